@@ -38,6 +38,9 @@
 #include <assert.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <limits.h>             /* MAXHOSTNAMELEN */
 #ifdef HAVE_NETDB_H
@@ -46,11 +49,15 @@
 
 #include "fi_hostlist.h"
 #include "hostlist.h"
+#include "network.h"
 
 #ifndef MAXHOSTNAMELEN
 #define MAXHOSTNAMELEN 64
 #endif
 
+/* max datagrams per sendmmsg()/recvmmsg() call */
+#define NETWORK_MMSG_MAX 64
+
 int
 host_is_ipv6_with_port (const char *host, char **addr, char **port)
 {
@@ -278,3 +285,154 @@ host_is_localhost (const char *host)
 
   return (0);
 }
+
+int
+network_sendmmsg (int s,
+                  struct network_dgram *dgrams,
+                  unsigned int count,
+                  int flags)
+{
+  unsigned int sent = 0;
+
+  assert (dgrams);
+
+#if HAVE_SENDMMSG
+  while (sent < count)
+    {
+      struct mmsghdr msgs[NETWORK_MMSG_MAX];
+      struct iovec iovs[NETWORK_MMSG_MAX];
+      unsigned int i, n;
+      int rv;
+
+      n = count - sent;
+      if (n > NETWORK_MMSG_MAX)
+        n = NETWORK_MMSG_MAX;
+
+      memset (msgs, '\0', sizeof (struct mmsghdr) * n);
+      for (i = 0; i < n; i++)
+        {
+          iovs[i].iov_base = dgrams[sent + i].buf;
+          iovs[i].iov_len = dgrams[sent + i].len;
+          msgs[i].msg_hdr.msg_name = dgrams[sent + i].addr;
+          msgs[i].msg_hdr.msg_namelen = dgrams[sent + i].addrlen;
+          msgs[i].msg_hdr.msg_iov = &iovs[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+      if ((rv = sendmmsg (s, msgs, n, flags)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          /* libc supports it, but the kernel does not */
+          if (errno == ENOSYS)
+            goto fallback;
+          return (sent ? sent : -1);
+        }
+
+      sent += rv;
+    }
+
+  return (sent);
+
+ fallback:
+#endif /* HAVE_SENDMMSG */
+  while (sent < count)
+    {
+      ssize_t rv;
+
+      do
+        {
+          rv = sendto (s,
+                       dgrams[sent].buf,
+                       dgrams[sent].len,
+                       flags,
+                       dgrams[sent].addr,
+                       dgrams[sent].addrlen);
+        } while (rv < 0 && errno == EINTR);
+
+      if (rv < 0)
+        return (sent ? sent : -1);
+
+      sent++;
+    }
+
+  return (sent);
+}
+
+int
+network_recvmmsg (int s,
+                  struct network_dgram *dgrams,
+                  unsigned int count,
+                  int flags)
+{
+  unsigned int received = 0;
+
+  assert (dgrams);
+  assert (count);
+
+#if HAVE_RECVMMSG
+  {
+    struct mmsghdr msgs[NETWORK_MMSG_MAX];
+    struct iovec iovs[NETWORK_MMSG_MAX];
+    unsigned int i, n;
+    int rv;
+
+    n = count;
+    if (n > NETWORK_MMSG_MAX)
+      n = NETWORK_MMSG_MAX;
+
+    memset (msgs, '\0', sizeof (struct mmsghdr) * n);
+    for (i = 0; i < n; i++)
+      {
+        iovs[i].iov_base = dgrams[i].buf;
+        iovs[i].iov_len = dgrams[i].len;
+        msgs[i].msg_hdr.msg_name = dgrams[i].addr;
+        msgs[i].msg_hdr.msg_namelen = dgrams[i].addrlen;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+    do
+      {
+        rv = recvmmsg (s, msgs, n, flags | MSG_WAITFORONE, NULL);
+      } while (rv < 0 && errno == EINTR);
+
+    if (rv >= 0)
+      {
+        for (i = 0; i < rv; i++)
+          {
+            dgrams[i].len = msgs[i].msg_len;
+            dgrams[i].addrlen = msgs[i].msg_hdr.msg_namelen;
+          }
+        return (rv);
+      }
+
+    /* libc supports it, but the kernel does not */
+    if (errno != ENOSYS)
+      return (-1);
+  }
+#endif /* HAVE_RECVMMSG */
+
+  while (received < count)
+    {
+      ssize_t rv;
+
+      do
+        {
+          rv = recvfrom (s,
+                         dgrams[received].buf,
+                         dgrams[received].len,
+                         received ? (flags | MSG_DONTWAIT) : flags,
+                         dgrams[received].addr,
+                         &dgrams[received].addrlen);
+        } while (rv < 0 && errno == EINTR);
+
+      if (rv < 0)
+        return (received ? received : -1);
+
+      dgrams[received].len = rv;
+      received++;
+    }
+
+  return (received);
+}
@@ -30,6 +30,8 @@
 #define _NETWORK_H
 
 #include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 
 /* Convenience functions */
 
@@ -61,4 +63,40 @@ int host_is_valid (const char *addr, const char *port, uint16_t *portptr);
  */
 int host_is_localhost (const char *host);
 
+/* Batched datagram I/O
+ *
+ * Uses sendmmsg()/recvmmsg() when available, otherwise one
+ * sendto()/recvfrom() per datagram.
+ */
+
+struct network_dgram
+{
+  void *buf;
+  /* buffer length for sends and receives, set to datagram length
+   * on receive
+   */
+  size_t len;
+  /* destination on send, source on receive */
+  struct sockaddr *addr;
+  socklen_t addrlen;
+};
+
+/* Send 'count' datagrams on socket 's'.  Returns the number sent,
+ * which may be less than 'count' if an error occurred after the first
+ * datagram, or -1 with errno set if the first could not be sent.
+ */
+int network_sendmmsg (int s,
+                      struct network_dgram *dgrams,
+                      unsigned int count,
+                      int flags);
+
+/* Receive up to 'count' datagrams from socket 's'.  Only waits for
+ * the first datagram, and not at all if MSG_DONTWAIT is set.  Returns
+ * the number received, or -1 with errno set if none could be received.
+ */
+int network_recvmmsg (int s,
+                      struct network_dgram *dgrams,
+                      unsigned int count,
+                      int flags);
+
 #endif /* !_NETWORK_H */
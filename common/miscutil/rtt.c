@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <assert.h>
+
+#include "rtt.h"
+#include "timeval.h"
+
+void
+rtt_init (struct rtt *rtt)
+{
+  assert (rtt);
+
+  rtt->srtt = 0;
+  rtt->rttvar = 0;
+  rtt->measured = 0;
+}
+
+void
+rtt_sample (struct rtt *rtt, struct timeval *send, struct timeval *recv)
+{
+  struct timeval result;
+  unsigned int sample;
+  unsigned int delta;
+
+  assert (rtt);
+  assert (send);
+  assert (recv);
+
+  if (timeval_lt (recv, send))
+    return;
+
+  timeval_sub (recv, send, &result);
+
+  /* avoid overflow, such a round trip is useless anyways */
+  if (result.tv_sec >= RTT_SAMPLE_MAX)
+    sample = RTT_SAMPLE_MAX * 1000000;
+  else
+    sample = result.tv_sec * 1000000 + result.tv_usec;
+
+  if (!rtt->measured)
+    {
+      rtt->srtt = sample;
+      rtt->rttvar = sample / 2;
+      rtt->measured = 1;
+      return;
+    }
+
+  if (rtt->srtt > sample)
+    delta = rtt->srtt - sample;
+  else
+    delta = sample - rtt->srtt;
+
+  /* rttvar = 3/4 rttvar + 1/4 delta, srtt = 7/8 srtt + 1/8 sample */
+  rtt->rttvar = rtt->rttvar - (rtt->rttvar / 4) + (delta / 4);
+  rtt->srtt = rtt->srtt - (rtt->srtt / 8) + (sample / 8);
+}
+
+unsigned int
+rtt_retransmission_timeout (struct rtt *rtt,
+                            unsigned int retransmission_timeout)
+{
+  unsigned int rv;
+  unsigned int min;
+
+  assert (rtt);
+
+  if (!rtt->measured)
+    return (retransmission_timeout);
+
+  rv = (rtt->srtt + 4 * rtt->rttvar + 999) / 1000;
+
+  if (retransmission_timeout < RTT_RETRANSMISSION_TIMEOUT_MIN)
+    min = retransmission_timeout;
+  else
+    min = RTT_RETRANSMISSION_TIMEOUT_MIN;
+
+  if (rv < min)
+    rv = min;
+
+  return (rv);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Round trip time estimate for retransmission timeouts
+ * (Jacobson/Karels, RFC 6298)
+ */
+
+#ifndef RTT_H
+#define RTT_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else  /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif  /* !HAVE_SYS_TIME_H */
+#endif /* !TIME_WITH_SYS_TIME */
+
+/* Lower bound of the measured retransmission timeout, in
+ * milliseconds.  Lower configured retransmission timeouts are
+ * honored.
+ */
+#define RTT_RETRANSMISSION_TIMEOUT_MIN 200
+
+/* Upper bound of a round trip time sample, in seconds */
+#define RTT_SAMPLE_MAX                 60
+
+struct rtt
+{
+  /* in microseconds */
+  unsigned int srtt;
+  unsigned int rttvar;
+  int measured;
+};
+
+void rtt_init (struct rtt *rtt);
+
+/* Update the estimate with the round trip of a request sent at send
+ * and answered at recv.  Per Karn's algorithm, callers must not pass
+ * responses to retransmitted requests, it is unknown which request
+ * they answer.
+ */
+void rtt_sample (struct rtt *rtt, struct timeval *send, struct timeval *recv);
+
+/* Retransmission timeout in milliseconds.  The configured
+ * retransmission_timeout is returned until a round trip time has
+ * been measured.
+ */
+unsigned int rtt_retransmission_timeout (struct rtt *rtt,
+                                         unsigned int retransmission_timeout);
+
+#endif /* RTT_H */
@@ -404,6 +404,12 @@ common_parse_opt (int key,
     case ARGP_SDR_CACHE_RECREATE_KEY:
       common_args->sdr_cache_recreate = 1;
       break;
+    case ARGP_SDR_CACHE_PIPELINE_KEY:
+      common_args->sdr_cache_pipeline = 1;
+      break;
+    case ARGP_SDR_CACHE_INCREMENTAL_KEY:
+      common_args->sdr_cache_incremental = 1;
+      break;
     case ARGP_SDR_CACHE_FILE_KEY:
       free (common_args->sdr_cache_file);
       if (!(common_args->sdr_cache_file = strdup (arg)))
@@ -519,6 +525,8 @@ _init_common_cmd_args (struct common_cmd_args *common_args)
   common_args->flush_cache = 0;
   common_args->quiet_cache = 0;
   common_args->sdr_cache_recreate = 0;
+  common_args->sdr_cache_pipeline = 0;
+  common_args->sdr_cache_incremental = 0;
   common_args->sdr_cache_file = NULL;
   common_args->sdr_cache_directory = NULL;
   common_args->ignore_sdr_cache = 0;
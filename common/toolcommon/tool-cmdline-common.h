@@ -75,6 +75,9 @@ enum argp_common_option_keys
     ARGP_FANOUT_KEY = 'F',
     ARGP_ELIMINATE_KEY = 'E',
     ARGP_ALWAYS_PREFIX_KEY = 149,
+    /* sdr options, continued */
+    ARGP_SDR_CACHE_PIPELINE_KEY = 150,
+    ARGP_SDR_CACHE_INCREMENTAL_KEY = 151,
   };
 
 /*
@@ -155,7 +158,11 @@ enum argp_common_option_keys
   { "quiet-cache", ARGP_QUIET_CACHE_KEY,  0, 0,                                                                 \
       "Do not output information about cache creation/deletion.", 21},                                          \
   { "sdr-cache-recreate", ARGP_SDR_CACHE_RECREATE_KEY,  0, 0,                                                   \
-      "Recreate sensor data repository (SDR) cache if cache is out of date or invalid.", 22}
+      "Recreate sensor data repository (SDR) cache if cache is out of date or invalid.", 22},                   \
+  { "sdr-cache-pipeline", ARGP_SDR_CACHE_PIPELINE_KEY,  0, 0,                                                   \
+      "Issue several SDR read requests at once when creating the sensor data repository (SDR) cache.", 22}, \
+  { "sdr-cache-incremental", ARGP_SDR_CACHE_INCREMENTAL_KEY,  0, 0,                                             \
+      "Refresh an out of date sensor data repository (SDR) cache, only downloading changed records.", 22}
 
 /* older -f option maintained for backwards compatability */
 #define ARGP_COMMON_SDR_CACHE_OPTIONS_LEGACY                                                                    \
@@ -239,6 +246,8 @@ struct common_cmd_args
   int flush_cache;
   int quiet_cache;
   int sdr_cache_recreate;
+  int sdr_cache_pipeline;
+  int sdr_cache_incremental;
   char *sdr_cache_file;
   char *sdr_cache_directory;
   int ignore_sdr_cache;
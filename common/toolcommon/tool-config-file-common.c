@@ -4510,6 +4510,61 @@ config_file_parse (const char *filename,
         &(ipmipower_data.ping_consec_count),
         0
       },
+      {
+        "ipmipower-shared-sockets",
+        CONFFILE_OPTION_BOOL,
+        -1,
+        _config_file_bool,
+        1,
+        0,
+        &(ipmipower_data.shared_sockets_count),
+        &(ipmipower_data.shared_sockets),
+        0
+      },
+      {
+        "ipmipower-threads",
+        CONFFILE_OPTION_INT,
+        -1,
+        _config_file_unsigned_int,
+        1,
+        0,
+        &(ipmipower_data.threads_count),
+        &(ipmipower_data.threads),
+        0
+      },
+      {
+        "ipmipower-session-rate",
+        CONFFILE_OPTION_INT,
+        -1,
+        _config_file_unsigned_int,
+        1,
+        0,
+        &(ipmipower_data.session_rate_count),
+        &(ipmipower_data.session_rate),
+        0
+      },
+      {
+        "ipmipower-session-window",
+        CONFFILE_OPTION_INT,
+        -1,
+        _config_file_unsigned_int,
+        1,
+        0,
+        &(ipmipower_data.session_window_count),
+        &(ipmipower_data.session_window),
+        0
+      },
+      {
+        "ipmipower-reuse-sessions",
+        CONFFILE_OPTION_BOOL,
+        -1,
+        _config_file_bool,
+        1,
+        0,
+        &(ipmipower_data.reuse_sessions_count),
+        &(ipmipower_data.reuse_sessions),
+        0
+      },
     };
 
   /*
@@ -4769,6 +4824,28 @@ config_file_parse (const char *filename,
         &(ipmiseld_data.re_download_sdr),
         0,
       },
+      {
+        "shared-sdr-cache",
+        CONFFILE_OPTION_BOOL,
+        -1,
+        _config_file_bool,
+        1,
+        0,
+        &(ipmiseld_data.shared_sdr_cache_count),
+        &(ipmiseld_data.shared_sdr_cache),
+        0,
+      },
+      {
+        "sel-pipeline",
+        CONFFILE_OPTION_BOOL,
+        -1,
+        _config_file_bool,
+        1,
+        0,
+        &(ipmiseld_data.sel_pipeline_count),
+        &(ipmiseld_data.sel_pipeline),
+        0,
+      },
       {
         "clear-sel",
         CONFFILE_OPTION_BOOL,
@@ -275,6 +275,16 @@ struct config_file_data_ipmipower
   int ping_percent_count;
   unsigned int ping_consec_count;
   int ping_consec_count_count;
+  int shared_sockets;
+  int shared_sockets_count;
+  unsigned int threads;
+  int threads_count;
+  unsigned int session_rate;
+  int session_rate_count;
+  unsigned int session_window;
+  int session_window_count;
+  int reuse_sessions;
+  int reuse_sessions_count;
 };
 
 struct config_file_data_ipmiseld
@@ -327,6 +337,10 @@ struct config_file_data_ipmiseld
   int ignore_sdr_count;
   int re_download_sdr;
   int re_download_sdr_count;
+  int shared_sdr_cache;
+  int shared_sdr_cache_count;
+  int sel_pipeline;
+  int sel_pipeline_count;
   int clear_sel;
   int clear_sel_count;
   unsigned int threadpool_count;
@@ -562,6 +562,12 @@ _sdr_cache_create (ipmi_sdr_ctx_t ctx,
   if (common_args->workaround_flags_sdr & IPMI_PARSE_WORKAROUND_FLAGS_SDR_ASSUME_MAX_SDR_RECORD_COUNT)
     cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT;
 
+  if (common_args->sdr_cache_pipeline)
+    cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE;
+
+  if (common_args->sdr_cache_incremental)
+    cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL;
+
   if (ipmi_sdr_cache_create (ctx,
                              ipmi_ctx,
                              cachefilenamebuf,
@@ -620,7 +626,8 @@ sdr_cache_create_and_load (ipmi_sdr_ctx_t sdr_ctx,
       if (ipmi_sdr_ctx_errnum (sdr_ctx) != IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
           && !((ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_INVALID
                 || ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_OUT_OF_DATE)
-               && common_args->sdr_cache_recreate))
+               && (common_args->sdr_cache_recreate
+                   || common_args->sdr_cache_incremental)))
         {
           if (ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_INVALID)
             {
@@ -654,7 +661,8 @@ sdr_cache_create_and_load (ipmi_sdr_ctx_t sdr_ctx,
   if (ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
       || ((ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_INVALID
            || ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_OUT_OF_DATE)
-          && common_args->sdr_cache_recreate))
+          && (common_args->sdr_cache_recreate
+              || common_args->sdr_cache_incremental)))
     {
       if (_sdr_cache_create (sdr_ctx,
                              pstate,
@@ -37,6 +37,9 @@
 #include "ipmi-raw-argp.h"
 
 #include "freeipmi-portability.h"
+#include "fi_hostlist.h"
+#include "network.h"
+#include "parse-common.h"
 #include "pstdout.h"
 #include "tool-common.h"
 #include "tool-cmdline-common.h"
@@ -418,11 +421,285 @@ _ipmi_raw (pstdout_state_t pstate,
   return (exit_code);
 }
 
+/* Raw request/response template, identical to the one used by
+ * ipmi_cmd_raw() for LAN.
+ */
+static fiid_template_t tmpl_ipmi_raw =
+  {
+    { 8192, "raw_data", FIID_FIELD_OPTIONAL | FIID_FIELD_LENGTH_VARIABLE},
+    { 0, "", 0}
+  };
+
+static void
+_reactor_host_destroy (void *data)
+{
+  struct ipmi_raw_reactor_host *host;
+
+  if (!data)
+    return;
+
+  host = (struct ipmi_raw_reactor_host *)data;
+  ipmi_ctx_close (host->ipmi_ctx);
+  ipmi_ctx_destroy (host->ipmi_ctx);
+  fiid_obj_destroy (host->obj_cmd_rq);
+  fiid_obj_destroy (host->obj_cmd_rs);
+  free (host->hostname);
+  free (host);
+}
+
+static void
+_reactor_host_callback (ipmi_ctx_t ipmi_ctx,
+                        int errnum,
+                        fiid_obj_t obj_cmd_rs,
+                        void *data)
+{
+  struct ipmi_raw_reactor_host *host;
+
+  assert (data);
+
+  host = (struct ipmi_raw_reactor_host *)data;
+  host->done = 1;
+  host->errnum = errnum;
+}
+
+/* Open a session-less context to hostname without any output, a
+ * failed host is left to _ipmi_raw() so errors are reported as usual.
+ */
+static struct ipmi_raw_reactor_host *
+_reactor_host_create (ipmi_raw_prog_data_t *prog_data, const char *hostname)
+{
+  struct ipmi_raw_reactor_host *host = NULL;
+  struct common_cmd_args *common_args;
+  struct ipmi_raw_arguments *args;
+  unsigned int workaround_flags = 0;
+
+  assert (prog_data);
+  assert (hostname);
+
+  args = prog_data->args;
+  common_args = &(args->common_args);
+
+  /* inband */
+  if (host_is_localhost (hostname))
+    return (NULL);
+
+  if (!(host = (struct ipmi_raw_reactor_host *)malloc (sizeof (struct ipmi_raw_reactor_host))))
+    return (NULL);
+  memset (host, '\0', sizeof (struct ipmi_raw_reactor_host));
+
+  if (!(host->hostname = strdup (hostname)))
+    goto cleanup;
+
+  if (!(host->ipmi_ctx = ipmi_ctx_create ()))
+    goto cleanup;
+
+  parse_get_freeipmi_outofband_flags (common_args->workaround_flags_outofband,
+                                      &workaround_flags);
+
+  if (ipmi_ctx_open_outofband (host->ipmi_ctx,
+                               hostname,
+                               common_args->username,
+                               common_args->password,
+                               common_args->authentication_type,
+                               common_args->privilege_level,
+                               common_args->session_timeout,
+                               common_args->retransmission_timeout,
+                               workaround_flags,
+                               IPMI_FLAGS_NOSESSION) < 0)
+    goto cleanup;
+
+  if (!(host->obj_cmd_rq = fiid_obj_create (tmpl_ipmi_raw)))
+    goto cleanup;
+
+  if (!(host->obj_cmd_rs = fiid_obj_create (tmpl_ipmi_raw)))
+    goto cleanup;
+
+  if (fiid_obj_set_all (host->obj_cmd_rq,
+                        &(args->cmd[2]),
+                        args->cmd_length - 2) < 0)
+    goto cleanup;
+
+  return (host);
+
+ cleanup:
+  _reactor_host_destroy (host);
+  return (NULL);
+}
+
+/* Without a session, opening a context requires no network I/O, so
+ * the command line command can be sent to every host from a single
+ * reactor instead of one pstdout thread per host.  Results are
+ * stored in prog_data->reactor_hosts and output by
+ * _ipmi_raw_reactor().
+ */
+static int
+_reactor_run (ipmi_raw_prog_data_t *prog_data, int hosts_count)
+{
+  struct ipmi_raw_arguments *args;
+  ipmi_reactor_ctx_t reactor_ctx = NULL;
+  fi_hostlist_t hlist = NULL;
+  fi_hostlist_iterator_t hitr = NULL;
+  char *hostname = NULL;
+  int rv = -1;
+
+  assert (prog_data);
+
+  args = prog_data->args;
+
+  if (!(prog_data->reactor_hosts = hash_create (hosts_count,
+                                                (hash_key_f)hash_key_string,
+                                                (hash_cmp_f)strcmp,
+                                                _reactor_host_destroy)))
+    {
+      fprintf (stderr, "hash_create: %s\n", strerror (errno));
+      goto cleanup;
+    }
+
+  if (!(reactor_ctx = ipmi_reactor_ctx_create ()))
+    {
+      fprintf (stderr, "ipmi_reactor_ctx_create: %s\n", strerror (errno));
+      goto cleanup;
+    }
+
+  if (!(hlist = fi_hostlist_create (args->common_args.hostname)))
+    {
+      fprintf (stderr, "fi_hostlist_create: %s\n", strerror (errno));
+      goto cleanup;
+    }
+
+  if (!(hitr = fi_hostlist_iterator_create (hlist)))
+    {
+      fprintf (stderr, "fi_hostlist_iterator_create: %s\n", strerror (errno));
+      goto cleanup;
+    }
+
+  while ((hostname = fi_hostlist_next (hitr)))
+    {
+      struct ipmi_raw_reactor_host *host;
+
+      if (hash_find (prog_data->reactor_hosts, hostname)
+          || !(host = _reactor_host_create (prog_data, hostname)))
+        goto end_loop;
+
+      if (!hash_insert (prog_data->reactor_hosts, host->hostname, host))
+        {
+          fprintf (stderr, "hash_insert: %s\n", strerror (errno));
+          _reactor_host_destroy (host);
+          goto cleanup;
+        }
+
+      if (ipmi_reactor_add (reactor_ctx, host->ipmi_ctx) < 0)
+        {
+          fprintf (stderr,
+                   "ipmi_reactor_add: %s\n",
+                   ipmi_reactor_ctx_errormsg (reactor_ctx));
+          goto cleanup;
+        }
+
+      if (ipmi_reactor_cmd (reactor_ctx,
+                            host->ipmi_ctx,
+                            args->cmd[0],
+                            args->cmd[1],
+                            host->obj_cmd_rq,
+                            host->obj_cmd_rs,
+                            _reactor_host_callback,
+                            host) < 0)
+        {
+          fprintf (stderr,
+                   "ipmi_reactor_cmd: %s\n",
+                   ipmi_reactor_ctx_errormsg (reactor_ctx));
+          goto cleanup;
+        }
+
+    end_loop:
+      free (hostname);
+      hostname = NULL;
+    }
+
+  if (ipmi_reactor_run (reactor_ctx) < 0)
+    {
+      fprintf (stderr,
+               "ipmi_reactor_run: %s\n",
+               ipmi_reactor_ctx_errormsg (reactor_ctx));
+      goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  free (hostname);
+  fi_hostlist_iterator_destroy (hitr);
+  fi_hostlist_destroy (hlist);
+  /* cancels outstanding commands, before their contexts are closed */
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  return (rv);
+}
+
+static int
+_ipmi_raw_reactor (pstdout_state_t pstate,
+                   const char *hostname,
+                   void *arg)
+{
+  ipmi_raw_prog_data_t *prog_data;
+  struct ipmi_raw_reactor_host *host;
+  uint8_t *bytes_rs = NULL;
+  int rs_len;
+  int exit_code = EXIT_FAILURE;
+  int i;
+
+  assert (pstate);
+  assert (hostname);
+  assert (arg);
+
+  prog_data = (ipmi_raw_prog_data_t *)arg;
+
+  if (!(host = hash_find (prog_data->reactor_hosts, hostname)))
+    return (_ipmi_raw (pstate, hostname, arg));
+
+  assert (host->done);
+
+  if (host->errnum != IPMI_ERR_SUCCESS)
+    {
+      pstdout_fprintf (pstate,
+                       stderr,
+                       "ipmi_cmd_raw: %s\n",
+                       ipmi_ctx_strerror (host->errnum));
+      goto cleanup;
+    }
+
+  if (!(bytes_rs = calloc (IPMI_RAW_MAX_ARGS, sizeof (uint8_t))))
+    {
+      pstdout_perror (pstate, "calloc");
+      goto cleanup;
+    }
+
+  if ((rs_len = fiid_obj_get_all (host->obj_cmd_rs,
+                                  bytes_rs,
+                                  IPMI_RAW_MAX_ARGS)) < 0)
+    {
+      pstdout_fprintf (pstate,
+                       stderr,
+                       "fiid_obj_get_all: %s\n",
+                       fiid_obj_errormsg (host->obj_cmd_rs));
+      goto cleanup;
+    }
+
+  pstdout_printf (pstate, "rcvd: ");
+  for (i = 0; i < rs_len; i++)
+    pstdout_printf (pstate, "%02X ", bytes_rs[i]);
+  pstdout_printf (pstate, "\n");
+
+  exit_code = EXIT_SUCCESS;
+ cleanup:
+  free (bytes_rs);
+  return (exit_code);
+}
+
 int
 main (int argc, char **argv)
 {
   ipmi_raw_prog_data_t prog_data;
   struct ipmi_raw_arguments cmd_args;
+  Pstdout_Thread pstdout_func = _ipmi_raw;
   int hosts_count;
   int rv;
 
@@ -431,6 +708,7 @@ main (int argc, char **argv)
   prog_data.progname = argv[0];
   ipmi_raw_argp_parse (argc, argv, &cmd_args);
   prog_data.args = &cmd_args;
+  prog_data.reactor_hosts = NULL;
 
   if ((hosts_count = pstdout_setup (&(prog_data.args->common_args.hostname),
                                     &(prog_data.args->common_args))) < 0)
@@ -439,15 +717,39 @@ main (int argc, char **argv)
   if (!hosts_count)
     return (EXIT_SUCCESS);
 
+  /* the reactor needs session-less IPMI 1.5 LAN contexts, a valid
+   * command, and the command must not be bridged
+   */
+  if (hosts_count > 1
+      && prog_data.args->no_session
+      && prog_data.args->cmd_length > 2
+      && IPMI_NET_FN_RQ_VALID (prog_data.args->cmd[1])
+      && prog_data.args->common_args.driver_type != IPMI_DEVICE_LAN_2_0
+      && !prog_data.args->common_args.debug
+      && !prog_data.args->common_args.target_channel_number_is_set
+      && !prog_data.args->common_args.target_slave_address_is_set)
+    {
+      if (_reactor_run (&prog_data, hosts_count) < 0)
+        {
+          rv = EXIT_FAILURE;
+          goto cleanup;
+        }
+      pstdout_func = _ipmi_raw_reactor;
+    }
+
   if ((rv = pstdout_launch (prog_data.args->common_args.hostname,
-                            _ipmi_raw,
+                            pstdout_func,
                             &prog_data)) < 0)
     {
       fprintf (stderr,
                "pstdout_launch: %s\n",
                pstdout_strerror (pstdout_errnum));
-      return (EXIT_FAILURE);
+      rv = EXIT_FAILURE;
+      goto cleanup;
     }
 
+ cleanup:
+  if (prog_data.reactor_hosts)
+    hash_destroy (prog_data.reactor_hosts);
   return (rv);
 }
@@ -23,6 +23,7 @@
 
 #include "tool-cmdline-common.h"
 #include "pstdout.h"
+#include "hash.h"
 
 /* IPMI 2.0 Payload is 2 bytes, so we'll assume that size * 2 for good measure */
 #define IPMI_RAW_MAX_ARGS (65536*2)
@@ -44,10 +45,23 @@ struct ipmi_raw_arguments
   unsigned int cmd_length;
 };
 
+/* result of a command sent through the reactor */
+struct ipmi_raw_reactor_host
+{
+  char *hostname;
+  ipmi_ctx_t ipmi_ctx;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+  int done;
+  int errnum;
+};
+
 typedef struct ipmi_raw_prog_data
 {
   char *progname;
   struct ipmi_raw_arguments *args;
+  /* hostname -> struct ipmi_raw_reactor_host, NULL if not used */
+  hash_t reactor_hosts;
 } ipmi_raw_prog_data_t;
 
 typedef struct ipmi_raw_state_data
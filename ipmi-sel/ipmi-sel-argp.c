@@ -145,6 +145,10 @@ static struct argp_option cmdline_options[] =
       "Do not output column headers.", 67},
     { "non-abbreviated-units", NON_ABBREVIATED_UNITS_KEY, 0, 0,
       "Output non-abbreviated units (e.g. 'Amps' instead of 'A').", 68},
+    { "sel-pipeline", SEL_PIPELINE_KEY, 0, 0,
+      "Issue several SEL read requests at once.", 69},
+    { "sel-mirror-directory", SEL_MIRROR_DIRECTORY_KEY, "DIRECTORY", 0,
+      "Keep a local copy of the SEL in DIRECTORY and only read new entries.", 70},
     { NULL, 0, NULL, 0, NULL, 0}
   };
 
@@ -625,6 +629,16 @@ cmdline_parse (int key, char *arg, struct argp_state *state)
     case NON_ABBREVIATED_UNITS_KEY:
       cmd_args->non_abbreviated_units = 1;
       break;
+    case SEL_PIPELINE_KEY:
+      cmd_args->sel_pipeline = 1;
+      break;
+    case SEL_MIRROR_DIRECTORY_KEY:
+      if (!(cmd_args->sel_mirror_directory = strdup (arg)))
+        {
+          perror ("strdup");
+          exit (EXIT_FAILURE);
+        }
+      break;
     case ARGP_KEY_ARG:
       /* Too many arguments. */
       argp_usage (state);
@@ -814,6 +828,8 @@ ipmi_sel_argp_parse (int argc, char **argv, struct ipmi_sel_arguments *cmd_args)
   cmd_args->comma_separated_output = 0;
   cmd_args->no_header_output = 0;
   cmd_args->non_abbreviated_units = 0;
+  cmd_args->sel_pipeline = 0;
+  cmd_args->sel_mirror_directory = NULL;
 
   argp_parse (&cmdline_config_file_argp,
               argc,
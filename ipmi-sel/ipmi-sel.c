@@ -55,6 +55,10 @@
 
 #define IPMI_SEL_TIME_BUFLEN 512
 
+#ifndef MAXPATHLEN
+#define MAXPATHLEN 4096
+#endif /* MAXPATHLEN */
+
 static int
 _display_sel_info (ipmi_sel_state_data_t *state_data)
 {
@@ -2056,6 +2060,9 @@ _ipmi_sel (pstdout_state_t pstate,
   if (state_data.prog_data->args->assume_system_event_records)
     sel_flags |= IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS;
 
+  if (state_data.prog_data->args->sel_pipeline)
+    sel_flags |= IPMI_SEL_FLAGS_PIPELINE;
+
   if (sel_flags)
     {
       /* Don't error out, if this fails we can still continue */
@@ -2076,6 +2083,30 @@ _ipmi_sel (pstdout_state_t pstate,
                          ipmi_sel_ctx_errormsg (state_data.sel_ctx));
     }
 
+  if (prog_data->args->sel_mirror_directory
+      && !prog_data->args->info
+      && !prog_data->args->clear
+      && !prog_data->args->delete
+      && !prog_data->args->delete_range)
+    {
+      char mirror_filename[MAXPATHLEN + 1];
+
+      snprintf (mirror_filename,
+                MAXPATHLEN,
+                "%s/sel-mirror-%s",
+                prog_data->args->sel_mirror_directory,
+                hostname ? hostname : "localhost");
+
+      if (ipmi_sel_sync (state_data.sel_ctx, mirror_filename) < 0)
+        {
+          pstdout_fprintf (pstate,
+                           stderr,
+                           "ipmi_sel_sync: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data.sel_ctx));
+          goto cleanup;
+        }
+    }
+
   if (prog_data->args->output_event_state)
     {
       unsigned int interpret_flags = 0;
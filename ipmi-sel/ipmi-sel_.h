@@ -69,6 +69,8 @@ enum ipmi_sel_argp_option_keys
     COMMA_SEPARATED_OUTPUT_KEY = 182,
     NO_HEADER_OUTPUT_KEY = 183,
     NON_ABBREVIATED_UNITS_KEY = 184,
+    SEL_PIPELINE_KEY = 185,
+    SEL_MIRROR_DIRECTORY_KEY = 186,
   };
 
 struct ipmi_sel_arguments
@@ -123,6 +125,8 @@ struct ipmi_sel_arguments
   int comma_separated_output;
   int no_header_output;
   int non_abbreviated_units;
+  int sel_pipeline;
+  char *sel_mirror_directory;
 };
 
 typedef struct ipmi_sel_prog_data
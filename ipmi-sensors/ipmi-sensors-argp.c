@@ -118,6 +118,8 @@ static struct argp_option cmdline_options[] =
       "Do not output column headers.", 67},
     { "non-abbreviated-units", NON_ABBREVIATED_UNITS_KEY, 0, 0,
       "Output non-abbreviated units (e.g. 'Amps' insetead of 'A').", 68},
+    { "sensor-pipeline", SENSOR_PIPELINE_KEY, 0, 0,
+      "Read sensors with several requests outstanding at once.", 69},
     { NULL, 0, NULL, 0, NULL, 0}
   };
 
@@ -275,6 +277,9 @@ cmdline_parse (int key, char *arg, struct argp_state *state)
     case NON_ABBREVIATED_UNITS_KEY:
       cmd_args->non_abbreviated_units = 1;
       break;
+    case SENSOR_PIPELINE_KEY:
+      cmd_args->sensor_pipeline = 1;
+      break;
     case ARGP_KEY_ARG:
       /* Too many arguments. */
       argp_usage (state);
@@ -463,6 +468,7 @@ ipmi_sensors_argp_parse (int argc, char **argv, struct ipmi_sensors_arguments *c
   cmd_args->comma_separated_output = 0;
   cmd_args->no_header_output = 0;
   cmd_args->non_abbreviated_units = 0;
+  cmd_args->sensor_pipeline = 0;
 
   argp_parse (&cmdline_config_file_argp,
               argc,
@@ -1073,6 +1073,128 @@ _output_sensor (ipmi_sensors_state_data_t *state_data,
   return (rv);
 }
 
+/* Queue the sensors of all output records and read them in one
+ * sweep, _output_sensor() then uses the swept readings.  If the sweep
+ * fails, _output_sensor() reads the sensors one at a time.
+ */
+static int
+_sweep_sensors (ipmi_sensors_state_data_t *state_data,
+                unsigned int *output_record_ids,
+                unsigned int output_record_ids_length)
+{
+  uint8_t sdr_record[IPMI_SDR_MAX_RECORD_LENGTH];
+  int sdr_record_len = 0;
+  unsigned int i;
+  int rv = -1;
+
+  assert (state_data);
+  assert (output_record_ids);
+
+  for (i = 0; i < output_record_ids_length; i++)
+    {
+      uint8_t record_type;
+      uint8_t share_count = 1;
+      int j;
+
+      if (ipmi_sdr_cache_search_record_id (state_data->sdr_ctx,
+                                           output_record_ids[i]) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sdr_cache_search_record_id: 0x%02X %s\n",
+                           output_record_ids[i],
+                           ipmi_sdr_ctx_errormsg (state_data->sdr_ctx));
+          goto cleanup;
+        }
+
+      if ((sdr_record_len = ipmi_sdr_cache_record_read (state_data->sdr_ctx,
+                                                        sdr_record,
+                                                        IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sdr_cache_record_read: %s\n",
+                           ipmi_sdr_ctx_errormsg (state_data->sdr_ctx));
+          goto cleanup;
+        }
+
+      if (ipmi_sdr_parse_record_id_and_type (state_data->sdr_ctx,
+                                             sdr_record,
+                                             sdr_record_len,
+                                             NULL,
+                                             &record_type) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sdr_parse_record_id_and_type: %s\n",
+                           ipmi_sdr_ctx_errormsg (state_data->sdr_ctx));
+          goto cleanup;
+        }
+
+      if (state_data->prog_data->args->shared_sensors
+          && record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+        {
+          if (ipmi_sdr_parse_sensor_record_sharing (state_data->sdr_ctx,
+                                                    sdr_record,
+                                                    sdr_record_len,
+                                                    &share_count,
+                                                    NULL,
+                                                    NULL,
+                                                    NULL) < 0)
+            {
+              pstdout_fprintf (state_data->pstate,
+                               stderr,
+                               "ipmi_sdr_parse_sensor_record_sharing: %s\n",
+                               ipmi_sdr_ctx_errormsg (state_data->sdr_ctx));
+              goto cleanup;
+            }
+
+          if (!share_count)
+            share_count = 1;
+        }
+
+      for (j = 0; j < share_count; j++)
+        {
+          if (ipmi_sensor_read_sweep_add (state_data->sensor_read_ctx,
+                                          sdr_record,
+                                          sdr_record_len,
+                                          j) < 0)
+            {
+              pstdout_fprintf (state_data->pstate,
+                               stderr,
+                               "ipmi_sensor_read_sweep_add: %s\n",
+                               ipmi_sensor_read_ctx_errormsg (state_data->sensor_read_ctx));
+              goto cleanup;
+            }
+        }
+    }
+
+  /* Some BMCs cannot handle pipelined requests, fall back to reading
+   * sensors one at a time in _output_sensor().
+   */
+  if (ipmi_sensor_read_sweep (state_data->sensor_read_ctx) < 0)
+    {
+      if (state_data->prog_data->args->common_args.debug)
+        pstdout_fprintf (state_data->pstate,
+                         stderr,
+                         "ipmi_sensor_read_sweep: %s\n",
+                         ipmi_sensor_read_ctx_errormsg (state_data->sensor_read_ctx));
+
+      if (ipmi_sensor_read_sweep_clear (state_data->sensor_read_ctx) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sensor_read_sweep_clear: %s\n",
+                           ipmi_sensor_read_ctx_errormsg (state_data->sensor_read_ctx));
+          goto cleanup;
+        }
+    }
+
+  rv = 0;
+ cleanup:
+  return (rv);
+}
+
 static int
 _display_sensors (ipmi_sensors_state_data_t *state_data)
 {
@@ -1234,6 +1356,14 @@ _display_sensors (ipmi_sensors_state_data_t *state_data)
         }
     }
 
+  if (args->sensor_pipeline)
+    {
+      if (_sweep_sensors (state_data,
+                          output_record_ids,
+                          output_record_ids_length) < 0)
+        goto cleanup;
+    }
+
   for (i = 0; i < output_record_ids_length; i++)
     {
       uint8_t record_type;
@@ -1331,6 +1461,18 @@ _display_sensors (ipmi_sensors_state_data_t *state_data)
         }
     }
 
+  if (args->sensor_pipeline)
+    {
+      if (ipmi_sensor_read_sweep_clear (state_data->sensor_read_ctx) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sensor_read_sweep_clear: %s\n",
+                           ipmi_sensor_read_ctx_errormsg (state_data->sensor_read_ctx));
+          goto cleanup;
+        }
+    }
+
   if (state_data->prog_data->args->common_args.section_specific_workaround_flags & IPMI_PARSE_SECTION_SPECIFIC_WORKAROUND_FLAGS_IGNORE_AUTH_CODE)
     {
       if (ipmi_ctx_set_flags (state_data->ipmi_ctx, ctx_flags_orig) < 0)
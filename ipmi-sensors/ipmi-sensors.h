@@ -51,6 +51,7 @@ enum ipmi_sensors_argp_option_keys
     COMMA_SEPARATED_OUTPUT_KEY = 174,
     NO_HEADER_OUTPUT_KEY = 175,
     NON_ABBREVIATED_UNITS_KEY = 176,
+    SENSOR_PIPELINE_KEY = 177,
   };
 
 struct ipmi_sensors_arguments
@@ -82,6 +83,7 @@ struct ipmi_sensors_arguments
   int comma_separated_output;
   int no_header_output;
   int non_abbreviated_units;
+  int sensor_pipeline;
 };
 
 typedef struct ipmi_sensors_prog_data
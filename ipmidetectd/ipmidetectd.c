@@ -449,10 +449,48 @@ _ipmi_ping_build (struct ipmidetectd_info *info, uint8_t *buf, unsigned int bufl
   return (len);
 }
 
+static void
+_ipmidetectd_send_batch (struct network_dgram *dgrams,
+                         struct ipmidetectd_info **infos,
+                         unsigned int count)
+{
+  unsigned int sent = 0;
+  unsigned int i;
+
+  assert (dgrams);
+  assert (infos);
+  assert (count);
+
+  /* ipmi_lan_sendto() is a plain sendto(), so batching the sends
+   * loses nothing.
+   */
+  while (sent < count)
+    {
+      int rv;
+
+      if ((rv = network_sendmmsg (infos[0]->fd,
+                                  dgrams + sent,
+                                  count - sent,
+                                  0)) < 0)
+        err_exit ("network_sendmmsg: %s", strerror (errno));
+
+      sent += rv;
+    }
+
+  if (cmd_args.debug)
+    {
+      for (i = 0; i < count; i++)
+        fprintf (stderr, "Ping Request to %s\n", infos[i]->hostname);
+    }
+}
+
 static void
 _ipmidetectd_send_pings (void)
 {
-  uint8_t buf[IPMIDETECTD_BUFLEN];
+  uint8_t bufs[IPMIDETECTD_NODES_PER_SOCKET][IPMIDETECTD_BUFLEN];
+  struct network_dgram dgrams[IPMIDETECTD_NODES_PER_SOCKET];
+  struct ipmidetectd_info *infos[IPMIDETECTD_NODES_PER_SOCKET];
+  unsigned int count = 0;
   int len;
   struct ipmidetectd_info *info;
   ListIterator itr;
@@ -465,23 +503,33 @@ _ipmidetectd_send_pings (void)
 
   while ((info = list_next (itr)))
     {
-      memset (buf, '\0', IPMIDETECTD_BUFLEN);
+      /* Nodes are assigned to fds in list order, so each fd's pings
+       * are consecutive and can go out in one batch.
+       */
+      if (count
+          && (count == IPMIDETECTD_NODES_PER_SOCKET
+              || infos[0]->fd != info->fd))
+        {
+          _ipmidetectd_send_batch (dgrams, infos, count);
+          count = 0;
+        }
 
-      if ((len = _ipmi_ping_build (info, buf, IPMIDETECTD_BUFLEN)) < 0)
-        err_exit ("_ipmi_ping_build: %s", strerror (errno));
+      memset (bufs[count], '\0', IPMIDETECTD_BUFLEN);
 
-      if (ipmi_lan_sendto (info->fd,
-                           buf,
-                           len,
-                           0,
-                           info->destaddr,
-                           info->destaddr_len) < 0)
-        err_exit ("ipmi_lan_sendto: %s", strerror (errno));
+      if ((len = _ipmi_ping_build (info, bufs[count], IPMIDETECTD_BUFLEN)) < 0)
+        err_exit ("_ipmi_ping_build: %s", strerror (errno));
 
-      if (cmd_args.debug)
-        fprintf (stderr, "Ping Request to %s\n", info->hostname);
+      dgrams[count].buf = bufs[count];
+      dgrams[count].len = len;
+      dgrams[count].addr = info->destaddr;
+      dgrams[count].addrlen = info->destaddr_len;
+      infos[count] = info;
+      count++;
     }
 
+  if (count)
+    _ipmidetectd_send_batch (dgrams, infos, count);
+
   list_iterator_destroy (itr);
 }
 
@@ -507,23 +555,32 @@ _setup_pfds (struct pollfd *pfds)
 static void
 _receive_ping (int fd)
 {
-  struct sockaddr_in6 from6;
-  struct sockaddr *from = (struct sockaddr *)&from6;
+  uint8_t bufs[IPMIDETECTD_NODES_PER_SOCKET][IPMIDETECTD_BUFLEN];
+  struct sockaddr_in6 froms[IPMIDETECTD_NODES_PER_SOCKET];
+  struct network_dgram dgrams[IPMIDETECTD_NODES_PER_SOCKET];
   struct ipmidetectd_info *info;
-  uint8_t buf[IPMIDETECTD_BUFLEN];
   char ipbuf[IPMIDETECTD_BUFLEN + 1];
-  int len;
-  socklen_t fromlen = sizeof (struct sockaddr_in6);
+  int i, count;
+
+  for (i = 0; i < IPMIDETECTD_NODES_PER_SOCKET; i++)
+    {
+      dgrams[i].buf = bufs[i];
+      dgrams[i].len = IPMIDETECTD_BUFLEN;
+      dgrams[i].addr = (struct sockaddr *)&froms[i];
+      dgrams[i].addrlen = sizeof (struct sockaddr_in6);
+    }
 
   /* We're happy as long as we receive something.  We don't bother
    * checking sequence numbers or anything like that.
+   *
+   * Every node on this fd may have replied, so read all the replies
+   * waiting, not just one.  ipmi_lan_recvfrom() is a plain
+   * recvfrom(), so batching the reads loses nothing.
    */
-  len = ipmi_lan_recvfrom (fd,
-                           buf,
-                           IPMIDETECTD_BUFLEN,
-                           0,
-                           from,
-                           &fromlen);
+  count = network_recvmmsg (fd,
+                            dgrams,
+                            IPMIDETECTD_NODES_PER_SOCKET,
+                            0);
 
   /* achu & hliebig:
    *
@@ -554,40 +611,43 @@ _receive_ping (int fd)
    * BMC (or IPMI disabled, etc.), just do the recvfrom again to
    * eventually get a timeout, which is the behavior we'd like.
    */
-  if (len < 0
+  if (count < 0
       && (errno == ECONNRESET
           || errno == ECONNREFUSED))
     return;
 
-  if (len < 0)
-    err_exit ("ipmi_lan_recvfrom: %s", strerror (errno));
+  if (count < 0)
+    err_exit ("network_recvmmsg: %s", strerror (errno));
 
-  memset (ipbuf, '\0', IPMIDETECTD_BUFLEN + 1);
-  if (from6.sin6_family == AF_INET6)
+  for (i = 0; i < count; i++)
     {
-      if (!inet_ntop (AF_INET6, &from6.sin6_addr, ipbuf, IPMIDETECTD_BUFLEN))
-        err_exit ("inet_ntop: %s", strerror (errno));
-    }
-  else
-    {
-      /* memcpy hacks to avoid warnings, i.e.
-       * warning: dereferencing pointer 'X' does break strict-aliasing rules
-       */
-      struct sockaddr_in from4;
+      memset (ipbuf, '\0', IPMIDETECTD_BUFLEN + 1);
+      if (froms[i].sin6_family == AF_INET6)
+        {
+          if (!inet_ntop (AF_INET6, &froms[i].sin6_addr, ipbuf, IPMIDETECTD_BUFLEN))
+            err_exit ("inet_ntop: %s", strerror (errno));
+        }
+      else
+        {
+          /* memcpy hacks to avoid warnings, i.e.
+           * warning: dereferencing pointer 'X' does break strict-aliasing rules
+           */
+          struct sockaddr_in from4;
 
-      memcpy (&from4, from, fromlen);
+          memcpy (&from4, &froms[i], dgrams[i].addrlen);
 
-      if (!inet_ntop (AF_INET, &from4.sin_addr, ipbuf, IPMIDETECTD_BUFLEN))
-        err_exit ("inet_ntop: %s", strerror (errno));
-    }
+          if (!inet_ntop (AF_INET, &from4.sin_addr, ipbuf, IPMIDETECTD_BUFLEN))
+            err_exit ("inet_ntop: %s", strerror (errno));
+        }
 
-  if ((info = hash_find (nodes_index, ipbuf)))
-    {
-      if (gettimeofday (&(info->last_received), NULL) < 0)
-        err_exit ("gettimeofday: %s", strerror (errno));
+      if ((info = hash_find (nodes_index, ipbuf)))
+        {
+          if (gettimeofday (&(info->last_received), NULL) < 0)
+            err_exit ("gettimeofday: %s", strerror (errno));
 
-      if (cmd_args.debug)
-        fprintf (stderr, "Ping Reply from %s\n", info->hostname);
+          if (cmd_args.debug)
+            fprintf (stderr, "Ping Reply from %s\n", info->hostname);
+        }
     }
 }
 
@@ -56,6 +56,10 @@
 #include <fcntl.h>
 #endif /* HAVE_FCNTL_H */
 #include <netinet/in.h>
+#include <pthread.h>
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif /* HAVE_SYS_EPOLL_H */
 #include <errno.h>
 
 #include "ipmipower.h"
@@ -63,6 +67,7 @@
 #include "ipmipower_connection.h"
 #include "ipmipower_error.h"
 #include "ipmipower_oem.h"
+#include "ipmipower_output.h"
 #include "ipmipower_powercmd.h"
 #include "ipmipower_prompt.h"
 #include "ipmipower_ping.h"
@@ -71,9 +76,20 @@
 #include "freeipmi-portability.h"
 #include "cbuf.h"
 #include "fi_hostlist.h"
+#include "network.h"
 #include "tool-common.h"
 #include "tool-util-common.h"
 
+#define IPMIPOWER_EPOLL_MAX_EVENTS 1024
+
+/* a packet queued on a --shared-sockets socket */
+struct ipmipower_shared_send
+{
+  struct ipmipower_socket *sock;
+  ipmipower_connection_t ic;
+  cbuf_t cbuf;
+};
+
 cbuf_t ttyin;
 cbuf_t ttyout;
 
@@ -91,6 +107,10 @@ fi_hostlist_t output_hostrange[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 /* Array of outputs for determining exit value */
 unsigned int output_counts[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 
+/* Count of --threads workers that have finished */
+static pthread_mutex_t threads_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int threads_done = 0;
+
 static void
 _ipmipower_setup (void)
 {
@@ -268,10 +288,47 @@ _sendto (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
     }
 }
 
+static void
+_cbuf_write_packet (cbuf_t cbuf, uint8_t *buf, int len)
+{
+  int n, dropped = 0;
+
+  /* cbuf should be empty, but if it isn't, empty it */
+  if (!cbuf_is_empty (cbuf))
+    {
+      IPMIPOWER_DEBUG (("cbuf not empty, draining"));
+      do
+        {
+          uint8_t tempbuf[IPMIPOWER_PACKET_BUFLEN];
+
+          if (cbuf_read (cbuf, tempbuf, IPMIPOWER_PACKET_BUFLEN) < 0)
+            {
+              IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+              exit (EXIT_FAILURE);
+            }
+        } while(!cbuf_is_empty (cbuf));
+    }
+
+  if ((n = cbuf_write (cbuf, buf, len, &dropped)) < 0)
+    {
+      IPMIPOWER_ERROR (("cbuf_write: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  if (n != len)
+    {
+      IPMIPOWER_ERROR (("cbuf_write: len=%d n=%d", len, n));
+      exit (EXIT_FAILURE);
+    }
+
+  if (dropped)
+    IPMIPOWER_DEBUG (("cbuf_write: read dropped %d bytes", dropped));
+}
+
 static void
 _recvfrom (cbuf_t cbuf, int fd, struct sockaddr *srcaddr, socklen_t srcaddrlen)
 {
-  int n, rv, dropped = 0;
+  int rv;
   uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
   struct sockaddr_in6 from6;
   struct sockaddr *from = (struct sockaddr *)&from6;
@@ -364,81 +421,720 @@ _recvfrom (cbuf_t cbuf, int fd, struct sockaddr *srcaddr, socklen_t srcaddrlen)
         return;
     }
 
-  /* cbuf should be empty, but if it isn't, empty it */
-  if (!cbuf_is_empty (cbuf))
+  _cbuf_write_packet (cbuf, buf, rv);
+}
+
+/* _shared_recvfrom
+ * - read packets waiting on a --shared-sockets socket and hand them
+ *   to the connections they came from
+ */
+static void
+_shared_recvfrom (struct ipmipower_socket *sock)
+{
+  uint8_t bufs[IPMIPOWER_CONNECTIONS_PER_SOCKET][IPMIPOWER_PACKET_BUFLEN];
+  struct sockaddr_in6 froms[IPMIPOWER_CONNECTIONS_PER_SOCKET];
+  struct network_dgram dgrams[IPMIPOWER_CONNECTIONS_PER_SOCKET];
+  unsigned int count = 0;
+
+  assert (sock);
+
+  /* A shared socket may have a reply waiting for every connection on
+   * it, so read until empty rather than one packet per poll.
+   *
+   * ipmi_lan_recvfrom() is a plain recvfrom(), so batching the reads
+   * loses nothing.
+   */
+  while (count <= sock->connections_count)
     {
-      IPMIPOWER_DEBUG (("cbuf not empty, draining"));
-      do
+      int i, rv;
+
+      for (i = 0; i < IPMIPOWER_CONNECTIONS_PER_SOCKET; i++)
         {
-          uint8_t tempbuf[IPMIPOWER_PACKET_BUFLEN];
+          dgrams[i].buf = bufs[i];
+          dgrams[i].len = IPMIPOWER_PACKET_BUFLEN;
+          dgrams[i].addr = (struct sockaddr *)&froms[i];
+          dgrams[i].addrlen = sizeof (struct sockaddr_in6);
+        }
 
-          if (cbuf_read (cbuf, tempbuf, IPMIPOWER_PACKET_BUFLEN) < 0)
+      if ((rv = network_recvmmsg (sock->fd,
+                                  dgrams,
+                                  IPMIPOWER_CONNECTIONS_PER_SOCKET,
+                                  MSG_DONTWAIT)) < 0)
+        {
+          if (errno == EAGAIN
+              || errno == EWOULDBLOCK)
+            break;
+
+          /* See comments in _recvfrom() regarding ECONNRESET/ECONNREFUSED */
+          if (errno == ECONNRESET
+              || errno == ECONNREFUSED)
             {
-              IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+              IPMIPOWER_DEBUG (("network_recvmmsg: connection refused: %s", strerror (errno)));
+              count++;
+              continue;
+            }
+
+          IPMIPOWER_ERROR (("network_recvmmsg: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      for (i = 0; i < rv; i++)
+        {
+          ipmipower_connection_t ic;
+
+          if (!dgrams[i].len)
+            {
+              IPMIPOWER_ERROR (("network_recvmmsg: EOF"));
               exit (EXIT_FAILURE);
             }
-        } while(!cbuf_is_empty (cbuf));
+
+          if (!(ic = ipmipower_connection_socket_find (sock, dgrams[i].addr)))
+            {
+              IPMIPOWER_DEBUG (("packet from unknown address dropped"));
+              continue;
+            }
+
+          _cbuf_write_packet (sock->ping ? ic->ping_in : ic->ipmi_in,
+                              bufs[i],
+                              dgrams[i].len);
+        }
+
+      count += rv;
+
+      if (rv < IPMIPOWER_CONNECTIONS_PER_SOCKET)
+        break;
+    }
+}
+
+/* _shared_sendto
+ * - send queued packets for connections sharing one socket with as
+ *   few system calls as possible
+ */
+static void
+_shared_sendto (struct ipmipower_shared_send *sends, unsigned int count)
+{
+  uint8_t bufs[IPMIPOWER_CONNECTIONS_PER_SOCKET][IPMIPOWER_PACKET_BUFLEN];
+  struct network_dgram dgrams[IPMIPOWER_CONNECTIONS_PER_SOCKET];
+  unsigned int i, sent = 0;
+
+  assert (sends);
+  assert (count && count <= IPMIPOWER_CONNECTIONS_PER_SOCKET);
+
+  for (i = 0; i < count; i++)
+    {
+      int n;
+
+      assert (sends[i].sock == sends[0].sock);
+
+      if ((n = cbuf_read (sends[i].cbuf, bufs[i], IPMIPOWER_PACKET_BUFLEN)) < 0)
+        {
+          IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      if (n == IPMIPOWER_PACKET_BUFLEN)
+        {
+          IPMIPOWER_ERROR (("cbuf_read: buffer full"));
+          exit (EXIT_FAILURE);
+        }
+
+      /* cbuf should be empty now */
+      if (!cbuf_is_empty (sends[i].cbuf))
+        {
+          IPMIPOWER_ERROR (("cbuf not empty"));
+          exit (EXIT_FAILURE);
+        }
+
+      /* ipmi_lan_sendto() and ipmi_rmcpplus_sendto() are plain
+       * sendto()s, see _sendto()
+       */
+      dgrams[i].buf = bufs[i];
+      dgrams[i].len = n;
+      dgrams[i].addr = sends[i].ic->destaddr;
+      dgrams[i].addrlen = sends[i].ic->destaddrlen;
     }
 
-  if ((n = cbuf_write (cbuf, buf, rv, &dropped)) < 0)
+  while (sent < count)
     {
-      IPMIPOWER_ERROR (("cbuf_write: %s", strerror (errno)));
+      int rv;
+
+      if ((rv = network_sendmmsg (sends[0].sock->fd,
+                                  dgrams + sent,
+                                  count - sent,
+                                  0)) < 0)
+        {
+          IPMIPOWER_ERROR (("network_sendmmsg: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      sent += rv;
+    }
+}
+
+static int
+_shared_send_cmp (const void *a, const void *b)
+{
+  const struct ipmipower_shared_send *sa = a;
+  const struct ipmipower_shared_send *sb = b;
+
+  return (sa->sock->pfds_index - sb->sock->pfds_index);
+}
+
+/* _poll_loop_timeout
+ * - process pending power commands of a shard and pings, calculate
+ *   the timeout for the next poll
+ * - returns 0 if there is no more work to do, 1 if not
+ */
+static int
+_poll_loop_timeout (int non_interactive, unsigned int shard, int *timeout)
+{
+  int num;
+  int powercmd_timeout = -1;
+  int ping_timeout = -1;
+
+  assert (timeout);
+
+  /* If there are no pending commands before this call,
+   * powercmd_timeout will not be set, leaving it at -1
+   */
+  num = ipmipower_powercmd_process_pending (shard, &powercmd_timeout);
+  if (non_interactive && !num)
+    return (0);
+
+  /* ping timeout is always set if cmd_args.ping_interval > 0 */
+  ipmipower_ping_process_pings (&ping_timeout);
+
+  if (cmd_args.ping_interval)
+    {
+      if (powercmd_timeout == -1)
+        *timeout = ping_timeout;
+      else
+        *timeout = (ping_timeout < powercmd_timeout) ?
+      ping_timeout : powercmd_timeout;
+    }
+  else
+    *timeout = powercmd_timeout;
+
+  return (1);
+}
+
+/* _poll_loop_tty
+ * - read from stdin and write to stdout
+ */
+static void
+_poll_loop_tty (int non_interactive, short stdin_revents, short stdout_revents)
+{
+  if (!non_interactive && (stdin_revents & POLLIN))
+    {
+      int n, dropped = 0;
+
+      if ((n = cbuf_write_from_fd (ttyin, STDIN_FILENO, -1, &dropped)) < 0)
+        {
+          IPMIPOWER_ERROR (("cbuf_write_from_fd: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      /* achu: If you are running ipmipower in co-process mode
+       * with powerman, this error condition will probably be hit
+       * with the file descriptor STDIN_FILENO.  The powerman
+       * daemon is usually closed by /etc/init.d/powerman stop,
+       * which kills a process through a signal.  Thus, powerman
+       * closes stdin and stdout pipes to ipmipower and the call
+       * to cbuf_write_from_fd will give us an EOF reading.  We'll
+       * consider this EOF an "ok" error.  No need to output an
+       * error message.
+       */
+      if (!n)
+        exit (EXIT_FAILURE);
+
+      if (dropped)
+        IPMIPOWER_DEBUG (("cbuf_write_from_fd: read dropped %d bytes", dropped));
+    }
+
+  if (!cbuf_is_empty (ttyout) && (stdout_revents & POLLOUT))
+    {
+      if (cbuf_read_to_fd (ttyout, STDOUT_FILENO, -1) < 0)
+        {
+          IPMIPOWER_ERROR (("cbuf_read_to_fd: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+    }
+}
+
+#if HAVE_SYS_EPOLL_H
+static void
+_epoll_update_fd (int epfd,
+                  int fd,
+                  cbuf_t out,
+                  uint64_t data,
+                  int *registered_fd,
+                  unsigned int *registered_events)
+{
+  struct epoll_event ev;
+  unsigned int events;
+
+  assert (epfd >= 0);
+  assert (fd >= 0);
+  assert (out);
+  assert (registered_fd);
+  assert (registered_events);
+
+  events = EPOLLIN;
+  if (!cbuf_is_empty (out))
+    events |= EPOLLOUT;
+
+  /* The ipmi fd is replaced on some retransmissions, see
+   * _retry_packets() in ipmipower_powercmd.c.  The old fd is kept
+   * open for a while, so it must be removed by hand.
+   */
+  if (*registered_fd >= 0 && *registered_fd != fd)
+    {
+      if (epoll_ctl (epfd, EPOLL_CTL_DEL, *registered_fd, NULL) < 0
+          && errno != EBADF
+          && errno != ENOENT)
+        {
+          IPMIPOWER_ERROR (("epoll_ctl: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+      *registered_fd = -1;
+    }
+
+  if (*registered_fd == fd && *registered_events == events)
+    return;
+
+  memset (&ev, '\0', sizeof (struct epoll_event));
+  ev.events = events;
+  ev.data.u64 = data;
+
+  if (epoll_ctl (epfd,
+                 (*registered_fd < 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+                 fd,
+                 &ev) < 0)
+    {
+      IPMIPOWER_ERROR (("epoll_ctl: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
 
-  if (n != rv)
+  *registered_fd = fd;
+  *registered_events = events;
+}
+
+/* _epoll_loop
+ * - like _poll_loop, but connection fds are registered once with
+ *   epoll and only connections with activity are looked at.
+ * - returns -1 if epoll is not available
+ */
+static int
+_epoll_loop (int non_interactive, unsigned int shard)
+{
+  struct epoll_event *events = NULL;
+  struct pollfd pfds[3];
+  int epfd;
+  int nfds;
+
+  /* size is only a hint */
+  if ((epfd = epoll_create (IPMIPOWER_EPOLL_MAX_EVENTS)) < 0)
+    {
+      IPMIPOWER_DEBUG (("epoll_create: %s", strerror (errno)));
+      return (-1);
+    }
+
+  if (!(events = (struct epoll_event *)malloc (sizeof (struct epoll_event) * IPMIPOWER_EPOLL_MAX_EVENTS)))
     {
-      IPMIPOWER_ERROR (("cbuf_write: rv=%d n=%d", rv, n));
+      IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
 
-  if (dropped)
-    IPMIPOWER_DEBUG (("cbuf_write: read dropped %d bytes", dropped));
+  /* stdin and stdout may be regular files, which epoll can't handle,
+   * so they are polled alongside the epoll fd.  With --threads, the
+   * main thread writes stdout instead, see _threads_loop().
+   */
+  if (cmd_args.threads > 1)
+    nfds = 1;
+  else
+    nfds = 2 + (non_interactive ? 0 : 1);
+
+  while (non_interactive || ipmipower_prompt_process_cmdline ())
+    {
+      ipmipower_connection_t ic;
+      int i, n, timeout;
+
+      if (!_poll_loop_timeout (non_interactive, shard, &timeout))
+        break;
+
+      while ((ic = ipmipower_connection_next_updated (shard)))
+        {
+          uint64_t index = ic - ics;
+
+          _epoll_update_fd (epfd,
+                            ic->ipmi_fd,
+                            ic->ipmi_out,
+                            index * 2,
+                            &ic->registered_ipmi_fd,
+                            &ic->registered_ipmi_events);
+
+          _epoll_update_fd (epfd,
+                            ic->ping_fd,
+                            ic->ping_out,
+                            index * 2 + 1,
+                            &ic->registered_ping_fd,
+                            &ic->registered_ping_events);
+        }
+
+      pfds[0].fd = epfd;
+      pfds[0].events = POLLIN;
+      pfds[0].revents = 0;
+      if (nfds > 1)
+        {
+          pfds[1].fd = STDOUT_FILENO;
+          if (!cbuf_is_empty (ttyout))
+            pfds[1].events = POLLOUT;
+          else
+            pfds[1].events = 0;
+          pfds[1].revents = 0;
+        }
+      if (nfds > 2)
+        {
+          pfds[2].fd = STDIN_FILENO;
+          pfds[2].events = POLLIN;
+          pfds[2].revents = 0;
+        }
+
+      ipmipower_poll (pfds, nfds, timeout);
+
+      if (pfds[0].revents & POLLIN)
+        {
+          if ((n = epoll_wait (epfd, events, IPMIPOWER_EPOLL_MAX_EVENTS, 0)) < 0)
+            {
+              if (errno != EINTR)
+                {
+                  IPMIPOWER_ERROR (("epoll_wait: %s", strerror (errno)));
+                  exit (EXIT_FAILURE);
+                }
+              n = 0;
+            }
+
+          for (i = 0; i < n; i++)
+            {
+              int fd;
+              cbuf_t in, out;
+
+              assert ((events[i].data.u64 / 2) < ics_len);
+
+              ic = &ics[events[i].data.u64 / 2];
+
+              if (!(events[i].data.u64 % 2))
+                {
+                  fd = ic->ipmi_fd;
+                  in = ic->ipmi_in;
+                  out = ic->ipmi_out;
+                }
+              else
+                {
+                  fd = ic->ping_fd;
+                  in = ic->ping_in;
+                  out = ic->ping_out;
+                }
+
+              if (events[i].events & EPOLLERR)
+                {
+                  IPMIPOWER_DEBUG (("host = %s; %s EPOLLERR",
+                                    ic->hostname,
+                                    (events[i].data.u64 % 2) ? "PING" : "IPMI"));
+                  /* See comments in _ipmi_recvfrom() regarding ECONNRESET/ECONNREFUSED */
+                  _recvfrom (in, fd, ic->destaddr, ic->destaddrlen);
+                  continue;
+                }
+
+              if (events[i].events & EPOLLIN)
+                _recvfrom (in, fd, ic->destaddr, ic->destaddrlen);
+
+              if (events[i].events & EPOLLOUT)
+                {
+                  _sendto (out, fd, ic->destaddr, ic->destaddrlen);
+
+                  /* no longer need EPOLLOUT */
+                  ipmipower_connection_mark_updated (ic);
+                }
+            }
+        }
+
+      if (nfds > 1)
+        _poll_loop_tty (non_interactive,
+                        non_interactive ? 0 : pfds[2].revents,
+                        pfds[1].revents);
+    }
+
+  /* ignore potential error, cleanup path */
+  close (epfd);
+  free (events);
+  return (0);
+}
+#endif /* HAVE_SYS_EPOLL_H */
+
+/* _shared_poll_loop
+ * - like _poll_loop, but polls the --shared-sockets socket pool
+ *   instead of every connection's fds
+ */
+static void
+_shared_poll_loop (int non_interactive)
+{
+  struct pollfd *pfds = NULL;
+  unsigned int pfds_size = 0;
+  ipmipower_connection_t *pending = NULL;
+  unsigned int pending_size = 0;
+  struct ipmipower_shared_send *sends = NULL;
+
+  while (non_interactive || ipmipower_prompt_process_cmdline ())
+    {
+      struct ipmipower_socket **sockets;
+      unsigned int sockets_len = 0;
+      unsigned int pending_count = 0;
+      unsigned int sends_count = 0;
+      unsigned int nfds;
+      ipmipower_connection_t ic;
+      int i, timeout;
+
+      if (!_poll_loop_timeout (non_interactive, 0, &timeout))
+        break;
+
+      /* may grow when sockets are rotated or hosts change */
+      sockets = ipmipower_connection_sockets (&sockets_len);
+
+      /* sockets, stdout, and stdin when interactive */
+      nfds = sockets_len + 1 + (non_interactive ? 0 : 1);
+
+      if (nfds > pfds_size)
+        {
+          free (pfds);
+
+          if (!(pfds = (struct pollfd *)malloc (nfds * sizeof (struct pollfd))))
+            {
+              IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
+              exit (EXIT_FAILURE);
+            }
+          pfds_size = nfds;
+        }
+
+      for (i = 0; i < sockets_len; i++)
+        {
+          pfds[i].fd = sockets[i]->fd;
+          pfds[i].events = POLLIN;
+          pfds[i].revents = 0;
+          sockets[i]->pfds_index = i;
+        }
+
+      /* connections are marked updated when packets are queued */
+      while ((ic = ipmipower_connection_next_updated (0)))
+        {
+          if (cbuf_is_empty (ic->ipmi_out) && cbuf_is_empty (ic->ping_out))
+            continue;
+
+          if (pending_count == pending_size)
+            {
+              ipmipower_connection_t *tmp;
+              struct ipmipower_shared_send *tmp2;
+              unsigned int size;
+
+              size = pending_size ? pending_size * 2 : 64;
+
+              if (!(tmp = (ipmipower_connection_t *)realloc (pending, sizeof (ipmipower_connection_t) * size)))
+                {
+                  IPMIPOWER_ERROR (("realloc: %s", strerror (errno)));
+                  exit (EXIT_FAILURE);
+                }
+
+              pending = tmp;
+              pending_size = size;
+
+              /* at most an ipmi and a ping packet per connection */
+              if (!(tmp2 = (struct ipmipower_shared_send *)realloc (sends, sizeof (struct ipmipower_shared_send) * size * 2)))
+                {
+                  IPMIPOWER_ERROR (("realloc: %s", strerror (errno)));
+                  exit (EXIT_FAILURE);
+                }
+
+              sends = tmp2;
+            }
+
+          pending[pending_count++] = ic;
+
+          if (!cbuf_is_empty (ic->ipmi_out))
+            pfds[ic->ipmi_socket->pfds_index].events |= POLLOUT;
+          if (!cbuf_is_empty (ic->ping_out))
+            pfds[ic->ping_socket->pfds_index].events |= POLLOUT;
+        }
+
+      pfds[sockets_len].fd = STDOUT_FILENO;
+      if (!cbuf_is_empty (ttyout))
+        pfds[sockets_len].events = POLLOUT;
+      else
+        pfds[sockets_len].events = 0;
+      pfds[sockets_len].revents = 0;
+      if (!non_interactive)
+        {
+          pfds[sockets_len + 1].fd = STDIN_FILENO;
+          pfds[sockets_len + 1].events = POLLIN;
+          pfds[sockets_len + 1].revents = 0;
+        }
+
+      ipmipower_poll (pfds, nfds, timeout);
+
+      for (i = 0; i < sockets_len; i++)
+        {
+          if (pfds[i].revents & (POLLIN | POLLERR))
+            _shared_recvfrom (sockets[i]);
+        }
+
+      /* group packets by socket, so each socket's packets go out in
+       * one batch
+       */
+      for (i = 0; i < pending_count; i++)
+        {
+          ic = pending[i];
+
+          if (!cbuf_is_empty (ic->ipmi_out)
+              && (pfds[ic->ipmi_socket->pfds_index].revents & POLLOUT))
+            {
+              sends[sends_count].sock = ic->ipmi_socket;
+              sends[sends_count].ic = ic;
+              sends[sends_count].cbuf = ic->ipmi_out;
+              sends_count++;
+            }
+
+          if (!cbuf_is_empty (ic->ping_out)
+              && (pfds[ic->ping_socket->pfds_index].revents & POLLOUT))
+            {
+              sends[sends_count].sock = ic->ping_socket;
+              sends[sends_count].ic = ic;
+              sends[sends_count].cbuf = ic->ping_out;
+              sends_count++;
+            }
+        }
+
+      if (sends_count > 1)
+        qsort (sends,
+               sends_count,
+               sizeof (struct ipmipower_shared_send),
+               _shared_send_cmp);
+
+      for (i = 0; i < sends_count; )
+        {
+          unsigned int j = i + 1;
+
+          while (j < sends_count
+                 && sends[j].sock == sends[i].sock
+                 && (j - i) < IPMIPOWER_CONNECTIONS_PER_SOCKET)
+            j++;
+
+          _shared_sendto (&sends[i], j - i);
+          i = j;
+        }
+
+      for (i = 0; i < pending_count; i++)
+        {
+          ic = pending[i];
+
+          /* try again next time around */
+          if (!cbuf_is_empty (ic->ipmi_out) || !cbuf_is_empty (ic->ping_out))
+            ipmipower_connection_mark_updated (ic);
+        }
+
+      _poll_loop_tty (non_interactive,
+                      non_interactive ? 0 : pfds[sockets_len + 1].revents,
+                      pfds[sockets_len].revents);
+    }
+
+  free (pfds);
+  free (pending);
+  free (sends);
+}
+
+/* _shard_range
+ * - find the connections of a shard, which are contiguous, see
+ *   ipmipower_connection_array_create()
+ */
+static void
+_shard_range (unsigned int shard,
+              struct ipmipower_connection **shard_ics,
+              unsigned int *shard_ics_len)
+{
+  unsigned int i;
+
+  assert (shard_ics);
+  assert (shard_ics_len);
+
+  *shard_ics = ics;
+  *shard_ics_len = 0;
+
+  for (i = 0; i < ics_len; i++)
+    {
+      if (ics[i].shard != shard)
+        continue;
+
+      if (!(*shard_ics_len))
+        *shard_ics = &ics[i];
+      (*shard_ics_len)++;
+    }
 }
 
 /* _poll_loop
- * - poll on all descriptors
+ * - poll on all descriptors of a shard
  */
 static void
-_poll_loop (int non_interactive)
+_poll_loop (int non_interactive, unsigned int shard)
 {
   int nfds = 0;
   struct pollfd *pfds = NULL;
+  struct ipmipower_connection *shard_ics = NULL;
+  unsigned int shard_ics_len = 0;
   int extra_fds;
 
+  if (cmd_args.shared_sockets)
+    {
+      _shared_poll_loop (non_interactive);
+      return;
+    }
+
+#if HAVE_SYS_EPOLL_H
+  if (!_epoll_loop (non_interactive, shard))
+    return;
+#endif /* HAVE_SYS_EPOLL_H */
+
   /* number of fds for stdin and stdout we'll need when polling
    *
-   * Right now, always poll stdout.  When non-interactive,
-   * don't need stdin
+   * Right now, always poll stdout, unless the main thread is
+   * writing it for --threads.  When non-interactive, don't need
+   * stdin
    */
-  extra_fds = 1 + (non_interactive ? 0 : 1);
+  if (cmd_args.threads > 1)
+    extra_fds = 0;
+  else
+    extra_fds = 1 + (non_interactive ? 0 : 1);
+
+  /* The hosts of a --threads worker never change, find them once.
+   * Otherwise the only shard is every host, which the prompt may
+   * replace, see below.
+   */
+  if (cmd_args.threads > 1)
+    _shard_range (shard, &shard_ics, &shard_ics_len);
 
   while (non_interactive || ipmipower_prompt_process_cmdline ())
     {
-      int i, num, timeout;
-      int powercmd_timeout = -1;
-      int ping_timeout = -1;
+      int i, timeout;
 
-      /* If there are no pending commands before this call,
-       * powercmd_timeout will not be set, leaving it at -1
-       */
-      num = ipmipower_powercmd_process_pending (&powercmd_timeout);
-      if (non_interactive && !num)
+      if (!_poll_loop_timeout (non_interactive, shard, &timeout))
         break;
 
-      /* ping timeout is always set if cmd_args.ping_interval > 0 */
-      ipmipower_ping_process_pings (&ping_timeout);
+      /* only used by the epoll loop */
+      while (ipmipower_connection_next_updated (shard))
+        ;
 
-      if (cmd_args.ping_interval)
+      if (cmd_args.threads == 1)
         {
-          if (powercmd_timeout == -1)
-            timeout = ping_timeout;
-          else
-            timeout = (ping_timeout < powercmd_timeout) ?
-          ping_timeout : powercmd_timeout;
+          shard_ics = ics;
+          shard_ics_len = ics_len;
         }
-      else
-        timeout = powercmd_timeout;
 
       /* achu: I always wonder if this poll() loop could be done far
        * more elegantly and efficiently without all this crazy
@@ -451,15 +1147,18 @@ _poll_loop (int non_interactive)
        * changing.  By going to a callback/event mechanism, there will
        * still be some O(n) activities within the code, so I am only
        * going to create a more efficient O(n) poll loop.
+       *
+       * This is now only the fallback when epoll isn't available,
+       * see _epoll_loop().
        */
 
       /* Has the number of hosts changed? */
-      if (nfds != (ics_len*2) + extra_fds)
+      if (nfds != (shard_ics_len*2) + extra_fds)
         {
           /* The "*2" is for each host's two fds, one for ipmi
            * (ipmi_fd) and one for rmcp (ping_fd).
            */
-          nfds = (ics_len*2) + extra_fds;
+          nfds = (shard_ics_len*2) + extra_fds;
           free (pfds);
 
           if (!(pfds = (struct pollfd *)malloc (nfds * sizeof (struct pollfd))))
@@ -469,55 +1168,58 @@ _poll_loop (int non_interactive)
             }
         }
 
-      for (i = 0; i < ics_len; i++)
+      for (i = 0; i < shard_ics_len; i++)
         {
-          pfds[i*2].fd = ics[i].ipmi_fd;
-          pfds[i*2+1].fd = ics[i].ping_fd;
+          pfds[i*2].fd = shard_ics[i].ipmi_fd;
+          pfds[i*2+1].fd = shard_ics[i].ping_fd;
           pfds[i*2].events = pfds[i*2+1].events = 0;
           pfds[i*2].revents = pfds[i*2+1].revents = 0;
 
           pfds[i*2].events |= POLLIN;
-          if (!cbuf_is_empty (ics[i].ipmi_out))
+          if (!cbuf_is_empty (shard_ics[i].ipmi_out))
             pfds[i*2].events |= POLLOUT;
 
           if (!cmd_args.ping_interval)
             continue;
 
           pfds[i*2+1].events |= POLLIN;
-          if (!cbuf_is_empty (ics[i].ping_out))
+          if (!cbuf_is_empty (shard_ics[i].ping_out))
             pfds[i*2+1].events |= POLLOUT;
         }
 
-      if (!non_interactive)
+      if (extra_fds > 1)
         {
           pfds[nfds-2].fd = STDIN_FILENO;
           pfds[nfds-2].events = POLLIN;
           pfds[nfds-2].revents = 0;
         }
-      pfds[nfds-1].fd = STDOUT_FILENO;
-      if (!cbuf_is_empty (ttyout))
-        pfds[nfds-1].events = POLLOUT;
-      else
-        pfds[nfds-1].events = 0;
-      pfds[nfds-1].revents = 0;
+      if (extra_fds)
+        {
+          pfds[nfds-1].fd = STDOUT_FILENO;
+          if (!cbuf_is_empty (ttyout))
+            pfds[nfds-1].events = POLLOUT;
+          else
+            pfds[nfds-1].events = 0;
+          pfds[nfds-1].revents = 0;
+        }
 
       ipmipower_poll (pfds, nfds, timeout);
 
-      for (i = 0; i < ics_len; i++)
+      for (i = 0; i < shard_ics_len; i++)
         {
           if (pfds[i*2].revents & POLLERR)
             {
-              IPMIPOWER_DEBUG (("host = %s; IPMI POLLERR", ics[i].hostname));
+              IPMIPOWER_DEBUG (("host = %s; IPMI POLLERR", shard_ics[i].hostname));
               /* See comments in _ipmi_recvfrom() regarding ECONNRESET/ECONNREFUSED */
-              _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+              _recvfrom (shard_ics[i].ipmi_in, shard_ics[i].ipmi_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
             }
           else
             {
               if (pfds[i*2].revents & POLLIN)
-                _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+                _recvfrom (shard_ics[i].ipmi_in, shard_ics[i].ipmi_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
 
               if (pfds[i*2].revents & POLLOUT)
-                _sendto (ics[i].ipmi_out, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+                _sendto (shard_ics[i].ipmi_out, shard_ics[i].ipmi_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
             }
 
           if (!cmd_args.ping_interval)
@@ -525,57 +1227,186 @@ _poll_loop (int non_interactive)
 
           if (pfds[i*2+1].revents & POLLERR)
             {
-              IPMIPOWER_DEBUG (("host = %s; PING_POLLERR", ics[i].hostname));
-              _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+              IPMIPOWER_DEBUG (("host = %s; PING_POLLERR", shard_ics[i].hostname));
+              _recvfrom (shard_ics[i].ping_in, shard_ics[i].ping_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
             }
           else
             {
               if (pfds[i*2+1].revents & POLLIN)
-                _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+                _recvfrom (shard_ics[i].ping_in, shard_ics[i].ping_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
 
               if (pfds[i*2+1].revents & POLLOUT)
-                _sendto (ics[i].ping_out, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+                _sendto (shard_ics[i].ping_out, shard_ics[i].ping_fd, shard_ics[i].destaddr, shard_ics[i].destaddrlen);
             }
         }
 
-      if (!non_interactive && (pfds[nfds-2].revents & POLLIN))
+      if (extra_fds)
+        _poll_loop_tty (non_interactive,
+                        non_interactive ? 0 : pfds[nfds-2].revents,
+                        pfds[nfds-1].revents);
+    }
+
+  free (pfds);
+}
+
+static void *
+_thread_poll_loop (void *arg)
+{
+  unsigned int shard;
+  int perr;
+
+  assert (arg);
+
+  shard = *((unsigned int *)arg);
+
+  _poll_loop (1, shard);
+
+  if ((perr = pthread_mutex_lock (&threads_mutex)))
+    {
+      IPMIPOWER_ERROR (("pthread_mutex_lock: %s", strerror (perr)));
+      exit (EXIT_FAILURE);
+    }
+
+  threads_done++;
+
+  if ((perr = pthread_mutex_unlock (&threads_mutex)))
+    {
+      IPMIPOWER_ERROR (("pthread_mutex_unlock: %s", strerror (perr)));
+      exit (EXIT_FAILURE);
+    }
+
+  ipmipower_output_wakeup ();
+  return (NULL);
+}
+
+/* _threads_loop
+ * - run a _poll_loop() per shard in worker threads, while this
+ *   thread writes their output to stdout
+ */
+static void
+_threads_loop (void)
+{
+  pthread_t threads[IPMIPOWER_THREADS_MAX];
+  unsigned int shards[IPMIPOWER_THREADS_MAX];
+  int notify_fds[2];
+  unsigned int i;
+  int perr;
+
+  assert (cmd_args.threads > 1 && cmd_args.threads <= IPMIPOWER_THREADS_MAX);
+
+  if (pipe (notify_fds) < 0)
+    {
+      IPMIPOWER_ERROR (("pipe: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      int flags;
+
+      if ((flags = fcntl (notify_fds[i], F_GETFL, 0)) < 0)
+        {
+          IPMIPOWER_ERROR (("fcntl: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      if (fcntl (notify_fds[i], F_SETFL, flags | O_NONBLOCK) < 0)
         {
-          int n, dropped = 0;
+          IPMIPOWER_ERROR (("fcntl: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+    }
 
-          if ((n = cbuf_write_from_fd (ttyin, STDIN_FILENO, -1, &dropped)) < 0)
-            {
-              IPMIPOWER_ERROR (("cbuf_write_from_fd: %s", strerror (errno)));
-              exit (EXIT_FAILURE);
-            }
+  ipmipower_output_notify (notify_fds[1]);
 
-          /* achu: If you are running ipmipower in co-process mode
-           * with powerman, this error condition will probably be hit
-           * with the file descriptor STDIN_FILENO.  The powerman
-           * daemon is usually closed by /etc/init.d/powerman stop,
-           * which kills a process through a signal.  Thus, powerman
-           * closes stdin and stdout pipes to ipmipower and the call
-           * to cbuf_write_from_fd will give us an EOF reading.  We'll
-           * consider this EOF an "ok" error.  No need to output an
-           * error message.
-           */
-          if (!n)
-            exit (EXIT_FAILURE);
+  for (i = 0; i < cmd_args.threads; i++)
+    {
+      shards[i] = i;
+
+      if ((perr = pthread_create (&threads[i],
+                                  NULL,
+                                  _thread_poll_loop,
+                                  &shards[i])))
+        {
+          IPMIPOWER_ERROR (("pthread_create: %s", strerror (perr)));
+          exit (EXIT_FAILURE);
+        }
+    }
+
+  while (1)
+    {
+      struct pollfd pfds[2];
+      unsigned int done;
+      int empty;
+
+      if ((perr = pthread_mutex_lock (&threads_mutex)))
+        {
+          IPMIPOWER_ERROR (("pthread_mutex_lock: %s", strerror (perr)));
+          exit (EXIT_FAILURE);
+        }
 
-          if (dropped)
-            IPMIPOWER_DEBUG (("cbuf_write_from_fd: read dropped %d bytes", dropped));
+      done = threads_done;
+
+      if ((perr = pthread_mutex_unlock (&threads_mutex)))
+        {
+          IPMIPOWER_ERROR (("pthread_mutex_unlock: %s", strerror (perr)));
+          exit (EXIT_FAILURE);
         }
 
-      if (!cbuf_is_empty (ttyout) && (pfds[nfds-1].revents & POLLOUT))
+      if (done == cmd_args.threads)
+        break;
+
+      ipmipower_output_lock ();
+      empty = cbuf_is_empty (ttyout);
+      ipmipower_output_unlock ();
+
+      pfds[0].fd = notify_fds[0];
+      pfds[0].events = POLLIN;
+      pfds[0].revents = 0;
+      pfds[1].fd = STDOUT_FILENO;
+      pfds[1].events = empty ? 0 : POLLOUT;
+      pfds[1].revents = 0;
+
+      ipmipower_poll (pfds, 2, -1);
+
+      if (pfds[0].revents & POLLIN)
+        {
+          uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+
+          while (read (notify_fds[0], buf, IPMIPOWER_PACKET_BUFLEN) > 0)
+            ;
+        }
+
+      if (pfds[1].revents & POLLOUT)
         {
+          ipmipower_output_lock ();
           if (cbuf_read_to_fd (ttyout, STDOUT_FILENO, -1) < 0)
             {
               IPMIPOWER_ERROR (("cbuf_read_to_fd: %s", strerror (errno)));
               exit (EXIT_FAILURE);
             }
+          ipmipower_output_unlock ();
         }
     }
 
-  free (pfds);
+  for (i = 0; i < cmd_args.threads; i++)
+    {
+      if ((perr = pthread_join (threads[i], NULL)))
+        {
+          IPMIPOWER_ERROR (("pthread_join: %s", strerror (perr)));
+          exit (EXIT_FAILURE);
+        }
+    }
+
+  ipmipower_output_notify (-1);
+
+  /* ignore potential error, cleanup path */
+  close (notify_fds[0]);
+  /* ignore potential error, cleanup path */
+  close (notify_fds[1]);
+
+  /* each shard skipped this, see ipmipower_powercmd_process_pending() */
+  ipmipower_output_finish ();
 }
 
 int
@@ -595,6 +1426,12 @@ main (int argc, char *argv[])
   else
     ipmipower_error_setup (IPMIPOWER_ERROR_STDERR);
 
+  /* worker threads are only used for power commands passed at the
+   * command line
+   */
+  if (cmd_args.powercmd == IPMIPOWER_POWER_CMD_NONE)
+    cmd_args.threads = 1;
+
   _ipmipower_setup ();
 
   ipmipower_powercmd_setup ();
@@ -706,7 +1543,10 @@ main (int argc, char *argv[])
   /* immediately send out discovery messages upon startup */
   ipmipower_ping_force_discovery_sweep ();
 
-  _poll_loop ((cmd_args.powercmd != IPMIPOWER_POWER_CMD_NONE) ? 1 : 0);
+  if (cmd_args.threads > 1)
+    _threads_loop ();
+  else
+    _poll_loop ((cmd_args.powercmd != IPMIPOWER_POWER_CMD_NONE) ? 1 : 0, 0);
 
   ipmipower_powercmd_cleanup ();
   _ipmipower_cleanup ();
@@ -52,7 +52,9 @@
 
 #include "cbuf.h"
 #include "fi_hostlist.h"
+#include "hash.h"
 #include "list.h"
+#include "rtt.h"
 #include "tool-cmdline-common.h"
 
 #include "ipmidetect.h"
@@ -72,6 +74,25 @@
 
 #define IPMIPOWER_PACKET_BUFLEN                          1024
 
+/* for --shared-sockets */
+#define IPMIPOWER_CONNECTIONS_PER_SOCKET                 32
+
+#define IPMIPOWER_SHARED_KEY_BUFLEN                      64
+
+/* for --threads */
+#define IPMIPOWER_THREADS_MAX                            64
+
+/* for --session-rate, allow bursts of a tenth of a second's packets */
+#define IPMIPOWER_SESSION_RATE_BURST_DIVISOR             10
+
+/* for --session-window */
+#define IPMIPOWER_SESSION_WINDOW_INITIAL                 8
+
+/* for --reuse-sessions, in milliseconds, well under the 60 second
+ * session inactivity timeout most BMCs use
+ */
+#define IPMIPOWER_SESSION_KEEPALIVE_INTERVAL             30000
+
 #define IPMIPOWER_OUTPUT_BUFLEN                          65536
 
 #define IPMI_MAX_SIK_KEY_LENGTH                          64
@@ -270,11 +291,12 @@ typedef enum
     IPMIPOWER_PROTOCOL_STATE_C410X_SLOT_POWER_CONTROL_SENT        = 0x0C,
     IPMIPOWER_PROTOCOL_STATE_CLOSE_SESSION_SENT                   = 0x0D,
     IPMIPOWER_PROTOCOL_STATE_END                                  = 0x0E,
+    IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE                         = 0x0F,
   } ipmipower_protocol_state_t;
 
-#define IPMIPOWER_PROTOCOL_STATE_VALID(__s)    \
-  (((__s) >= IPMIPOWER_PROTOCOL_STATE_START    \
-    && (__s) <= IPMIPOWER_PROTOCOL_STATE_END) ? 1 : 0)
+#define IPMIPOWER_PROTOCOL_STATE_VALID(__s)             \
+  (((__s) >= IPMIPOWER_PROTOCOL_STATE_START             \
+    && (__s) <= IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE) ? 1 : 0)
 
 typedef enum
   {
@@ -383,6 +405,13 @@ struct ipmipower_powercmd {
   int wait_until_on_state;
   int wait_until_off_state;
 
+  /* for --reuse-sessions, see ipmipower_powercmd_queue().
+   * session_reused is cleared once the session answers.
+   */
+  int session_reused;
+  int keepalive;
+  struct timeval time_idle;
+
   struct ipmipower_connection *ic;
 
   fiid_obj_t obj_rmcp_hdr_rq;
@@ -434,6 +463,27 @@ struct ipmipower_powercmd {
   struct ipmipower_powercmd *next;
 };
 
+/* ipmipower_socket
+ * - A socket shared by many connections with --shared-sockets.
+ * Replies are matched to connections by source address and port,
+ * so no two connections on a socket have the same destination.
+ */
+struct ipmipower_socket
+{
+  int fd;
+  int family;
+  /* rmcp pings and ipmi packets come from the same remote port, so
+   * they go through different sockets
+   */
+  int ping;
+  unsigned int connections_count;
+  hash_t connections;
+  /* connection array the socket was created for */
+  unsigned int generation;
+  /* index into the event loop's pollfd array */
+  int pfds_index;
+};
+
 struct ipmipower_connection_extra_arg
 {
   struct ipmipower_connection_extra_arg *next;
@@ -459,6 +509,9 @@ struct ipmipower_connection
   struct timeval last_ipmi_recv;
   struct timeval last_ping_recv;
 
+  /* round trip time estimate, for the retransmission timeout */
+  struct rtt rtt;
+
   ipmipower_link_state_t link_state;
   unsigned int ping_last_packet_recv_flag;
   unsigned int ping_packet_count_send;
@@ -480,6 +533,21 @@ struct ipmipower_connection
 
   /* for eliminate option */
   int skip;
+
+  /* for --threads, the worker thread this connection belongs to */
+  unsigned int shard;
+
+  /* for the event loop, see ipmipower_connection_mark_updated() */
+  int updated;
+  int registered_ipmi_fd;
+  int registered_ping_fd;
+  unsigned int registered_ipmi_events;
+  unsigned int registered_ping_events;
+
+  /* for --shared-sockets, ipmi_fd and ping_fd belong to these */
+  struct ipmipower_socket *ipmi_socket;
+  struct ipmipower_socket *ping_socket;
+  char shared_key[IPMIPOWER_SHARED_KEY_BUFLEN + 1];
 };
 
 typedef struct ipmipower_powercmd *ipmipower_powercmd_t;
@@ -508,6 +576,11 @@ enum ipmipower_argp_option_keys
     PING_PACKET_COUNT_KEY = 174,
     PING_PERCENT_KEY = 175,
     PING_CONSEC_COUNT_KEY = 176,
+    SHARED_SOCKETS_KEY = 177,
+    THREADS_KEY = 178,
+    SESSION_RATE_KEY = 179,
+    SESSION_WINDOW_KEY = 180,
+    REUSE_SESSIONS_KEY = 181,
   };
 
 struct ipmipower_arguments
@@ -530,6 +603,11 @@ struct ipmipower_arguments
   unsigned int ping_packet_count;
   unsigned int ping_percent;
   unsigned int ping_consec_count;
+  int shared_sockets;
+  unsigned int threads;
+  unsigned int session_rate;
+  unsigned int session_window;
+  int reuse_sessions;
 };
 
 #endif /* IPMIPOWER_H */
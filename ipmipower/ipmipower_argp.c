@@ -116,9 +116,19 @@ static struct argp_option cmdline_options[] =
       "Specify the ping percent value.", 57},
     { "ping-consec-count", PING_CONSEC_COUNT_KEY, "COUNT", 0,
       "Specify the ping consecutive count.", 58},
+    { "shared-sockets", SHARED_SOCKETS_KEY, 0, 0,
+      "Multiplex many hosts over a small pool of sockets.", 59},
+    { "threads", THREADS_KEY, "NUM", 0,
+      "Specify the number of worker threads to split hosts between.", 60},
+    { "session-rate", SESSION_RATE_KEY, "NUM", 0,
+      "Specify the maximum session starts and retransmissions per second.", 61},
+    { "session-window", SESSION_WINDOW_KEY, "COUNT", 0,
+      "Specify the maximum sessions in flight, adjusted to packet loss.", 62},
+    { "reuse-sessions", REUSE_SESSIONS_KEY, 0, 0,
+      "Keep sessions open between power control operations in interactive mode.", 63},
 #ifndef NDEBUG
     { "rmcpdump", RMCPDUMP_KEY, 0, 0,
-      "Turn on RMCP packet dump output.", 59},
+      "Turn on RMCP packet dump output.", 64},
 #endif
     { NULL, 0, NULL, 0, NULL, 0}
   };
@@ -285,6 +295,49 @@ cmdline_parse (int key,
         }
       cmd_args->ping_consec_count = tmp;
       break;
+    case SHARED_SOCKETS_KEY:       /* --shared-sockets */
+      cmd_args->shared_sockets++;
+      break;
+    case THREADS_KEY:       /* --threads */
+      errno = 0;
+      tmp = strtol (arg, &endptr, 10);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp <= 0
+          || tmp > IPMIPOWER_THREADS_MAX)
+        {
+          fprintf (stderr, "threads invalid\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->threads = tmp;
+      break;
+    case SESSION_RATE_KEY:       /* --session-rate */
+      errno = 0;
+      tmp = strtol (arg, &endptr, 10);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp < 0)
+        {
+          fprintf (stderr, "session rate invalid\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->session_rate = tmp;
+      break;
+    case SESSION_WINDOW_KEY:       /* --session-window */
+      errno = 0;
+      tmp = strtol (arg, &endptr, 10);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp < 0)
+        {
+          fprintf (stderr, "session window invalid\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->session_window = tmp;
+      break;
+    case REUSE_SESSIONS_KEY:       /* --reuse-sessions */
+      cmd_args->reuse_sessions++;
+      break;
       /* removed legacy short options */
     default:
       return (common_parse_opt (key, arg, &(cmd_args->common_args)));
@@ -338,6 +391,16 @@ _ipmipower_config_file_parse (struct ipmipower_arguments *cmd_args)
     cmd_args->ping_percent = config_file_data.ping_percent;
   if (config_file_data.ping_consec_count_count)
     cmd_args->ping_consec_count = config_file_data.ping_consec_count;
+  if (config_file_data.shared_sockets_count)
+    cmd_args->shared_sockets = config_file_data.shared_sockets;
+  if (config_file_data.threads_count)
+    cmd_args->threads = config_file_data.threads;
+  if (config_file_data.session_rate_count)
+    cmd_args->session_rate = config_file_data.session_rate;
+  if (config_file_data.session_window_count)
+    cmd_args->session_window = config_file_data.session_window;
+  if (config_file_data.reuse_sessions_count)
+    cmd_args->reuse_sessions = config_file_data.reuse_sessions;
 }
 
 static void
@@ -374,6 +437,18 @@ _ipmipower_args_validate (struct ipmipower_arguments *cmd_args)
       fprintf (stderr, "ping consec count larger than ping packet count\n");
       exit (EXIT_FAILURE);
     }
+
+  if (!cmd_args->threads || cmd_args->threads > IPMIPOWER_THREADS_MAX)
+    {
+      fprintf (stderr, "threads invalid\n");
+      exit (EXIT_FAILURE);
+    }
+
+  if (cmd_args->shared_sockets && cmd_args->threads > 1)
+    {
+      fprintf (stderr, "shared sockets cannot be used with threads\n");
+      exit (EXIT_FAILURE);
+    }
 }
 
 void
@@ -407,6 +482,11 @@ ipmipower_argp_parse (int argc, char **argv, struct ipmipower_arguments *cmd_arg
   cmd_args->ping_packet_count = 10;
   cmd_args->ping_percent = 50;
   cmd_args->ping_consec_count = 5;
+  cmd_args->shared_sockets = 0;
+  cmd_args->threads = 1;
+  cmd_args->session_rate = 0;
+  cmd_args->session_window = 0;
+  cmd_args->reuse_sessions = 0;
 
   argp_parse (&cmdline_config_file_argp,
               argc,
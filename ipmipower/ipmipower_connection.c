@@ -60,12 +60,30 @@
 #include "freeipmi-portability.h"
 #include "cbuf.h"
 #include "fi_hostlist.h"
+#include "hash.h"
 #include "network.h"
 
 extern cbuf_t ttyout;
 
 extern struct ipmipower_arguments cmd_args;
 
+/* connections marked by ipmipower_connection_mark_updated(), one
+ * list per --threads shard
+ */
+static ipmipower_connection_t *ics_updated[IPMIPOWER_THREADS_MAX];
+static unsigned int ics_updated_count[IPMIPOWER_THREADS_MAX];
+static unsigned int ics_updated_size[IPMIPOWER_THREADS_MAX];
+
+/* socket pool for --shared-sockets */
+static struct ipmipower_socket **sockets = NULL;
+static unsigned int sockets_count = 0;
+static unsigned int sockets_size = 0;
+
+/* The prompt creates a new connection array before destroying the
+ * old one, so each array's sockets are tagged with a generation.
+ */
+static unsigned int sockets_generation = 0;
+
 #define IPMIPOWER_MIN_CONNECTION_BUF 1024*2
 #define IPMIPOWER_MAX_CONNECTION_BUF 1024*4
 
@@ -110,7 +128,12 @@ ipmipower_connection_clear (struct ipmipower_connection *ic)
 {
   assert (ic);
 
-  _clean_fd (ic->ipmi_fd);
+  /* A shared socket carries packets for other hosts.  Stale packets
+   * for this host have already been moved to ipmi_in, which is
+   * dropped below.
+   */
+  if (!cmd_args.shared_sockets)
+    _clean_fd (ic->ipmi_fd);
   if (cbuf_drop (ic->ipmi_in, -1) < 0)
     {
       IPMIPOWER_ERROR (("cbuf_drop: %s", strerror (errno)));
@@ -124,6 +147,268 @@ ipmipower_connection_clear (struct ipmipower_connection *ic)
   return;
 }
 
+/* _shared_key
+ * - Key for matching replies to connections, an address and port
+ */
+static int
+_shared_key (const struct sockaddr *addr, char *buf, unsigned int buflen)
+{
+  char addrstr[INET6_ADDRSTRLEN + 1];
+
+  assert (addr);
+  assert (buf);
+  assert (buflen);
+
+  memset (addrstr, '\0', INET6_ADDRSTRLEN + 1);
+
+  if (addr->sa_family == AF_INET)
+    {
+      /* memcpy hacks to avoid warnings, i.e.
+       * warning: dereferencing pointer 'X' does break strict-aliasing rules
+       */
+      struct sockaddr_in addr4;
+
+      memcpy (&addr4, addr, sizeof (struct sockaddr_in));
+
+      if (!inet_ntop (AF_INET, &addr4.sin_addr, addrstr, INET6_ADDRSTRLEN))
+        return (-1);
+
+      snprintf (buf, buflen, "%s:%u", addrstr, ntohs (addr4.sin_port));
+    }
+  else if (addr->sa_family == AF_INET6)
+    {
+      struct sockaddr_in6 addr6;
+
+      memcpy (&addr6, addr, sizeof (struct sockaddr_in6));
+
+      if (!inet_ntop (AF_INET6, &addr6.sin6_addr, addrstr, INET6_ADDRSTRLEN))
+        return (-1);
+
+      snprintf (buf, buflen, "[%s]:%u", addrstr, ntohs (addr6.sin6_port));
+    }
+  else
+    return (-1);
+
+  return (0);
+}
+
+/* _shared_socket_create
+ * - Add a socket to the pool
+ * - Returns NULL if the file descriptor limit was reached
+ */
+static struct ipmipower_socket *
+_shared_socket_create (int family, int ping, unsigned int generation)
+{
+  struct ipmipower_socket *sock;
+  struct sockaddr_in srcaddr4;
+  struct sockaddr_in6 srcaddr6;
+  struct sockaddr *srcaddr;
+  socklen_t srcaddrlen;
+  int fd;
+
+  assert (family == AF_INET || family == AF_INET6);
+
+  if ((fd = socket (family, SOCK_DGRAM, 0)) < 0)
+    {
+      if (errno != EMFILE)
+        {
+          IPMIPOWER_ERROR (("socket: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+      IPMIPOWER_DEBUG (("file descriptor limit reached"));
+      return (NULL);
+    }
+
+  /* zero everywhere, secure ephemeral port */
+  if (family == AF_INET)
+    {
+      memset (&srcaddr4, '\0', sizeof (struct sockaddr_in));
+      srcaddr4.sin_family = AF_INET;
+      srcaddr = (struct sockaddr *)&srcaddr4;
+      srcaddrlen = sizeof (struct sockaddr_in);
+    }
+  else
+    {
+      memset (&srcaddr6, '\0', sizeof (struct sockaddr_in6));
+      srcaddr6.sin6_family = AF_INET6;
+      srcaddr = (struct sockaddr *)&srcaddr6;
+      srcaddrlen = sizeof (struct sockaddr_in6);
+    }
+
+  if (bind (fd, srcaddr, srcaddrlen) < 0)
+    {
+      IPMIPOWER_ERROR (("bind: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  if (sockets_count == sockets_size)
+    {
+      struct ipmipower_socket **tmp;
+      unsigned int size;
+
+      size = sockets_size ? sockets_size * 2 : 16;
+
+      if (!(tmp = (struct ipmipower_socket **)realloc (sockets, sizeof (struct ipmipower_socket *) * size)))
+        {
+          IPMIPOWER_ERROR (("realloc: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      sockets = tmp;
+      sockets_size = size;
+    }
+
+  if (!(sock = (struct ipmipower_socket *)malloc (sizeof (struct ipmipower_socket))))
+    {
+      IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  sock->fd = fd;
+  sock->family = family;
+  sock->ping = ping;
+  sock->connections_count = 0;
+  sock->generation = generation;
+  sock->pfds_index = -1;
+
+  if (!(sock->connections = hash_create (IPMIPOWER_CONNECTIONS_PER_SOCKET,
+                                         (hash_key_f)hash_key_string,
+                                         (hash_cmp_f)strcmp,
+                                         NULL)))
+    {
+      IPMIPOWER_ERROR (("hash_create: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  sockets[sockets_count++] = sock;
+
+  IPMIPOWER_DEBUG (("shared socket %u created: fd = %d; %s",
+                    sockets_count - 1,
+                    fd,
+                    ping ? "PING" : "IPMI"));
+  return (sock);
+}
+
+static void
+_shared_sockets_destroy (unsigned int generation)
+{
+  unsigned int count = 0;
+  int i;
+
+  for (i = 0; i < sockets_count; i++)
+    {
+      if (sockets[i]->generation != generation)
+        {
+          sockets[count++] = sockets[i];
+          continue;
+        }
+
+      /* ignore potential error, cleanup path */
+      close (sockets[i]->fd);
+      hash_destroy (sockets[i]->connections);
+      free (sockets[i]);
+    }
+  sockets_count = count;
+
+  if (!sockets_count)
+    {
+      free (sockets);
+      sockets = NULL;
+      sockets_size = 0;
+    }
+}
+
+static int
+_shared_socket_usable (struct ipmipower_socket *sock,
+                       struct ipmipower_connection *ic,
+                       int ping,
+                       unsigned int generation)
+{
+  assert (sock);
+  assert (ic);
+
+  return (sock->generation == generation
+          && sock->family == ic->destaddr->sa_family
+          && sock->ping == ping
+          && sock->connections_count < IPMIPOWER_CONNECTIONS_PER_SOCKET
+          && !hash_find (sock->connections, ic->shared_key));
+}
+
+static void
+_shared_socket_add (struct ipmipower_socket *sock,
+                    struct ipmipower_connection *ic)
+{
+  assert (sock);
+  assert (ic);
+
+  if (!hash_insert (sock->connections, ic->shared_key, ic))
+    {
+      IPMIPOWER_ERROR (("hash_insert: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+  sock->connections_count++;
+}
+
+/* _shared_socket_get
+ * - Find a socket in the pool that can take this connection, creating
+ *   one if necessary.  Searches from the newest socket, which is the
+ *   one normally being filled.
+ * - Returns NULL if the file descriptor limit was reached
+ */
+static struct ipmipower_socket *
+_shared_socket_get (struct ipmipower_connection *ic, int ping)
+{
+  int i;
+
+  assert (ic);
+
+  for (i = sockets_count - 1; i >= 0; i--)
+    {
+      if (_shared_socket_usable (sockets[i], ic, ping, sockets_generation))
+        return (sockets[i]);
+    }
+
+  return (_shared_socket_create (ic->destaddr->sa_family, ping, sockets_generation));
+}
+
+/* _connection_shared_setup
+ * - Assign ipmi_fd and ping_fd from the socket pool
+ */
+static int
+_connection_shared_setup (struct ipmipower_connection *ic)
+{
+  struct ipmipower_socket *sock;
+
+  assert (ic);
+  assert (ic->destaddr);
+
+  if (_shared_key (ic->destaddr, ic->shared_key, IPMIPOWER_SHARED_KEY_BUFLEN) < 0)
+    {
+      IPMIPOWER_ERROR (("_shared_key: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  if (!(sock = _shared_socket_get (ic, 0)))
+    {
+      errno = EMFILE;
+      return (-1);
+    }
+  _shared_socket_add (sock, ic);
+  ic->ipmi_socket = sock;
+  ic->ipmi_fd = sock->fd;
+
+  if (!(sock = _shared_socket_get (ic, 1)))
+    {
+      errno = EMFILE;
+      return (-1);
+    }
+  _shared_socket_add (sock, ic);
+  ic->ping_socket = sock;
+  ic->ping_fd = sock->fd;
+
+  return (0);
+}
+
 static int
 _connection_setup (struct ipmipower_connection *ic, const char *hostname)
 {
@@ -196,6 +481,7 @@ _connection_setup (struct ipmipower_connection *ic, const char *hostname)
   memset (&ic->last_ping_send, '\0', sizeof (struct timeval));
   memset (&ic->last_ipmi_recv, '\0', sizeof (struct timeval));
   memset (&ic->last_ping_recv, '\0', sizeof (struct timeval));
+  rtt_init (&(ic->rtt));
 
   ic->link_state = IPMIPOWER_LINK_STATE_GOOD; /* assumed good to begin with */
   ic->ping_last_packet_recv_flag = 0;
@@ -311,25 +597,29 @@ _connection_setup (struct ipmipower_connection *ic, const char *hostname)
   /* Try all of the different answers we got, until we succeed. */
   for (ai = ai_res; ai != NULL; ai = ai->ai_next)
     {
-      if ((ic->ipmi_fd = socket (ai->ai_family,
-				 ai->ai_socktype, ai->ai_protocol)) < 0)
-	{
-	  if (errno == EMFILE)
-	    {
-	      IPMIPOWER_DEBUG (("file descriptor limit reached"));
-	      return (-1);
-	    }
-	}
+      /* with --shared-sockets, fds come from the pool below */
+      if (!cmd_args.shared_sockets)
+        {
+          if ((ic->ipmi_fd = socket (ai->ai_family,
+                                     ai->ai_socktype, ai->ai_protocol)) < 0)
+            {
+              if (errno == EMFILE)
+                {
+                  IPMIPOWER_DEBUG (("file descriptor limit reached"));
+                  return (-1);
+                }
+            }
 
-      if ((ic->ping_fd = socket (ai->ai_family,
-				 ai->ai_socktype, ai->ai_protocol)) < 0)
-	{
-	  if (errno == EMFILE)
-	    {
-	      IPMIPOWER_DEBUG (("file descriptor limit reached"));
-	      return (-1);
-	    }
-	}
+          if ((ic->ping_fd = socket (ai->ai_family,
+                                     ai->ai_socktype, ai->ai_protocol)) < 0)
+            {
+              if (errno == EMFILE)
+                {
+                  IPMIPOWER_DEBUG (("file descriptor limit reached"));
+                  return (-1);
+                }
+            }
+        }
 
       if (ai->ai_family == AF_INET)
         {
@@ -358,11 +648,23 @@ _connection_setup (struct ipmipower_connection *ic, const char *hostname)
         }
       else
         {
-	  close(ic->ipmi_fd);
-	  close(ic->ping_fd);
+          if (!cmd_args.shared_sockets)
+            {
+              close(ic->ipmi_fd);
+              close(ic->ping_fd);
+            }
 	  continue;
         }
 
+      if (cmd_args.shared_sockets)
+        {
+          if (_connection_shared_setup (ic) < 0)
+            return (-1);
+
+          ic->skip = 0;
+          break;
+        }
+
       if ((bind (ic->ipmi_fd, ic->srcaddr, ic->srcaddrlen) < 0)
           || (bind (ic->ping_fd, ic->srcaddr, ic->srcaddrlen) < 0))
 	{
@@ -593,10 +895,14 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
 
   memset (ics, '\0', (sizeof (struct ipmipower_connection) * host_count));
 
+  sockets_generation++;
+
   for (i = 0; i < host_count; i++)
     {
       ics[i].ipmi_fd = -1;
       ics[i].ping_fd = -1;
+      ics[i].registered_ipmi_fd = -1;
+      ics[i].registered_ping_fd = -1;
     }
 
   if (!(h = fi_hostlist_create (hostname)))
@@ -748,10 +1054,13 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
       int i;
       for (i = 0; i < index; i++)
         {
-          /* ignore potential error, error path */
-          close (ics[i].ipmi_fd);
-          /* ignore potential error, error path */
-          close (ics[i].ping_fd);
+          if (!cmd_args.shared_sockets)
+            {
+              /* ignore potential error, error path */
+              close (ics[i].ipmi_fd);
+              /* ignore potential error, error path */
+              close (ics[i].ping_fd);
+            }
           if (ics[i].ipmi_in)
             cbuf_destroy (ics[i].ipmi_in);
           if (ics[i].ipmi_out)
@@ -778,10 +1087,20 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
                 }
             }
         }
+      _shared_sockets_destroy (sockets_generation);
       free (ics);
       return (NULL);
     }
 
+  /* Split hosts into contiguous shards, one per --threads worker.
+   * New fds need to be registered with the event loop.
+   */
+  for (i = 0; i < index; i++)
+    {
+      ics[i].shard = ((uint64_t)i * cmd_args.threads) / index;
+      ipmipower_connection_mark_updated (&ics[i]);
+    }
+
   *len = index;
   return (ics);
 }
@@ -795,12 +1114,22 @@ ipmipower_connection_array_destroy (struct ipmipower_connection *ics,
   if (!ics)
     return;
 
+  /* closing the fds removes them from the event loop */
+  for (i = 0; i < IPMIPOWER_THREADS_MAX; i++)
+    {
+      while (ipmipower_connection_next_updated (i))
+        ;
+    }
+
   for (i = 0; i < ics_len; i++)
     {
-      /* ignore potential error, cleanup path */
-      close (ics[i].ipmi_fd);
-      /* ignore potential error, cleanup path */
-      close (ics[i].ping_fd);
+      if (!cmd_args.shared_sockets)
+        {
+          /* ignore potential error, cleanup path */
+          close (ics[i].ipmi_fd);
+          /* ignore potential error, cleanup path */
+          close (ics[i].ping_fd);
+        }
       cbuf_destroy (ics[i].ipmi_in);
       cbuf_destroy (ics[i].ipmi_out);
       cbuf_destroy (ics[i].ping_in);
@@ -823,9 +1152,141 @@ ipmipower_connection_array_destroy (struct ipmipower_connection *ics,
             }
         }
     }
+  if (cmd_args.shared_sockets && ics_len)
+    _shared_sockets_destroy (ics[0].ipmi_socket->generation);
   free (ics);
 }
 
+void
+ipmipower_connection_mark_updated (ipmipower_connection_t ic)
+{
+  assert (ic);
+
+  assert (ic->shard < IPMIPOWER_THREADS_MAX);
+
+  if (ic->updated)
+    return;
+
+  if (ics_updated_count[ic->shard] == ics_updated_size[ic->shard])
+    {
+      ipmipower_connection_t *tmp;
+      unsigned int size;
+
+      size = ics_updated_size[ic->shard] ? ics_updated_size[ic->shard] * 2 : 64;
+
+      if (!(tmp = (ipmipower_connection_t *)realloc (ics_updated[ic->shard], sizeof (ipmipower_connection_t) * size)))
+        {
+          IPMIPOWER_ERROR (("realloc: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      ics_updated[ic->shard] = tmp;
+      ics_updated_size[ic->shard] = size;
+    }
+
+  ics_updated[ic->shard][ics_updated_count[ic->shard]++] = ic;
+  ic->updated = 1;
+}
+
+ipmipower_connection_t
+ipmipower_connection_next_updated (unsigned int shard)
+{
+  ipmipower_connection_t ic;
+
+  assert (shard < IPMIPOWER_THREADS_MAX);
+
+  if (!ics_updated_count[shard])
+    return (NULL);
+
+  ic = ics_updated[shard][--ics_updated_count[shard]];
+  ic->updated = 0;
+  return (ic);
+}
+
+int
+ipmipower_connection_socket_rotate (ipmipower_connection_t ic)
+{
+  struct ipmipower_socket *sock = NULL;
+  int index = -1;
+  int i;
+
+  assert (ic);
+  assert (cmd_args.shared_sockets);
+  assert (ic->ipmi_socket);
+
+  for (i = 0; i < sockets_count; i++)
+    {
+      if (sockets[i] == ic->ipmi_socket)
+        {
+          index = i;
+          break;
+        }
+    }
+
+  assert (index >= 0);
+
+  /* Search forward from the current socket, so retransmissions
+   * cycle through the pool instead of alternating between two
+   * ports.
+   */
+  for (i = 1; i < sockets_count; i++)
+    {
+      unsigned int tmp = (index + i) % sockets_count;
+
+      if (_shared_socket_usable (sockets[tmp], ic, 0, ic->ipmi_socket->generation))
+        {
+          sock = sockets[tmp];
+          break;
+        }
+    }
+
+  if (!sock)
+    {
+      if (!(sock = _shared_socket_create (ic->destaddr->sa_family,
+                                          0,
+                                          ic->ipmi_socket->generation)))
+        return (-1);
+    }
+
+  if (!hash_remove (ic->ipmi_socket->connections, ic->shared_key))
+    {
+      IPMIPOWER_ERROR (("hash_remove: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+  ic->ipmi_socket->connections_count--;
+
+  _shared_socket_add (sock, ic);
+  ic->ipmi_socket = sock;
+  ic->ipmi_fd = sock->fd;
+  return (0);
+}
+
+struct ipmipower_socket **
+ipmipower_connection_sockets (unsigned int *len)
+{
+  assert (len);
+
+  *len = sockets_count;
+  return (sockets);
+}
+
+ipmipower_connection_t
+ipmipower_connection_socket_find (struct ipmipower_socket *sock,
+                                  const struct sockaddr *from)
+{
+  char key[IPMIPOWER_SHARED_KEY_BUFLEN + 1];
+
+  assert (sock);
+  assert (from);
+
+  memset (key, '\0', IPMIPOWER_SHARED_KEY_BUFLEN + 1);
+
+  if (_shared_key (from, key, IPMIPOWER_SHARED_KEY_BUFLEN) < 0)
+    return (NULL);
+
+  return ((ipmipower_connection_t)hash_find (sock->connections, key));
+}
+
 int
 ipmipower_connection_hostname_index (struct ipmipower_connection *ics,
                                      unsigned int ics_len,
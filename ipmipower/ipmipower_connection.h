@@ -47,6 +47,39 @@ struct ipmipower_connection *ipmipower_connection_array_create (const char *host
 void ipmipower_connection_array_destroy (struct ipmipower_connection *ics,
                                          unsigned int ics_len);
 
+/* ipmipower_connection_mark_updated
+ * - Note that a connection's fds changed or packets were queued on
+ *   its ipmi_out or ping_out, so the event loop need only look at
+ *   connections that changed.
+ */
+void ipmipower_connection_mark_updated (ipmipower_connection_t ic);
+
+/* ipmipower_connection_next_updated
+ * - Remove and return a connection of the specified shard marked
+ *   updated.  Shard is always 0 unless --threads is used.
+ * - Returns NULL if no connections are marked
+ */
+ipmipower_connection_t ipmipower_connection_next_updated (unsigned int shard);
+
+/* ipmipower_connection_socket_rotate
+ * - With --shared-sockets, move a connection's ipmi_fd to a
+ *   different socket in the pool, giving it a new source port
+ * - Returns 0 on success, -1 if the file descriptor limit was reached
+ */
+int ipmipower_connection_socket_rotate (ipmipower_connection_t ic);
+
+/* ipmipower_connection_sockets
+ * - Returns the --shared-sockets socket pool, NULL if not in use
+ */
+struct ipmipower_socket **ipmipower_connection_sockets (unsigned int *len);
+
+/* ipmipower_connection_socket_find
+ * - Find the connection a packet received on a shared socket belongs to
+ * - Returns NULL if the source address is unknown
+ */
+ipmipower_connection_t ipmipower_connection_socket_find (struct ipmipower_socket *sock,
+                                                         const struct sockaddr *from);
+
 /* ipmipower_connection_hostname_index
  * - Find ics entry with given hostname
  * - Returns index of entry, -1 if not found
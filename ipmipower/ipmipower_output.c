@@ -33,7 +33,12 @@
 #if STDC_HEADERS
 #include <string.h>
 #endif /* STDC_HEADERS */
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <pthread.h>
 #include <assert.h>
+#include <errno.h>
 
 #include "ipmipower.h"
 #include "ipmipower_error.h"
@@ -49,6 +54,13 @@ extern struct ipmipower_arguments cmd_args;
 extern fi_hostlist_t output_hostrange[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 extern unsigned int output_counts[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 
+/* With --threads, worker threads output results while the main
+ * thread writes ttyout to stdout.
+ */
+static pthread_mutex_t output_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int output_notify_fd = -1;
+
 static char *ipmipower_outputs[] =
   {
     "on",
@@ -77,12 +89,69 @@ static char *ipmipower_outputs[] =
     "BMC error"
   };
 
+void
+ipmipower_output_lock (void)
+{
+  int perr;
+
+  if ((perr = pthread_mutex_lock (&output_mutex)))
+    {
+      IPMIPOWER_ERROR (("pthread_mutex_lock: %s", strerror (perr)));
+      exit (EXIT_FAILURE);
+    }
+}
+
+void
+ipmipower_output_unlock (void)
+{
+  int perr;
+
+  if ((perr = pthread_mutex_unlock (&output_mutex)))
+    {
+      IPMIPOWER_ERROR (("pthread_mutex_unlock: %s", strerror (perr)));
+      exit (EXIT_FAILURE);
+    }
+}
+
+void
+ipmipower_output_notify (int fd)
+{
+  ipmipower_output_lock ();
+  output_notify_fd = fd;
+  ipmipower_output_unlock ();
+}
+
+void
+ipmipower_output_wakeup (void)
+{
+  uint8_t c = 0;
+
+  ipmipower_output_lock ();
+
+  /* The fd is non-blocking.  If the pipe is full, the reader is
+   * already going to wake up, so EAGAIN is ignored.
+   */
+  if (output_notify_fd >= 0
+      && write (output_notify_fd, &c, 1) < 0
+      && errno != EAGAIN
+      && errno != EWOULDBLOCK
+      && errno != EINTR)
+    {
+      IPMIPOWER_ERROR (("write: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  ipmipower_output_unlock ();
+}
+
 void
 ipmipower_output (ipmipower_msg_type_t num, const char *hostname, const char *extra_arg)
 {
   assert (IPMIPOWER_MSG_TYPE_VALID (num));
   assert (hostname);
 
+  ipmipower_output_lock ();
+
   /* If extra argument required, then we can't do consolidated output */
 
   if (cmd_args.common_args.consolidate_output
@@ -103,12 +172,17 @@ ipmipower_output (ipmipower_msg_type_t num, const char *hostname, const char *ex
                            ipmipower_outputs[num]);
 
   output_counts[num]++;
+  ipmipower_output_unlock ();
+
+  ipmipower_output_wakeup ();
   return;
 }
 
 void
 ipmipower_output_finish (void)
 {
+  ipmipower_output_lock ();
+
   if (cmd_args.common_args.consolidate_output
       && !IPMIPOWER_OEM_POWER_TYPE_REQUIRES_EXTRA_ARGUMENT (cmd_args.oem_power_type))
     {
@@ -151,6 +225,7 @@ ipmipower_output_finish (void)
         }
     }
 
+  ipmipower_output_unlock ();
   return;
 }
 
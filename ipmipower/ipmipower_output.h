@@ -29,6 +29,27 @@
 
 #include "ipmipower.h"
 
+/* ipmipower_output_lock, ipmipower_output_unlock
+ * - Serialize ttyout and the output results between threads.
+ *   ipmipower_output() and ipmipower_output_finish() lock on their
+ *   own.
+ */
+void ipmipower_output_lock (void);
+
+void ipmipower_output_unlock (void);
+
+/* ipmipower_output_notify
+ * - Write a byte to the non-blocking fd whenever output is added, so
+ *   the thread writing ttyout to stdout can sleep until there is
+ *   something to write.  Pass -1 to stop.
+ */
+void ipmipower_output_notify (int fd);
+
+/* ipmipower_output_wakeup
+ * - Write a byte to the fd set by ipmipower_output_notify(), if any.
+ */
+void ipmipower_output_wakeup (void);
+
 void ipmipower_output (ipmipower_msg_type_t num, const char *hostname, const char *extra_arg);
 
 /* ipmipower_output_finish
@@ -43,6 +43,7 @@
 #include "ipmipower_packet.h"
 #include "ipmipower_error.h"
 #include "ipmipower_oem.h"
+#include "ipmipower_output.h"
 #include "ipmipower_util.h"
 
 #include "freeipmi-portability.h"
@@ -290,6 +291,9 @@ ipmipower_packet_dump (ipmipower_powercmd_t ip,
       else
         tmpl_lan_msg_hdr = &tmpl_lan_msg_hdr_rs[0];
 
+      /* don't interleave dumps from --threads workers */
+      ipmipower_output_lock ();
+
       if (IPMIPOWER_PACKET_TYPE_IPMI_2_0_SETUP (pkt))
         {
           if (ipmi_dump_rmcpplus_packet (STDERR_FILENO,
@@ -352,6 +356,8 @@ ipmipower_packet_dump (ipmipower_powercmd_t ip,
               exit (EXIT_FAILURE);
             }
         }
+
+      ipmipower_output_unlock ();
     }
 }
 
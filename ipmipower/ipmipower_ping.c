@@ -50,6 +50,7 @@
 #include <errno.h>
 
 #include "ipmipower_ping.h"
+#include "ipmipower_connection.h"
 #include "ipmipower_error.h"
 #include "ipmipower_util.h"
 
@@ -345,6 +346,8 @@ ipmipower_ping_process_pings (int *timeout)
           if (dropped)
             IPMIPOWER_DEBUG (("cbuf_write: dropped %d bytes", dropped));
 
+          ipmipower_connection_mark_updated (&ics[i]);
+
           ics[i].last_ping_send.tv_sec = cur_time.tv_sec;
           ics[i].last_ping_send.tv_usec = cur_time.tv_usec;
 
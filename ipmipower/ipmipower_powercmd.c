@@ -71,16 +71,54 @@
 
 extern struct ipmipower_arguments cmd_args;
 
+/* The queues and counts below are kept per --threads shard, so each
+ * worker thread only touches its own.  See ipmipower_connection.shard.
+ */
+static unsigned int shards_count = 0;
+
 /* Queue of all pending power commands */
-static List pending = NULL;
+static List pending[IPMIPOWER_THREADS_MAX];
 
 /* Queue of power commands to be added to the pending, for serializing
  * OEM power control to the same host
  */
-static List add_to_pending = NULL;
+static List add_to_pending[IPMIPOWER_THREADS_MAX];
 
 /* Count of currently executing power commands for fanout */
-static unsigned int executing_count = 0;
+static unsigned int executing_count[IPMIPOWER_THREADS_MAX];
+
+/* Session admission for --session-rate and --session-window.
+ *
+ * Session starts and retransmissions are the only packets not clocked
+ * by a reply from the BMC, so they are the ones rate limited.  The
+ * rate is a token bucket, kept as the earliest time the next packet
+ * may go out.  The window of executing power commands grows like TCP
+ * slow start and congestion avoidance as power commands complete, and
+ * is halved when a retransmission shows a packet was lost.
+ */
+struct ipmipower_admission
+{
+  uint64_t next_send_usec;
+  uint64_t last_loss_usec;
+  unsigned int window;
+  unsigned int window_threshold;
+  unsigned int window_acks;
+  int wait;
+};
+
+static struct ipmipower_admission admission[IPMIPOWER_THREADS_MAX];
+
+/* Sessions kept open by --reuse-sessions.  Only interactive mode
+ * reuses sessions.  An idle session is parked on this list when its
+ * power command completes, and moved back to the pending list for
+ * the next power command to the same host or for a keepalive.
+ */
+static int reuse_sessions = 0;
+
+static List idle[IPMIPOWER_THREADS_MAX];
+
+/* Count of keepalives on the pending list */
+static unsigned int keepalive_count[IPMIPOWER_THREADS_MAX];
 
 static int
 _find_ipmipower_powercmd (void *x, void *key)
@@ -179,75 +217,294 @@ _destroy_ipmipower_powercmd (void *x)
   free (ip);
 }
 
+/* _shard_share
+ * - limits such as the fanout are split between shards, but every
+ *   shard gets at least 1
+ * - returns 0 if the limit is 0 (i.e. no limit)
+ */
+static unsigned int
+_shard_share (unsigned int total, unsigned int shard)
+{
+  unsigned int share;
+
+  assert (shard < shards_count);
+
+  if (!total)
+    return (0);
+
+  share = total / shards_count;
+  if (shard < (total % shards_count))
+    share++;
+
+  return (share ? share : 1);
+}
+
+static uint64_t
+_usec_now (void)
+{
+  struct timeval cur_time;
+
+  if (gettimeofday (&cur_time, NULL) < 0)
+    {
+      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  return (((uint64_t)cur_time.tv_sec * 1000000) + cur_time.tv_usec);
+}
+
+/* _admission_send
+ * - take a token for a session start or retransmission
+ * - if none is available, note how long until one is
+ * Returns 1 if the packet may be sent, 0 if not
+ */
+static int
+_admission_send (unsigned int shard)
+{
+  struct ipmipower_admission *a;
+  uint64_t now, interval, burst;
+  unsigned int rate;
+  int wait;
+
+  assert (shard < shards_count);
+
+  if (!cmd_args.session_rate)
+    return (1);
+
+  a = &admission[shard];
+  rate = _shard_share (cmd_args.session_rate, shard);
+  interval = 1000000 / rate;
+  burst = (rate / IPMIPOWER_SESSION_RATE_BURST_DIVISOR) * interval;
+
+  now = _usec_now ();
+
+  if (a->next_send_usec < now)
+    a->next_send_usec = now;
+
+  if ((a->next_send_usec - now) > burst)
+    {
+      wait = ((a->next_send_usec - now - burst) + 999) / 1000;
+      if (a->wait < 0 || wait < a->wait)
+        a->wait = wait;
+      return (0);
+    }
+
+  a->next_send_usec += interval;
+  return (1);
+}
+
+/* _admission_window_full
+ * Returns 1 if the shard may not start another power command, 0 if not
+ */
+static int
+_admission_window_full (unsigned int shard)
+{
+  assert (shard < shards_count);
+
+  if (!cmd_args.session_window)
+    return (0);
+
+  return (executing_count[shard] >= admission[shard].window);
+}
+
+/* _admission_loss
+ * - a packet was retransmitted, shrink the window
+ */
+static void
+_admission_loss (unsigned int shard)
+{
+  struct ipmipower_admission *a;
+  uint64_t now;
+
+  assert (shard < shards_count);
+
+  if (!cmd_args.session_window)
+    return;
+
+  a = &admission[shard];
+  now = _usec_now ();
+
+  /* Sessions started together time out together.  Count their
+   * retransmissions as one loss.
+   */
+  if ((now - a->last_loss_usec) < ((uint64_t)cmd_args.common_args.retransmission_timeout * 1000))
+    return;
+
+  a->last_loss_usec = now;
+  a->window_threshold = a->window / 2;
+  if (!a->window_threshold)
+    a->window_threshold = 1;
+  a->window = a->window_threshold;
+  a->window_acks = 0;
+
+  IPMIPOWER_DEBUG (("shard = %u; packet loss, session window = %u",
+                    shard,
+                    a->window));
+}
+
+/* _admission_success
+ * - a power command completed, grow the window
+ */
+static void
+_admission_success (unsigned int shard)
+{
+  struct ipmipower_admission *a;
+
+  assert (shard < shards_count);
+
+  if (!cmd_args.session_window)
+    return;
+
+  a = &admission[shard];
+
+  if (a->window >= _shard_share (cmd_args.session_window, shard))
+    return;
+
+  if (a->window < a->window_threshold)
+    a->window++;
+  else if (++a->window_acks >= a->window)
+    {
+      a->window++;
+      a->window_acks = 0;
+    }
+}
+
 void
 ipmipower_powercmd_setup ()
 {
-  assert (!pending);  /* need to cleanup first! */
+  unsigned int i;
 
-  pending = list_create ((ListDelF)_destroy_ipmipower_powercmd);
-  if (!pending)
+  assert (!shards_count);  /* need to cleanup first! */
+  assert (cmd_args.threads && cmd_args.threads <= IPMIPOWER_THREADS_MAX);
+
+  for (i = 0; i < cmd_args.threads; i++)
     {
-      IPMIPOWER_ERROR (("list_create: %s", strerror (errno)));
-      exit (EXIT_FAILURE);
+      pending[i] = list_create ((ListDelF)_destroy_ipmipower_powercmd);
+      if (!pending[i])
+        {
+          IPMIPOWER_ERROR (("list_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      add_to_pending[i] = list_create (NULL);
+      if (!add_to_pending[i])
+        {
+          IPMIPOWER_ERROR (("list_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      idle[i] = list_create ((ListDelF)_destroy_ipmipower_powercmd);
+      if (!idle[i])
+        {
+          IPMIPOWER_ERROR (("list_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      executing_count[i] = 0;
+      keepalive_count[i] = 0;
     }
 
-  add_to_pending = list_create (NULL);
-  if (!add_to_pending)
+  shards_count = cmd_args.threads;
+
+  if (cmd_args.reuse_sessions
+      && cmd_args.powercmd == IPMIPOWER_POWER_CMD_NONE)
+    reuse_sessions = 1;
+  else
+    reuse_sessions = 0;
+
+  for (i = 0; i < shards_count; i++)
     {
-      IPMIPOWER_ERROR (("list_create: %s", strerror (errno)));
-      exit (EXIT_FAILURE);
+      unsigned int window = _shard_share (cmd_args.session_window, i);
+
+      memset (&admission[i], '\0', sizeof (struct ipmipower_admission));
+      admission[i].window = window;
+      if (admission[i].window > IPMIPOWER_SESSION_WINDOW_INITIAL)
+        admission[i].window = IPMIPOWER_SESSION_WINDOW_INITIAL;
+      admission[i].window_threshold = window;
+      admission[i].wait = -1;
     }
 }
 
 void
 ipmipower_powercmd_cleanup ()
 {
-  assert (pending);  /* did not run ipmipower_powercmd_setup() */
-  list_destroy (pending);
-  list_destroy (add_to_pending);
-  pending = NULL;
-  add_to_pending = NULL;
+  unsigned int i;
+
+  assert (shards_count);  /* did not run ipmipower_powercmd_setup() */
+
+  ipmipower_powercmd_close_sessions ();
+
+  for (i = 0; i < shards_count; i++)
+    {
+      list_destroy (pending[i]);
+      list_destroy (add_to_pending[i]);
+      list_destroy (idle[i]);
+      pending[i] = NULL;
+      add_to_pending[i] = NULL;
+      idle[i] = NULL;
+    }
+
+  shards_count = 0;
 }
 
-void
-ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
-                          struct ipmipower_connection *ic,
-                          const char *extra_arg)
+static int
+_find_session (void *x, void *key)
 {
   ipmipower_powercmd_t ip;
 
-  assert (pending);  /* did not run ipmipower_powercmd_setup() */
-  assert (ic);
-  assert (IPMIPOWER_POWER_CMD_VALID (cmd));
+  assert (x);
+  assert (key);
 
-  ipmipower_connection_clear (ic);
+  ip = (ipmipower_powercmd_t)x;
 
-  if (!(ip = (ipmipower_powercmd_t)malloc (sizeof (struct ipmipower_powercmd))))
+  return (ip->ic == (struct ipmipower_connection *)key);
+}
+
+/* _session_remove
+ * - remove the idle session of a connection from a list without
+ *   destroying it
+ * - if keepalive is set, only a keepalive is removed
+ * Returns the session, NULL if there is none
+ */
+static ipmipower_powercmd_t
+_session_remove (List l, struct ipmipower_connection *ic, int keepalive)
+{
+  ListIterator itr;
+  ipmipower_powercmd_t ip;
+
+  assert (l);
+  assert (ic);
+
+  if (!(itr = list_iterator_create (l)))
     {
-      IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
+      IPMIPOWER_ERROR (("list_iterator_create: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
 
-  ip->cmd = cmd;
-  ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_START;
-
-  /*
-   * Protocol State Machine Variables
-   */
-#if 0
-  /* Initialize when protocol really begins.  Necessary b/c of fanout support
-   * For now just clear it.
-   */
-  if (gettimeofday (&(ip->time_begin), NULL) < 0)
+  while ((ip = (ipmipower_powercmd_t)list_next (itr)))
     {
-      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
-      exit (EXIT_FAILURE);
+      if (ip->ic == ic && (!keepalive || ip->keepalive))
+        {
+          if (!list_remove (itr))
+            {
+              IPMIPOWER_ERROR (("list_remove"));
+              exit (EXIT_FAILURE);
+            }
+          break;
+        }
     }
-#else  /* 0 */
-  memset (&(ip->time_begin), '\0', sizeof (struct timeval));
-#endif  /* 0 */
-  ip->retransmission_count = 0;
-  ip->close_timeout = 0;
+
+  list_iterator_destroy (itr);
+  return (ip);
+}
+
+/* _session_init
+ * - initialize the protocol variables for a new session
+ */
+static void
+_session_init (ipmipower_powercmd_t ip)
+{
+  assert (ip);
 
   /*
    * Protocol Maintenance Variables
@@ -297,7 +554,7 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
                                               &(ip->integrity_algorithm),
                                               &(ip->confidentiality_algorithm)) < 0)
         {
-          IPMIPOWER_ERROR (("ipmipower_powercmd_queue: ipmi_cipher_suite_id_to_algorithms: ",
+          IPMIPOWER_ERROR (("_session_init: ipmi_cipher_suite_id_to_algorithms: ",
                             "cmd_args.common_args.cipher_suite_id: %d: %s",
                             cmd_args.common_args.cipher_suite_id, strerror (errno)));
           exit (EXIT_FAILURE);
@@ -387,10 +644,104 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
           exit (EXIT_FAILURE);
         }
     }
+}
+
+void
+ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
+                          struct ipmipower_connection *ic,
+                          const char *extra_arg)
+{
+  ipmipower_powercmd_t ip;
+
+  assert (shards_count);  /* did not run ipmipower_powercmd_setup() */
+  assert (ic);
+  assert (ic->shard < shards_count);
+  assert (IPMIPOWER_POWER_CMD_VALID (cmd));
+
+  ipmipower_connection_clear (ic);
+
+  /* With --reuse-sessions, skip straight to the power command if a
+   * session to this host is already up.  A keepalive in flight is
+   * taken over, its reply will no longer match and is ignored.
+   */
+  if (reuse_sessions)
+    {
+      if (!(ip = _session_remove (idle[ic->shard], ic, 0))
+          && (ip = _session_remove (pending[ic->shard], ic, 1)))
+        {
+          assert (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_START
+                  || ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_GET_CHASSIS_STATUS_SENT);
+
+          if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_START)
+            executing_count[ic->shard]--;
+          keepalive_count[ic->shard]--;
+        }
+
+      if (ip)
+        {
+          ip->cmd = cmd;
+          ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_START;
+          memset (&(ip->time_begin), '\0', sizeof (struct timeval));
+          ip->retransmission_count = 0;
+          ip->close_timeout = 0;
+          ip->wait_until_on_state = 0;
+          ip->wait_until_off_state = 0;
+          ip->session_reused = 1;
+          ip->keepalive = 0;
+
+          free (ip->extra_arg);
+          ip->extra_arg = NULL;
+          if (extra_arg)
+            {
+              if (!(ip->extra_arg = strdup (extra_arg)))
+                {
+                  IPMIPOWER_ERROR (("strdup"));
+                  exit (EXIT_FAILURE);
+                }
+            }
+
+          IPMIPOWER_DEBUG (("host = %s; reusing session",
+                            ic->hostname));
+          goto queue_powercmd;
+        }
+    }
+
+  if (!(ip = (ipmipower_powercmd_t)malloc (sizeof (struct ipmipower_powercmd))))
+    {
+      IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  ip->cmd = cmd;
+  ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_START;
+
+  /*
+   * Protocol State Machine Variables
+   */
+#if 0
+  /* Initialize when protocol really begins.  Necessary b/c of fanout support
+   * For now just clear it.
+   */
+  if (gettimeofday (&(ip->time_begin), NULL) < 0)
+    {
+      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+#else  /* 0 */
+  memset (&(ip->time_begin), '\0', sizeof (struct timeval));
+#endif  /* 0 */
+  ip->retransmission_count = 0;
+  ip->close_timeout = 0;
+
+  _session_init (ip);
 
   ip->wait_until_on_state = 0;
   ip->wait_until_off_state = 0;
 
+  ip->session_reused = 0;
+  ip->keepalive = 0;
+  memset (&(ip->time_idle), '\0', sizeof (struct timeval));
+
   ip->ic = ic;
 
   if (!(ip->obj_rmcp_hdr_rq = fiid_obj_create (tmpl_rmcp_hdr)))
@@ -651,13 +1002,14 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
    * an issue, a bigger rearchitecture will be required.
    */
 
+ queue_powercmd:
   ip->next = NULL;
 
   if (cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_C410X)
     {
       ipmipower_powercmd_t iptmp;
 
-      if ((iptmp = list_find_first (pending,
+      if ((iptmp = list_find_first (pending[ic->shard],
                                     _find_ipmipower_powercmd,
                                     ip->ic->hostname)))
         {
@@ -669,7 +1021,7 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
         }
     }
 
-  if (!list_append (pending, ip))
+  if (!list_append (pending[ic->shard], ip))
     {
       IPMIPOWER_ERROR (("list_append: %s", strerror (errno)));
       exit (EXIT_FAILURE);
@@ -679,9 +1031,17 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
 int
 ipmipower_powercmd_pending ()
 {
-  assert (pending);  /* did not run ipmipower_powercmd_setup() */
+  unsigned int i;
 
-  return (!list_is_empty (pending));
+  assert (shards_count);  /* did not run ipmipower_powercmd_setup() */
+
+  for (i = 0; i < shards_count; i++)
+    {
+      if (list_count (pending[i]) > keepalive_count[i])
+        return (1);
+    }
+
+  return (0);
 }
 
 /* _send_packet
@@ -736,6 +1096,8 @@ _send_packet (ipmipower_powercmd_t ip, ipmipower_packet_type_t pkt)
   if (dropped)
     IPMIPOWER_DEBUG (("cbuf_write: dropped %d bytes", dropped));
 
+  ipmipower_connection_mark_updated (ip->ic);
+
   if (cmd_args.common_args.driver_type == IPMI_DEVICE_LAN
       && cmd_args.common_args.authentication_type == IPMI_AUTHENTICATION_TYPE_STRAIGHT_PASSWORD_KEY)
     secure_memset (buf, '\0', IPMIPOWER_PACKET_BUFLEN);
@@ -818,6 +1180,165 @@ _send_packet (ipmipower_powercmd_t ip, ipmipower_packet_type_t pkt)
     }
 }
 
+/* _send_power_control_packet
+ * - Send the first packet of the power control operation, once the
+ *   session is up
+ */
+static void
+_send_power_control_packet (ipmipower_powercmd_t ip)
+{
+  assert (ip);
+
+  if (cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_NONE)
+    {
+      if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS
+          || ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_STATUS
+          || (cmd_args.on_if_off
+              && (ip->cmd == IPMIPOWER_POWER_CMD_POWER_CYCLE
+                  || ip->cmd == IPMIPOWER_POWER_CMD_POWER_RESET)))
+        _send_packet (ip, IPMIPOWER_PACKET_TYPE_GET_CHASSIS_STATUS_RQ);
+      else if (ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_ON
+               || ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_OFF)
+        _send_packet (ip, IPMIPOWER_PACKET_TYPE_CHASSIS_IDENTIFY_RQ);
+      else /* on, off, cycle, reset, pulse diag interupt, soft shutdown */
+        _send_packet (ip, IPMIPOWER_PACKET_TYPE_CHASSIS_CONTROL_RQ);
+    }
+  else /* cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_C410X */
+    {
+      assert (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS
+              || ip->cmd == IPMIPOWER_POWER_CMD_POWER_OFF
+              || ip->cmd == IPMIPOWER_POWER_CMD_POWER_ON);
+
+      _send_packet (ip, IPMIPOWER_PACKET_TYPE_C410X_GET_SENSOR_READING_RQ);
+    }
+}
+
+/* _finish_session
+ * - The power control operation is done, close the session.  With
+ *   --reuse-sessions, keep it idle for the next power control
+ *   operation instead, unless the host already has an idle session.
+ */
+static void
+_finish_session (ipmipower_powercmd_t ip)
+{
+  assert (ip);
+
+  if (reuse_sessions
+      && !list_find_first (idle[ip->ic->shard], _find_session, ip->ic))
+    {
+      ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE;
+      return;
+    }
+
+  _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+}
+
+/* _close_session_now
+ * - Close a session immediately, its connection may be destroyed
+ *   or reused before the poll loop runs again.  Like any close
+ *   session, the reply is not waited for, see _retry_packets().
+ */
+static void
+_close_session_now (ipmipower_powercmd_t ip)
+{
+  uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+  int len;
+
+  assert (ip);
+
+  ipmipower_connection_clear (ip->ic);
+
+  _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+
+  if ((len = cbuf_read (ip->ic->ipmi_out, buf, IPMIPOWER_PACKET_BUFLEN)) < 0)
+    {
+      IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  /* cleanup path, ignore potential error */
+  if (cmd_args.common_args.driver_type == IPMI_DEVICE_LAN)
+    ipmi_lan_sendto (ip->ic->ipmi_fd,
+                     buf,
+                     len,
+                     0,
+                     ip->ic->destaddr,
+                     ip->ic->destaddrlen);
+  else
+    ipmi_rmcpplus_sendto (ip->ic->ipmi_fd,
+                          buf,
+                          len,
+                          0,
+                          ip->ic->destaddr,
+                          ip->ic->destaddrlen);
+}
+
+/* _session_restart
+ * - A reused session did not answer or answered with an error, the
+ *   BMC may have closed it.  Close it in case it is still up and
+ *   start the power control operation over with a new session.  Done
+ *   at most once, the new session is not a reused one.
+ */
+static void
+_session_restart (ipmipower_powercmd_t ip)
+{
+  assert (ip);
+  assert (ip->session_reused);
+
+  IPMIPOWER_DEBUG (("host = %s; reused session failed, starting a new session",
+                    ip->ic->hostname));
+
+  if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_START)
+    executing_count[ip->ic->shard]--;
+
+  _close_session_now (ip);
+
+  ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_START;
+  memset (&(ip->time_begin), '\0', sizeof (struct timeval));
+  ip->retransmission_count = 0;
+  ip->session_reused = 0;
+
+  _session_init (ip);
+}
+
+/* _rtt_sample
+ * - Update the round trip time estimate of a host after a good
+ *   packet was received.  Per Karn's algorithm, replies to
+ *   retransmitted packets are not used, it is unknown which packet
+ *   they answer.
+ */
+static void
+_rtt_sample (ipmipower_powercmd_t ip)
+{
+  struct timeval cur_time;
+
+  assert (ip);
+
+  if (ip->retransmission_count)
+    return;
+
+  if (gettimeofday (&cur_time, NULL) < 0)
+    {
+      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  rtt_sample (&(ip->ic->rtt), &(ip->ic->last_ipmi_send), &cur_time);
+}
+
+/* _retransmission_timeout
+ * - Retransmission timeout of a host in milliseconds, from its
+ *   measured round trip time.
+ */
+static unsigned int
+_retransmission_timeout (ipmipower_powercmd_t ip)
+{
+  assert (ip);
+
+  return (rtt_retransmission_timeout (&(ip->ic->rtt),
+                                      cmd_args.common_args.retransmission_timeout));
+}
+
 /* _recv_packet
  * - Receive a packet
  * Returns 1 if packet is of correct size and passes checks
@@ -1055,7 +1576,15 @@ _recv_packet (ipmipower_powercmd_t ip, ipmipower_packet_type_t pkt)
           if (pkt == IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RS)
             goto close_session_workaround;
 
-          ipmipower_output (ipmipower_packet_errmsg (ip, pkt), ip->ic->hostname, ip->extra_arg);
+          if (ip->session_reused)
+            {
+              _session_restart (ip);
+              rv = 0;
+              goto cleanup;
+            }
+
+          if (!ip->keepalive)
+            ipmipower_output (ipmipower_packet_errmsg (ip, pkt), ip->ic->hostname, ip->extra_arg);
 
           ip->retransmission_count = 0;  /* important to reset */
           if (gettimeofday (&ip->ic->last_ipmi_recv, NULL) < 0)
@@ -1233,6 +1762,13 @@ _recv_packet (ipmipower_powercmd_t ip, ipmipower_packet_type_t pkt)
           if (pkt == IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RS)
             goto close_session_workaround;
 
+          if (ip->session_reused)
+            {
+              _session_restart (ip);
+              rv = 0;
+              goto cleanup;
+            }
+
           ip->retransmission_count = 0;  /* important to reset */
           if (gettimeofday (&ip->ic->last_ipmi_recv, NULL) < 0)
             {
@@ -1260,6 +1796,8 @@ _recv_packet (ipmipower_powercmd_t ip, ipmipower_packet_type_t pkt)
    * close the session anyways.
    */
  close_session_workaround:
+  _rtt_sample (ip);
+  ip->session_reused = 0;       /* the session is still up */
   ip->retransmission_count = 0;  /* important to reset */
   if (gettimeofday (&ip->ic->last_ipmi_recv, NULL) < 0)
     {
@@ -1311,9 +1849,18 @@ _has_timed_out (ipmipower_powercmd_t ip)
   /* Must use >=, otherwise we could potentially spin */
   if (session_timeout >= cmd_args.common_args.session_timeout)
     {
+      if (ip->session_reused)
+        {
+          _session_restart (ip);
+          return (0);
+        }
+
       /* Don't bother outputting timeout if we have finished the power
-         control operation */
-      if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_CLOSE_SESSION_SENT)
+         control operation, or if this is only a keepalive */
+      if (ip->keepalive)
+        IPMIPOWER_DEBUG (("host = %s; keepalive timeout, idle session closed",
+                          ip->ic->hostname));
+      else if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_CLOSE_SESSION_SENT)
         {
           /* Special cases */
           if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_AUTHENTICATION_CAPABILITIES_SENT)
@@ -1354,7 +1901,7 @@ _retry_packets (ipmipower_powercmd_t ip)
           && ip->cmd == IPMIPOWER_POWER_CMD_POWER_OFF))
     retransmission_timeout = cmd_args.retransmission_wait_timeout * (1 + (ip->retransmission_count/cmd_args.retransmission_backoff_count));
   else
-    retransmission_timeout = cmd_args.common_args.retransmission_timeout * (1 + (ip->retransmission_count/cmd_args.retransmission_backoff_count));
+    retransmission_timeout = _retransmission_timeout (ip) * (1 + (ip->retransmission_count/cmd_args.retransmission_backoff_count));
 
   if (gettimeofday (&cur_time, NULL) < 0)
     {
@@ -1368,6 +1915,12 @@ _retry_packets (ipmipower_powercmd_t ip)
   if (time_since_last_ipmi_send < retransmission_timeout)
     return (0);
 
+  if (ip->session_reused)
+    {
+      _session_restart (ip);
+      return (0);
+    }
+
   /* Do we have enough time to retransmit? */
   timeval_add_ms (&cur_time, cmd_args.common_args.session_timeout, &end_time);
   timeval_sub (&end_time, &cur_time, &result);
@@ -1375,6 +1928,15 @@ _retry_packets (ipmipower_powercmd_t ip)
   if (time_left < retransmission_timeout)
     return (0);
 
+  if (!_admission_send (ip->ic->shard))
+    return (0);
+
+  /* A BMC that has never replied may just be down, which says
+   * nothing about the network.
+   */
+  if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_AUTHENTICATION_CAPABILITIES_SENT)
+    _admission_loss (ip->ic->shard);
+
   ip->retransmission_count++;
 
   IPMIPOWER_DEBUG (("host = %s; p = %d; Sending retry, retry count=%d",
@@ -1409,9 +1971,24 @@ _retry_packets (ipmipower_powercmd_t ip)
          * store the old file descriptrs (which are bound to the old
          * ports) on a list, and close all of them after we have gotten
          * past the Get Session Challenge phase of the protocol.
+         *
+         * With --shared-sockets, the connection is instead moved to
+         * another socket in the pool.
          */
         int new_fd, *old_fd;
 
+        if (cmd_args.shared_sockets)
+          {
+            if (ipmipower_connection_socket_rotate (ip->ic) < 0)
+              {
+                ipmipower_output (IPMIPOWER_MSG_TYPE_RESOURCES, ip->ic->hostname, ip->extra_arg);
+                return (-1);
+              }
+
+            _send_packet (ip, IPMIPOWER_PACKET_TYPE_GET_SESSION_CHALLENGE_RQ);
+            break;
+          }
+
         if ((new_fd = socket (ip->ic->srcaddr->sa_family, SOCK_DGRAM, 0)) < 0)
           {
             if (errno != EMFILE)
@@ -1897,17 +2474,31 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
        * many power commands.
        */
       if (cmd_args.common_args.fanout
-          && (executing_count >= cmd_args.common_args.fanout))
+          && (executing_count[ip->ic->shard] >= _shard_share (cmd_args.common_args.fanout, ip->ic->shard)))
         return (cmd_args.common_args.session_timeout);
 
-      _send_packet (ip, IPMIPOWER_PACKET_TYPE_AUTHENTICATION_CAPABILITIES_RQ);
+      /* Nor if too many sessions are being started at once.  A
+       * reused session or a keepalive does not start one.
+       */
+      if (!ip->session_reused
+          && !ip->keepalive
+          && (_admission_window_full (ip->ic->shard)
+              || !_admission_send (ip->ic->shard)))
+        return (cmd_args.common_args.session_timeout);
+
+      if (ip->keepalive)
+        _send_packet (ip, IPMIPOWER_PACKET_TYPE_GET_CHASSIS_STATUS_RQ);
+      else if (ip->session_reused)
+        _send_power_control_packet (ip);
+      else
+        _send_packet (ip, IPMIPOWER_PACKET_TYPE_AUTHENTICATION_CAPABILITIES_RQ);
 
       if (gettimeofday (&(ip->time_begin), NULL) < 0)
         {
           IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
           exit (EXIT_FAILURE);
         }
-      executing_count++;
+      executing_count[ip->ic->shard]++;
     }
   else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_AUTHENTICATION_CAPABILITIES_SENT)
     {
@@ -2016,28 +2607,16 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
           goto done;
         }
 
-      if (cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_NONE)
-        {
-          if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS
-              || ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_STATUS
-              || (cmd_args.on_if_off
-                  && (ip->cmd == IPMIPOWER_POWER_CMD_POWER_CYCLE
-                      || ip->cmd == IPMIPOWER_POWER_CMD_POWER_RESET)))
-            _send_packet (ip, IPMIPOWER_PACKET_TYPE_GET_CHASSIS_STATUS_RQ);
-          else if (ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_ON
-                   || ip->cmd == IPMIPOWER_POWER_CMD_IDENTIFY_OFF)
-            _send_packet (ip, IPMIPOWER_PACKET_TYPE_CHASSIS_IDENTIFY_RQ);
-          else /* on, off, cycle, reset, pulse diag interupt, soft shutdown */
-            _send_packet (ip, IPMIPOWER_PACKET_TYPE_CHASSIS_CONTROL_RQ);
-        }
-      else /* cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_C410X */
-        {
-          assert (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS
-                  || ip->cmd == IPMIPOWER_POWER_CMD_POWER_OFF
-                  || ip->cmd == IPMIPOWER_POWER_CMD_POWER_ON);
+      _send_power_control_packet (ip);
+    }
+  else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_GET_CHASSIS_STATUS_SENT
+           && ip->keepalive)
+    {
+      /* Any reply, even an error, shows the idle session is still up */
+      if (!_recv_packet (ip, IPMIPOWER_PACKET_TYPE_GET_CHASSIS_STATUS_RS))
+        goto done;
 
-          _send_packet (ip, IPMIPOWER_PACKET_TYPE_C410X_GET_SENSOR_READING_RQ);
-        }
+      ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE;
     }
   else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_GET_CHASSIS_STATUS_SENT)
     {
@@ -2069,7 +2648,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
               ip->wait_until_on_state = 0;
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
         }
       else if (cmd_args.wait_until_off
@@ -2080,7 +2659,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
               ip->wait_until_off_state = 0;
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
         }
       else if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS)
@@ -2088,7 +2667,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
           ipmipower_output ((power_state == IPMI_SYSTEM_POWER_IS_ON) ? IPMIPOWER_MSG_TYPE_ON : IPMIPOWER_MSG_TYPE_OFF,
                             ip->ic->hostname,
                             ip->extra_arg);
-          _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+          _finish_session (ip);
         }
       else if (cmd_args.on_if_off && (ip->cmd == IPMIPOWER_POWER_CMD_POWER_CYCLE
                                       || ip->cmd == IPMIPOWER_POWER_CMD_POWER_RESET))
@@ -2139,7 +2718,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
           else
             ipmipower_output (IPMIPOWER_MSG_TYPE_UNKNOWN, ip->ic->hostname, ip->extra_arg);
 
-          _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+          _finish_session (ip);
         }
       else
         {
@@ -2178,12 +2757,13 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
            *
            * There is no response from the IPMI close command if the
            * IPMIPOWER_POWER_CMD_POWER_RESET power control command is
-           * successful.  So just skip the close session.
+           * successful.  So just skip the close session.  The
+           * session can't be trusted for --reuse-sessions either.
            */
           if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_RESET)
             goto finish_up;
           else
-            _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+            _finish_session (ip);
         }
     }
   else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_CHASSIS_IDENTIFY_SENT)
@@ -2197,7 +2777,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
         }
 
       ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
-      _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+      _finish_session (ip);
     }
   else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_C410X_GET_SENSOR_READING_SENT)
     {
@@ -2267,7 +2847,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
               ip->wait_until_on_state = 0;
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
         }
       else if (cmd_args.wait_until_off
@@ -2278,7 +2858,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
               ip->wait_until_off_state = 0;
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
         }
       else if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_STATUS)
@@ -2286,14 +2866,14 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
           ipmipower_output ((slot_power_on_flag) ? IPMIPOWER_MSG_TYPE_ON : IPMIPOWER_MSG_TYPE_OFF,
                             ip->ic->hostname,
                             ip->extra_arg);
-          _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+          _finish_session (ip);
         }
       else if (ip->cmd == IPMIPOWER_POWER_CMD_POWER_ON)
         {
           if (slot_power_on_flag)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
           else
             _send_packet (ip, IPMIPOWER_PACKET_TYPE_C410X_SLOT_POWER_CONTROL_RQ);
@@ -2303,7 +2883,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
           if (!slot_power_on_flag)
             {
               ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
-              _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+              _finish_session (ip);
             }
           else
             _send_packet (ip, IPMIPOWER_PACKET_TYPE_C410X_SLOT_POWER_CONTROL_RQ);
@@ -2338,7 +2918,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
       else
         {
           ipmipower_output (IPMIPOWER_MSG_TYPE_OK, ip->ic->hostname, ip->extra_arg);
-          _send_packet (ip, IPMIPOWER_PACKET_TYPE_CLOSE_SESSION_RQ);
+          _finish_session (ip);
         }
     }
   else if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_CLOSE_SESSION_SENT)
@@ -2374,6 +2954,14 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
     }
 
  done:
+  /* parked, see ipmipower_powercmd_process_pending() */
+  if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE)
+    return (-1);
+
+  /* a reused session failed, see _session_restart() */
+  if (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_START)
+    return (_process_ipmi_packets (ip));
+
   if (gettimeofday (&cur_time, NULL) < 0)
     {
       IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
@@ -2393,7 +2981,7 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
     }
   else
     {
-      int retransmission_timeout = cmd_args.common_args.retransmission_timeout * (1 + (ip->retransmission_count/cmd_args.retransmission_backoff_count));
+      int retransmission_timeout = _retransmission_timeout (ip) * (1 + (ip->retransmission_count/cmd_args.retransmission_backoff_count));
       if (timeout > retransmission_timeout)
         timeout = retransmission_timeout;
     }
@@ -2401,26 +2989,133 @@ _process_ipmi_packets (ipmipower_powercmd_t ip)
   return (timeout);
 }
 
+/* _session_park
+ * - keep an idle session for --reuse-sessions
+ */
+static void
+_session_park (unsigned int shard, ipmipower_powercmd_t ip)
+{
+  assert (shard < shards_count);
+  assert (ip);
+  assert (ip->protocol_state == IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE);
+
+  ip->keepalive = 0;
+  if (gettimeofday (&(ip->time_idle), NULL) < 0)
+    {
+      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  if (!list_append (idle[shard], ip))
+    {
+      IPMIPOWER_ERROR (("list_append: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+}
+
+/* _process_idle_sessions
+ * - move idle sessions due for a keepalive to the pending list
+ * - returns the timeout until the next keepalive is due, -1 if there
+ *   are no idle sessions
+ */
+static int
+_process_idle_sessions (unsigned int shard)
+{
+  struct timeval cur_time, result;
+  unsigned int idle_time;
+  ListIterator itr;
+  ipmipower_powercmd_t ip;
+  int timeout = -1;
+
+  assert (shard < shards_count);
+
+  if (list_is_empty (idle[shard]))
+    return (-1);
+
+  if (gettimeofday (&cur_time, NULL) < 0)
+    {
+      IPMIPOWER_ERROR (("gettimeofday: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  if (!(itr = list_iterator_create (idle[shard])))
+    {
+      IPMIPOWER_ERROR (("list_iterator_create: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  while ((ip = (ipmipower_powercmd_t)list_next (itr)))
+    {
+      timeval_sub (&cur_time, &(ip->time_idle), &result);
+      timeval_millisecond_calc (&result, &idle_time);
+
+      if (idle_time < IPMIPOWER_SESSION_KEEPALIVE_INTERVAL)
+        {
+          if (timeout < 0
+              || (IPMIPOWER_SESSION_KEEPALIVE_INTERVAL - idle_time) < timeout)
+            timeout = IPMIPOWER_SESSION_KEEPALIVE_INTERVAL - idle_time;
+          continue;
+        }
+
+      if (!list_remove (itr))
+        {
+          IPMIPOWER_ERROR (("list_remove"));
+          exit (EXIT_FAILURE);
+        }
+
+      ipmipower_connection_clear (ip->ic);
+
+      ip->protocol_state = IPMIPOWER_PROTOCOL_STATE_START;
+      memset (&(ip->time_begin), '\0', sizeof (struct timeval));
+      ip->retransmission_count = 0;
+      ip->close_timeout = 0;
+      ip->keepalive = 1;
+
+      if (!list_append (pending[shard], ip))
+        {
+          IPMIPOWER_ERROR (("list_append: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+      keepalive_count[shard]++;
+    }
+
+  list_iterator_destroy (itr);
+  return (timeout);
+}
+
 int
-ipmipower_powercmd_process_pending (int *timeout)
+ipmipower_powercmd_process_pending (unsigned int shard, int *timeout)
 {
   ListIterator itr;
   ipmipower_powercmd_t ip;
   int min_timeout = cmd_args.common_args.session_timeout;
+  int idle_timeout = -1;
   int num_pending;
 
-  assert (pending);  /* did not run ipmipower_powercmd_setup() */
+  assert (shards_count);  /* did not run ipmipower_powercmd_setup() */
+  assert (shard < shards_count);
   assert (timeout);
 
-  /* if there are no pending jobs, don't edit the timeout */
-  if (list_is_empty (pending))
-    return (0);
+  if (reuse_sessions)
+    idle_timeout = _process_idle_sessions (shard);
+
+  /* if there are no pending jobs, don't edit the timeout, unless
+   * to wake up for the next keepalive
+   */
+  if (list_is_empty (pending[shard]))
+    {
+      if (idle_timeout >= 0)
+        *timeout = idle_timeout;
+      return (0);
+    }
+
+  admission[shard].wait = -1;
 
   /* If we have a fanout, powercmds should be executed "in order" on
    * this list.  So no need to iterate through this list twice.
    */
 
-  if (!(itr = list_iterator_create (pending)))
+  if (!(itr = list_iterator_create (pending[shard])))
     {
       IPMIPOWER_ERROR (("list_iterator_create: %s", strerror (errno)));
       exit (EXIT_FAILURE);
@@ -2428,15 +3123,18 @@ ipmipower_powercmd_process_pending (int *timeout)
 
   while ((ip = (ipmipower_powercmd_t)list_next (itr)))
     {
+      ipmipower_protocol_state_t protocol_state;
       int tmp_timeout = -1;
 
       if ((tmp_timeout = _process_ipmi_packets (ip)) < 0)
         {
+          protocol_state = ip->protocol_state;
+
           if (cmd_args.oem_power_type == IPMIPOWER_OEM_POWER_TYPE_C410X)
             {
               if (ip->next)
                 {
-                  if (!list_append (add_to_pending, ip->next))
+                  if (!list_append (add_to_pending[shard], ip->next))
                     {
                       IPMIPOWER_ERROR (("list_append: %s", strerror (errno)));
                       exit (EXIT_FAILURE);
@@ -2446,13 +3144,30 @@ ipmipower_powercmd_process_pending (int *timeout)
                 }
             }
 
-          if (!list_delete (itr))
+          if (ip->keepalive)
+            keepalive_count[shard]--;
+
+          if (protocol_state == IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE)
+            {
+              if (!list_remove (itr))
+                {
+                  IPMIPOWER_ERROR (("list_remove"));
+                  exit (EXIT_FAILURE);
+                }
+
+              _session_park (shard, ip);
+            }
+          else if (!list_delete (itr))
             {
               IPMIPOWER_ERROR (("list_delete"));
               exit (EXIT_FAILURE);
             }
 
-          executing_count--;
+          if (protocol_state == IPMIPOWER_PROTOCOL_STATE_END
+              || protocol_state == IPMIPOWER_PROTOCOL_STATE_SESSION_IDLE)
+            _admission_success (shard);
+
+          executing_count[shard]--;
           continue;
         }
 
@@ -2461,11 +3176,11 @@ ipmipower_powercmd_process_pending (int *timeout)
     }
   list_iterator_destroy (itr);
 
-  if (list_count (add_to_pending) > 0)
+  if (list_count (add_to_pending[shard]) > 0)
     {
       ListIterator addtoitr;
 
-      if (!(addtoitr = list_iterator_create (add_to_pending)))
+      if (!(addtoitr = list_iterator_create (add_to_pending[shard])))
         {
           IPMIPOWER_ERROR (("list_iterator_create: %s", strerror (errno)));
           exit (EXIT_FAILURE);
@@ -2473,7 +3188,7 @@ ipmipower_powercmd_process_pending (int *timeout)
       while ((ip = list_next (addtoitr)))
         {
           ipmipower_connection_clear (ip->ic);
-          if (!list_append (pending, ip))
+          if (!list_append (pending[shard], ip))
             {
               IPMIPOWER_ERROR (("list_append: %s", strerror (errno)));
               exit (EXIT_FAILURE);
@@ -2498,9 +3213,19 @@ ipmipower_powercmd_process_pending (int *timeout)
         min_timeout = cmd_args.common_args.retransmission_timeout;
     }
 
-  if (!(num_pending = list_count (pending)))
+  /* wake up when the next session may be started or retransmitted */
+  if (admission[shard].wait >= 0 && admission[shard].wait < min_timeout)
+    min_timeout = admission[shard].wait;
+
+  /* with --threads, the final output waits for every shard */
+  num_pending = list_count (pending[shard]);
+  if (num_pending == keepalive_count[shard]
+      && shards_count == 1)
     ipmipower_output_finish ();
 
+  if (idle_timeout >= 0 && idle_timeout < min_timeout)
+    min_timeout = idle_timeout;
+
   /* If the last pending power control command finished, the timeout
    * is 0 to get the primary poll loop to "re-init" at the start of
    * the loop.
@@ -2511,3 +3236,54 @@ ipmipower_powercmd_process_pending (int *timeout)
     *timeout = 0;
   return (num_pending);
 }
+
+void
+ipmipower_powercmd_close_sessions ()
+{
+  ListIterator itr;
+  ipmipower_powercmd_t ip;
+  unsigned int i;
+
+  assert (shards_count);  /* did not run ipmipower_powercmd_setup() */
+
+  if (!reuse_sessions)
+    return;
+
+  for (i = 0; i < shards_count; i++)
+    {
+      while ((ip = (ipmipower_powercmd_t)list_pop (idle[i])))
+        {
+          _close_session_now (ip);
+          _destroy_ipmipower_powercmd (ip);
+        }
+
+      if (!keepalive_count[i])
+        continue;
+
+      if (!(itr = list_iterator_create (pending[i])))
+        {
+          IPMIPOWER_ERROR (("list_iterator_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      while ((ip = (ipmipower_powercmd_t)list_next (itr)))
+        {
+          if (!ip->keepalive)
+            continue;
+
+          if (ip->protocol_state != IPMIPOWER_PROTOCOL_STATE_START)
+            executing_count[i]--;
+          keepalive_count[i]--;
+
+          _close_session_now (ip);
+
+          if (!list_delete (itr))
+            {
+              IPMIPOWER_ERROR (("list_delete"));
+              exit (EXIT_FAILURE);
+            }
+        }
+
+      list_iterator_destroy (itr);
+    }
+}
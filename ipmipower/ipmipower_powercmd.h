@@ -39,16 +39,26 @@ void ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
 
 /* ipmipower_powercmd_pending
  * - Determines if any commands are still pending
+ * - Keepalives of idle sessions for --reuse-sessions are not counted
  * Returns 1 if commands are still being executed, 0 if not
  */
 int ipmipower_powercmd_pending ();
 
+/* ipmipower_powercmd_close_sessions
+ * - Close all idle sessions kept for --reuse-sessions.  Must be
+ *   called before connections are destroyed or session settings are
+ *   changed.
+ */
+void ipmipower_powercmd_close_sessions ();
+
 /* ipmipower_powercmd_process_pending
- * - Process remaining commands still in the queue
+ * - Process remaining commands still in the queue of the specified
+ *   shard.  Shard is always 0 unless --threads is used.
  * - Sets timeout to min timeout of all pending requests
- * - Does not set timeout if no pending requests exist
+ * - Does not set timeout if no pending requests exist, unless idle
+ *   sessions are waiting for a keepalive
  * Returns number of pending requests, 0 if none
  */
-int ipmipower_powercmd_process_pending (int *timeout);
+int ipmipower_powercmd_process_pending (unsigned int shard, int *timeout);
 
 #endif /* IPMIPOWER_POWERCMD_H */
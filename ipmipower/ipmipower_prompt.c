@@ -85,6 +85,8 @@ _cmd_driver_type (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1])
     {
       int tmp;
@@ -111,6 +113,9 @@ _cmd_driver_type (char **argv)
 static void
 _cmd_hostname_clear (void)
 {
+  /* idle sessions refer to the connections */
+  ipmipower_powercmd_close_sessions ();
+
   free (cmd_args.common_args.hostname);
   cmd_args.common_args.hostname = NULL;
 
@@ -170,6 +175,8 @@ _cmd_username (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (!argv[1]
       || (argv[1] && strlen (argv[1]) <= IPMI_MAX_USER_NAME_LENGTH))
     {
@@ -198,6 +205,8 @@ _cmd_password (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1] && cmd_args.common_args.authentication_type == IPMI_AUTHENTICATION_TYPE_NONE)
     ipmipower_cbuf_printf (ttyout,
                            "password cannot be set for authentication_type '%s'\n",
@@ -243,6 +252,8 @@ _cmd_k_g (char **argv)
 
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (cmd_args.common_args.driver_type == IPMI_DEVICE_LAN)
     ipmipower_cbuf_printf (ttyout, "k_g is only used for IPMI 2.0");
   else
@@ -275,6 +286,8 @@ _cmd_authentication_type (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1])
     {
       int tmp;
@@ -305,6 +318,8 @@ _cmd_cipher_suite_id (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1])
     {
       char *endptr;
@@ -341,6 +356,8 @@ _cmd_privilege_level (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1])
     {
       int tmp;
@@ -370,6 +387,8 @@ _cmd_workaround_flags (char **argv)
 {
   assert (argv);
 
+  ipmipower_powercmd_close_sessions ();
+
   if (argv[1])
     {
       unsigned int outofband_flags, outofband_2_0_flags;
@@ -120,14 +120,18 @@ static struct argp_option cmdline_options[] =
       "Ignore SDR related processing.", 60},
     { "re-download-sdr", IPMISELD_RE_DOWNLOAD_SDR_KEY, 0, 0,
       "Re-download the SDR even if it is not out of date.", 61},
+    { "shared-sdr-cache", IPMISELD_SHARED_SDR_CACHE_KEY, 0, 0,
+      "Share one SDR cache between hosts with identical SDRs.", 62},
+    { "sel-pipeline", IPMISELD_SEL_PIPELINE_KEY, 0, 0,
+      "Issue several SEL read requests at once.", 63},
     { "clear-sel", IPMISELD_CLEAR_SEL_KEY, 0, 0,
-      "Clear SEL on startup.", 62},
+      "Clear SEL on startup.", 64},
     { "threadpool-count", IPMISELD_THREADPOOL_COUNT_KEY, "NUM", 0,
-      "Specify threadpool count for parallel SEL polling.", 63},
+      "Specify threadpool count for parallel SEL polling.", 65},
     { "test-run", IPMISELD_TEST_RUN_KEY, 0, 0,
-      "Do not daemonize, output current SEL as test of current settings.", 64},
+      "Do not daemonize, output current SEL as test of current settings.", 66},
     { "foreground", IPMISELD_FOREGROUND_KEY, 0, 0,
-      "Run daemon in foreground.", 65},
+      "Run daemon in foreground.", 67},
     { NULL, 0, NULL, 0, NULL, 0}
   };
 
@@ -291,6 +295,12 @@ cmdline_parse (int key, char *arg, struct argp_state *state)
     case IPMISELD_RE_DOWNLOAD_SDR_KEY:
       cmd_args->re_download_sdr = 1;
       break;
+    case IPMISELD_SHARED_SDR_CACHE_KEY:
+      cmd_args->shared_sdr_cache = 1;
+      break;
+    case IPMISELD_SEL_PIPELINE_KEY:
+      cmd_args->sel_pipeline = 1;
+      break;
     case IPMISELD_CLEAR_SEL_KEY:
       cmd_args->clear_sel = 1;
       break;
@@ -431,6 +441,10 @@ _ipmiseld_config_file_parse (struct ipmiseld_arguments *cmd_args)
     cmd_args->ignore_sdr = config_file_data.ignore_sdr;
   if (config_file_data.re_download_sdr_count)
     cmd_args->re_download_sdr = config_file_data.re_download_sdr;
+  if (config_file_data.shared_sdr_cache_count)
+    cmd_args->shared_sdr_cache = config_file_data.shared_sdr_cache;
+  if (config_file_data.sel_pipeline_count)
+    cmd_args->sel_pipeline = config_file_data.sel_pipeline;
   if (config_file_data.clear_sel_count)
     cmd_args->clear_sel = config_file_data.clear_sel;
   if (config_file_data.threadpool_count_count)
@@ -529,6 +543,8 @@ ipmiseld_argp_parse (int argc, char **argv, struct ipmiseld_arguments *cmd_args)
   cmd_args->cache_directory = NULL;
   cmd_args->ignore_sdr = 0;
   cmd_args->re_download_sdr = 0;
+  cmd_args->shared_sdr_cache = 0;
+  cmd_args->sel_pipeline = 0;
   cmd_args->clear_sel = 0;
   cmd_args->threadpool_count = IPMISELD_THREADPOOL_COUNT;
   cmd_args->test_run = 0;
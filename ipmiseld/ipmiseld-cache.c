@@ -122,12 +122,140 @@ _ipmiseld_sdr_cache_create (ipmiseld_host_data_t *host_data,
   return (0);
 }
 
+/* With --shared-sdr-cache the cache is named by the SDR repository
+ * key rather than the hostname, so all hosts with identical BMCs open
+ * the same file and only the first of them downloads the SDR.
+ */
+static int
+_ipmiseld_sdr_cache_load_shared (ipmiseld_host_data_t *host_data,
+                                 const char *sdr_cache_dir,
+                                 const char *hostname)
+{
+  char key[IPMI_SDR_CACHE_KEY_BUFLEN];
+  char filename[MAXPATHLEN+1];
+  char tmpfilename[MAXPATHLEN+1];
+
+  assert (host_data);
+  assert (host_data->host_poll);
+  assert (host_data->host_poll->sdr_ctx);
+  assert (host_data->host_poll->ipmi_ctx);
+  assert (sdr_cache_dir);
+  assert (hostname);
+
+  memset (filename, '\0', MAXPATHLEN + 1);
+  memset (tmpfilename, '\0', MAXPATHLEN + 1);
+
+  if (ipmi_sdr_cache_key (host_data->host_poll->sdr_ctx,
+                          host_data->host_poll->ipmi_ctx,
+                          key,
+                          IPMI_SDR_CACHE_KEY_BUFLEN) < 0)
+    {
+      ipmiseld_err_output (host_data,
+                           "ipmi_sdr_cache_key: %s",
+                           ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+      goto cleanup;
+    }
+
+  snprintf (filename,
+            MAXPATHLEN,
+            "%s/%s.%s",
+            sdr_cache_dir,
+            IPMISELD_SDR_CACHE_FILENAME,
+            key);
+
+  if (host_data->prog_data->args->re_download_sdr
+      && !host_data->re_download_sdr_done)
+    {
+      if (host_data->prog_data->args->common_args.debug)
+        IPMISELD_HOST_DEBUG (("SDR cache - deleting"));
+
+      if (ipmi_sdr_cache_delete (host_data->host_poll->sdr_ctx, filename) < 0)
+        {
+          ipmiseld_err_output (host_data,
+                               "ipmi_sdr_cache_delete: %s",
+                               ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+          goto cleanup;
+        }
+      host_data->re_download_sdr_done = 1;
+    }
+
+  /* key already covers the SDR timestamps, no need to recheck them */
+  if (!ipmi_sdr_cache_open (host_data->host_poll->sdr_ctx, NULL, filename))
+    return (0);
+
+  if (ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) != IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
+      && ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) != IPMI_SDR_ERR_CACHE_INVALID)
+    {
+      ipmiseld_err_output (host_data,
+                           "ipmi_sdr_cache_open: %s",
+                           ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+      goto cleanup;
+    }
+
+  if (host_data->prog_data->args->common_args.debug)
+    IPMISELD_HOST_DEBUG (("SDR cache %s not available - creating", key));
+
+  /* Create under a per-host name and rename into place, so other
+   * hosts never open a partially written cache.
+   */
+  if (snprintf (tmpfilename,
+                MAXPATHLEN,
+                "%s.%s",
+                filename,
+                hostname) >= MAXPATHLEN)
+    {
+      ipmiseld_err_output (host_data,
+                           "SDR cache filename '%s.%s' too long",
+                           filename,
+                           hostname);
+      /* never delete the truncated name in cleanup */
+      memset (tmpfilename, '\0', MAXPATHLEN + 1);
+      goto cleanup;
+    }
+
+  if (ipmi_sdr_cache_delete (host_data->host_poll->sdr_ctx, tmpfilename) < 0)
+    {
+      ipmiseld_err_output (host_data,
+                           "ipmi_sdr_cache_delete: %s",
+                           ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+      goto cleanup;
+    }
+
+  if (_ipmiseld_sdr_cache_create (host_data, tmpfilename) < 0)
+    goto cleanup;
+
+  if (rename (tmpfilename, filename) < 0)
+    {
+      ipmiseld_err_output (host_data,
+                           "Error renaming SDR cache '%s': %s",
+                           tmpfilename,
+                           strerror (errno));
+      goto cleanup;
+    }
+
+  if (ipmi_sdr_cache_open (host_data->host_poll->sdr_ctx, NULL, filename) < 0)
+    {
+      ipmiseld_err_output (host_data,
+                           "ipmi_sdr_cache_open: %s",
+                           ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+      goto cleanup;
+    }
+
+  return (0);
+
+ cleanup:
+  if (strlen (tmpfilename))
+    ipmi_sdr_cache_delete (host_data->host_poll->sdr_ctx, tmpfilename);
+  return (-1);
+}
+
 int
 ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
 {
   char filename[MAXPATHLEN+1];
   char *sdr_cache_dir;
   char *hostname;
+  unsigned int sdr_flags;
 
   assert (host_data);
   assert (host_data->host_poll);
@@ -141,15 +269,25 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
       goto cleanup;
     }
 
+  /* sensors are looked up for every SEL event logged, index the cache */
+  sdr_flags = IPMI_SDR_FLAGS_CACHE_INDEX;
+
+  if (host_data->prog_data->args->shared_sdr_cache)
+    sdr_flags |= IPMI_SDR_FLAGS_CACHE_SHARED;
+
   if (host_data->prog_data->args->foreground
       && host_data->prog_data->args->common_args.debug > 1)
-    {
-      /* Don't error out, if this fails we can still continue */
-      if (ipmi_sdr_ctx_set_flags (host_data->host_poll->sdr_ctx, IPMI_SDR_FLAGS_DEBUG_DUMP) < 0)
-        ipmiseld_err_output (host_data,
-                             "ipmi_sdr_ctx_set_flags: %s",
-                             ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
+    sdr_flags |= IPMI_SDR_FLAGS_DEBUG_DUMP;
+
+  /* Don't error out, if this fails we can still continue */
+  if (ipmi_sdr_ctx_set_flags (host_data->host_poll->sdr_ctx, sdr_flags) < 0)
+    ipmiseld_err_output (host_data,
+                         "ipmi_sdr_ctx_set_flags: %s",
+                         ipmi_sdr_ctx_errormsg (host_data->host_poll->sdr_ctx));
 
+  if (host_data->prog_data->args->foreground
+      && host_data->prog_data->args->common_args.debug > 1)
+    {
       if (host_data->hostname)
         {
           if (ipmi_sdr_ctx_set_debug_prefix (host_data->host_poll->sdr_ctx, host_data->hostname) < 0)
@@ -168,6 +306,13 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
   if (!hostname)
     hostname = IPMISELD_CACHE_INBAND;
 
+  if (host_data->prog_data->args->shared_sdr_cache)
+    {
+      if (_ipmiseld_sdr_cache_load_shared (host_data, sdr_cache_dir, hostname) < 0)
+        goto cleanup;
+      return (0);
+    }
+
   snprintf (filename,
             MAXPATHLEN,
             "%s/%s.%s",
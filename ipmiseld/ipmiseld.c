@@ -1322,6 +1322,9 @@ _ipmiseld_poll (void *arg)
   if (host_data->prog_data->args->common_args.section_specific_workaround_flags & IPMI_PARSE_SECTION_SPECIFIC_WORKAROUND_FLAGS_ASSUME_SYSTEM_EVENT)
     sel_flags |= IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS;
 
+  if (host_data->prog_data->args->sel_pipeline)
+    sel_flags |= IPMI_SEL_FLAGS_PIPELINE;
+
   if (sel_flags)
     {
       /* Don't error out, if this fails we can still continue */
@@ -97,6 +97,8 @@ enum ipmiseld_argp_option_keys
     IPMISELD_THREADPOOL_COUNT_KEY = 180,
     IPMISELD_TEST_RUN_KEY = 181,
     IPMISELD_FOREGROUND_KEY = 182,
+    IPMISELD_SHARED_SDR_CACHE_KEY = 183,
+    IPMISELD_SEL_PIPELINE_KEY = 184,
   };
 
 struct ipmiseld_arguments
@@ -126,6 +128,8 @@ struct ipmiseld_arguments
   char *cache_directory;
   int ignore_sdr;
   int re_download_sdr;
+  int shared_sdr_cache;
+  int sel_pipeline;
   int clear_sel;
   unsigned int threadpool_count;
   int test_run;
@@ -52,6 +52,8 @@
 
 #include "freeipmi/api/ipmi-api.h"
 
+#include "rtt.h"
+
 #define IPMI_MAX_SIK_KEY_LENGTH                           64
 #define IPMI_MAX_INTEGRITY_KEY_LENGTH                     64
 #define IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH               64
@@ -157,9 +159,26 @@ struct ipmi_ctx
       uint8_t rq_seq;
       struct timeval last_send;
       struct timeval last_received;
+      /* Round trip time estimate, in microseconds, for the
+       * retransmission timeout
+       */
+      struct rtt rtt;
       uint32_t highest_received_sequence_number;
       uint32_t previously_received_list;
 
+      /* Outstanding command submitted by ipmi_cmd_poll_submit() */
+      struct
+      {
+        int pending;
+        uint8_t cmd;                /* for debug dumping */
+        uint8_t group_extension;    /* for debug dumping */
+        unsigned int retransmission_count;
+        fiid_obj_t obj_cmd_rq;
+        fiid_obj_t obj_cmd_rs;
+        Ipmi_Cmd_Poll_Callback callback;
+        void *callback_data;
+      } poll;
+
       /* Used by IPMI 1.5 */
       uint32_t session_id;
 
@@ -41,6 +41,7 @@
 #include "ipmi-api-defs.h"
 #include "ipmi-api-util.h"
 #include "ipmi-api-trace.h"
+#include "ipmi-lan-interface-api.h"
 
 #include "freeipmi-portability.h"
 
@@ -400,6 +401,43 @@ api_ipmi_cmd (ipmi_ctx_t ctx,
   return (_api_ipmi_cmd_post (ctx, obj_cmd_rs));
 }
 
+int
+api_ipmi_cmd_batch_pipelined (ipmi_ctx_t ctx)
+{
+  assert (ctx && ctx->magic == IPMI_CTX_MAGIC);
+
+  if (ctx->type != IPMI_DEVICE_LAN_2_0
+      || (ctx->target.channel_number_is_set
+          && ctx->target.rs_addr_is_set))
+    return (0);
+
+  return (1);
+}
+
+int
+api_ipmi_cmd_batch (ipmi_ctx_t ctx,
+                    uint8_t lun,
+                    uint8_t net_fn,
+                    fiid_obj_t *obj_cmd_rq,
+                    fiid_obj_t *obj_cmd_rs,
+                    unsigned int count)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && obj_cmd_rq
+          && obj_cmd_rs
+          && count);
+
+  /* Note: ctx->errnum set in call to ipmi_cmd_batch() */
+  return (ipmi_cmd_batch (ctx,
+                          lun,
+                          net_fn,
+                          obj_cmd_rq,
+                          obj_cmd_rs,
+                          count,
+                          IPMI_CMD_BATCH_WINDOW_DEFAULT));
+}
+
 int
 api_ipmi_cmd_ipmb (ipmi_ctx_t ctx,
                    uint8_t channel_number,
@@ -61,6 +61,21 @@ int api_ipmi_cmd (ipmi_ctx_t ctx,
                   fiid_obj_t obj_cmd_rq,
                   fiid_obj_t obj_cmd_rs);
 
+/* Returns 1 if ipmi_cmd_batch() will keep requests outstanding at
+ * once, 0 if it will issue them one at a time.
+ */
+int api_ipmi_cmd_batch_pipelined (ipmi_ctx_t ctx);
+
+/* ipmi_cmd_batch() with the default window.  Completion codes are
+ * not checked, the caller must check each response.
+ */
+int api_ipmi_cmd_batch (ipmi_ctx_t ctx,
+                        uint8_t lun,
+                        uint8_t net_fn,
+                        fiid_obj_t *obj_cmd_rq,
+                        fiid_obj_t *obj_cmd_rs,
+                        unsigned int count);
+
 int api_ipmi_cmd_ipmb (ipmi_ctx_t ctx,
                        uint8_t channel_number,
                        uint8_t rs_addr,
@@ -545,6 +545,8 @@ ipmi_ctx_open_outofband (ipmi_ctx_t ctx,
 
   memset (&ctx->io.outofband.last_send, '\0', sizeof (struct timeval));
   memset (&ctx->io.outofband.last_received, '\0', sizeof (struct timeval));
+  rtt_init (&ctx->io.outofband.rtt);
+  memset (&ctx->io.outofband.poll, '\0', sizeof (ctx->io.outofband.poll));
 
   if (ipmi_check_session_sequence_number_1_5_init (&(ctx->io.outofband.highest_received_sequence_number),
                                                    &(ctx->io.outofband.previously_received_list)) < 0)
@@ -741,6 +743,8 @@ ipmi_ctx_open_outofband_2_0 (ipmi_ctx_t ctx,
   ctx->io.outofband.confidentiality_key_len = IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH;
   memset (&ctx->io.outofband.last_send, '\0', sizeof (struct timeval));
   memset (&ctx->io.outofband.last_received, '\0', sizeof (struct timeval));
+  rtt_init (&ctx->io.outofband.rtt);
+  memset (&ctx->io.outofband.poll, '\0', sizeof (ctx->io.outofband.poll));
 
   if (ipmi_check_session_sequence_number_2_0_init (&(ctx->io.outofband.highest_received_sequence_number),
                                                    &(ctx->io.outofband.previously_received_list)) < 0)
@@ -1579,6 +1583,19 @@ ipmi_ctx_get_target (ipmi_ctx_t ctx,
   return (0);
 }
 
+/* A polled command owns the session sequence numbers until
+ * it completes
+ */
+static int
+_poll_cmd_pending (ipmi_ctx_t ctx)
+{
+  assert (ctx && ctx->magic == IPMI_CTX_MAGIC);
+
+  return ((ctx->type == IPMI_DEVICE_LAN
+           || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.poll.pending);
+}
+
 int
 ipmi_cmd (ipmi_ctx_t ctx,
           uint8_t lun,
@@ -1645,6 +1662,12 @@ ipmi_cmd (ipmi_ctx_t ctx,
       return (-1);
     }
 
+  if (_poll_cmd_pending (ctx))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DRIVER_BUSY);
+      return (-1);
+    }
+
   ctx->target.lun = lun;
   ctx->target.net_fn = net_fn;
 
@@ -1945,6 +1968,12 @@ ipmi_cmd_raw (ipmi_ctx_t ctx,
       return (-1);
     }
 
+  if (_poll_cmd_pending (ctx))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DRIVER_BUSY);
+      return (-1);
+    }
+
   ctx->target.lun = lun;
   ctx->target.net_fn = net_fn;
 
@@ -2160,6 +2189,257 @@ ipmi_cmd_raw_ipmb (ipmi_ctx_t ctx,
   return (rv);
 }
 
+int
+ipmi_cmd_batch (ipmi_ctx_t ctx,
+                uint8_t lun,
+                uint8_t net_fn,
+                fiid_obj_t *obj_cmd_rq,
+                fiid_obj_t *obj_cmd_rs,
+                unsigned int count,
+                unsigned int window)
+{
+  unsigned int i;
+
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (ctx->type == IPMI_DEVICE_UNKNOWN)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DEVICE_NOT_OPEN);
+      return (-1);
+    }
+
+  if (!obj_cmd_rq
+      || !obj_cmd_rs
+      || !count
+      || window > IPMI_CMD_BATCH_WINDOW_MAX)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!window)
+    window = IPMI_CMD_BATCH_WINDOW_DEFAULT;
+
+  if (!api_ipmi_cmd_batch_pipelined (ctx)
+      || window == 1)
+    {
+      for (i = 0; i < count; i++)
+        {
+          /* Note: ctx->errnum set in call to ipmi_cmd() */
+          if (ipmi_cmd (ctx,
+                        lun,
+                        net_fn,
+                        obj_cmd_rq[i],
+                        obj_cmd_rs[i]) < 0)
+            return (-1);
+        }
+      return (0);
+    }
+
+  if (!IPMI_BMC_LUN_VALID (lun)
+      || !IPMI_NET_FN_VALID (net_fn))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if (!fiid_obj_valid (obj_cmd_rq[i])
+          || !fiid_obj_valid (obj_cmd_rs[i]))
+        {
+          API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+          return (-1);
+        }
+
+      if (FIID_OBJ_PACKET_VALID (obj_cmd_rq[i]) < 0)
+        {
+          API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[i]);
+          return (-1);
+        }
+    }
+
+  if (_poll_cmd_pending (ctx))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DRIVER_BUSY);
+      return (-1);
+    }
+
+  ctx->target.lun = lun;
+  ctx->target.net_fn = net_fn;
+
+  if (api_lan_2_0_cmd_batch (ctx,
+                             obj_cmd_rq,
+                             obj_cmd_rs,
+                             count,
+                             window) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_cmd_poll_submit (ipmi_ctx_t ctx,
+                      uint8_t lun,
+                      uint8_t net_fn,
+                      fiid_obj_t obj_cmd_rq,
+                      fiid_obj_t obj_cmd_rs,
+                      Ipmi_Cmd_Poll_Callback callback,
+                      void *callback_data)
+{
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (ctx->type == IPMI_DEVICE_UNKNOWN)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DEVICE_NOT_OPEN);
+      return (-1);
+    }
+
+  if ((ctx->type != IPMI_DEVICE_LAN
+       && ctx->type != IPMI_DEVICE_LAN_2_0)
+      || (ctx->target.channel_number_is_set
+          && ctx->target.rs_addr_is_set))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_COMMAND_INVALID_FOR_SELECTED_INTERFACE);
+      return (-1);
+    }
+
+  if (!IPMI_BMC_LUN_VALID (lun)
+      || !IPMI_NET_FN_VALID (net_fn)
+      || !fiid_obj_valid (obj_cmd_rq)
+      || !fiid_obj_valid (obj_cmd_rs)
+      || !callback)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (FIID_OBJ_PACKET_VALID (obj_cmd_rq) < 0)
+    {
+      API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+      return (-1);
+    }
+
+  if (_poll_cmd_pending (ctx))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DRIVER_BUSY);
+      return (-1);
+    }
+
+  ctx->target.lun = lun;
+  ctx->target.net_fn = net_fn;
+
+  if (api_lan_cmd_poll_submit (ctx,
+                               obj_cmd_rq,
+                               obj_cmd_rs,
+                               callback,
+                               callback_data) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_ctx_get_fd (ipmi_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (ctx->type == IPMI_DEVICE_UNKNOWN)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_DEVICE_NOT_OPEN);
+      return (-1);
+    }
+
+  if (ctx->type != IPMI_DEVICE_LAN
+      && ctx->type != IPMI_DEVICE_LAN_2_0)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_COMMAND_INVALID_FOR_SELECTED_INTERFACE);
+      return (-1);
+    }
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (ctx->io.outofband.sockfd);
+}
+
+int
+ipmi_cmd_poll_timeout (ipmi_ctx_t ctx, unsigned int *timeout)
+{
+  int rv;
+
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!timeout)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!_poll_cmd_pending (ctx))
+    {
+      ctx->errnum = IPMI_ERR_SUCCESS;
+      return (0);
+    }
+
+  if ((rv = api_lan_cmd_poll_timeout (ctx, timeout)) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (rv);
+}
+
+int
+ipmi_cmd_poll_process (ipmi_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!_poll_cmd_pending (ctx))
+    {
+      ctx->errnum = IPMI_ERR_SUCCESS;
+      return (0);
+    }
+
+  /* errnum set in api_lan_cmd_poll_process() and passed to the callback */
+  return (api_lan_cmd_poll_process (ctx));
+}
+
+int
+ipmi_cmd_poll_cancel (ipmi_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (_poll_cmd_pending (ctx))
+    api_lan_cmd_poll_cancel (ctx);
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
 static void
 _ipmi_outofband_close (ipmi_ctx_t ctx)
 {
@@ -2256,6 +2536,10 @@ ipmi_ctx_close (ipmi_ctx_t ctx)
   ctx->target.channel_number_is_set = 0;
   ctx->target.rs_addr_is_set = 0;
 
+  /* outstanding polled command is dropped, no callback */
+  if (_poll_cmd_pending (ctx))
+    api_lan_cmd_poll_cancel (ctx);
+
   if (ctx->type == IPMI_DEVICE_LAN)
     _ipmi_outofband_close (ctx);
   else if (ctx->type == IPMI_DEVICE_LAN_2_0)
@@ -291,6 +291,53 @@ api_lan_2_0_cmd (ipmi_ctx_t ctx,
                                    obj_cmd_rs));
 }
 
+int
+api_lan_2_0_cmd_batch (ipmi_ctx_t ctx,
+                       fiid_obj_t *obj_cmd_rq,
+                       fiid_obj_t *obj_cmd_rs,
+                       unsigned int count,
+                       unsigned int window)
+{
+  uint8_t payload_authenticated;
+  uint8_t payload_encrypted;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && obj_cmd_rq
+          && obj_cmd_rs
+          && count
+          && window
+          && window <= IPMI_CMD_BATCH_WINDOW_MAX);
+
+  api_lan_2_0_cmd_get_session_parameters (ctx,
+                                          &payload_authenticated,
+                                          &payload_encrypted);
+
+  return (api_lan_2_0_cmd_wrapper_batch (ctx,
+                                         ctx->target.lun,
+                                         ctx->target.net_fn,
+                                         payload_authenticated,
+                                         payload_encrypted,
+                                         &(ctx->io.outofband.session_sequence_number),
+                                         ctx->io.outofband.managed_system_session_id,
+                                         &(ctx->io.outofband.rq_seq),
+                                         ctx->io.outofband.authentication_algorithm,
+                                         ctx->io.outofband.integrity_algorithm,
+                                         ctx->io.outofband.confidentiality_algorithm,
+                                         ctx->io.outofband.integrity_key_ptr,
+                                         ctx->io.outofband.integrity_key_len,
+                                         ctx->io.outofband.confidentiality_key_ptr,
+                                         ctx->io.outofband.confidentiality_key_len,
+                                         strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL,
+                                         strlen (ctx->io.outofband.password),
+                                         obj_cmd_rq,
+                                         obj_cmd_rs,
+                                         count,
+                                         window));
+}
+
 int
 api_lan_2_0_cmd_ipmb (ipmi_ctx_t ctx,
                       fiid_obj_t obj_cmd_rq,
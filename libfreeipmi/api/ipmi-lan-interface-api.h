@@ -51,6 +51,12 @@ int api_lan_2_0_cmd_ipmb (ipmi_ctx_t ctx,
                           fiid_obj_t obj_cmd_rq,
                           fiid_obj_t obj_cmd_rs);
 
+int api_lan_2_0_cmd_batch (ipmi_ctx_t ctx,
+                           fiid_obj_t *obj_cmd_rq,
+                           fiid_obj_t *obj_cmd_rs,
+                           unsigned int count,
+                           unsigned int window);
+
 int api_lan_2_0_cmd_raw (ipmi_ctx_t ctx,
                          const void *buf_rq,
                          unsigned int buf_rq_len,
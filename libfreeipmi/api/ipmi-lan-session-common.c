@@ -157,6 +157,43 @@ _session_timed_out (ipmi_ctx_t ctx)
   return (timercmp (&current, &session_timeout, >));
 }
 
+/* _retransmission_timeout
+ * - Retransmission timeout in milliseconds, from the measured round
+ *   trip time to the BMC.
+ */
+static unsigned int
+_retransmission_timeout (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0));
+
+  return (rtt_retransmission_timeout (&ctx->io.outofband.rtt,
+                                      ctx->io.outofband.retransmission_timeout));
+}
+
+/* _rtt_sample
+ * - Update the round trip time estimate after a response was
+ *   received.  Per Karn's algorithm, responses to retransmitted
+ *   requests are not used, it is unknown which request they answer.
+ */
+static void
+_rtt_sample (ipmi_ctx_t ctx, unsigned int retransmission_count)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0));
+
+  if (retransmission_count)
+    return;
+
+  rtt_sample (&ctx->io.outofband.rtt,
+              &ctx->io.outofband.last_send,
+              &ctx->io.outofband.last_received);
+}
+
 /* return 1 on continue, 0 if timeout already happened, -1 on error */
 static int
 _calculate_timeout (ipmi_ctx_t ctx,
@@ -173,6 +210,7 @@ _calculate_timeout (ipmi_ctx_t ctx,
   struct timeval retransmission_timeout_val;
   struct timeval already_timedout_check;
   unsigned int retransmission_timeout_multiplier;
+  unsigned int retransmission_timeout_ms;
 
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
@@ -194,9 +232,10 @@ _calculate_timeout (ipmi_ctx_t ctx,
   timersub (&session_timeout, recv_starttime, &session_timeout_val);
 
   retransmission_timeout_multiplier = (retransmission_count / IPMI_LAN_BACKOFF_COUNT) + 1;
+  retransmission_timeout_ms = retransmission_timeout_multiplier * _retransmission_timeout (ctx);
 
-  retransmission_timeout_len.tv_sec = (retransmission_timeout_multiplier * ctx->io.outofband.retransmission_timeout) / 1000;
-  retransmission_timeout_len.tv_usec = ((retransmission_timeout_multiplier * ctx->io.outofband.retransmission_timeout) - (retransmission_timeout_len.tv_sec * 1000)) * 1000;
+  retransmission_timeout_len.tv_sec = retransmission_timeout_ms / 1000;
+  retransmission_timeout_len.tv_usec = (retransmission_timeout_ms - (retransmission_timeout_len.tv_sec * 1000)) * 1000;
 
   timeradd (&ctx->io.outofband.last_send, &retransmission_timeout_len, &retransmission_timeout);
   timersub (&retransmission_timeout, recv_starttime, &retransmission_timeout_val);
@@ -1124,6 +1163,8 @@ api_lan_cmd_wrapper (ipmi_ctx_t ctx,
           return (-1);
         }
 
+      _rtt_sample (ctx, retransmission_count);
+
       rv = 0;
       break;
     }
@@ -3128,6 +3169,8 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
           goto cleanup;
         }
 
+      _rtt_sample (ctx, retransmission_count);
+
       rv = 0;
       break;
     }
@@ -3147,75 +3190,321 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
   return (rv);
 }
 
+/* A requester sequence number handed out by
+ * api_lan_2_0_cmd_wrapper_batch().  It is not handed out again until
+ * the send using it has been answered or its retire time, one session
+ * timeout after the send, has passed.  Until then a response carrying
+ * it can only belong to request 'index'.
+ */
+struct _api_lan_batch_rq_seq
+{
+  int used;
+  unsigned int index;
+  struct timeval retire;
+};
+
+/* return 1 and the requester sequence number in l_rq_seq if one is
+ * free, 0 if all are held
+ */
+static int
+_api_lan_batch_rq_seq_get (struct _api_lan_batch_rq_seq *rq_seqs,
+                           uint8_t rq_seq,
+                           struct timeval *current,
+                           uint8_t *l_rq_seq)
+{
+  unsigned int i;
+
+  assert (rq_seqs
+          && rq_seq <= IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX
+          && current
+          && l_rq_seq);
+
+  for (i = 0; i <= IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX; i++)
+    {
+      uint8_t tmp_rq_seq = (rq_seq + i) % (IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
+
+      if (!rq_seqs[tmp_rq_seq].used
+          || timercmp (current, &rq_seqs[tmp_rq_seq].retire, >=))
+        {
+          rq_seqs[tmp_rq_seq].used = 0;
+          *l_rq_seq = tmp_rq_seq;
+          return (1);
+        }
+    }
+
+  return (0);
+}
+
+/* return receive length on success, 0 on no packet before deadline,
+ * -1 on error
+ */
+static int
+_api_lan_batch_recv (ipmi_ctx_t ctx,
+                     void *pkt,
+                     unsigned int pkt_len,
+                     struct timeval *deadline)
+{
+  struct pollfd pfd_read;
+  struct timeval current;
+  struct timeval timeout;
+  int timeout_ms = 0;
+  int recv_len;
+  int status;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->io.outofband.sockfd
+          && pkt
+          && pkt_len
+          && deadline);
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (timercmp (deadline, &current, >))
+    {
+      timersub (deadline, &current, &timeout);
+      timeout_ms = timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000;
+    }
+
+  pfd_read.fd = ctx->io.outofband.sockfd;
+  pfd_read.events = POLLIN;
+  pfd_read.revents = 0;
+
+  if ((status = poll (&pfd_read, 1, timeout_ms)) < 0)
+    {
+      if (errno == EINTR)
+        return (0);
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (!status)
+    return (0);
+
+  do
+    {
+      recv_len = ipmi_lan_recvfrom (ctx->io.outofband.sockfd,
+                                    pkt,
+                                    pkt_len,
+                                    0,
+                                    NULL,
+                                    NULL);
+    } while (recv_len < 0 && errno == EINTR);
+
+  /* See _api_lan_2_0_cmd_recv() on ECONNREFUSED and ECONNRESET */
+  if (recv_len < 0
+      && (errno == ECONNRESET
+          || errno == ECONNREFUSED))
+    return (0);
+
+  if (recv_len < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  return (recv_len);
+}
+
 int
-api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
-                              fiid_obj_t obj_cmd_rq,
-                              fiid_obj_t obj_cmd_rs)
+api_lan_2_0_cmd_wrapper_batch (ipmi_ctx_t ctx,
+                               uint8_t lun,
+                               uint8_t net_fn,
+                               uint8_t payload_authenticated,
+                               uint8_t payload_encrypted,
+                               uint32_t *session_sequence_number,
+                               uint32_t session_id,
+                               uint8_t *rq_seq,
+                               uint8_t authentication_algorithm,
+                               uint8_t integrity_algorithm,
+                               uint8_t confidentiality_algorithm,
+                               const void *integrity_key,
+                               unsigned int integrity_key_len,
+                               const void *confidentiality_key,
+                               unsigned int confidentiality_key_len,
+                               const char *password,
+                               unsigned int password_len,
+                               fiid_obj_t *obj_cmd_rq,
+                               fiid_obj_t *obj_cmd_rs,
+                               unsigned int count,
+                               unsigned int window)
 {
   int recv_len, ret, rv = -1;
-  unsigned int retransmission_count = 0;
   uint8_t pkt[IPMI_MAX_PKT_LEN];
-  uint8_t cmd = 0;             /* used for debugging */
-  uint8_t group_extension = 0; /* used for debugging */
-  uint8_t rq_seq_orig;
+  /* per window slot, the request it currently carries */
+  unsigned int slot_index[IPMI_CMD_BATCH_WINDOW_MAX];
+  uint8_t slot_cmd[IPMI_CMD_BATCH_WINDOW_MAX];             /* used for debugging */
+  uint8_t slot_group_extension[IPMI_CMD_BATCH_WINDOW_MAX]; /* used for debugging */
+  int slot_used[IPMI_CMD_BATCH_WINDOW_MAX];
+  int slot_send[IPMI_CMD_BATCH_WINDOW_MAX];
+  struct timeval slot_deadline[IPMI_CMD_BATCH_WINDOW_MAX];
+  unsigned int slot_retransmission_count[IPMI_CMD_BATCH_WINDOW_MAX];
+  struct _api_lan_batch_rq_seq rq_seqs[IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1];
+  struct timeval session_timeout_len;
+  struct timeval current;
+  struct timeval deadline;
+  unsigned int next = 0;
+  unsigned int completed = 0;
+  unsigned int first, i, j;
+  uint8_t l_rq_seq;
   uint64_t val;
   unsigned int intf_flags = IPMI_INTERFACE_FLAGS_DEFAULT;
-  fiid_obj_t obj_send_rs = NULL;
-  ipmi_errnum_type_t obj_rs_errnum;
 
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0
           && ctx->io.outofband.sockfd
-          && fiid_obj_valid (obj_cmd_rq)
-          && fiid_obj_packet_valid (obj_cmd_rq) == 1
-          && fiid_obj_valid (obj_cmd_rs));
+          && IPMI_BMC_LUN_VALID (lun)
+          && IPMI_NET_FN_VALID (net_fn)
+          && IPMI_PAYLOAD_AUTHENTICATED_FLAG_VALID (payload_authenticated)
+          && IPMI_PAYLOAD_ENCRYPTED_FLAG_VALID (payload_encrypted)
+          && session_sequence_number
+          && rq_seq
+          && IPMI_AUTHENTICATION_ALGORITHM_SUPPORTED (authentication_algorithm)
+          && IPMI_INTEGRITY_ALGORITHM_SUPPORTED (integrity_algorithm)
+          && IPMI_CONFIDENTIALITY_ALGORITHM_SUPPORTED (confidentiality_algorithm)
+          && !(password && password_len > IPMI_2_0_MAX_PASSWORD_LENGTH)
+          && obj_cmd_rq
+          && obj_cmd_rs
+          && count
+          && window
+          && window <= IPMI_CMD_BATCH_WINDOW_MAX);
 
   if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
     intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
 
-  if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+  if (!ctx->io.outofband.last_received.tv_sec
+      && !ctx->io.outofband.last_received.tv_usec)
     {
-      /* ignore error, continue on */
-      if (FIID_OBJ_GET (obj_cmd_rq,
-                        "cmd",
-                        &val) < 0)
-        API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
-      else
-        cmd = val;
-
-      if (IPMI_NET_FN_GROUP_EXTENSION (ctx->target.net_fn))
+      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
         {
-          /* ignore error, continue on */
-          if (FIID_OBJ_GET (obj_cmd_rq,
-                            "group_extension_identification",
-                            &val) < 0)
-            API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
-          else
-            group_extension = val;
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
         }
     }
 
-  /* for debugging */
-  ctx->tmpl_ipmb_cmd_rq = fiid_obj_template (obj_cmd_rq);
-  ctx->tmpl_ipmb_cmd_rs = fiid_obj_template (obj_cmd_rs);
-
-  /* ipmb response packet will use the request sequence number from
-   * the earlier packet.  Save it for verification.
-   */
+  session_timeout_len.tv_sec = ctx->io.outofband.session_timeout / 1000;
+  session_timeout_len.tv_usec = (ctx->io.outofband.session_timeout % 1000) * 1000;
 
-  rq_seq_orig = ctx->io.outofband.rq_seq;
+  for (i = 0; i < window; i++)
+    {
+      slot_used[i] = 0;
+      slot_send[i] = 0;
+    }
 
-  if (_ipmi_cmd_send_ipmb (ctx,
-                           obj_cmd_rq,
-                           &obj_send_rs,
-                           &obj_rs_errnum) < 0)
-    goto cleanup;
+  for (i = 0; i <= IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX; i++)
+    rq_seqs[i].used = 0;
 
   while (1)
     {
-      uint8_t payload_authenticated;
-      uint8_t payload_encrypted;
+      /* Refill the window with the next requests as responses
+       * arrive, so up to 'window' requests are always in flight.
+       */
+      for (i = 0; i < window && next < count; i++)
+        {
+          if (slot_used[i])
+            continue;
+
+          assert (fiid_obj_valid (obj_cmd_rq[next])
+                  && fiid_obj_packet_valid (obj_cmd_rq[next]) == 1
+                  && fiid_obj_valid (obj_cmd_rs[next]));
+
+          slot_index[i] = next++;
+          slot_cmd[i] = 0;
+          slot_group_extension[i] = 0;
+          slot_used[i] = 1;
+          slot_send[i] = 1;
+          slot_retransmission_count[i] = 0;
+
+          if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+            {
+              /* ignore error, continue on */
+              if (FIID_OBJ_GET (obj_cmd_rq[slot_index[i]],
+                                "cmd",
+                                &val) < 0)
+                API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[slot_index[i]]);
+              else
+                slot_cmd[i] = val;
+
+              if (IPMI_NET_FN_GROUP_EXTENSION (net_fn))
+                {
+                  /* ignore error, continue on */
+                  if (FIID_OBJ_GET (obj_cmd_rq[slot_index[i]],
+                                    "group_extension_identification",
+                                    &val) < 0)
+                    API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[slot_index[i]]);
+                  else
+                    slot_group_extension[i] = val;
+                }
+            }
+        }
+
+      if (gettimeofday (&current, NULL) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      /* Each (re)transmission gets its own session sequence number
+       * and requester sequence number.  A requester sequence number
+       * is not reused while an earlier send with it may still be
+       * answered, if none is free the slot waits.
+       */
+      for (i = 0; i < window; i++)
+        {
+          struct timeval retransmission_timeout_len;
+          unsigned int retransmission_timeout_ms;
+
+          if (!slot_send[i])
+            continue;
+
+          if (!_api_lan_batch_rq_seq_get (rq_seqs, *rq_seq, &current, &l_rq_seq))
+            break;
+
+          if (_api_lan_2_0_cmd_send (ctx,
+                                     lun,
+                                     net_fn,
+                                     IPMI_PAYLOAD_TYPE_IPMI,
+                                     payload_authenticated,
+                                     payload_encrypted,
+                                     *session_sequence_number,
+                                     session_id,
+                                     l_rq_seq,
+                                     authentication_algorithm,
+                                     integrity_algorithm,
+                                     confidentiality_algorithm,
+                                     integrity_key,
+                                     integrity_key_len,
+                                     confidentiality_key,
+                                     confidentiality_key_len,
+                                     password,
+                                     password_len,
+                                     slot_cmd[i], /* for debug dumping */
+                                     slot_group_extension[i], /* for debug dumping */
+                                     obj_cmd_rq[slot_index[i]]) < 0)
+            goto cleanup;
+
+          /* In IPMI 2.0, session sequence numbers of 0 are special */
+          (*session_sequence_number)++;
+          if (!(*session_sequence_number))
+            (*session_sequence_number)++;
+          *rq_seq = (l_rq_seq + 1) % (IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
+
+          rq_seqs[l_rq_seq].used = 1;
+          rq_seqs[l_rq_seq].index = slot_index[i];
+          timeradd (&ctx->io.outofband.last_send, &session_timeout_len, &rq_seqs[l_rq_seq].retire);
+
+          retransmission_timeout_ms = ((slot_retransmission_count[i] / IPMI_LAN_BACKOFF_COUNT) + 1) * _retransmission_timeout (ctx);
+          retransmission_timeout_len.tv_sec = retransmission_timeout_ms / 1000;
+          retransmission_timeout_len.tv_usec = (retransmission_timeout_ms % 1000) * 1000;
+          timeradd (&ctx->io.outofband.last_send, &retransmission_timeout_len, &slot_deadline[i]);
+
+          slot_send[i] = 0;
+        }
 
       if ((ret = _session_timed_out (ctx)) < 0)
         break;
@@ -3226,56 +3515,353 @@ api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
           break;
         }
 
-      /* its ok to use the "request" net_fn, dump code doesn't care */
-      if ((recv_len = _api_lan_2_0_cmd_recv (ctx,
-                                             ctx->io.outofband.authentication_algorithm,
-                                             ctx->io.outofband.integrity_algorithm,
-                                             ctx->io.outofband.confidentiality_algorithm,
-                                             ctx->io.outofband.integrity_key_ptr,
-                                             ctx->io.outofband.integrity_key_len,
-                                             ctx->io.outofband.confidentiality_key_ptr,
-                                             ctx->io.outofband.confidentiality_key_len,
-                                             pkt,
-                                             IPMI_MAX_PKT_LEN,
-                                             retransmission_count)) < 0)
-        {
-          rv = -1;
-          break;
-        }
+      /* Wait until the session times out, the earliest retransmission
+       * timeout of a slot passes, or, if a slot is waiting for a
+       * requester sequence number, the earliest one retires.
+       */
+      timeradd (&ctx->io.outofband.last_received, &session_timeout_len, &deadline);
 
-      if (!recv_len)
+      for (i = 0; i < window; i++)
         {
-          retransmission_count++;
-
-          /* don't increment sequence numbers, will be done in _ipmi_cmd_send_ipmb */
+          if (!slot_used[i])
+            continue;
 
-          /* ipmb response packet will use the request sequence number from
-           * the earlier packet.  Save it for verification.
-           */
+          if (slot_send[i])
+            {
+              for (j = 0; j <= IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX; j++)
+                {
+                  if (rq_seqs[j].used
+                      && timercmp (&rq_seqs[j].retire, &deadline, <))
+                    deadline = rq_seqs[j].retire;
+                }
+            }
+          else if (ctx->io.outofband.retransmission_timeout
+                   && timercmp (&slot_deadline[i], &deadline, <))
+            deadline = slot_deadline[i];
+        }
 
-          rq_seq_orig = ctx->io.outofband.rq_seq;
+      if ((recv_len = _api_lan_batch_recv (ctx,
+                                           pkt,
+                                           IPMI_MAX_PKT_LEN,
+                                           &deadline)) < 0)
+        break;
 
-          if (obj_send_rs) {
-            fiid_obj_destroy (obj_send_rs);
-            obj_send_rs = NULL;
-          }
+      if (!recv_len)
+        goto retransmit;
 
-          if (_ipmi_cmd_send_ipmb (ctx,
-                                   obj_cmd_rq,
-                                   &obj_send_rs,
-                                   &obj_rs_errnum) < 0)
-            goto cleanup;
+      /* else received a packet */
 
-          continue;
+      for (first = 0; first < window; first++)
+        {
+          if (slot_used[first])
+            break;
         }
+      assert (first < window);
 
-      /* else received a packet */
+      /* unassemble into the first outstanding response to learn the
+       * requester sequence number, then again into the response it
+       * actually belongs to if different.
+       */
+      j = first;
+      while (1)
+        {
+          if ((ret = unassemble_ipmi_rmcpplus_pkt (authentication_algorithm,
+                                                   integrity_algorithm,
+                                                   confidentiality_algorithm,
+                                                   integrity_key,
+                                                   integrity_key_len,
+                                                   confidentiality_key,
+                                                   confidentiality_key_len,
+                                                   pkt,
+                                                   recv_len,
+                                                   ctx->io.outofband.rs.obj_rmcp_hdr,
+                                                   ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                                   ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                                   ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                                   obj_cmd_rs[slot_index[j]],
+                                                   ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                                   ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                                   intf_flags)) < 0)
+            {
+              API_ERRNO_TO_API_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
 
-      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
-        _api_lan_2_0_dump_rs (ctx,
-                              ctx->io.outofband.authentication_algorithm,
-                              ctx->io.outofband.integrity_algorithm,
-                              ctx->io.outofband.confidentiality_algorithm,
+          if (!ret || j != first)
+            break;
+
+          if (FIID_OBJ_GET (ctx->io.outofband.rs.obj_lan_msg_hdr,
+                            "rq_seq",
+                            &val) < 0)
+            {
+              API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, ctx->io.outofband.rs.obj_lan_msg_hdr);
+              goto cleanup;
+            }
+          l_rq_seq = val;
+
+          /* unknown response */
+          if (l_rq_seq > IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX
+              || !rq_seqs[l_rq_seq].used)
+            {
+              ret = 0;
+              break;
+            }
+
+          for (j = first; j < window; j++)
+            {
+              if (slot_used[j] && slot_index[j] == rq_seqs[l_rq_seq].index)
+                break;
+            }
+
+          /* Stale response to a retransmitted request that has
+           * already been answered.  Once verified, its requester
+           * sequence number may be reused.
+           */
+          if (j == window)
+            {
+              if ((ret = _api_lan_2_0_cmd_wrapper_verify_packet (ctx,
+                                                                 IPMI_PAYLOAD_TYPE_IPMI,
+                                                                 NULL,
+                                                                 session_sequence_number,
+                                                                 session_id,
+                                                                 &l_rq_seq,
+                                                                 integrity_algorithm,
+                                                                 integrity_key,
+                                                                 integrity_key_len,
+                                                                 password,
+                                                                 password_len,
+                                                                 obj_cmd_rs[slot_index[first]],
+                                                                 pkt,
+                                                                 recv_len)) < 0)
+                goto cleanup;
+
+              if (ret)
+                rq_seqs[l_rq_seq].used = 0;
+
+              ret = 0;
+              break;
+            }
+
+          if (j == first)
+            break;
+        }
+
+      if (!ret)
+        goto retransmit;
+
+      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+        _api_lan_2_0_dump_rs (ctx,
+                              authentication_algorithm,
+                              integrity_algorithm,
+                              confidentiality_algorithm,
+                              integrity_key,
+                              integrity_key_len,
+                              confidentiality_key,
+                              confidentiality_key_len,
+                              pkt,
+                              recv_len,
+                              slot_cmd[j],
+                              net_fn,
+                              slot_group_extension[j],
+                              obj_cmd_rs[slot_index[j]]);
+
+      if ((ret = _api_lan_2_0_cmd_wrapper_verify_packet (ctx,
+                                                         IPMI_PAYLOAD_TYPE_IPMI,
+                                                         NULL,
+                                                         session_sequence_number,
+                                                         session_id,
+                                                         &l_rq_seq,
+                                                         integrity_algorithm,
+                                                         integrity_key,
+                                                         integrity_key_len,
+                                                         password,
+                                                         password_len,
+                                                         obj_cmd_rs[slot_index[j]],
+                                                         pkt,
+                                                         recv_len)) < 0)
+        goto cleanup;
+
+      if (!ret)
+        goto retransmit;
+
+      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      /* The send carrying l_rq_seq has been answered, it may be
+       * reused.  Other sends for the same request keep theirs until
+       * they retire, their responses may still arrive.
+       */
+      rq_seqs[l_rq_seq].used = 0;
+      slot_used[j] = 0;
+      slot_send[j] = 0;
+      if (++completed == count)
+        {
+          rv = 0;
+          break;
+        }
+
+    retransmit:
+      /* Retransmit only the requests whose own retransmission
+       * timeout has passed.
+       */
+      if (!ctx->io.outofband.retransmission_timeout)
+        continue;
+
+      if (gettimeofday (&current, NULL) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      for (i = 0; i < window; i++)
+        {
+          if (!slot_used[i] || slot_send[i])
+            continue;
+
+          if (timercmp (&current, &slot_deadline[i], >=))
+            {
+              slot_send[i] = 1;
+              slot_retransmission_count[i]++;
+            }
+        }
+    }
+
+ cleanup:
+  return (rv);
+}
+
+int
+api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
+                              fiid_obj_t obj_cmd_rq,
+                              fiid_obj_t obj_cmd_rs)
+{
+  int recv_len, ret, rv = -1;
+  unsigned int retransmission_count = 0;
+  uint8_t pkt[IPMI_MAX_PKT_LEN];
+  uint8_t cmd = 0;             /* used for debugging */
+  uint8_t group_extension = 0; /* used for debugging */
+  uint8_t rq_seq_orig;
+  uint64_t val;
+  unsigned int intf_flags = IPMI_INTERFACE_FLAGS_DEFAULT;
+  fiid_obj_t obj_send_rs = NULL;
+  ipmi_errnum_type_t obj_rs_errnum;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_packet_valid (obj_cmd_rq) == 1
+          && fiid_obj_valid (obj_cmd_rs));
+
+  if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
+    intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
+
+  if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+    {
+      /* ignore error, continue on */
+      if (FIID_OBJ_GET (obj_cmd_rq,
+                        "cmd",
+                        &val) < 0)
+        API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+      else
+        cmd = val;
+
+      if (IPMI_NET_FN_GROUP_EXTENSION (ctx->target.net_fn))
+        {
+          /* ignore error, continue on */
+          if (FIID_OBJ_GET (obj_cmd_rq,
+                            "group_extension_identification",
+                            &val) < 0)
+            API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+          else
+            group_extension = val;
+        }
+    }
+
+  /* for debugging */
+  ctx->tmpl_ipmb_cmd_rq = fiid_obj_template (obj_cmd_rq);
+  ctx->tmpl_ipmb_cmd_rs = fiid_obj_template (obj_cmd_rs);
+
+  /* ipmb response packet will use the request sequence number from
+   * the earlier packet.  Save it for verification.
+   */
+
+  rq_seq_orig = ctx->io.outofband.rq_seq;
+
+  if (_ipmi_cmd_send_ipmb (ctx,
+                           obj_cmd_rq,
+                           &obj_send_rs,
+                           &obj_rs_errnum) < 0)
+    goto cleanup;
+
+  while (1)
+    {
+      uint8_t payload_authenticated;
+      uint8_t payload_encrypted;
+
+      if ((ret = _session_timed_out (ctx)) < 0)
+        break;
+
+      if (ret)
+        {
+          API_SET_ERRNUM (ctx, IPMI_ERR_SESSION_TIMEOUT);
+          break;
+        }
+
+      /* its ok to use the "request" net_fn, dump code doesn't care */
+      if ((recv_len = _api_lan_2_0_cmd_recv (ctx,
+                                             ctx->io.outofband.authentication_algorithm,
+                                             ctx->io.outofband.integrity_algorithm,
+                                             ctx->io.outofband.confidentiality_algorithm,
+                                             ctx->io.outofband.integrity_key_ptr,
+                                             ctx->io.outofband.integrity_key_len,
+                                             ctx->io.outofband.confidentiality_key_ptr,
+                                             ctx->io.outofband.confidentiality_key_len,
+                                             pkt,
+                                             IPMI_MAX_PKT_LEN,
+                                             retransmission_count)) < 0)
+        {
+          rv = -1;
+          break;
+        }
+
+      if (!recv_len)
+        {
+          retransmission_count++;
+
+          /* don't increment sequence numbers, will be done in _ipmi_cmd_send_ipmb */
+
+          /* ipmb response packet will use the request sequence number from
+           * the earlier packet.  Save it for verification.
+           */
+
+          rq_seq_orig = ctx->io.outofband.rq_seq;
+
+          if (obj_send_rs) {
+            fiid_obj_destroy (obj_send_rs);
+            obj_send_rs = NULL;
+          }
+
+          if (_ipmi_cmd_send_ipmb (ctx,
+                                   obj_cmd_rq,
+                                   &obj_send_rs,
+                                   &obj_rs_errnum) < 0)
+            goto cleanup;
+
+          continue;
+        }
+
+      /* else received a packet */
+
+      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+        _api_lan_2_0_dump_rs (ctx,
+                              ctx->io.outofband.authentication_algorithm,
+                              ctx->io.outofband.integrity_algorithm,
+                              ctx->io.outofband.confidentiality_algorithm,
                               ctx->io.outofband.integrity_key_ptr,
                               ctx->io.outofband.integrity_key_len,
                               ctx->io.outofband.confidentiality_key_ptr,
@@ -4377,3 +4963,584 @@ api_lan_2_0_close_session (ipmi_ctx_t ctx)
   fiid_obj_destroy (obj_cmd_rs);
   return (rv);
 }
+
+/* Single outstanding command polling
+ *
+ * The request submitted by api_lan_cmd_poll_submit() is kept in
+ * ctx->io.outofband.poll.  Session and requester sequence numbers
+ * are handled as in api_lan_cmd_wrapper() and
+ * api_lan_2_0_cmd_wrapper(), they are incremented on every
+ * retransmission and once the command completes.
+ */
+
+static void
+_api_lan_poll_sequence_numbers_increment (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0));
+
+  if (ctx->type == IPMI_DEVICE_LAN)
+    {
+      if (!(ctx->flags & IPMI_FLAGS_NOSESSION))
+        ctx->io.outofband.session_sequence_number++;
+    }
+  else
+    {
+      /* In IPMI 2.0, session sequence numbers of 0 are special */
+      ctx->io.outofband.session_sequence_number++;
+      if (!ctx->io.outofband.session_sequence_number)
+        ctx->io.outofband.session_sequence_number++;
+    }
+
+  ctx->io.outofband.rq_seq = (ctx->io.outofband.rq_seq + 1) % (IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
+}
+
+static int
+_api_lan_poll_send (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.poll.pending);
+
+  if (ctx->type == IPMI_DEVICE_LAN)
+    {
+      uint8_t authentication_type;
+      unsigned int internal_workaround_flags = 0;
+
+      api_lan_cmd_get_session_parameters (ctx,
+                                          &authentication_type,
+                                          &internal_workaround_flags);
+
+      if (ctx->flags & IPMI_FLAGS_NOSESSION)
+        return (_api_lan_cmd_send (ctx,
+                                   ctx->target.lun,
+                                   ctx->target.net_fn,
+                                   IPMI_AUTHENTICATION_TYPE_NONE,
+                                   0,
+                                   0,
+                                   ctx->io.outofband.rq_seq,
+                                   NULL,
+                                   0,
+                                   ctx->io.outofband.poll.cmd, /* for debug dumping */
+                                   ctx->io.outofband.poll.group_extension, /* for debug dumping */
+                                   ctx->io.outofband.poll.obj_cmd_rq));
+
+      return (_api_lan_cmd_send (ctx,
+                                 ctx->target.lun,
+                                 ctx->target.net_fn,
+                                 authentication_type,
+                                 ctx->io.outofband.session_sequence_number,
+                                 ctx->io.outofband.session_id,
+                                 ctx->io.outofband.rq_seq,
+                                 ctx->io.outofband.password,
+                                 IPMI_1_5_MAX_PASSWORD_LENGTH,
+                                 ctx->io.outofband.poll.cmd, /* for debug dumping */
+                                 ctx->io.outofband.poll.group_extension, /* for debug dumping */
+                                 ctx->io.outofband.poll.obj_cmd_rq));
+    }
+  else
+    {
+      uint8_t payload_authenticated;
+      uint8_t payload_encrypted;
+
+      api_lan_2_0_cmd_get_session_parameters (ctx,
+                                              &payload_authenticated,
+                                              &payload_encrypted);
+
+      return (_api_lan_2_0_cmd_send (ctx,
+                                     ctx->target.lun,
+                                     ctx->target.net_fn,
+                                     IPMI_PAYLOAD_TYPE_IPMI,
+                                     payload_authenticated,
+                                     payload_encrypted,
+                                     ctx->io.outofband.session_sequence_number,
+                                     ctx->io.outofband.managed_system_session_id,
+                                     ctx->io.outofband.rq_seq,
+                                     ctx->io.outofband.authentication_algorithm,
+                                     ctx->io.outofband.integrity_algorithm,
+                                     ctx->io.outofband.confidentiality_algorithm,
+                                     ctx->io.outofband.integrity_key_ptr,
+                                     ctx->io.outofband.integrity_key_len,
+                                     ctx->io.outofband.confidentiality_key_ptr,
+                                     ctx->io.outofband.confidentiality_key_len,
+                                     strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL,
+                                     strlen (ctx->io.outofband.password),
+                                     ctx->io.outofband.poll.cmd, /* for debug dumping */
+                                     ctx->io.outofband.poll.group_extension, /* for debug dumping */
+                                     ctx->io.outofband.poll.obj_cmd_rq));
+    }
+}
+
+/* return 1 on good packet, 0 on bad packet, -1 on error */
+static int
+_api_lan_poll_recv_packet (ipmi_ctx_t ctx,
+                           const void *pkt,
+                           unsigned int pkt_len)
+{
+  fiid_obj_t obj_cmd_rs;
+  unsigned int intf_flags = IPMI_INTERFACE_FLAGS_DEFAULT;
+  int ret;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.poll.pending
+          && pkt
+          && pkt_len);
+
+  obj_cmd_rs = ctx->io.outofband.poll.obj_cmd_rs;
+
+  if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
+    intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
+
+  if (ctx->type == IPMI_DEVICE_LAN)
+    {
+      uint8_t authentication_type;
+      unsigned int internal_workaround_flags = 0;
+
+      /* its ok to use the "request" net_fn, dump code doesn't care */
+      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+        _api_lan_dump_rs (ctx,
+                          pkt,
+                          pkt_len,
+                          ctx->io.outofband.poll.cmd,
+                          ctx->target.net_fn,
+                          ctx->io.outofband.poll.group_extension,
+                          obj_cmd_rs);
+
+      if ((ret = unassemble_ipmi_lan_pkt (pkt,
+                                          pkt_len,
+                                          ctx->io.outofband.rs.obj_rmcp_hdr,
+                                          ctx->io.outofband.rs.obj_lan_session_hdr,
+                                          ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                          obj_cmd_rs,
+                                          ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                          intf_flags)) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      if (!ret)
+        return (0);
+
+      api_lan_cmd_get_session_parameters (ctx,
+                                          &authentication_type,
+                                          &internal_workaround_flags);
+
+      if (ctx->flags & IPMI_FLAGS_NOSESSION)
+        return (_api_lan_cmd_wrapper_verify_packet (ctx,
+                                                    internal_workaround_flags,
+                                                    IPMI_AUTHENTICATION_TYPE_NONE,
+                                                    0,
+                                                    NULL,
+                                                    0,
+                                                    &(ctx->io.outofband.rq_seq),
+                                                    NULL,
+                                                    0,
+                                                    obj_cmd_rs));
+
+      return (_api_lan_cmd_wrapper_verify_packet (ctx,
+                                                  internal_workaround_flags,
+                                                  authentication_type,
+                                                  1,
+                                                  &(ctx->io.outofband.session_sequence_number),
+                                                  ctx->io.outofband.session_id,
+                                                  &(ctx->io.outofband.rq_seq),
+                                                  ctx->io.outofband.password,
+                                                  IPMI_1_5_MAX_PASSWORD_LENGTH,
+                                                  obj_cmd_rs));
+    }
+
+  if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+    _api_lan_2_0_dump_rs (ctx,
+                          ctx->io.outofband.authentication_algorithm,
+                          ctx->io.outofband.integrity_algorithm,
+                          ctx->io.outofband.confidentiality_algorithm,
+                          ctx->io.outofband.integrity_key_ptr,
+                          ctx->io.outofband.integrity_key_len,
+                          ctx->io.outofband.confidentiality_key_ptr,
+                          ctx->io.outofband.confidentiality_key_len,
+                          pkt,
+                          pkt_len,
+                          ctx->io.outofband.poll.cmd,
+                          ctx->target.net_fn,
+                          ctx->io.outofband.poll.group_extension,
+                          obj_cmd_rs);
+
+  if ((ret = unassemble_ipmi_rmcpplus_pkt (ctx->io.outofband.authentication_algorithm,
+                                           ctx->io.outofband.integrity_algorithm,
+                                           ctx->io.outofband.confidentiality_algorithm,
+                                           ctx->io.outofband.integrity_key_ptr,
+                                           ctx->io.outofband.integrity_key_len,
+                                           ctx->io.outofband.confidentiality_key_ptr,
+                                           ctx->io.outofband.confidentiality_key_len,
+                                           pkt,
+                                           pkt_len,
+                                           ctx->io.outofband.rs.obj_rmcp_hdr,
+                                           ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                           ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                           ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                           obj_cmd_rs,
+                                           ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                           ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                           intf_flags)) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (!ret)
+    return (0);
+
+  return (_api_lan_2_0_cmd_wrapper_verify_packet (ctx,
+                                                  IPMI_PAYLOAD_TYPE_IPMI,
+                                                  NULL,
+                                                  &(ctx->io.outofband.session_sequence_number),
+                                                  ctx->io.outofband.managed_system_session_id,
+                                                  &(ctx->io.outofband.rq_seq),
+                                                  ctx->io.outofband.integrity_algorithm,
+                                                  ctx->io.outofband.integrity_key_ptr,
+                                                  ctx->io.outofband.integrity_key_len,
+                                                  strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL,
+                                                  strlen (ctx->io.outofband.password),
+                                                  obj_cmd_rs,
+                                                  pkt,
+                                                  pkt_len));
+}
+
+/* Completes the outstanding command, the callback may submit the
+ * next one.
+ */
+static void
+_api_lan_poll_complete (ipmi_ctx_t ctx, int errnum)
+{
+  Ipmi_Cmd_Poll_Callback callback;
+  void *callback_data;
+  fiid_obj_t obj_cmd_rs;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.poll.pending);
+
+  callback = ctx->io.outofband.poll.callback;
+  callback_data = ctx->io.outofband.poll.callback_data;
+  obj_cmd_rs = ctx->io.outofband.poll.obj_cmd_rs;
+
+  _api_lan_poll_sequence_numbers_increment (ctx);
+  memset (&(ctx->io.outofband.poll), '\0', sizeof (ctx->io.outofband.poll));
+
+  if (errnum == IPMI_ERR_SUCCESS)
+    ctx->errnum = IPMI_ERR_SUCCESS;
+  else
+    API_SET_ERRNUM (ctx, errnum);
+
+  callback (ctx, errnum, obj_cmd_rs, callback_data);
+}
+
+/* Returns absolute time the outstanding command must be processed
+ * by, either to retransmit it or because the session timed out.
+ */
+static void
+_api_lan_poll_deadline (ipmi_ctx_t ctx, struct timeval *deadline)
+{
+  struct timeval session_timeout;
+  struct timeval session_timeout_len;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.poll.pending
+          && deadline);
+
+  session_timeout_len.tv_sec = ctx->io.outofband.session_timeout / 1000;
+  session_timeout_len.tv_usec = (ctx->io.outofband.session_timeout - (session_timeout_len.tv_sec * 1000)) * 1000;
+  timeradd (&(ctx->io.outofband.last_received), &session_timeout_len, &session_timeout);
+
+  if (ctx->io.outofband.retransmission_timeout)
+    {
+      struct timeval retransmission_timeout;
+      struct timeval retransmission_timeout_len;
+      unsigned int retransmission_timeout_multiplier;
+      unsigned int retransmission_timeout_ms;
+
+      retransmission_timeout_multiplier = (ctx->io.outofband.poll.retransmission_count / IPMI_LAN_BACKOFF_COUNT) + 1;
+      retransmission_timeout_ms = retransmission_timeout_multiplier * _retransmission_timeout (ctx);
+
+      retransmission_timeout_len.tv_sec = retransmission_timeout_ms / 1000;
+      retransmission_timeout_len.tv_usec = (retransmission_timeout_ms - (retransmission_timeout_len.tv_sec * 1000)) * 1000;
+      timeradd (&(ctx->io.outofband.last_send), &retransmission_timeout_len, &retransmission_timeout);
+
+      if (timercmp (&retransmission_timeout, &session_timeout, <))
+        {
+          *deadline = retransmission_timeout;
+          return;
+        }
+    }
+
+  *deadline = session_timeout;
+}
+
+int
+api_lan_cmd_poll_submit (ipmi_ctx_t ctx,
+                         fiid_obj_t obj_cmd_rq,
+                         fiid_obj_t obj_cmd_rs,
+                         Ipmi_Cmd_Poll_Callback callback,
+                         void *callback_data)
+{
+  uint64_t val;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.sockfd
+          && !ctx->io.outofband.poll.pending
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_packet_valid (obj_cmd_rq) == 1
+          && fiid_obj_valid (obj_cmd_rs)
+          && callback);
+
+  if (!ctx->io.outofband.last_received.tv_sec
+      && !ctx->io.outofband.last_received.tv_usec)
+    {
+      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  memset (&(ctx->io.outofband.poll), '\0', sizeof (ctx->io.outofband.poll));
+
+  if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+    {
+      /* ignore error, continue on */
+      if (FIID_OBJ_GET (obj_cmd_rq,
+                        "cmd",
+                        &val) < 0)
+        API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+      else
+        ctx->io.outofband.poll.cmd = val;
+
+      if (IPMI_NET_FN_GROUP_EXTENSION (ctx->target.net_fn))
+        {
+          /* ignore error, continue on */
+          if (FIID_OBJ_GET (obj_cmd_rq,
+                            "group_extension_identification",
+                            &val) < 0)
+            API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+          else
+            ctx->io.outofband.poll.group_extension = val;
+        }
+    }
+
+  ctx->io.outofband.poll.obj_cmd_rq = obj_cmd_rq;
+  ctx->io.outofband.poll.obj_cmd_rs = obj_cmd_rs;
+  ctx->io.outofband.poll.callback = callback;
+  ctx->io.outofband.poll.callback_data = callback_data;
+  ctx->io.outofband.poll.pending = 1;
+
+  if (_api_lan_poll_send (ctx) < 0)
+    {
+      _api_lan_poll_sequence_numbers_increment (ctx);
+      memset (&(ctx->io.outofband.poll), '\0', sizeof (ctx->io.outofband.poll));
+      return (-1);
+    }
+
+  return (0);
+}
+
+int
+api_lan_cmd_poll_timeout (ipmi_ctx_t ctx, unsigned int *timeout)
+{
+  struct timeval current;
+  struct timeval deadline;
+  struct timeval delta;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && timeout);
+
+  if (!ctx->io.outofband.poll.pending)
+    return (0);
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  _api_lan_poll_deadline (ctx, &deadline);
+
+  if (timercmp (&current, &deadline, <))
+    {
+      timersub (&deadline, &current, &delta);
+      /* round up, so the caller does not wake up early */
+      (*timeout) = (delta.tv_sec * 1000) + ((delta.tv_usec + 999) / 1000);
+    }
+  else
+    (*timeout) = 0;
+
+  return (1);
+}
+
+int
+api_lan_cmd_poll_process (ipmi_ctx_t ctx)
+{
+  uint8_t pkt[IPMI_MAX_PKT_LEN];
+  struct timeval current;
+  struct timeval deadline;
+  int recv_len, ret;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0)
+          && ctx->io.outofband.sockfd);
+
+  if (!ctx->io.outofband.poll.pending)
+    return (0);
+
+  /* Read everything queued on the socket without blocking, stale
+   * responses to earlier transmissions are discarded.
+   */
+  while (1)
+    {
+      struct pollfd pfd_read;
+
+      pfd_read.fd = ctx->io.outofband.sockfd;
+      pfd_read.events = POLLIN;
+      pfd_read.revents = 0;
+
+      if ((ret = poll (&pfd_read, 1, 0)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          _api_lan_poll_complete (ctx, ctx->errnum);
+          return (1);
+        }
+
+      if (!ret)
+        break;
+
+      /* For receive side, ipmi_lan_recvfrom and
+       * ipmi_rmcpplus_recvfrom are identical.  So we just use
+       * ipmi_lan_recvfrom for both.
+       */
+      do
+        {
+          recv_len = ipmi_lan_recvfrom (ctx->io.outofband.sockfd,
+                                        pkt,
+                                        IPMI_MAX_PKT_LEN,
+                                        0,
+                                        NULL,
+                                        NULL);
+        } while (recv_len < 0 && errno == EINTR);
+
+      /* See _api_lan_cmd_recv() on ECONNRESET and ECONNREFUSED */
+      if (recv_len < 0
+          && (errno == ECONNRESET
+              || errno == ECONNREFUSED))
+        continue;
+
+      if (recv_len < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          _api_lan_poll_complete (ctx, ctx->errnum);
+          return (1);
+        }
+
+      if (!recv_len)
+        continue;
+
+      if ((ret = _api_lan_poll_recv_packet (ctx, pkt, recv_len)) < 0)
+        {
+          _api_lan_poll_complete (ctx, ctx->errnum);
+          return (1);
+        }
+
+      if (!ret)
+        continue;
+
+      if (gettimeofday (&(ctx->io.outofband.last_received), NULL) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          _api_lan_poll_complete (ctx, ctx->errnum);
+          return (1);
+        }
+
+      _rtt_sample (ctx, ctx->io.outofband.poll.retransmission_count);
+
+      _api_lan_poll_complete (ctx, IPMI_ERR_SUCCESS);
+      return (1);
+    }
+
+  if ((ret = _session_timed_out (ctx)) < 0)
+    {
+      _api_lan_poll_complete (ctx, ctx->errnum);
+      return (1);
+    }
+
+  if (ret)
+    {
+      if (ctx->flags & IPMI_FLAGS_NOSESSION)
+        _api_lan_poll_complete (ctx, IPMI_ERR_MESSAGE_TIMEOUT);
+      else
+        _api_lan_poll_complete (ctx, IPMI_ERR_SESSION_TIMEOUT);
+      return (1);
+    }
+
+  if (!ctx->io.outofband.retransmission_timeout)
+    return (0);
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      _api_lan_poll_complete (ctx, ctx->errnum);
+      return (1);
+    }
+
+  _api_lan_poll_deadline (ctx, &deadline);
+
+  if (timercmp (&current, &deadline, <))
+    return (0);
+
+  _api_lan_poll_sequence_numbers_increment (ctx);
+  ctx->io.outofband.poll.retransmission_count++;
+
+  if (_api_lan_poll_send (ctx) < 0)
+    {
+      _api_lan_poll_complete (ctx, ctx->errnum);
+      return (1);
+    }
+
+  return (0);
+}
+
+void
+api_lan_cmd_poll_cancel (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && (ctx->type == IPMI_DEVICE_LAN
+              || ctx->type == IPMI_DEVICE_LAN_2_0));
+
+  if (!ctx->io.outofband.poll.pending)
+    return;
+
+  /* a late response must not match the next request */
+  _api_lan_poll_sequence_numbers_increment (ctx);
+  memset (&(ctx->io.outofband.poll), '\0', sizeof (ctx->io.outofband.poll));
+}
@@ -80,6 +80,33 @@ int api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
                              fiid_obj_t obj_cmd_rq,
                              fiid_obj_t obj_cmd_rs);
 
+/* Send 'count' requests back to back within the session and wait for
+ * all responses.  Responses are matched to requests by requester
+ * sequence number and may arrive in any order.  On timeout, only the
+ * requests without a response are retransmitted.
+ */
+int api_lan_2_0_cmd_wrapper_batch (ipmi_ctx_t ctx,
+                                   uint8_t lun,
+                                   uint8_t net_fn,
+                                   uint8_t payload_authenticated,
+                                   uint8_t payload_encrypted,
+                                   uint32_t *session_sequence_number,
+                                   uint32_t session_id,
+                                   uint8_t *rq_seq,
+                                   uint8_t authentication_algorithm,
+                                   uint8_t integrity_algorithm,
+                                   uint8_t confidentiality_algorithm,
+                                   const void *integrity_key,
+                                   unsigned int integrity_key_len,
+                                   const void *confidentiality_key,
+                                   unsigned int confidentiality_key_len,
+                                   const char *password,
+                                   unsigned int password_len,
+                                   fiid_obj_t *obj_cmd_rq,
+                                   fiid_obj_t *obj_cmd_rs,
+                                   unsigned int count,
+                                   unsigned int window);
+
 int api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
                                   fiid_obj_t obj_cmd_rq,
                                   fiid_obj_t obj_cmd_rs);
@@ -88,4 +115,22 @@ int api_lan_2_0_open_session (ipmi_ctx_t ctx);
 
 int api_lan_2_0_close_session (ipmi_ctx_t ctx);
 
+/* Single outstanding command polling for IPMI 1.5 and IPMI 2.0 LAN
+ * sessions, see ipmi_cmd_poll_submit().  api_lan_cmd_poll_timeout()
+ * and api_lan_cmd_poll_process() return as ipmi_cmd_poll_timeout()
+ * and ipmi_cmd_poll_process().
+ */
+int api_lan_cmd_poll_submit (ipmi_ctx_t ctx,
+                             fiid_obj_t obj_cmd_rq,
+                             fiid_obj_t obj_cmd_rs,
+                             Ipmi_Cmd_Poll_Callback callback,
+                             void *callback_data);
+
+int api_lan_cmd_poll_timeout (ipmi_ctx_t ctx, unsigned int *timeout);
+
+int api_lan_cmd_poll_process (ipmi_ctx_t ctx);
+
+/* Drops the outstanding command without calling its callback */
+void api_lan_cmd_poll_cancel (ipmi_ctx_t ctx);
+
 #endif /* IPMI_LAN_SESSION_COMMON_H */
@@ -29,40 +29,86 @@
 #include <limits.h>
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/fiid/fiid.h"
 
 #include "libcommon/ipmi-bit-ops.h"
 
 #include "freeipmi-portability.h"
-#include "hash.h"
 #include "secure.h"
 
 #define FIID_OBJ_MAGIC 0xf00fd00d
 #define FIID_ITERATOR_MAGIC 0xd00df00f
+#define FIID_TEMPLATE_LAYOUT_MAGIC 0xfeedf00d
+#define FIID_ARENA_MAGIC 0xf00dfeed
+
+#define FIID_ARENA_DEFAULT_SIZE 4096
+
+/* prime, templates are arrays so low order bits are not very random */
+#define FIID_TEMPLATE_LAYOUT_HASH_SIZE 1021
 
 struct fiid_field_data
 {
   unsigned int max_field_len;
   char key[FIID_FIELD_MAX_KEY_LEN + 1];
-  unsigned int set_field_len;
   unsigned int flags;
   unsigned int index;           /* for lookup */
   unsigned int start;           /* for lookup */
   unsigned int end;             /* for lookup */
 };
 
+/* A template layout is the parsed, immutable form of a
+ * fiid_template_t.  It is built once per template per process and
+ * shared by every object created from that template.  Objects only
+ * carry their own data and set field lengths.
+ */
+struct fiid_template_layout
+{
+  uint32_t magic;
+  const fiid_field_t *tmpl;     /* cache key */
+  struct fiid_field_data *field_data;
+  unsigned int field_data_len;  /* includes terminating field */
+  unsigned int *key_index;      /* field indexes sorted by key */
+  unsigned int data_len;
+  int makes_packet_sufficient;
+  int secure_memset_on_clear;
+  unsigned int refcount;        /* protected by layouts mutex */
+  struct fiid_template_layout *next;
+};
+
 struct fiid_obj
 {
   uint32_t magic;
   fiid_err_t errnum;
   uint8_t *data;
   unsigned int data_len;
-  struct fiid_field_data *field_data;
+  struct fiid_template_layout *layout;
+  struct fiid_field_data *field_data; /* shortcut to layout */
+  unsigned int *set_field_len;
   unsigned int field_data_len;
-  hash_t lookup;
   int makes_packet_sufficient;  /* flag for internal use */
   int secure_memset_on_clear;   /* flag for internal use */
+  struct fiid_arena *arena;     /* NULL if malloced */
+  struct fiid_obj *arena_prev;
+  struct fiid_obj *arena_next;
+};
+
+struct fiid_arena_chunk
+{
+  struct fiid_arena_chunk *next;
+  unsigned int size;
+  unsigned int used;
+};
+
+struct fiid_arena
+{
+  uint32_t magic;
+  struct fiid_arena_chunk *chunks; /* current chunk first */
+  unsigned int chunks_size;
+  struct fiid_obj *objs;           /* live objects */
 };
 
 struct fiid_iterator
@@ -104,6 +150,9 @@ static char * fiid_errmsg[] =
     "errnum out of range",
   };
 
+static struct fiid_template_layout *fiid_template_layouts[FIID_TEMPLATE_LAYOUT_HASH_SIZE];
+static pthread_mutex_t fiid_template_layouts_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 #ifndef NDEBUG
 static int
 _fiid_template_check_valid_keys (fiid_template_t tmpl)
@@ -254,6 +303,45 @@ FIID_TEMPLATE_FIELD_LOOKUP (fiid_template_t tmpl,
   return (ret);
 }
 
+int
+fiid_template_field_index (fiid_template_t tmpl,
+                           const char *field,
+                           fiid_field_index_t *index)
+{
+  unsigned int i;
+
+  if (!(tmpl && field && index))
+    {
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (-1);
+    }
+
+#ifndef NDEBUG
+  if (_fiid_template_check_valid_keys (tmpl) < 0)
+    {
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (-1);
+    }
+#endif /* NDEBUG */
+
+  /* index is the field position, same as the object layout */
+  for (i = 0; tmpl[i].max_field_len; i++)
+    {
+      if (!strcmp (tmpl[i].key, field))
+        {
+          index->tmpl = tmpl;
+          index->index = i;
+          return (0);
+        }
+    }
+
+  /* FIID_ERR_FIELD_NOT_FOUND */
+  errno = EINVAL;
+  return (-1);
+}
+
 int
 fiid_template_len (fiid_template_t tmpl)
 {
@@ -773,20 +861,373 @@ FIID_TEMPLATE_COMPARE (fiid_template_t tmpl1,
   return (ret);
 }
 
+static unsigned int
+_fiid_template_layout_hash (fiid_template_t tmpl)
+{
+  return ((uintptr_t)tmpl % FIID_TEMPLATE_LAYOUT_HASH_SIZE);
+}
+
+static void
+_fiid_template_layout_free (struct fiid_template_layout *layout)
+{
+  if (!layout)
+    return;
+
+  layout->magic = ~FIID_TEMPLATE_LAYOUT_MAGIC;
+  free (layout->field_data);
+  free (layout->key_index);
+  free (layout);
+}
+
+/* must be called with fiid_template_layouts_mutex held */
+static void
+_fiid_template_layout_release (struct fiid_template_layout *layout)
+{
+  assert (layout);
+  assert (layout->magic == FIID_TEMPLATE_LAYOUT_MAGIC);
+  assert (layout->refcount);
+
+  if (!--layout->refcount)
+    _fiid_template_layout_free (layout);
+}
+
+static struct fiid_template_layout *
+_fiid_template_layout_create (fiid_template_t tmpl)
+{
+  struct fiid_template_layout *layout = NULL;
+  unsigned int i;
+  unsigned int start = 0;
+  int data_len;
+
+  assert (tmpl);
+
+#ifndef NDEBUG
+  if (_fiid_template_check_valid_keys (tmpl) < 0)
+    {
+      /* FIID_ERR_TEMPLATE_INVALID */
+      errno = EINVAL;
+      goto cleanup;
+    }
+#endif /* NDEBUG */
+
+  if (_fiid_template_check_valid_flags (tmpl) < 0)
+    {
+      /* FIID_ERR_TEMPLATE_INVALID */
+      errno = EINVAL;
+      goto cleanup;
+    }
+
+  if (!(layout = (struct fiid_template_layout *)malloc (sizeof (struct fiid_template_layout))))
+    {
+      /* FIID_ERR_OUT_OF_MEMORY */
+      errno = ENOMEM;
+      goto cleanup;
+    }
+  memset (layout, '\0', sizeof (struct fiid_template_layout));
+  layout->magic = FIID_TEMPLATE_LAYOUT_MAGIC;
+  layout->tmpl = tmpl;
+
+  /* after call to _fiid_template_len_bytes, we know each field length
+   * and total field length won't overflow an int.
+   */
+  if ((data_len = _fiid_template_len_bytes (tmpl,
+                                            &layout->field_data_len)) < 0)
+    goto cleanup;
+  layout->data_len = data_len;
+
+  if (!layout->field_data_len)
+    {
+      /* FIID_ERR_TEMPLATE_INVALID */
+      errno = EINVAL;
+      goto cleanup;
+    }
+
+  if (!(layout->field_data = malloc (layout->field_data_len * sizeof (struct fiid_field_data))))
+    {
+      /* FIID_ERR_OUT_OF_MEMORY */
+      errno = ENOMEM;
+      goto cleanup;
+    }
+  memset (layout->field_data, '\0', layout->field_data_len * sizeof (struct fiid_field_data));
+
+  if (!(layout->key_index = malloc (layout->field_data_len * sizeof (unsigned int))))
+    {
+      /* FIID_ERR_OUT_OF_MEMORY */
+      errno = ENOMEM;
+      goto cleanup;
+    }
+  memset (layout->key_index, '\0', layout->field_data_len * sizeof (unsigned int));
+
+  for (i = 0; i < layout->field_data_len; i++)
+    {
+      layout->field_data[i].max_field_len = tmpl[i].max_field_len;
+      strncpy (layout->field_data[i].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN);
+      layout->field_data[i].flags = tmpl[i].flags;
+      layout->field_data[i].index = i;
+      layout->field_data[i].start = start;
+      layout->field_data[i].end = start + layout->field_data[i].max_field_len;
+
+      if (layout->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT)
+        layout->makes_packet_sufficient = 1;
+
+      if (layout->field_data[i].flags & FIID_FIELD_SECURE_MEMSET_ON_CLEAR)
+        layout->secure_memset_on_clear = 1;
+
+      start += layout->field_data[i].max_field_len;
+    }
+
+  /* Insertion sort the keys for binary search lookups.  Templates
+   * are small, so this is cheap, and it is only done once per
+   * template.  The terminating field is not a key.  The sort is
+   * stable, so duplicate keys stay in template order.
+   */
+  for (i = 0; i < (layout->field_data_len - 1); i++)
+    {
+      unsigned int j = i;
+
+      while (j
+             && strcmp (layout->field_data[layout->key_index[j - 1]].key,
+                        layout->field_data[i].key) > 0)
+        {
+          layout->key_index[j] = layout->key_index[j - 1];
+          j--;
+        }
+
+      layout->key_index[j] = i;
+    }
+
+  return (layout);
+
+ cleanup:
+  _fiid_template_layout_free (layout);
+  return (NULL);
+}
+
+/* Returns 1 if the layout was built from a template with the same
+ * contents as tmpl, 0 if not.
+ */
+static int
+_fiid_template_layout_matches (struct fiid_template_layout *layout,
+                               const fiid_field_t *tmpl)
+{
+  unsigned int i;
+
+  assert (layout);
+  assert (layout->magic == FIID_TEMPLATE_LAYOUT_MAGIC);
+  assert (tmpl);
+
+  /* stops at the first difference, so tmpl is never read past its
+   * terminating field
+   */
+  for (i = 0; i < layout->field_data_len; i++)
+    {
+      if (layout->field_data[i].max_field_len != tmpl[i].max_field_len
+          || layout->field_data[i].flags != tmpl[i].flags
+          || strncmp (layout->field_data[i].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN))
+        return (0);
+    }
+
+  return (1);
+}
+
+/* Returns a referenced layout for the template, creating and caching
+ * it on first use.
+ */
+static struct fiid_template_layout *
+_fiid_template_layout_get (fiid_template_t tmpl)
+{
+  struct fiid_template_layout **lpp;
+  struct fiid_template_layout *layout = NULL;
+  int perr;
+
+  assert (tmpl);
+
+  if ((perr = pthread_mutex_lock (&fiid_template_layouts_mutex)))
+    {
+      errno = perr;
+      return (NULL);
+    }
+
+  lpp = &fiid_template_layouts[_fiid_template_layout_hash (tmpl)];
+  while (*lpp && (*lpp)->tmpl != tmpl)
+    lpp = &((*lpp)->next);
+
+  /* Dynamic templates drop their layout in fiid_template_free(), but
+   * a template on the stack or released with free() may leave its
+   * layout behind for another template at the same address.
+   */
+  if (*lpp)
+    {
+      if (_fiid_template_layout_matches (*lpp, tmpl))
+        {
+          layout = *lpp;
+          goto out;
+        }
+
+      layout = *lpp;
+      *lpp = layout->next;
+      _fiid_template_layout_release (layout);
+      layout = NULL;
+    }
+
+  if (!(layout = _fiid_template_layout_create (tmpl)))
+    goto out_unlock;
+
+  /* one reference for the cache */
+  layout->refcount = 1;
+  layout->next = *lpp;
+  *lpp = layout;
+
+ out:
+  layout->refcount++;
+ out_unlock:
+  pthread_mutex_unlock (&fiid_template_layouts_mutex);
+  return (layout);
+}
+
+static int
+_fiid_template_layout_ref (struct fiid_template_layout *layout)
+{
+  int perr;
+
+  assert (layout);
+  assert (layout->magic == FIID_TEMPLATE_LAYOUT_MAGIC);
+
+  if ((perr = pthread_mutex_lock (&fiid_template_layouts_mutex)))
+    {
+      errno = perr;
+      return (-1);
+    }
+
+  layout->refcount++;
+
+  pthread_mutex_unlock (&fiid_template_layouts_mutex);
+  return (0);
+}
+
+static void
+_fiid_template_layout_unref (struct fiid_template_layout *layout)
+{
+  assert (layout);
+  assert (layout->magic == FIID_TEMPLATE_LAYOUT_MAGIC);
+
+  /* if we cannot lock, leak rather than risk a double free */
+  if (pthread_mutex_lock (&fiid_template_layouts_mutex))
+    return;
+
+  _fiid_template_layout_release (layout);
+
+  pthread_mutex_unlock (&fiid_template_layouts_mutex);
+}
+
+static int
+_fiid_template_layout_field_index (struct fiid_template_layout *layout,
+                                   const char *field)
+{
+  unsigned int low = 0;
+  unsigned int high;
+
+  assert (layout);
+  assert (layout->magic == FIID_TEMPLATE_LAYOUT_MAGIC);
+  assert (field);
+
+  /* Find the first matching key, like the linear search of old, a
+   * template with a duplicate key resolves to its first occurrence.
+   */
+  high = layout->field_data_len - 1;
+  while (low < high)
+    {
+      unsigned int mid = low + (high - low) / 2;
+
+      if (strcmp (field, layout->field_data[layout->key_index[mid]].key) > 0)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+
+  if (low < layout->field_data_len - 1
+      && !strcmp (field, layout->field_data[layout->key_index[low]].key))
+    return (layout->key_index[low]);
+
+  return (-1);
+}
+
 void
 fiid_template_free (fiid_field_t *tmpl_dynamic)
 {
+  struct fiid_template_layout **lpp;
+
+  if (!tmpl_dynamic)
+    return;
+
+  /* drop any cached layout so the cache does not grow with
+   * short lived templates.
+   */
+  if (!pthread_mutex_lock (&fiid_template_layouts_mutex))
+    {
+      lpp = &fiid_template_layouts[_fiid_template_layout_hash (tmpl_dynamic)];
+      while (*lpp && (*lpp)->tmpl != tmpl_dynamic)
+        lpp = &((*lpp)->next);
+
+      if (*lpp)
+        {
+          struct fiid_template_layout *layout = *lpp;
+
+          *lpp = layout->next;
+          _fiid_template_layout_release (layout);
+        }
+
+      pthread_mutex_unlock (&fiid_template_layouts_mutex);
+    }
+
   free (tmpl_dynamic);
 }
 
+static int
+_fiid_obj_lookup_field_index (fiid_obj_t obj, const char *field, unsigned int *index)
+{
+  int i;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+  assert (index);
+
+  if ((i = _fiid_template_layout_field_index (obj->layout, field)) < 0)
+    {
+      obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
+      return (-1);
+    }
+
+  (*index) = i;
+  return (0);
+}
+
+/* An index is only meaningful for templates with the same contents
+ * as the one it was resolved against, positions in another template
+ * name different fields.
+ */
+static int
+_fiid_obj_field_index_valid (fiid_obj_t obj, fiid_field_index_t index)
+{
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+
+  if (!index.tmpl
+      || index.index >= (obj->field_data_len - 1))
+    return (0);
+
+  return (index.tmpl == obj->layout->tmpl
+          || _fiid_template_layout_matches (obj->layout, index.tmpl));
+}
+
 static int
 _fiid_obj_field_start_end (fiid_obj_t obj,
                            const char *field,
                            unsigned int *start,
                            unsigned int *end)
 {
-  struct fiid_field_data *ffdptr;
-  unsigned int i;
+  unsigned int index;
 
   assert (obj);
   assert (obj->magic == FIID_OBJ_MAGIC);
@@ -794,34 +1235,13 @@ _fiid_obj_field_start_end (fiid_obj_t obj,
   assert (start);
   assert (end);
 
-  if ((ffdptr = hash_find (obj->lookup, field)))
-    {
-      *start = ffdptr->start;
-      *end = ffdptr->end;
-      return (ffdptr->max_field_len);
-    }
-
-  /* integer overflow conditions checked during object creation */
-  for (i = 0; obj->field_data[i].max_field_len; i++)
-    {
-      if (!strcmp (obj->field_data[i].key, field))
-        {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
-            {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
-            }
-
-          *start = obj->field_data[i].start;
-          *end = obj->field_data[i].end;
-          return (obj->field_data[i].max_field_len);
-        }
-    }
+  /* integer overflow conditions checked during layout creation */
+  if (_fiid_obj_lookup_field_index (obj, field, &index) < 0)
+    return (-1);
 
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
+  *start = obj->field_data[index].start;
+  *end = obj->field_data[index].end;
+  return (obj->field_data[index].max_field_len);
 }
 
 static int
@@ -859,34 +1279,16 @@ _fiid_obj_field_end (fiid_obj_t obj, const char *field)
 static int
 _fiid_obj_field_len (fiid_obj_t obj, const char *field)
 {
-  struct fiid_field_data *ffdptr;
-  unsigned int i;
+  unsigned int index;
 
   assert (obj);
   assert (obj->magic == FIID_OBJ_MAGIC);
   assert (field);
 
-  if ((ffdptr = hash_find (obj->lookup, field)))
-    return (ffdptr->max_field_len);
-
-  for (i = 0; obj->field_data[i].max_field_len; i++)
-    {
-      if (!strcmp (obj->field_data[i].key, field))
-        {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
-            {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
-            }
-
-          return (obj->field_data[i].max_field_len);
-        }
-    }
+  if (_fiid_obj_lookup_field_index (obj, field, &index) < 0)
+    return (-1);
 
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
+  return (obj->field_data[index].max_field_len);
 }
 
 char *
@@ -898,144 +1300,280 @@ fiid_strerror (fiid_err_t errnum)
     return (fiid_errmsg[FIID_ERR_ERRNUMRANGE]);
 }
 
+static unsigned int
+_fiid_obj_alloc_len (struct fiid_template_layout *layout)
+{
+  assert (layout);
+
+  return (sizeof (struct fiid_obj)
+          + layout->field_data_len * sizeof (unsigned int)
+          + layout->data_len);
+}
+
+/* set_field_len and data are carved out of the same allocation
+ * as the object itself.
+ */
+static void
+_fiid_obj_init (fiid_obj_t obj, struct fiid_template_layout *layout)
+{
+  assert (obj);
+  assert (layout);
+
+  memset (obj, '\0', _fiid_obj_alloc_len (layout));
+  obj->magic = FIID_OBJ_MAGIC;
+  obj->layout = layout;
+  obj->field_data = layout->field_data;
+  obj->field_data_len = layout->field_data_len;
+  obj->set_field_len = (unsigned int *)(obj + 1);
+  obj->data = (uint8_t *)(obj->set_field_len + layout->field_data_len);
+  obj->data_len = layout->data_len;
+  obj->makes_packet_sufficient = layout->makes_packet_sufficient;
+  obj->secure_memset_on_clear = layout->secure_memset_on_clear;
+  obj->errnum = FIID_ERR_SUCCESS;
+}
+
 fiid_obj_t
 fiid_obj_create (fiid_template_t tmpl)
 {
+  struct fiid_template_layout *layout = NULL;
   fiid_obj_t obj = NULL;
-  unsigned int max_pkt_len = 0;
-  unsigned int i;
-  unsigned int start = 0;
-  int data_len;
 
   if (!tmpl)
     {
       /* FIID_ERR_PARAMETERS */
       errno = EINVAL;
-      goto cleanup;
+      return (NULL);
     }
 
-#ifndef NDEBUG
-  if (_fiid_template_check_valid_keys (tmpl) < 0)
+  if (!(layout = _fiid_template_layout_get (tmpl)))
+    return (NULL);
+
+  if (!(obj = (fiid_obj_t)malloc (_fiid_obj_alloc_len (layout))))
     {
-      /* FIID_ERR_TEMPLATE_INVALID */
-      errno = EINVAL;
-      goto cleanup;
+      /* FIID_ERR_OUT_OF_MEMORY */
+      _fiid_template_layout_unref (layout);
+      errno = ENOMEM;
+      return (NULL);
     }
-#endif /* NDEBUG */
 
-  if (_fiid_template_check_valid_flags (tmpl) < 0)
+  _fiid_obj_init (obj, layout);
+  return (obj);
+}
+
+/* Arena chunks are carved up in multiples of this, so object and
+ * data alignment is preserved.
+ */
+#define FIID_ARENA_ALIGN        16
+#define FIID_ARENA_ROUND(__len) \
+  (((__len) + FIID_ARENA_ALIGN - 1) & ~(FIID_ARENA_ALIGN - 1))
+#define FIID_ARENA_CHUNK_HDR_LEN FIID_ARENA_ROUND (sizeof (struct fiid_arena_chunk))
+
+static void
+_fiid_arena_chunks_free (struct fiid_arena *arena)
+{
+  struct fiid_arena_chunk *chunk;
+
+  assert (arena);
+
+  while ((chunk = arena->chunks))
     {
-      /* FIID_ERR_TEMPLATE_INVALID */
-      errno = EINVAL;
-      goto cleanup;
+      arena->chunks = chunk->next;
+      free (chunk);
     }
+  arena->chunks_size = 0;
+}
+
+static struct fiid_arena_chunk *
+_fiid_arena_chunk_add (struct fiid_arena *arena, unsigned int size)
+{
+  struct fiid_arena_chunk *chunk;
+
+  assert (arena);
+
+  if (!(chunk = (struct fiid_arena_chunk *)malloc (FIID_ARENA_CHUNK_HDR_LEN + size)))
+    return (NULL);
 
-  if (!(obj = (fiid_obj_t)malloc (sizeof (struct fiid_obj))))
+  chunk->next = arena->chunks;
+  chunk->size = size;
+  chunk->used = 0;
+  arena->chunks = chunk;
+  arena->chunks_size += size;
+  return (chunk);
+}
+
+/* No objects are live, make all memory available again.  If the
+ * arena had to grow, replace its chunks with one chunk large enough
+ * for everything, so the steady state needs no further allocations.
+ */
+static void
+_fiid_arena_rewind (struct fiid_arena *arena)
+{
+  assert (arena);
+  assert (!arena->objs);
+
+  if (arena->chunks && arena->chunks->next)
     {
-      /* FIID_ERR_OUT_OF_MEMORY */
-      errno = ENOMEM;
-      goto cleanup;
+      unsigned int size = arena->chunks_size;
+
+      _fiid_arena_chunks_free (arena);
+
+      /* if this fails, a chunk will be allocated on demand later */
+      _fiid_arena_chunk_add (arena, size);
     }
-  memset (obj, '\0', sizeof (struct fiid_obj));
-  obj->magic = FIID_OBJ_MAGIC;
+  else if (arena->chunks)
+    arena->chunks->used = 0;
+}
 
-  /* after call to _fiid_template_len_bytes, we know each field length
-   * and total field length won't overflow an int.
-   */
-  if ((data_len = _fiid_template_len_bytes (tmpl,
-                                            &obj->field_data_len)) < 0)
-    goto cleanup;
-  obj->data_len = data_len;
+static void
+_fiid_arena_obj_release (fiid_obj_t obj)
+{
+  struct fiid_arena *arena;
+  struct fiid_arena_chunk *chunk;
+  unsigned int len;
+
+  assert (obj);
+  assert (obj->arena);
+
+  arena = obj->arena;
+  len = FIID_ARENA_ROUND (_fiid_obj_alloc_len (obj->layout));
 
-  if (!obj->field_data_len)
+  if (obj->arena_prev)
+    obj->arena_prev->arena_next = obj->arena_next;
+  else
+    arena->objs = obj->arena_next;
+  if (obj->arena_next)
+    obj->arena_next->arena_prev = obj->arena_prev;
+
+  obj->magic = ~FIID_OBJ_MAGIC;
+  obj->errnum = FIID_ERR_SUCCESS;
+  obj->arena = NULL;
+  _fiid_template_layout_unref (obj->layout);
+
+  if (!arena->objs)
     {
-      /* FIID_ERR_TEMPLATE_INVALID */
-      errno = EINVAL;
-      goto cleanup;
+      _fiid_arena_rewind (arena);
+      return;
     }
 
-  if (!(obj->data = malloc (obj->data_len)))
+  /* objects destroyed in reverse order of creation are reclaimed
+   * immediately, anything else waits until the arena is empty.
+   */
+  chunk = arena->chunks;
+  if ((uint8_t *)obj + len == (uint8_t *)chunk + FIID_ARENA_CHUNK_HDR_LEN + chunk->used)
+    chunk->used -= len;
+}
+
+fiid_arena_t
+fiid_arena_create (unsigned int size)
+{
+  fiid_arena_t arena = NULL;
+
+  if (!size)
+    size = FIID_ARENA_DEFAULT_SIZE;
+
+  if (!(arena = (fiid_arena_t)malloc (sizeof (struct fiid_arena))))
     {
       /* FIID_ERR_OUT_OF_MEMORY */
       errno = ENOMEM;
-      goto cleanup;
+      return (NULL);
     }
-  memset (obj->data, '\0', obj->data_len);
+  memset (arena, '\0', sizeof (struct fiid_arena));
+  arena->magic = FIID_ARENA_MAGIC;
 
-  if (!(obj->field_data = malloc (obj->field_data_len * sizeof (struct fiid_field_data))))
+  if (!_fiid_arena_chunk_add (arena, FIID_ARENA_ROUND (size)))
     {
       /* FIID_ERR_OUT_OF_MEMORY */
+      free (arena);
       errno = ENOMEM;
-      goto cleanup;
+      return (NULL);
     }
-  memset (obj->field_data, '\0', obj->field_data_len * sizeof (struct fiid_field_data));
 
-  if (!(obj->lookup = hash_create (obj->field_data_len,
-                                   (hash_key_f)hash_key_string,
-                                   (hash_cmp_f)strcmp,
-                                   NULL)))
+  return (arena);
+}
+
+int
+fiid_arena_reset (fiid_arena_t arena)
+{
+  fiid_obj_t obj;
+
+  if (!arena || arena->magic != FIID_ARENA_MAGIC)
     {
-      errno = ENOMEM;
-      goto cleanup;
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (-1);
     }
 
-  for (i = 0; i < obj->field_data_len; i++)
+  while ((obj = arena->objs))
     {
-#ifndef NDEBUG
-      if (tmpl[i].max_field_len)
-        {
-          unsigned int j;
+      arena->objs = obj->arena_next;
+      obj->magic = ~FIID_OBJ_MAGIC;
+      obj->arena = NULL;
+      _fiid_template_layout_unref (obj->layout);
+    }
 
-          for (j = 0; j < i; j++)
-            {
-              if (!strncmp (obj->field_data[j].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN))
-                {
-                  /* FIID_ERR_TEMPLATE_INVALID */
-                  errno = EINVAL;
-                  goto cleanup;
-                }
-            }
-        }
-#endif /* !NDEBUG */
-      obj->field_data[i].max_field_len = tmpl[i].max_field_len;
-      memset (obj->field_data[i].key, '\0', FIID_FIELD_MAX_KEY_LEN + 1);
-      strncpy (obj->field_data[i].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN);
-      obj->field_data[i].set_field_len = 0;
-      obj->field_data[i].flags = tmpl[i].flags;
-      obj->field_data[i].index = i;
-      obj->field_data[i].start = start;
-      obj->field_data[i].end = start + obj->field_data[i].max_field_len;
-      max_pkt_len += tmpl[i].max_field_len;
+  _fiid_arena_rewind (arena);
+  return (0);
+}
 
-      if (obj->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT)
-        obj->makes_packet_sufficient = 1;
+void
+fiid_arena_destroy (fiid_arena_t arena)
+{
+  if (!arena || arena->magic != FIID_ARENA_MAGIC)
+    return;
 
-      if (obj->field_data[i].flags & FIID_FIELD_SECURE_MEMSET_ON_CLEAR)
-        obj->secure_memset_on_clear = 1;
+  fiid_arena_reset (arena);
+  _fiid_arena_chunks_free (arena);
+  arena->magic = ~FIID_ARENA_MAGIC;
+  free (arena);
+}
 
-      start += obj->field_data[i].max_field_len;
-    }
+fiid_obj_t
+fiid_obj_create_in_arena (fiid_arena_t arena, fiid_template_t tmpl)
+{
+  struct fiid_template_layout *layout = NULL;
+  struct fiid_arena_chunk *chunk;
+  fiid_obj_t obj = NULL;
+  unsigned int len;
 
-  if (max_pkt_len % 8)
+  if (!arena || arena->magic != FIID_ARENA_MAGIC || !tmpl)
     {
-      /* FIID_ERR_TEMPLATE_NOT_BYTE_ALIGNED */
+      /* FIID_ERR_PARAMETERS */
       errno = EINVAL;
-      goto cleanup;
+      return (NULL);
     }
 
-  obj->errnum = FIID_ERR_SUCCESS;
-  return (obj);
+  if (!(layout = _fiid_template_layout_get (tmpl)))
+    return (NULL);
 
- cleanup:
-  if (obj)
+  len = FIID_ARENA_ROUND (_fiid_obj_alloc_len (layout));
+
+  chunk = arena->chunks;
+  if (!chunk || (chunk->size - chunk->used) < len)
     {
-      free (obj->data);
-      free (obj->field_data);
-      hash_destroy (obj->lookup);
-      free (obj);
+      unsigned int size = chunk ? chunk->size * 2 : FIID_ARENA_DEFAULT_SIZE;
+
+      if (size < len)
+        size = len;
+
+      if (!(chunk = _fiid_arena_chunk_add (arena, size)))
+        {
+          /* FIID_ERR_OUT_OF_MEMORY */
+          _fiid_template_layout_unref (layout);
+          errno = ENOMEM;
+          return (NULL);
+        }
     }
 
-  return (NULL);
+  obj = (fiid_obj_t)((uint8_t *)chunk + FIID_ARENA_CHUNK_HDR_LEN + chunk->used);
+  chunk->used += len;
+
+  _fiid_obj_init (obj, layout);
+  obj->arena = arena;
+  obj->arena_next = arena->objs;
+  if (arena->objs)
+    arena->objs->arena_prev = obj;
+  arena->objs = obj;
+  return (obj);
 }
 
 void
@@ -1044,11 +1582,15 @@ fiid_obj_destroy (fiid_obj_t obj)
   if (!(obj && obj->magic == FIID_OBJ_MAGIC))
     return;
 
+  if (obj->arena)
+    {
+      _fiid_arena_obj_release (obj);
+      return;
+    }
+
   obj->magic = ~FIID_OBJ_MAGIC;
   obj->errnum = FIID_ERR_SUCCESS;
-  free (obj->data);
-  free (obj->field_data);
-  hash_destroy (obj->lookup);
+  _fiid_template_layout_unref (obj->layout);
   free (obj);
 }
 
@@ -1058,57 +1600,29 @@ fiid_obj_dup (fiid_obj_t src_obj)
   fiid_obj_t dest_obj = NULL;
 
   if (!src_obj || src_obj->magic != FIID_OBJ_MAGIC)
-    goto cleanup;
-
-  if (!(dest_obj = malloc (sizeof (struct fiid_obj))))
-    {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
-    }
-  memset (dest_obj, '\0', sizeof (struct fiid_obj));
-  dest_obj->magic = src_obj->magic;
-  dest_obj->data_len = src_obj->data_len;
-  dest_obj->field_data_len = src_obj->field_data_len;
+    return (NULL);
 
-  if (!(dest_obj->data = malloc (src_obj->data_len)))
+  if (!(dest_obj = malloc (_fiid_obj_alloc_len (src_obj->layout))))
     {
       src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      return (NULL);
     }
-  memcpy (dest_obj->data, src_obj->data, src_obj->data_len);
 
-  if (!(dest_obj->field_data = malloc (dest_obj->field_data_len * sizeof (struct fiid_field_data))))
+  if (_fiid_template_layout_ref (src_obj->layout) < 0)
     {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      src_obj->errnum = FIID_ERR_INTERNAL_ERROR;
+      free (dest_obj);
+      return (NULL);
     }
 
-  memcpy (dest_obj->field_data,
-          src_obj->field_data,
-          src_obj->field_data_len * sizeof (struct fiid_field_data));
-
-  if (!(dest_obj->lookup = hash_create (dest_obj->field_data_len,
-                                        (hash_key_f)hash_key_string,
-                                        (hash_cmp_f)strcmp,
-                                        NULL)))
-    {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
-    }
+  _fiid_obj_init (dest_obj, src_obj->layout);
+  memcpy (dest_obj->set_field_len,
+          src_obj->set_field_len,
+          src_obj->field_data_len * sizeof (unsigned int));
+  memcpy (dest_obj->data, src_obj->data, src_obj->data_len);
 
   src_obj->errnum = FIID_ERR_SUCCESS;
-  dest_obj->errnum = FIID_ERR_SUCCESS;
   return (dest_obj);
-
- cleanup:
-  if (dest_obj)
-    {
-      free (dest_obj->data);
-      free (dest_obj->field_data);
-      hash_destroy (dest_obj->lookup);
-      free (dest_obj);
-    }
-  return (NULL);
 }
 
 fiid_obj_t
@@ -1183,7 +1697,7 @@ _fiid_obj_packet_valid (fiid_obj_t obj, int makes_packet_sufficient_checks)
       unsigned int required_flag = FIID_FIELD_REQUIRED_FLAG (obj->field_data[i].flags);
       unsigned int length_flag = FIID_FIELD_LENGTH_FLAG (obj->field_data[i].flags);
       unsigned int max_field_len = obj->field_data[i].max_field_len;
-      unsigned int set_field_len = obj->field_data[i].set_field_len;
+      unsigned int set_field_len = obj->set_field_len[i];
       unsigned int makes_packet_sufficient_flag = obj->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT;
 
       if (makes_packet_sufficient_checks)
@@ -1471,44 +1985,6 @@ fiid_obj_errormsg (fiid_obj_t obj)
   return (fiid_strerror (fiid_obj_errnum (obj)));
 }
 
-static int
-_fiid_obj_lookup_field_index (fiid_obj_t obj, const char *field, unsigned int *index)
-{
-  struct fiid_field_data *ffdptr;
-  unsigned int i;
-
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (field);
-  assert (index);
-
-  if ((ffdptr = hash_find (obj->lookup, field)))
-    {
-      (*index) = ffdptr->index;
-      return (0);
-    }
-
-  for (i = 0; obj->field_data[i].max_field_len; i++)
-    {
-      if (!strcmp (obj->field_data[i].key, field))
-        {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
-            {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
-            }
-
-          (*index) = obj->field_data[i].index;
-          return (0);
-        }
-    }
-
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
-}
-
 int
 fiid_obj_len (fiid_obj_t obj)
 {
@@ -1520,7 +1996,7 @@ fiid_obj_len (fiid_obj_t obj)
 
   /* integer overflow conditions checked during object creation */
   for (i = 0; obj->field_data[i].max_field_len; i++)
-    counter += obj->field_data[i].set_field_len;
+    counter += obj->set_field_len[i];
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (counter);
@@ -1565,7 +2041,7 @@ fiid_obj_field_len (fiid_obj_t obj, const char *field)
     return (-1);
 
   obj->errnum = FIID_ERR_SUCCESS;
-  return (obj->field_data[key_index].set_field_len);
+  return (obj->set_field_len[key_index]);
 }
 
 int
@@ -1625,7 +2101,7 @@ fiid_obj_block_len (fiid_obj_t obj, const char *field_start, const char *field_e
 
   /* integer overflow conditions checked during object creation */
   for (i = key_index_start; i <= key_index_end; i++)
-    counter += obj->field_data[i].set_field_len;
+    counter += obj->set_field_len[i];
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (counter);
@@ -1672,7 +2148,7 @@ fiid_obj_clear (fiid_obj_t obj)
     memset (obj->data, '\0', obj->data_len);
 
   for (i =0; i < obj->field_data_len; i++)
-    obj->field_data[i].set_field_len = 0;
+    obj->set_field_len[i] = 0;
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
@@ -1696,7 +2172,7 @@ fiid_obj_clear_field (fiid_obj_t obj, const char *field)
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  if (!obj->set_field_len[key_index])
     return (0);
 
   if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
@@ -1742,7 +2218,7 @@ fiid_obj_clear_field (fiid_obj_t obj, const char *field)
         memset (obj->data + field_offset, '\0', bytes_len);
     }
 
-  obj->field_data[key_index].set_field_len = 0;
+  obj->set_field_len[key_index] = 0;
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
 }
@@ -1789,39 +2265,25 @@ FIID_OBJ_FIELD_LOOKUP (fiid_obj_t obj, const char *field)
   return (ret);
 }
 
-int
-fiid_obj_set (fiid_obj_t obj,
-              const char *field,
-              uint64_t val)
+static int
+_fiid_obj_set (fiid_obj_t obj,
+               unsigned int key_index,
+               uint64_t val)
 {
-  unsigned int start_bit_pos = 0;
-  unsigned int end_bit_pos = 0; /* excluded always */
+  unsigned int start_bit_pos;
   int byte_pos = 0;
   int start_bit_in_byte_pos = 0;
   int end_bit_in_byte_pos = 0;
   int field_len = 0;
   int bytes_used = 0;
-  unsigned int key_index;
   uint64_t merged_val = 0;
-  uint8_t *temp_data = NULL;
-
-  if (!obj || obj->magic != FIID_OBJ_MAGIC)
-    goto cleanup;
-
-  if (!field)
-    {
-      obj->errnum = FIID_ERR_PARAMETERS;
-      goto cleanup;
-    }
 
-  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
-    return (-1);
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < (obj->field_data_len - 1));
 
-  if ((field_len = _fiid_obj_field_start_end (obj,
-                                              field,
-                                              &start_bit_pos,
-                                              &end_bit_pos)) < 0)
-    return (-1);
+  start_bit_pos = obj->field_data[key_index].start;
+  field_len = obj->field_data[key_index].max_field_len;
 
   if (field_len > 64)
     field_len = 64;
@@ -1856,18 +2318,18 @@ fiid_obj_set (fiid_obj_t obj,
 
   if (bytes_used > 1)
     {
+      /* at most 64 bits starting at any bit within a byte */
+      uint8_t temp_data[sizeof (uint64_t) + 1];
       int start_val_pos = 0;
       int end_val_pos = 0;
       uint64_t extracted_val = 0;
       int field_len_left = field_len;
       unsigned int i;
 
-      if (!(temp_data = malloc (obj->data_len)))
-        {
-          obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-          goto cleanup;
-        }
-      memcpy (temp_data, obj->data, obj->data_len);
+      assert (bytes_used <= sizeof (temp_data));
+
+      /* work on a copy, so object is untouched on error */
+      memcpy (temp_data, obj->data + byte_pos, bytes_used);
 
       for (i = 0; i < bytes_used; i++)
         {
@@ -1895,26 +2357,26 @@ fiid_obj_set (fiid_obj_t obj,
                             &extracted_val) < 0)
             {
               obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              goto cleanup;
+              return (-1);
             }
 
-          if (bits_merge (temp_data[byte_pos + i],
+          if (bits_merge (temp_data[i],
                           start_bit_in_byte_pos,
                           end_bit_in_byte_pos,
                           extracted_val,
                           &merged_val) < 0)
             {
               obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              goto cleanup;
+              return (-1);
             }
 
-          temp_data[byte_pos + i] = merged_val;
+          temp_data[i] = merged_val;
           start_bit_in_byte_pos = 0;
           start_val_pos = end_val_pos;
         }
 
-      memcpy (obj->data, temp_data, obj->data_len);
-      obj->field_data[key_index].set_field_len = field_len;
+      memcpy (obj->data + byte_pos, temp_data, bytes_used);
+      obj->set_field_len[key_index] = field_len;
     }
   else
     {
@@ -1925,40 +2387,27 @@ fiid_obj_set (fiid_obj_t obj,
                       &merged_val) < 0)
         {
           obj->errnum = FIID_ERR_INTERNAL_ERROR;
-          goto cleanup;
+          return (-1);
         }
       obj->data[byte_pos] = merged_val;
-      obj->field_data[key_index].set_field_len = field_len;
+      obj->set_field_len[key_index] = field_len;
     }
 
-  free (temp_data);
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
-
- cleanup:
-  free (temp_data);
-  return (-1);
 }
 
 int
-fiid_obj_get (fiid_obj_t obj,
+fiid_obj_set (fiid_obj_t obj,
               const char *field,
-              uint64_t *val)
+              uint64_t val)
 {
-  unsigned int start_bit_pos = 0;
-  unsigned int end_bit_pos = 0; /* excluded always */
-  int byte_pos = 0;
-  int start_bit_in_byte_pos = 0;
-  int end_bit_in_byte_pos = 0;
-  int field_len = 0;
-  int bytes_used = 0;
   unsigned int key_index;
-  uint64_t merged_val = 0;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (!field || !val)
+  if (!field)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
       return (-1);
@@ -1967,23 +2416,58 @@ fiid_obj_get (fiid_obj_t obj,
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  return (_fiid_obj_set (obj, key_index, val));
+}
+
+int
+fiid_obj_set_by_index (fiid_obj_t obj,
+                       fiid_field_index_t index,
+                       uint64_t val)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!_fiid_obj_field_index_valid (obj, index))
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  return (_fiid_obj_set (obj, index.index, val));
+}
+
+static int
+_fiid_obj_get (fiid_obj_t obj,
+               unsigned int key_index,
+               uint64_t *val)
+{
+  unsigned int start_bit_pos;
+  int byte_pos = 0;
+  int start_bit_in_byte_pos = 0;
+  int end_bit_in_byte_pos = 0;
+  int field_len = 0;
+  int bytes_used = 0;
+  uint64_t merged_val = 0;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < (obj->field_data_len - 1));
+  assert (val);
+
+  if (!obj->set_field_len[key_index])
     {
       obj->errnum = FIID_ERR_SUCCESS;
       return (0);
     }
 
-  if ((field_len = _fiid_obj_field_start_end (obj,
-                                              field,
-                                              &start_bit_pos,
-                                              &end_bit_pos)) < 0)
-    return (-1);
+  start_bit_pos = obj->field_data[key_index].start;
+  field_len = obj->field_data[key_index].max_field_len;
 
   if (field_len > 64)
     field_len = 64;
 
-  if (field_len > obj->field_data[key_index].set_field_len)
-    field_len = obj->field_data[key_index].set_field_len;
+  if (field_len > obj->set_field_len[key_index])
+    field_len = obj->set_field_len[key_index];
 
   byte_pos = start_bit_pos / 8;
 
@@ -2088,6 +2572,45 @@ fiid_obj_get (fiid_obj_t obj,
   return (1);
 }
 
+int
+fiid_obj_get (fiid_obj_t obj,
+              const char *field,
+              uint64_t *val)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!field || !val)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
+
+  return (_fiid_obj_get (obj, key_index, val));
+}
+
+int
+fiid_obj_get_by_index (fiid_obj_t obj,
+                       fiid_field_index_t index,
+                       uint64_t *val)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!val || !_fiid_obj_field_index_valid (obj, index))
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  return (_fiid_obj_get (obj, index.index, val));
+}
+
 int
 FIID_OBJ_GET (fiid_obj_t obj,
               const char *field,
@@ -2110,32 +2633,45 @@ FIID_OBJ_GET (fiid_obj_t obj,
 }
 
 int
-fiid_obj_set_data (fiid_obj_t obj,
-                   const char *field,
-                   const void *data,
-                   unsigned int data_len)
+FIID_OBJ_GET_BY_INDEX (fiid_obj_t obj,
+                       fiid_field_index_t index,
+                       uint64_t *val)
 {
-  unsigned int field_offset, bytes_len, key_index;
-  int bits_len, field_start;
+  uint64_t lval;
+  int ret;
 
-  if (!obj || obj->magic != FIID_OBJ_MAGIC)
-    return (-1);
+  if ((ret = fiid_obj_get_by_index (obj, index, &lval)) < 0)
+    return (ret);
 
-  if (!field || !data)
+  if (!ret)
     {
-      obj->errnum = FIID_ERR_PARAMETERS;
+      obj->errnum = FIID_ERR_DATA_NOT_AVAILABLE;
       return (-1);
     }
 
-  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
-    return (-1);
+  *val = lval;
+  return (ret);
+}
+
+static int
+_fiid_obj_set_data (fiid_obj_t obj,
+                    unsigned int key_index,
+                    const void *data,
+                    unsigned int data_len)
+{
+  unsigned int field_offset, bytes_len;
+  unsigned int bits_len, field_start;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < (obj->field_data_len - 1));
+  assert (data);
 
   /* achu: We assume the field must start on a byte boundary and end
    * on a byte boundary.
    */
 
-  if ((field_start = _fiid_obj_field_start (obj, field)) < 0)
-    return (-1);
+  field_start = obj->field_data[key_index].start;
 
   if (field_start % 8)
     {
@@ -2143,8 +2679,7 @@ fiid_obj_set_data (fiid_obj_t obj,
       return (-1);
     }
 
-  if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
-    return (-1);
+  bits_len = obj->field_data[key_index].max_field_len;
 
   if (bits_len % 8)
     {
@@ -2158,20 +2693,19 @@ fiid_obj_set_data (fiid_obj_t obj,
 
   field_offset = BITS_ROUND_BYTES (field_start);
   memcpy ((obj->data + field_offset), data, data_len);
-  obj->field_data[key_index].set_field_len = (data_len * 8);
+  obj->set_field_len[key_index] = (data_len * 8);
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
 }
 
 int
-fiid_obj_get_data (fiid_obj_t obj,
+fiid_obj_set_data (fiid_obj_t obj,
                    const char *field,
-                   void *data,
+                   const void *data,
                    unsigned int data_len)
 {
-  unsigned int field_offset, bytes_len, key_index;
-  int bits_len, field_start;
+  unsigned int key_index;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
@@ -2185,15 +2719,49 @@ fiid_obj_get_data (fiid_obj_t obj,
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  return (_fiid_obj_set_data (obj, key_index, data, data_len));
+}
+
+int
+fiid_obj_set_data_by_index (fiid_obj_t obj,
+                            fiid_field_index_t index,
+                            const void *data,
+                            unsigned int data_len)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!data || !_fiid_obj_field_index_valid (obj, index))
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  return (_fiid_obj_set_data (obj, index.index, data, data_len));
+}
+
+static int
+_fiid_obj_get_data (fiid_obj_t obj,
+                    unsigned int key_index,
+                    void *data,
+                    unsigned int data_len)
+{
+  unsigned int field_offset, bytes_len;
+  unsigned int bits_len, field_start;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < (obj->field_data_len - 1));
+  assert (data);
+
+  if (!obj->set_field_len[key_index])
     return (0);
 
   /* achu: We assume the field must start on a byte boundary and end
    * on a byte boundary.
    */
 
-  if ((field_start = _fiid_obj_field_start (obj, field)) < 0)
-    return (-1);
+  field_start = obj->field_data[key_index].start;
 
   if (field_start % 8)
     {
@@ -2201,11 +2769,10 @@ fiid_obj_get_data (fiid_obj_t obj,
       return (-1);
     }
 
-  if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
-    return (-1);
+  bits_len = obj->field_data[key_index].max_field_len;
 
-  if (obj->field_data[key_index].set_field_len < bits_len)
-    bits_len = obj->field_data[key_index].set_field_len;
+  if (obj->set_field_len[key_index] < bits_len)
+    bits_len = obj->set_field_len[key_index];
 
   if (bits_len % 8)
     {
@@ -2229,6 +2796,47 @@ fiid_obj_get_data (fiid_obj_t obj,
   return (bytes_len);
 }
 
+int
+fiid_obj_get_data (fiid_obj_t obj,
+                   const char *field,
+                   void *data,
+                   unsigned int data_len)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!field || !data)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
+
+  return (_fiid_obj_get_data (obj, key_index, data, data_len));
+}
+
+int
+fiid_obj_get_data_by_index (fiid_obj_t obj,
+                            fiid_field_index_t index,
+                            void *data,
+                            unsigned int data_len)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!data || !_fiid_obj_field_index_valid (obj, index))
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  return (_fiid_obj_get_data (obj, index.index, data, data_len));
+}
+
 int
 fiid_obj_set_all (fiid_obj_t obj,
                   const void *data,
@@ -2283,16 +2891,16 @@ fiid_obj_set_all (fiid_obj_t obj,
   bits_counter = 0;
   for (i = 0; i < key_index_end; i++)
     {
-      obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
-      bits_counter += obj->field_data[i].set_field_len;
+      obj->set_field_len[i] = obj->field_data[i].max_field_len;
+      bits_counter += obj->set_field_len[i];
     }
   if (data_bits_len < bits_counter + obj->field_data[key_index_end].max_field_len)
     {
       int data_bits_left = data_bits_len - bits_counter;
-      obj->field_data[i].set_field_len = data_bits_left;
+      obj->set_field_len[i] = data_bits_left;
     }
   else
-    obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
+    obj->set_field_len[i] = obj->field_data[i].max_field_len;
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
@@ -2341,7 +2949,7 @@ fiid_obj_get_all (fiid_obj_t obj,
       for (i = 0; i < obj->field_data_len; i++)
         {
           unsigned int max_field_len = obj->field_data[i].max_field_len;
-          unsigned int set_field_len = obj->field_data[i].set_field_len;
+          unsigned int set_field_len = obj->set_field_len[i];
 
           max_bits_counter += max_field_len;
 
@@ -2557,16 +3165,16 @@ fiid_obj_set_block (fiid_obj_t obj,
   bits_counter = 0;
   for (i = key_index_start; i < key_index_end; i++)
     {
-      obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
-      bits_counter += obj->field_data[i].set_field_len;
+      obj->set_field_len[i] = obj->field_data[i].max_field_len;
+      bits_counter += obj->set_field_len[i];
     }
   if (data_bits_len < bits_counter + obj->field_data[key_index_end].max_field_len)
     {
       int data_bits_left = data_bits_len - bits_counter;
-      obj->field_data[i].set_field_len = data_bits_left;
+      obj->set_field_len[i] = data_bits_left;
     }
   else
-    obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
+    obj->set_field_len[i] = obj->field_data[i].max_field_len;
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
@@ -2660,7 +3268,7 @@ fiid_obj_get_block (fiid_obj_t obj,
       for (i = key_index_start; i <= key_index_end; i++)
         {
           unsigned int max_field_len = obj->field_data[i].max_field_len;
-          unsigned int set_field_len = obj->field_data[i].set_field_len;
+          unsigned int set_field_len = obj->set_field_len[i];
 
           max_bits_counter += max_field_len;
 
@@ -2866,7 +3474,7 @@ fiid_iterator_field_len (fiid_iterator_t iter)
 
   iter->errnum = FIID_ERR_SUCCESS;
   /* integer overflow conditions checked during object creation */
-  return (iter->obj->field_data[iter->current_index].set_field_len);
+  return (iter->obj->set_field_len[iter->current_index]);
 }
 
 char *
@@ -164,6 +164,14 @@ typedef enum ipmi_driver_type ipmi_driver_type_t;
 #define IPMI_SESSION_TIMEOUT_DEFAULT                                        20000
 #define IPMI_RETRANSMISSION_TIMEOUT_DEFAULT                                 1000
 
+/* Requests outstanding at once in ipmi_cmd_batch().  The maximum is
+ * half of the 64 requester sequence numbers, leaving room for
+ * retransmissions, as a requester sequence number is not reused while
+ * a response to an earlier send with it may still arrive.
+ */
+#define IPMI_CMD_BATCH_WINDOW_DEFAULT                                       8
+#define IPMI_CMD_BATCH_WINDOW_MAX                                           32
+
 #define IPMI_WORKAROUND_FLAGS_DEFAULT                                       0x00000000
 
 /* For use w/ ipmi_ctx_open_outofband() */
@@ -364,6 +372,84 @@ int ipmi_cmd_raw_ipmb (ipmi_ctx_t ctx,
                        void *buf_rs,
                        unsigned int buf_rs_len);
 
+/* Perform count IPMI commands with the same lun and net_fn, such as
+ * a sweep of Get Sensor Reading requests.  On IPMI 2.0 LAN contexts
+ * without a bridging target, up to window requests are kept
+ * outstanding within the session and responses are matched to their
+ * requests by requester sequence number, so the batch takes a few
+ * round trips instead of count.  On all other contexts the commands
+ * are performed one at a time, as with ipmi_cmd().
+ *
+ * A window of 0 selects IPMI_CMD_BATCH_WINDOW_DEFAULT.  Returns 0 if
+ * a response was received for every request, -1 on error.  As with
+ * ipmi_cmd(), completion codes are not checked.
+ */
+int ipmi_cmd_batch (ipmi_ctx_t ctx,
+                    uint8_t lun,
+                    uint8_t net_fn,
+                    fiid_obj_t *obj_cmd_rq,
+                    fiid_obj_t *obj_cmd_rs,
+                    unsigned int count,
+                    unsigned int window);
+
+/* Single outstanding command polling
+ *
+ * These let one thread drive a command on each of many already
+ * opened LAN contexts, instead of blocking in ipmi_cmd() on one
+ * context at a time.  They do not pipeline: a context has at most
+ * one command outstanding, and ipmi_cmd_poll_submit() fails with
+ * IPMI_ERR_DRIVER_BUSY until it completes.  Use ipmi_cmd_batch() to
+ * have several requests outstanding on one context.  Sessions are
+ * still opened with the blocking ipmi_ctx_open_outofband() or
+ * ipmi_ctx_open_outofband_2_0().  Only IPMI 1.5 and IPMI 2.0 LAN
+ * contexts without a bridging target are supported.
+ *
+ * ipmi_cmd_poll_submit() sends the request and returns.  The caller
+ * polls the file descriptor returned by ipmi_ctx_get_fd() for input,
+ * for at most the timeout returned by ipmi_cmd_poll_timeout(), and
+ * calls ipmi_cmd_poll_process() whenever the descriptor is readable
+ * or the timeout has expired.  ipmi_cmd_poll_process() receives and
+ * verifies the response, retransmits the request when due, and calls
+ * the callback once the command has completed or failed.  The
+ * callback may submit the next command.  While a command is
+ * outstanding, ipmi_cmd() and ipmi_cmd_raw() on the same context
+ * fail with IPMI_ERR_DRIVER_BUSY.
+ *
+ * errnum passed to the callback is IPMI_ERR_SUCCESS if a response
+ * was received into obj_cmd_rs, or the error the command failed
+ * with, e.g. IPMI_ERR_SESSION_TIMEOUT.  The completion code of the
+ * response is not checked.
+ */
+typedef void (*Ipmi_Cmd_Poll_Callback)(ipmi_ctx_t ctx,
+                                       int errnum,
+                                       fiid_obj_t obj_cmd_rs,
+                                       void *data);
+
+int ipmi_cmd_poll_submit (ipmi_ctx_t ctx,
+                          uint8_t lun,
+                          uint8_t net_fn,
+                          fiid_obj_t obj_cmd_rq,
+                          fiid_obj_t obj_cmd_rs,
+                          Ipmi_Cmd_Poll_Callback callback,
+                          void *callback_data);
+
+/* returns file descriptor to poll for input, -1 on error */
+int ipmi_ctx_get_fd (ipmi_ctx_t ctx);
+
+/* returns 1 and the milliseconds until ipmi_cmd_poll_process() must
+ * be called in timeout if a command is outstanding, 0 if no command
+ * is outstanding, -1 on error
+ */
+int ipmi_cmd_poll_timeout (ipmi_ctx_t ctx, unsigned int *timeout);
+
+/* returns 1 if the outstanding command completed and its callback
+ * was called, 0 if it is still outstanding or none is, -1 on error
+ */
+int ipmi_cmd_poll_process (ipmi_ctx_t ctx);
+
+/* drops the outstanding command, its callback is not called */
+int ipmi_cmd_poll_cancel (ipmi_ctx_t ctx);
+
 int ipmi_ctx_close (ipmi_ctx_t ctx);
 
 void ipmi_ctx_destroy (ipmi_ctx_t ctx);
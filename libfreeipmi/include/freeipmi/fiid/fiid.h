@@ -167,10 +167,24 @@ typedef struct fiid_field
  */
 typedef fiid_field_t fiid_template_t[];
 
+/*
+ * FIID Field Index
+ *
+ * A field resolved by fiid_template_field_index().  It remembers the
+ * template it was resolved against, treat it as opaque.
+ */
+typedef struct fiid_field_index
+{
+  const fiid_field_t *tmpl;
+  unsigned int index;
+} fiid_field_index_t;
+
 typedef struct fiid_obj *fiid_obj_t;
 
 typedef struct fiid_iterator *fiid_iterator_t;
 
+typedef struct fiid_arena *fiid_arena_t;
+
 /*****************************
 * FIID Template API         *
 *****************************/
@@ -195,6 +209,24 @@ int fiid_template_field_lookup (fiid_template_t tmpl,
 int FIID_TEMPLATE_FIELD_LOOKUP (fiid_template_t tmpl,
                                 const char *field);
 
+/*
+ * fiid_template_field_index
+ *
+ * Resolves the field in the template into index.  Returns 0 on
+ * success, -1 on error.  If the field is not found, -1 is returned
+ * and errno EINVAL is the error code set.  The index may be passed to
+ * the *_by_index functions below for any object created from the same
+ * template, avoiding a field name lookup on every access.  Objects
+ * created from a template with the same contents, such as a copy
+ * returned by fiid_obj_template(), are accepted after comparing the
+ * templates.  Objects created from any other template fail with
+ * FIID_ERR_PARAMETERS.  The template must remain valid while the
+ * index is used.
+ */
+int fiid_template_field_index (fiid_template_t tmpl,
+                               const char *field,
+                               fiid_field_index_t *index);
+
 /*
  * fiid_template_len
  *
@@ -334,17 +366,58 @@ char *fiid_strerror (fiid_err_t errnum);
  * fiid_obj_create
  *
  * Return a fiid object based on the specified template.  Returns NULL
- * on error.
+ * on error.  The parsed template is cached by address and shared
+ * between objects, a template with different contents at the same
+ * address is parsed again.
  */
 fiid_obj_t fiid_obj_create (fiid_template_t tmpl);
 
 /*
  * fiid_obj_destroy
  *
- * Destroy and free memory from a fiid object.
+ * Destroy and free memory from a fiid object.  Objects created in an
+ * arena return their memory to the arena.
  */
 void fiid_obj_destroy (fiid_obj_t obj);
 
+/*
+ * fiid_arena_create
+ *
+ * Create an arena that fiid objects may be created in.  Objects in
+ * an arena do not allocate memory of their own, so short lived
+ * request/response objects can be created and destroyed repeatedly
+ * without calls to malloc.  The arena is sized initially to 'size'
+ * bytes, or a default if 0, and grows as needed.  Arenas are not
+ * thread safe.  Returns NULL on error.
+ */
+fiid_arena_t fiid_arena_create (unsigned int size);
+
+/*
+ * fiid_arena_reset
+ *
+ * Destroy all objects created in the arena, making all of its memory
+ * available again.  Memory is also made available automatically once
+ * every object in the arena has been destroyed.  Returns 0 on
+ * success, -1 on error.
+ */
+int fiid_arena_reset (fiid_arena_t arena);
+
+/*
+ * fiid_arena_destroy
+ *
+ * Destroy all objects created in the arena and free the arena.
+ */
+void fiid_arena_destroy (fiid_arena_t arena);
+
+/*
+ * fiid_obj_create_in_arena
+ *
+ * Identical to fiid_obj_create() except the object is created in the
+ * specified arena.  The object must not be used after the arena is
+ * reset or destroyed.  Returns NULL on error.
+ */
+fiid_obj_t fiid_obj_create_in_arena (fiid_arena_t arena, fiid_template_t tmpl);
+
 /*
  * fiid_obj_dup
  *
@@ -575,6 +648,30 @@ int fiid_obj_get (fiid_obj_t obj, const char *field, uint64_t *val);
  */
 int FIID_OBJ_GET (fiid_obj_t obj, const char *field, uint64_t *val);
 
+/*
+ * fiid_obj_set_by_index
+ *
+ * Identical to fiid_obj_set() except the field is specified by an
+ * index returned from fiid_template_field_index().
+ */
+int fiid_obj_set_by_index (fiid_obj_t obj, fiid_field_index_t index, uint64_t val);
+
+/*
+ * fiid_obj_get_by_index
+ *
+ * Identical to fiid_obj_get() except the field is specified by an
+ * index returned from fiid_template_field_index().
+ */
+int fiid_obj_get_by_index (fiid_obj_t obj, fiid_field_index_t index, uint64_t *val);
+
+/*
+ * FIID_OBJ_GET_BY_INDEX
+ *
+ * Identical to FIID_OBJ_GET() except the field is specified by an
+ * index returned from fiid_template_field_index().
+ */
+int FIID_OBJ_GET_BY_INDEX (fiid_obj_t obj, fiid_field_index_t index, uint64_t *val);
+
 /*
  * fiid_obj_set_data
  *
@@ -602,6 +699,28 @@ int fiid_obj_get_data (fiid_obj_t obj,
                        void *data,
                        unsigned int data_len);
 
+/*
+ * fiid_obj_set_data_by_index
+ *
+ * Identical to fiid_obj_set_data() except the field is specified by
+ * an index returned from fiid_template_field_index().
+ */
+int fiid_obj_set_data_by_index (fiid_obj_t obj,
+                                fiid_field_index_t index,
+                                const void *data,
+                                unsigned int data_len);
+
+/*
+ * fiid_obj_get_data_by_index
+ *
+ * Identical to fiid_obj_get_data() except the field is specified by
+ * an index returned from fiid_template_field_index().
+ */
+int fiid_obj_get_data_by_index (fiid_obj_t obj,
+                                fiid_field_index_t index,
+                                void *data,
+                                unsigned int data_len);
+
 /*
  * fiid_obj_set_all
  *
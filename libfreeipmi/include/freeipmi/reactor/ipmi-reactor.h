@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_REACTOR_H
+#define IPMI_REACTOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <freeipmi/api/ipmi-api.h>
+#include <freeipmi/fiid/fiid.h>
+
+#define IPMI_REACTOR_ERR_SUCCESS           0
+#define IPMI_REACTOR_ERR_CONTEXT_NULL      1
+#define IPMI_REACTOR_ERR_CONTEXT_INVALID   2
+#define IPMI_REACTOR_ERR_PARAMETERS        3
+#define IPMI_REACTOR_ERR_OUT_OF_MEMORY     4
+#define IPMI_REACTOR_ERR_ALREADY_ADDED     5
+#define IPMI_REACTOR_ERR_NOT_FOUND         6
+#define IPMI_REACTOR_ERR_IPMI_ERROR        7
+#define IPMI_REACTOR_ERR_SYSTEM_ERROR      8
+#define IPMI_REACTOR_ERR_INTERNAL_ERROR    9
+#define IPMI_REACTOR_ERR_ERRNUMRANGE      10
+
+typedef struct ipmi_reactor_ctx *ipmi_reactor_ctx_t;
+
+/* The reactor runs commands queued on any number of LAN contexts
+ * from a single thread, using the polling interface (see
+ * ipmi_cmd_poll_submit()).  Commands for one context are sent one at
+ * a time in the order they were queued, commands for different
+ * contexts are outstanding together.  Sockets are waited on with
+ * epoll where available and retransmission and session timeouts are
+ * kept in a timer heap.
+ *
+ * The reactor does not open sessions.  Contexts must be opened
+ * beforehand with ipmi_ctx_open_outofband() or
+ * ipmi_ctx_open_outofband_2_0(), which block during session setup.
+ * Contexts opened with IPMI_FLAGS_NOSESSION require no network I/O
+ * to open.
+ *
+ * Contexts are not owned by the reactor and must not be used for
+ * other commands until the reactor is destroyed.
+ */
+
+/* Reactor Context Functions */
+ipmi_reactor_ctx_t ipmi_reactor_ctx_create (void);
+void ipmi_reactor_ctx_destroy (ipmi_reactor_ctx_t ctx);
+int ipmi_reactor_ctx_errnum (ipmi_reactor_ctx_t ctx);
+char *ipmi_reactor_ctx_strerror (int errnum);
+char *ipmi_reactor_ctx_errormsg (ipmi_reactor_ctx_t ctx);
+
+/* Reactor Functions */
+
+/* Add an opened IPMI 1.5 or IPMI 2.0 LAN context */
+int ipmi_reactor_add (ipmi_reactor_ctx_t ctx, ipmi_ctx_t ipmi_ctx);
+
+/* Queue a command on an added context.  obj_cmd_rq and obj_cmd_rs
+ * must remain valid until the callback is called.  The callback is
+ * called from ipmi_reactor_run() and may queue further commands.
+ *
+ * If the IPMI context fails to send the command, the callback is
+ * called immediately with the IPMI context's error.
+ */
+int ipmi_reactor_cmd (ipmi_reactor_ctx_t ctx,
+                      ipmi_ctx_t ipmi_ctx,
+                      uint8_t lun,
+                      uint8_t net_fn,
+                      fiid_obj_t obj_cmd_rq,
+                      fiid_obj_t obj_cmd_rs,
+                      Ipmi_Cmd_Poll_Callback callback,
+                      void *callback_data);
+
+/* Run until all queued and outstanding commands have completed.
+ * Returns 0 on success, -1 on error.
+ */
+int ipmi_reactor_run (ipmi_reactor_ctx_t ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IPMI_REACTOR_H */
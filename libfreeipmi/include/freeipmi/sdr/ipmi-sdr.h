@@ -48,6 +48,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <freeipmi/api/ipmi-api.h>
+#include <freeipmi/record-format/ipmi-sdr-record-format.h>
 
 #define IPMI_SDR_ERR_SUCCESS                                      0
 #define IPMI_SDR_ERR_CONTEXT_NULL                                 1
@@ -79,8 +80,20 @@ extern "C" {
 #define IPMI_SDR_ERR_INTERNAL_ERROR                               27
 #define IPMI_SDR_ERR_ERRNUMRANGE                                  28
 
+/* CACHE_INDEX - build an in memory index of the SDR cache in
+ * ipmi_sdr_cache_open() so ipmi_sdr_cache_seek(),
+ * ipmi_sdr_cache_search_record_id(), and
+ * ipmi_sdr_cache_search_sensor() do not walk the cache.  Takes
+ * effect on the next ipmi_sdr_cache_open().
+ *
+ * CACHE_SHARED - share the read only mapping of a cache file with
+ * every other context in the process that opened the same file with
+ * this flag, instead of mapping it once per context.
+ */
 #define IPMI_SDR_FLAGS_DEFAULT                   0x0000
 #define IPMI_SDR_FLAGS_DEBUG_DUMP                0x0001
+#define IPMI_SDR_FLAGS_CACHE_INDEX               0x0002
+#define IPMI_SDR_FLAGS_CACHE_SHARED              0x0004
 
 /* Flags just for cache creation
  *
@@ -91,11 +104,27 @@ extern "C" {
  * ASSUME_MAX_SDR_RECORD_COUNT - If motherboard does not implement SDR
  * record reading properly, this workaround will allow code to not
  * fail out.
+ *
+ * PIPELINE - keep several Get SDR requests outstanding at once,
+ * reading the remainder of one record alongside the header of the
+ * next, and grow the partial read size while the BMC accepts it.
+ * Only IPMI 2.0 LAN sessions pipeline requests, other interfaces
+ * issue them one at a time.  Falls back to plain sequential reads if
+ * the BMC misbehaves.
+ *
+ * INCREMENTAL - replace a previously created cache, copying records
+ * whose header on the BMC still matches the previous cache rather
+ * than downloading them again.  The new cache is written to a
+ * temporary file and renamed over the previous cache when complete.
+ * Changes to a record's body that leave its header intact are not
+ * detected.
  */
 #define IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT                     0x00
 #define IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE                   0x01
 #define IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID         0x02
 #define IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT 0x04
+#define IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE                    0x08
+#define IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL                 0x10
 
 #define IPMI_SDR_SENSOR_NAME_FLAGS_DEFAULT                       0x00000000
 #define IPMI_SDR_SENSOR_NAME_FLAGS_IGNORE_SHARED_SENSORS         0x00000001
@@ -232,6 +261,88 @@ int ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
                                        uint16_t *record_id,
                                        uint8_t *record_type);
 
+/* ipmi_sdr_parse_record_decoded
+ * - decodes all fields of a Full, Compact, or Event SDR record in one
+ *   pass.  Fields not found in the record type are zeroed.
+ * - id_string is NULL terminated, id_string_len does not include the
+ *   NULL.
+ * - returns IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD if the record is
+ *   too short to contain all fields before the id string.
+ */
+struct ipmi_sdr_record_decoded
+{
+  uint16_t record_id;
+  uint8_t record_type;
+
+  /* Full, Compact, Event */
+  uint8_t sensor_owner_id_type;
+  uint8_t sensor_owner_id;
+  uint8_t sensor_owner_lun;
+  uint8_t channel_number;
+  uint8_t sensor_number;
+  uint8_t entity_id;
+  uint8_t entity_instance;
+  uint8_t entity_instance_type;
+  uint8_t sensor_type;
+  uint8_t event_reading_type_code;
+  uint8_t sensor_direction;
+  char id_string[IPMI_SDR_MAX_ID_STRING_LENGTH + 1];
+  unsigned int id_string_len;
+
+  /* Full, Compact */
+  uint8_t event_message_control_support;
+  uint8_t threshold_access_support;
+  uint8_t hysteresis_support;
+  uint8_t auto_re_arm_support;
+  uint8_t entity_ignore_support;
+  uint16_t assertion_event_mask;
+  uint16_t deassertion_event_mask;
+  uint16_t reading_mask;
+  uint8_t sensor_units_percentage;
+  uint8_t sensor_units_modifier;
+  uint8_t sensor_units_rate;
+  uint8_t sensor_base_unit_type;
+  uint8_t sensor_modifier_unit_type;
+  uint8_t analog_data_format;
+  uint8_t positive_going_threshold_hysteresis;
+  uint8_t negative_going_threshold_hysteresis;
+
+  /* Full */
+  int8_t r_exponent;
+  int8_t b_exponent;
+  int16_t m;
+  int16_t b;
+  uint8_t linearization;
+  uint8_t tolerance;
+  uint16_t accuracy;
+  uint8_t accuracy_exp;
+  uint8_t nominal_reading_specified;
+  uint8_t normal_maximum_specified;
+  uint8_t normal_minimum_specified;
+  uint8_t nominal_reading;
+  uint8_t normal_maximum;
+  uint8_t normal_minimum;
+  uint8_t sensor_maximum_reading;
+  uint8_t sensor_minimum_reading;
+  uint8_t lower_non_critical_threshold;
+  uint8_t lower_critical_threshold;
+  uint8_t lower_non_recoverable_threshold;
+  uint8_t upper_non_critical_threshold;
+  uint8_t upper_critical_threshold;
+  uint8_t upper_non_recoverable_threshold;
+
+  /* Compact, Event */
+  uint8_t share_count;
+  uint8_t id_string_instance_modifier_type;
+  uint8_t id_string_instance_modifier_offset;
+  uint8_t entity_instance_sharing;
+};
+
+int ipmi_sdr_parse_record_decoded (ipmi_sdr_ctx_t ctx,
+                                   const void *sdr_record,
+                                   unsigned int sdr_record_len,
+                                   struct ipmi_sdr_record_decoded *decoded);
+
 /* For Full, Compact, Event SDR records */
 int ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
                                     const void *sdr_record,
@@ -596,6 +707,22 @@ int ipmi_sdr_parse_oem_data (ipmi_sdr_ctx_t ctx,
 
 int ipmi_sdr_cache_delete (ipmi_sdr_ctx_t ctx, const char *filename);
 
+/* ipmi_sdr_cache_key
+ * - Writes a key identifying the SDR repository of the BMC behind
+ *   ipmi_ctx into buf: manufacturer id, product id, SDR version,
+ *   record count, and most recent addition/erase timestamps.
+ * - BMCs returning the same key are assumed to hold identical SDRs,
+ *   so the key may be used to name a cache shared between them.
+ * - The key is usable as a filename component.  buflen should be
+ *   atleast IPMI_SDR_CACHE_KEY_BUFLEN.
+ */
+#define IPMI_SDR_CACHE_KEY_BUFLEN 64
+
+int ipmi_sdr_cache_key (ipmi_sdr_ctx_t ctx,
+                        ipmi_ctx_t ipmi_ctx,
+                        char *buf,
+                        unsigned int buflen);
+
 /* ipmi_sensor_parse_sensor_name_string
  * - Wrapper that will return id_string or device_id_string dependent
  *   on SDR type.
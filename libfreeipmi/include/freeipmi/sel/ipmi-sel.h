@@ -49,9 +49,15 @@ extern "C" {
 #define IPMI_SEL_ERR_INTERNAL_ERROR                         17
 #define IPMI_SEL_ERR_ERRNUMRANGE                            18
 
+/* PIPELINE - when parsing the SEL, keep Get SEL Entry requests for
+ * the following record ids outstanding alongside the current one.
+ * Only IPMI 2.0 LAN sessions pipeline requests, this flag is ignored
+ * on other interfaces.
+ */
 #define IPMI_SEL_FLAGS_DEFAULT                              0x0000
 #define IPMI_SEL_FLAGS_DEBUG_DUMP                           0x0001
 #define IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS           0x0002
+#define IPMI_SEL_FLAGS_PIPELINE                             0x0004
 
 #define IPMI_SEL_PARAMETER_INTERPRET_CONTEXT                0x0001
 #define IPMI_SEL_PARAMETER_UTC_OFFSET                       0x0002
@@ -180,6 +186,23 @@ int ipmi_sel_ctx_set_separator (ipmi_sel_ctx_t ctx, const char *separator);
 int ipmi_sel_ctx_register_reservation_id (ipmi_sel_ctx_t ctx, uint16_t *reservation_id);
 int ipmi_sel_ctx_clear_reservation_id (ipmi_sel_ctx_t ctx);
 
+/*
+ * SEL Mirror Functions
+ */
+
+/* ipmi_sel_sync
+ * - Maintains an append-only local copy of the SEL in filename and
+ *   binds it to the context.  Subsequent calls to ipmi_sel_parse()
+ *   bring the mirror up to date and parse from it.
+ * - When the SEL has not changed since the last sync, only a Get SEL
+ *   Info request is sent.  When records have been added, only the
+ *   new records are read.  The mirror is rebuilt if the SEL was
+ *   cleared or older entries were overwritten.
+ * - Pass a NULL filename to stop using a mirror.
+ * - Returns the number of records read from the BMC
+ */
+int ipmi_sel_sync (ipmi_sel_ctx_t ctx, const char *filename);
+
 /*
  * SEL Parse Functions
  */
@@ -108,6 +108,33 @@ int ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
                       double **sensor_reading,
                       uint16_t *sensor_event_bitmask);
 
+/* Sensor read sweep
+ *
+ * ipmi_sensor_read_sweep_add() queues the sensor of an SDR record,
+ * arguments as for ipmi_sensor_read().  ipmi_sensor_read_sweep()
+ * then issues the Get Sensor Reading requests of all queued sensors
+ * at once, pipelined within the session (see ipmi_cmd_batch()), and
+ * keeps the responses.  A later ipmi_sensor_read() of a swept sensor
+ * uses its response instead of issuing a request, so callers may
+ * sweep all sensors first and still output them in their usual
+ * order.  Each response is used at most once.
+ *
+ * Only sensors owned by the BMC are swept.  Sensors that must be
+ * bridged are skipped by ipmi_sensor_read_sweep_add() and are read
+ * one at a time by ipmi_sensor_read() as before.  On interfaces that
+ * cannot pipeline requests ipmi_sensor_read_sweep() does nothing.
+ *
+ * ipmi_sensor_read_sweep_clear() drops unused responses.
+ */
+int ipmi_sensor_read_sweep_add (ipmi_sensor_read_ctx_t ctx,
+                                const void *sdr_record,
+                                unsigned int sdr_record_len,
+                                uint8_t shared_sensor_number_offset);
+
+int ipmi_sensor_read_sweep (ipmi_sensor_read_ctx_t ctx);
+
+int ipmi_sensor_read_sweep_clear (ipmi_sensor_read_ctx_t ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,9 @@
 #include <limits.h>
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/cmds/ipmi-messaging-support-cmds.h"
 #include "freeipmi/fiid/fiid.h"
@@ -96,6 +99,74 @@ fiid_template_t tmpl_lan_msg_trlr =
     { 0, "", 0}
   };
 
+/* Field indexes for the packet headers and trailers, resolved once
+ * so packet assembly does not look up fields by name per packet.
+ */
+struct ipmi_lan_field_index
+{
+  fiid_field_index_t msg_hdr_rq_checksum1;
+  fiid_field_index_t msg_hdr_rq_net_fn;
+  fiid_field_index_t msg_hdr_rq_rq_addr;
+  fiid_field_index_t msg_hdr_rq_rq_lun;
+  fiid_field_index_t msg_hdr_rq_rq_seq;
+  fiid_field_index_t msg_hdr_rq_rs_addr;
+  fiid_field_index_t msg_hdr_rq_rs_lun;
+  fiid_field_index_t session_hdr_authentication_code;
+  fiid_field_index_t session_hdr_authentication_type;
+  fiid_field_index_t session_hdr_ipmi_msg_len;
+  fiid_field_index_t session_hdr_session_id;
+  fiid_field_index_t session_hdr_session_sequence_number;
+};
+
+static struct ipmi_lan_field_index lan_field_index;
+
+static struct fiid_field_index_map lan_field_index_map[] =
+  {
+    { tmpl_lan_msg_hdr_rq, "checksum1", &lan_field_index.msg_hdr_rq_checksum1 },
+    { tmpl_lan_msg_hdr_rq, "net_fn", &lan_field_index.msg_hdr_rq_net_fn },
+    { tmpl_lan_msg_hdr_rq, "rq_addr", &lan_field_index.msg_hdr_rq_rq_addr },
+    { tmpl_lan_msg_hdr_rq, "rq_lun", &lan_field_index.msg_hdr_rq_rq_lun },
+    { tmpl_lan_msg_hdr_rq, "rq_seq", &lan_field_index.msg_hdr_rq_rq_seq },
+    { tmpl_lan_msg_hdr_rq, "rs_addr", &lan_field_index.msg_hdr_rq_rs_addr },
+    { tmpl_lan_msg_hdr_rq, "rs_lun", &lan_field_index.msg_hdr_rq_rs_lun },
+    { tmpl_lan_session_hdr, "authentication_code", &lan_field_index.session_hdr_authentication_code },
+    { tmpl_lan_session_hdr, "authentication_type", &lan_field_index.session_hdr_authentication_type },
+    { tmpl_lan_session_hdr, "ipmi_msg_len", &lan_field_index.session_hdr_ipmi_msg_len },
+    { tmpl_lan_session_hdr, "session_id", &lan_field_index.session_hdr_session_id },
+    { tmpl_lan_session_hdr, "session_sequence_number", &lan_field_index.session_hdr_session_sequence_number },
+    { NULL, NULL, NULL }
+  };
+
+static pthread_once_t lan_field_index_once = PTHREAD_ONCE_INIT;
+static int lan_field_index_errnum = 0;
+
+static void
+_lan_field_index_init (void)
+{
+  if (resolve_fiid_field_indexes (lan_field_index_map) < 0)
+    lan_field_index_errnum = errno ? errno : EINVAL;
+}
+
+static int
+_lan_field_index_resolve (void)
+{
+  int perr;
+
+  if ((perr = pthread_once (&lan_field_index_once, _lan_field_index_init)))
+    {
+      SET_ERRNO (perr);
+      return (-1);
+    }
+
+  if (lan_field_index_errnum)
+    {
+      SET_ERRNO (lan_field_index_errnum);
+      return (-1);
+    }
+
+  return (0);
+}
+
 int
 fill_lan_session_hdr (uint8_t authentication_type,
                       uint32_t session_sequence_number,
@@ -115,10 +186,13 @@ fill_lan_session_hdr (uint8_t authentication_type,
       return (-1);
     }
 
+  if (_lan_field_index_resolve () < 0)
+    return (-1);
+
   FILL_FIID_OBJ_CLEAR (obj_lan_session_hdr);
-  FILL_FIID_OBJ_SET (obj_lan_session_hdr, "authentication_type", authentication_type);
-  FILL_FIID_OBJ_SET (obj_lan_session_hdr, "session_sequence_number", session_sequence_number);
-  FILL_FIID_OBJ_SET (obj_lan_session_hdr, "session_id", session_id);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_session_hdr, lan_field_index.session_hdr_authentication_type, authentication_type);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_session_hdr, lan_field_index.session_hdr_session_sequence_number, session_sequence_number);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_session_hdr, lan_field_index.session_hdr_session_id, session_id);
 
   /* authentication_code_data calculated in assemble_ipmi_lan_pkt */
   /* ipmi_msg_len calculated in assemble_ipmi_lan_pkt */
@@ -152,10 +226,13 @@ fill_lan_msg_hdr (uint8_t rs_addr,
       return (-1);
     }
 
+  if (_lan_field_index_resolve () < 0)
+    return (-1);
+
   FILL_FIID_OBJ_CLEAR (obj_lan_msg_hdr);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "rs_addr", rs_addr);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "net_fn", net_fn);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "rs_lun", rs_lun);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_rs_addr, rs_addr);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_net_fn, net_fn);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_rs_lun, rs_lun);
 
   if ((checksum_len = fiid_obj_get_block (obj_lan_msg_hdr,
                                           "rs_addr",
@@ -168,10 +245,10 @@ fill_lan_msg_hdr (uint8_t rs_addr,
     }
 
   checksum = ipmi_checksum (checksum_buf, checksum_len);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "checksum1", checksum);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "rq_addr", IPMI_LAN_SOFTWARE_ID_REMOTE_CONSOLE_SOFTWARE);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "rq_lun", IPMI_BMC_IPMB_LUN_BMC);
-  FILL_FIID_OBJ_SET (obj_lan_msg_hdr, "rq_seq", rq_seq);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_checksum1, checksum);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_rq_addr, IPMI_LAN_SOFTWARE_ID_REMOTE_CONSOLE_SOFTWARE);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_rq_lun, IPMI_BMC_IPMB_LUN_BMC);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_lan_msg_hdr, lan_field_index.msg_hdr_rq_rq_seq, rq_seq);
 
   return (0);
 }
@@ -306,6 +383,9 @@ assemble_ipmi_lan_pkt (fiid_obj_t obj_rmcp_hdr,
       return (-1);
     }
 
+  if (_lan_field_index_resolve () < 0)
+    return (-1);
+
   if (FIID_OBJ_PACKET_VALID (obj_rmcp_hdr) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcp_hdr);
@@ -329,9 +409,9 @@ assemble_ipmi_lan_pkt (fiid_obj_t obj_rmcp_hdr,
       return (-1);
     }
 
-  if (FIID_OBJ_GET (obj_lan_session_hdr,
-                    "authentication_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_lan_session_hdr,
+                             lan_field_index.session_hdr_authentication_type,
+                             &val) < 0)
     {
       ERRNO_TRACE (errno);
       return (-1);
@@ -481,10 +561,10 @@ assemble_ipmi_lan_pkt (fiid_obj_t obj_rmcp_hdr,
 
       if (authentication_len)
         {
-          if (fiid_obj_get_data (obj_lan_session_hdr,
-                                 "authentication_code",
-                                 pwbuf,
-                                 IPMI_1_5_MAX_PASSWORD_LENGTH) < 0)
+          if (fiid_obj_get_data_by_index (obj_lan_session_hdr,
+                                          lan_field_index.session_hdr_authentication_code,
+                                          pwbuf,
+                                          IPMI_1_5_MAX_PASSWORD_LENGTH) < 0)
             {
               FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
               goto cleanup;
@@ -513,19 +593,19 @@ assemble_ipmi_lan_pkt (fiid_obj_t obj_rmcp_hdr,
               uint8_t session_sequence_number_buf[1024];
               int session_id_len, session_sequence_number_len;
 
-              if ((session_id_len = fiid_obj_get_data (obj_lan_session_hdr,
-                                                       "session_id",
-                                                       session_id_buf,
-                                                       1024)) < 0)
+              if ((session_id_len = fiid_obj_get_data_by_index (obj_lan_session_hdr,
+                                                                lan_field_index.session_hdr_session_id,
+                                                                session_id_buf,
+                                                                1024)) < 0)
                 {
                   FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
                   goto cleanup;
                 }
 
-              if ((session_sequence_number_len = fiid_obj_get_data (obj_lan_session_hdr,
-                                                                    "session_sequence_number",
-                                                                    session_sequence_number_buf,
-                                                                    1024)) < 0)
+              if ((session_sequence_number_len = fiid_obj_get_data_by_index (obj_lan_session_hdr,
+                                                                             lan_field_index.session_hdr_session_sequence_number,
+                                                                             session_sequence_number_buf,
+                                                                             1024)) < 0)
                 {
                   FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
                   goto cleanup;
@@ -656,6 +736,9 @@ unassemble_ipmi_lan_pkt (const void *pkt,
       return (-1);
     }
 
+  if (_lan_field_index_resolve () < 0)
+    return (-1);
+
   indx = 0;
   if (fiid_obj_clear (obj_rmcp_hdr) < 0)
     {
@@ -712,9 +795,9 @@ unassemble_ipmi_lan_pkt (const void *pkt,
     }
   indx += len;
 
-  if (FIID_OBJ_GET (obj_lan_session_hdr,
-                    "authentication_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_lan_session_hdr,
+                             lan_field_index.session_hdr_authentication_type,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
       return (-1);
@@ -730,10 +813,10 @@ unassemble_ipmi_lan_pkt (const void *pkt,
 
   if (authentication_type != IPMI_AUTHENTICATION_TYPE_NONE)
     {
-      if ((len = fiid_obj_set_data (obj_lan_session_hdr,
-                                    "authentication_code",
-                                    pkt + indx,
-                                    pkt_len - indx)) < 0)
+      if ((len = fiid_obj_set_data_by_index (obj_lan_session_hdr,
+                                             lan_field_index.session_hdr_authentication_code,
+                                             pkt + indx,
+                                             pkt_len - indx)) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
           return (-1);
@@ -748,10 +831,10 @@ unassemble_ipmi_lan_pkt (const void *pkt,
         }
     }
 
-  if ((len = fiid_obj_set_data (obj_lan_session_hdr,
-                                "ipmi_msg_len",
-                                pkt + indx,
-                                pkt_len - indx)) < 0)
+  if ((len = fiid_obj_set_data_by_index (obj_lan_session_hdr,
+                                         lan_field_index.session_hdr_ipmi_msg_len,
+                                         pkt + indx,
+                                         pkt_len - indx)) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_lan_session_hdr);
       return (-1);
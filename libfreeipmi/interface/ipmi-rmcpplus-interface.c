@@ -28,6 +28,9 @@
 #include <limits.h>
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/interface/ipmi-rmcpplus-interface.h"
 #include "freeipmi/cmds/ipmi-messaging-support-cmds.h"
@@ -212,6 +215,86 @@ fiid_template_t tmpl_rmcpplus_rakp_message_4 =
     { 0, "", 0}
   };
 
+/* Field indexes for the packet headers and trailers, resolved once
+ * so packet assembly does not look up fields by name per packet.
+ */
+struct ipmi_rmcpplus_field_index
+{
+  fiid_field_index_t payload_confidentiality_header;
+  fiid_field_index_t payload_confidentiality_trailer;
+  fiid_field_index_t payload_data;
+  fiid_field_index_t session_hdr_authentication_type;
+  fiid_field_index_t session_hdr_ipmi_payload_len;
+  fiid_field_index_t session_hdr_oem_iana;
+  fiid_field_index_t session_hdr_oem_payload_id;
+  fiid_field_index_t session_hdr_payload_type;
+  fiid_field_index_t session_hdr_payload_type_authenticated;
+  fiid_field_index_t session_hdr_payload_type_encrypted;
+  fiid_field_index_t session_hdr_reserved1;
+  fiid_field_index_t session_hdr_reserved2;
+  fiid_field_index_t session_hdr_session_id;
+  fiid_field_index_t session_hdr_session_sequence_number;
+  fiid_field_index_t session_trlr_authentication_code;
+  fiid_field_index_t session_trlr_integrity_pad;
+  fiid_field_index_t session_trlr_next_header;
+  fiid_field_index_t session_trlr_pad_length;
+};
+
+static struct ipmi_rmcpplus_field_index rmcpplus_field_index;
+
+static struct fiid_field_index_map rmcpplus_field_index_map[] =
+  {
+    { tmpl_rmcpplus_payload, "confidentiality_header", &rmcpplus_field_index.payload_confidentiality_header },
+    { tmpl_rmcpplus_payload, "confidentiality_trailer", &rmcpplus_field_index.payload_confidentiality_trailer },
+    { tmpl_rmcpplus_payload, "payload_data", &rmcpplus_field_index.payload_data },
+    { tmpl_rmcpplus_session_hdr, "authentication_type", &rmcpplus_field_index.session_hdr_authentication_type },
+    { tmpl_rmcpplus_session_hdr, "ipmi_payload_len", &rmcpplus_field_index.session_hdr_ipmi_payload_len },
+    { tmpl_rmcpplus_session_hdr, "oem_iana", &rmcpplus_field_index.session_hdr_oem_iana },
+    { tmpl_rmcpplus_session_hdr, "oem_payload_id", &rmcpplus_field_index.session_hdr_oem_payload_id },
+    { tmpl_rmcpplus_session_hdr, "payload_type", &rmcpplus_field_index.session_hdr_payload_type },
+    { tmpl_rmcpplus_session_hdr, "payload_type.authenticated", &rmcpplus_field_index.session_hdr_payload_type_authenticated },
+    { tmpl_rmcpplus_session_hdr, "payload_type.encrypted", &rmcpplus_field_index.session_hdr_payload_type_encrypted },
+    { tmpl_rmcpplus_session_hdr, "reserved1", &rmcpplus_field_index.session_hdr_reserved1 },
+    { tmpl_rmcpplus_session_hdr, "reserved2", &rmcpplus_field_index.session_hdr_reserved2 },
+    { tmpl_rmcpplus_session_hdr, "session_id", &rmcpplus_field_index.session_hdr_session_id },
+    { tmpl_rmcpplus_session_hdr, "session_sequence_number", &rmcpplus_field_index.session_hdr_session_sequence_number },
+    { tmpl_rmcpplus_session_trlr, "authentication_code", &rmcpplus_field_index.session_trlr_authentication_code },
+    { tmpl_rmcpplus_session_trlr, "integrity_pad", &rmcpplus_field_index.session_trlr_integrity_pad },
+    { tmpl_rmcpplus_session_trlr, "next_header", &rmcpplus_field_index.session_trlr_next_header },
+    { tmpl_rmcpplus_session_trlr, "pad_length", &rmcpplus_field_index.session_trlr_pad_length },
+    { NULL, NULL, NULL }
+  };
+
+static pthread_once_t rmcpplus_field_index_once = PTHREAD_ONCE_INIT;
+static int rmcpplus_field_index_errnum = 0;
+
+static void
+_rmcpplus_field_index_init (void)
+{
+  if (resolve_fiid_field_indexes (rmcpplus_field_index_map) < 0)
+    rmcpplus_field_index_errnum = errno ? errno : EINVAL;
+}
+
+static int
+_rmcpplus_field_index_resolve (void)
+{
+  int perr;
+
+  if ((perr = pthread_once (&rmcpplus_field_index_once, _rmcpplus_field_index_init)))
+    {
+      SET_ERRNO (perr);
+      return (-1);
+    }
+
+  if (rmcpplus_field_index_errnum)
+    {
+      SET_ERRNO (rmcpplus_field_index_errnum);
+      return (-1);
+    }
+
+  return (0);
+}
+
 int
 ipmi_rmcpplus_init (void)
 {
@@ -250,21 +333,24 @@ fill_rmcpplus_session_hdr (uint8_t payload_type,
       return (-1);
     }
 
+  if (_rmcpplus_field_index_resolve () < 0)
+    return (-1);
+
   FILL_FIID_OBJ_CLEAR (obj_rmcpplus_session_hdr);
 
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "authentication_type", IPMI_AUTHENTICATION_TYPE_RMCPPLUS);
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "reserved1", 0);
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "payload_type", payload_type);
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "payload_type.authenticated", payload_authenticated);
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "payload_type.encrypted", payload_encrypted);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_authentication_type, IPMI_AUTHENTICATION_TYPE_RMCPPLUS);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_reserved1, 0);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_payload_type, payload_type);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_payload_type_authenticated, payload_authenticated);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_payload_type_encrypted, payload_encrypted);
   if (payload_type == IPMI_PAYLOAD_TYPE_OEM_EXPLICIT)
     {
-      FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "oem_iana", oem_iana);
-      FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "reserved2", 0);
-      FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "oem_payload_id", oem_payload_id);
+      FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_oem_iana, oem_iana);
+      FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_reserved2, 0);
+      FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_oem_payload_id, oem_payload_id);
     }
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "session_id", session_id);
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_hdr, "session_sequence_number", session_sequence_number);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_session_id, session_id);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_hdr, rmcpplus_field_index.session_hdr_session_sequence_number, session_sequence_number);
 
   /* ipmi_payload_len will be calculated during packet assembly */
 
@@ -286,6 +372,9 @@ fill_rmcpplus_session_trlr (fiid_obj_t obj_rmcpplus_session_trlr)
       return (-1);
     }
 
+  if (_rmcpplus_field_index_resolve () < 0)
+    return (-1);
+
   FILL_FIID_OBJ_CLEAR (obj_rmcpplus_session_trlr);
 
   /* Computing hashes and checking for correct input is done during
@@ -293,7 +382,7 @@ fill_rmcpplus_session_trlr (fiid_obj_t obj_rmcpplus_session_trlr)
    * during packet assembly.
    */
 
-  FILL_FIID_OBJ_SET (obj_rmcpplus_session_trlr, "next_header", IPMI_NEXT_HEADER);
+  FILL_FIID_OBJ_SET_BY_INDEX (obj_rmcpplus_session_trlr, rmcpplus_field_index.session_trlr_next_header, IPMI_NEXT_HEADER);
 
   return (0);
 }
@@ -712,10 +801,10 @@ _construct_payload_confidentiality_none (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         payload_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  payload_buf,
+                                  payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -845,28 +934,28 @@ _construct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_header",
-                         iv,
-                         IPMI_CRYPT_AES_CBC_128_IV_LENGTH) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_confidentiality_header,
+                                  iv,
+                                  IPMI_CRYPT_AES_CBC_128_IV_LENGTH) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         payload_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  payload_buf,
+                                  payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_trailer",
-                         payload_buf + payload_len,
-                         pad_len + 1) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_confidentiality_trailer,
+                                  payload_buf + payload_len,
+                                  pad_len + 1) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -905,10 +994,10 @@ _construct_payload_rakp (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         obj_cmd_buf,
-                         obj_cmd_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  obj_cmd_buf,
+                                  obj_cmd_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -1003,19 +1092,19 @@ _construct_session_trlr_pad (uint8_t integrity_algorithm,
 
   if (pad_length)
     {
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "integrity_pad",
-                             pad_bytes,
-                             pad_length) < 0)
+      if (fiid_obj_set_data_by_index (obj_rmcpplus_session_trlr,
+                                      rmcpplus_field_index.session_trlr_integrity_pad,
+                                      pad_bytes,
+                                      pad_length) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
     }
 
-  if (fiid_obj_set (obj_rmcpplus_session_trlr,
-                    "pad_length",
-                    pad_length) < 0)
+  if (fiid_obj_set_by_index (obj_rmcpplus_session_trlr,
+                             rmcpplus_field_index.session_trlr_pad_length,
+                             pad_length) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
       return (-1);
@@ -1097,10 +1186,10 @@ _construct_session_trlr_authentication_code (uint8_t integrity_algorithm,
 
   if (len)
     {
-      if ((len = fiid_obj_get_data (obj_rmcpplus_session_trlr,
-                                    "authentication_code",
-                                    authentication_code_buf,
-                                    authentication_code_buf_len)) < 0)
+      if ((len = fiid_obj_get_data_by_index (obj_rmcpplus_session_trlr,
+                                             rmcpplus_field_index.session_trlr_authentication_code,
+                                             authentication_code_buf,
+                                             authentication_code_buf_len)) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -1278,6 +1367,9 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (-1);
     }
 
+  if (_rmcpplus_field_index_resolve () < 0)
+    return (-1);
+
   if (FIID_OBJ_PACKET_VALID (obj_rmcp_hdr) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcp_hdr);
@@ -1294,45 +1386,45 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
    * a ipmi_payload_len is required but may not be set yet.
    */
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_type = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.authenticated",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type_authenticated,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_authenticated = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.encrypted",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type_encrypted,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_encrypted = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_id",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_session_id,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_id = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_sequence_number",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_session_sequence_number,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -1552,9 +1644,9 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       goto cleanup;
     }
 
-  if (fiid_obj_set (obj_session_hdr_temp,
-                    "ipmi_payload_len",
-                    payload_len) < 0)
+  if (fiid_obj_set_by_index (obj_session_hdr_temp,
+                             rmcpplus_field_index.session_hdr_ipmi_payload_len,
+                             payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_session_hdr_temp);
       goto cleanup;
@@ -1839,10 +1931,10 @@ _deconstruct_payload_confidentiality_none (uint8_t payload_type,
   if (!ret)
     return (0);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         pkt,
-                         ipmi_payload_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  pkt,
+                                  ipmi_payload_len) < 0)
 
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
@@ -1935,10 +2027,10 @@ _deconstruct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
   indx += IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH;
   memcpy (payload_buf, pkt + indx, payload_data_len);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_header",
-                         iv,
-                         IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_confidentiality_header,
+                                  iv,
+                                  IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -1987,19 +2079,19 @@ _deconstruct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
       return (0);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         cmd_data_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  payload_buf,
+                                  cmd_data_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_trailer",
-                         payload_buf + cmd_data_len,
-                         pad_length + 1), 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_confidentiality_trailer,
+                                  payload_buf + cmd_data_len,
+                                  pad_length + 1), 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -2038,10 +2130,10 @@ _deconstruct_payload_rakp (uint8_t payload_type,
           && pkt
           && ipmi_payload_len);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         pkt,
-                         ipmi_payload_len) < 0)
+  if (fiid_obj_set_data_by_index (obj_rmcpplus_payload,
+                                  rmcpplus_field_index.payload_data,
+                                  pkt,
+                                  ipmi_payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -2186,6 +2278,9 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (-1);
     }
 
+  if (_rmcpplus_field_index_resolve () < 0)
+    return (-1);
+
   if (fiid_obj_clear (obj_rmcp_hdr) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcp_hdr);
@@ -2250,9 +2345,9 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (0);
     }
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -2321,45 +2416,45 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (0);
     }
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.authenticated",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type_authenticated,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_authenticated = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.encrypted",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_payload_type_encrypted,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_encrypted = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_id",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_session_id,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_id = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_sequence_number",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_session_sequence_number,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_sequence_number = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "ipmi_payload_len",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_hdr,
+                             rmcpplus_field_index.session_hdr_ipmi_payload_len,
+                             &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -2542,37 +2637,37 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
 
       if (authentication_code_len)
         {
-          if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                                 "authentication_code",
-                                 pkt + indx + ((pkt_len - indx) - authentication_code_len),
-                                 authentication_code_len) < 0)
+          if (fiid_obj_set_data_by_index (obj_rmcpplus_session_trlr,
+                                          rmcpplus_field_index.session_trlr_authentication_code,
+                                          pkt + indx + ((pkt_len - indx) - authentication_code_len),
+                                          authentication_code_len) < 0)
             {
               FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
               return (-1);
             }
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "next_header",
-                             pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len),
-                             next_header_field_len) < 0)
+      if (fiid_obj_set_data_by_index (obj_rmcpplus_session_trlr,
+                                      rmcpplus_field_index.session_trlr_next_header,
+                                      pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len),
+                                      next_header_field_len) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "pad_length",
-                             pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len - pad_length_field_len),
-                             pad_length_field_len) < 0)
+      if (fiid_obj_set_data_by_index (obj_rmcpplus_session_trlr,
+                                      rmcpplus_field_index.session_trlr_pad_length,
+                                      pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len - pad_length_field_len),
+                                      pad_length_field_len) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
 
-      if (FIID_OBJ_GET (obj_rmcpplus_session_trlr,
-                        "pad_length",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_INDEX (obj_rmcpplus_session_trlr,
+                                 rmcpplus_field_index.session_trlr_pad_length,
+                                 &val) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -2592,10 +2687,10 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
           pad_length = (pkt_len - indx - authentication_code_len - pad_length_field_len - next_header_field_len);
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "integrity_pad",
-                             pkt + indx,
-                             pad_length) < 0)
+      if (fiid_obj_set_data_by_index (obj_rmcpplus_session_trlr,
+                                      rmcpplus_field_index.session_trlr_integrity_pad,
+                                      pkt + indx,
+                                      pad_length) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -70,3 +70,26 @@ set_errno_by_fiid_iterator (fiid_iterator_t iter)
   else
     errno = EINVAL;
 }
+
+int
+resolve_fiid_field_indexes (struct fiid_field_index_map *map)
+{
+  unsigned int i;
+
+  if (!map)
+    {
+      SET_ERRNO (EINVAL);
+      return (-1);
+    }
+
+  for (i = 0; map[i].tmpl; i++)
+    {
+      if (fiid_template_field_index (map[i].tmpl, map[i].field, map[i].index) < 0)
+        {
+          ERRNO_TRACE (errno);
+          return (-1);
+        }
+    }
+
+  return (0);
+}
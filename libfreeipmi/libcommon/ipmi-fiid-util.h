@@ -36,4 +36,19 @@ void set_errno_by_fiid_object (fiid_obj_t obj);
 
 void set_errno_by_fiid_iterator (fiid_iterator_t iter);
 
+/* Maps a template field to where its index should be stored.  Arrays
+ * are terminated by an entry with a NULL template.
+ */
+struct fiid_field_index_map
+{
+  fiid_field_t *tmpl;
+  const char *field;
+  fiid_field_index_t *index;
+};
+
+/* Resolve all field indexes in the map via
+ * fiid_template_field_index().  Returns 0 on success, -1 on error.
+ */
+int resolve_fiid_field_indexes (struct fiid_field_index_map *map);
+
 #endif /* IPMI_FIID_UTIL_H */
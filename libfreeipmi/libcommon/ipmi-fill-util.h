@@ -58,4 +58,13 @@
       }                                                                     \
   } while (0)
 
+#define FILL_FIID_OBJ_SET_BY_INDEX(__obj, __index, __val)         \
+  do {                                                            \
+    if (fiid_obj_set_by_index ((__obj), (__index), (__val)) < 0)  \
+      {                                                           \
+        FIID_OBJECT_ERROR_TO_ERRNO ((__obj));                     \
+        return (-1);                                              \
+      }                                                           \
+  } while (0)
+
 #endif /* IPMI_FILL_UTIL_H */
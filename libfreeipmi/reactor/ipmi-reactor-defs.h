@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_REACTOR_DEFS_H
+#define IPMI_REACTOR_DEFS_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdint.h>
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif /* !HAVE_SYS_TIME_H */
+#endif  /* !TIME_WITH_SYS_TIME */
+
+#include "freeipmi/api/ipmi-api.h"
+#include "freeipmi/fiid/fiid.h"
+#include "freeipmi/reactor/ipmi-reactor.h"
+
+#include "hash.h"
+#include "list.h"
+
+#define IPMI_REACTOR_CTX_MAGIC 0x5eac7012
+
+#define IPMI_REACTOR_HOSTS_HASH_SIZE 1024
+
+#define IPMI_REACTOR_TIMERS_SIZE_INIT 64
+
+#define IPMI_REACTOR_EPOLL_MAX_EVENTS 256
+
+struct ipmi_reactor_cmd {
+  uint8_t lun;
+  uint8_t net_fn;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+  Ipmi_Cmd_Poll_Callback callback;
+  void *callback_data;
+};
+
+struct ipmi_reactor_host {
+  struct ipmi_reactor_ctx *ctx;
+  ipmi_ctx_t ipmi_ctx;
+  int fd;
+  /* queued commands, the first one is outstanding if outstanding set */
+  List cmds;
+  int outstanding;
+  /* timer heap position, -1 if not in the heap */
+  int timer_index;
+  struct timeval deadline;
+};
+
+struct ipmi_reactor_ctx {
+  uint32_t magic;
+  int errnum;
+  hash_t hosts;
+  /* min heap of hosts with an outstanding command, by deadline */
+  struct ipmi_reactor_host **timers;
+  unsigned int timers_count;
+  unsigned int timers_size;
+  unsigned int cmds_count;
+  int epfd;
+};
+
+#endif /* IPMI_REACTOR_DEFS_H */
@@ -0,0 +1,835 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <sys/types.h>
+#include <sys/poll.h>
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif /* HAVE_SYS_EPOLL_H */
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/reactor/ipmi-reactor.h"
+#include "freeipmi/api/ipmi-api.h"
+
+#include "ipmi-reactor-defs.h"
+#include "ipmi-reactor-trace.h"
+#include "ipmi-reactor-util.h"
+
+#include "freeipmi-portability.h"
+
+static char *ipmi_reactor_errmsgs[] =
+  {
+    "success",
+    "context null",
+    "context invalid",
+    "invalid parameters",
+    "out of memory",
+    "ipmi context already added",
+    "ipmi context not found",
+    "ipmi error",
+    "system error",
+    "internal error",
+    "errnum out of range",
+    NULL
+  };
+
+static unsigned int
+_hosts_hash_key (const void *key)
+{
+  unsigned long val = (unsigned long)key;
+
+  /* low bits of a pointer are always zero */
+  return ((unsigned int)((val >> 4) ^ (val >> 16)));
+}
+
+static int
+_hosts_hash_cmp (const void *key1, const void *key2)
+{
+  return (key1 != key2);
+}
+
+ipmi_reactor_ctx_t
+ipmi_reactor_ctx_create (void)
+{
+  struct ipmi_reactor_ctx *ctx = NULL;
+
+  if (!(ctx = (ipmi_reactor_ctx_t)malloc (sizeof (struct ipmi_reactor_ctx))))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+  memset (ctx, '\0', sizeof (struct ipmi_reactor_ctx));
+  ctx->magic = IPMI_REACTOR_CTX_MAGIC;
+  ctx->epfd = -1;
+
+  if (!(ctx->hosts = hash_create (IPMI_REACTOR_HOSTS_HASH_SIZE,
+                                  _hosts_hash_key,
+                                  _hosts_hash_cmp,
+                                  NULL)))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(ctx->timers = (struct ipmi_reactor_host **)malloc (sizeof (struct ipmi_reactor_host *) * IPMI_REACTOR_TIMERS_SIZE_INIT)))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+  ctx->timers_size = IPMI_REACTOR_TIMERS_SIZE_INIT;
+
+#if HAVE_SYS_EPOLL_H
+  /* size is only a hint, fall back to poll() if epoll is unavailable */
+  ctx->epfd = epoll_create (IPMI_REACTOR_EPOLL_MAX_EVENTS);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  ctx->errnum = IPMI_REACTOR_ERR_SUCCESS;
+  return (ctx);
+
+ cleanup:
+  if (ctx->hosts)
+    hash_destroy (ctx->hosts);
+  free (ctx->timers);
+  free (ctx);
+  return (NULL);
+}
+
+static void _host_destroy (struct ipmi_reactor_host *host);
+
+static int
+_hosts_destroy_all (void *data, const void *key, void *arg)
+{
+  _host_destroy ((struct ipmi_reactor_host *)data);
+  return (1);
+}
+
+void
+ipmi_reactor_ctx_destroy (ipmi_reactor_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_REACTOR_CTX_MAGIC)
+    return;
+
+  hash_delete_if (ctx->hosts, _hosts_destroy_all, NULL);
+  hash_destroy (ctx->hosts);
+  free (ctx->timers);
+  /* ignore potential error, destroy path */
+  if (ctx->epfd >= 0)
+    close (ctx->epfd);
+
+  ctx->magic = ~IPMI_REACTOR_CTX_MAGIC;
+  free (ctx);
+}
+
+int
+ipmi_reactor_ctx_errnum (ipmi_reactor_ctx_t ctx)
+{
+  if (!ctx)
+    return (IPMI_REACTOR_ERR_CONTEXT_NULL);
+  else if (ctx->magic != IPMI_REACTOR_CTX_MAGIC)
+    return (IPMI_REACTOR_ERR_CONTEXT_INVALID);
+  else
+    return (ctx->errnum);
+}
+
+char *
+ipmi_reactor_ctx_strerror (int errnum)
+{
+  if (errnum >= IPMI_REACTOR_ERR_SUCCESS && errnum <= IPMI_REACTOR_ERR_ERRNUMRANGE)
+    return (ipmi_reactor_errmsgs[errnum]);
+  else
+    return (ipmi_reactor_errmsgs[IPMI_REACTOR_ERR_ERRNUMRANGE]);
+}
+
+char *
+ipmi_reactor_ctx_errormsg (ipmi_reactor_ctx_t ctx)
+{
+  return (ipmi_reactor_ctx_strerror (ipmi_reactor_ctx_errnum (ctx)));
+}
+
+/*
+ * Timer heap
+ *
+ * Binary min heap of the hosts with an outstanding command, ordered
+ * by the time they must next be processed.  Each host knows its
+ * position, so its deadline can be moved or removed in O(log n).
+ */
+
+static void
+_timer_swap (ipmi_reactor_ctx_t ctx, unsigned int i, unsigned int j)
+{
+  struct ipmi_reactor_host *tmp;
+
+  tmp = ctx->timers[i];
+  ctx->timers[i] = ctx->timers[j];
+  ctx->timers[j] = tmp;
+  ctx->timers[i]->timer_index = i;
+  ctx->timers[j]->timer_index = j;
+}
+
+static void
+_timer_sift_up (ipmi_reactor_ctx_t ctx, unsigned int i)
+{
+  while (i)
+    {
+      unsigned int parent = (i - 1) / 2;
+
+      if (!timercmp (&(ctx->timers[i]->deadline), &(ctx->timers[parent]->deadline), <))
+        break;
+
+      _timer_swap (ctx, i, parent);
+      i = parent;
+    }
+}
+
+static void
+_timer_sift_down (ipmi_reactor_ctx_t ctx, unsigned int i)
+{
+  while (1)
+    {
+      unsigned int left = 2 * i + 1;
+      unsigned int right = 2 * i + 2;
+      unsigned int smallest = i;
+
+      if (left < ctx->timers_count
+          && timercmp (&(ctx->timers[left]->deadline), &(ctx->timers[smallest]->deadline), <))
+        smallest = left;
+
+      if (right < ctx->timers_count
+          && timercmp (&(ctx->timers[right]->deadline), &(ctx->timers[smallest]->deadline), <))
+        smallest = right;
+
+      if (smallest == i)
+        break;
+
+      _timer_swap (ctx, i, smallest);
+      i = smallest;
+    }
+}
+
+static void
+_timer_clear (ipmi_reactor_ctx_t ctx, struct ipmi_reactor_host *host)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (host);
+
+  if (host->timer_index < 0)
+    return;
+
+  i = host->timer_index;
+  host->timer_index = -1;
+  ctx->timers_count--;
+
+  if (i == ctx->timers_count)
+    return;
+
+  ctx->timers[i] = ctx->timers[ctx->timers_count];
+  ctx->timers[i]->timer_index = i;
+  _timer_sift_up (ctx, i);
+  _timer_sift_down (ctx, ctx->timers[i]->timer_index);
+}
+
+static int
+_timer_set (ipmi_reactor_ctx_t ctx,
+            struct ipmi_reactor_host *host,
+            struct timeval *deadline)
+{
+  assert (ctx);
+  assert (host);
+  assert (deadline);
+
+  if (host->timer_index >= 0)
+    {
+      host->deadline = *deadline;
+      _timer_sift_up (ctx, host->timer_index);
+      _timer_sift_down (ctx, host->timer_index);
+      return (0);
+    }
+
+  if (ctx->timers_count == ctx->timers_size)
+    {
+      struct ipmi_reactor_host **tmp;
+
+      if (!(tmp = (struct ipmi_reactor_host **)realloc (ctx->timers,
+                                                        sizeof (struct ipmi_reactor_host *) * ctx->timers_size * 2)))
+        {
+          REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      ctx->timers = tmp;
+      ctx->timers_size *= 2;
+    }
+
+  host->deadline = *deadline;
+  host->timer_index = ctx->timers_count;
+  ctx->timers[ctx->timers_count++] = host;
+  _timer_sift_up (ctx, host->timer_index);
+  return (0);
+}
+
+/*
+ * Hosts
+ */
+
+/* Host must already be removed from the hosts hash */
+static void
+_host_destroy (struct ipmi_reactor_host *host)
+{
+  ipmi_reactor_ctx_t ctx;
+  struct ipmi_reactor_cmd *cmd;
+
+  assert (host);
+
+  ctx = host->ctx;
+
+#if HAVE_SYS_EPOLL_H
+  /* ignore potential error, socket may already be closed */
+  if (ctx->epfd >= 0)
+    epoll_ctl (ctx->epfd, EPOLL_CTL_DEL, host->fd, NULL);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  _timer_clear (ctx, host);
+
+  /* ignore potential error, context may already be closed */
+  if (host->outstanding)
+    ipmi_cmd_poll_cancel (host->ipmi_ctx);
+
+  while ((cmd = list_dequeue (host->cmds)))
+    {
+      ctx->cmds_count--;
+      free (cmd);
+    }
+
+  list_destroy (host->cmds);
+  free (host);
+}
+
+static int
+_host_timer_update (struct ipmi_reactor_host *host)
+{
+  ipmi_reactor_ctx_t ctx;
+  struct timeval current;
+  struct timeval deadline;
+  struct timeval timeout_len;
+  unsigned int timeout;
+  int ret;
+
+  assert (host);
+
+  ctx = host->ctx;
+
+  if (!host->outstanding)
+    {
+      _timer_clear (ctx, host);
+      return (0);
+    }
+
+  if ((ret = ipmi_cmd_poll_timeout (host->ipmi_ctx, &timeout)) < 0)
+    {
+      REACTOR_IPMI_CTX_ERROR_TO_REACTOR_ERRNUM (ctx, host->ipmi_ctx);
+      return (-1);
+    }
+
+  if (!ret)
+    {
+      _timer_clear (ctx, host);
+      return (0);
+    }
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  timeout_len.tv_sec = timeout / 1000;
+  timeout_len.tv_usec = (timeout % 1000) * 1000;
+  timeradd (&current, &timeout_len, &deadline);
+
+  return (_timer_set (ctx, host, &deadline));
+}
+
+static int _host_dispatch (struct ipmi_reactor_host *host);
+
+static void
+_host_cmd_callback (ipmi_ctx_t ipmi_ctx,
+                    int errnum,
+                    fiid_obj_t obj_cmd_rs,
+                    void *data)
+{
+  struct ipmi_reactor_host *host;
+  struct ipmi_reactor_cmd *cmd;
+
+  assert (data);
+
+  host = (struct ipmi_reactor_host *)data;
+
+  assert (host->outstanding);
+
+  cmd = list_dequeue (host->cmds);
+  assert (cmd);
+  host->outstanding = 0;
+  host->ctx->cmds_count--;
+
+  cmd->callback (ipmi_ctx, errnum, obj_cmd_rs, cmd->callback_data);
+  free (cmd);
+
+  /* ignore potential error, the next process call will fail the same */
+  _host_dispatch (host);
+}
+
+/* Send the next queued command if none is outstanding */
+static int
+_host_dispatch (struct ipmi_reactor_host *host)
+{
+  ipmi_reactor_ctx_t ctx;
+  struct ipmi_reactor_cmd *cmd;
+
+  assert (host);
+
+  ctx = host->ctx;
+
+  while (!host->outstanding
+         && (cmd = list_peek (host->cmds)))
+    {
+      if (ipmi_cmd_poll_submit (host->ipmi_ctx,
+                                cmd->lun,
+                                cmd->net_fn,
+                                cmd->obj_cmd_rq,
+                                cmd->obj_cmd_rs,
+                                _host_cmd_callback,
+                                host) < 0)
+        {
+          list_dequeue (host->cmds);
+          ctx->cmds_count--;
+          cmd->callback (host->ipmi_ctx,
+                         ipmi_ctx_errnum (host->ipmi_ctx),
+                         cmd->obj_cmd_rs,
+                         cmd->callback_data);
+          free (cmd);
+          continue;
+        }
+
+      host->outstanding = 1;
+    }
+
+  return (_host_timer_update (host));
+}
+
+static int
+_host_process (struct ipmi_reactor_host *host)
+{
+  assert (host);
+
+  if (!host->outstanding)
+    return (0);
+
+  if (ipmi_cmd_poll_process (host->ipmi_ctx) < 0)
+    {
+      REACTOR_IPMI_CTX_ERROR_TO_REACTOR_ERRNUM (host->ctx, host->ipmi_ctx);
+      return (-1);
+    }
+
+  return (_host_timer_update (host));
+}
+
+int
+ipmi_reactor_add (ipmi_reactor_ctx_t ctx, ipmi_ctx_t ipmi_ctx)
+{
+  struct ipmi_reactor_host *host = NULL;
+  int fd;
+
+  if (!ctx || ctx->magic != IPMI_REACTOR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_reactor_ctx_errormsg (ctx), ipmi_reactor_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!ipmi_ctx)
+    {
+      REACTOR_SET_ERRNUM (ctx, IPMI_REACTOR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (hash_find (ctx->hosts, ipmi_ctx))
+    {
+      REACTOR_SET_ERRNUM (ctx, IPMI_REACTOR_ERR_ALREADY_ADDED);
+      return (-1);
+    }
+
+  /* fails if not an opened LAN context */
+  if ((fd = ipmi_ctx_get_fd (ipmi_ctx)) < 0)
+    {
+      REACTOR_IPMI_CTX_ERROR_TO_REACTOR_ERRNUM (ctx, ipmi_ctx);
+      return (-1);
+    }
+
+  if (!(host = (struct ipmi_reactor_host *)malloc (sizeof (struct ipmi_reactor_host))))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+  memset (host, '\0', sizeof (struct ipmi_reactor_host));
+  host->ctx = ctx;
+  host->ipmi_ctx = ipmi_ctx;
+  host->fd = fd;
+  host->timer_index = -1;
+
+  if (!(host->cmds = list_create ((ListDelF)free)))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+#if HAVE_SYS_EPOLL_H
+  if (ctx->epfd >= 0)
+    {
+      struct epoll_event ev;
+
+      memset (&ev, '\0', sizeof (struct epoll_event));
+      ev.events = EPOLLIN;
+      ev.data.ptr = host;
+
+      if (epoll_ctl (ctx->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+          REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  if (!hash_insert (ctx->hosts, ipmi_ctx, host))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+#if HAVE_SYS_EPOLL_H
+      if (ctx->epfd >= 0)
+        epoll_ctl (ctx->epfd, EPOLL_CTL_DEL, fd, NULL);
+#endif /* HAVE_SYS_EPOLL_H */
+      goto cleanup;
+    }
+
+  ctx->errnum = IPMI_REACTOR_ERR_SUCCESS;
+  return (0);
+
+ cleanup:
+  if (host->cmds)
+    list_destroy (host->cmds);
+  free (host);
+  return (-1);
+}
+
+int
+ipmi_reactor_cmd (ipmi_reactor_ctx_t ctx,
+                  ipmi_ctx_t ipmi_ctx,
+                  uint8_t lun,
+                  uint8_t net_fn,
+                  fiid_obj_t obj_cmd_rq,
+                  fiid_obj_t obj_cmd_rs,
+                  Ipmi_Cmd_Poll_Callback callback,
+                  void *callback_data)
+{
+  struct ipmi_reactor_host *host;
+  struct ipmi_reactor_cmd *cmd;
+
+  if (!ctx || ctx->magic != IPMI_REACTOR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_reactor_ctx_errormsg (ctx), ipmi_reactor_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!ipmi_ctx
+      || !fiid_obj_valid (obj_cmd_rq)
+      || !fiid_obj_valid (obj_cmd_rs)
+      || !callback)
+    {
+      REACTOR_SET_ERRNUM (ctx, IPMI_REACTOR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!(host = hash_find (ctx->hosts, ipmi_ctx)))
+    {
+      REACTOR_SET_ERRNUM (ctx, IPMI_REACTOR_ERR_NOT_FOUND);
+      return (-1);
+    }
+
+  if (!(cmd = (struct ipmi_reactor_cmd *)malloc (sizeof (struct ipmi_reactor_cmd))))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+  cmd->lun = lun;
+  cmd->net_fn = net_fn;
+  cmd->obj_cmd_rq = obj_cmd_rq;
+  cmd->obj_cmd_rs = obj_cmd_rs;
+  cmd->callback = callback;
+  cmd->callback_data = callback_data;
+
+  if (!list_enqueue (host->cmds, cmd))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      free (cmd);
+      return (-1);
+    }
+  ctx->cmds_count++;
+
+  if (_host_dispatch (host) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_REACTOR_ERR_SUCCESS;
+  return (0);
+}
+
+struct _poll_hosts_arg {
+  struct pollfd *pfds;
+  struct ipmi_reactor_host **hosts;
+  unsigned int count;
+};
+
+static int
+_poll_hosts_add (void *data, const void *key, void *arg)
+{
+  struct ipmi_reactor_host *host;
+  struct _poll_hosts_arg *parg;
+
+  assert (data);
+  assert (arg);
+
+  host = (struct ipmi_reactor_host *)data;
+  parg = (struct _poll_hosts_arg *)arg;
+
+  if (!host->outstanding)
+    return (0);
+
+  parg->pfds[parg->count].fd = host->fd;
+  parg->pfds[parg->count].events = POLLIN;
+  parg->pfds[parg->count].revents = 0;
+  parg->hosts[parg->count] = host;
+  parg->count++;
+  return (0);
+}
+
+/* Wait for input on hosts with an outstanding command, stores the
+ * hosts that are readable in ready.
+ */
+static int
+_wait_ready (ipmi_reactor_ctx_t ctx,
+             int timeout,
+             struct ipmi_reactor_host **ready,
+             unsigned int *ready_count)
+{
+  struct _poll_hosts_arg parg;
+  unsigned int i;
+  int n, rv = -1;
+
+  assert (ctx);
+  assert (ready);
+  assert (ready_count);
+
+  (*ready_count) = 0;
+
+#if HAVE_SYS_EPOLL_H
+  if (ctx->epfd >= 0)
+    {
+      struct epoll_event events[IPMI_REACTOR_EPOLL_MAX_EVENTS];
+
+      if ((n = epoll_wait (ctx->epfd,
+                           events,
+                           IPMI_REACTOR_EPOLL_MAX_EVENTS,
+                           timeout)) < 0)
+        {
+          if (errno == EINTR)
+            return (0);
+          REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          ready[(*ready_count)] = (struct ipmi_reactor_host *)events[i].data.ptr;
+          (*ready_count)++;
+        }
+
+      return (0);
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  memset (&parg, '\0', sizeof (struct _poll_hosts_arg));
+
+  if (!(parg.pfds = (struct pollfd *)malloc (sizeof (struct pollfd) * (ctx->timers_count + 1))))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (!(parg.hosts = (struct ipmi_reactor_host **)malloc (sizeof (struct ipmi_reactor_host *) * (ctx->timers_count + 1))))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  hash_for_each (ctx->hosts, _poll_hosts_add, &parg);
+
+  if ((n = poll (parg.pfds, parg.count, timeout)) < 0)
+    {
+      if (errno == EINTR)
+        {
+          rv = 0;
+          goto cleanup;
+        }
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  for (i = 0; i < parg.count && n; i++)
+    {
+      if (!parg.pfds[i].revents)
+        continue;
+
+      ready[(*ready_count)] = parg.hosts[i];
+      (*ready_count)++;
+      n--;
+    }
+
+  rv = 0;
+ cleanup:
+  free (parg.pfds);
+  free (parg.hosts);
+  return (rv);
+}
+
+/* Wait until the earliest deadline for responses, then handle
+ * readable hosts and expired timers.
+ */
+static int
+_reactor_run_once (ipmi_reactor_ctx_t ctx)
+{
+  struct ipmi_reactor_host **ready = NULL;
+  unsigned int ready_count = 0;
+  unsigned int ready_size;
+  struct timeval current;
+  int timeout;
+  unsigned int i;
+  int rv = -1;
+
+  assert (ctx);
+
+  /* every host with queued commands has one outstanding */
+  if (!ctx->timers_count)
+    {
+      REACTOR_SET_ERRNUM (ctx, IPMI_REACTOR_ERR_INTERNAL_ERROR);
+      return (-1);
+    }
+
+  /* every readable or expired host is outstanding, so in the heap */
+  ready_size = ctx->timers_count;
+  if (ready_size < IPMI_REACTOR_EPOLL_MAX_EVENTS)
+    ready_size = IPMI_REACTOR_EPOLL_MAX_EVENTS;
+
+  if (!(ready = (struct ipmi_reactor_host **)malloc (sizeof (struct ipmi_reactor_host *) * ready_size)))
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (timercmp (&(ctx->timers[0]->deadline), &current, >))
+    {
+      struct timeval delta;
+
+      timersub (&(ctx->timers[0]->deadline), &current, &delta);
+      /* round up, so the timer has expired on wake up */
+      timeout = (delta.tv_sec * 1000) + ((delta.tv_usec + 999) / 1000);
+    }
+  else
+    timeout = 0;
+
+  if (_wait_ready (ctx, timeout, ready, &ready_count) < 0)
+    goto cleanup;
+
+  for (i = 0; i < ready_count; i++)
+    {
+      if (_host_process (ready[i]) < 0)
+        goto cleanup;
+    }
+
+  ready_count = 0;
+
+  if (gettimeofday (&current, NULL) < 0)
+    {
+      REACTOR_ERRNO_TO_REACTOR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  /* collect expired timers first, processing moves them */
+  while (ctx->timers_count
+         && !timercmp (&(ctx->timers[0]->deadline), &current, >))
+    {
+      ready[ready_count] = ctx->timers[0];
+      _timer_clear (ctx, ready[ready_count]);
+      ready_count++;
+    }
+
+  for (i = 0; i < ready_count; i++)
+    {
+      if (_host_process (ready[i]) < 0)
+        goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  free (ready);
+  return (rv);
+}
+
+int
+ipmi_reactor_run (ipmi_reactor_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_REACTOR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_reactor_ctx_errormsg (ctx), ipmi_reactor_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  while (ctx->cmds_count)
+    {
+      if (_reactor_run_once (ctx) < 0)
+        return (-1);
+    }
+
+  ctx->errnum = IPMI_REACTOR_ERR_SUCCESS;
+  return (0);
+}
@@ -51,6 +51,8 @@
 #include "freeipmi/debug/ipmi-debug.h"
 #include "freeipmi/record-format/ipmi-sdr-record-format.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
+#include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/util/ipmi-util.h"
 
 #include "ipmi-sdr-common.h"
@@ -58,6 +60,7 @@
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
 
+#include "api/ipmi-api-util.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -73,6 +76,41 @@
 #define IPMI_SDR_CACHE_BYTES_TO_READ_START      16
 #define IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT  4
 
+/* Partial reads start at the size above, or the size remembered in
+ * the previous cache for this BMC, and grow from there while the BMC
+ * keeps accepting them.  A size the BMC rejects lowers the limit for
+ * the rest of the cache creation and is remembered in the cache.
+ */
+#define IPMI_SDR_CACHE_BYTES_TO_READ_INCREMENT  8
+#define IPMI_SDR_CACHE_BYTES_TO_READ_MAX        64
+
+#define IPMI_SDR_CACHE_PIPELINE_DEPTH           8
+
+struct ipmi_sdr_cache_read_size {
+  unsigned int bytes_to_read;
+  unsigned int bytes_to_read_max;
+};
+
+struct ipmi_sdr_cache_pipeline {
+  int enabled;
+  int entire_record_tested;
+  struct ipmi_sdr_cache_read_size read_size;
+  int header_valid;
+  uint16_t header_record_id;
+  uint16_t header_next_record_id;
+  uint8_t header_buf[IPMI_SDR_RECORD_HEADER_LENGTH];
+  fiid_obj_t obj_cmd_rq[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  fiid_obj_t obj_cmd_rs[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+};
+
+struct ipmi_sdr_cache_index_record {
+  uint16_t record_id;
+  uint32_t offset;
+  uint8_t sensor_owner_id;
+  uint8_t sensor_number;
+  unsigned int sensor_count;
+};
+
 static int
 _sdr_cache_header_write (ipmi_sdr_ctx_t ctx,
                          ipmi_ctx_t ipmi_ctx,
@@ -119,10 +157,10 @@ _sdr_cache_header_write (ipmi_sdr_ctx_t ctx,
   memcpy(&header_checksum_buf[header_checksum_buf_len], sdr_cache_magic_buf, 4);
   header_checksum_buf_len += 4;
 
-  sdr_cache_version_buf[0] = IPMI_SDR_CACHE_FILE_VERSION_1_2_0;
-  sdr_cache_version_buf[1] = IPMI_SDR_CACHE_FILE_VERSION_1_2_1;
-  sdr_cache_version_buf[2] = IPMI_SDR_CACHE_FILE_VERSION_1_2_2;
-  sdr_cache_version_buf[3] = IPMI_SDR_CACHE_FILE_VERSION_1_2_3;
+  sdr_cache_version_buf[0] = IPMI_SDR_CACHE_FILE_VERSION_1_4_0;
+  sdr_cache_version_buf[1] = IPMI_SDR_CACHE_FILE_VERSION_1_4_1;
+  sdr_cache_version_buf[2] = IPMI_SDR_CACHE_FILE_VERSION_1_4_2;
+  sdr_cache_version_buf[3] = IPMI_SDR_CACHE_FILE_VERSION_1_4_3;
 
   if ((n = fd_write_n (fd, sdr_cache_version_buf, 4)) < 0)
     {
@@ -283,6 +321,133 @@ _sdr_cache_trailer_write (ipmi_sdr_ctx_t ctx,
   return (0);
 }
 
+/* Load the read sizes remembered in an existing cache, if any.  They
+ * are only hints, so any problem with the file is ignored.
+ */
+static void
+_sdr_cache_read_size_load (const char *filename,
+                           struct ipmi_sdr_cache_read_size *read_size)
+{
+  uint8_t header_buf[8];
+  uint8_t read_size_buf[IPMI_SDR_CACHE_READ_SIZE_LENGTH];
+  struct stat stat_buf;
+  unsigned int bytes_to_read_max;
+  unsigned int bytes_to_read;
+  int fd = -1;
+
+  assert (filename);
+  assert (read_size);
+
+  if ((fd = open (filename, O_RDONLY)) < 0)
+    return;
+
+  if (fstat (fd, &stat_buf) < 0
+      || stat_buf.st_size < (off_t)(sizeof (header_buf) + IPMI_SDR_CACHE_READ_SIZE_LENGTH + 5))
+    goto cleanup;
+
+  if (fd_read_n (fd, header_buf, sizeof (header_buf)) != sizeof (header_buf))
+    goto cleanup;
+
+  if (header_buf[0] != IPMI_SDR_CACHE_FILE_MAGIC_0
+      || header_buf[1] != IPMI_SDR_CACHE_FILE_MAGIC_1
+      || header_buf[2] != IPMI_SDR_CACHE_FILE_MAGIC_2
+      || header_buf[3] != IPMI_SDR_CACHE_FILE_MAGIC_3
+      || header_buf[4] != IPMI_SDR_CACHE_FILE_VERSION_1_4_0
+      || header_buf[5] != IPMI_SDR_CACHE_FILE_VERSION_1_4_1
+      || header_buf[6] != IPMI_SDR_CACHE_FILE_VERSION_1_4_2
+      || header_buf[7] != IPMI_SDR_CACHE_FILE_VERSION_1_4_3)
+    goto cleanup;
+
+  /* read sizes are before total bytes of file (4) and checksum (1) */
+  if (lseek (fd, stat_buf.st_size - IPMI_SDR_CACHE_READ_SIZE_LENGTH - 5, SEEK_SET) < 0)
+    goto cleanup;
+
+  if (fd_read_n (fd, read_size_buf, IPMI_SDR_CACHE_READ_SIZE_LENGTH) != IPMI_SDR_CACHE_READ_SIZE_LENGTH)
+    goto cleanup;
+
+  bytes_to_read = read_size_buf[0];
+  bytes_to_read_max = read_size_buf[1];
+
+  if (bytes_to_read_max < IPMI_SDR_RECORD_HEADER_LENGTH
+      || bytes_to_read_max > IPMI_SDR_CACHE_BYTES_TO_READ_MAX
+      || bytes_to_read < IPMI_SDR_RECORD_HEADER_LENGTH
+      || bytes_to_read > bytes_to_read_max)
+    goto cleanup;
+
+  read_size->bytes_to_read = bytes_to_read;
+  read_size->bytes_to_read_max = bytes_to_read_max;
+
+ cleanup:
+  /* ignore potential error, cleanup path */
+  close (fd);
+}
+
+static int
+_sdr_cache_read_size_write (ipmi_sdr_ctx_t ctx,
+                            int fd,
+                            unsigned int *total_bytes_written,
+                            const struct ipmi_sdr_cache_read_size *read_size,
+                            uint8_t *trailer_checksum)
+{
+  uint8_t read_size_buf[IPMI_SDR_CACHE_READ_SIZE_LENGTH];
+  ssize_t n;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (fd);
+  assert (total_bytes_written);
+  assert (read_size);
+  assert (trailer_checksum);
+
+  read_size_buf[0] = read_size->bytes_to_read;
+  read_size_buf[1] = read_size->bytes_to_read_max;
+
+  if ((n = fd_write_n (fd, read_size_buf, IPMI_SDR_CACHE_READ_SIZE_LENGTH)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+  if (n != IPMI_SDR_CACHE_READ_SIZE_LENGTH)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+  (*total_bytes_written) += IPMI_SDR_CACHE_READ_SIZE_LENGTH;
+
+  (*trailer_checksum) = ipmi_checksum_incremental (read_size_buf,
+                                                   IPMI_SDR_CACHE_READ_SIZE_LENGTH,
+                                                   (*trailer_checksum));
+  return (0);
+}
+
+/* A full sized partial read succeeded, try a larger one next */
+static void
+_sdr_cache_read_size_grow (struct ipmi_sdr_cache_read_size *read_size)
+{
+  assert (read_size);
+
+  read_size->bytes_to_read += IPMI_SDR_CACHE_BYTES_TO_READ_INCREMENT;
+  if (read_size->bytes_to_read > read_size->bytes_to_read_max)
+    read_size->bytes_to_read = read_size->bytes_to_read_max;
+}
+
+/* BMC could not return 'bytes_to_read' bytes, never try that many again */
+static void
+_sdr_cache_read_size_shrink (struct ipmi_sdr_cache_read_size *read_size,
+                             unsigned int bytes_to_read)
+{
+  assert (read_size);
+  assert (bytes_to_read > IPMI_SDR_RECORD_HEADER_LENGTH);
+
+  if ((bytes_to_read - IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT) < IPMI_SDR_RECORD_HEADER_LENGTH)
+    read_size->bytes_to_read_max = IPMI_SDR_RECORD_HEADER_LENGTH;
+  else
+    read_size->bytes_to_read_max = bytes_to_read - IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT;
+
+  if (read_size->bytes_to_read > read_size->bytes_to_read_max)
+    read_size->bytes_to_read = read_size->bytes_to_read_max;
+}
+
 static int
 _sdr_cache_reservation_id (ipmi_sdr_ctx_t ctx,
                            ipmi_ctx_t ipmi_ctx,
@@ -297,7 +462,7 @@ _sdr_cache_reservation_id (ipmi_sdr_ctx_t ctx,
   assert (ipmi_ctx);
   assert (reservation_id);
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_reserve_sdr_repository_rs)))
+  if (!(obj_cmd_rs = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_reserve_sdr_repository_rs)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -332,7 +497,9 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
                        void *record_buf,
                        unsigned int record_buf_len,
                        uint16_t *reservation_id,
-                       uint16_t *next_record_id)
+                       uint16_t *next_record_id,
+                       struct ipmi_sdr_cache_read_size *read_size,
+                       int *entire_record_read)
 {
   fiid_obj_t obj_cmd_rs = NULL;
   fiid_obj_t obj_sdr_record_header = NULL;
@@ -340,7 +507,6 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   int sdr_record_len = 0;
   unsigned int record_length = 0;
   int rv = -1;
-  unsigned int bytes_to_read = IPMI_SDR_CACHE_BYTES_TO_READ_START;
   unsigned int offset_into_record = 0;
   unsigned int reservation_id_retry_count = 0;
   uint8_t temp_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
@@ -353,14 +519,18 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   assert (record_buf_len);
   assert (reservation_id);
   assert (next_record_id);
+  assert (read_size);
+
+  if (entire_record_read)
+    *entire_record_read = 0;
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sdr_rs)))
+  if (!(obj_cmd_rs = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_sdr_rs)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
     }
 
-  if (!(obj_sdr_record_header = fiid_obj_create (tmpl_sdr_record_header)))
+  if (!(obj_sdr_record_header = fiid_obj_create_in_arena (ctx->arena, tmpl_sdr_record_header)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -462,6 +632,8 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
 
       memcpy (record_buf, temp_record_buf, sdr_record_len);
       offset_into_record += sdr_record_len;
+      if (entire_record_read)
+        *entire_record_read = 1;
       goto out;
     }
 
@@ -575,8 +747,10 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   reservation_id_retry_count = 0;
   while (offset_into_record < record_length)
     {
+      unsigned int bytes_to_read;
       int record_data_len;
 
+      bytes_to_read = read_size->bytes_to_read;
       if ((record_length - offset_into_record) < bytes_to_read)
         bytes_to_read = record_length - offset_into_record;
 
@@ -648,9 +822,7 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
                          || comp_code == IPMI_COMP_CODE_UNSPECIFIED_ERROR)
                         && bytes_to_read > sdr_record_header_length)
                 {
-                  bytes_to_read -= IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT;
-                  if (bytes_to_read < sdr_record_header_length)
-                    bytes_to_read = sdr_record_header_length;
+                  _sdr_cache_read_size_shrink (read_size, bytes_to_read);
                   continue;
                 }
 
@@ -668,6 +840,10 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
           goto cleanup;
         }
 
+      if (bytes_to_read == read_size->bytes_to_read
+          && record_data_len == bytes_to_read)
+        _sdr_cache_read_size_grow (read_size);
+
       offset_into_record += record_data_len;
     }
 
@@ -679,6 +855,503 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   return (rv);
 }
 
+static int
+_sdr_cache_pipeline_init (ipmi_sdr_ctx_t ctx,
+                          struct ipmi_sdr_cache_pipeline *pipeline,
+                          int enabled)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (pipeline);
+
+  memset (pipeline, '\0', sizeof (struct ipmi_sdr_cache_pipeline));
+  pipeline->enabled = enabled;
+  pipeline->read_size.bytes_to_read = IPMI_SDR_CACHE_BYTES_TO_READ_START;
+  pipeline->read_size.bytes_to_read_max = IPMI_SDR_CACHE_BYTES_TO_READ_MAX;
+
+  if (!enabled)
+    return (0);
+
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+    {
+      if (!(pipeline->obj_cmd_rq[i] = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_sdr_rq)))
+        {
+          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      if (!(pipeline->obj_cmd_rs[i] = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_sdr_rs)))
+        {
+          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  return (0);
+}
+
+static void
+_sdr_cache_pipeline_cleanup (struct ipmi_sdr_cache_pipeline *pipeline)
+{
+  unsigned int i;
+
+  assert (pipeline);
+
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+    {
+      fiid_obj_destroy (pipeline->obj_cmd_rq[i]);
+      fiid_obj_destroy (pipeline->obj_cmd_rs[i]);
+    }
+}
+
+/* Read a record with several Get SDR requests outstanding at once.
+ * Each batch requests every remaining chunk of the record and, when
+ * they all fit, the header of the next record, so a record usually
+ * costs a single round trip.
+ *
+ * Returns length of record read, 0 if the record should be skipped,
+ * -1 on error.
+ */
+static int
+_sdr_cache_get_record_pipelined (ipmi_sdr_ctx_t ctx,
+                                 ipmi_ctx_t ipmi_ctx,
+                                 struct ipmi_sdr_cache_pipeline *pipeline,
+                                 uint16_t record_id,
+                                 void *record_buf,
+                                 unsigned int record_buf_len,
+                                 uint16_t *reservation_id,
+                                 uint16_t *next_record_id)
+{
+  uint8_t *buf = record_buf;
+  uint8_t filled[IPMI_SDR_MAX_RECORD_LENGTH];
+  uint16_t record_ids[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  unsigned int offsets[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  unsigned int lengths[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  unsigned int record_length = 0;
+  unsigned int reservation_id_retry_count = 0;
+  uint64_t val;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (pipeline);
+  assert (record_buf);
+  assert (record_buf_len >= IPMI_SDR_MAX_RECORD_LENGTH);
+  assert (reservation_id);
+  assert (next_record_id);
+
+  if (!pipeline->enabled)
+    return (_sdr_cache_get_record (ctx,
+                                   ipmi_ctx,
+                                   record_id,
+                                   record_buf,
+                                   record_buf_len,
+                                   reservation_id,
+                                   next_record_id,
+                                   &pipeline->read_size,
+                                   NULL));
+
+  /* Nothing to pipeline if the BMC returns entire records in one
+   * read, which we learn from the first record.
+   */
+  if (!pipeline->entire_record_tested)
+    {
+      int entire_record_read;
+
+      if ((rv = _sdr_cache_get_record (ctx,
+                                       ipmi_ctx,
+                                       record_id,
+                                       record_buf,
+                                       record_buf_len,
+                                       reservation_id,
+                                       next_record_id,
+                                       &pipeline->read_size,
+                                       &entire_record_read)) < 0)
+        return (-1);
+
+      pipeline->entire_record_tested = 1;
+      if (entire_record_read)
+        pipeline->enabled = 0;
+      return (rv);
+    }
+
+  memset (filled, '\0', IPMI_SDR_MAX_RECORD_LENGTH);
+
+  if (pipeline->header_valid
+      && pipeline->header_record_id == record_id)
+    {
+      memcpy (buf, pipeline->header_buf, IPMI_SDR_RECORD_HEADER_LENGTH);
+      memset (filled, '\1', IPMI_SDR_RECORD_HEADER_LENGTH);
+      record_length = buf[IPMI_SDR_RECORD_LENGTH_INDEX] + IPMI_SDR_RECORD_HEADER_LENGTH;
+      *next_record_id = pipeline->header_next_record_id;
+    }
+  pipeline->header_valid = 0;
+
+  while (1)
+    {
+      unsigned int count = 0;
+      unsigned int offset;
+      unsigned int shrink_length = 0;
+      int cancelled = 0;
+      int grow = 0;
+      unsigned int i;
+
+      if (!record_length)
+        {
+          record_ids[count] = record_id;
+          offsets[count] = 0;
+          lengths[count] = IPMI_SDR_RECORD_HEADER_LENGTH;
+          count++;
+        }
+      else
+        {
+          offset = IPMI_SDR_RECORD_HEADER_LENGTH;
+          while (count < IPMI_SDR_CACHE_PIPELINE_DEPTH)
+            {
+              unsigned int len = 0;
+
+              while (offset < record_length && filled[offset])
+                offset++;
+
+              if (offset >= record_length)
+                break;
+
+              while ((offset + len) < record_length
+                     && !filled[offset + len]
+                     && len < pipeline->read_size.bytes_to_read)
+                len++;
+
+              record_ids[count] = record_id;
+              offsets[count] = offset;
+              lengths[count] = len;
+              count++;
+              offset += len;
+            }
+
+          if (!count)
+            break;
+
+          while (offset < record_length && filled[offset])
+            offset++;
+
+          if (offset >= record_length
+              && count < IPMI_SDR_CACHE_PIPELINE_DEPTH
+              && (*next_record_id) != IPMI_SDR_RECORD_ID_LAST)
+            {
+              record_ids[count] = *next_record_id;
+              offsets[count] = 0;
+              lengths[count] = IPMI_SDR_RECORD_HEADER_LENGTH;
+              count++;
+            }
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          if (fill_cmd_get_sdr (*reservation_id,
+                                record_ids[i],
+                                offsets[i],
+                                lengths[i],
+                                pipeline->obj_cmd_rq[i]) < 0)
+            {
+              SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+        }
+
+      if (api_ipmi_cmd_batch (ipmi_ctx,
+                              IPMI_BMC_IPMB_LUN_BMC,
+                              IPMI_NET_FN_STORAGE_RQ,
+                              pipeline->obj_cmd_rq,
+                              pipeline->obj_cmd_rs,
+                              count) < 0)
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+          goto cleanup;
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          uint8_t data_buf[IPMI_SDR_MAX_RECORD_LENGTH];
+          uint8_t comp_code;
+          int data_len;
+
+          if (FIID_OBJ_GET (pipeline->obj_cmd_rs[i],
+                            "comp_code",
+                            &val) < 0)
+            {
+              SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, pipeline->obj_cmd_rs[i]);
+              goto cleanup;
+            }
+          comp_code = val;
+
+          if (comp_code != IPMI_COMP_CODE_COMMAND_SUCCESS)
+            {
+              if (comp_code == IPMI_COMP_CODE_RESERVATION_CANCELLED)
+                {
+                  cancelled++;
+                  continue;
+                }
+
+              if ((comp_code == IPMI_COMP_CODE_CANNOT_RETURN_REQUESTED_NUMBER_OF_BYTES
+                   || comp_code == IPMI_COMP_CODE_UNSPECIFIED_ERROR)
+                  && offsets[i]
+                  && lengths[i] > IPMI_SDR_RECORD_HEADER_LENGTH)
+                {
+                  if (!shrink_length || lengths[i] < shrink_length)
+                    shrink_length = lengths[i];
+                  continue;
+                }
+
+              /* Dell Poweredge FC830 workaround, see
+               * _sdr_cache_get_record().
+               */
+              if (comp_code == IPMI_COMP_CODE_COMMAND_TIMEOUT
+                  && record_ids[i] == record_id
+                  && offsets[i]
+                  && (*next_record_id) == IPMI_SDR_RECORD_ID_LAST)
+                {
+                  rv = 0;
+                  goto cleanup;
+                }
+
+              goto fallback;
+            }
+
+          if ((data_len = fiid_obj_get_data (pipeline->obj_cmd_rs[i],
+                                             "record_data",
+                                             data_buf,
+                                             IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+            {
+              SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, pipeline->obj_cmd_rs[i]);
+              goto cleanup;
+            }
+
+          if (!offsets[i])
+            {
+              if (data_len < IPMI_SDR_RECORD_HEADER_LENGTH)
+                goto fallback;
+
+              if (FIID_OBJ_GET (pipeline->obj_cmd_rs[i],
+                                "next_record_id",
+                                &val) < 0)
+                {
+                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, pipeline->obj_cmd_rs[i]);
+                  goto cleanup;
+                }
+
+              if (record_ids[i] == record_id && !record_length)
+                {
+                  memcpy (buf, data_buf, IPMI_SDR_RECORD_HEADER_LENGTH);
+                  memset (filled, '\1', IPMI_SDR_RECORD_HEADER_LENGTH);
+                  record_length = buf[IPMI_SDR_RECORD_LENGTH_INDEX] + IPMI_SDR_RECORD_HEADER_LENGTH;
+                  *next_record_id = val;
+                }
+              else
+                {
+                  memcpy (pipeline->header_buf, data_buf, IPMI_SDR_RECORD_HEADER_LENGTH);
+                  pipeline->header_record_id = record_ids[i];
+                  pipeline->header_next_record_id = val;
+                  pipeline->header_valid = 1;
+                }
+            }
+          else
+            {
+              if (!data_len)
+                goto fallback;
+
+              if (data_len > lengths[i])
+                data_len = lengths[i];
+
+              memcpy (buf + offsets[i], data_buf, data_len);
+              memset (filled + offsets[i], '\1', data_len);
+
+              if (lengths[i] == pipeline->read_size.bytes_to_read
+                  && data_len == lengths[i])
+                grow++;
+            }
+        }
+
+      if (cancelled)
+        {
+          if (reservation_id_retry_count >= IPMI_SDR_CACHE_MAX_RESERVATION_ID_RETRY)
+            goto fallback;
+
+          if (_sdr_cache_reservation_id (ctx,
+                                         ipmi_ctx,
+                                         reservation_id) < 0)
+            goto cleanup;
+          reservation_id_retry_count++;
+
+          /* repository may have changed under the old reservation */
+          pipeline->header_valid = 0;
+        }
+
+      if (shrink_length)
+        _sdr_cache_read_size_shrink (&pipeline->read_size, shrink_length);
+      else if (grow && !cancelled)
+        _sdr_cache_read_size_grow (&pipeline->read_size);
+    }
+
+  if (record_length > record_buf_len)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+      goto cleanup;
+    }
+
+  rv = record_length;
+ cleanup:
+  return (rv);
+
+ fallback:
+  /* BMC does not cope with pipelined reads, read this and all
+   * remaining records one request at a time.
+   */
+  pipeline->enabled = 0;
+  pipeline->header_valid = 0;
+  return (_sdr_cache_get_record (ctx,
+                                 ipmi_ctx,
+                                 record_id,
+                                 record_buf,
+                                 record_buf_len,
+                                 reservation_id,
+                                 next_record_id,
+                                 &pipeline->read_size,
+                                 NULL));
+}
+
+/* Incremental cache creation: if record_id is in the previous cache
+ * and its header on the BMC is unchanged, copy the record from the
+ * previous cache instead of downloading it.
+ *
+ * Returns length of record copied, 0 if the record must be
+ * downloaded, -1 on error.
+ */
+static int
+_sdr_cache_get_record_unchanged (ipmi_sdr_ctx_t ctx,
+                                 ipmi_ctx_t ipmi_ctx,
+                                 ipmi_sdr_ctx_t old_ctx,
+                                 uint16_t record_id,
+                                 void *record_buf,
+                                 unsigned int record_buf_len,
+                                 uint16_t *reservation_id,
+                                 uint16_t *next_record_id)
+{
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint8_t record_header_buf[IPMI_SDR_MAX_RECORD_LENGTH];
+  unsigned int reservation_id_retry_count = 0;
+  int record_header_len;
+  int old_record_len;
+  uint64_t val;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (old_ctx);
+  assert (record_buf);
+  assert (record_buf_len);
+  assert (reservation_id);
+  assert (next_record_id);
+
+  /* not in previous cache, new record */
+  if (ipmi_sdr_cache_search_record_id (old_ctx, record_id) < 0)
+    return (0);
+
+  if ((old_record_len = ipmi_sdr_cache_record_read (old_ctx,
+                                                    record_buf,
+                                                    record_buf_len)) < 0)
+    return (0);
+
+  if (old_record_len < IPMI_SDR_RECORD_HEADER_LENGTH)
+    return (0);
+
+  if (!(obj_cmd_rs = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_sdr_rs)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  while (1)
+    {
+      if (ipmi_cmd_get_sdr (ipmi_ctx,
+                            *reservation_id,
+                            record_id,
+                            0,
+                            IPMI_SDR_RECORD_HEADER_LENGTH,
+                            obj_cmd_rs) < 0)
+        {
+          if (ipmi_ctx_errnum (ipmi_ctx) != IPMI_ERR_BAD_COMPLETION_CODE)
+            {
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+              goto cleanup;
+            }
+          else
+            {
+              uint8_t comp_code;
+
+              if (FIID_OBJ_GET (obj_cmd_rs,
+                                "comp_code",
+                                &val) < 0)
+                {
+                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+                  goto cleanup;
+                }
+              comp_code = val;
+
+              if (comp_code == IPMI_COMP_CODE_RESERVATION_CANCELLED
+                  && (reservation_id_retry_count < IPMI_SDR_CACHE_MAX_RESERVATION_ID_RETRY))
+                {
+                  if (_sdr_cache_reservation_id (ctx,
+                                                 ipmi_ctx,
+                                                 reservation_id) < 0)
+                    goto cleanup;
+                  reservation_id_retry_count++;
+                  continue;
+                }
+
+              /* let the normal download deal with it */
+              rv = 0;
+              goto cleanup;
+            }
+        }
+      break;
+    }
+
+  if ((record_header_len = fiid_obj_get_data (obj_cmd_rs,
+                                              "record_data",
+                                              record_header_buf,
+                                              IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+
+  if (record_header_len < IPMI_SDR_RECORD_HEADER_LENGTH
+      || memcmp (record_buf, record_header_buf, IPMI_SDR_RECORD_HEADER_LENGTH)
+      || old_record_len != (record_header_buf[IPMI_SDR_RECORD_LENGTH_INDEX] + IPMI_SDR_RECORD_HEADER_LENGTH))
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "next_record_id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  *next_record_id = val;
+
+  rv = old_record_len;
+ cleanup:
+  fiid_obj_destroy (obj_cmd_rs);
+  return (rv);
+}
+
 static int
 _sdr_cache_record_write (ipmi_sdr_ctx_t ctx,
                          int fd,
@@ -771,6 +1444,200 @@ _sdr_cache_record_write (ipmi_sdr_ctx_t ctx,
 
 }
 
+static void
+_sdr_cache_index_add (ipmi_sdr_ctx_t ctx,
+                      struct ipmi_sdr_cache_index_record *index_records,
+                      unsigned int *index_records_count,
+                      unsigned int offset,
+                      uint8_t *buf,
+                      unsigned int buflen)
+{
+  struct ipmi_sdr_cache_index_record *index_record;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (index_records);
+  assert (index_records_count);
+  assert (buf);
+  assert (buflen >= IPMI_SDR_RECORD_HEADER_LENGTH);
+
+  index_record = &index_records[*index_records_count];
+  memset (index_record, '\0', sizeof (struct ipmi_sdr_cache_index_record));
+
+  /* Record ID stored little endian */
+  index_record->record_id = ((uint16_t)buf[IPMI_SDR_RECORD_ID_INDEX_LS] & 0xFF);
+  index_record->record_id |= ((uint16_t)buf[IPMI_SDR_RECORD_ID_INDEX_MS] & 0xFF) << 8;
+  index_record->offset = offset;
+  index_record->sensor_count = sdr_record_sensor_key (buf,
+                                                      buflen,
+                                                      &index_record->sensor_owner_id,
+                                                      &index_record->sensor_number);
+
+  (*index_records_count)++;
+}
+
+static void
+_sdr_cache_index_entries_write (uint8_t *buf,
+                                unsigned int *buflen,
+                                struct ipmi_sdr_index_entry *entries,
+                                unsigned int entries_count,
+                                int record_id_key)
+{
+  unsigned int i;
+
+  assert (buf);
+  assert (buflen);
+  
+  buf[(*buflen)++] = (entries_count & 0x000000FF);
+  buf[(*buflen)++] = (entries_count & 0x0000FF00) >> 8;
+  buf[(*buflen)++] = (entries_count & 0x00FF0000) >> 16;
+  buf[(*buflen)++] = (entries_count & 0xFF000000) >> 24;
+
+  for (i = 0; i < entries_count; i++)
+    {
+      /* sensor keys are owner id then sensor number, i.e. big endian */
+      if (record_id_key)
+        {
+          buf[(*buflen)++] = (entries[i].key & 0x00FF);
+          buf[(*buflen)++] = (entries[i].key & 0xFF00) >> 8;
+        }
+      else
+        {
+          buf[(*buflen)++] = (entries[i].key & 0xFF00) >> 8;
+          buf[(*buflen)++] = (entries[i].key & 0x00FF);
+        }
+      buf[(*buflen)++] = (entries[i].offset & 0x000000FF);
+      buf[(*buflen)++] = (entries[i].offset & 0x0000FF00) >> 8;
+      buf[(*buflen)++] = (entries[i].offset & 0x00FF0000) >> 16;
+      buf[(*buflen)++] = (entries[i].offset & 0xFF000000) >> 24;
+    }
+}
+
+static int
+_sdr_cache_index_write (ipmi_sdr_ctx_t ctx,
+                        int fd,
+                        unsigned int *total_bytes_written,
+                        struct ipmi_sdr_cache_index_record *index_records,
+                        unsigned int index_records_count,
+                        uint8_t *trailer_checksum)
+{
+  struct ipmi_sdr_index_entry *record_id_entries = NULL;
+  struct ipmi_sdr_index_entry *sensor_entries = NULL;
+  unsigned int sensor_entries_count = 0;
+  unsigned int index_start_offset;
+  uint8_t *buf = NULL;
+  unsigned int buflen = 0;
+  unsigned int buflen_max;
+  unsigned int i, j;
+  ssize_t n;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (fd);
+  assert (total_bytes_written);
+  assert (index_records);
+  assert (trailer_checksum);
+
+  for (i = 0; i < index_records_count; i++)
+    sensor_entries_count += index_records[i].sensor_count;
+
+  /* + 1 to avoid 0 byte mallocs */
+  if (!(record_id_entries = (struct ipmi_sdr_index_entry *)malloc ((index_records_count + 1) * sizeof (struct ipmi_sdr_index_entry))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  if (!(sensor_entries = (struct ipmi_sdr_index_entry *)malloc ((sensor_entries_count + 1) * sizeof (struct ipmi_sdr_index_entry))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  sensor_entries_count = 0;
+  for (i = 0; i < index_records_count; i++)
+    {
+      record_id_entries[i].key = index_records[i].record_id;
+      record_id_entries[i].offset = index_records[i].offset;
+
+      for (j = 0; j < index_records[i].sensor_count; j++)
+        {
+          sensor_entries[sensor_entries_count].key = IPMI_SDR_INDEX_SENSOR_KEY (index_records[i].sensor_owner_id,
+                                                                                index_records[i].sensor_number + j);
+          sensor_entries[sensor_entries_count].offset = index_records[i].offset;
+          sensor_entries_count++;
+        }
+    }
+
+  /* ties broken by offset, so the first matching record in the cache
+   * is always found first, same as a linear scan
+   */
+  qsort (record_id_entries,
+         index_records_count,
+         sizeof (struct ipmi_sdr_index_entry),
+         sdr_index_entry_compare);
+
+  qsort (sensor_entries,
+         sensor_entries_count,
+         sizeof (struct ipmi_sdr_index_entry),
+         sdr_index_entry_compare);
+
+  buflen_max = IPMI_SDR_CACHE_INDEX_COUNT_LENGTH;
+  buflen_max += index_records_count * IPMI_SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH;
+  buflen_max += IPMI_SDR_CACHE_INDEX_COUNT_LENGTH;
+  buflen_max += sensor_entries_count * IPMI_SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH;
+  buflen_max += IPMI_SDR_CACHE_INDEX_START_OFFSET_LENGTH;
+
+  if (!(buf = (uint8_t *)malloc (buflen_max)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  index_start_offset = *total_bytes_written;
+
+  _sdr_cache_index_entries_write (buf,
+                                  &buflen,
+                                  record_id_entries,
+                                  index_records_count,
+                                  1);
+
+  _sdr_cache_index_entries_write (buf,
+                                  &buflen,
+                                  sensor_entries,
+                                  sensor_entries_count,
+                                  0);
+
+  buf[buflen++] = (index_start_offset & 0x000000FF);
+  buf[buflen++] = (index_start_offset & 0x0000FF00) >> 8;
+  buf[buflen++] = (index_start_offset & 0x00FF0000) >> 16;
+  buf[buflen++] = (index_start_offset & 0xFF000000) >> 24;
+
+  assert (buflen == buflen_max);
+
+  if ((n = fd_write_n (fd, buf, buflen)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+  if (n != buflen)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_SYSTEM_ERROR);
+      goto cleanup;
+    }
+  (*total_bytes_written) += buflen;
+
+  (*trailer_checksum) = ipmi_checksum_incremental (buf, buflen, (*trailer_checksum));
+
+  rv = 0;
+ cleanup:
+  free (record_id_entries);
+  free (sensor_entries);
+  free (buf);
+  return (rv);
+}
+
 int
 ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                        ipmi_ctx_t ipmi_ctx,
@@ -780,6 +1647,9 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                        void *create_callback_data)
 {
   int open_flags;
+  char tmpfilename[MAXPATHLEN+1];
+  const char *create_filename = NULL;
+  ipmi_sdr_ctx_t old_ctx = NULL;
   uint8_t sdr_version;
   uint16_t record_count, reservation_id, record_id, next_record_id;
   uint32_t most_recent_addition_timestamp, most_recent_erase_timestamp;
@@ -787,9 +1657,14 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
   unsigned int total_bytes_written = 0;
   uint16_t *record_ids = NULL;
   unsigned int record_ids_count = 0;
+  struct ipmi_sdr_cache_index_record *index_records = NULL;
+  unsigned int index_records_count = 0;
+  struct ipmi_sdr_cache_pipeline pipeline;
   unsigned int cache_create_flags_mask = (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE
                                           | IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID
-                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT);
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL);
   uint8_t trailer_checksum = 0;
   int fd = -1;
   int rv = -1;
@@ -821,12 +1696,70 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
 
   ctx->operation = IPMI_SDR_OPERATION_CREATE_CACHE;
 
-  if (cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE)
-    open_flags = O_CREAT | O_TRUNC | O_WRONLY;
+  if (_sdr_cache_pipeline_init (ctx,
+                                &pipeline,
+                                (cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE) ? 1 : 0) < 0)
+    goto cleanup;
+
+  if (cache_create_flags & (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL))
+    {
+      /* start from what the BMC accepted when the cache was last created */
+      _sdr_cache_read_size_load (filename, &pipeline.read_size);
+      open_flags = O_CREAT | O_TRUNC | O_WRONLY;
+    }
   else
     open_flags = O_CREAT | O_EXCL | O_WRONLY;
 
-  if ((fd = open (filename, open_flags, 0644)) < 0)
+  if (cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL)
+    {
+      /* Previous cache is optional, if it is missing or invalid every
+       * record is downloaded.  Timestamps are not checked, they are
+       * why we are here.
+       */
+      if (!(old_ctx = ipmi_sdr_ctx_create ()))
+        {
+          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      /* ignore potential error, only speeds up searches */
+      ipmi_sdr_ctx_set_flags (old_ctx, IPMI_SDR_FLAGS_CACHE_INDEX);
+
+      if (ipmi_sdr_cache_open (old_ctx, NULL, filename) < 0)
+        {
+          ipmi_sdr_ctx_destroy (old_ctx);
+          old_ctx = NULL;
+        }
+
+      /* build the new cache beside the old one, rename it into place
+       * once complete so readers never see a partial cache.
+       */
+      if (snprintf (tmpfilename,
+                    MAXPATHLEN + 1,
+                    "%s.XXXXXX",
+                    filename) > MAXPATHLEN)
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+          goto cleanup;
+        }
+      create_filename = tmpfilename;
+
+      if ((fd = mkstemp (tmpfilename)) >= 0)
+        {
+          if (fchmod (fd, 0644) < 0)
+            {
+              SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+        }
+    }
+  else
+    {
+      create_filename = filename;
+      fd = open (filename, open_flags, 0644);
+    }
+
+  if (fd < 0)
     {
       if (!(cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE)
           && errno == EEXIST)
@@ -889,6 +1822,12 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       record_ids_count = 0;
     }
 
+  if (!(index_records = (struct ipmi_sdr_cache_index_record *)malloc (ctx->record_count * sizeof (struct ipmi_sdr_cache_index_record))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
   if (_sdr_cache_reservation_id (ctx,
                                  ipmi_ctx,
                                  &reservation_id) < 0)
@@ -898,6 +1837,7 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
   while (next_record_id != IPMI_SDR_RECORD_ID_LAST)
     {
       uint8_t record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
+      unsigned int record_offset;
       int record_len;
 
       if (record_count_written >= ctx->record_count)
@@ -921,14 +1861,32 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
         }
 
       record_id = next_record_id;
-      if ((record_len = _sdr_cache_get_record (ctx,
-                                               ipmi_ctx,
-                                               record_id,
-                                               record_buf,
-                                               IPMI_SDR_MAX_RECORD_LENGTH,
-                                               &reservation_id,
-                                               &next_record_id)) < 0)
-        goto cleanup;
+      record_len = 0;
+      if (old_ctx)
+        {
+          if ((record_len = _sdr_cache_get_record_unchanged (ctx,
+                                                             ipmi_ctx,
+                                                             old_ctx,
+                                                             record_id,
+                                                             record_buf,
+                                                             IPMI_SDR_MAX_RECORD_LENGTH,
+                                                             &reservation_id,
+                                                             &next_record_id)) < 0)
+            goto cleanup;
+        }
+
+      if (!record_len)
+        {
+          if ((record_len = _sdr_cache_get_record_pipelined (ctx,
+                                                             ipmi_ctx,
+                                                             &pipeline,
+                                                             record_id,
+                                                             record_buf,
+                                                             IPMI_SDR_MAX_RECORD_LENGTH,
+                                                             &reservation_id,
+                                                             &next_record_id)) < 0)
+            goto cleanup;
+        }
 
       if (record_len)
         {
@@ -960,6 +1918,8 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                 }
             }
 
+          record_offset = total_bytes_written;
+
           if (_sdr_cache_record_write (ctx,
                                        fd,
                                        &total_bytes_written,
@@ -970,6 +1930,13 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                                        &trailer_checksum) < 0)
             goto cleanup;
 
+          _sdr_cache_index_add (ctx,
+                                index_records,
+                                &index_records_count,
+                                record_offset,
+                                record_buf,
+                                total_bytes_written - record_offset);
+
           record_count_written++;
 
           if (create_callback)
@@ -1044,6 +2011,21 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
         }
     }
 
+  if (_sdr_cache_index_write (ctx,
+                              fd,
+                              &total_bytes_written,
+                              index_records,
+                              index_records_count,
+                              &trailer_checksum) < 0)
+    goto cleanup;
+
+  if (_sdr_cache_read_size_write (ctx,
+                                  fd,
+                                  &total_bytes_written,
+                                  &pipeline.read_size,
+                                  &trailer_checksum) < 0)
+    goto cleanup;
+
   if (_sdr_cache_trailer_write (ctx,
                                 ipmi_ctx,
                                 fd,
@@ -1057,6 +2039,15 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
+  if (create_filename != filename)
+    {
+      if (rename (create_filename, filename) < 0)
+        {
+          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+
   if (close (fd) < 0)
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
@@ -1072,11 +2063,19 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
     {
       /* If the cache create never completed, try to remove the file */
       /* ignore potential error, cleanup path */
-      unlink (filename);
+      unlink (create_filename);
       /* ignore potential error, cleanup path */
       close (fd);
     }
+  if (old_ctx)
+    {
+      /* ignore potential error, cleanup path */
+      ipmi_sdr_cache_close (old_ctx);
+      ipmi_sdr_ctx_destroy (old_ctx);
+    }
   free (record_ids);
+  free (index_records);
+  _sdr_cache_pipeline_cleanup (&pipeline);
   sdr_init_ctx (ctx);
   return (rv);
 }
@@ -67,6 +67,288 @@ _sdr_set_current_offset (ipmi_sdr_ctx_t ctx, off_t new_offset)
   ctx->current_offset.offset_dumped = 0;
 }
 
+static uint32_t
+_sdr_cache_uint32 (const uint8_t *ptr)
+{
+  uint32_t val;
+
+  val = ((uint32_t)ptr[0] & 0xFF);
+  val |= ((uint32_t)ptr[1] & 0xFF) << 8;
+  val |= ((uint32_t)ptr[2] & 0xFF) << 16;
+  val |= ((uint32_t)ptr[3] & 0xFF) << 24;
+  return (val);
+}
+
+/* Load the index found between the records and the trailer.
+ * ctx->records_end_offset is expected to be the start of the trailer
+ * and is moved to the start of the index.
+ */
+static int
+_sdr_cache_index_load (ipmi_sdr_ctx_t ctx)
+{
+  off_t index_end_offset;
+  off_t index_start_offset;
+  off_t offset;
+  uint32_t record_ids_count;
+  uint32_t sensors_count;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->sdr_cache);
+
+  if ((ctx->records_end_offset - ctx->records_start_offset) < (IPMI_SDR_CACHE_INDEX_COUNT_LENGTH * 2
+                                                               + IPMI_SDR_CACHE_INDEX_START_OFFSET_LENGTH))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      return (-1);
+    }
+
+  index_end_offset = ctx->records_end_offset - IPMI_SDR_CACHE_INDEX_START_OFFSET_LENGTH;
+  index_start_offset = _sdr_cache_uint32 (ctx->sdr_cache + index_end_offset);
+
+  if (index_start_offset < ctx->records_start_offset
+      || (index_end_offset - index_start_offset) < (IPMI_SDR_CACHE_INDEX_COUNT_LENGTH * 2))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      return (-1);
+    }
+
+  offset = index_start_offset;
+  record_ids_count = _sdr_cache_uint32 (ctx->sdr_cache + offset);
+  offset += IPMI_SDR_CACHE_INDEX_COUNT_LENGTH;
+
+  if (record_ids_count > ctx->record_count
+      || (index_end_offset - offset) < ((off_t)record_ids_count * IPMI_SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH
+                                        + IPMI_SDR_CACHE_INDEX_COUNT_LENGTH))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      return (-1);
+    }
+
+  ctx->index_record_ids_offset = offset;
+  ctx->index_record_ids_count = record_ids_count;
+  offset += (off_t)record_ids_count * IPMI_SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH;
+
+  sensors_count = _sdr_cache_uint32 (ctx->sdr_cache + offset);
+  offset += IPMI_SDR_CACHE_INDEX_COUNT_LENGTH;
+
+  if ((index_end_offset - offset) != ((off_t)sensors_count * IPMI_SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      return (-1);
+    }
+
+  ctx->index_sensors_offset = offset;
+  ctx->index_sensors_count = sensors_count;
+
+  ctx->records_end_offset = index_start_offset;
+  return (0);
+}
+
+static uint16_t
+_sdr_cache_index_key (const uint8_t *ptr, int record_id_key)
+{
+  /* record ids stored little endian, sensor keys owner id first */
+  if (record_id_key)
+    return ((uint16_t)ptr[0] | ((uint16_t)ptr[1] << 8));
+  return (((uint16_t)ptr[0] << 8) | (uint16_t)ptr[1]);
+}
+
+/* Binary search an index for the first entry matching key, returns
+ * offset of the record or 0 if not found.
+ */
+static off_t
+_sdr_cache_index_search (ipmi_sdr_ctx_t ctx,
+                         off_t index_offset,
+                         uint32_t index_count,
+                         unsigned int entry_length,
+                         uint16_t key,
+                         int record_id_key)
+{
+  uint32_t lo = 0;
+  uint32_t hi = index_count;
+  uint8_t *ptr;
+  off_t record_offset;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (index_offset);
+  assert (entry_length);
+  
+  while (lo < hi)
+    {
+      uint32_t mid = lo + (hi - lo) / 2;
+
+      ptr = ctx->sdr_cache + index_offset + (off_t)mid * entry_length;
+      if (_sdr_cache_index_key (ptr, record_id_key) < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo >= index_count)
+    return (0);
+
+  ptr = ctx->sdr_cache + index_offset + (off_t)lo * entry_length;
+  if (_sdr_cache_index_key (ptr, record_id_key) != key)
+    return (0);
+
+  record_offset = _sdr_cache_uint32 (ptr + 2);
+
+  /* Don't trust the index blindly */
+  if (record_offset < ctx->records_start_offset
+      || (record_offset + IPMI_SDR_RECORD_HEADER_LENGTH) > ctx->records_end_offset)
+    return (0);
+
+  return (record_offset);
+}
+
+/* Build in memory offset, record id, and sensor indexes with a single
+ * walk through the records.  The record id and sensor indexes are not
+ * built if the cache file already contains them.
+ */
+static int
+_sdr_cache_memory_index_build (ipmi_sdr_ctx_t ctx)
+{
+  unsigned int offsets_count = 0;
+  unsigned int sensor_entries_count = 0;
+  off_t offset;
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->sdr_cache);
+  assert (!ctx->index_offsets);
+
+  if (ctx->records_start_offset >= ctx->records_end_offset)
+    return (0);
+
+  offset = ctx->records_start_offset;
+  while (1)
+    {
+      uint8_t *ptr = ctx->sdr_cache + offset;
+      unsigned int record_length;
+      uint8_t sensor_owner_id, sensor_number;
+
+      record_length = (uint8_t)ptr[IPMI_SDR_RECORD_LENGTH_INDEX];
+
+      offsets_count++;
+      sensor_entries_count += sdr_record_sensor_key (ptr,
+                                                     record_length + IPMI_SDR_RECORD_HEADER_LENGTH,
+                                                     &sensor_owner_id,
+                                                     &sensor_number);
+
+      if ((offset + record_length + IPMI_SDR_RECORD_HEADER_LENGTH) >= ctx->records_end_offset)
+        break;
+
+      offset += IPMI_SDR_RECORD_HEADER_LENGTH;
+      offset += record_length;
+    }
+
+  if (!(ctx->index_offsets = (off_t *)malloc (offsets_count * sizeof (off_t))))
+    goto cleanup;
+
+  if (!ctx->index_record_ids_offset)
+    {
+      if (!(ctx->index_record_id_entries = (struct ipmi_sdr_index_entry *)malloc (offsets_count * sizeof (struct ipmi_sdr_index_entry))))
+        goto cleanup;
+
+      /* + 1 to avoid 0 byte mallocs */
+      if (!(ctx->index_sensor_entries = (struct ipmi_sdr_index_entry *)malloc ((sensor_entries_count + 1) * sizeof (struct ipmi_sdr_index_entry))))
+        goto cleanup;
+    }
+
+  offset = ctx->records_start_offset;
+  for (i = 0; i < offsets_count; i++)
+    {
+      uint8_t *ptr = ctx->sdr_cache + offset;
+      unsigned int record_length;
+
+      record_length = (uint8_t)ptr[IPMI_SDR_RECORD_LENGTH_INDEX];
+
+      ctx->index_offsets[i] = offset;
+
+      if (ctx->index_record_id_entries)
+        {
+          struct ipmi_sdr_index_entry *entry;
+          uint8_t sensor_owner_id, sensor_number;
+          unsigned int sensor_count, j;
+
+          entry = &ctx->index_record_id_entries[ctx->index_record_id_entries_count++];
+          /* Record ID stored little-endian */
+          entry->key = (uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_LS] & 0xFF;
+          entry->key |= ((uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_MS] & 0xFF) << 8;
+          entry->offset = offset;
+
+          sensor_count = sdr_record_sensor_key (ptr,
+                                                record_length + IPMI_SDR_RECORD_HEADER_LENGTH,
+                                                &sensor_owner_id,
+                                                &sensor_number);
+          for (j = 0; j < sensor_count; j++)
+            {
+              entry = &ctx->index_sensor_entries[ctx->index_sensor_entries_count++];
+              entry->key = IPMI_SDR_INDEX_SENSOR_KEY (sensor_owner_id, sensor_number + j);
+              entry->offset = offset;
+            }
+        }
+
+      offset += IPMI_SDR_RECORD_HEADER_LENGTH;
+      offset += record_length;
+    }
+  ctx->index_offsets_count = offsets_count;
+
+  if (ctx->index_record_id_entries)
+    {
+      /* ties broken by offset, so the first matching record in the
+       * cache is always found first, same as a linear scan
+       */
+      qsort (ctx->index_record_id_entries,
+             ctx->index_record_id_entries_count,
+             sizeof (struct ipmi_sdr_index_entry),
+             sdr_index_entry_compare);
+
+      qsort (ctx->index_sensor_entries,
+             ctx->index_sensor_entries_count,
+             sizeof (struct ipmi_sdr_index_entry),
+             sdr_index_entry_compare);
+    }
+
+  return (0);
+
+ cleanup:
+  SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+  return (-1);
+}
+
+/* Binary search an in memory index for the first entry matching key,
+ * returns offset of the record or 0 if not found.
+ */
+static off_t
+_sdr_cache_memory_index_search (struct ipmi_sdr_index_entry *entries,
+                                unsigned int entries_count,
+                                uint16_t key)
+{
+  unsigned int lo = 0;
+  unsigned int hi = entries_count;
+
+  assert (entries);
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (entries[mid].key < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo >= entries_count || entries[lo].key != key)
+    return (0);
+
+  return (entries[lo].offset);
+}
+
 int
 ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
                      ipmi_ctx_t ipmi_ctx,
@@ -129,18 +411,8 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  ctx->sdr_cache = (uint8_t *)mmap (NULL,
-                                    ctx->file_size,
-                                    PROT_READ,
-                                    MAP_PRIVATE,
-                                    ctx->fd,
-                                    0);
-  if (!ctx->sdr_cache || ctx->sdr_cache == ((void *) -1))
-    {
-      ERRNO_TRACE (errno);
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_SYSTEM_ERROR);
-      goto cleanup;
-    }
+  if (sdr_cache_map (ctx) < 0)
+    goto cleanup;
 
   memcpy (sdr_cache_magic_buf, ctx->sdr_cache + ctx->records_start_offset, 4);
   ctx->records_start_offset += 4;
@@ -171,7 +443,15 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
       && ((uint8_t)sdr_cache_version_buf[0] != IPMI_SDR_CACHE_FILE_VERSION_1_2_0
           || (uint8_t)sdr_cache_version_buf[1] != IPMI_SDR_CACHE_FILE_VERSION_1_2_1
           || (uint8_t)sdr_cache_version_buf[2] != IPMI_SDR_CACHE_FILE_VERSION_1_2_2
-          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_2_3))
+          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+      && ((uint8_t)sdr_cache_version_buf[0] != IPMI_SDR_CACHE_FILE_VERSION_1_3_0
+          || (uint8_t)sdr_cache_version_buf[1] != IPMI_SDR_CACHE_FILE_VERSION_1_3_1
+          || (uint8_t)sdr_cache_version_buf[2] != IPMI_SDR_CACHE_FILE_VERSION_1_3_2
+          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_3_3)
+      && ((uint8_t)sdr_cache_version_buf[0] != IPMI_SDR_CACHE_FILE_VERSION_1_4_0
+          || (uint8_t)sdr_cache_version_buf[1] != IPMI_SDR_CACHE_FILE_VERSION_1_4_1
+          || (uint8_t)sdr_cache_version_buf[2] != IPMI_SDR_CACHE_FILE_VERSION_1_4_2
+          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_4_3))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
       goto cleanup;
@@ -208,10 +488,18 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
         }
     }
 
-  if ((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_2_0
-      && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_2_1
-      && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_2_2
-      && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+  if (((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_2_0
+       && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_2_1
+       && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_2_2
+       && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+      || ((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_3_0
+          && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_3_1
+          && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_3_2
+          && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3_3)
+      || ((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_4_0
+          && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_4_1
+          && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_4_2
+          && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_4_3))
     {
       uint8_t header_checksum_buf[512];
       unsigned int header_checksum_buf_len = 0;
@@ -288,6 +576,24 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
         }
 
       ctx->records_end_offset = ctx->file_size - trailer_bytes_len;
+
+      /* read sizes are only of interest to cache creation */
+      if ((uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_4_3)
+        {
+          if ((ctx->records_end_offset - ctx->records_start_offset) < IPMI_SDR_CACHE_READ_SIZE_LENGTH)
+            {
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+              goto cleanup;
+            }
+          ctx->records_end_offset -= IPMI_SDR_CACHE_READ_SIZE_LENGTH;
+        }
+
+      if ((uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3_3
+          || (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_4_3)
+        {
+          if (_sdr_cache_index_load (ctx) < 0)
+            goto cleanup;
+        }
     }
   else /* (uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_0
           && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_1
@@ -295,6 +601,12 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
           && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3 */
     ctx->records_end_offset = ctx->file_size;
 
+  if (ctx->flags & IPMI_SDR_FLAGS_CACHE_INDEX)
+    {
+      if (_sdr_cache_memory_index_build (ctx) < 0)
+        goto cleanup;
+    }
+
   _sdr_set_current_offset (ctx, ctx->records_start_offset);
   ctx->operation = IPMI_SDR_OPERATION_READ_CACHE;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
@@ -304,9 +616,7 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
   /* ignore potential error, cleanup path */
   if (ctx->fd >= 0)
     close (ctx->fd);
-  /* ignore potential error, cleanup path */
-  if (ctx->sdr_cache)
-    munmap ((void *)ctx->sdr_cache, ctx->file_size);
+  sdr_cache_unmap (ctx);
   sdr_init_ctx (ctx);
   return (-1);
 }
@@ -488,6 +798,19 @@ ipmi_sdr_cache_seek (ipmi_sdr_ctx_t ctx, unsigned int index)
       return (-1);
     }
 
+  if (ctx->index_offsets)
+    {
+      /* same as below, stop at the last record if there are fewer
+       * records than the record count
+       */
+      if (index >= ctx->index_offsets_count)
+        index = ctx->index_offsets_count - 1;
+
+      _sdr_set_current_offset (ctx, ctx->index_offsets[index]);
+      ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+      return (0);
+    }
+
   offset = ctx->records_start_offset;
   for (i = 0; i < index; i++)
     {
@@ -526,6 +849,33 @@ ipmi_sdr_cache_search_record_id (ipmi_sdr_ctx_t ctx, uint16_t record_id)
       return (-1);
     }
 
+  if (ctx->index_record_id_entries)
+    {
+      if ((offset = _sdr_cache_memory_index_search (ctx->index_record_id_entries,
+                                                    ctx->index_record_id_entries_count,
+                                                    record_id)))
+        {
+          found++;
+          _sdr_set_current_offset (ctx, offset);
+        }
+      goto out;
+    }
+
+  if (ctx->index_record_ids_offset)
+    {
+      if ((offset = _sdr_cache_index_search (ctx,
+                                             ctx->index_record_ids_offset,
+                                             ctx->index_record_ids_count,
+                                             IPMI_SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH,
+                                             record_id,
+                                             1)))
+        {
+          found++;
+          _sdr_set_current_offset (ctx, offset);
+        }
+      goto out;
+    }
+
   offset = ctx->records_start_offset;
   while (offset < ctx->records_end_offset)
     {
@@ -553,6 +903,7 @@ ipmi_sdr_cache_search_record_id (ipmi_sdr_ctx_t ctx, uint16_t record_id)
       offset += record_length;
     }
 
+ out:
   if (!found)
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_NOT_FOUND);
@@ -581,6 +932,33 @@ ipmi_sdr_cache_search_sensor (ipmi_sdr_ctx_t ctx, uint8_t sensor_number, uint8_t
       return (-1);
     }
 
+  if (ctx->index_sensor_entries)
+    {
+      if ((offset = _sdr_cache_memory_index_search (ctx->index_sensor_entries,
+                                                    ctx->index_sensor_entries_count,
+                                                    IPMI_SDR_INDEX_SENSOR_KEY (sensor_owner_id, sensor_number))))
+        {
+          found++;
+          _sdr_set_current_offset (ctx, offset);
+        }
+      goto out;
+    }
+
+  if (ctx->index_sensors_offset)
+    {
+      if ((offset = _sdr_cache_index_search (ctx,
+                                             ctx->index_sensors_offset,
+                                             ctx->index_sensors_count,
+                                             IPMI_SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH,
+                                             IPMI_SDR_INDEX_SENSOR_KEY (sensor_owner_id, sensor_number),
+                                             0)))
+        {
+          found++;
+          _sdr_set_current_offset (ctx, offset);
+        }
+      goto out;
+    }
+
   offset = ctx->records_start_offset;
   while (offset < ctx->records_end_offset)
     {
@@ -656,6 +1034,7 @@ ipmi_sdr_cache_search_sensor (ipmi_sdr_ctx_t ctx, uint8_t sensor_number, uint8_t
       offset += record_length;
     }
 
+ out:
   if (!found)
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_NOT_FOUND);
@@ -873,9 +1252,7 @@ ipmi_sdr_cache_close (ipmi_sdr_ctx_t ctx)
   /* ignore potential error, cleanup path */
   if (ctx->fd >= 0)
     close (ctx->fd);
-  /* ignore potential error, cleanup path */
-  if (ctx->sdr_cache)
-    munmap ((void *)ctx->sdr_cache, ctx->file_size);
+  sdr_cache_unmap (ctx);
   sdr_init_ctx (ctx);
 
   ctx->operation = IPMI_SDR_OPERATION_UNINITIALIZED;
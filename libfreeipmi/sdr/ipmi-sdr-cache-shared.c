@@ -0,0 +1,329 @@
+/*****************************************************************************\
+ *  Copyright (C) 2007-2015 Lawrence Livermore National Security, LLC.
+ *  Copyright (C) 2006-2007 The Regents of the University of California.
+ *  Produced at Lawrence Livermore National Laboratory (cf, DISCLAIMER).
+ *  Written by Albert Chu <chu11@llnl.gov>
+ *  UCRL-CODE-222073
+ *
+ *  This file is part of Ipmimonitoring, an IPMI sensor monitoring
+ *  library.  For details, see http://www.llnl.gov/linux/.
+ *
+ *  Ipmimonitoring is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation; either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  Ipmimonitoring is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Ipmimonitoring.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <sys/types.h>
+#include <sys/stat.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <sys/mman.h>
+#include <pthread.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/api/ipmi-device-global-cmds-api.h"
+#include "freeipmi/cmds/ipmi-device-global-cmds.h"
+#include "freeipmi/fiid/fiid.h"
+
+#include "ipmi-sdr-common.h"
+#include "ipmi-sdr-defs.h"
+#include "ipmi-sdr-trace.h"
+#include "ipmi-sdr-util.h"
+
+#include "freeipmi-portability.h"
+
+/* Process wide list of read only cache mappings.  Contexts opening
+ * the same cache file with IPMI_SDR_FLAGS_CACHE_SHARED share one
+ * mapping, which is unmapped when the last of them closes.
+ */
+struct sdr_cache_shared_mapping {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+  uint8_t *sdr_cache;
+  unsigned int refcount;
+  struct sdr_cache_shared_mapping *next;
+};
+
+static struct sdr_cache_shared_mapping *sdr_cache_shared_mappings = NULL;
+
+static pthread_mutex_t sdr_cache_shared_mappings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int
+_sdr_cache_map_private (ipmi_sdr_ctx_t ctx)
+{
+  uint8_t *sdr_cache;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->fd >= 0);
+
+  sdr_cache = (uint8_t *)mmap (NULL,
+                               ctx->file_size,
+                               PROT_READ,
+                               MAP_PRIVATE,
+                               ctx->fd,
+                               0);
+  if (!sdr_cache || sdr_cache == ((void *) -1))
+    {
+      ERRNO_TRACE (errno);
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+
+  ctx->sdr_cache = sdr_cache;
+  ctx->sdr_cache_shared = 0;
+  return (0);
+}
+
+static int
+_sdr_cache_map_shared (ipmi_sdr_ctx_t ctx)
+{
+  struct sdr_cache_shared_mapping *mapping;
+  struct stat stat_buf;
+  int perr;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->fd >= 0);
+
+  if (fstat (ctx->fd, &stat_buf) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  /* file replaced between stat() and open() */
+  if (stat_buf.st_size != ctx->file_size)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      return (-1);
+    }
+
+  if ((perr = pthread_mutex_lock (&sdr_cache_shared_mappings_mutex)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, perr);
+      return (-1);
+    }
+
+  mapping = sdr_cache_shared_mappings;
+  while (mapping)
+    {
+      if (mapping->dev == stat_buf.st_dev
+          && mapping->ino == stat_buf.st_ino
+          && mapping->size == stat_buf.st_size
+          && mapping->mtime == stat_buf.st_mtime)
+        break;
+      mapping = mapping->next;
+    }
+
+  if (!mapping)
+    {
+      if (!(mapping = (struct sdr_cache_shared_mapping *)malloc (sizeof (struct sdr_cache_shared_mapping))))
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+          goto cleanup;
+        }
+
+      if (_sdr_cache_map_private (ctx) < 0)
+        {
+          free (mapping);
+          goto cleanup;
+        }
+
+      mapping->dev = stat_buf.st_dev;
+      mapping->ino = stat_buf.st_ino;
+      mapping->size = stat_buf.st_size;
+      mapping->mtime = stat_buf.st_mtime;
+      mapping->sdr_cache = ctx->sdr_cache;
+      mapping->refcount = 0;
+      mapping->next = sdr_cache_shared_mappings;
+      sdr_cache_shared_mappings = mapping;
+    }
+
+  mapping->refcount++;
+  ctx->sdr_cache = mapping->sdr_cache;
+  ctx->sdr_cache_shared = 1;
+  rv = 0;
+
+ cleanup:
+  /* ignore potential error, cleanup path */
+  pthread_mutex_unlock (&sdr_cache_shared_mappings_mutex);
+  return (rv);
+}
+
+int
+sdr_cache_map (ipmi_sdr_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->fd >= 0);
+
+  if (ctx->flags & IPMI_SDR_FLAGS_CACHE_SHARED)
+    return (_sdr_cache_map_shared (ctx));
+
+  return (_sdr_cache_map_private (ctx));
+}
+
+void
+sdr_cache_unmap (ipmi_sdr_ctx_t ctx)
+{
+  struct sdr_cache_shared_mapping *mapping;
+  struct sdr_cache_shared_mapping *prev = NULL;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+
+  if (!ctx->sdr_cache)
+    return;
+
+  if (!ctx->sdr_cache_shared)
+    {
+      /* ignore potential error, cleanup path */
+      munmap ((void *)ctx->sdr_cache, ctx->file_size);
+      ctx->sdr_cache = NULL;
+      return;
+    }
+
+  /* ignore potential errors, cleanup path, worst case is a leaked mapping */
+  if (pthread_mutex_lock (&sdr_cache_shared_mappings_mutex))
+    goto out;
+
+  mapping = sdr_cache_shared_mappings;
+  while (mapping)
+    {
+      if (mapping->sdr_cache == ctx->sdr_cache)
+        break;
+      prev = mapping;
+      mapping = mapping->next;
+    }
+
+  if (mapping && !(--mapping->refcount))
+    {
+      if (prev)
+        prev->next = mapping->next;
+      else
+        sdr_cache_shared_mappings = mapping->next;
+      munmap ((void *)mapping->sdr_cache, mapping->size);
+      free (mapping);
+    }
+
+  pthread_mutex_unlock (&sdr_cache_shared_mappings_mutex);
+ out:
+  ctx->sdr_cache = NULL;
+  ctx->sdr_cache_shared = 0;
+}
+
+int
+ipmi_sdr_cache_key (ipmi_sdr_ctx_t ctx,
+                    ipmi_ctx_t ipmi_ctx,
+                    char *buf,
+                    unsigned int buflen)
+{
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint32_t manufacturer_id;
+  uint16_t product_id;
+  uint8_t sdr_version;
+  uint16_t record_count;
+  uint32_t most_recent_addition_timestamp, most_recent_erase_timestamp;
+  uint64_t val;
+  int len;
+  int rv = -1;
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!ipmi_ctx
+      || !buf
+      || !buflen)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!(obj_cmd_rs = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_device_id_rs)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (ipmi_cmd_get_device_id (ipmi_ctx, obj_cmd_rs) < 0)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "manufacturer_id.id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  manufacturer_id = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "product_id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  product_id = val;
+
+  if (sdr_info (ctx,
+                ipmi_ctx,
+                &sdr_version,
+                &record_count,
+                &most_recent_addition_timestamp,
+                &most_recent_erase_timestamp) < 0)
+    goto cleanup;
+
+  len = snprintf (buf,
+                  buflen,
+                  "%05X.%04X.%02X.%04X.%08X.%08X",
+                  manufacturer_id,
+                  product_id,
+                  sdr_version,
+                  record_count,
+                  most_recent_addition_timestamp,
+                  most_recent_erase_timestamp);
+  if (len < 0 || len >= buflen)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OVERFLOW);
+      goto cleanup;
+    }
+
+  rv = 0;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+ cleanup:
+  if (obj_cmd_rs)
+    fiid_obj_destroy (obj_cmd_rs);
+  return (rv);
+}
@@ -70,8 +70,22 @@ sdr_init_ctx (ipmi_sdr_ctx_t ctx)
   ctx->records_start_offset = 0;
   ctx->records_end_offset = 0;
   ctx->sdr_cache = NULL;
+  ctx->sdr_cache_shared = 0;
   ctx->current_offset.offset = 0;
   ctx->current_offset.offset_dumped = 0;
+  ctx->index_record_ids_offset = 0;
+  ctx->index_record_ids_count = 0;
+  ctx->index_sensors_offset = 0;
+  ctx->index_sensors_count = 0;
+  free (ctx->index_offsets);
+  ctx->index_offsets = NULL;
+  ctx->index_offsets_count = 0;
+  free (ctx->index_record_id_entries);
+  ctx->index_record_id_entries = NULL;
+  ctx->index_record_id_entries_count = 0;
+  free (ctx->index_sensor_entries);
+  ctx->index_sensor_entries = NULL;
+  ctx->index_sensor_entries_count = 0;
   ctx->callback_lock = 0;
 
   ctx->stats_compiled = 0;
@@ -100,7 +114,7 @@ sdr_info (ipmi_sdr_ctx_t ctx,
   assert (most_recent_addition_timestamp);
   assert (most_recent_erase_timestamp);
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sdr_repository_info_rs)))
+  if (!(obj_cmd_rs = fiid_obj_create_in_arena (ctx->arena, tmpl_cmd_get_sdr_repository_info_rs)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -193,7 +207,7 @@ sdr_record_type_str (ipmi_sdr_ctx_t ctx,
   if (sdr_record_len < sdr_record_header_len)
     goto cleanup;
 
-  if (!(obj_sdr_record_header = fiid_obj_create (tmpl_sdr_record_header)))
+  if (!(obj_sdr_record_header = fiid_obj_create_in_arena (ctx->arena, tmpl_sdr_record_header)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -303,3 +317,72 @@ sdr_check_read_status (ipmi_sdr_ctx_t ctx)
       ctx->current_offset.offset_dumped = 1;
     }
 }
+
+unsigned int
+sdr_record_sensor_key (const uint8_t *sdr_record,
+                       unsigned int sdr_record_len,
+                       uint8_t *sensor_owner_id,
+                       uint8_t *sensor_number)
+{
+  uint8_t record_type;
+  uint8_t share_count = 1;
+
+  assert (sdr_record);
+  assert (sdr_record_len >= IPMI_SDR_RECORD_HEADER_LENGTH);
+  assert (sensor_owner_id);
+  assert (sensor_number);
+
+  record_type = sdr_record[IPMI_SDR_RECORD_TYPE_INDEX];
+
+  if ((record_type != IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
+       && record_type != IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
+       && record_type != IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
+      || sdr_record_len <= IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX)
+    return (0);
+
+  *sensor_owner_id = sdr_record[IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX];
+  *sensor_number = sdr_record[IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX];
+
+  if (record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
+      && sdr_record_len > IPMI_SDR_RECORD_COMPACT_SHARE_COUNT)
+    {
+      share_count = sdr_record[IPMI_SDR_RECORD_COMPACT_SHARE_COUNT];
+      share_count &= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_BITMASK;
+      share_count >>= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_SHIFT;
+    }
+  else if (record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD
+           && sdr_record_len > IPMI_SDR_RECORD_EVENT_SHARE_COUNT)
+    {
+      share_count = sdr_record[IPMI_SDR_RECORD_EVENT_SHARE_COUNT];
+      share_count &= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_BITMASK;
+      share_count >>= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_SHIFT;
+    }
+
+  /* share count of 0 is legal, treat as 1 */
+  if (!share_count)
+    share_count = 1;
+
+  /* IPMI spec gives the following example:
+   *
+   * "If the starting sensor number was 10, and the share
+   * count was 3, then sensors 10, 11, and 12 would share
+   * the record"
+   */
+  if (((unsigned int)*sensor_number + share_count) > 0x100)
+    share_count = 0x100 - *sensor_number;
+
+  return (share_count);
+}
+
+int
+sdr_index_entry_compare (const void *a, const void *b)
+{
+  const struct ipmi_sdr_index_entry *ea = a;
+  const struct ipmi_sdr_index_entry *eb = b;
+
+  if (ea->key != eb->key)
+    return (ea->key < eb->key ? -1 : 1);
+  if (ea->offset != eb->offset)
+    return (ea->offset < eb->offset ? -1 : 1);
+  return (0);
+}
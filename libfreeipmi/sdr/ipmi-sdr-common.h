@@ -50,4 +50,18 @@ const char *sdr_record_type_str (ipmi_sdr_ctx_t ctx,
 
 void sdr_check_read_status (ipmi_sdr_ctx_t ctx);
 
+/* returns number of sensors sharing the record, 0 if not a sensor record */
+unsigned int sdr_record_sensor_key (const uint8_t *sdr_record,
+                                    unsigned int sdr_record_len,
+                                    uint8_t *sensor_owner_id,
+                                    uint8_t *sensor_number);
+
+/* mmap ctx->fd, shared with other contexts under IPMI_SDR_FLAGS_CACHE_SHARED */
+int sdr_cache_map (ipmi_sdr_ctx_t ctx);
+
+void sdr_cache_unmap (ipmi_sdr_ctx_t ctx);
+
+/* sort by key then offset, for qsort() */
+int sdr_index_entry_compare (const void *a, const void *b);
+
 #endif /* IPMI_SDR_COMMON_H */
@@ -38,6 +38,7 @@
 #include <unistd.h>             /* off_t */
 #endif /* HAVE_UNISTD_H */
 
+#include "freeipmi/fiid/fiid.h"
 #include "freeipmi/sdr/ipmi-sdr.h"
 
 #include "list.h"
@@ -118,6 +119,61 @@
 #define IPMI_SDR_CACHE_FILE_VERSION_1_2_2 0x00
 #define IPMI_SDR_CACHE_FILE_VERSION_1_2_3 0x02
 
+/* Cache Version 1.3 format
+ *
+ * magic bytes (4 bytes)
+ * version bytes (4)
+ * sdr version (1)
+ * record count (2)
+ * most recent addition timestamp (4)
+ * most recent erase timestamp (4)
+ * header checksum (1) [all bytes above]
+ * records (variable)
+ * record id index count (4)
+ * record id index entries (variable)
+ *   - record id (2), record offset (4)
+ *   - sorted by record id, then offset
+ * sensor index count (4)
+ * sensor index entries (variable)
+ *   - sensor owner id (1), sensor number (1), record offset (4)
+ *   - sorted by sensor owner id, sensor number, then offset
+ *   - records shared by multiple sensors have one entry per sensor
+ * index start offset (4) [offset of record id index count]
+ * total bytes of file (4)
+ * trailer checksum (1) [records + index + total bytes of file]
+ *
+ * All multi-byte values are stored little endian, all offsets are
+ * from the start of the file.
+ */
+
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_0 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_1 0x01
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_2 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_3 0x03
+
+/* Cache Version 1.4 format
+ *
+ * Identical to version 1.3, with the following after the index start
+ * offset and before the total bytes of file.
+ *
+ * read size (1) [Get SDR partial read size last used]
+ * read size limit (1) [largest partial read size the BMC may accept]
+ *
+ * The read sizes are hints for the next cache creation against the
+ * same BMC and are covered by the trailer checksum.
+ */
+
+#define IPMI_SDR_CACHE_FILE_VERSION_1_4_0 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_4_1 0x01
+#define IPMI_SDR_CACHE_FILE_VERSION_1_4_2 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_4_3 0x04
+
+#define IPMI_SDR_CACHE_INDEX_COUNT_LENGTH            4
+#define IPMI_SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH  6
+#define IPMI_SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH     6
+#define IPMI_SDR_CACHE_INDEX_START_OFFSET_LENGTH     4
+#define IPMI_SDR_CACHE_READ_SIZE_LENGTH              2
+
 #define IPMI_MAX_ENTITY_IDS          256
 #define IPMI_MAX_ENTITY_ID_INSTANCES 256
 
@@ -126,6 +182,15 @@ struct ipmi_sdr_offset {
   int offset_dumped;
 };
 
+/* key is record id or sensor owner id << 8 | sensor number */
+struct ipmi_sdr_index_entry {
+  uint16_t key;
+  off_t offset;
+};
+
+#define IPMI_SDR_INDEX_SENSOR_KEY(__sensor_owner_id, __sensor_number) \
+  (((uint16_t)(__sensor_owner_id) << 8) | (uint8_t)(__sensor_number))
+
 struct ipmi_sdr_entity_count {
   uint8_t entity_instances[IPMI_MAX_ENTITY_ID_INSTANCES];
   unsigned int entity_instances_count;
@@ -149,12 +214,36 @@ struct ipmi_sdr_ctx {
   off_t records_start_offset;
   off_t records_end_offset;
   uint8_t *sdr_cache;
+  int sdr_cache_shared;
   struct ipmi_sdr_offset current_offset;
+  /* 0 offsets if the cache has no index */
+  off_t index_record_ids_offset;
+  uint32_t index_record_ids_count;
+  off_t index_sensors_offset;
+  uint32_t index_sensors_count;
+  /* built at open with IPMI_SDR_FLAGS_CACHE_INDEX */
+  off_t *index_offsets;
+  unsigned int index_offsets_count;
+  struct ipmi_sdr_index_entry *index_record_id_entries;
+  unsigned int index_record_id_entries_count;
+  struct ipmi_sdr_index_entry *index_sensor_entries;
+  unsigned int index_sensor_entries_count;
   int callback_lock;
 
   /* for saving/reset */
   List saved_offsets;
 
+  /* for short lived request/response/record objects */
+  fiid_arena_t arena;
+
+  /* last record decoded by the sensor record accessors, see
+   * _sdr_record_decode()
+   */
+  uint8_t decoded_record[IPMI_SDR_MAX_RECORD_LENGTH];
+  unsigned int decoded_record_len;
+  struct ipmi_sdr_record_decoded decoded;
+  uint64_t decoded_fields;
+
   /* Stats */
   int stats_compiled;
   struct ipmi_sdr_entity_count entity_counts[IPMI_MAX_ENTITY_IDS];
@@ -118,7 +118,7 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(obj_oem_record = fiid_obj_create (tmpl_sdr_oem_intel_node_manager_record)))
+  if (!(obj_oem_record = fiid_obj_create_in_arena (ctx->arena, tmpl_sdr_oem_intel_node_manager_record)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -60,27 +60,166 @@
 #define IPMI_SDR_PARSE_RECORD_TYPE_BMC_MESSAGE_CHANNEL_INFO_RECORD             0x0200
 #define IPMI_SDR_PARSE_RECORD_TYPE_OEM_RECORD                                  0x0400
 
-int
-ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
-                                   const void *sdr_record,
-                                   unsigned int sdr_record_len,
-                                   uint16_t *record_id,
-                                   uint8_t *record_type)
+/* Fields available in a decoded record.  SDR records from some
+ * motherboards are shorter than the spec says they should be, so
+ * accessors only fail on the fields they were actually asked for.
+ */
+#define SDR_DECODED_SENSOR_OWNER_ID                0x0000000000000001ULL
+#define SDR_DECODED_SENSOR_OWNER_LUN               0x0000000000000002ULL
+#define SDR_DECODED_SENSOR_NUMBER                  0x0000000000000004ULL
+#define SDR_DECODED_ENTITY_ID                      0x0000000000000008ULL
+#define SDR_DECODED_ENTITY_INSTANCE                0x0000000000000010ULL
+#define SDR_DECODED_SENSOR_CAPABILITIES            0x0000000000000020ULL
+#define SDR_DECODED_SENSOR_TYPE                    0x0000000000000040ULL
+#define SDR_DECODED_EVENT_READING_TYPE_CODE        0x0000000000000080ULL
+#define SDR_DECODED_ASSERTION_MASK_LS              0x0000000000000100ULL
+#define SDR_DECODED_ASSERTION_MASK_MS              0x0000000000000200ULL
+#define SDR_DECODED_DEASSERTION_MASK_LS            0x0000000000000400ULL
+#define SDR_DECODED_DEASSERTION_MASK_MS            0x0000000000000800ULL
+#define SDR_DECODED_READING_MASK_LS                0x0000000000001000ULL
+#define SDR_DECODED_READING_MASK_MS                0x0000000000002000ULL
+#define SDR_DECODED_SENSOR_UNIT1                   0x0000000000004000ULL
+#define SDR_DECODED_SENSOR_UNIT2                   0x0000000000008000ULL
+#define SDR_DECODED_SENSOR_UNIT3                   0x0000000000010000ULL
+#define SDR_DECODED_LINEARIZATION                  0x0000000000020000ULL
+#define SDR_DECODED_M_LS                           0x0000000000040000ULL
+#define SDR_DECODED_M_MS_TOLERANCE                 0x0000000000080000ULL
+#define SDR_DECODED_B_LS                           0x0000000000100000ULL
+#define SDR_DECODED_B_MS_ACCURACY_LS               0x0000000000200000ULL
+#define SDR_DECODED_SENSOR_DIRECTION               0x0000000000400000ULL
+#define SDR_DECODED_ACCURACY_MS_EXP                0x0000000000800000ULL
+#define SDR_DECODED_EXPONENTS                      0x0000000001000000ULL
+#define SDR_DECODED_ANALOG_CHARACTERISTICS         0x0000000002000000ULL
+#define SDR_DECODED_NOMINAL_READING                0x0000000004000000ULL
+#define SDR_DECODED_NORMAL_MAXIMUM                 0x0000000008000000ULL
+#define SDR_DECODED_NORMAL_MINIMUM                 0x0000000010000000ULL
+#define SDR_DECODED_SENSOR_MAXIMUM_READING         0x0000000020000000ULL
+#define SDR_DECODED_SENSOR_MINIMUM_READING         0x0000000040000000ULL
+#define SDR_DECODED_UPPER_NON_RECOVERABLE          0x0000000080000000ULL
+#define SDR_DECODED_UPPER_CRITICAL                 0x0000000100000000ULL
+#define SDR_DECODED_UPPER_NON_CRITICAL             0x0000000200000000ULL
+#define SDR_DECODED_LOWER_NON_RECOVERABLE          0x0000000400000000ULL
+#define SDR_DECODED_LOWER_CRITICAL                 0x0000000800000000ULL
+#define SDR_DECODED_LOWER_NON_CRITICAL             0x0000001000000000ULL
+#define SDR_DECODED_POSITIVE_HYSTERESIS            0x0000002000000000ULL
+#define SDR_DECODED_NEGATIVE_HYSTERESIS            0x0000004000000000ULL
+#define SDR_DECODED_SHARE_COUNT                    0x0000008000000000ULL
+#define SDR_DECODED_ID_STRING_INSTANCE_MODIFIER    0x0000010000000000ULL
+
+/* most raw readings decoded in one call, i.e. the thresholds */
+#define SDR_DECODED_VALUES_MAX                     6
+
+/* Byte offsets into sensor records, per the IPMI spec and the
+ * tmpl_sdr_*_record templates.  Offsets shared by all sensor record
+ * types are listed once.
+ */
+#define SDR_SENSOR_OWNER_LUN_INDEX                 6
+#define SDR_ENTITY_ID_INDEX                        8
+#define SDR_ENTITY_INSTANCE_INDEX                  9
+
+#define SDR_SENSOR_CAPABILITIES_INDEX              11
+#define SDR_SENSOR_TYPE_INDEX                      12
+#define SDR_EVENT_READING_TYPE_CODE_INDEX          13
+#define SDR_ASSERTION_MASK_INDEX                   14
+#define SDR_DEASSERTION_MASK_INDEX                 16
+#define SDR_READING_MASK_INDEX                     18
+#define SDR_SENSOR_UNIT1_INDEX                     20
+#define SDR_SENSOR_UNIT2_INDEX                     21
+#define SDR_SENSOR_UNIT3_INDEX                     22
+
+#define SDR_FULL_LINEARIZATION_INDEX               23
+#define SDR_FULL_M_LS_INDEX                        24
+#define SDR_FULL_M_MS_TOLERANCE_INDEX              25
+#define SDR_FULL_B_LS_INDEX                        26
+#define SDR_FULL_B_MS_ACCURACY_LS_INDEX            27
+#define SDR_FULL_ACCURACY_MS_EXP_DIRECTION_INDEX   28
+#define SDR_FULL_EXPONENTS_INDEX                   29
+#define SDR_FULL_ANALOG_CHARACTERISTICS_INDEX      30
+#define SDR_FULL_NOMINAL_READING_INDEX             31
+#define SDR_FULL_NORMAL_MAXIMUM_INDEX              32
+#define SDR_FULL_NORMAL_MINIMUM_INDEX              33
+#define SDR_FULL_SENSOR_MAXIMUM_READING_INDEX      34
+#define SDR_FULL_SENSOR_MINIMUM_READING_INDEX      35
+#define SDR_FULL_UPPER_NON_RECOVERABLE_INDEX       36
+#define SDR_FULL_UPPER_CRITICAL_INDEX              37
+#define SDR_FULL_UPPER_NON_CRITICAL_INDEX          38
+#define SDR_FULL_LOWER_NON_RECOVERABLE_INDEX       39
+#define SDR_FULL_LOWER_CRITICAL_INDEX              40
+#define SDR_FULL_LOWER_NON_CRITICAL_INDEX          41
+#define SDR_FULL_POSITIVE_HYSTERESIS_INDEX         42
+#define SDR_FULL_NEGATIVE_HYSTERESIS_INDEX         43
+#define SDR_FULL_ID_STRING_INDEX                   48
+
+#define SDR_COMPACT_SHARE_COUNT_DIRECTION_INDEX    23
+#define SDR_COMPACT_ID_STRING_MODIFIER_INDEX       24
+#define SDR_COMPACT_POSITIVE_HYSTERESIS_INDEX      25
+#define SDR_COMPACT_NEGATIVE_HYSTERESIS_INDEX      26
+#define SDR_COMPACT_ID_STRING_INDEX                32
+
+#define SDR_EVENT_ONLY_SENSOR_TYPE_INDEX           10
+#define SDR_EVENT_ONLY_EVENT_READING_TYPE_CODE_INDEX 11
+#define SDR_EVENT_ONLY_SHARE_COUNT_DIRECTION_INDEX 12
+#define SDR_EVENT_ONLY_ID_STRING_MODIFIER_INDEX    13
+#define SDR_EVENT_ONLY_ID_STRING_INDEX             17
+
+/* entity id/instance in generic and management controller device locators */
+#define SDR_DEVICE_LOCATOR_ENTITY_ID_INDEX         12
+#define SDR_DEVICE_LOCATOR_ENTITY_INSTANCE_INDEX   13
+
+struct sdr_record_decoded
+{
+  struct ipmi_sdr_record_decoded decoded;
+  uint64_t fields;
+};
+
+static int
+_sdr_record_type_acceptable (uint8_t record_type,
+                             uint32_t acceptable_record_types)
+{
+  if (((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD)
+       && record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD)
+          && record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD)
+          && record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_ENTITY_ASSOCIATION_RECORD)
+          && record_type == IPMI_SDR_FORMAT_ENTITY_ASSOCIATION_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
+          && record_type == IPMI_SDR_FORMAT_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
+
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_GENERIC_DEVICE_LOCATOR_RECORD)
+          && record_type == IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_FRU_DEVICE_LOCATOR_RECORD)
+          && record_type == IPMI_SDR_FORMAT_FRU_DEVICE_LOCATOR_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
+          && record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
+          && record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_BMC_MESSAGE_CHANNEL_INFO_RECORD)
+          && record_type == IPMI_SDR_FORMAT_BMC_MESSAGE_CHANNEL_INFO_RECORD)
+      || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_OEM_RECORD)
+          && record_type == IPMI_SDR_FORMAT_OEM_RECORD))
+    return (1);
+
+  return (0);
+}
+
+/* Returns pointer to the sdr record to parse, reading it out of the
+ * cache if necessary.
+ */
+static const uint8_t *
+_sdr_record_to_use (ipmi_sdr_ctx_t ctx,
+                    const void *sdr_record,
+                    unsigned int sdr_record_len,
+                    uint8_t *sdr_record_buf,
+                    unsigned int *sdr_record_len_to_use)
 {
-  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
   int sdr_record_buf_len;
-  fiid_obj_t obj_sdr_record_header = NULL;
-  int sdr_record_header_len;
-  void *sdr_record_to_use;
-  unsigned int sdr_record_len_to_use;
-  uint64_t val;
-  int rv = -1;
 
-  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
-    {
-      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
-      return (-1);
-    }
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (sdr_record_buf);
+  assert (sdr_record_len_to_use);
 
   if (!sdr_record || !sdr_record_len)
     {
@@ -93,80 +232,61 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
                                                                 IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
             {
               SDR_SET_INTERNAL_ERRNUM (ctx);
-              return (-1);
+              return (NULL);
             }
-          sdr_record_to_use = sdr_record_buf;
-          sdr_record_len_to_use = sdr_record_buf_len;
-        }
-      else
-        {
-          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
-          return (-1);
+          *sdr_record_len_to_use = sdr_record_buf_len;
+          return (sdr_record_buf);
         }
-    }
-  else
-    {
-      sdr_record_to_use = (void *)sdr_record;
-      sdr_record_len_to_use = sdr_record_len;
-    }
 
-  if ((sdr_record_header_len = fiid_template_len_bytes (tmpl_sdr_record_header)) < 0)
-    {
-      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-      goto cleanup;
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (NULL);
     }
 
-  if (sdr_record_len_to_use < sdr_record_header_len)
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
-      goto cleanup;
-    }
+  *sdr_record_len_to_use = sdr_record_len;
+  return (sdr_record);
+}
+
+int
+ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
+                                   const void *sdr_record,
+                                   unsigned int sdr_record_len,
+                                   uint16_t *record_id,
+                                   uint8_t *record_type)
+{
+  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
+  const uint8_t *sdr_record_to_use;
+  unsigned int sdr_record_len_to_use;
 
-  if (!(obj_sdr_record_header = fiid_obj_create (tmpl_sdr_record_header)))
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
     {
-      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-      goto cleanup;
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
     }
 
-  if (fiid_obj_set_all (obj_sdr_record_header,
-                        sdr_record_to_use,
-                        sdr_record_header_len) < 0)
+  if (!(sdr_record_to_use = _sdr_record_to_use (ctx,
+                                                sdr_record,
+                                                sdr_record_len,
+                                                sdr_record_buf,
+                                                &sdr_record_len_to_use)))
+    return (-1);
+
+  if (sdr_record_len_to_use < IPMI_SDR_RECORD_HEADER_LENGTH)
     {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
-      goto cleanup;
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
+      return (-1);
     }
 
   if (record_id)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_header,
-                        "record_id",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
-          goto cleanup;
-        }
-      *record_id = val;
-    }
+    *record_id = sdr_record_to_use[IPMI_SDR_RECORD_ID_INDEX_LS]
+      | ((uint16_t)sdr_record_to_use[IPMI_SDR_RECORD_ID_INDEX_MS] << 8);
 
   if (record_type)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_header,
-                        "record_type",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
-          goto cleanup;
-        }
-      *record_type = val;
-    }
+    *record_type = sdr_record_to_use[IPMI_SDR_RECORD_TYPE_INDEX];
 
   sdr_check_read_status (ctx);
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record_header);
-  return (rv);
+  return (0);
 }
 
 static fiid_obj_t
@@ -176,10 +296,10 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
                         uint32_t acceptable_record_types)
 {
   uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
-  int sdr_record_buf_len;
-  void *sdr_record_to_use;
+  const uint8_t *sdr_record_to_use;
   unsigned int sdr_record_len_to_use;
   fiid_obj_t obj_sdr_record = NULL;
+  fiid_field_t *tmpl_sdr_record = NULL;
   uint8_t record_type;
 
   assert (acceptable_record_types);
@@ -190,33 +310,12 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!sdr_record || !sdr_record_len)
-    {
-      if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE
-          && !sdr_record
-          && !sdr_record_len)
-        {
-          if ((sdr_record_buf_len = ipmi_sdr_cache_record_read (ctx,
-                                                                sdr_record_buf,
-                                                                IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
-            {
-              SDR_SET_INTERNAL_ERRNUM (ctx);
-              goto cleanup;
-            }
-          sdr_record_to_use = sdr_record_buf;
-          sdr_record_len_to_use = sdr_record_buf_len;
-        }
-      else
-        {
-          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
-          goto cleanup;
-        }
-    }
-  else
-    {
-      sdr_record_to_use = (void *)sdr_record;
-      sdr_record_len_to_use = sdr_record_len;
-    }
+  if (!(sdr_record_to_use = _sdr_record_to_use (ctx,
+                                                sdr_record,
+                                                sdr_record_len,
+                                                sdr_record_buf,
+                                                &sdr_record_len_to_use)))
+    goto cleanup;
 
   if (ipmi_sdr_parse_record_id_and_type (ctx,
                                          sdr_record_to_use,
@@ -228,122 +327,39 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD)
-         && record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD)
-            && record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD)
-            && record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_ENTITY_ASSOCIATION_RECORD)
-            && record_type == IPMI_SDR_FORMAT_ENTITY_ASSOCIATION_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
-            && record_type == IPMI_SDR_FORMAT_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
-
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_GENERIC_DEVICE_LOCATOR_RECORD)
-            && record_type == IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_FRU_DEVICE_LOCATOR_RECORD)
-            && record_type == IPMI_SDR_FORMAT_FRU_DEVICE_LOCATOR_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
-            && record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
-            && record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_BMC_MESSAGE_CHANNEL_INFO_RECORD)
-            && record_type == IPMI_SDR_FORMAT_BMC_MESSAGE_CHANNEL_INFO_RECORD)
-        || ((acceptable_record_types & IPMI_SDR_PARSE_RECORD_TYPE_OEM_RECORD)
-            && record_type == IPMI_SDR_FORMAT_OEM_RECORD)
-        ))
+  if (!_sdr_record_type_acceptable (record_type, acceptable_record_types))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
       goto cleanup;
     }
 
   if (record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_full_sensor_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_full_sensor_record;
   else if (record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_compact_sensor_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_compact_sensor_record;
   else if (record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_event_only_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_event_only_record;
   else if (record_type == IPMI_SDR_FORMAT_ENTITY_ASSOCIATION_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_entity_association_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_entity_association_record;
   else if (record_type == IPMI_SDR_FORMAT_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_device_relative_entity_association_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_device_relative_entity_association_record;
   else if (record_type == IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_generic_device_locator_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_generic_device_locator_record;
   else if (record_type == IPMI_SDR_FORMAT_FRU_DEVICE_LOCATOR_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_fru_device_locator_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_fru_device_locator_record;
   else if (record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_management_controller_device_locator_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_management_controller_device_locator_record;
   else if (record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_management_controller_confirmation_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
+    tmpl_sdr_record = tmpl_sdr_management_controller_confirmation_record;
   else if (record_type == IPMI_SDR_FORMAT_BMC_MESSAGE_CHANNEL_INFO_RECORD)
+    tmpl_sdr_record = tmpl_sdr_bmc_message_channel_info_record;
+  else /* record_type == IPMI_SDR_FORMAT_OEM_RECORD */
+    tmpl_sdr_record = tmpl_sdr_oem_record;
+
+  if (!(obj_sdr_record = fiid_obj_create_in_arena (ctx->arena, tmpl_sdr_record)))
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_bmc_message_channel_info_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
-    }
-  else if (record_type == IPMI_SDR_FORMAT_OEM_RECORD)
-    {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_oem_record)))
-        {
-          SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
-          goto cleanup;
-        }
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
     }
 
   if (fiid_obj_set_all (obj_sdr_record,
@@ -363,110 +379,602 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
   return (NULL);
 }
 
-int
-ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
-                                const void *sdr_record,
-                                unsigned int sdr_record_len,
-                                uint8_t *sensor_owner_id_type,
-                                uint8_t *sensor_owner_id)
+static int8_t
+_sdr_decode_exponent (uint8_t val)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
+  int8_t exponent = val & 0x0F;
 
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
+  if (exponent & 0x08)
+    exponent |= 0xF0;
+  return (exponent);
+}
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+static int16_t
+_sdr_decode_m_b (uint8_t ls, uint8_t ms)
+{
+  int16_t val;
+
+  val = ls;
+  val |= (((int16_t)ms & 0x3) << 8);
+  if (val & 0x200)
+    val |= 0xFE00;
+  return (val);
+}
 
-  if (sensor_owner_id_type)
+static uint8_t
+_sdr_decode_unit (uint8_t unit)
+{
+  if (!IPMI_SENSOR_UNIT_VALID (unit))
+    return (IPMI_SENSOR_UNIT_UNSPECIFIED);
+  return (unit);
+}
+
+/* Decode a full, compact, or event only record in one pass over the
+ * record bytes.  The entity id and instance of generic and management
+ * controller device locator records are decoded as well.  Fields
+ * beyond the end of the record are zeroed and not flagged in 'fields'.
+ *
+ * Callers usually ask for several fields of the same record in a
+ * row, so the last decode is kept in the context and reused while
+ * the record bytes are unchanged.
+ */
+static int
+_sdr_record_decode (ipmi_sdr_ctx_t ctx,
+                    const void *sdr_record,
+                    unsigned int sdr_record_len,
+                    uint32_t acceptable_record_types,
+                    struct sdr_record_decoded *rd)
+{
+  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
+  const uint8_t *buf;
+  unsigned int len;
+  unsigned int id_string_index;
+  unsigned int record_len;
+  struct ipmi_sdr_record_decoded *d;
+
+  assert (acceptable_record_types);
+  assert (rd);
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_id.type",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_owner_id_type = val;
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
     }
 
-  if (sensor_owner_id)
+  if (!(buf = _sdr_record_to_use (ctx,
+                                  sdr_record,
+                                  sdr_record_len,
+                                  sdr_record_buf,
+                                  &len)))
+    return (-1);
+
+  if (len < IPMI_SDR_RECORD_HEADER_LENGTH)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_id",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_owner_id = val;
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
+      return (-1);
     }
 
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
-}
+  if (!_sdr_record_type_acceptable (buf[IPMI_SDR_RECORD_TYPE_INDEX], acceptable_record_types))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+      return (-1);
+    }
 
-int
-ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
-                                 const void *sdr_record,
-                                 unsigned int sdr_record_len,
-                                 uint8_t *sensor_owner_lun,
-                                 uint8_t *channel_number)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
+  if (len == ctx->decoded_record_len
+      && !memcmp (buf, ctx->decoded_record, len))
+    {
+      memcpy (&rd->decoded, &ctx->decoded, sizeof (struct ipmi_sdr_record_decoded));
+      rd->fields = ctx->decoded_fields;
+      goto out;
+    }
+  record_len = len;
 
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
+  memset (rd, '\0', sizeof (struct sdr_record_decoded));
+  d = &rd->decoded;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  d->record_id = buf[IPMI_SDR_RECORD_ID_INDEX_LS]
+    | ((uint16_t)buf[IPMI_SDR_RECORD_ID_INDEX_MS] << 8);
+  d->record_type = buf[IPMI_SDR_RECORD_TYPE_INDEX];
 
-  if (sensor_owner_lun)
+  if (d->record_type == IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD
+      || d->record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_lun",
-                        &val) < 0)
+      if (len > SDR_DEVICE_LOCATOR_ENTITY_ID_INDEX)
         {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
+          d->entity_id = buf[SDR_DEVICE_LOCATOR_ENTITY_ID_INDEX];
+          rd->fields |= SDR_DECODED_ENTITY_ID;
         }
-      *sensor_owner_lun = val;
+      if (len > SDR_DEVICE_LOCATOR_ENTITY_INSTANCE_INDEX)
+        {
+          d->entity_instance = buf[SDR_DEVICE_LOCATOR_ENTITY_INSTANCE_INDEX] & 0x7F;
+          d->entity_instance_type = buf[SDR_DEVICE_LOCATOR_ENTITY_INSTANCE_INDEX] >> 7;
+          rd->fields |= SDR_DECODED_ENTITY_INSTANCE;
+        }
+      goto decoded;
     }
 
-  if (channel_number)
+  if (d->record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+    id_string_index = SDR_FULL_ID_STRING_INDEX;
+  else if (d->record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+    id_string_index = SDR_COMPACT_ID_STRING_INDEX;
+  else
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *channel_number = val;
+      assert (d->record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD);
+      id_string_index = SDR_EVENT_ONLY_ID_STRING_INDEX;
     }
 
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  /* anything past the max length id string is ignored */
+  if (len > id_string_index + IPMI_SDR_MAX_ID_STRING_LENGTH)
+    len = id_string_index + IPMI_SDR_MAX_ID_STRING_LENGTH;
+
+  /* Record Key Bytes */
+  if (len > IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX)
+    {
+      d->sensor_owner_id_type = buf[IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX] & 0x01;
+      d->sensor_owner_id = buf[IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX] >> 1;
+      rd->fields |= SDR_DECODED_SENSOR_OWNER_ID;
+    }
+  if (len > SDR_SENSOR_OWNER_LUN_INDEX)
+    {
+      d->sensor_owner_lun = buf[SDR_SENSOR_OWNER_LUN_INDEX] & 0x03;
+      d->channel_number = buf[SDR_SENSOR_OWNER_LUN_INDEX] >> 4;
+      rd->fields |= SDR_DECODED_SENSOR_OWNER_LUN;
+    }
+  if (len > IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX)
+    {
+      d->sensor_number = buf[IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX];
+      rd->fields |= SDR_DECODED_SENSOR_NUMBER;
+    }
+
+  /* Record Body Bytes */
+  if (len > SDR_ENTITY_ID_INDEX)
+    {
+      d->entity_id = buf[SDR_ENTITY_ID_INDEX];
+      rd->fields |= SDR_DECODED_ENTITY_ID;
+    }
+  if (len > SDR_ENTITY_INSTANCE_INDEX)
+    {
+      d->entity_instance = buf[SDR_ENTITY_INSTANCE_INDEX] & 0x7F;
+      d->entity_instance_type = buf[SDR_ENTITY_INSTANCE_INDEX] >> 7;
+      rd->fields |= SDR_DECODED_ENTITY_INSTANCE;
+    }
+
+  if (d->record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
+    {
+      if (len > SDR_EVENT_ONLY_SENSOR_TYPE_INDEX)
+        {
+          d->sensor_type = buf[SDR_EVENT_ONLY_SENSOR_TYPE_INDEX];
+          rd->fields |= SDR_DECODED_SENSOR_TYPE;
+        }
+      if (len > SDR_EVENT_ONLY_EVENT_READING_TYPE_CODE_INDEX)
+        {
+          d->event_reading_type_code = buf[SDR_EVENT_ONLY_EVENT_READING_TYPE_CODE_INDEX];
+          rd->fields |= SDR_DECODED_EVENT_READING_TYPE_CODE;
+        }
+      if (len > SDR_EVENT_ONLY_SHARE_COUNT_DIRECTION_INDEX)
+        {
+          d->share_count = buf[SDR_EVENT_ONLY_SHARE_COUNT_DIRECTION_INDEX] & 0x0F;
+          d->id_string_instance_modifier_type = (buf[SDR_EVENT_ONLY_SHARE_COUNT_DIRECTION_INDEX] >> 4) & 0x03;
+          d->sensor_direction = buf[SDR_EVENT_ONLY_SHARE_COUNT_DIRECTION_INDEX] >> 6;
+          rd->fields |= (SDR_DECODED_SHARE_COUNT | SDR_DECODED_SENSOR_DIRECTION);
+        }
+      if (len > SDR_EVENT_ONLY_ID_STRING_MODIFIER_INDEX)
+        {
+          d->id_string_instance_modifier_offset = buf[SDR_EVENT_ONLY_ID_STRING_MODIFIER_INDEX] & 0x7F;
+          d->entity_instance_sharing = buf[SDR_EVENT_ONLY_ID_STRING_MODIFIER_INDEX] >> 7;
+          rd->fields |= SDR_DECODED_ID_STRING_INSTANCE_MODIFIER;
+        }
+      goto id_string;
+    }
+
+  /* Full and Compact records */
+  if (len > SDR_SENSOR_CAPABILITIES_INDEX)
+    {
+      uint8_t val = buf[SDR_SENSOR_CAPABILITIES_INDEX];
+
+      d->event_message_control_support = val & 0x03;
+      d->threshold_access_support = (val >> 2) & 0x03;
+      d->hysteresis_support = (val >> 4) & 0x03;
+      d->auto_re_arm_support = (val >> 6) & 0x01;
+      d->entity_ignore_support = val >> 7;
+      rd->fields |= SDR_DECODED_SENSOR_CAPABILITIES;
+    }
+  if (len > SDR_SENSOR_TYPE_INDEX)
+    {
+      d->sensor_type = buf[SDR_SENSOR_TYPE_INDEX];
+      rd->fields |= SDR_DECODED_SENSOR_TYPE;
+    }
+  if (len > SDR_EVENT_READING_TYPE_CODE_INDEX)
+    {
+      d->event_reading_type_code = buf[SDR_EVENT_READING_TYPE_CODE_INDEX];
+      rd->fields |= SDR_DECODED_EVENT_READING_TYPE_CODE;
+    }
+  if (len > SDR_ASSERTION_MASK_INDEX)
+    {
+      d->assertion_event_mask = buf[SDR_ASSERTION_MASK_INDEX];
+      rd->fields |= SDR_DECODED_ASSERTION_MASK_LS;
+    }
+  if (len > SDR_ASSERTION_MASK_INDEX + 1)
+    {
+      d->assertion_event_mask |= ((uint16_t)buf[SDR_ASSERTION_MASK_INDEX + 1] << 8);
+      rd->fields |= SDR_DECODED_ASSERTION_MASK_MS;
+    }
+  if (len > SDR_DEASSERTION_MASK_INDEX)
+    {
+      d->deassertion_event_mask = buf[SDR_DEASSERTION_MASK_INDEX];
+      rd->fields |= SDR_DECODED_DEASSERTION_MASK_LS;
+    }
+  if (len > SDR_DEASSERTION_MASK_INDEX + 1)
+    {
+      d->deassertion_event_mask |= ((uint16_t)buf[SDR_DEASSERTION_MASK_INDEX + 1] << 8);
+      rd->fields |= SDR_DECODED_DEASSERTION_MASK_MS;
+    }
+  if (len > SDR_READING_MASK_INDEX)
+    {
+      d->reading_mask = buf[SDR_READING_MASK_INDEX];
+      rd->fields |= SDR_DECODED_READING_MASK_LS;
+    }
+  if (len > SDR_READING_MASK_INDEX + 1)
+    {
+      d->reading_mask |= ((uint16_t)buf[SDR_READING_MASK_INDEX + 1] << 8);
+      rd->fields |= SDR_DECODED_READING_MASK_MS;
+    }
+  if (len > SDR_SENSOR_UNIT1_INDEX)
+    {
+      uint8_t val = buf[SDR_SENSOR_UNIT1_INDEX];
+
+      d->sensor_units_percentage = val & 0x01;
+      d->sensor_units_modifier = (val >> 1) & 0x03;
+      d->sensor_units_rate = (val >> 3) & 0x07;
+      d->analog_data_format = val >> 6;
+      rd->fields |= SDR_DECODED_SENSOR_UNIT1;
+    }
+  if (len > SDR_SENSOR_UNIT2_INDEX)
+    {
+      d->sensor_base_unit_type = _sdr_decode_unit (buf[SDR_SENSOR_UNIT2_INDEX]);
+      rd->fields |= SDR_DECODED_SENSOR_UNIT2;
+    }
+  if (len > SDR_SENSOR_UNIT3_INDEX)
+    {
+      d->sensor_modifier_unit_type = _sdr_decode_unit (buf[SDR_SENSOR_UNIT3_INDEX]);
+      rd->fields |= SDR_DECODED_SENSOR_UNIT3;
+    }
+
+  if (d->record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+    {
+      if (len > SDR_COMPACT_SHARE_COUNT_DIRECTION_INDEX)
+        {
+          d->share_count = buf[SDR_COMPACT_SHARE_COUNT_DIRECTION_INDEX] & 0x0F;
+          d->id_string_instance_modifier_type = (buf[SDR_COMPACT_SHARE_COUNT_DIRECTION_INDEX] >> 4) & 0x03;
+          d->sensor_direction = buf[SDR_COMPACT_SHARE_COUNT_DIRECTION_INDEX] >> 6;
+          rd->fields |= (SDR_DECODED_SHARE_COUNT | SDR_DECODED_SENSOR_DIRECTION);
+        }
+      if (len > SDR_COMPACT_ID_STRING_MODIFIER_INDEX)
+        {
+          d->id_string_instance_modifier_offset = buf[SDR_COMPACT_ID_STRING_MODIFIER_INDEX] & 0x7F;
+          d->entity_instance_sharing = buf[SDR_COMPACT_ID_STRING_MODIFIER_INDEX] >> 7;
+          rd->fields |= SDR_DECODED_ID_STRING_INSTANCE_MODIFIER;
+        }
+      if (len > SDR_COMPACT_POSITIVE_HYSTERESIS_INDEX)
+        {
+          d->positive_going_threshold_hysteresis = buf[SDR_COMPACT_POSITIVE_HYSTERESIS_INDEX];
+          rd->fields |= SDR_DECODED_POSITIVE_HYSTERESIS;
+        }
+      if (len > SDR_COMPACT_NEGATIVE_HYSTERESIS_INDEX)
+        {
+          d->negative_going_threshold_hysteresis = buf[SDR_COMPACT_NEGATIVE_HYSTERESIS_INDEX];
+          rd->fields |= SDR_DECODED_NEGATIVE_HYSTERESIS;
+        }
+      goto id_string;
+    }
+
+  /* Full records */
+  if (len > SDR_FULL_LINEARIZATION_INDEX)
+    {
+      d->linearization = buf[SDR_FULL_LINEARIZATION_INDEX] & 0x7F;
+      rd->fields |= SDR_DECODED_LINEARIZATION;
+    }
+  if (len > SDR_FULL_M_LS_INDEX)
+    {
+      d->m = _sdr_decode_m_b (buf[SDR_FULL_M_LS_INDEX], 0);
+      rd->fields |= SDR_DECODED_M_LS;
+    }
+  if (len > SDR_FULL_M_MS_TOLERANCE_INDEX)
+    {
+      d->m = _sdr_decode_m_b (buf[SDR_FULL_M_LS_INDEX],
+                              buf[SDR_FULL_M_MS_TOLERANCE_INDEX] >> 6);
+      d->tolerance = buf[SDR_FULL_M_MS_TOLERANCE_INDEX] & 0x3F;
+      rd->fields |= SDR_DECODED_M_MS_TOLERANCE;
+    }
+  if (len > SDR_FULL_B_LS_INDEX)
+    {
+      d->b = _sdr_decode_m_b (buf[SDR_FULL_B_LS_INDEX], 0);
+      rd->fields |= SDR_DECODED_B_LS;
+    }
+  if (len > SDR_FULL_B_MS_ACCURACY_LS_INDEX)
+    {
+      d->b = _sdr_decode_m_b (buf[SDR_FULL_B_LS_INDEX],
+                              buf[SDR_FULL_B_MS_ACCURACY_LS_INDEX] >> 6);
+      d->accuracy = buf[SDR_FULL_B_MS_ACCURACY_LS_INDEX] & 0x3F;
+      rd->fields |= SDR_DECODED_B_MS_ACCURACY_LS;
+    }
+  if (len > SDR_FULL_ACCURACY_MS_EXP_DIRECTION_INDEX)
+    {
+      uint8_t val = buf[SDR_FULL_ACCURACY_MS_EXP_DIRECTION_INDEX];
+
+      d->sensor_direction = val & 0x03;
+      d->accuracy_exp = (val >> 2) & 0x03;
+      /* accuracy is unsigned, no need to sign extend */
+      d->accuracy |= (((uint16_t)(val >> 4)) << 6);
+      rd->fields |= (SDR_DECODED_SENSOR_DIRECTION | SDR_DECODED_ACCURACY_MS_EXP);
+    }
+  if (len > SDR_FULL_EXPONENTS_INDEX)
+    {
+      d->b_exponent = _sdr_decode_exponent (buf[SDR_FULL_EXPONENTS_INDEX]);
+      d->r_exponent = _sdr_decode_exponent (buf[SDR_FULL_EXPONENTS_INDEX] >> 4);
+      rd->fields |= SDR_DECODED_EXPONENTS;
+    }
+  if (len > SDR_FULL_ANALOG_CHARACTERISTICS_INDEX)
+    {
+      uint8_t val = buf[SDR_FULL_ANALOG_CHARACTERISTICS_INDEX];
+
+      d->nominal_reading_specified = val & 0x01;
+      d->normal_maximum_specified = (val >> 1) & 0x01;
+      d->normal_minimum_specified = (val >> 2) & 0x01;
+      rd->fields |= SDR_DECODED_ANALOG_CHARACTERISTICS;
+    }
+  if (len > SDR_FULL_NOMINAL_READING_INDEX)
+    {
+      d->nominal_reading = buf[SDR_FULL_NOMINAL_READING_INDEX];
+      rd->fields |= SDR_DECODED_NOMINAL_READING;
+    }
+  if (len > SDR_FULL_NORMAL_MAXIMUM_INDEX)
+    {
+      d->normal_maximum = buf[SDR_FULL_NORMAL_MAXIMUM_INDEX];
+      rd->fields |= SDR_DECODED_NORMAL_MAXIMUM;
+    }
+  if (len > SDR_FULL_NORMAL_MINIMUM_INDEX)
+    {
+      d->normal_minimum = buf[SDR_FULL_NORMAL_MINIMUM_INDEX];
+      rd->fields |= SDR_DECODED_NORMAL_MINIMUM;
+    }
+  if (len > SDR_FULL_SENSOR_MAXIMUM_READING_INDEX)
+    {
+      d->sensor_maximum_reading = buf[SDR_FULL_SENSOR_MAXIMUM_READING_INDEX];
+      rd->fields |= SDR_DECODED_SENSOR_MAXIMUM_READING;
+    }
+  if (len > SDR_FULL_SENSOR_MINIMUM_READING_INDEX)
+    {
+      d->sensor_minimum_reading = buf[SDR_FULL_SENSOR_MINIMUM_READING_INDEX];
+      rd->fields |= SDR_DECODED_SENSOR_MINIMUM_READING;
+    }
+  if (len > SDR_FULL_UPPER_NON_RECOVERABLE_INDEX)
+    {
+      d->upper_non_recoverable_threshold = buf[SDR_FULL_UPPER_NON_RECOVERABLE_INDEX];
+      rd->fields |= SDR_DECODED_UPPER_NON_RECOVERABLE;
+    }
+  if (len > SDR_FULL_UPPER_CRITICAL_INDEX)
+    {
+      d->upper_critical_threshold = buf[SDR_FULL_UPPER_CRITICAL_INDEX];
+      rd->fields |= SDR_DECODED_UPPER_CRITICAL;
+    }
+  if (len > SDR_FULL_UPPER_NON_CRITICAL_INDEX)
+    {
+      d->upper_non_critical_threshold = buf[SDR_FULL_UPPER_NON_CRITICAL_INDEX];
+      rd->fields |= SDR_DECODED_UPPER_NON_CRITICAL;
+    }
+  if (len > SDR_FULL_LOWER_NON_RECOVERABLE_INDEX)
+    {
+      d->lower_non_recoverable_threshold = buf[SDR_FULL_LOWER_NON_RECOVERABLE_INDEX];
+      rd->fields |= SDR_DECODED_LOWER_NON_RECOVERABLE;
+    }
+  if (len > SDR_FULL_LOWER_CRITICAL_INDEX)
+    {
+      d->lower_critical_threshold = buf[SDR_FULL_LOWER_CRITICAL_INDEX];
+      rd->fields |= SDR_DECODED_LOWER_CRITICAL;
+    }
+  if (len > SDR_FULL_LOWER_NON_CRITICAL_INDEX)
+    {
+      d->lower_non_critical_threshold = buf[SDR_FULL_LOWER_NON_CRITICAL_INDEX];
+      rd->fields |= SDR_DECODED_LOWER_NON_CRITICAL;
+    }
+  if (len > SDR_FULL_POSITIVE_HYSTERESIS_INDEX)
+    {
+      d->positive_going_threshold_hysteresis = buf[SDR_FULL_POSITIVE_HYSTERESIS_INDEX];
+      rd->fields |= SDR_DECODED_POSITIVE_HYSTERESIS;
+    }
+  if (len > SDR_FULL_NEGATIVE_HYSTERESIS_INDEX)
+    {
+      d->negative_going_threshold_hysteresis = buf[SDR_FULL_NEGATIVE_HYSTERESIS_INDEX];
+      rd->fields |= SDR_DECODED_NEGATIVE_HYSTERESIS;
+    }
+
+ id_string:
+  if (len > id_string_index)
+    {
+      d->id_string_len = len - id_string_index;
+      memcpy (d->id_string, buf + id_string_index, d->id_string_len);
+    }
+
+ decoded:
+  if (record_len <= IPMI_SDR_MAX_RECORD_LENGTH)
+    {
+      memcpy (ctx->decoded_record, buf, record_len);
+      ctx->decoded_record_len = record_len;
+      memcpy (&ctx->decoded, &rd->decoded, sizeof (struct ipmi_sdr_record_decoded));
+      ctx->decoded_fields = rd->fields;
+    }
+
+ out:
+  sdr_check_read_status (ctx);
+  return (0);
+}
+
+/* Fail with the same error a fiid object would for fields that were
+ * not available in the record.
+ */
+static int
+_sdr_record_decoded_check (ipmi_sdr_ctx_t ctx,
+                           const struct sdr_record_decoded *rd,
+                           uint64_t fields)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (rd);
+
+  if ((rd->fields & fields) != fields)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+      return (-1);
+    }
+  return (0);
+}
+
+int
+ipmi_sdr_parse_record_decoded (ipmi_sdr_ctx_t ctx,
+                               const void *sdr_record,
+                               unsigned int sdr_record_len,
+                               struct ipmi_sdr_record_decoded *decoded)
+{
+  struct sdr_record_decoded rd;
+  uint32_t acceptable_record_types;
+  uint64_t fields;
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!decoded)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
+
+  /* everything up to the id string must be present */
+  fields = SDR_DECODED_SENSOR_OWNER_ID | SDR_DECODED_SENSOR_OWNER_LUN
+    | SDR_DECODED_SENSOR_NUMBER | SDR_DECODED_ENTITY_ID
+    | SDR_DECODED_ENTITY_INSTANCE | SDR_DECODED_SENSOR_TYPE
+    | SDR_DECODED_EVENT_READING_TYPE_CODE | SDR_DECODED_SENSOR_DIRECTION;
+
+  if (rd.decoded.record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+    fields |= SDR_DECODED_SENSOR_CAPABILITIES
+      | SDR_DECODED_ASSERTION_MASK_LS | SDR_DECODED_ASSERTION_MASK_MS
+      | SDR_DECODED_DEASSERTION_MASK_LS | SDR_DECODED_DEASSERTION_MASK_MS
+      | SDR_DECODED_READING_MASK_LS | SDR_DECODED_READING_MASK_MS
+      | SDR_DECODED_SENSOR_UNIT1 | SDR_DECODED_SENSOR_UNIT2 | SDR_DECODED_SENSOR_UNIT3
+      | SDR_DECODED_LINEARIZATION | SDR_DECODED_M_LS | SDR_DECODED_M_MS_TOLERANCE
+      | SDR_DECODED_B_LS | SDR_DECODED_B_MS_ACCURACY_LS | SDR_DECODED_ACCURACY_MS_EXP
+      | SDR_DECODED_EXPONENTS | SDR_DECODED_ANALOG_CHARACTERISTICS
+      | SDR_DECODED_NOMINAL_READING | SDR_DECODED_NORMAL_MAXIMUM
+      | SDR_DECODED_NORMAL_MINIMUM | SDR_DECODED_SENSOR_MAXIMUM_READING
+      | SDR_DECODED_SENSOR_MINIMUM_READING | SDR_DECODED_UPPER_NON_RECOVERABLE
+      | SDR_DECODED_UPPER_CRITICAL | SDR_DECODED_UPPER_NON_CRITICAL
+      | SDR_DECODED_LOWER_NON_RECOVERABLE | SDR_DECODED_LOWER_CRITICAL
+      | SDR_DECODED_LOWER_NON_CRITICAL | SDR_DECODED_POSITIVE_HYSTERESIS
+      | SDR_DECODED_NEGATIVE_HYSTERESIS;
+  else if (rd.decoded.record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+    fields |= SDR_DECODED_SENSOR_CAPABILITIES
+      | SDR_DECODED_ASSERTION_MASK_LS | SDR_DECODED_ASSERTION_MASK_MS
+      | SDR_DECODED_DEASSERTION_MASK_LS | SDR_DECODED_DEASSERTION_MASK_MS
+      | SDR_DECODED_READING_MASK_LS | SDR_DECODED_READING_MASK_MS
+      | SDR_DECODED_SENSOR_UNIT1 | SDR_DECODED_SENSOR_UNIT2 | SDR_DECODED_SENSOR_UNIT3
+      | SDR_DECODED_SHARE_COUNT | SDR_DECODED_ID_STRING_INSTANCE_MODIFIER
+      | SDR_DECODED_POSITIVE_HYSTERESIS | SDR_DECODED_NEGATIVE_HYSTERESIS;
+  else
+    fields |= SDR_DECODED_SHARE_COUNT | SDR_DECODED_ID_STRING_INSTANCE_MODIFIER;
+
+  if ((rd.fields & fields) != fields)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
+      return (-1);
+    }
+
+  memcpy (decoded, &rd.decoded, sizeof (struct ipmi_sdr_record_decoded));
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
+                                const void *sdr_record,
+                                unsigned int sdr_record_len,
+                                uint8_t *sensor_owner_id_type,
+                                uint8_t *sensor_owner_id)
+{
+  struct sdr_record_decoded rd;
+  uint32_t acceptable_record_types;
+
+  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
+
+  if (sensor_owner_id_type || sensor_owner_id)
+    {
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_OWNER_ID) < 0)
+        return (-1);
+      if (sensor_owner_id_type)
+        *sensor_owner_id_type = rd.decoded.sensor_owner_id_type;
+      if (sensor_owner_id)
+        *sensor_owner_id = rd.decoded.sensor_owner_id;
+    }
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
+                                 const void *sdr_record,
+                                 unsigned int sdr_record_len,
+                                 uint8_t *sensor_owner_lun,
+                                 uint8_t *channel_number)
+{
+  struct sdr_record_decoded rd;
+  uint32_t acceptable_record_types;
+
+  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
+
+  if (sensor_owner_lun || channel_number)
+    {
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_OWNER_LUN) < 0)
+        return (-1);
+      if (sensor_owner_lun)
+        *sensor_owner_lun = rd.decoded.sensor_owner_lun;
+      if (channel_number)
+        *channel_number = rd.decoded.channel_number;
+    }
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
 }
 
 int
@@ -475,38 +983,29 @@ ipmi_sdr_parse_sensor_number (ipmi_sdr_ctx_t ctx,
                               unsigned int sdr_record_len,
                               uint8_t *sensor_number)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (sensor_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_number",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_number = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_NUMBER) < 0)
+        return (-1);
+      *sensor_number = rd.decoded.sensor_number;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -517,10 +1016,8 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
                                         uint8_t *entity_instance,
                                         uint8_t *entity_instance_type)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
@@ -528,51 +1025,31 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_GENERIC_DEVICE_LOCATOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (entity_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_id",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *entity_id = val;
-    }
-  if (entity_instance)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *entity_instance = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_ENTITY_ID) < 0)
+        return (-1);
+      *entity_id = rd.decoded.entity_id;
     }
-  if (entity_instance_type)
+  if (entity_instance || entity_instance_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance.type",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *entity_instance_type = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_ENTITY_INSTANCE) < 0)
+        return (-1);
+      if (entity_instance)
+        *entity_instance = rd.decoded.entity_instance;
+      if (entity_instance_type)
+        *entity_instance_type = rd.decoded.entity_instance_type;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -581,38 +1058,29 @@ ipmi_sdr_parse_sensor_type (ipmi_sdr_ctx_t ctx,
                             unsigned int sdr_record_len,
                             uint8_t *sensor_type)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (sensor_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_type",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_type = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_TYPE) < 0)
+        return (-1);
+      *sensor_type = rd.decoded.sensor_type;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -621,38 +1089,29 @@ ipmi_sdr_parse_event_reading_type_code (ipmi_sdr_ctx_t ctx,
                                         unsigned int sdr_record_len,
                                         uint8_t *event_reading_type_code)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (event_reading_type_code)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "event_reading_type_code",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *event_reading_type_code = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_EVENT_READING_TYPE_CODE) < 0)
+        return (-1);
+      *event_reading_type_code = rd.decoded.event_reading_type_code;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -662,38 +1121,34 @@ ipmi_sdr_parse_id_string (ipmi_sdr_ctx_t ctx,
                           char *id_string,
                           unsigned int id_string_len)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
   int len = 0;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (id_string && id_string_len)
     {
-      if ((len = fiid_obj_get_data (obj_sdr_record,
-                                    "id_string",
-                                    id_string,
-                                    id_string_len)) < 0)
+      if (rd.decoded.id_string_len > id_string_len)
         {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+          return (-1);
         }
+      memcpy (id_string, rd.decoded.id_string, rd.decoded.id_string_len);
+      len = rd.decoded.id_string_len;
     }
 
-  rv = len;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (len);
 }
 
 int
@@ -706,92 +1161,47 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
                              uint8_t *sensor_base_unit_type,
                              uint8_t *sensor_modifier_unit_type)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (sensor_units_percentage)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.percentage",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_units_percentage = val;
-    }
-
-  if (sensor_units_modifier)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.modifier_unit",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_units_modifier = val;
-    }
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
-  if (sensor_units_rate)
+  if (sensor_units_percentage || sensor_units_modifier || sensor_units_rate)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.rate_unit",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-
-      *sensor_units_rate = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_UNIT1) < 0)
+        return (-1);
+      if (sensor_units_percentage)
+        *sensor_units_percentage = rd.decoded.sensor_units_percentage;
+      if (sensor_units_modifier)
+        *sensor_units_modifier = rd.decoded.sensor_units_modifier;
+      if (sensor_units_rate)
+        *sensor_units_rate = rd.decoded.sensor_units_rate;
     }
 
   if (sensor_base_unit_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit2.base_unit",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_base_unit_type = val;
-
-      if (!IPMI_SENSOR_UNIT_VALID (*sensor_base_unit_type))
-        *sensor_base_unit_type = IPMI_SENSOR_UNIT_UNSPECIFIED;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_UNIT2) < 0)
+        return (-1);
+      *sensor_base_unit_type = rd.decoded.sensor_base_unit_type;
     }
 
   if (sensor_modifier_unit_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit3.modifier_unit",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_modifier_unit_type = val;
-
-      if (!IPMI_SENSOR_UNIT_VALID (*sensor_modifier_unit_type))
-        *sensor_modifier_unit_type = IPMI_SENSOR_UNIT_UNSPECIFIED;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_UNIT3) < 0)
+        return (-1);
+      *sensor_modifier_unit_type = rd.decoded.sensor_modifier_unit_type;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -804,81 +1214,41 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
                                     uint8_t *auto_re_arm_support,
                                     uint8_t *entity_ignore_support)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (event_message_control_support)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.event_message_control_support",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *event_message_control_support = val;
-    }
-  if (threshold_access_support)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.threshold_access_support",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *threshold_access_support = val;
-    }
-  if (hysteresis_support)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.hysteresis_support",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *hysteresis_support = val;
-    }
-  if (auto_re_arm_support)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.auto_re_arm_support",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *auto_re_arm_support = val;
-    }
-  if (entity_ignore_support)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.entity_ignore_support",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *entity_ignore_support = val;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
+
+  if (event_message_control_support
+      || threshold_access_support
+      || hysteresis_support
+      || auto_re_arm_support
+      || entity_ignore_support)
+    {
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_CAPABILITIES) < 0)
+        return (-1);
+      if (event_message_control_support)
+        *event_message_control_support = rd.decoded.event_message_control_support;
+      if (threshold_access_support)
+        *threshold_access_support = rd.decoded.threshold_access_support;
+      if (hysteresis_support)
+        *hysteresis_support = rd.decoded.hysteresis_support;
+      if (auto_re_arm_support)
+        *auto_re_arm_support = rd.decoded.auto_re_arm_support;
+      if (entity_ignore_support)
+        *entity_ignore_support = rd.decoded.entity_ignore_support;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -887,37 +1257,130 @@ ipmi_sdr_parse_sensor_direction (ipmi_sdr_ctx_t ctx,
                                  unsigned int sdr_record_len,
                                  uint8_t *sensor_direction)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (sensor_direction)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_direction",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *sensor_direction = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SENSOR_DIRECTION) < 0)
+        return (-1);
+      *sensor_direction = rd.decoded.sensor_direction;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
+}
+
+/* Output bits of a 16 bit event/reading mask.  Bits 0-7 come from the
+ * first byte of the mask and bits 8-15 from the second, either of
+ * which may be missing from a short record.
+ */
+static int
+_sdr_parse_mask_bits (ipmi_sdr_ctx_t ctx,
+                      const struct sdr_record_decoded *rd,
+                      uint16_t mask,
+                      uint64_t mask_ls_field,
+                      uint64_t mask_ms_field,
+                      unsigned int first_bit,
+                      uint8_t **bits,
+                      unsigned int bits_len)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (rd);
+  assert (bits);
+  assert ((first_bit + bits_len) <= 16);
+
+  for (i = 0; i < bits_len; i++)
+    {
+      unsigned int bit = first_bit + i;
+
+      if (!bits[i])
+        continue;
+
+      if (_sdr_record_decoded_check (ctx,
+                                     rd,
+                                     bit < 8 ? mask_ls_field : mask_ms_field) < 0)
+        return (-1);
+
+      *bits[i] = (mask >> bit) & 0x1;
+    }
+
+  return (0);
+}
+
+static int
+_sdr_parse_event_mask_supported (ipmi_sdr_ctx_t ctx,
+                                 const void *sdr_record,
+                                 unsigned int sdr_record_len,
+                                 int assertion,
+                                 uint8_t **event_states)
+{
+  struct sdr_record_decoded rd;
+  uint32_t acceptable_record_types;
+  uint8_t event_reading_type_code;
+
+  assert (event_states);
+
+  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
+
+  if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_EVENT_READING_TYPE_CODE) < 0)
+    return (-1);
+  event_reading_type_code = rd.decoded.event_reading_type_code;
+
+  if (!IPMI_EVENT_READING_TYPE_CODE_IS_GENERIC (event_reading_type_code)
+      && !IPMI_EVENT_READING_TYPE_CODE_IS_SENSOR_SPECIFIC (event_reading_type_code))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+      return (-1);
+    }
+
+  if (assertion)
+    {
+      if (_sdr_parse_mask_bits (ctx,
+                                &rd,
+                                rd.decoded.assertion_event_mask,
+                                SDR_DECODED_ASSERTION_MASK_LS,
+                                SDR_DECODED_ASSERTION_MASK_MS,
+                                0,
+                                event_states,
+                                15) < 0)
+        return (-1);
+    }
+  else
+    {
+      if (_sdr_parse_mask_bits (ctx,
+                                &rd,
+                                rd.decoded.deassertion_event_mask,
+                                SDR_DECODED_DEASSERTION_MASK_LS,
+                                SDR_DECODED_DEASSERTION_MASK_MS,
+                                0,
+                                event_states,
+                                15) < 0)
+        return (-1);
+    }
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
 }
 
 int
@@ -940,1737 +1403,504 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
                                     uint8_t *event_state_13,
                                     uint8_t *event_state_14)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_discrete = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t record_type;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
+  uint8_t *event_states[15];
+
+  event_states[0] = event_state_0;
+  event_states[1] = event_state_1;
+  event_states[2] = event_state_2;
+  event_states[3] = event_state_3;
+  event_states[4] = event_state_4;
+  event_states[5] = event_state_5;
+  event_states[6] = event_state_6;
+  event_states[7] = event_state_7;
+  event_states[8] = event_state_8;
+  event_states[9] = event_state_9;
+  event_states[10] = event_state_10;
+  event_states[11] = event_state_11;
+  event_states[12] = event_state_12;
+  event_states[13] = event_state_13;
+  event_states[14] = event_state_14;
+
+  return (_sdr_parse_event_mask_supported (ctx,
+                                           sdr_record,
+                                           sdr_record_len,
+                                           1,
+                                           event_states));
+}
 
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
+int
+ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
+                                      const void *sdr_record,
+                                      unsigned int sdr_record_len,
+                                      uint8_t *event_state_0,
+                                      uint8_t *event_state_1,
+                                      uint8_t *event_state_2,
+                                      uint8_t *event_state_3,
+                                      uint8_t *event_state_4,
+                                      uint8_t *event_state_5,
+                                      uint8_t *event_state_6,
+                                      uint8_t *event_state_7,
+                                      uint8_t *event_state_8,
+                                      uint8_t *event_state_9,
+                                      uint8_t *event_state_10,
+                                      uint8_t *event_state_11,
+                                      uint8_t *event_state_12,
+                                      uint8_t *event_state_13,
+                                      uint8_t *event_state_14)
+{
+  uint8_t *event_states[15];
+
+  event_states[0] = event_state_0;
+  event_states[1] = event_state_1;
+  event_states[2] = event_state_2;
+  event_states[3] = event_state_3;
+  event_states[4] = event_state_4;
+  event_states[5] = event_state_5;
+  event_states[6] = event_state_6;
+  event_states[7] = event_state_7;
+  event_states[8] = event_state_8;
+  event_states[9] = event_state_9;
+  event_states[10] = event_state_10;
+  event_states[11] = event_state_11;
+  event_states[12] = event_state_12;
+  event_states[13] = event_state_13;
+  event_states[14] = event_state_14;
+
+  return (_sdr_parse_event_mask_supported (ctx,
+                                           sdr_record,
+                                           sdr_record_len,
+                                           0,
+                                           event_states));
+}
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+/* achu:
+ *
+ * Technically, the IPMI spec lists that compact record formats also
+ * support settable thresholds.  However, since compact records
+ * don't contain any information for interpreting threshold sensors
+ * (e.g. R exponent) I don't know how they could be of any use.  No
+ * vendor that I know of supports threshold sensors via a compact
+ * record (excluding possible OEM ones).
+ *
+ * There's a part of me that believes the readable/setting
+ * threshold masks for compact sensor records is a cut and paste
+ * typo.  It shouldn't be there.
+ */
+static int
+_sdr_record_decode_threshold (ipmi_sdr_ctx_t ctx,
+                              const void *sdr_record,
+                              unsigned int sdr_record_len,
+                              struct sdr_record_decoded *rd)
+{
+  assert (rd);
 
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          rd) < 0)
+    return (-1);
 
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_GENERIC (event_reading_type_code)
-      && !IPMI_EVENT_READING_TYPE_CODE_IS_SENSOR_SPECIFIC (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  /* convert obj_sdr_record to appropriate format we care about */
-  if (ipmi_sdr_parse_record_id_and_type (ctx,
-                                         sdr_record,
-                                         sdr_record_len,
-                                         NULL,
-                                         &record_type) < 0)
-    goto cleanup;
-
-  if (record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
-    {
-      if (!(obj_sdr_record_discrete = fiid_obj_copy (obj_sdr_record,
-                                                     tmpl_sdr_full_sensor_record_non_threshold_based_sensors)))
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-    }
-  else
-    {
-      if (!(obj_sdr_record_discrete = fiid_obj_copy (obj_sdr_record,
-                                                     tmpl_sdr_compact_sensor_record_non_threshold_based_sensors)))
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-    }
-
-  if (event_state_0)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_0",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_0 = val;
-    }
-
-  if (event_state_1)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_1",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_1 = val;
-    }
-
-  if (event_state_2)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_2",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_2 = val;
-    }
-
-  if (event_state_3)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_3",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_3 = val;
-    }
-
-  if (event_state_4)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_4",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_4 = val;
-    }
-
-  if (event_state_5)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_5",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_5 = val;
-    }
-
-  if (event_state_6)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_6",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_6 = val;
-    }
-
-  if (event_state_7)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_7",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_7 = val;
-    }
-
-  if (event_state_8)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_8",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_8 = val;
-    }
-
-  if (event_state_9)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_9",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_9 = val;
-    }
-
-  if (event_state_10)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_10",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_10 = val;
-    }
-
-  if (event_state_11)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_11",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_11 = val;
-    }
-
-  if (event_state_12)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_12",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_12 = val;
-    }
-
-  if (event_state_13)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_13",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_13 = val;
-    }
-
-  if (event_state_14)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_14",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_14 = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_discrete);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
-                                      const void *sdr_record,
-                                      unsigned int sdr_record_len,
-                                      uint8_t *event_state_0,
-                                      uint8_t *event_state_1,
-                                      uint8_t *event_state_2,
-                                      uint8_t *event_state_3,
-                                      uint8_t *event_state_4,
-                                      uint8_t *event_state_5,
-                                      uint8_t *event_state_6,
-                                      uint8_t *event_state_7,
-                                      uint8_t *event_state_8,
-                                      uint8_t *event_state_9,
-                                      uint8_t *event_state_10,
-                                      uint8_t *event_state_11,
-                                      uint8_t *event_state_12,
-                                      uint8_t *event_state_13,
-                                      uint8_t *event_state_14)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_discrete = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t record_type;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-  acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_GENERIC (event_reading_type_code)
-      && !IPMI_EVENT_READING_TYPE_CODE_IS_SENSOR_SPECIFIC (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  /* convert obj_sdr_record to appropriate format we care about */
-  if (ipmi_sdr_parse_record_id_and_type (ctx,
-                                         sdr_record,
-                                         sdr_record_len,
-                                         NULL,
-                                         &record_type) < 0)
-    goto cleanup;
-
-  if (record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
-    {
-      if (!(obj_sdr_record_discrete = fiid_obj_copy (obj_sdr_record,
-                                                     tmpl_sdr_full_sensor_record_non_threshold_based_sensors)))
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-    }
-  else
-    {
-      if (!(obj_sdr_record_discrete = fiid_obj_copy (obj_sdr_record,
-                                                     tmpl_sdr_compact_sensor_record_non_threshold_based_sensors)))
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-    }
-
-  if (event_state_0)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_0",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_0 = val;
-    }
-
-  if (event_state_1)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_1",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_1 = val;
-    }
-
-  if (event_state_2)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_2",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_2 = val;
-    }
-
-  if (event_state_3)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_3",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_3 = val;
-    }
-
-  if (event_state_4)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_4",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_4 = val;
-    }
-
-  if (event_state_5)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_5",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_5 = val;
-    }
-
-  if (event_state_6)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_6",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_6 = val;
-    }
-
-  if (event_state_7)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_7",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_7 = val;
-    }
-
-  if (event_state_8)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_8",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_8 = val;
-    }
-
-  if (event_state_9)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_9",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_9 = val;
-    }
-
-  if (event_state_10)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_10",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_10 = val;
-    }
-
-  if (event_state_11)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_11",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_11 = val;
-    }
-
-  if (event_state_12)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_12",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_12 = val;
-    }
-
-  if (event_state_13)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_13",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_13 = val;
-    }
-
-  if (event_state_14)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_14",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
-          goto cleanup;
-        }
-      *event_state_14 = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_discrete);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
-                                              const void *sdr_record,
-                                              unsigned int sdr_record_len,
-                                              uint8_t *lower_non_critical_going_low,
-                                              uint8_t *lower_non_critical_going_high,
-                                              uint8_t *lower_critical_going_low,
-                                              uint8_t *lower_critical_going_high,
-                                              uint8_t *lower_non_recoverable_going_low,
-                                              uint8_t *lower_non_recoverable_going_high,
-                                              uint8_t *upper_non_critical_going_low,
-                                              uint8_t *upper_non_critical_going_high,
-                                              uint8_t *upper_critical_going_low,
-                                              uint8_t *upper_critical_going_high,
-                                              uint8_t *upper_non_recoverable_going_low,
-                                              uint8_t *upper_non_recoverable_going_high)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_threshold = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  /* achu:
-   *
-   * Technically, the IPMI spec lists that compact record formats also
-   * support settable thresholds.  However, since compact records
-   * don't contain any information for interpreting threshold sensors
-   * (e.g. R exponent) I don't know how they could be of any use.  No
-   * vendor that I know of supports threshold sensors via a compact
-   * record (excluding possible OEM ones).
-   *
-   * There's a part of me that believes the readable/setting
-   * threshold masks for compact sensor records is a cut and paste
-   * typo.  It shouldn't be there.
-   */
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  /* We don't want the generic sdr full record, we need the special
-   * threshold one.
-   */
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  if (!(obj_sdr_record_threshold = fiid_obj_copy (obj_sdr_record,
-                                                  tmpl_sdr_full_sensor_record_threshold_based_sensors)))
-    {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-      goto cleanup;
-    }
-
-  if (lower_non_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_going_low = val;
-    }
-
-  if (lower_non_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_going_high = val;
-    }
-
-  if (lower_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_going_low = val;
-    }
-
-  if (lower_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_going_high = val;
-    }
-
-  if (lower_non_recoverable_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_recoverable_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_going_low = val;
-    }
-
-  if (lower_non_recoverable_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_recoverable_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_going_high = val;
-    }
-
-  if (upper_non_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_going_low = val;
-    }
-
-  if (upper_non_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_going_high = val;
-    }
-
-  if (upper_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_going_low = val;
-    }
-
-  if (upper_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_going_high = val;
-    }
-
-  if (upper_non_recoverable_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_recoverable_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_going_low = val;
-    }
-
-  if (upper_non_recoverable_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_recoverable_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_going_high = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_threshold);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
-                                                const void *sdr_record,
-                                                unsigned int sdr_record_len,
-                                                uint8_t *lower_non_critical_going_low,
-                                                uint8_t *lower_non_critical_going_high,
-                                                uint8_t *lower_critical_going_low,
-                                                uint8_t *lower_critical_going_high,
-                                                uint8_t *lower_non_recoverable_going_low,
-                                                uint8_t *lower_non_recoverable_going_high,
-                                                uint8_t *upper_non_critical_going_low,
-                                                uint8_t *upper_non_critical_going_high,
-                                                uint8_t *upper_critical_going_low,
-                                                uint8_t *upper_critical_going_high,
-                                                uint8_t *upper_non_recoverable_going_low,
-                                                uint8_t *upper_non_recoverable_going_high)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_threshold = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  /* achu:
-   *
-   * Technically, the IPMI spec lists that compact record formats also
-   * support settable thresholds.  However, since compact records
-   * don't contain any information for interpreting threshold sensors
-   * (e.g. R exponent) I don't know how they could be of any use.  No
-   * vendor that I know of supports threshold sensors via a compact
-   * record (excluding possible OEM ones).
-   *
-   * There's a part of me that believes the readable/setting
-   * threshold masks for compact sensor records is a cut and paste
-   * typo.  It shouldn't be there.
-   */
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  /* We don't want the generic sdr full record, we need the special
-   * threshold one.
-   */
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  if (!(obj_sdr_record_threshold = fiid_obj_copy (obj_sdr_record,
-                                                  tmpl_sdr_full_sensor_record_threshold_based_sensors)))
-    {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-      goto cleanup;
-    }
-
-  if (lower_non_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_going_low = val;
-    }
-
-  if (lower_non_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_going_high = val;
-    }
-
-  if (lower_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_going_low = val;
-    }
-
-  if (lower_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_going_high = val;
-    }
-
-  if (lower_non_recoverable_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_recoverable_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_going_low = val;
-    }
-
-  if (lower_non_recoverable_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_recoverable_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_going_high = val;
-    }
-
-  if (upper_non_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_going_low = val;
-    }
-
-  if (upper_non_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_going_high = val;
-    }
-
-  if (upper_critical_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_critical_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_going_low = val;
-    }
-
-  if (upper_critical_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_critical_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_going_high = val;
-    }
-
-  if (upper_non_recoverable_going_low)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_recoverable_going_low_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_going_low = val;
-    }
-
-  if (upper_non_recoverable_going_high)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_recoverable_going_high_supported",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_going_high = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_threshold);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
-                                   const void *sdr_record,
-                                   unsigned int sdr_record_len,
-                                   uint8_t *lower_non_critical_threshold,
-                                   uint8_t *lower_critical_threshold,
-                                   uint8_t *lower_non_recoverable_threshold,
-                                   uint8_t *upper_non_critical_threshold,
-                                   uint8_t *upper_critical_threshold,
-                                   uint8_t *upper_non_recoverable_threshold)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_threshold = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  /* achu:
-   *
-   * Technically, the IPMI spec lists that compact record formats also
-   * support settable thresholds.  However, since compact records
-   * don't contain any information for interpreting threshold sensors
-   * (e.g. R exponent) I don't know how they could be of any use.  No
-   * vendor that I know of supports threshold sensors via a compact
-   * record (excluding possible OEM ones).
-   *
-   * There's a part of me that believes the readable/setting
-   * threshold masks for compact sensor records is a cut and paste
-   * typo.  It shouldn't be there.
-   */
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  /* We don't want the generic sdr full record, we need the special
-   * threshold one.
-   */
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  if (!(obj_sdr_record_threshold = fiid_obj_copy (obj_sdr_record,
-                                                  tmpl_sdr_full_sensor_record_threshold_based_sensors)))
-    {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-      goto cleanup;
-    }
-
-  if (lower_non_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_non_critical_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_threshold = val;
-    }
-
-  if (lower_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_critical_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_threshold = val;
-    }
-
-  if (lower_non_recoverable_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_non_recoverable_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_threshold = val;
-    }
-
-  if (upper_non_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_non_critical_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_threshold = val;
-    }
-
-  if (upper_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_critical_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_threshold = val;
-    }
-
-  if (upper_non_recoverable_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_non_recoverable_threshold_is_readable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_threshold = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_threshold);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
-                                   const void *sdr_record,
-                                   unsigned int sdr_record_len,
-                                   uint8_t *lower_non_critical_threshold,
-                                   uint8_t *lower_critical_threshold,
-                                   uint8_t *lower_non_recoverable_threshold,
-                                   uint8_t *upper_non_critical_threshold,
-                                   uint8_t *upper_critical_threshold,
-                                   uint8_t *upper_non_recoverable_threshold)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_threshold = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  /* achu:
-   *
-   * Technically, the IPMI spec lists that compact record formats also
-   * support settable thresholds.  However, since compact records
-   * don't contain any information for interpreting threshold sensors
-   * (e.g. R exponent) I don't know how they could be of any use.  No
-   * vendor that I know of supports threshold sensors via a compact
-   * record (excluding possible OEM ones).
-   *
-   * There's a part of me that believes the readable/setting
-   * threshold masks for compact sensor records is a cut and paste
-   * typo.  It shouldn't be there.
-   */
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  /* We don't want the generic sdr full record, we need the special
-   * threshold one.
-   */
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
-
-  if (!(obj_sdr_record_threshold = fiid_obj_copy (obj_sdr_record,
-                                                  tmpl_sdr_full_sensor_record_threshold_based_sensors)))
-    {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-      goto cleanup;
-    }
-
-  if (lower_non_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_non_critical_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_threshold = val;
-    }
-
-  if (lower_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_critical_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_threshold = val;
-    }
-
-  if (lower_non_recoverable_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_non_recoverable_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_threshold = val;
-    }
-
-  if (upper_non_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_non_critical_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_threshold = val;
-    }
-
-  if (upper_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_critical_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_threshold = val;
-    }
-
-  if (upper_non_recoverable_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_non_recoverable_threshold_is_settable",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_threshold = val;
-    }
-
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_threshold);
-  return (rv);
-}
-
-int
-ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
-                                     const void *sdr_record,
-                                     unsigned int sdr_record_len,
-                                     int8_t *r_exponent,
-                                     int8_t *b_exponent,
-                                     int16_t *m,
-                                     int16_t *b,
-                                     uint8_t *linearization,
-                                     uint8_t *analog_data_format)
-{
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  uint64_t val, val1, val2;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (r_exponent)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "r_exponent",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *r_exponent = val;
-      if (*r_exponent & 0x08)
-        *r_exponent |= 0xF0;
-    }
-
-  if (b_exponent)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_exponent",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *b_exponent = val;
-      if (*b_exponent & 0x08)
-        *b_exponent |= 0xF0;
-    }
-
-  if (m)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "m_ls",
-                        &val1) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "m_ms",
-                        &val2) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *m = val1;
-      *m |= (((int16_t)val2 & 0x3) << 8);
-      if (*m & 0x200)
-        *m |= 0xFE00;
-    }
-
-  if (b)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_ls",
-                        &val1) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_ms",
-                        &val2) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *b = val1;
-      *b |= (((int16_t)val2 & 0x3) << 8);
-      if (*b & 0x200)
-        *b |= 0xFE00;
-    }
-
-  if (linearization)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "linearization",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      (*linearization) = val;
-    }
+  if (_sdr_record_decoded_check (ctx, rd, SDR_DECODED_EVENT_READING_TYPE_CODE) < 0)
+    return (-1);
 
-  if (analog_data_format)
+  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (rd->decoded.event_reading_type_code))
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.analog_data_format",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      (*analog_data_format) = val;
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+      return (-1);
     }
 
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 static int
-_sensor_decode_value (ipmi_sdr_ctx_t ctx,
-                      int8_t r_exponent,
-                      int8_t b_exponent,
-                      int16_t m,
-                      int16_t b,
-                      uint8_t linearization,
-                      uint8_t analog_data_format,
-                      uint8_t raw_data,
-                      double **value_ptr)
+_sdr_parse_threshold_event_mask_supported (ipmi_sdr_ctx_t ctx,
+                                           const void *sdr_record,
+                                           unsigned int sdr_record_len,
+                                           int assertion,
+                                           uint8_t **thresholds)
 {
-  double reading;
-  int rv = -1;
+  struct sdr_record_decoded rd;
 
-  assert (ctx);
-  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
-  assert (value_ptr);
+  assert (thresholds);
 
-  *value_ptr = NULL;
+  if (_sdr_record_decode_threshold (ctx,
+                                    sdr_record,
+                                    sdr_record_len,
+                                    &rd) < 0)
+    return (-1);
 
-  if (ipmi_sensor_decode_value (r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                raw_data,
-                                &reading) < 0)
+  if (assertion)
     {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
-      goto cleanup;
+      if (_sdr_parse_mask_bits (ctx,
+                                &rd,
+                                rd.decoded.assertion_event_mask,
+                                SDR_DECODED_ASSERTION_MASK_LS,
+                                SDR_DECODED_ASSERTION_MASK_MS,
+                                0,
+                                thresholds,
+                                12) < 0)
+        return (-1);
     }
-
-  if (!((*value_ptr) = (double *)malloc (sizeof (double))))
+  else
     {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
-      goto cleanup;
+      if (_sdr_parse_mask_bits (ctx,
+                                &rd,
+                                rd.decoded.deassertion_event_mask,
+                                SDR_DECODED_DEASSERTION_MASK_LS,
+                                SDR_DECODED_DEASSERTION_MASK_MS,
+                                0,
+                                thresholds,
+                                12) < 0)
+        return (-1);
     }
-  (**value_ptr) = reading;
 
-  rv = 0;
- cleanup:
-  return (rv);
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
 }
 
 int
-ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
+ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
+                                              const void *sdr_record,
+                                              unsigned int sdr_record_len,
+                                              uint8_t *lower_non_critical_going_low,
+                                              uint8_t *lower_non_critical_going_high,
+                                              uint8_t *lower_critical_going_low,
+                                              uint8_t *lower_critical_going_high,
+                                              uint8_t *lower_non_recoverable_going_low,
+                                              uint8_t *lower_non_recoverable_going_high,
+                                              uint8_t *upper_non_critical_going_low,
+                                              uint8_t *upper_non_critical_going_high,
+                                              uint8_t *upper_critical_going_low,
+                                              uint8_t *upper_critical_going_high,
+                                              uint8_t *upper_non_recoverable_going_low,
+                                              uint8_t *upper_non_recoverable_going_high)
+{
+  uint8_t *thresholds[12];
+
+  thresholds[0] = lower_non_critical_going_low;
+  thresholds[1] = lower_non_critical_going_high;
+  thresholds[2] = lower_critical_going_low;
+  thresholds[3] = lower_critical_going_high;
+  thresholds[4] = lower_non_recoverable_going_low;
+  thresholds[5] = lower_non_recoverable_going_high;
+  thresholds[6] = upper_non_critical_going_low;
+  thresholds[7] = upper_non_critical_going_high;
+  thresholds[8] = upper_critical_going_low;
+  thresholds[9] = upper_critical_going_high;
+  thresholds[10] = upper_non_recoverable_going_low;
+  thresholds[11] = upper_non_recoverable_going_high;
+
+  return (_sdr_parse_threshold_event_mask_supported (ctx,
+                                                     sdr_record,
+                                                     sdr_record_len,
+                                                     1,
+                                                     thresholds));
+}
+
+int
+ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
                                                 const void *sdr_record,
                                                 unsigned int sdr_record_len,
-                                                uint8_t *nominal_reading_specified,
-                                                uint8_t *normal_maximum_specified,
-                                                uint8_t *normal_minimum_specified)
+                                                uint8_t *lower_non_critical_going_low,
+                                                uint8_t *lower_non_critical_going_high,
+                                                uint8_t *lower_critical_going_low,
+                                                uint8_t *lower_critical_going_high,
+                                                uint8_t *lower_non_recoverable_going_low,
+                                                uint8_t *lower_non_recoverable_going_high,
+                                                uint8_t *upper_non_critical_going_low,
+                                                uint8_t *upper_non_critical_going_high,
+                                                uint8_t *upper_critical_going_low,
+                                                uint8_t *upper_critical_going_high,
+                                                uint8_t *upper_non_recoverable_going_low,
+                                                uint8_t *upper_non_recoverable_going_high)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (nominal_reading_specified)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.nominal_reading",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *nominal_reading_specified = val;
-    }
-
-  if (normal_maximum_specified)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.normal_max",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *normal_maximum_specified = val;
-    }
+  uint8_t *thresholds[12];
+
+  thresholds[0] = lower_non_critical_going_low;
+  thresholds[1] = lower_non_critical_going_high;
+  thresholds[2] = lower_critical_going_low;
+  thresholds[3] = lower_critical_going_high;
+  thresholds[4] = lower_non_recoverable_going_low;
+  thresholds[5] = lower_non_recoverable_going_high;
+  thresholds[6] = upper_non_critical_going_low;
+  thresholds[7] = upper_non_critical_going_high;
+  thresholds[8] = upper_critical_going_low;
+  thresholds[9] = upper_critical_going_high;
+  thresholds[10] = upper_non_recoverable_going_low;
+  thresholds[11] = upper_non_recoverable_going_high;
+
+  return (_sdr_parse_threshold_event_mask_supported (ctx,
+                                                     sdr_record,
+                                                     sdr_record_len,
+                                                     0,
+                                                     thresholds));
+}
 
-  if (normal_minimum_specified)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.normal_min",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *normal_minimum_specified = val;
-    }
+/* readable thresholds are bits 0-5 of the reading mask, settable
+ * thresholds bits 8-13
+ */
+static int
+_sdr_parse_threshold_reading_mask (ipmi_sdr_ctx_t ctx,
+                                   const void *sdr_record,
+                                   unsigned int sdr_record_len,
+                                   unsigned int first_bit,
+                                   uint8_t **thresholds)
+{
+  struct sdr_record_decoded rd;
+
+  assert (thresholds);
+
+  if (_sdr_record_decode_threshold (ctx,
+                                    sdr_record,
+                                    sdr_record_len,
+                                    &rd) < 0)
+    return (-1);
+
+  if (_sdr_parse_mask_bits (ctx,
+                            &rd,
+                            rd.decoded.reading_mask,
+                            SDR_DECODED_READING_MASK_LS,
+                            SDR_DECODED_READING_MASK_MS,
+                            first_bit,
+                            thresholds,
+                            6) < 0)
+    return (-1);
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
-ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
-                                      const void *sdr_record,
-                                      unsigned int sdr_record_len,
-                                      double **nominal_reading,
-                                      double **normal_maximum,
-                                      double **normal_minimum,
-                                      double **sensor_maximum_reading,
-                                      double **sensor_minimum_reading)
+ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
+                                   const void *sdr_record,
+                                   unsigned int sdr_record_len,
+                                   uint8_t *lower_non_critical_threshold,
+                                   uint8_t *lower_critical_threshold,
+                                   uint8_t *lower_non_recoverable_threshold,
+                                   uint8_t *upper_non_critical_threshold,
+                                   uint8_t *upper_critical_threshold,
+                                   uint8_t *upper_non_recoverable_threshold)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  int8_t r_exponent, b_exponent;
-  int16_t m, b;
-  uint8_t reading_raw, linearization, analog_data_format;
-  double *tmp_nominal_reading = NULL;
-  double *tmp_normal_maximum = NULL;
-  double *tmp_normal_minimum = NULL;
-  double *tmp_sensor_maximum_reading = NULL;
-  double *tmp_sensor_minimum_reading = NULL;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (nominal_reading)
-    *nominal_reading = NULL;
-  if (normal_maximum)
-    *normal_maximum = NULL;
-  if (normal_minimum)
-    *normal_minimum = NULL;
-  if (sensor_maximum_reading)
-    *sensor_maximum_reading = NULL;
-  if (sensor_minimum_reading)
-    *sensor_minimum_reading = NULL;
-
-  if (ipmi_sdr_parse_sensor_decoding_data (ctx,
-                                           sdr_record,
-                                           sdr_record_len,
-                                           &r_exponent,
-                                           &b_exponent,
-                                           &m,
-                                           &b,
-                                           &linearization,
-                                           &analog_data_format) < 0)
-    goto cleanup;
-
-  if (!IPMI_SDR_ANALOG_DATA_FORMAT_VALID (analog_data_format))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_CANNOT_PARSE_OR_CALCULATE);
-      goto cleanup;
-    }
-
-  if (!IPMI_SDR_LINEARIZATION_IS_LINEAR (linearization))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_CANNOT_PARSE_OR_CALCULATE);
-      goto cleanup;
-    }
-
-  if (nominal_reading)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "nominal_reading",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      reading_raw = val;
+  uint8_t *thresholds[6];
+
+  thresholds[0] = lower_non_critical_threshold;
+  thresholds[1] = lower_critical_threshold;
+  thresholds[2] = lower_non_recoverable_threshold;
+  thresholds[3] = upper_non_critical_threshold;
+  thresholds[4] = upper_critical_threshold;
+  thresholds[5] = upper_non_recoverable_threshold;
+
+  return (_sdr_parse_threshold_reading_mask (ctx,
+                                             sdr_record,
+                                             sdr_record_len,
+                                             0,
+                                             thresholds));
+}
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                reading_raw,
-                                &tmp_nominal_reading) < 0)
-        goto cleanup;
-    }
-  if (normal_maximum)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "normal_maximum",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      reading_raw = val;
+int
+ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
+                                   const void *sdr_record,
+                                   unsigned int sdr_record_len,
+                                   uint8_t *lower_non_critical_threshold,
+                                   uint8_t *lower_critical_threshold,
+                                   uint8_t *lower_non_recoverable_threshold,
+                                   uint8_t *upper_non_critical_threshold,
+                                   uint8_t *upper_critical_threshold,
+                                   uint8_t *upper_non_recoverable_threshold)
+{
+  uint8_t *thresholds[6];
+
+  thresholds[0] = lower_non_critical_threshold;
+  thresholds[1] = lower_critical_threshold;
+  thresholds[2] = lower_non_recoverable_threshold;
+  thresholds[3] = upper_non_critical_threshold;
+  thresholds[4] = upper_critical_threshold;
+  thresholds[5] = upper_non_recoverable_threshold;
+
+  return (_sdr_parse_threshold_reading_mask (ctx,
+                                             sdr_record,
+                                             sdr_record_len,
+                                             8,
+                                             thresholds));
+}
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                reading_raw,
-                                &tmp_normal_maximum) < 0)
-        goto cleanup;
-    }
-  if (normal_minimum)
+static int
+_sdr_record_decoded_decoding_data (ipmi_sdr_ctx_t ctx,
+                                   const struct sdr_record_decoded *rd,
+                                   int8_t *r_exponent,
+                                   int8_t *b_exponent,
+                                   int16_t *m,
+                                   int16_t *b,
+                                   uint8_t *linearization,
+                                   uint8_t *analog_data_format)
+{
+  assert (rd);
+
+  if (r_exponent || b_exponent)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "normal_minimum",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      reading_raw = val;
+      if (_sdr_record_decoded_check (ctx, rd, SDR_DECODED_EXPONENTS) < 0)
+        return (-1);
+      if (r_exponent)
+        *r_exponent = rd->decoded.r_exponent;
+      if (b_exponent)
+        *b_exponent = rd->decoded.b_exponent;
+    }
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                reading_raw,
-                                &tmp_normal_minimum) < 0)
-        goto cleanup;
+  if (m)
+    {
+      if (_sdr_record_decoded_check (ctx,
+                                     rd,
+                                     SDR_DECODED_M_LS | SDR_DECODED_M_MS_TOLERANCE) < 0)
+        return (-1);
+      *m = rd->decoded.m;
     }
-  if (sensor_maximum_reading)
+
+  if (b)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_maximum_reading",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      reading_raw = val;
+      if (_sdr_record_decoded_check (ctx,
+                                     rd,
+                                     SDR_DECODED_B_LS | SDR_DECODED_B_MS_ACCURACY_LS) < 0)
+        return (-1);
+      *b = rd->decoded.b;
+    }
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                reading_raw,
-                                &tmp_sensor_maximum_reading) < 0)
-        goto cleanup;
+  if (linearization)
+    {
+      if (_sdr_record_decoded_check (ctx, rd, SDR_DECODED_LINEARIZATION) < 0)
+        return (-1);
+      *linearization = rd->decoded.linearization;
     }
-  if (sensor_minimum_reading)
+
+  if (analog_data_format)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_minimum_reading",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      reading_raw = val;
+      if (_sdr_record_decoded_check (ctx, rd, SDR_DECODED_SENSOR_UNIT1) < 0)
+        return (-1);
+      *analog_data_format = rd->decoded.analog_data_format;
+    }
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
+  return (0);
+}
+
+int
+ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
+                                     const void *sdr_record,
+                                     unsigned int sdr_record_len,
+                                     int8_t *r_exponent,
+                                     int8_t *b_exponent,
+                                     int16_t *m,
+                                     int16_t *b,
+                                     uint8_t *linearization,
+                                     uint8_t *analog_data_format)
+{
+  struct sdr_record_decoded rd;
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
+
+  if (_sdr_record_decoded_decoding_data (ctx,
+                                         &rd,
+                                         r_exponent,
+                                         b_exponent,
+                                         m,
+                                         b,
+                                         linearization,
+                                         analog_data_format) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+static int
+_sensor_decode_value (ipmi_sdr_ctx_t ctx,
+                      int8_t r_exponent,
+                      int8_t b_exponent,
+                      int16_t m,
+                      int16_t b,
+                      uint8_t linearization,
+                      uint8_t analog_data_format,
+                      uint8_t raw_data,
+                      double **value_ptr)
+{
+  double reading;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (value_ptr);
+
+  *value_ptr = NULL;
+
+  if (ipmi_sensor_decode_value (r_exponent,
                                 b_exponent,
                                 m,
                                 b,
                                 linearization,
                                 analog_data_format,
-                                reading_raw,
-                                &tmp_sensor_minimum_reading) < 0)
-        goto cleanup;
+                                raw_data,
+                                &reading) < 0)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+      goto cleanup;
     }
 
-  if (nominal_reading)
-    *nominal_reading = tmp_nominal_reading;
-  if (normal_maximum)
-    *normal_maximum = tmp_normal_maximum;
-  if (normal_minimum)
-    *normal_minimum = tmp_normal_minimum;
-  if (sensor_maximum_reading)
-    *sensor_maximum_reading = tmp_sensor_maximum_reading;
-  if (sensor_minimum_reading)
-    *sensor_minimum_reading = tmp_sensor_minimum_reading;
+  if (!((*value_ptr) = (double *)malloc (sizeof (double))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+  (**value_ptr) = reading;
 
   rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  if (rv < 0)
-    {
-      free (tmp_nominal_reading);
-      free (tmp_normal_maximum);
-      free (tmp_normal_minimum);
-      free (tmp_sensor_maximum_reading);
-      free (tmp_sensor_minimum_reading);
-    }
   return (rv);
 }
 
-int
-ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
-                           const void *sdr_record,
-                           unsigned int sdr_record_len,
-                           double **lower_non_critical_threshold,
-                           double **lower_critical_threshold,
-                           double **lower_non_recoverable_threshold,
-                           double **upper_non_critical_threshold,
-                           double **upper_critical_threshold,
-                           double **upper_non_recoverable_threshold)
+/* Decode the requested raw readings of a full record.  Each entry in
+ * 'values' is output to and freed on error.
+ */
+static int
+_sdr_record_decoded_values (ipmi_sdr_ctx_t ctx,
+                            const struct sdr_record_decoded *rd,
+                            const uint8_t *raw,
+                            const uint64_t *fields,
+                            double ***values,
+                            unsigned int values_len)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
   int8_t r_exponent, b_exponent;
   int16_t m, b;
-  uint8_t threshold_raw, linearization, analog_data_format;
-  double *tmp_lower_non_critical_threshold = NULL;
-  double *tmp_lower_critical_threshold = NULL;
-  double *tmp_lower_non_recoverable_threshold = NULL;
-  double *tmp_upper_non_critical_threshold = NULL;
-  double *tmp_upper_critical_threshold = NULL;
-  double *tmp_upper_non_recoverable_threshold = NULL;
-  uint64_t val;
+  uint8_t linearization, analog_data_format;
+  double *tmp_values[SDR_DECODED_VALUES_MAX];
+  unsigned int i;
   int rv = -1;
 
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  assert (rd);
+  assert (raw);
+  assert (fields);
+  assert (values);
+  assert (values_len <= SDR_DECODED_VALUES_MAX);
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  memset (tmp_values, '\0', sizeof (tmp_values));
 
-  if (lower_non_critical_threshold)
-    *lower_non_critical_threshold = NULL;
-  if (lower_critical_threshold)
-    *lower_critical_threshold = NULL;
-  if (lower_non_recoverable_threshold)
-    *lower_non_recoverable_threshold = NULL;
-  if (upper_non_critical_threshold)
-    *upper_non_critical_threshold = NULL;
-  if (upper_critical_threshold)
-    *upper_critical_threshold = NULL;
-  if (upper_non_recoverable_threshold)
-    *upper_non_recoverable_threshold = NULL;
+  for (i = 0; i < values_len; i++)
+    {
+      if (values[i])
+        *values[i] = NULL;
+    }
 
-  if (ipmi_sdr_parse_sensor_decoding_data (ctx,
-                                           sdr_record,
-                                           sdr_record_len,
-                                           &r_exponent,
-                                           &b_exponent,
-                                           &m,
-                                           &b,
-                                           &linearization,
-                                           &analog_data_format) < 0)
+  if (_sdr_record_decoded_decoding_data (ctx,
+                                         rd,
+                                         &r_exponent,
+                                         &b_exponent,
+                                         &m,
+                                         &b,
+                                         &linearization,
+                                         &analog_data_format) < 0)
     goto cleanup;
 
   if (!IPMI_SDR_ANALOG_DATA_FORMAT_VALID (analog_data_format))
@@ -2685,38 +1915,13 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (lower_non_critical_threshold)
+  for (i = 0; i < values_len; i++)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_non_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
+      if (!values[i])
+        continue;
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                threshold_raw,
-                                &tmp_lower_non_critical_threshold) < 0)
+      if (_sdr_record_decoded_check (ctx, rd, fields[i]) < 0)
         goto cleanup;
-    }
-  if (lower_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
 
       if (_sensor_decode_value (ctx,
                                 r_exponent,
@@ -2725,126 +1930,154 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
                                 b,
                                 linearization,
                                 analog_data_format,
-                                threshold_raw,
-                                &tmp_lower_critical_threshold) < 0)
+                                raw[i],
+                                &tmp_values[i]) < 0)
         goto cleanup;
     }
-  if (lower_non_recoverable_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_non_recoverable_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                threshold_raw,
-                                &tmp_lower_non_recoverable_threshold) < 0)
-        goto cleanup;
-    }
-  if (upper_non_critical_threshold)
+  for (i = 0; i < values_len; i++)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_non_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
-
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                threshold_raw,
-                                &tmp_upper_non_critical_threshold) < 0)
-        goto cleanup;
+      if (values[i])
+        *values[i] = tmp_values[i];
     }
-  if (upper_critical_threshold)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
 
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                threshold_raw,
-                                &tmp_upper_critical_threshold) < 0)
-        goto cleanup;
-    }
-  if (upper_non_recoverable_threshold)
+  rv = 0;
+ cleanup:
+  if (rv < 0)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_non_recoverable_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      threshold_raw = val;
-
-      if (_sensor_decode_value (ctx,
-                                r_exponent,
-                                b_exponent,
-                                m,
-                                b,
-                                linearization,
-                                analog_data_format,
-                                threshold_raw,
-                                &tmp_upper_non_recoverable_threshold) < 0)
-        goto cleanup;
+      for (i = 0; i < values_len; i++)
+        free (tmp_values[i]);
     }
+  return (rv);
+}
+
+int
+ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
+                                                const void *sdr_record,
+                                                unsigned int sdr_record_len,
+                                                uint8_t *nominal_reading_specified,
+                                                uint8_t *normal_maximum_specified,
+                                                uint8_t *normal_minimum_specified)
+{
+  struct sdr_record_decoded rd;
 
-  if (lower_non_critical_threshold)
-    *lower_non_critical_threshold = tmp_lower_non_critical_threshold;
-  if (lower_critical_threshold)
-    *lower_critical_threshold = tmp_lower_critical_threshold;
-  if (lower_non_recoverable_threshold)
-    *lower_non_recoverable_threshold = tmp_lower_non_recoverable_threshold;
-  if (upper_non_critical_threshold)
-    *upper_non_critical_threshold = tmp_upper_non_critical_threshold;
-  if (upper_critical_threshold)
-    *upper_critical_threshold = tmp_upper_critical_threshold;
-  if (upper_non_recoverable_threshold)
-    *upper_non_recoverable_threshold = tmp_upper_non_recoverable_threshold;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
 
-  rv = 0;
-  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  if (rv < 0)
+  if (nominal_reading_specified
+      || normal_maximum_specified
+      || normal_minimum_specified)
     {
-      free (tmp_lower_non_critical_threshold);
-      free (tmp_lower_critical_threshold);
-      free (tmp_lower_non_recoverable_threshold);
-      free (tmp_upper_non_critical_threshold);
-      free (tmp_upper_critical_threshold);
-      free (tmp_upper_non_recoverable_threshold);
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_ANALOG_CHARACTERISTICS) < 0)
+        return (-1);
+      if (nominal_reading_specified)
+        *nominal_reading_specified = rd.decoded.nominal_reading_specified;
+      if (normal_maximum_specified)
+        *normal_maximum_specified = rd.decoded.normal_maximum_specified;
+      if (normal_minimum_specified)
+        *normal_minimum_specified = rd.decoded.normal_minimum_specified;
     }
-  return (rv);
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
+                                      const void *sdr_record,
+                                      unsigned int sdr_record_len,
+                                      double **nominal_reading,
+                                      double **normal_maximum,
+                                      double **normal_minimum,
+                                      double **sensor_maximum_reading,
+                                      double **sensor_minimum_reading)
+{
+  struct sdr_record_decoded rd;
+  uint8_t raw[5];
+  uint64_t fields[5];
+  double **values[5];
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
+
+  raw[0] = rd.decoded.nominal_reading;
+  fields[0] = SDR_DECODED_NOMINAL_READING;
+  values[0] = nominal_reading;
+  raw[1] = rd.decoded.normal_maximum;
+  fields[1] = SDR_DECODED_NORMAL_MAXIMUM;
+  values[1] = normal_maximum;
+  raw[2] = rd.decoded.normal_minimum;
+  fields[2] = SDR_DECODED_NORMAL_MINIMUM;
+  values[2] = normal_minimum;
+  raw[3] = rd.decoded.sensor_maximum_reading;
+  fields[3] = SDR_DECODED_SENSOR_MAXIMUM_READING;
+  values[3] = sensor_maximum_reading;
+  raw[4] = rd.decoded.sensor_minimum_reading;
+  fields[4] = SDR_DECODED_SENSOR_MINIMUM_READING;
+  values[4] = sensor_minimum_reading;
+
+  if (_sdr_record_decoded_values (ctx, &rd, raw, fields, values, 5) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
+                           const void *sdr_record,
+                           unsigned int sdr_record_len,
+                           double **lower_non_critical_threshold,
+                           double **lower_critical_threshold,
+                           double **lower_non_recoverable_threshold,
+                           double **upper_non_critical_threshold,
+                           double **upper_critical_threshold,
+                           double **upper_non_recoverable_threshold)
+{
+  struct sdr_record_decoded rd;
+  uint8_t raw[6];
+  uint64_t fields[6];
+  double **values[6];
+
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
+
+  raw[0] = rd.decoded.lower_non_critical_threshold;
+  fields[0] = SDR_DECODED_LOWER_NON_CRITICAL;
+  values[0] = lower_non_critical_threshold;
+  raw[1] = rd.decoded.lower_critical_threshold;
+  fields[1] = SDR_DECODED_LOWER_CRITICAL;
+  values[1] = lower_critical_threshold;
+  raw[2] = rd.decoded.lower_non_recoverable_threshold;
+  fields[2] = SDR_DECODED_LOWER_NON_RECOVERABLE;
+  values[2] = lower_non_recoverable_threshold;
+  raw[3] = rd.decoded.upper_non_critical_threshold;
+  fields[3] = SDR_DECODED_UPPER_NON_CRITICAL;
+  values[3] = upper_non_critical_threshold;
+  raw[4] = rd.decoded.upper_critical_threshold;
+  fields[4] = SDR_DECODED_UPPER_CRITICAL;
+  values[4] = upper_critical_threshold;
+  raw[5] = rd.decoded.upper_non_recoverable_threshold;
+  fields[5] = SDR_DECODED_UPPER_NON_RECOVERABLE;
+  values[5] = upper_non_recoverable_threshold;
+
+  if (_sdr_record_decoded_values (ctx, &rd, raw, fields, values, 6) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
 }
 
 int
@@ -2858,122 +2091,53 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
                                uint8_t *upper_critical_threshold,
                                uint8_t *upper_non_recoverable_threshold)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  fiid_obj_t obj_sdr_record_threshold = NULL;
-  uint32_t acceptable_record_types;
-  uint8_t event_reading_type_code;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  /* We don't want the generic sdr full record, we need the special
-   * threshold one.
-   */
-
-  if (ipmi_sdr_parse_event_reading_type_code (ctx,
-                                              sdr_record,
-                                              sdr_record_len,
-                                              &event_reading_type_code) < 0)
-    goto cleanup;
-
-  if (!IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (event_reading_type_code))
-    {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
-      goto cleanup;
-    }
+  struct sdr_record_decoded rd;
 
-  if (!(obj_sdr_record_threshold = fiid_obj_copy (obj_sdr_record,
-                                                  tmpl_sdr_full_sensor_record_threshold_based_sensors)))
-    {
-      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-      goto cleanup;
-    }
+  if (_sdr_record_decode_threshold (ctx,
+                                    sdr_record,
+                                    sdr_record_len,
+                                    &rd) < 0)
+    return (-1);
 
   if (lower_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_non_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_critical_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_LOWER_NON_CRITICAL) < 0)
+        return (-1);
+      *lower_non_critical_threshold = rd.decoded.lower_non_critical_threshold;
     }
-
   if (lower_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_critical_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_LOWER_CRITICAL) < 0)
+        return (-1);
+      *lower_critical_threshold = rd.decoded.lower_critical_threshold;
     }
-
   if (lower_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_non_recoverable_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *lower_non_recoverable_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_LOWER_NON_RECOVERABLE) < 0)
+        return (-1);
+      *lower_non_recoverable_threshold = rd.decoded.lower_non_recoverable_threshold;
     }
-
   if (upper_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_non_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_critical_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_UPPER_NON_CRITICAL) < 0)
+        return (-1);
+      *upper_non_critical_threshold = rd.decoded.upper_non_critical_threshold;
     }
-
   if (upper_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_critical_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_critical_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_UPPER_CRITICAL) < 0)
+        return (-1);
+      *upper_critical_threshold = rd.decoded.upper_critical_threshold;
     }
-
   if (upper_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_non_recoverable_threshold",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
-          goto cleanup;
-        }
-      *upper_non_recoverable_threshold = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_UPPER_NON_RECOVERABLE) < 0)
+        return (-1);
+      *upper_non_recoverable_threshold = rd.decoded.upper_non_recoverable_threshold;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  fiid_obj_destroy (obj_sdr_record_threshold);
-  return (rv);
+  return (0);
 }
 
 int
@@ -2982,84 +2146,61 @@ ipmi_sdr_parse_tolerance (ipmi_sdr_ctx_t ctx,
                           unsigned int sdr_record_len,
                           double **tolerance)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
+  struct sdr_record_decoded rd;
   int8_t r_exponent;
   int16_t m;
-  uint8_t tolerance_raw, linearization;
-  double *tmp_tolerance = NULL;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
+  uint8_t linearization;
+  double reading;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
 
   if (tolerance)
     *tolerance = NULL;
 
-  if (ipmi_sdr_parse_sensor_decoding_data (ctx,
-                                           sdr_record,
-                                           sdr_record_len,
-                                           &r_exponent,
-                                           NULL,
-                                           &m,
-                                           NULL,
-                                           &linearization,
-                                           NULL) < 0)
-    goto cleanup;
+  if (_sdr_record_decoded_decoding_data (ctx,
+                                         &rd,
+                                         &r_exponent,
+                                         NULL,
+                                         &m,
+                                         NULL,
+                                         &linearization,
+                                         NULL) < 0)
+    return (-1);
 
   if (!IPMI_SDR_LINEARIZATION_IS_LINEAR (linearization))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARSE_CANNOT_PARSE_OR_CALCULATE);
-      goto cleanup;
+      return (-1);
     }
 
   if (tolerance)
     {
-      double reading;
-
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "tolerance",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      tolerance_raw = val;
-
+      /* tolerance shares a byte with m, already checked above */
       if (ipmi_sensor_decode_tolerance (r_exponent,
                                         m,
                                         linearization,
-                                        tolerance_raw,
+                                        rd.decoded.tolerance,
                                         &reading) < 0)
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
-          goto cleanup;
+          return (-1);
         }
 
-      if (!(tmp_tolerance = (double *)malloc (sizeof (double))))
+      if (!((*tolerance) = (double *)malloc (sizeof (double))))
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
-          goto cleanup;
+          return (-1);
         }
-      (*tmp_tolerance) = reading;
+      (**tolerance) = reading;
     }
 
-  if (tolerance)
-    *tolerance = tmp_tolerance;
-
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  if (rv < 0)
-    free (tmp_tolerance);
-  return (rv);
+  return (0);
 }
 
 int
@@ -3068,85 +2209,43 @@ ipmi_sdr_parse_accuracy (ipmi_sdr_ctx_t ctx,
                          unsigned int sdr_record_len,
                          double **accuracy)
 {
-  fiid_obj_t obj_sdr_record = NULL;
-  uint32_t acceptable_record_types;
-  uint16_t accuracy_raw;
-  uint8_t accuracy_ls, accuracy_ms, accuracy_exp;
-  double *tmp_accuracy = NULL;
-  uint64_t val;
-  int rv = -1;
-
-  acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
-
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  struct sdr_record_decoded rd;
+  double reading;
 
-  if (accuracy)
-    *accuracy = NULL;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD,
+                          &rd) < 0)
+    return (-1);
 
   if (accuracy)
     {
-      double reading;
-
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_ls",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      accuracy_ls = val;
-
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_ms",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      accuracy_ms = val;
+      *accuracy = NULL;
 
-      /* accuracy is unsigned, no need to sign extend */
-      accuracy_raw = accuracy_ls | (((uint16_t)accuracy_ms) << 6);
-
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_exp",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      accuracy_exp = val;
+      if (_sdr_record_decoded_check (ctx,
+                                     &rd,
+                                     SDR_DECODED_B_MS_ACCURACY_LS | SDR_DECODED_ACCURACY_MS_EXP) < 0)
+        return (-1);
 
-      if (ipmi_sensor_decode_accuracy (accuracy_raw,
-                                       accuracy_exp,
+      if (ipmi_sensor_decode_accuracy (rd.decoded.accuracy,
+                                       rd.decoded.accuracy_exp,
                                        &reading) < 0)
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
-          goto cleanup;
+          return (-1);
         }
 
-      if (!(tmp_accuracy = (double *)malloc (sizeof (double))))
+      if (!((*accuracy) = (double *)malloc (sizeof (double))))
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
-          goto cleanup;
+          return (-1);
         }
-      (*tmp_accuracy) = reading;
+      (**accuracy) = reading;
     }
 
-  if (accuracy)
-    *accuracy = tmp_accuracy;
-
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  if (rv < 0)
-    free (tmp_accuracy);
-  return (rv);
+  return (0);
 }
 
 int
@@ -3156,47 +2255,35 @@ ipmi_sdr_parse_hysteresis (ipmi_sdr_ctx_t ctx,
                            uint8_t *positive_going_threshold_hysteresis,
                            uint8_t *negative_going_threshold_hysteresis)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
   if (positive_going_threshold_hysteresis)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "positive_going_threshold_hysteresis",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *positive_going_threshold_hysteresis = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_POSITIVE_HYSTERESIS) < 0)
+        return (-1);
+      *positive_going_threshold_hysteresis = rd.decoded.positive_going_threshold_hysteresis;
     }
+
   if (negative_going_threshold_hysteresis)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "negative_going_threshold_hysteresis",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *negative_going_threshold_hysteresis = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_NEGATIVE_HYSTERESIS) < 0)
+        return (-1);
+      *negative_going_threshold_hysteresis = rd.decoded.negative_going_threshold_hysteresis;
     }
-  rv = 0;
+
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
 int
@@ -3208,75 +2295,44 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
                                       uint8_t *id_string_instance_modifier_offset,
                                       uint8_t *entity_instance_sharing)
 {
-  fiid_obj_t obj_sdr_record = NULL;
+  struct sdr_record_decoded rd;
   uint32_t acceptable_record_types;
-  uint64_t val;
-  int rv = -1;
 
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
 
-  if (!(obj_sdr_record = _sdr_record_get_common (ctx,
-                                                 sdr_record,
-                                                 sdr_record_len,
-                                                 acceptable_record_types)))
-    goto cleanup;
-
-  if (share_count)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "share_count",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *share_count = val;
-    }
-
-  if (id_string_instance_modifier_type)
-    {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "id_string_instance_modifier_type",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *id_string_instance_modifier_type = val;
-    }
+  if (_sdr_record_decode (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          acceptable_record_types,
+                          &rd) < 0)
+    return (-1);
 
-  if (id_string_instance_modifier_offset)
+  if (share_count || id_string_instance_modifier_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "id_string_instance_modifier_offset",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *id_string_instance_modifier_offset = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_SHARE_COUNT) < 0)
+        return (-1);
+      if (share_count)
+        *share_count = rd.decoded.share_count;
+      if (id_string_instance_modifier_type)
+        *id_string_instance_modifier_type = rd.decoded.id_string_instance_modifier_type;
     }
 
-  if (entity_instance_sharing)
+  if (id_string_instance_modifier_offset || entity_instance_sharing)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance_sharing",
-                        &val) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
-          goto cleanup;
-        }
-      *entity_instance_sharing = val;
+      if (_sdr_record_decoded_check (ctx, &rd, SDR_DECODED_ID_STRING_INSTANCE_MODIFIER) < 0)
+        return (-1);
+      if (id_string_instance_modifier_offset)
+        *id_string_instance_modifier_offset = rd.decoded.id_string_instance_modifier_offset;
+      if (entity_instance_sharing)
+        *entity_instance_sharing = rd.decoded.entity_instance_sharing;
     }
 
-  rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
- cleanup:
-  fiid_obj_destroy (obj_sdr_record);
-  return (rv);
+  return (0);
 }
 
+
 int
 ipmi_sdr_parse_container_entity (ipmi_sdr_ctx_t ctx,
                                  const void *sdr_record,
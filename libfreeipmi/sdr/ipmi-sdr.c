@@ -36,7 +36,6 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif /* HAVE_UNISTD_H */
-#include <sys/mman.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -104,6 +103,12 @@ ipmi_sdr_ctx_create (void)
       goto cleanup;
     }
 
+  if (!(ctx->arena = fiid_arena_create (0)))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
   sdr_init_ctx (ctx);
   return (ctx);
 
@@ -112,6 +117,7 @@ ipmi_sdr_ctx_create (void)
     {
       if (ctx->saved_offsets)
         list_destroy (ctx->saved_offsets);
+      fiid_arena_destroy (ctx->arena);
       free (ctx);
     }
   return (NULL);
@@ -132,11 +138,14 @@ ipmi_sdr_ctx_destroy (ipmi_sdr_ctx_t ctx)
   /* ignore potential error, destroy path */
   if (ctx->fd >= 0)
     close (ctx->fd);
-  /* ignore potential error, void return func */
-  if (ctx->sdr_cache)
-    munmap (ctx->sdr_cache, ctx->file_size);
+  sdr_cache_unmap (ctx);
+
+  free (ctx->index_offsets);
+  free (ctx->index_record_id_entries);
+  free (ctx->index_sensor_entries);
 
   list_destroy (ctx->saved_offsets);
+  fiid_arena_destroy (ctx->arena);
 
   ctx->magic = ~IPMI_SDR_CTX_MAGIC;
   ctx->operation = IPMI_SDR_OPERATION_UNINITIALIZED;
@@ -199,7 +208,9 @@ ipmi_sdr_ctx_set_flags (ipmi_sdr_ctx_t ctx, unsigned int flags)
       return (-1);
     }
 
-  if (flags & ~IPMI_SDR_FLAGS_DEBUG_DUMP)
+  if (flags & ~(IPMI_SDR_FLAGS_DEBUG_DUMP
+                | IPMI_SDR_FLAGS_CACHE_INDEX
+                | IPMI_SDR_FLAGS_CACHE_SHARED))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
       return (-1);
@@ -35,6 +35,8 @@
 #include "freeipmi/fiid/fiid.h"
 #include "freeipmi/record-format/ipmi-sel-record-format.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
+#include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/util/ipmi-sensor-and-event-code-tables-util.h"
 #include "freeipmi/util/ipmi-util.h"
 
@@ -43,6 +45,7 @@
 #include "ipmi-sel-trace.h"
 #include "ipmi-sel-util.h"
 
+#include "api/ipmi-api-util.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -120,6 +123,294 @@ sel_get_reservation_id (ipmi_sel_ctx_t ctx,
   return (rv);
 }
 
+int
+sel_get_entry (ipmi_sel_ctx_t ctx,
+               fiid_obj_t obj_cmd_rs,
+               uint16_t *reservation_id,
+               int *reservation_id_initialized,
+               uint16_t record_id)
+{
+  unsigned int reservation_id_retry_count = 0;
+  unsigned int reservation_canceled = 0;
+  unsigned int is_insufficient_privilege_level = 0;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->ipmi_ctx);
+  assert (fiid_obj_valid (obj_cmd_rs) == 1);
+  assert (fiid_obj_template_compare (obj_cmd_rs, tmpl_cmd_get_sel_entry_rs) == 1);
+  assert (reservation_id);
+
+  /*
+   * IPMI spec states in section 31.4.1:
+   *
+   * "A Requester must issue a 'Reserve SEL' command prior to issuing
+   * any of the following SEL commands. Note that the 'Reserve SEL'
+   * command only needs to be reissued if the reservation is
+   * canceled. ... Get SEL Entry command (if 'get' is from an offset
+   * other than 00h)".
+   *
+   * Since we always use an offset of 00h, presumably we should never
+   * need reserve the SEL before the get_sel_entry call.
+   *
+   * However, some machines may need it due to compliance issues.
+   * I don't think using a reservation ID all of the time hurts
+   * anything, so we'll just use it all of the time.
+   */
+
+  while (1)
+    {
+      if (!(*reservation_id_initialized) || reservation_canceled)
+        {
+          if (ctx->reservation_id_registered)
+            (*reservation_id) = ctx->reservation_id;
+          else
+            {
+              if (sel_get_reservation_id (ctx, reservation_id, &is_insufficient_privilege_level) < 0)
+                {
+                  /* IPMI Workaround (achu)
+                   *
+                   * Discovered on Supermicro H8QME with SIMSO daughter card.
+                   *
+                   * For some reason motherboard requires Operator
+                   * privilege instead of User privilege.  If
+                   * IPMI_COMP_CODE_INSUFFICIENT_PRIVILEGE_LEVEL was
+                   * received, just use reservation ID 0. For the reasons
+                   * listed above, it shouldn't matter.
+                   */
+                  if (is_insufficient_privilege_level)
+                    (*reservation_id) = 0;
+                  else
+                    goto cleanup;
+                }
+            }
+          (*reservation_id_initialized)++;
+        }
+
+      if (ipmi_cmd_get_sel_entry (ctx->ipmi_ctx,
+                                  (*reservation_id),
+                                  record_id,
+                                  0,
+                                  IPMI_SEL_READ_ENTIRE_RECORD_BYTES_TO_READ,
+                                  obj_cmd_rs) < 0)
+        {
+          if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
+              && ipmi_check_completion_code (obj_cmd_rs,
+                                             IPMI_COMP_CODE_RESERVATION_CANCELLED) == 1)
+            {
+              if (ctx->reservation_id_registered)
+                {
+                  SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_RESERVATION_CANCELED);
+                  goto cleanup;
+                }
+              else
+                {
+                  reservation_id_retry_count++;
+                  reservation_canceled++;
+                  (*reservation_id_initialized) = 0;
+
+                  if (reservation_id_retry_count > IPMI_SEL_RESERVATION_ID_RETRY)
+                    {
+                      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+                      goto cleanup;
+                    }
+
+                  continue;
+                }
+            }
+          else
+            {
+              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+              goto cleanup;
+            }
+        }
+
+      break;
+    }
+
+  rv = 0;
+ cleanup:
+  return (rv);
+}
+
+int
+sel_pipeline_init (ipmi_sel_ctx_t ctx,
+                   struct ipmi_sel_pipeline *pipeline)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->ipmi_ctx);
+  assert (pipeline);
+
+  memset (pipeline, '\0', sizeof (struct ipmi_sel_pipeline));
+
+  /* speculative requests issued one at a time would only add round trips */
+  if (!(ctx->flags & IPMI_SEL_FLAGS_PIPELINE)
+      || !api_ipmi_cmd_batch_pipelined (ctx->ipmi_ctx))
+    return (0);
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      if (!(pipeline->obj_cmd_rq[i] = fiid_obj_create (tmpl_cmd_get_sel_entry_rq)))
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      if (!(pipeline->obj_cmd_rs[i] = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  pipeline->enabled = 1;
+  return (0);
+}
+
+void
+sel_pipeline_cleanup (struct ipmi_sel_pipeline *pipeline)
+{
+  unsigned int i;
+
+  assert (pipeline);
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      fiid_obj_destroy (pipeline->obj_cmd_rq[i]);
+      fiid_obj_destroy (pipeline->obj_cmd_rs[i]);
+    }
+}
+
+/* Same semantics as sel_get_entry(), but may answer from or issue
+ * speculative requests for the following record ids.  Any error on
+ * the requested record id itself is left to sel_get_entry() so
+ * reservation and completion code handling stays the same.
+ */
+int
+sel_get_entry_pipelined (ipmi_sel_ctx_t ctx,
+                         struct ipmi_sel_pipeline *pipeline,
+                         fiid_obj_t obj_cmd_rs,
+                         uint16_t *reservation_id,
+                         int *reservation_id_initialized,
+                         uint16_t record_id,
+                         uint16_t record_id_last)
+{
+  uint8_t buf[IPMI_SEL_PIPELINE_RS_BUFLEN];
+  unsigned int i;
+  int len;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->ipmi_ctx);
+  assert (pipeline);
+  assert (fiid_obj_valid (obj_cmd_rs) == 1);
+  assert (reservation_id);
+  assert (reservation_id_initialized);
+
+  if (!pipeline->enabled)
+    goto sequential;
+
+  for (i = 0; i < pipeline->count; i++)
+    {
+      if (pipeline->valid[i]
+          && pipeline->record_ids[i] == record_id)
+        {
+          pipeline->valid[i] = 0;
+
+          if ((len = fiid_obj_get_all (pipeline->obj_cmd_rs[i],
+                                       buf,
+                                       IPMI_SEL_PIPELINE_RS_BUFLEN)) < 0)
+            {
+              SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, pipeline->obj_cmd_rs[i]);
+              return (-1);
+            }
+
+          if (fiid_obj_set_all (obj_cmd_rs, buf, len) < 0)
+            {
+              SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+              return (-1);
+            }
+
+          return (0);
+        }
+    }
+
+  /* chain went somewhere we didn't guess, discard */
+  pipeline->count = 0;
+
+  /* first request obtains the reservation id */
+  if (!(*reservation_id_initialized))
+    goto sequential;
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      uint16_t tmp_record_id = record_id + i;
+
+      if (i
+          && (tmp_record_id < record_id
+              || tmp_record_id > record_id_last
+              || tmp_record_id == IPMI_SEL_GET_RECORD_ID_LAST_ENTRY))
+        break;
+
+      if (fill_cmd_get_sel_entry (*reservation_id,
+                                  tmp_record_id,
+                                  0,
+                                  IPMI_SEL_READ_ENTIRE_RECORD_BYTES_TO_READ,
+                                  pipeline->obj_cmd_rq[i]) < 0)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      pipeline->record_ids[i] = tmp_record_id;
+      pipeline->valid[i] = 0;
+    }
+
+  if (i < 2)
+    goto sequential;
+
+  if (api_ipmi_cmd_batch (ctx->ipmi_ctx,
+                          IPMI_BMC_IPMB_LUN_BMC,
+                          IPMI_NET_FN_STORAGE_RQ,
+                          pipeline->obj_cmd_rq,
+                          pipeline->obj_cmd_rs,
+                          i) < 0)
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+      return (-1);
+    }
+  pipeline->count = i;
+
+  /* records not present, reservation canceled, etc. are simply not used */
+  for (i = 1; i < pipeline->count; i++)
+    {
+      if (ipmi_check_completion_code_success (pipeline->obj_cmd_rs[i]) == 1)
+        pipeline->valid[i] = 1;
+    }
+
+  if (ipmi_check_completion_code_success (pipeline->obj_cmd_rs[0]) == 1)
+    {
+      pipeline->valid[0] = 1;
+      return (sel_get_entry_pipelined (ctx,
+                                       pipeline,
+                                       obj_cmd_rs,
+                                       reservation_id,
+                                       reservation_id_initialized,
+                                       record_id,
+                                       record_id_last));
+    }
+
+ sequential:
+  return (sel_get_entry (ctx,
+                         obj_cmd_rs,
+                         reservation_id,
+                         reservation_id_initialized,
+                         record_id));
+}
+
 int
 sel_get_record_header_info (ipmi_sel_ctx_t ctx,
                             struct ipmi_sel_entry *sel_entry,
@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 
+#include "freeipmi/fiid/fiid.h"
 #include "freeipmi/sel/ipmi-sel.h"
 
 #include "ipmi-sel-defs.h"
@@ -53,6 +54,53 @@ int sel_get_reservation_id (ipmi_sel_ctx_t ctx,
                             uint16_t *reservation_id,
                             unsigned int *is_insufficient_privilege_level);
 
+/* Speculative Get SEL Entry requests for the record ids following
+ * the one being read.  Most BMCs hand out dense sequential record
+ * ids, so the responses are usually the next records in the
+ * next_record_id chain.  Responses are only used if the chain
+ * actually reaches their record id.
+ */
+struct ipmi_sel_pipeline {
+  int enabled;
+  unsigned int count;
+  uint16_t record_ids[IPMI_SEL_PIPELINE_DEPTH];
+  int valid[IPMI_SEL_PIPELINE_DEPTH];
+  fiid_obj_t obj_cmd_rq[IPMI_SEL_PIPELINE_DEPTH];
+  fiid_obj_t obj_cmd_rs[IPMI_SEL_PIPELINE_DEPTH];
+};
+
+int sel_get_entry (ipmi_sel_ctx_t ctx,
+                   fiid_obj_t obj_cmd_rs,
+                   uint16_t *reservation_id,
+                   int *reservation_id_initialized,
+                   uint16_t record_id);
+
+int sel_pipeline_init (ipmi_sel_ctx_t ctx,
+                       struct ipmi_sel_pipeline *pipeline);
+
+void sel_pipeline_cleanup (struct ipmi_sel_pipeline *pipeline);
+
+/* Same semantics as sel_get_entry(), but may answer from or issue
+ * speculative requests for the following record ids.
+ */
+int sel_get_entry_pipelined (ipmi_sel_ctx_t ctx,
+                             struct ipmi_sel_pipeline *pipeline,
+                             fiid_obj_t obj_cmd_rs,
+                             uint16_t *reservation_id,
+                             int *reservation_id_initialized,
+                             uint16_t record_id,
+                             uint16_t record_id_last);
+
+/* Bring ctx->mirror_filename up to date with the BMC, returns number
+ * of records appended
+ */
+int sel_mirror_sync (ipmi_sel_ctx_t ctx);
+
+/* Returns all mirrored records, caller must free */
+int sel_mirror_read (ipmi_sel_ctx_t ctx,
+                     uint8_t **records,
+                     unsigned int *records_count);
+
 int sel_get_record_header_info (ipmi_sel_ctx_t ctx,
                                 struct ipmi_sel_entry *sel_entry,
                                 uint16_t *record_id,
@@ -30,8 +30,6 @@
 #include "freeipmi/sdr/ipmi-sdr.h"
 #include "freeipmi/sel/ipmi-sel.h"
 
-#include "list.h"
-
 #ifndef MAXPATHLEN
 #define MAXPATHLEN 4096
 #endif /* MAXPATHLEN */
@@ -44,9 +42,46 @@
 
 #define IPMI_SEL_RESERVATION_ID_RETRY         4
 
+/* Get SEL Entry requests outstanding with IPMI_SEL_FLAGS_PIPELINE */
+#define IPMI_SEL_PIPELINE_DEPTH               8
+
+/* cmd, comp_code, next_record_id, record_data with room to spare */
+#define IPMI_SEL_PIPELINE_RS_BUFLEN          64
+
+/* SEL mirror file, see ipmi_sel_sync()
+ *
+ * 4 bytes - magic
+ * 1 byte  - mirror file version
+ * 1 byte  - SEL version
+ * 4 bytes - most recent addition timestamp (little endian)
+ * 4 bytes - most recent erase timestamp (little endian)
+ *
+ * followed by 16 byte SEL records in the order they were read from
+ * the BMC.  The timestamps are written after the records are synced
+ * to disk, so a mirror with stale timestamps is simply re-checked.
+ */
+#define IPMI_SEL_MIRROR_FILE_MAGIC_0 0x5E
+#define IPMI_SEL_MIRROR_FILE_MAGIC_1 0x1A
+#define IPMI_SEL_MIRROR_FILE_MAGIC_2 0xB3
+#define IPMI_SEL_MIRROR_FILE_MAGIC_3 0x4D
+
+#define IPMI_SEL_MIRROR_FILE_VERSION_1_0 0x00
+
+#define IPMI_SEL_MIRROR_HEADER_LENGTH        14
+
+/* Parsed SEL entries are kept in one array, grown by doubling.  It
+ * is realloc()ed until it reaches IPMI_SEL_ENTRIES_MMAP_THRESHOLD
+ * bytes, then copied once to an anonymous mapping which mremap()
+ * grows from there on where available.  A full SEL is at most 65535
+ * entries.
+ */
+#define IPMI_SEL_ENTRIES_INITIAL_COUNT       64
+#define IPMI_SEL_ENTRIES_MMAP_THRESHOLD      (128 * 1024)
+
 #define IPMI_SEL_FLAGS_MASK                     \
   (IPMI_SEL_FLAGS_DEBUG_DUMP                    \
-   | IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS)
+   | IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS  \
+   | IPMI_SEL_FLAGS_PIPELINE)
 
 #define IPMI_SEL_SEPARATOR_STRING     " | "
 
@@ -65,6 +100,8 @@
 struct ipmi_sel_entry {
   uint8_t sel_event_record[IPMI_SEL_RECORD_LENGTH];
   unsigned int sel_event_record_len; /* should always be 16, but just in case */
+  uint16_t record_id;
+  int record_id_valid;
 };
 
 struct ipmi_sel_oem_intel_node_manager {
@@ -86,6 +123,7 @@ struct ipmi_sel_ctx {
   uint8_t ipmi_version_minor;
   char *debug_prefix;
   char *separator;
+  char *mirror_filename;
 
   uint16_t reservation_id;
   int reservation_id_registered;
@@ -96,9 +134,12 @@ struct ipmi_sel_ctx {
   int utc_offset;
 
   int sel_entries_loaded;
-  List sel_entries;
-  ListIterator sel_entries_itr;
-  struct ipmi_sel_entry *current_sel_entry;
+  struct ipmi_sel_entry *sel_entries;
+  unsigned int sel_entries_count;
+  unsigned int sel_entries_size;
+  int sel_entries_mmapped;
+  int sel_entries_sorted;     /* record ids ascending, can binary search */
+  unsigned int current_sel_entry; /* == sel_entries_count at end of list */
 
   struct ipmi_sel_entry *callback_sel_entry;
 
@@ -0,0 +1,645 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/sel/ipmi-sel.h"
+
+#include "freeipmi/api/ipmi-sel-cmds-api.h"
+#include "freeipmi/cmds/ipmi-sel-cmds.h"
+#include "freeipmi/fiid/fiid.h"
+#include "freeipmi/spec/ipmi-comp-code-spec.h"
+#include "freeipmi/util/ipmi-util.h"
+
+#include "ipmi-sel-common.h"
+#include "ipmi-sel-defs.h"
+#include "ipmi-sel-trace.h"
+#include "ipmi-sel-util.h"
+
+#include "libcommon/ipmi-fiid-util.h"
+
+#include "freeipmi-portability.h"
+#include "fd.h"
+
+struct ipmi_sel_mirror_header {
+  uint8_t sel_version;
+  uint32_t most_recent_addition_timestamp;
+  uint32_t most_recent_erase_timestamp;
+};
+
+static void
+_sel_mirror_header_encode (struct ipmi_sel_mirror_header *header,
+                           uint8_t *buf)
+{
+  assert (header);
+  assert (buf);
+
+  buf[0] = IPMI_SEL_MIRROR_FILE_MAGIC_0;
+  buf[1] = IPMI_SEL_MIRROR_FILE_MAGIC_1;
+  buf[2] = IPMI_SEL_MIRROR_FILE_MAGIC_2;
+  buf[3] = IPMI_SEL_MIRROR_FILE_MAGIC_3;
+  buf[4] = IPMI_SEL_MIRROR_FILE_VERSION_1_0;
+  buf[5] = header->sel_version;
+  buf[6] = (header->most_recent_addition_timestamp & 0x000000FF);
+  buf[7] = (header->most_recent_addition_timestamp & 0x0000FF00) >> 8;
+  buf[8] = (header->most_recent_addition_timestamp & 0x00FF0000) >> 16;
+  buf[9] = (header->most_recent_addition_timestamp & 0xFF000000) >> 24;
+  buf[10] = (header->most_recent_erase_timestamp & 0x000000FF);
+  buf[11] = (header->most_recent_erase_timestamp & 0x0000FF00) >> 8;
+  buf[12] = (header->most_recent_erase_timestamp & 0x00FF0000) >> 16;
+  buf[13] = (header->most_recent_erase_timestamp & 0xFF000000) >> 24;
+}
+
+/* returns 1 if valid, 0 if not */
+static int
+_sel_mirror_header_decode (const uint8_t *buf,
+                           struct ipmi_sel_mirror_header *header)
+{
+  assert (buf);
+  assert (header);
+
+  if (buf[0] != IPMI_SEL_MIRROR_FILE_MAGIC_0
+      || buf[1] != IPMI_SEL_MIRROR_FILE_MAGIC_1
+      || buf[2] != IPMI_SEL_MIRROR_FILE_MAGIC_2
+      || buf[3] != IPMI_SEL_MIRROR_FILE_MAGIC_3
+      || buf[4] != IPMI_SEL_MIRROR_FILE_VERSION_1_0)
+    return (0);
+
+  header->sel_version = buf[5];
+  header->most_recent_addition_timestamp = buf[6];
+  header->most_recent_addition_timestamp |= (buf[7] << 8);
+  header->most_recent_addition_timestamp |= (buf[8] << 16);
+  header->most_recent_addition_timestamp |= ((uint32_t)buf[9] << 24);
+  header->most_recent_erase_timestamp = buf[10];
+  header->most_recent_erase_timestamp |= (buf[11] << 8);
+  header->most_recent_erase_timestamp |= (buf[12] << 16);
+  header->most_recent_erase_timestamp |= ((uint32_t)buf[13] << 24);
+  return (1);
+}
+
+static int
+_sel_mirror_header_write (ipmi_sel_ctx_t ctx,
+                          int fd,
+                          struct ipmi_sel_mirror_header *header)
+{
+  uint8_t buf[IPMI_SEL_MIRROR_HEADER_LENGTH];
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (fd >= 0);
+  assert (header);
+
+  _sel_mirror_header_encode (header, buf);
+
+  if (lseek (fd, 0, SEEK_SET) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (fd_write_n (fd, buf, IPMI_SEL_MIRROR_HEADER_LENGTH) != IPMI_SEL_MIRROR_HEADER_LENGTH)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  return (0);
+}
+
+static int
+_sel_mirror_record_read (ipmi_sel_ctx_t ctx,
+                         int fd,
+                         unsigned int index,
+                         uint8_t *record)
+{
+  off_t offset;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (fd >= 0);
+  assert (record);
+
+  offset = IPMI_SEL_MIRROR_HEADER_LENGTH + (off_t)index * IPMI_SEL_RECORD_LENGTH;
+
+  if (lseek (fd, offset, SEEK_SET) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (fd_read_n (fd, record, IPMI_SEL_RECORD_LENGTH) != IPMI_SEL_RECORD_LENGTH)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  return (0);
+}
+
+/* Compare record_id's record on the BMC against a mirrored record.
+ *
+ * Returns 1 if identical, 0 if different or no longer present, -1
+ * on error.
+ */
+static int
+_sel_mirror_record_check (ipmi_sel_ctx_t ctx,
+                          fiid_obj_t obj_cmd_rs,
+                          uint16_t *reservation_id,
+                          int *reservation_id_initialized,
+                          uint16_t record_id,
+                          const uint8_t *record,
+                          uint16_t *next_record_id)
+{
+  uint8_t buf[IPMI_SEL_RECORD_LENGTH];
+  uint64_t val;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (obj_cmd_rs);
+  assert (reservation_id);
+  assert (reservation_id_initialized);
+  assert (record);
+
+  if (sel_get_entry (ctx,
+                     obj_cmd_rs,
+                     reservation_id,
+                     reservation_id_initialized,
+                     record_id) < 0)
+    {
+      if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
+          && ipmi_check_completion_code (obj_cmd_rs,
+                                         IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+        return (0);
+      return (-1);
+    }
+
+  memset (buf, '\0', IPMI_SEL_RECORD_LENGTH);
+  if (fiid_obj_get_data (obj_cmd_rs,
+                         "record_data",
+                         buf,
+                         IPMI_SEL_RECORD_LENGTH) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      return (-1);
+    }
+
+  if (memcmp (buf, record, IPMI_SEL_RECORD_LENGTH))
+    return (0);
+
+  if (next_record_id)
+    {
+      if (FIID_OBJ_GET (obj_cmd_rs, "next_record_id", &val) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+          return (-1);
+        }
+      (*next_record_id) = val;
+    }
+
+  return (1);
+}
+
+static int
+_sel_mirror_get_info (ipmi_sel_ctx_t ctx,
+                      struct ipmi_sel_mirror_header *header,
+                      uint16_t *entries)
+{
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint8_t major, minor;
+  uint64_t val;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (header);
+  assert (entries);
+
+  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_info_rs)))
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (ipmi_cmd_get_sel_info (ctx->ipmi_ctx, obj_cmd_rs) < 0)
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "sel_version_major", &val) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  major = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "sel_version_minor", &val) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  minor = val;
+  header->sel_version = (major << 4) | minor;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "entries", &val) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  (*entries) = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "most_recent_addition_timestamp", &val) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  header->most_recent_addition_timestamp = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "most_recent_erase_timestamp", &val) < 0)
+    {
+      SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  header->most_recent_erase_timestamp = val;
+
+  rv = 0;
+ cleanup:
+  fiid_obj_destroy (obj_cmd_rs);
+  return (rv);
+}
+
+int
+sel_mirror_sync (ipmi_sel_ctx_t ctx)
+{
+  struct ipmi_sel_mirror_header bmc_header;
+  struct ipmi_sel_mirror_header mirror_header;
+  struct ipmi_sel_mirror_header tmp_header;
+  struct ipmi_sel_pipeline pipeline;
+  uint8_t buf[IPMI_SEL_MIRROR_HEADER_LENGTH];
+  uint8_t record[IPMI_SEL_RECORD_LENGTH];
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint16_t reservation_id = 0;
+  int reservation_id_initialized = 0;
+  uint16_t record_id = IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY;
+  uint16_t next_record_id;
+  uint16_t entries;
+  unsigned int mirror_count = 0;
+  unsigned int appended = 0;
+  struct stat statbuf;
+  int mirror_valid = 0;
+  uint64_t val;
+  int fd = -1;
+  int ret;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->ipmi_ctx);
+  assert (ctx->mirror_filename);
+
+  if (sel_pipeline_init (ctx, &pipeline) < 0)
+    goto cleanup;
+
+  if (_sel_mirror_get_info (ctx, &bmc_header, &entries) < 0)
+    goto cleanup;
+
+  if ((fd = open (ctx->mirror_filename, O_RDWR | O_CREAT, 0644)) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (fstat (fd, &statbuf) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (statbuf.st_size >= IPMI_SEL_MIRROR_HEADER_LENGTH)
+    {
+      if (fd_read_n (fd, buf, IPMI_SEL_MIRROR_HEADER_LENGTH) != IPMI_SEL_MIRROR_HEADER_LENGTH)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      /* A changed erase timestamp means the SEL was cleared or
+       * entries were deleted, start over.
+       */
+      if (_sel_mirror_header_decode (buf, &mirror_header)
+          && mirror_header.sel_version == bmc_header.sel_version
+          && mirror_header.most_recent_erase_timestamp == bmc_header.most_recent_erase_timestamp)
+        {
+          mirror_valid = 1;
+          mirror_count = (statbuf.st_size - IPMI_SEL_MIRROR_HEADER_LENGTH) / IPMI_SEL_RECORD_LENGTH;
+        }
+    }
+
+  /* Nothing added since the last sync, the common case */
+  if (mirror_valid
+      && mirror_header.most_recent_addition_timestamp == bmc_header.most_recent_addition_timestamp
+      && statbuf.st_size == (IPMI_SEL_MIRROR_HEADER_LENGTH + (off_t)mirror_count * IPMI_SEL_RECORD_LENGTH))
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (!entries)
+    mirror_valid = 0;
+
+  /* Additions may overwrite the oldest entries of a full SEL, so the
+   * first mirrored record must still be the first on the BMC.  The
+   * last mirrored record must still be present to continue from it.
+   */
+  if (mirror_valid && mirror_count)
+    {
+      if (_sel_mirror_record_read (ctx, fd, 0, record) < 0)
+        goto cleanup;
+
+      if ((ret = _sel_mirror_record_check (ctx,
+                                           obj_cmd_rs,
+                                           &reservation_id,
+                                           &reservation_id_initialized,
+                                           IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY,
+                                           record,
+                                           NULL)) < 0)
+        goto cleanup;
+
+      if (ret)
+        {
+          if (_sel_mirror_record_read (ctx, fd, mirror_count - 1, record) < 0)
+            goto cleanup;
+
+          if ((ret = _sel_mirror_record_check (ctx,
+                                               obj_cmd_rs,
+                                               &reservation_id,
+                                               &reservation_id_initialized,
+                                               record[0] | (record[1] << 8),
+                                               record,
+                                               &next_record_id)) < 0)
+            goto cleanup;
+        }
+
+      if (ret)
+        record_id = next_record_id;
+      else
+        mirror_valid = 0;
+    }
+
+  if (!mirror_valid)
+    {
+      /* header timestamps zeroed so an interrupted rebuild is not
+       * taken as complete
+       */
+      tmp_header.sel_version = bmc_header.sel_version;
+      tmp_header.most_recent_addition_timestamp = 0;
+      tmp_header.most_recent_erase_timestamp = bmc_header.most_recent_erase_timestamp;
+
+      if (ftruncate (fd, 0) < 0)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      if (_sel_mirror_header_write (ctx, fd, &tmp_header) < 0)
+        goto cleanup;
+
+      mirror_count = 0;
+      record_id = IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY;
+    }
+  else
+    {
+      /* drop a partially written record from an interrupted sync */
+      if (ftruncate (fd, IPMI_SEL_MIRROR_HEADER_LENGTH + (off_t)mirror_count * IPMI_SEL_RECORD_LENGTH) < 0)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+
+  if (lseek (fd, 0, SEEK_END) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  while (entries && record_id != IPMI_SEL_GET_RECORD_ID_LAST_ENTRY)
+    {
+      if (sel_get_entry_pipelined (ctx,
+                                   &pipeline,
+                                   obj_cmd_rs,
+                                   &reservation_id,
+                                   &reservation_id_initialized,
+                                   record_id,
+                                   IPMI_SEL_GET_RECORD_ID_LAST_ENTRY) < 0)
+        {
+          if (record_id == IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
+              && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
+              && ipmi_check_completion_code (obj_cmd_rs,
+                                             IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+            {
+              /* If the sel is empty it's not really an error */
+              break;
+            }
+          goto cleanup;
+        }
+
+      if (FIID_OBJ_GET (obj_cmd_rs, "next_record_id", &val) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+          goto cleanup;
+        }
+      next_record_id = val;
+
+      /* records are always 16 bytes, pad if the BMC says otherwise */
+      memset (record, '\0', IPMI_SEL_RECORD_LENGTH);
+      if (fiid_obj_get_data (obj_cmd_rs,
+                             "record_data",
+                             record,
+                             IPMI_SEL_RECORD_LENGTH) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+          goto cleanup;
+        }
+
+      if (fd_write_n (fd, record, IPMI_SEL_RECORD_LENGTH) != IPMI_SEL_RECORD_LENGTH)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      appended++;
+      record_id = next_record_id;
+    }
+
+  if (fsync (fd) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (_sel_mirror_header_write (ctx, fd, &bmc_header) < 0)
+    goto cleanup;
+
+  if (fsync (fd) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  rv = appended;
+ cleanup:
+  /* ignore potential error, cleanup path */
+  if (fd >= 0)
+    close (fd);
+  fiid_obj_destroy (obj_cmd_rs);
+  sel_pipeline_cleanup (&pipeline);
+  return (rv);
+}
+
+int
+sel_mirror_read (ipmi_sel_ctx_t ctx,
+                 uint8_t **records,
+                 unsigned int *records_count)
+{
+  struct ipmi_sel_mirror_header mirror_header;
+  uint8_t buf[IPMI_SEL_MIRROR_HEADER_LENGTH];
+  struct stat statbuf;
+  unsigned int count;
+  uint8_t *tmp_records = NULL;
+  int fd = -1;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->mirror_filename);
+  assert (records);
+  assert (records_count);
+
+  if ((fd = open (ctx->mirror_filename, O_RDONLY)) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (fstat (fd, &statbuf) < 0)
+    {
+      SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (statbuf.st_size < IPMI_SEL_MIRROR_HEADER_LENGTH
+      || fd_read_n (fd, buf, IPMI_SEL_MIRROR_HEADER_LENGTH) != IPMI_SEL_MIRROR_HEADER_LENGTH
+      || !_sel_mirror_header_decode (buf, &mirror_header))
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_SYSTEM_ERROR);
+      goto cleanup;
+    }
+
+  count = (statbuf.st_size - IPMI_SEL_MIRROR_HEADER_LENGTH) / IPMI_SEL_RECORD_LENGTH;
+
+  if (count)
+    {
+      if (!(tmp_records = (uint8_t *)malloc (count * IPMI_SEL_RECORD_LENGTH)))
+        {
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
+          goto cleanup;
+        }
+
+      if (fd_read_n (fd, tmp_records, count * IPMI_SEL_RECORD_LENGTH) != (count * IPMI_SEL_RECORD_LENGTH))
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+
+  (*records) = tmp_records;
+  (*records_count) = count;
+  tmp_records = NULL;
+  rv = 0;
+ cleanup:
+  /* ignore potential error, cleanup path */
+  if (fd >= 0)
+    close (fd);
+  free (tmp_records);
+  return (rv);
+}
+
+int
+ipmi_sel_sync (ipmi_sel_ctx_t ctx, const char *filename)
+{
+  char *tmp_filename = NULL;
+  int rv;
+
+  if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sel_ctx_errormsg (ctx), ipmi_sel_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!filename)
+    {
+      free (ctx->mirror_filename);
+      ctx->mirror_filename = NULL;
+      ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+      return (0);
+    }
+
+  if (!ctx->ipmi_ctx)
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+      return (-1);
+    }
+
+  if (!(tmp_filename = strdup (filename)))
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+
+  free (ctx->mirror_filename);
+  ctx->mirror_filename = tmp_filename;
+
+  if ((rv = sel_mirror_sync (ctx)) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+  return (rv);
+}
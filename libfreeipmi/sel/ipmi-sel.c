@@ -28,6 +28,9 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif /* HAVE_UNISTD_H */
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif /* HAVE_MMAP */
 #include <assert.h>
 #include <errno.h>
 
@@ -121,6 +124,7 @@ ipmi_sel_ctx_create (ipmi_ctx_t ipmi_ctx, ipmi_sdr_ctx_t sdr_ctx)
   ctx->ipmi_version_minor = 0;
   ctx->debug_prefix = NULL;
   ctx->separator = NULL;
+  ctx->mirror_filename = NULL;
 
   ctx->reservation_id = 0;
   ctx->reservation_id_registered = 0;
@@ -131,48 +135,146 @@ ipmi_sel_ctx_create (ipmi_ctx_t ipmi_ctx, ipmi_sdr_ctx_t sdr_ctx)
   ctx->utc_offset = 0;
 
   ctx->sel_entries_loaded = 0;
-
-  if (!(ctx->sel_entries = list_create ((ListDelF)free)))
-    {
-      ERRNO_TRACE (errno);
-      goto cleanup;
-    }
+  ctx->sel_entries = NULL;
+  ctx->sel_entries_count = 0;
+  ctx->sel_entries_size = 0;
+  ctx->sel_entries_mmapped = 0;
+  ctx->sel_entries_sorted = 1;
+  ctx->current_sel_entry = 0;
 
   return (ctx);
+}
 
- cleanup:
-  if (ctx)
+static void
+_sel_entries_free (struct ipmi_sel_entry *sel_entries,
+                   unsigned int sel_entries_size,
+                   int sel_entries_mmapped)
+{
+  if (!sel_entries)
+    return;
+
+#if HAVE_MMAP
+  if (sel_entries_mmapped)
     {
-      if (ctx->sel_entries)
-        list_destroy (ctx->sel_entries);
-      free (ctx);
+      /* ignore potential error, cleanup path */
+      munmap ((void *)sel_entries, sel_entries_size * sizeof (struct ipmi_sel_entry));
+      return;
     }
-  return (NULL);
-}
+#endif /* HAVE_MMAP */
 
-static int
-_sel_entries_delete_all (void *x, void *y)
-{
-  return (1);
+  free (sel_entries);
 }
 
+/* keeps the buffer around for the next parse */
 static void
 _sel_entries_clear (ipmi_sel_ctx_t ctx)
 {
   assert (ctx);
   assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
 
-  list_delete_all (ctx->sel_entries, _sel_entries_delete_all, "dummyvalue");
+  ctx->sel_entries_count = 0;
+  ctx->sel_entries_sorted = 1;
+  ctx->sel_entries_loaded = 0;
+
+  ctx->current_sel_entry = 0;
+  ctx->callback_sel_entry = NULL;
+}
+
+static int
+_sel_entries_grow (ipmi_sel_ctx_t ctx)
+{
+  struct ipmi_sel_entry *sel_entries = NULL;
+  unsigned int sel_entries_size;
+  size_t len;
+  int sel_entries_mmapped = 0;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+
+  if (ctx->sel_entries_size)
+    sel_entries_size = ctx->sel_entries_size * 2;
+  else
+    sel_entries_size = IPMI_SEL_ENTRIES_INITIAL_COUNT;
+
+  len = sel_entries_size * sizeof (struct ipmi_sel_entry);
+
+#if defined(MAP_ANONYMOUS) && HAVE_MMAP
+#if defined(MREMAP_MAYMOVE) && HAVE_MREMAP
+  /* let the kernel move the pages rather than copying them */
+  if (ctx->sel_entries_mmapped)
+    {
+      if ((sel_entries = (struct ipmi_sel_entry *)mremap ((void *)ctx->sel_entries,
+                                                          ctx->sel_entries_size * sizeof (struct ipmi_sel_entry),
+                                                          len,
+                                                          MREMAP_MAYMOVE)) == MAP_FAILED)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      goto out;
+    }
+#endif /* defined(MREMAP_MAYMOVE) && HAVE_MREMAP */
+
+  if (len >= IPMI_SEL_ENTRIES_MMAP_THRESHOLD)
+    {
+      if ((sel_entries = (struct ipmi_sel_entry *)mmap (NULL,
+                                                        len,
+                                                        PROT_READ | PROT_WRITE,
+                                                        MAP_PRIVATE | MAP_ANONYMOUS,
+                                                        -1,
+                                                        0)) == MAP_FAILED)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      sel_entries_mmapped = 1;
+    }
+#endif /* defined(MAP_ANONYMOUS) && HAVE_MMAP */
 
-  if (ctx->sel_entries_itr)
+  if (!sel_entries_mmapped)
     {
-      list_iterator_destroy (ctx->sel_entries_itr);
-      ctx->sel_entries_itr = NULL;
+      /* still on the heap, realloc can usually extend in place */
+      if (!(sel_entries = (struct ipmi_sel_entry *)realloc (ctx->sel_entries, len)))
+        {
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
+          return (-1);
+        }
+      goto out;
     }
-  ctx->sel_entries_loaded = 0;
 
-  ctx->current_sel_entry = NULL;
-  ctx->callback_sel_entry = NULL;
+  if (ctx->sel_entries_count)
+    memcpy (sel_entries,
+            ctx->sel_entries,
+            ctx->sel_entries_count * sizeof (struct ipmi_sel_entry));
+
+  _sel_entries_free (ctx->sel_entries,
+                     ctx->sel_entries_size,
+                     ctx->sel_entries_mmapped);
+
+ out:
+  ctx->sel_entries = sel_entries;
+  ctx->sel_entries_size = sel_entries_size;
+  if (sel_entries_mmapped)
+    ctx->sel_entries_mmapped = 1;
+  return (0);
+}
+
+/* Returns the slot for the next entry, it is not part of the list
+ * until _sel_entries_append() is called.
+ */
+static struct ipmi_sel_entry *
+_sel_entries_next (ipmi_sel_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+
+  if (ctx->sel_entries_count == ctx->sel_entries_size)
+    {
+      if (_sel_entries_grow (ctx) < 0)
+        return (NULL);
+    }
+
+  return (&ctx->sel_entries[ctx->sel_entries_count]);
 }
 
 void
@@ -186,8 +288,11 @@ ipmi_sel_ctx_destroy (ipmi_sel_ctx_t ctx)
 
   free (ctx->debug_prefix);
   free (ctx->separator);
+  free (ctx->mirror_filename);
   _sel_entries_clear (ctx);
-  list_destroy (ctx->sel_entries);
+  _sel_entries_free (ctx->sel_entries,
+                     ctx->sel_entries_size,
+                     ctx->sel_entries_mmapped);
   ctx->magic = ~IPMI_SEL_CTX_MAGIC;
   free (ctx);
 }
@@ -790,114 +895,119 @@ _sel_entry_dump (ipmi_sel_ctx_t ctx, struct ipmi_sel_entry *sel_entry)
   fiid_obj_destroy (obj_sel_record);
 }
 
+/* Adds the entry returned by _sel_entries_next() to the list */
 static int
-_get_sel_entry (ipmi_sel_ctx_t ctx,
-                fiid_obj_t obj_cmd_rs,
-                uint16_t *reservation_id,
-                int *reservation_id_initialized,
-                uint16_t record_id)
+_sel_entries_append (ipmi_sel_ctx_t ctx,
+                     struct ipmi_sel_entry *sel_entry,
+                     Ipmi_Sel_Parse_Callback callback,
+                     void *callback_data)
 {
-  unsigned int reservation_id_retry_count = 0;
-  unsigned int reservation_canceled = 0;
-  unsigned int is_insufficient_privilege_level = 0;
-  int rv = -1;
+  struct ipmi_sel_entry *prev_sel_entry;
 
   assert (ctx);
   assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
-  assert (ctx->ipmi_ctx);
-  assert (fiid_obj_valid (obj_cmd_rs) == 1);
-  assert (fiid_obj_template_compare (obj_cmd_rs, tmpl_cmd_get_sel_entry_rs) == 1);
-  assert (reservation_id);
-
-  /*
-   * IPMI spec states in section 31.4.1:
-   *
-   * "A Requester must issue a 'Reserve SEL' command prior to issuing
-   * any of the following SEL commands. Note that the 'Reserve SEL'
-   * command only needs to be reissued if the reservation is
-   * canceled. ... Get SEL Entry command (if 'get' is from an offset
-   * other than 00h)".
-   *
-   * Since we always use an offset of 00h, presumably we should never
-   * need reserve the SEL before the get_sel_entry call.
-   *
-   * However, some machines may need it due to compliance issues.
-   * I don't think using a reservation ID all of the time hurts
-   * anything, so we'll just use it all of the time.
+  assert (sel_entry == &ctx->sel_entries[ctx->sel_entries_count]);
+
+  /* record id is the first two bytes of all SEL record types, cache
+   * it for ipmi_sel_parse_seek_record_id() and friends
    */
+  if (sel_entry->sel_event_record_len >= IPMI_SEL_RECORD_HEADER_LENGTH)
+    {
+      sel_entry->record_id = sel_entry->sel_event_record[0];
+      sel_entry->record_id |= (sel_entry->sel_event_record[1] << 8);
+      sel_entry->record_id_valid = 1;
+    }
+  else
+    {
+      sel_entry->record_id = 0;
+      sel_entry->record_id_valid = 0;
+    }
 
-  while (1)
+  _sel_entry_dump (ctx, sel_entry);
+
+  /* achu: should come before the entry is counted to avoid having a
+   * failed entry on the list
+   */
+  if (callback)
     {
-      if (!(*reservation_id_initialized) || reservation_canceled)
+      ctx->callback_sel_entry = sel_entry;
+      if ((*callback)(ctx, callback_data) < 0)
         {
-          if (ctx->reservation_id_registered)
-            (*reservation_id) = ctx->reservation_id;
-          else
-            {
-              if (sel_get_reservation_id (ctx, reservation_id, &is_insufficient_privilege_level) < 0)
-                {
-                  /* IPMI Workaround (achu)
-                   *
-                   * Discovered on Supermicro H8QME with SIMSO daughter card.
-                   *
-                   * For some reason motherboard requires Operator
-                   * privilege instead of User privilege.  If
-                   * IPMI_COMP_CODE_INSUFFICIENT_PRIVILEGE_LEVEL was
-                   * received, just use reservation ID 0. For the reasons
-                   * listed above, it shouldn't matter.
-                   */
-                  if (is_insufficient_privilege_level)
-                    (*reservation_id) = 0;
-                  else
-                    goto cleanup;
-                }
-            }
-          (*reservation_id_initialized)++;
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_CALLBACK_ERROR);
+          return (-1);
         }
+    }
 
-      if (ipmi_cmd_get_sel_entry (ctx->ipmi_ctx,
-                                  (*reservation_id),
-                                  record_id,
-                                  0,
-                                  IPMI_SEL_READ_ENTIRE_RECORD_BYTES_TO_READ,
-                                  obj_cmd_rs) < 0)
-        {
-          if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
-              && ipmi_check_completion_code (obj_cmd_rs,
-                                             IPMI_COMP_CODE_RESERVATION_CANCELLED) == 1)
-            {
-              if (ctx->reservation_id_registered)
-                {
-                  SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_RESERVATION_CANCELED);
-                  goto cleanup;
-                }
-              else
-                {
-                  reservation_id_retry_count++;
-                  reservation_canceled++;
-                  (*reservation_id_initialized) = 0;
+  if (!sel_entry->record_id_valid)
+    ctx->sel_entries_sorted = 0;
+  else if (ctx->sel_entries_sorted && ctx->sel_entries_count)
+    {
+      prev_sel_entry = &ctx->sel_entries[ctx->sel_entries_count - 1];
+      if (prev_sel_entry->record_id >= sel_entry->record_id)
+        ctx->sel_entries_sorted = 0;
+    }
 
-                  if (reservation_id_retry_count > IPMI_SEL_RESERVATION_ID_RETRY)
-                    {
-                      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
-                      goto cleanup;
-                    }
+  ctx->sel_entries_count++;
+  return (0);
+}
 
-                  continue;
-                }
-            }
-          else
-            {
-              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
-              goto cleanup;
-            }
-        }
+/* Parse SEL entries out of the local mirror, see ipmi_sel_sync() */
+static int
+_sel_parse_mirror (ipmi_sel_ctx_t ctx,
+                   uint16_t record_id_start,
+                   uint16_t record_id_last,
+                   Ipmi_Sel_Parse_Callback callback,
+                   void *callback_data)
+{
+  struct ipmi_sel_entry *sel_entry = NULL;
+  uint8_t *records = NULL;
+  unsigned int records_count = 0;
+  unsigned int i;
+  int rv = -1;
 
-      break;
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->mirror_filename);
+
+  if (sel_mirror_read (ctx, &records, &records_count) < 0)
+    goto cleanup;
+
+  for (i = 0; i < records_count; i++)
+    {
+      uint16_t record_id;
+
+      /* special case, need only get the last record */
+      if (record_id_start == IPMI_SEL_GET_RECORD_ID_LAST_ENTRY
+          && i != (records_count - 1))
+        continue;
+
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
+
+      memcpy (sel_entry->sel_event_record,
+              records + i * IPMI_SEL_RECORD_LENGTH,
+              IPMI_SEL_RECORD_LENGTH);
+      sel_entry->sel_event_record_len = IPMI_SEL_RECORD_LENGTH;
+
+      if (sel_get_record_header_info (ctx,
+                                      sel_entry,
+                                      &record_id,
+                                      NULL) < 0)
+        goto cleanup;
+
+      if (record_id_start != IPMI_SEL_GET_RECORD_ID_LAST_ENTRY
+          && (record_id < record_id_start
+              || record_id > record_id_last))
+        continue;
+
+      if (_sel_entries_append (ctx, sel_entry, callback, callback_data) < 0)
+        goto cleanup;
     }
 
   rv = 0;
  cleanup:
+  ctx->callback_sel_entry = NULL;
+  free (records);
   return (rv);
 }
 
@@ -915,6 +1025,7 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
   uint16_t next_record_id = 0;
   int parsed_atleast_one_entry = 0;
   fiid_obj_t obj_cmd_rs = NULL;
+  struct ipmi_sel_pipeline pipeline;
   uint64_t val;
   int len;
   int rv = -1;
@@ -939,6 +1050,25 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
 
   _sel_entries_clear (ctx);
 
+  if (sel_pipeline_init (ctx, &pipeline) < 0)
+    goto cleanup;
+
+  /* bring the mirror up to date, then parse entirely from it */
+  if (ctx->mirror_filename)
+    {
+      if (sel_mirror_sync (ctx) < 0)
+        goto cleanup;
+
+      if (_sel_parse_mirror (ctx,
+                             record_id_start,
+                             record_id_last,
+                             callback,
+                             callback_data) < 0)
+        goto cleanup;
+
+      goto out;
+    }
+
   if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
@@ -953,11 +1083,11 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
       struct ipmi_sel_entry tmp_sel_entry;
       uint16_t tmp_record_id_last = 0;
 
-      if (_get_sel_entry (ctx,
-                          obj_cmd_rs,
-                          &reservation_id,
-                          &reservation_id_initialized,
-                          IPMI_SEL_GET_RECORD_ID_LAST_ENTRY) < 0)
+      if (sel_get_entry (ctx,
+                         obj_cmd_rs,
+                         &reservation_id,
+                         &reservation_id_initialized,
+                         IPMI_SEL_GET_RECORD_ID_LAST_ENTRY) < 0)
         {
           if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
               && ipmi_check_completion_code (obj_cmd_rs,
@@ -993,11 +1123,11 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
   /* special case, need only get the last record */
   if (record_id_start == IPMI_SEL_GET_RECORD_ID_LAST_ENTRY)
     {
-      if (_get_sel_entry (ctx,
-                          obj_cmd_rs,
-                          &reservation_id,
-                          &reservation_id_initialized,
-                          record_id_start) < 0)
+      if (sel_get_entry (ctx,
+                         obj_cmd_rs,
+                         &reservation_id,
+                         &reservation_id_initialized,
+                         record_id_start) < 0)
         {
           if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
               && ipmi_check_completion_code (obj_cmd_rs,
@@ -1009,11 +1139,8 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
           goto cleanup;
         }
 
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
-        }
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
 
       if ((len = fiid_obj_get_data (obj_cmd_rs,
                                     "record_data",
@@ -1026,25 +1153,8 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
 
       sel_entry->sel_event_record_len = len;
 
-      _sel_entry_dump (ctx, sel_entry);
-
-      /* achu: should come before list_append to avoid having a freed entry on the list */
-      if (callback)
-        {
-          ctx->callback_sel_entry = sel_entry;
-          if ((*callback)(ctx, callback_data) < 0)
-            {
-              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_CALLBACK_ERROR);
-              goto cleanup;
-            }
-        }
-
-      if (!list_append (ctx->sel_entries, sel_entry))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      sel_entry = NULL;
+      if (_sel_entries_append (ctx, sel_entry, callback, callback_data) < 0)
+        goto cleanup;
 
       goto out;
     }
@@ -1053,11 +1163,13 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
        record_id <= record_id_last && record_id != IPMI_SEL_GET_RECORD_ID_LAST_ENTRY;
        record_id = next_record_id)
     {
-      if (_get_sel_entry (ctx,
-                          obj_cmd_rs,
-                          &reservation_id,
-                          &reservation_id_initialized,
-                          record_id) < 0)
+      if (sel_get_entry_pipelined (ctx,
+                                   &pipeline,
+                                   obj_cmd_rs,
+                                   &reservation_id,
+                                   &reservation_id_initialized,
+                                   record_id,
+                                   record_id_last) < 0)
         {
           if (record_id == IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
               && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
@@ -1091,11 +1203,8 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
         }
       next_record_id = val;
 
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
-        }
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
 
       if ((len = fiid_obj_get_data (obj_cmd_rs,
                                     "record_data",
@@ -1108,45 +1217,21 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
 
       sel_entry->sel_event_record_len = len;
 
-      _sel_entry_dump (ctx, sel_entry);
-
-      /* achu: should come before list_append to avoid having a freed entry on the list */
-      if (callback)
-        {
-          ctx->callback_sel_entry = sel_entry;
-          if ((*callback)(ctx, callback_data) < 0)
-            {
-              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_CALLBACK_ERROR);
-              goto cleanup;
-            }
-        }
-
-      if (!list_append (ctx->sel_entries, sel_entry))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      sel_entry = NULL;
+      if (_sel_entries_append (ctx, sel_entry, callback, callback_data) < 0)
+        goto cleanup;
     }
 
  out:
 
-  if ((rv = list_count (ctx->sel_entries)) > 0)
-    {
-      if (!(ctx->sel_entries_itr = list_iterator_create (ctx->sel_entries)))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
-    }
+  rv = ctx->sel_entries_count;
+  ctx->current_sel_entry = 0;
   ctx->sel_entries_loaded = 1;
 
   ctx->errnum = IPMI_SEL_ERR_SUCCESS;
  cleanup:
   ctx->callback_sel_entry = NULL;
-  free (sel_entry);
   fiid_obj_destroy (obj_cmd_rs);
+  sel_pipeline_cleanup (&pipeline);
   return (rv);
 }
 
@@ -1193,11 +1278,11 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
 
   for (i = 0; i < record_ids_len; i++)
     {
-      if (_get_sel_entry (ctx,
-                          obj_cmd_rs,
-                          &reservation_id,
-                          &reservation_id_initialized,
-                          record_ids[i]) < 0)
+      if (sel_get_entry (ctx,
+                         obj_cmd_rs,
+                         &reservation_id,
+                         &reservation_id_initialized,
+                         record_ids[i]) < 0)
         {
           if (ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
               && ipmi_check_completion_code (obj_cmd_rs,
@@ -1210,11 +1295,8 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
           goto cleanup;
         }
 
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
-        }
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
 
       if ((len = fiid_obj_get_data (obj_cmd_rs,
                                     "record_data",
@@ -1227,42 +1309,17 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
 
       sel_entry->sel_event_record_len = len;
 
-      _sel_entry_dump (ctx, sel_entry);
-
-      /* achu: should come before list_append to avoid having a freed entry on the list */
-      if (callback)
-        {
-          ctx->callback_sel_entry = sel_entry;
-          if ((*callback)(ctx, callback_data) < 0)
-            {
-              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_CALLBACK_ERROR);
-              goto cleanup;
-            }
-        }
-
-      if (!list_append (ctx->sel_entries, sel_entry))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      sel_entry = NULL;
+      if (_sel_entries_append (ctx, sel_entry, callback, callback_data) < 0)
+        goto cleanup;
     }
 
-  if ((rv = list_count (ctx->sel_entries)) > 0)
-    {
-      if (!(ctx->sel_entries_itr = list_iterator_create (ctx->sel_entries)))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
-    }
+  rv = ctx->sel_entries_count;
+  ctx->current_sel_entry = 0;
   ctx->sel_entries_loaded = 1;
 
   ctx->errnum = IPMI_SEL_ERR_SUCCESS;
  cleanup:
   ctx->callback_sel_entry = NULL;
-  free (sel_entry);
   fiid_obj_destroy (obj_cmd_rs);
   return (rv);
 }
@@ -1282,14 +1339,13 @@ ipmi_sel_parse_first (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  list_iterator_reset (ctx->sel_entries_itr);
-  ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
+  ctx->current_sel_entry = 0;
   return (0);
 }
 
@@ -1308,14 +1364,15 @@ ipmi_sel_parse_next (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
-  return ((ctx->current_sel_entry) ? 1 : 0);
+  if (ctx->current_sel_entry < ctx->sel_entries_count)
+    ctx->current_sel_entry++;
+  return ((ctx->current_sel_entry < ctx->sel_entries_count) ? 1 : 0);
 }
 
 int
@@ -1333,13 +1390,13 @@ ipmi_sel_parse_sel_entry_count (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  return (list_count (ctx->sel_entries));
+  return (ctx->sel_entries_count);
 }
 
 static int
@@ -1348,7 +1405,8 @@ _ipmi_sel_parse_find_record_id (ipmi_sel_ctx_t ctx,
                                 unsigned int exact_match_flag)
 {
   struct ipmi_sel_entry *sel_entry;
-  int rv = -1;
+  unsigned int low, high, mid;
+  unsigned int i;
 
   if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
     {
@@ -1362,45 +1420,62 @@ _ipmi_sel_parse_find_record_id (ipmi_sel_ctx_t ctx,
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  list_iterator_reset (ctx->sel_entries_itr);
-
-  while ((sel_entry = list_next (ctx->sel_entries_itr)))
+  if (ctx->sel_entries_sorted)
     {
-      uint16_t current_record_id;
-
-      if (sel_get_record_header_info (ctx,
-                                      sel_entry,
-                                      &current_record_id,
-                                      NULL) < 0)
+      /* find first entry with record id >= record_id */
+      low = 0;
+      high = ctx->sel_entries_count;
+      while (low < high)
         {
-          /* if it was an invalid SEL entry, continue on */
-          if (ctx->errnum == IPMI_SEL_ERR_INVALID_SEL_ENTRY)
-            continue;
-          goto cleanup;
+          mid = low + (high - low) / 2;
+          if (ctx->sel_entries[mid].record_id < record_id)
+            low = mid + 1;
+          else
+            high = mid;
         }
 
-      if ((exact_match_flag
-           && current_record_id == record_id)
-          || (!exact_match_flag
-              && current_record_id >= record_id))
+      if (low < ctx->sel_entries_count
+          && (!exact_match_flag
+              || ctx->sel_entries[low].record_id == record_id))
         {
-          rv = 0;
+          ctx->current_sel_entry = low;
           ctx->errnum = IPMI_SEL_ERR_SUCCESS;
-          ctx->current_sel_entry = sel_entry;
-          goto cleanup;
+          return (0);
+        }
+    }
+  else
+    {
+      /* record ids wrapped or an entry is invalid, fall back to a
+       * linear search
+       */
+      for (i = 0; i < ctx->sel_entries_count; i++)
+        {
+          sel_entry = &ctx->sel_entries[i];
+
+          /* if it was an invalid SEL entry, continue on */
+          if (!sel_entry->record_id_valid)
+            continue;
+
+          if ((exact_match_flag
+               && sel_entry->record_id == record_id)
+              || (!exact_match_flag
+                  && sel_entry->record_id >= record_id))
+            {
+              ctx->current_sel_entry = i;
+              ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+              return (0);
+            }
         }
     }
 
   SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NOT_FOUND);
-  list_iterator_reset (ctx->sel_entries_itr);
- cleanup:
-  return (rv);
+  return (-1);
 }
 
 int
@@ -1437,19 +1512,19 @@ _get_parse_sel_entry_common (ipmi_sel_ctx_t ctx,
           return (-1);
         }
 
-      if (!ctx->sel_entries_itr)
+      if (!ctx->sel_entries_count)
         {
           SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
           return (-1);
         }
 
-      *sel_entry = ctx->current_sel_entry;
-    }
+      if (ctx->current_sel_entry >= ctx->sel_entries_count)
+        {
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_SEL_ENTRIES_LIST_END);
+          return (-1);
+        }
 
-  if (!(*sel_entry))
-    {
-      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_SEL_ENTRIES_LIST_END);
-      return (-1);
+      *sel_entry = &ctx->sel_entries[ctx->current_sel_entry];
     }
 
   return (0);
@@ -37,6 +37,10 @@
 
 #define IPMI_SENSOR_READ_CTX_MAGIC 0xABCD1246
 
+#define IPMI_SENSOR_READ_SENSOR_NUMBERS 256
+
+#define IPMI_SENSOR_READ_RS_BUFLEN      64
+
 #define IPMI_SENSOR_READ_FLAGS_MASK                  \
   (IPMI_SENSOR_READ_FLAGS_BRIDGE_SENSORS             \
    | IPMI_SENSOR_READ_FLAGS_DISCRETE_READING         \
@@ -50,6 +54,13 @@ struct ipmi_sensor_read_ctx {
 
   ipmi_ctx_t ipmi_ctx;
   ipmi_sdr_ctx_t sdr_ctx;
+
+  /* sensor numbers queued by ipmi_sensor_read_sweep_add() */
+  uint8_t sweep_queue[IPMI_SENSOR_READ_SENSOR_NUMBERS];
+  unsigned int sweep_queue_count;
+  uint8_t sweep_queued[IPMI_SENSOR_READ_SENSOR_NUMBERS];
+  /* unused responses of ipmi_sensor_read_sweep(), by sensor number */
+  fiid_obj_t sweep_obj_cmd_rs[IPMI_SENSOR_READ_SENSOR_NUMBERS];
 };
 
 #endif /* IPMI_SENSOR_READ_DEFS_H */
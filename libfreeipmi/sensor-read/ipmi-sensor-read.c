@@ -41,6 +41,7 @@
 #include "freeipmi/spec/ipmi-channel-spec.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
 #include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/spec/ipmi-slave-address-spec.h"
 #include "freeipmi/spec/ipmi-sensor-units-spec.h"
 #include "freeipmi/util/ipmi-sensor-and-event-code-tables-util.h"
@@ -51,6 +52,7 @@
 #include "ipmi-sensor-read-trace.h"
 #include "ipmi-sensor-read-util.h"
 
+#include "api/ipmi-api-util.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -107,6 +109,7 @@ ipmi_sensor_read_ctx_create (ipmi_ctx_t ipmi_ctx)
       return (NULL);
     }
 
+  memset (ctx, '\0', sizeof (struct ipmi_sensor_read_ctx));
   ctx->magic = IPMI_SENSOR_READ_CTX_MAGIC;
   ctx->flags = IPMI_SENSOR_READ_FLAGS_DEFAULT;
   ctx->ipmi_ctx = ipmi_ctx;
@@ -129,12 +132,30 @@ ipmi_sensor_read_ctx_create (ipmi_ctx_t ipmi_ctx)
   return (NULL);
 }
 
+static void
+_sweep_clear (ipmi_sensor_read_ctx_t ctx)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+
+  for (i = 0; i < IPMI_SENSOR_READ_SENSOR_NUMBERS; i++)
+    {
+      fiid_obj_destroy (ctx->sweep_obj_cmd_rs[i]);
+      ctx->sweep_obj_cmd_rs[i] = NULL;
+      ctx->sweep_queued[i] = 0;
+    }
+  ctx->sweep_queue_count = 0;
+}
+
 void
 ipmi_sensor_read_ctx_destroy (ipmi_sensor_read_ctx_t ctx)
 {
   if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
     return;
 
+  _sweep_clear (ctx);
   ctx->magic = ~IPMI_SENSOR_READ_CTX_MAGIC;
   ipmi_sdr_ctx_destroy (ctx->sdr_ctx);
   free (ctx);
@@ -305,17 +326,92 @@ _sensor_reading_corner_case_checks (ipmi_sensor_read_ctx_t ctx,
   return (0);
 }
 
+/* Use the response from ipmi_sensor_read_sweep() if there is one.
+ * Returns 1 if used, 0 if the reading must be requested, -1 on
+ * error.
+ */
+static int
+_get_sensor_reading_swept (ipmi_sensor_read_ctx_t ctx,
+                           uint8_t sensor_number,
+                           fiid_obj_t obj_cmd_rs)
+{
+  uint8_t buf[IPMI_SENSOR_READ_RS_BUFLEN];
+  fiid_obj_t obj_swept;
+  int len, ret, rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (obj_cmd_rs);
+
+  if (!(obj_swept = ctx->sweep_obj_cmd_rs[sensor_number]))
+    return (0);
+
+  /* each response is used only once */
+  ctx->sweep_obj_cmd_rs[sensor_number] = NULL;
+
+  if ((len = fiid_obj_get_all (obj_swept,
+                               buf,
+                               IPMI_SENSOR_READ_RS_BUFLEN)) < 0)
+    {
+      SENSOR_READ_FIID_OBJECT_ERROR_TO_SENSOR_READ_ERRNUM (ctx, obj_swept);
+      goto cleanup;
+    }
+
+  if (fiid_obj_set_all (obj_cmd_rs, buf, len) < 0)
+    {
+      SENSOR_READ_FIID_OBJECT_ERROR_TO_SENSOR_READ_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+
+  if ((ret = ipmi_check_completion_code_success (obj_cmd_rs)) == 1)
+    {
+      rv = 1;
+      goto cleanup;
+    }
+
+  if (!ret)
+    {
+      if (_sensor_reading_corner_case_checks (ctx, obj_cmd_rs) < 0)
+        goto cleanup;
+    }
+
+  /* Other errors are requested again, so they are reported exactly
+   * as without the sweep.
+   */
+  if (fiid_obj_clear (obj_cmd_rs) < 0)
+    {
+      SENSOR_READ_FIID_OBJECT_ERROR_TO_SENSOR_READ_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  fiid_obj_destroy (obj_swept);
+  return (rv);
+}
+
 int
 _get_sensor_reading (ipmi_sensor_read_ctx_t ctx,
                      uint8_t sensor_number,
                      fiid_obj_t obj_cmd_rs)
 {
-  int rv = -1;
+  int ret, rv = -1;
 
   assert (ctx);
   assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
   assert (obj_cmd_rs);
 
+  if ((ret = _get_sensor_reading_swept (ctx,
+                                        sensor_number,
+                                        obj_cmd_rs)) < 0)
+    goto cleanup;
+
+  if (ret)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
   if (ipmi_cmd_get_sensor_reading (ctx->ipmi_ctx,
                                    sensor_number,
                                    obj_cmd_rs) < 0)
@@ -387,23 +483,19 @@ _get_sensor_reading_ipmb (ipmi_sensor_read_ctx_t ctx,
   return (rv);
 }
 
-int
-ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
-                  const void *sdr_record,
-                  unsigned int sdr_record_len,
-                  uint8_t shared_sensor_number_offset,
-                  uint8_t *sensor_reading_raw,
-                  double **sensor_reading,
-                  uint16_t *sensor_event_bitmask)
+/* Parse the SDR record fields needed to read the sensor */
+static int
+_sensor_read_parse (ipmi_sensor_read_ctx_t ctx,
+                    const void *sdr_record,
+                    unsigned int sdr_record_len,
+                    uint8_t shared_sensor_number_offset,
+                    uint8_t *record_type_ptr,
+                    uint8_t *sensor_number_ptr,
+                    uint8_t *event_reading_type_code_ptr,
+                    uint8_t *slave_address_ptr,
+                    uint8_t *sensor_owner_lun_ptr,
+                    uint8_t *channel_number_ptr)
 {
-  double *tmp_sensor_reading = NULL;
-  uint64_t val;
-  int rv = -1;
-  fiid_obj_t obj_cmd_rs = NULL;
-  uint8_t sensor_event_bitmask1 = 0;
-  uint8_t sensor_event_bitmask2 = 0;
-  int sensor_event_bitmask1_flag = 0;
-  int sensor_event_bitmask2_flag = 0;
   uint16_t record_id = 0;
   uint8_t record_type = 0;
   uint8_t sensor_number = 0;
@@ -413,28 +505,18 @@ ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
   uint8_t sensor_owner_lun = 0;
   uint8_t channel_number = 0;
   uint8_t slave_address = 0;
-  uint8_t reading_state, sensor_scanning;
-  uint8_t local_sensor_reading_raw;
-  unsigned int ctx_flags_orig;
-  int event_reading_type_code_class = 0;
-
-  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
-    {
-      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
-      return (-1);
-    }
-
-  if (!sdr_record
-      || !sdr_record_len
-      || !sensor_reading
-      || !sensor_event_bitmask)
-    {
-      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_PARAMETERS);
-      return (-1);
-    }
+  int rv = -1;
 
-  *sensor_reading = NULL;
-  *sensor_event_bitmask = 0;
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (sdr_record);
+  assert (sdr_record_len);
+  assert (record_type_ptr);
+  assert (sensor_number_ptr);
+  assert (event_reading_type_code_ptr);
+  assert (slave_address_ptr);
+  assert (sensor_owner_lun_ptr);
+  assert (channel_number_ptr);
 
   if (ipmi_sdr_parse_record_id_and_type (ctx->sdr_ctx,
                                          sdr_record,
@@ -536,6 +618,75 @@ ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
 
   slave_address = (sensor_owner_id << 1) | sensor_owner_id_type;
 
+  *record_type_ptr = record_type;
+  *sensor_number_ptr = sensor_number;
+  *event_reading_type_code_ptr = event_reading_type_code;
+  *slave_address_ptr = slave_address;
+  *sensor_owner_lun_ptr = sensor_owner_lun;
+  *channel_number_ptr = channel_number;
+  rv = 0;
+ cleanup:
+  return (rv);
+}
+
+int
+ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
+                  const void *sdr_record,
+                  unsigned int sdr_record_len,
+                  uint8_t shared_sensor_number_offset,
+                  uint8_t *sensor_reading_raw,
+                  double **sensor_reading,
+                  uint16_t *sensor_event_bitmask)
+{
+  double *tmp_sensor_reading = NULL;
+  uint64_t val;
+  int rv = -1;
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint8_t sensor_event_bitmask1 = 0;
+  uint8_t sensor_event_bitmask2 = 0;
+  int sensor_event_bitmask1_flag = 0;
+  int sensor_event_bitmask2_flag = 0;
+  uint8_t record_type = 0;
+  uint8_t sensor_number = 0;
+  uint8_t event_reading_type_code = 0;
+  uint8_t sensor_owner_lun = 0;
+  uint8_t channel_number = 0;
+  uint8_t slave_address = 0;
+  uint8_t reading_state, sensor_scanning;
+  uint8_t local_sensor_reading_raw;
+  unsigned int ctx_flags_orig;
+  int event_reading_type_code_class = 0;
+
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!sdr_record
+      || !sdr_record_len
+      || !sensor_reading
+      || !sensor_event_bitmask)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  *sensor_reading = NULL;
+  *sensor_event_bitmask = 0;
+
+  if (_sensor_read_parse (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          shared_sensor_number_offset,
+                          &record_type,
+                          &sensor_number,
+                          &event_reading_type_code,
+                          &slave_address,
+                          &sensor_owner_lun,
+                          &channel_number) < 0)
+    goto cleanup;
+
   if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)))
     {
       SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
@@ -909,3 +1060,161 @@ ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
     free (tmp_sensor_reading);
   return (rv);
 }
+
+int
+ipmi_sensor_read_sweep_add (ipmi_sensor_read_ctx_t ctx,
+                            const void *sdr_record,
+                            unsigned int sdr_record_len,
+                            uint8_t shared_sensor_number_offset)
+{
+  uint8_t record_type = 0;
+  uint8_t sensor_number = 0;
+  uint8_t event_reading_type_code = 0;
+  uint8_t sensor_owner_lun = 0;
+  uint8_t channel_number = 0;
+  uint8_t slave_address = 0;
+
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!sdr_record
+      || !sdr_record_len)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (_sensor_read_parse (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          shared_sensor_number_offset,
+                          &record_type,
+                          &sensor_number,
+                          &event_reading_type_code,
+                          &slave_address,
+                          &sensor_owner_lun,
+                          &channel_number) < 0)
+    {
+      /* no reading to sweep, ipmi_sensor_read() reports the error */
+      if (ctx->errnum == IPMI_SENSOR_READ_ERR_INVALID_SDR_RECORD_TYPE
+          || ctx->errnum == IPMI_SENSOR_READ_ERR_SENSOR_IS_SYSTEM_SOFTWARE)
+        goto out;
+      return (-1);
+    }
+
+  /* Sensors on other controllers are bridged, one request at a time,
+   * by ipmi_sensor_read().  See ipmi_sensor_read() for the
+   * ASSUME_BMC_OWNER workaround.
+   */
+  if (!(ctx->flags & IPMI_SENSOR_READ_FLAGS_ASSUME_BMC_OWNER)
+      && (slave_address != IPMI_SLAVE_ADDRESS_BMC
+          || sensor_owner_lun != IPMI_BMC_IPMB_LUN_BMC))
+    goto out;
+
+  if (!ctx->sweep_queued[sensor_number])
+    {
+      ctx->sweep_queue[ctx->sweep_queue_count++] = sensor_number;
+      ctx->sweep_queued[sensor_number] = 1;
+    }
+
+ out:
+  ctx->errnum = IPMI_SENSOR_READ_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_sensor_read_sweep (ipmi_sensor_read_ctx_t ctx)
+{
+  fiid_obj_t obj_cmd_rq[IPMI_SENSOR_READ_SENSOR_NUMBERS];
+  fiid_obj_t obj_cmd_rs[IPMI_SENSOR_READ_SENSOR_NUMBERS];
+  unsigned int count;
+  unsigned int i;
+  int rv = -1;
+
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  count = ctx->sweep_queue_count;
+  memset (obj_cmd_rq, '\0', sizeof (fiid_obj_t) * count);
+  memset (obj_cmd_rs, '\0', sizeof (fiid_obj_t) * count);
+
+  /* requests issued one at a time gain nothing over ipmi_sensor_read() */
+  if (!count
+      || !api_ipmi_cmd_batch_pipelined (ctx->ipmi_ctx))
+    goto out;
+
+  for (i = 0; i < count; i++)
+    {
+      if (!(obj_cmd_rq[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      if (!(obj_cmd_rs[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      if (fill_cmd_get_sensor_reading (ctx->sweep_queue[i], obj_cmd_rq[i]) < 0)
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+
+  if (ipmi_cmd_batch (ctx->ipmi_ctx,
+                      IPMI_BMC_IPMB_LUN_BMC,
+                      IPMI_NET_FN_SENSOR_EVENT_RQ,
+                      obj_cmd_rq,
+                      obj_cmd_rs,
+                      count,
+                      0) < 0)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_IPMI_ERROR);
+      goto cleanup;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      uint8_t sensor_number = ctx->sweep_queue[i];
+
+      fiid_obj_destroy (ctx->sweep_obj_cmd_rs[sensor_number]);
+      ctx->sweep_obj_cmd_rs[sensor_number] = obj_cmd_rs[i];
+      obj_cmd_rs[i] = NULL;
+    }
+
+ out:
+  ctx->errnum = IPMI_SENSOR_READ_ERR_SUCCESS;
+  rv = 0;
+ cleanup:
+  for (i = 0; i < count; i++)
+    {
+      fiid_obj_destroy (obj_cmd_rq[i]);
+      fiid_obj_destroy (obj_cmd_rs[i]);
+      ctx->sweep_queued[ctx->sweep_queue[i]] = 0;
+    }
+  ctx->sweep_queue_count = 0;
+  return (rv);
+}
+
+int
+ipmi_sensor_read_sweep_clear (ipmi_sensor_read_ctx_t ctx)
+{
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  _sweep_clear (ctx);
+  ctx->errnum = IPMI_SENSOR_READ_ERR_SUCCESS;
+  return (0);
+}
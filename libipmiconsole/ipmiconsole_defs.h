@@ -293,6 +293,9 @@ struct ipmiconsole_ctx_connection {
   /* Pipe for non-fd communication: from API to engine */
   int asynccomm[2];
 
+  /* Engine load: fd events handled since the last rebalance */
+  unsigned int engine_load;
+
   /* Fiid Objects */
 
   fiid_obj_t obj_rmcp_hdr_rq;
@@ -61,6 +61,7 @@
 #include "freeipmi-portability.h"
 #include "list.h"
 #include "secure.h"
+#include "timeval.h"
 
 /*
  * Locking notes:
@@ -68,6 +69,9 @@
  * when is_count mutex is locked - thread_count_mutex can be locked, not vice versa
  * when is_count mutex is locked - teardown_mutex can be locked, not vice versa
  * when thread_count mutex is locked - ctxs_mutex can be locked, not vice versa
+ * when ctxs_mutex is locked - teardown_mutex can be locked, not vice versa
+ * when ctxs_mutex is locked - ctxs_load_mutex can be locked, not vice versa
+ * when ctxs_mutex is locked - another ctxs_mutex can only be trylocked
  */
 static int console_engine_is_setup = 0;
 static pthread_mutex_t console_engine_is_setup_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -83,6 +87,21 @@ static List console_engine_ctxs[IPMICONSOLE_THREAD_COUNT_MAX];
 static unsigned int console_engine_ctxs_count[IPMICONSOLE_THREAD_COUNT_MAX];
 static pthread_mutex_t console_engine_ctxs_mutex[IPMICONSOLE_THREAD_COUNT_MAX];
 
+/* Contexts are submitted to the engine thread with the fewest
+ * contexts, but SOL traffic varies greatly between consoles (e.g. a
+ * kernel panic dumping at 115200 baud vs. an idle login prompt).  So
+ * every IPMICONSOLE_REBALANCE_INTERVAL each engine thread publishes
+ * its load, the fd events per second handled for its contexts, and
+ * hands one context to the least loaded thread if that evens things
+ * out.
+ *
+ * Contexts are only handed off by the thread owning them, as a
+ * thread accesses its contexts without holding its ctxs_mutex while
+ * polling.
+ */
+static unsigned int console_engine_ctxs_load[IPMICONSOLE_THREAD_COUNT_MAX];
+static pthread_mutex_t console_engine_ctxs_load_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* In the core engine code, the poll() may sit for a large number of
  * seconds, waiting for the next event to happen.  In the meantime, a
  * user may have submitted a new context or wants to close the engine.
@@ -124,6 +143,11 @@ struct _ipmiconsole_poll_data {
 
 #define IPMICONSOLE_SPIN_WAIT_TIME 250000
 
+#define IPMICONSOLE_REBALANCE_INTERVAL 5000
+
+/* fd events per second */
+#define IPMICONSOLE_REBALANCE_LOAD_MIN 50
+
 #define IPMICONSOLE_PIPE_BUFLEN 1024
 
 static int
@@ -217,6 +241,7 @@ ipmiconsole_engine_setup (unsigned int thread_count)
   memset (console_engine_ctxs, '\0', IPMICONSOLE_THREAD_COUNT_MAX * sizeof (List));
   memset (console_engine_ctxs_count, '\0', IPMICONSOLE_THREAD_COUNT_MAX * sizeof (unsigned int));
   memset (console_engine_ctxs_mutex, '\0', IPMICONSOLE_THREAD_COUNT_MAX * sizeof (pthread_mutex_t));
+  memset (console_engine_ctxs_load, '\0', IPMICONSOLE_THREAD_COUNT_MAX * sizeof (unsigned int));
   for (i = 0; i < IPMICONSOLE_THREAD_COUNT_MAX; i++)
     {
       console_engine_ctxs_notifier[i][0] = -1;
@@ -932,6 +957,263 @@ _ipmiconsole_poll (struct pollfd *ufds, unsigned int nfds, int timeout)
   return n;
 }
 
+struct _ipmiconsole_rebalance_data {
+  unsigned int elapsed;
+  unsigned int load;
+  unsigned int load_max;
+  ipmiconsole_ctx_t c;
+  unsigned int c_load;
+};
+
+static unsigned int
+_ctx_load (ipmiconsole_ctx_t c, unsigned int elapsed)
+{
+  assert (c);
+  assert (c->magic == IPMICONSOLE_CTX_MAGIC);
+  assert (elapsed);
+
+  return ((unsigned int)(((uint64_t)c->connection.engine_load * 1000) / elapsed));
+}
+
+static int
+_rebalance_load (void *x, void *arg)
+{
+  ipmiconsole_ctx_t c;
+  struct _ipmiconsole_rebalance_data *rebalance_data;
+
+  assert (x);
+  assert (arg);
+
+  c = (ipmiconsole_ctx_t)x;
+  rebalance_data = (struct _ipmiconsole_rebalance_data *)arg;
+
+  rebalance_data->load += _ctx_load (c, rebalance_data->elapsed);
+  return (0);
+}
+
+/* Select the busiest context not exceeding load_max, or the least
+ * busy context if load_max is 0.  Load measurements are restarted.
+ */
+static int
+_rebalance_select (void *x, void *arg)
+{
+  ipmiconsole_ctx_t c;
+  struct _ipmiconsole_rebalance_data *rebalance_data;
+  unsigned int load;
+
+  assert (x);
+  assert (arg);
+
+  c = (ipmiconsole_ctx_t)x;
+  rebalance_data = (struct _ipmiconsole_rebalance_data *)arg;
+
+  load = _ctx_load (c, rebalance_data->elapsed);
+  c->connection.engine_load = 0;
+
+  if (c->session.close_session_flag)
+    return (0);
+
+  if (rebalance_data->load_max)
+    {
+      if (load
+          && load <= rebalance_data->load_max
+          && (!rebalance_data->c || load > rebalance_data->c_load))
+        {
+          rebalance_data->c = c;
+          rebalance_data->c_load = load;
+        }
+    }
+  else
+    {
+      if (!rebalance_data->c || load < rebalance_data->c_load)
+        {
+          rebalance_data->c = c;
+          rebalance_data->c_load = load;
+        }
+    }
+
+  return (0);
+}
+
+static int
+_rebalance_find (void *x, void *key)
+{
+  return (x == key);
+}
+
+/* Must be called with console_engine_ctxs_mutex[index] locked.
+ *
+ * - The target thread's ctxs_mutex is only trylocked, two threads
+ *   handing off to each other would deadlock otherwise.  If it is
+ *   busy the hand-off waits for the next interval.
+ * - The context counts adjusted here only hold until each thread
+ *   recounts its contexts, see _ipmiconsole_engine().
+ *
+ * Returns 1 if a context was handed to another thread, 0 if not.
+ */
+static int
+_rebalance (unsigned int index, struct timeval *last_rebalance)
+{
+  struct _ipmiconsole_rebalance_data rebalance_data;
+  ListIterator itr = NULL;
+  struct timeval now, delta;
+  unsigned int elapsed;
+  unsigned int target = index;
+  unsigned int target_load = UINT_MAX;
+  unsigned int i;
+  int perr, rv = 0;
+
+  assert (index < IPMICONSOLE_THREAD_COUNT_MAX);
+  assert (last_rebalance);
+
+  if (gettimeofday (&now, NULL) < 0)
+    {
+      IPMICONSOLE_DEBUG (("gettimeofday: %s", strerror (errno)));
+      return (0);
+    }
+
+  timeval_sub (&now, last_rebalance, &delta);
+  timeval_millisecond_calc (&delta, &elapsed);
+  if (elapsed < IPMICONSOLE_REBALANCE_INTERVAL)
+    return (0);
+
+  *last_rebalance = now;
+
+  memset (&rebalance_data, '\0', sizeof (struct _ipmiconsole_rebalance_data));
+  rebalance_data.elapsed = elapsed;
+
+  if (list_for_each (console_engine_ctxs[index], _rebalance_load, &rebalance_data) < 0)
+    {
+      IPMICONSOLE_DEBUG (("list_for_each: %s", strerror (errno)));
+      return (0);
+    }
+
+  if ((perr = pthread_mutex_lock (&console_engine_ctxs_load_mutex)))
+    {
+      IPMICONSOLE_DEBUG (("pthread_mutex_lock: %s", strerror (perr)));
+      return (0);
+    }
+
+  console_engine_ctxs_load[index] = rebalance_data.load;
+
+  for (i = 0; i < console_engine_ctxs_notifier_num; i++)
+    {
+      if (i != index && console_engine_ctxs_load[i] < target_load)
+        {
+          target = i;
+          target_load = console_engine_ctxs_load[i];
+        }
+    }
+
+  if ((perr = pthread_mutex_unlock (&console_engine_ctxs_load_mutex)))
+    {
+      IPMICONSOLE_DEBUG (("pthread_mutex_unlock: %s", strerror (perr)));
+      return (0);
+    }
+
+  /* Hand off a busy context if it narrows the difference in load,
+   * otherwise an idle context if this thread has noticeably more
+   * contexts, e.g. after many sessions on other threads ended.
+   */
+  if (rebalance_data.load > target_load + IPMICONSOLE_REBALANCE_LOAD_MIN)
+    rebalance_data.load_max = (rebalance_data.load - target_load) / 2;
+
+  if (list_for_each (console_engine_ctxs[index], _rebalance_select, &rebalance_data) < 0)
+    {
+      IPMICONSOLE_DEBUG (("list_for_each: %s", strerror (errno)));
+      return (0);
+    }
+
+  if (target == index || !rebalance_data.c)
+    return (0);
+
+  /* Never block on another thread's ctxs_mutex, try again later */
+  if ((perr = pthread_mutex_trylock (&console_engine_ctxs_mutex[target])))
+    {
+      if (perr != EBUSY)
+        IPMICONSOLE_DEBUG (("pthread_mutex_trylock: %s", strerror (perr)));
+      return (0);
+    }
+
+  if (!rebalance_data.load_max
+      && console_engine_ctxs_count[index] <= console_engine_ctxs_count[target] + 1)
+    goto unlock_target_ctxs_mutex;
+
+  /* Once the engine is being torn down, the target thread may no
+   * longer close contexts handed to it.
+   */
+  if ((perr = pthread_mutex_lock (&console_engine_teardown_mutex)))
+    {
+      IPMICONSOLE_DEBUG (("pthread_mutex_lock: %s", strerror (perr)));
+      goto unlock_target_ctxs_mutex;
+    }
+
+  if (console_engine_teardown)
+    goto unlock_teardown_mutex;
+
+  if (!(itr = list_iterator_create (console_engine_ctxs[index])))
+    {
+      IPMICONSOLE_DEBUG (("list_iterator_create: %s", strerror (errno)));
+      goto unlock_teardown_mutex;
+    }
+
+  if (!list_find (itr, _rebalance_find, rebalance_data.c))
+    {
+      IPMICONSOLE_DEBUG (("list_find: %s", strerror (errno)));
+      goto unlock_teardown_mutex;
+    }
+
+  /* list_remove() does not cleanup the context, unlike list_delete() */
+  if (!list_remove (itr))
+    {
+      IPMICONSOLE_DEBUG (("list_remove: %s", strerror (errno)));
+      goto unlock_teardown_mutex;
+    }
+
+  if (!list_append (console_engine_ctxs[target], rebalance_data.c))
+    {
+      /* Put it back, cannot lose the context */
+      IPMICONSOLE_DEBUG (("list_append: %s", strerror (errno)));
+      if (!list_append (console_engine_ctxs[index], rebalance_data.c))
+        IPMICONSOLE_DEBUG (("list_append: %s", strerror (errno)));
+      goto unlock_teardown_mutex;
+    }
+
+  IPMICONSOLE_CTX_DEBUG (rebalance_data.c, ("moved from engine thread %u to %u; load=%u",
+                                            index,
+                                            target,
+                                            rebalance_data.c_load));
+
+  console_engine_ctxs_count[index]--;
+  console_engine_ctxs_count[target]++;
+
+  /* Adjust until the target thread measures itself */
+  if ((perr = pthread_mutex_lock (&console_engine_ctxs_load_mutex)))
+    IPMICONSOLE_DEBUG (("pthread_mutex_lock: %s", strerror (perr)));
+  else
+    {
+      console_engine_ctxs_load[index] -= rebalance_data.c_load;
+      console_engine_ctxs_load[target] += rebalance_data.c_load;
+      if ((perr = pthread_mutex_unlock (&console_engine_ctxs_load_mutex)))
+        IPMICONSOLE_DEBUG (("pthread_mutex_unlock: %s", strerror (perr)));
+    }
+
+  /* "Interrupt" the target thread to get moving along w/ the context */
+  if (write (console_engine_ctxs_notifier[target][1], "1", 1) < 0)
+    IPMICONSOLE_DEBUG (("write: %s", strerror (errno)));
+
+  rv = 1;
+ unlock_teardown_mutex:
+  if (itr)
+    list_iterator_destroy (itr);
+  if ((perr = pthread_mutex_unlock (&console_engine_teardown_mutex)))
+    IPMICONSOLE_DEBUG (("pthread_mutex_unlock: %s", strerror (perr)));
+ unlock_target_ctxs_mutex:
+  if ((perr = pthread_mutex_unlock (&console_engine_ctxs_mutex[target])))
+    IPMICONSOLE_DEBUG (("pthread_mutex_unlock: %s", strerror (perr)));
+  return (rv);
+}
+
 static void *
 _ipmiconsole_engine (void *arg)
 {
@@ -939,6 +1221,7 @@ _ipmiconsole_engine (void *arg)
   unsigned int index;
   unsigned int teardown_flag = 0;
   unsigned int teardown_initiated = 0;
+  struct timeval last_rebalance;
 
   assert (arg);
 
@@ -952,6 +1235,12 @@ _ipmiconsole_engine (void *arg)
   if (signal (SIGPIPE, SIG_IGN) == SIG_ERR)
     IPMICONSOLE_DEBUG (("signal: %s", strerror (errno)));
 
+  if (gettimeofday (&last_rebalance, NULL) < 0)
+    {
+      IPMICONSOLE_DEBUG (("gettimeofday: %s", strerror (errno)));
+      timeval_clear (&last_rebalance);
+    }
+
   while (!teardown_flag || ctxs_count)
     {
       struct _ipmiconsole_poll_data poll_data;
@@ -1025,6 +1314,15 @@ _ipmiconsole_engine (void *arg)
       if ((ctxs_count = ipmiconsole_process_ctxs (console_engine_ctxs[index], &timeout_len)) < 0)
         goto continue_loop;
 
+      /* Contexts closed by ipmiconsole_process_ctxs() are gone */
+      console_engine_ctxs_count[index] = ctxs_count;
+
+      if (!teardown_flag && ctxs_count)
+        {
+          if (_rebalance (index, &last_rebalance))
+            ctxs_count--;
+        }
+
       if (!ctxs_count && teardown_flag)
         continue;
 
@@ -1101,6 +1399,13 @@ _ipmiconsole_engine (void *arg)
 
       for (i = 0; i < poll_data.ctxs_len; i++)
         {
+          if (poll_data.pfds[i*3].revents)
+            poll_data.pfds_ctxs[i]->connection.engine_load++;
+          if (poll_data.pfds[i*3 + 1].revents)
+            poll_data.pfds_ctxs[i]->connection.engine_load++;
+          if (poll_data.pfds[i*3 + 2].revents)
+            poll_data.pfds_ctxs[i]->connection.engine_load++;
+
           if (poll_data.pfds[i*3].revents & POLLERR)
             {
               IPMICONSOLE_CTX_DEBUG (poll_data.pfds_ctxs[i], ("POLLERR"));
@@ -104,7 +104,8 @@
   (IPMI_MONITORING_FLAGS_NONE                    \
    | IPMI_MONITORING_FLAGS_DEBUG                 \
    | IPMI_MONITORING_FLAGS_DEBUG_IPMI_PACKETS    \
-   | IPMI_MONITORING_FLAGS_LOCK_MEMORY)
+   | IPMI_MONITORING_FLAGS_LOCK_MEMORY           \
+   | IPMI_MONITORING_FLAGS_SHARED_SDR_CACHE)
 
 #define IPMI_MONITORING_SEL_FLAGS_MASK                    \
   (IPMI_MONITORING_SEL_FLAGS_REREAD_SDR_CACHE             \
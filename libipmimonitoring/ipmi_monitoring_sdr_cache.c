@@ -57,6 +57,8 @@ extern uint32_t _ipmi_monitoring_flags;
 static int
 _ipmi_monitoring_sdr_ctx_init (ipmi_monitoring_ctx_t c, const char *hostname)
 {
+  unsigned int sdr_flags = IPMI_SDR_FLAGS_DEFAULT;
+
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
 
@@ -70,12 +72,21 @@ _ipmi_monitoring_sdr_ctx_init (ipmi_monitoring_ctx_t c, const char *hostname)
       return (-1);
     }
 
+  if (_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_SHARED_SDR_CACHE)
+    sdr_flags |= IPMI_SDR_FLAGS_CACHE_SHARED;
+
   if (_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_DEBUG_IPMI_PACKETS)
+    sdr_flags |= IPMI_SDR_FLAGS_DEBUG_DUMP;
+
+  if (sdr_flags)
     {
       /* Don't error out, if this fails we can still continue */
-      if (ipmi_sdr_ctx_set_flags (c->sdr_ctx, IPMI_SDR_FLAGS_DEBUG_DUMP) < 0)
+      if (ipmi_sdr_ctx_set_flags (c->sdr_ctx, sdr_flags) < 0)
         IPMI_MONITORING_DEBUG (("ipmi_sdr_ctx_set_flags: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
+    }
 
+  if (_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_DEBUG_IPMI_PACKETS)
+    {
       if (hostname)
         {
           if (ipmi_sdr_ctx_set_debug_prefix (c->sdr_ctx, hostname) < 0)
@@ -260,6 +271,145 @@ _ipmi_monitoring_sdr_cache_delete (ipmi_monitoring_ctx_t c,
   return (0);
 }
 
+static int
+_ipmi_monitoring_sdr_cache_key (ipmi_monitoring_ctx_t c,
+                                char *buf,
+                                unsigned int buflen)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->sdr_ctx);
+  assert (c->ipmi_ctx);
+  assert (buf);
+  assert (buflen);
+
+  if (ipmi_sdr_cache_key (c->sdr_ctx,
+                          c->ipmi_ctx,
+                          buf,
+                          buflen) < 0)
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_key: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
+      if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_IPMI_ERROR)
+        ipmi_monitoring_ipmi_ctx_error_convert (c);
+      else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_SYSTEM_ERROR)
+        c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+      else
+        c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      return (-1);
+    }
+
+  return (0);
+}
+
+static int
+_ipmi_monitoring_sdr_cache_open_error (ipmi_monitoring_ctx_t c)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->sdr_ctx);
+
+  if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_FILESYSTEM)
+    c->errnum = IPMI_MONITORING_ERR_SDR_CACHE_FILESYSTEM;
+  else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_PERMISSION)
+    c->errnum = IPMI_MONITORING_ERR_SDR_CACHE_PERMISSION;
+  else
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_open: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
+      c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+    }
+
+  return (-1);
+}
+
+/* With IPMI_MONITORING_FLAGS_SHARED_SDR_CACHE the cache is named by
+ * the SDR repository key rather than the hostname.  Every host with
+ * an identical BMC opens the same file, and the SDR is downloaded
+ * only by the first of them.
+ */
+static int
+_ipmi_monitoring_sdr_cache_load_shared (ipmi_monitoring_ctx_t c,
+                                        const char *hostname,
+                                        unsigned int sdr_create_flags)
+{
+  char key[IPMI_SDR_CACHE_KEY_BUFLEN];
+  char filename[MAXPATHLEN+1];
+  char tmpfilename[MAXPATHLEN+1];
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->ipmi_ctx);
+
+  memset (filename, '\0', MAXPATHLEN + 1);
+  memset (tmpfilename, '\0', MAXPATHLEN + 1);
+
+  if (_ipmi_monitoring_sdr_ctx_init (c, hostname) < 0)
+    goto cleanup;
+
+  if (_ipmi_monitoring_sdr_cache_key (c, key, IPMI_SDR_CACHE_KEY_BUFLEN) < 0)
+    goto cleanup;
+
+  if (_ipmi_monitoring_sdr_cache_filename (c, key, filename, MAXPATHLEN + 1) < 0)
+    goto cleanup;
+
+  /* key already covers the SDR timestamps, no need to recheck them */
+  if (!ipmi_sdr_cache_open (c->sdr_ctx, NULL, filename))
+    return (0);
+
+  if (ipmi_sdr_ctx_errnum (c->sdr_ctx) != IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
+      && ipmi_sdr_ctx_errnum (c->sdr_ctx) != IPMI_SDR_ERR_CACHE_INVALID)
+    {
+      _ipmi_monitoring_sdr_cache_open_error (c);
+      goto cleanup;
+    }
+
+  /* Create under a per-host name and rename into place, so other
+   * hosts never open a partially written cache.
+   */
+  if (snprintf (tmpfilename,
+                MAXPATHLEN,
+                "%s.%s",
+                filename,
+                hostname ? hostname : IPMI_MONITORING_SDR_CACHE_INBAND) >= MAXPATHLEN)
+    {
+      IPMI_MONITORING_DEBUG (("_ipmi_monitoring_sdr_cache_load_shared: overflow"));
+      c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      /* never delete the truncated name in cleanup */
+      memset (tmpfilename, '\0', MAXPATHLEN + 1);
+      goto cleanup;
+    }
+
+  if (_ipmi_monitoring_sdr_cache_delete (c, hostname, tmpfilename) < 0)
+    goto cleanup;
+
+  if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, tmpfilename, sdr_create_flags) < 0)
+    goto cleanup;
+
+  if (rename (tmpfilename, filename) < 0)
+    {
+      IPMI_MONITORING_DEBUG (("rename: %s", strerror (errno)));
+      if (errno == EPERM || errno == EACCES)
+        c->errnum = IPMI_MONITORING_ERR_SDR_CACHE_PERMISSION;
+      else
+        c->errnum = IPMI_MONITORING_ERR_SDR_CACHE_FILESYSTEM;
+      goto cleanup;
+    }
+
+  if (ipmi_sdr_cache_open (c->sdr_ctx, NULL, filename) < 0)
+    {
+      _ipmi_monitoring_sdr_cache_open_error (c);
+      goto cleanup;
+    }
+
+  return (0);
+
+ cleanup:
+  if (strlen (tmpfilename))
+    ipmi_sdr_cache_delete (c->sdr_ctx, tmpfilename);
+  ipmi_sdr_ctx_destroy (c->sdr_ctx);
+  c->sdr_ctx = NULL;
+  return (-1);
+}
+
 int
 ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
                                 const char *hostname,
@@ -271,6 +421,9 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
   assert (c->magic == IPMI_MONITORING_MAGIC);
   assert (c->ipmi_ctx);
 
+  if (_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_SHARED_SDR_CACHE)
+    return (_ipmi_monitoring_sdr_cache_load_shared (c, hostname, sdr_create_flags));
+
   memset (filename, '\0', MAXPATHLEN + 1);
 
   if (_ipmi_monitoring_sdr_cache_filename (c, hostname, filename, MAXPATHLEN + 1) < 0)
@@ -380,6 +533,23 @@ ipmi_monitoring_sdr_cache_flush (ipmi_monitoring_ctx_t c,
   if (_ipmi_monitoring_sdr_cache_delete (c, hostname, filename) < 0)
     goto cleanup;
 
+  if ((_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_SHARED_SDR_CACHE)
+      && c->ipmi_ctx)
+    {
+      char key[IPMI_SDR_CACHE_KEY_BUFLEN];
+
+      if (_ipmi_monitoring_sdr_cache_key (c, key, IPMI_SDR_CACHE_KEY_BUFLEN) < 0)
+        goto cleanup;
+
+      memset (filename, '\0', MAXPATHLEN + 1);
+
+      if (_ipmi_monitoring_sdr_cache_filename (c, key, filename, MAXPATHLEN + 1) < 0)
+        goto cleanup;
+
+      if (_ipmi_monitoring_sdr_cache_delete (c, hostname, filename) < 0)
+        goto cleanup;
+    }
+
   return (0);
 
  cleanup:
@@ -0,0 +1,1015 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "fakebmc.h"
+
+#define FAKEBMC_PKT_LEN            1024
+#define FAKEBMC_PEERS_MAX          256
+#define FAKEBMC_PENDING_MAX        1024
+#define FAKEBMC_POLL_TIMEOUT       20
+
+#define FAKEBMC_NET_FN_CHASSIS     0x00
+#define FAKEBMC_NET_FN_SENSOR      0x04
+#define FAKEBMC_NET_FN_APP         0x06
+#define FAKEBMC_NET_FN_STORAGE     0x0a
+
+#define FAKEBMC_PAYLOAD_IPMI       0x00
+#define FAKEBMC_PAYLOAD_OPEN_RQ    0x10
+#define FAKEBMC_PAYLOAD_OPEN_RS    0x11
+#define FAKEBMC_PAYLOAD_RAKP1      0x12
+#define FAKEBMC_PAYLOAD_RAKP2      0x13
+#define FAKEBMC_PAYLOAD_RAKP3      0x14
+#define FAKEBMC_PAYLOAD_RAKP4      0x15
+
+#define FAKEBMC_CC_SUCCESS         0x00
+#define FAKEBMC_CC_INVALID_CMD     0xc1
+#define FAKEBMC_CC_OUT_OF_RANGE    0xc9
+#define FAKEBMC_CC_BYTES_TOO_MANY  0xca
+#define FAKEBMC_CC_NOT_PRESENT     0xcb
+
+#define FAKEBMC_SEL_ENTRY_LEN      16
+
+struct fakebmc_record
+{
+  uint16_t record_id;
+  uint8_t data[256];
+  unsigned int len;
+};
+
+struct fakebmc_peer
+{
+  struct sockaddr_in addr;
+  uint32_t console_session_id;
+  uint32_t session_sequence_number;
+  int session_open;
+};
+
+struct fakebmc_pending
+{
+  struct timeval when;
+  unsigned int peer;
+  uint8_t authentication_type;
+  uint8_t net_fn;
+  uint8_t cmd;
+  uint8_t msg[FAKEBMC_PKT_LEN];
+  unsigned int msg_len;
+};
+
+struct fakebmc_rule
+{
+  uint8_t net_fn;
+  uint8_t cmd;
+  unsigned int every;
+  unsigned int delay_ms;
+  unsigned int count;
+};
+
+struct fakebmc
+{
+  int fd;
+  char hostname[64];
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  int stop;
+  unsigned int seed;
+
+  struct fakebmc_peer peers[FAKEBMC_PEERS_MAX];
+  unsigned int peers_count;
+
+  struct fakebmc_pending pending[FAKEBMC_PENDING_MAX];
+  unsigned int pending_count;
+
+  struct fakebmc_record sdr[FAKEBMC_SDR_MAX];
+  unsigned int sdr_count;
+  uint32_t sdr_addition_timestamp;
+  uint32_t sdr_erase_timestamp;
+  unsigned int sdr_read_max;
+  unsigned int sdr_read_rejected;
+
+  struct fakebmc_record sel[FAKEBMC_SEL_MAX];
+  unsigned int sel_count;
+  uint32_t sel_addition_timestamp;
+  uint32_t sel_erase_timestamp;
+
+  uint16_t reservation_id;
+
+  unsigned int delay_min_ms;
+  unsigned int delay_max_ms;
+  struct fakebmc_rule drop;
+  struct fakebmc_rule late;
+
+  unsigned int counts[64][256];
+  unsigned int outstanding[64][256];
+  unsigned int outstanding_max[64][256];
+};
+
+static const uint8_t fakebmc_rmcp_hdr[4] = { 0x06, 0x00, 0xff, 0x07 };
+
+static void
+_put16 (uint8_t *buf, uint16_t val)
+{
+  buf[0] = val & 0xff;
+  buf[1] = (val >> 8) & 0xff;
+}
+
+static void
+_put32 (uint8_t *buf, uint32_t val)
+{
+  buf[0] = val & 0xff;
+  buf[1] = (val >> 8) & 0xff;
+  buf[2] = (val >> 16) & 0xff;
+  buf[3] = (val >> 24) & 0xff;
+}
+
+static uint16_t
+_get16 (const uint8_t *buf)
+{
+  return (buf[0] | (buf[1] << 8));
+}
+
+static uint32_t
+_get32 (const uint8_t *buf)
+{
+  return (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24));
+}
+
+static uint8_t
+_checksum (const uint8_t *buf, unsigned int len)
+{
+  uint8_t sum = 0;
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    sum += buf[i];
+
+  return (-sum);
+}
+
+static void
+_send (fakebmc_t bmc,
+       unsigned int peer,
+       uint8_t authentication_type,
+       uint8_t payload_type,
+       const uint8_t *payload,
+       unsigned int payload_len)
+{
+  uint8_t pkt[FAKEBMC_PKT_LEN];
+  struct fakebmc_peer *p = &bmc->peers[peer];
+  unsigned int len = 0;
+
+  memcpy (pkt, fakebmc_rmcp_hdr, 4);
+  len += 4;
+
+  if (authentication_type == 0x00)
+    {
+      /* IPMI 1.5 session header, no authentication */
+      pkt[len++] = 0x00;
+      _put32 (&pkt[len], 0);
+      len += 4;
+      _put32 (&pkt[len], 0);
+      len += 4;
+      pkt[len++] = payload_len;
+    }
+  else
+    {
+      pkt[len++] = 0x06;
+      pkt[len++] = payload_type;
+      if (payload_type == FAKEBMC_PAYLOAD_IPMI)
+        {
+          /* stamped when sent, so delayed responses stay in order */
+          _put32 (&pkt[len], p->console_session_id);
+          _put32 (&pkt[len + 4], ++p->session_sequence_number);
+        }
+      else
+        {
+          _put32 (&pkt[len], 0);
+          _put32 (&pkt[len + 4], 0);
+        }
+      len += 8;
+      _put16 (&pkt[len], payload_len);
+      len += 2;
+    }
+
+  memcpy (&pkt[len], payload, payload_len);
+  len += payload_len;
+
+  sendto (bmc->fd,
+          pkt,
+          len,
+          0,
+          (struct sockaddr *)&p->addr,
+          sizeof (struct sockaddr_in));
+}
+
+/* Build the IPMI message response to the request in rq */
+static unsigned int
+_ipmi_rs (const uint8_t *rq,
+          uint8_t comp_code,
+          const uint8_t *data,
+          unsigned int data_len,
+          uint8_t *rs)
+{
+  unsigned int len;
+
+  rs[0] = rq[3];
+  rs[1] = (((rq[1] >> 2) | 1) << 2) | (rq[4] & 0x3);
+  rs[2] = _checksum (rs, 2);
+  rs[3] = rq[0];
+  rs[4] = (rq[4] & 0xfc) | (rq[1] & 0x3);
+  rs[5] = rq[5];
+  rs[6] = comp_code;
+  memcpy (&rs[7], data, data_len);
+  len = 7 + data_len;
+  rs[len] = _checksum (&rs[3], len - 3);
+  return (len + 1);
+}
+
+static struct fakebmc_record *
+_record_find (struct fakebmc_record *records,
+              unsigned int count,
+              uint16_t record_id,
+              uint16_t *next_record_id)
+{
+  unsigned int i;
+
+  if (!count)
+    return (NULL);
+
+  if (record_id == 0x0000)
+    i = 0;
+  else if (record_id == 0xffff)
+    i = count - 1;
+  else
+    {
+      for (i = 0; i < count; i++)
+        {
+          if (records[i].record_id == record_id)
+            break;
+        }
+      if (i == count)
+        return (NULL);
+    }
+
+  *next_record_id = (i + 1 < count) ? records[i + 1].record_id : 0xffff;
+  return (&records[i]);
+}
+
+static uint8_t
+_record_read (struct fakebmc_record *records,
+              unsigned int count,
+              unsigned int read_max,
+              const uint8_t *rq_data,
+              uint8_t *data,
+              unsigned int *data_len)
+{
+  struct fakebmc_record *record;
+  uint16_t next_record_id = 0xffff;
+  unsigned int offset, bytes;
+
+  if (!(record = _record_find (records, count, _get16 (&rq_data[2]), &next_record_id)))
+    return (FAKEBMC_CC_NOT_PRESENT);
+
+  offset = rq_data[4];
+  bytes = rq_data[5];
+
+  if (offset > record->len)
+    return (FAKEBMC_CC_OUT_OF_RANGE);
+
+  if (bytes == 0xff)
+    bytes = record->len - offset;
+
+  if (read_max && bytes > read_max)
+    return (FAKEBMC_CC_BYTES_TOO_MANY);
+
+  if (offset + bytes > record->len)
+    bytes = record->len - offset;
+
+  _put16 (data, next_record_id);
+  memcpy (&data[2], &record->data[offset], bytes);
+  *data_len = 2 + bytes;
+  return (FAKEBMC_CC_SUCCESS);
+}
+
+/* Returns the completion code, fills in data */
+static uint8_t
+_ipmi_cmd (fakebmc_t bmc,
+           uint8_t net_fn,
+           uint8_t cmd,
+           const uint8_t *rq_data,
+           unsigned int rq_data_len,
+           uint8_t *data,
+           unsigned int *data_len)
+{
+  *data_len = 0;
+
+  if (net_fn == FAKEBMC_NET_FN_APP && cmd == 0x01)
+    {
+      /* Get Device ID */
+      static const uint8_t device_id[] = { 0x20, 0x81, 0x01, 0x00, 0x02, 0x06,
+                                           0x57, 0x01, 0x00, 0x34, 0x12 };
+
+      memcpy (data, device_id, sizeof (device_id));
+      *data_len = sizeof (device_id);
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_APP && cmd == 0x38)
+    {
+      /* Get Channel Authentication Capabilities, IPMI 2.0 and none */
+      static const uint8_t auth_caps[] = { 0x01, 0x81, 0x03, 0x02,
+                                           0x00, 0x00, 0x00, 0x00 };
+
+      memcpy (data, auth_caps, sizeof (auth_caps));
+      *data_len = sizeof (auth_caps);
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_APP && cmd == 0x3b)
+    {
+      /* Set Session Privilege Level */
+      data[0] = (rq_data_len && rq_data[0]) ? (rq_data[0] & 0x0f) : 0x04;
+      *data_len = 1;
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_APP && cmd == 0x3c)
+    /* Close Session */
+    return (FAKEBMC_CC_SUCCESS);
+
+  if (net_fn == FAKEBMC_NET_FN_CHASSIS && cmd == 0x01)
+    {
+      /* Get Chassis Status, power on */
+      data[0] = 0x01;
+      data[1] = 0x00;
+      data[2] = 0x00;
+      *data_len = 3;
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_SENSOR && cmd == 0x2d && rq_data_len >= 1)
+    {
+      /* Get Sensor Reading, the reading is the sensor number */
+      if (rq_data[0] == FAKEBMC_SENSOR_NOT_PRESENT)
+        return (FAKEBMC_CC_NOT_PRESENT);
+
+      data[0] = rq_data[0];
+      data[1] = 0xc0;
+      data[2] = 0x01;
+      data[3] = 0x00;
+      *data_len = 4;
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_STORAGE
+      && (cmd == 0x20 || cmd == 0x40))
+    {
+      /* Get SDR Repository Info, Get SEL Info */
+      data[0] = 0x51;
+      if (cmd == 0x20)
+        {
+          _put16 (&data[1], bmc->sdr_count);
+          _put16 (&data[3], 0xffff);
+          _put32 (&data[5], bmc->sdr_addition_timestamp);
+          _put32 (&data[9], bmc->sdr_erase_timestamp);
+        }
+      else
+        {
+          _put16 (&data[1], bmc->sel_count);
+          _put16 (&data[3], 0xffff);
+          _put32 (&data[5], bmc->sel_addition_timestamp);
+          _put32 (&data[9], bmc->sel_erase_timestamp);
+        }
+      /* reserve supported */
+      data[13] = 0x02;
+      *data_len = 14;
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_STORAGE
+      && (cmd == 0x22 || cmd == 0x42))
+    {
+      /* Reserve SDR Repository, Reserve SEL */
+      if (!++bmc->reservation_id)
+        bmc->reservation_id++;
+      _put16 (data, bmc->reservation_id);
+      *data_len = 2;
+      return (FAKEBMC_CC_SUCCESS);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_STORAGE && cmd == 0x23 && rq_data_len >= 6)
+    {
+      /* Get SDR */
+      uint8_t comp_code;
+
+      comp_code = _record_read (bmc->sdr,
+                                bmc->sdr_count,
+                                bmc->sdr_read_max,
+                                rq_data,
+                                data,
+                                data_len);
+      /* reads of the entire record are expected to fail */
+      if (comp_code == FAKEBMC_CC_BYTES_TOO_MANY && rq_data[5] != 0xff)
+        bmc->sdr_read_rejected++;
+      return (comp_code);
+    }
+
+  if (net_fn == FAKEBMC_NET_FN_STORAGE && cmd == 0x43 && rq_data_len >= 6)
+    /* Get SEL Entry */
+    return (_record_read (bmc->sel,
+                          bmc->sel_count,
+                          0,
+                          rq_data,
+                          data,
+                          data_len));
+
+  return (FAKEBMC_CC_INVALID_CMD);
+}
+
+static int
+_rule_match (struct fakebmc_rule *rule, uint8_t net_fn, uint8_t cmd)
+{
+  if (!rule->every || rule->net_fn != net_fn || rule->cmd != cmd)
+    return (0);
+
+  return (!(++rule->count % rule->every));
+}
+
+static void
+_timeval_add_ms (struct timeval *tv, unsigned int ms)
+{
+  struct timeval len;
+
+  len.tv_sec = ms / 1000;
+  len.tv_usec = (ms % 1000) * 1000;
+  timeradd (tv, &len, tv);
+}
+
+static void
+_ipmi_payload (fakebmc_t bmc,
+               unsigned int peer,
+               uint8_t authentication_type,
+               const uint8_t *msg,
+               unsigned int msg_len)
+{
+  struct fakebmc_pending *pending;
+  uint8_t data[FAKEBMC_PKT_LEN];
+  unsigned int data_len;
+  unsigned int delay_ms = 0;
+  uint8_t net_fn, cmd, comp_code;
+
+  /* header 6 bytes, checksum 1 byte */
+  if (msg_len < 7)
+    return;
+
+  net_fn = msg[1] >> 2;
+  cmd = msg[5];
+
+  bmc->counts[net_fn >> 1][cmd]++;
+
+  /* as a BMC does, ignore requests in a session it does not know */
+  if (authentication_type != 0x00 && !bmc->peers[peer].session_open)
+    return;
+
+  if (_rule_match (&bmc->drop, net_fn, cmd))
+    return;
+
+  /* Close Session */
+  if (net_fn == FAKEBMC_NET_FN_APP && cmd == 0x3c)
+    bmc->peers[peer].session_open = 0;
+
+  comp_code = _ipmi_cmd (bmc,
+                         net_fn,
+                         cmd,
+                         &msg[6],
+                         msg_len - 7,
+                         data,
+                         &data_len);
+
+  if (bmc->delay_max_ms)
+    delay_ms = bmc->delay_min_ms
+      + (rand_r (&bmc->seed) % (bmc->delay_max_ms - bmc->delay_min_ms + 1));
+
+  if (_rule_match (&bmc->late, net_fn, cmd))
+    delay_ms = bmc->late.delay_ms;
+
+  if (bmc->pending_count == FAKEBMC_PENDING_MAX)
+    return;
+
+  pending = &bmc->pending[bmc->pending_count++];
+  gettimeofday (&pending->when, NULL);
+  _timeval_add_ms (&pending->when, delay_ms);
+  pending->peer = peer;
+  pending->authentication_type = authentication_type;
+  pending->net_fn = net_fn;
+  pending->cmd = cmd;
+  pending->msg_len = _ipmi_rs (msg, comp_code, data, data_len, pending->msg);
+
+  if (++bmc->outstanding[net_fn >> 1][cmd] > bmc->outstanding_max[net_fn >> 1][cmd])
+    bmc->outstanding_max[net_fn >> 1][cmd] = bmc->outstanding[net_fn >> 1][cmd];
+}
+
+/* Send responses that are due, earliest first, and return the poll
+ * timeout until the next one.
+ */
+static int
+_pending_send (fakebmc_t bmc)
+{
+  struct timeval now;
+  int timeout = FAKEBMC_POLL_TIMEOUT;
+
+  gettimeofday (&now, NULL);
+
+  while (bmc->pending_count)
+    {
+      struct fakebmc_pending *pending;
+      unsigned int i, earliest = 0;
+
+      for (i = 1; i < bmc->pending_count; i++)
+        {
+          if (timercmp (&bmc->pending[i].when, &bmc->pending[earliest].when, <))
+            earliest = i;
+        }
+
+      pending = &bmc->pending[earliest];
+      if (timercmp (&pending->when, &now, >))
+        {
+          struct timeval diff;
+
+          timersub (&pending->when, &now, &diff);
+          if (diff.tv_sec * 1000 + diff.tv_usec / 1000 < timeout)
+            timeout = diff.tv_sec * 1000 + diff.tv_usec / 1000;
+          break;
+        }
+
+      _send (bmc,
+             pending->peer,
+             pending->authentication_type,
+             FAKEBMC_PAYLOAD_IPMI,
+             pending->msg,
+             pending->msg_len);
+
+      bmc->outstanding[pending->net_fn >> 1][pending->cmd]--;
+      *pending = bmc->pending[--bmc->pending_count];
+    }
+
+  return (timeout);
+}
+
+static unsigned int
+_peer (fakebmc_t bmc, struct sockaddr_in *addr)
+{
+  unsigned int i;
+
+  for (i = 0; i < bmc->peers_count; i++)
+    {
+      if (bmc->peers[i].addr.sin_port == addr->sin_port
+          && bmc->peers[i].addr.sin_addr.s_addr == addr->sin_addr.s_addr)
+        return (i);
+    }
+
+  /* re-use the oldest slot when full, tests don't get that far */
+  if (i == FAKEBMC_PEERS_MAX)
+    i = 0;
+  else
+    bmc->peers_count++;
+
+  memset (&bmc->peers[i], '\0', sizeof (struct fakebmc_peer));
+  bmc->peers[i].addr = *addr;
+  return (i);
+}
+
+static void
+_recv (fakebmc_t bmc)
+{
+  uint8_t pkt[FAKEBMC_PKT_LEN];
+  uint8_t rs[FAKEBMC_PKT_LEN];
+  struct sockaddr_in addr;
+  socklen_t addrlen = sizeof (struct sockaddr_in);
+  unsigned int peer, payload_len, i;
+  const uint8_t *payload;
+  uint8_t payload_type;
+  ssize_t len;
+
+  if ((len = recvfrom (bmc->fd,
+                       pkt,
+                       FAKEBMC_PKT_LEN,
+                       MSG_DONTWAIT,
+                       (struct sockaddr *)&addr,
+                       &addrlen)) < 16)
+    return;
+
+  peer = _peer (bmc, &addr);
+
+  if (pkt[4] == 0x00)
+    {
+      /* IPMI 1.5, only Get Channel Authentication Capabilities is
+       * answered, it is sent before a 2.0 session is opened.
+       */
+      if (len < 14 + 7 || 14 + pkt[13] > len || pkt[14 + 5] != 0x38)
+        return;
+
+      _ipmi_payload (bmc, peer, 0x00, &pkt[14], pkt[13]);
+      return;
+    }
+
+  if (pkt[4] != 0x06)
+    return;
+
+  payload_type = pkt[5] & 0x3f;
+  payload_len = _get16 (&pkt[14]);
+  payload = &pkt[16];
+  if (16 + payload_len > len)
+    return;
+
+  switch (payload_type)
+    {
+    case FAKEBMC_PAYLOAD_OPEN_RQ:
+      if (payload_len < 8)
+        return;
+      bmc->peers[peer].console_session_id = _get32 (&payload[4]);
+      bmc->peers[peer].session_sequence_number = 0;
+      bmc->peers[peer].session_open = 1;
+      memset (rs, '\0', 36);
+      rs[0] = payload[0];
+      rs[2] = 0x04;
+      _put32 (&rs[4], bmc->peers[peer].console_session_id);
+      _put32 (&rs[8], 0x1000 + peer);
+      /* authentication, integrity, confidentiality: none */
+      for (i = 0; i < 3; i++)
+        {
+          rs[12 + i * 8] = i;
+          rs[12 + i * 8 + 3] = 0x08;
+        }
+      _send (bmc, peer, 0x06, FAKEBMC_PAYLOAD_OPEN_RS, rs, 36);
+      break;
+    case FAKEBMC_PAYLOAD_RAKP1:
+      memset (rs, '\0', 40);
+      rs[0] = payload[0];
+      _put32 (&rs[4], bmc->peers[peer].console_session_id);
+      /* random number and guid, contents do not matter */
+      for (i = 8; i < 40; i++)
+        rs[i] = i;
+      _send (bmc, peer, 0x06, FAKEBMC_PAYLOAD_RAKP2, rs, 40);
+      break;
+    case FAKEBMC_PAYLOAD_RAKP3:
+      memset (rs, '\0', 8);
+      rs[0] = payload[0];
+      _put32 (&rs[4], bmc->peers[peer].console_session_id);
+      _send (bmc, peer, 0x06, FAKEBMC_PAYLOAD_RAKP4, rs, 8);
+      break;
+    case FAKEBMC_PAYLOAD_IPMI:
+      _ipmi_payload (bmc, peer, 0x06, payload, payload_len);
+      break;
+    default:
+      break;
+    }
+}
+
+static void *
+_fakebmc_thread (void *arg)
+{
+  fakebmc_t bmc = arg;
+  struct pollfd pfd;
+
+  while (1)
+    {
+      int timeout;
+
+      pthread_mutex_lock (&bmc->mutex);
+      if (bmc->stop)
+        {
+          pthread_mutex_unlock (&bmc->mutex);
+          break;
+        }
+      timeout = _pending_send (bmc);
+      pthread_mutex_unlock (&bmc->mutex);
+
+      pfd.fd = bmc->fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll (&pfd, 1, timeout) <= 0)
+        continue;
+
+      pthread_mutex_lock (&bmc->mutex);
+      _recv (bmc);
+      pthread_mutex_unlock (&bmc->mutex);
+    }
+
+  return (NULL);
+}
+
+fakebmc_t
+fakebmc_start (void)
+{
+  struct sockaddr_in addr;
+  socklen_t addrlen = sizeof (struct sockaddr_in);
+  fakebmc_t bmc;
+
+  if (!(bmc = (fakebmc_t)malloc (sizeof (struct fakebmc))))
+    return (NULL);
+  memset (bmc, '\0', sizeof (struct fakebmc));
+
+  bmc->seed = 1;
+  bmc->sdr_addition_timestamp = 0x10000000;
+  bmc->sdr_erase_timestamp = 0x10000000;
+  bmc->sel_addition_timestamp = 0x10000000;
+  bmc->sel_erase_timestamp = 0x10000000;
+
+  if ((bmc->fd = socket (AF_INET, SOCK_DGRAM, 0)) < 0)
+    goto cleanup;
+
+  memset (&addr, '\0', sizeof (struct sockaddr_in));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  addr.sin_port = 0;
+
+  if (bind (bmc->fd, (struct sockaddr *)&addr, sizeof (struct sockaddr_in)) < 0)
+    goto cleanup;
+
+  if (getsockname (bmc->fd, (struct sockaddr *)&addr, &addrlen) < 0)
+    goto cleanup;
+
+  snprintf (bmc->hostname,
+            sizeof (bmc->hostname),
+            "127.0.0.1:%u",
+            ntohs (addr.sin_port));
+
+  if (pthread_mutex_init (&bmc->mutex, NULL))
+    goto cleanup;
+
+  if (pthread_create (&bmc->thread, NULL, _fakebmc_thread, bmc))
+    {
+      pthread_mutex_destroy (&bmc->mutex);
+      goto cleanup;
+    }
+
+  return (bmc);
+
+ cleanup:
+  if (bmc->fd >= 0)
+    close (bmc->fd);
+  free (bmc);
+  return (NULL);
+}
+
+void
+fakebmc_stop (fakebmc_t bmc)
+{
+  if (!bmc)
+    return;
+
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->stop = 1;
+  pthread_mutex_unlock (&bmc->mutex);
+
+  pthread_join (bmc->thread, NULL);
+  pthread_mutex_destroy (&bmc->mutex);
+  close (bmc->fd);
+  free (bmc);
+}
+
+const char *
+fakebmc_hostname (fakebmc_t bmc)
+{
+  return (bmc->hostname);
+}
+
+ipmi_ctx_t
+fakebmc_ctx_open (fakebmc_t bmc,
+                  unsigned int session_timeout,
+                  unsigned int retransmission_timeout)
+{
+  ipmi_ctx_t ctx;
+
+  if (!(ctx = ipmi_ctx_create ()))
+    return (NULL);
+
+  if (ipmi_ctx_open_outofband_2_0 (ctx,
+                                   bmc->hostname,
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   0,
+                                   IPMI_PRIVILEGE_LEVEL_ADMIN,
+                                   0,
+                                   session_timeout,
+                                   retransmission_timeout,
+                                   IPMI_WORKAROUND_FLAGS_DEFAULT,
+                                   IPMI_FLAGS_DEFAULT) < 0)
+    {
+      fprintf (stderr,
+               "ipmi_ctx_open_outofband_2_0: %s\n",
+               ipmi_ctx_errormsg (ctx));
+      ipmi_ctx_destroy (ctx);
+      return (NULL);
+    }
+
+  return (ctx);
+}
+
+static int
+_record_add (struct fakebmc_record *records,
+             unsigned int *count,
+             unsigned int max,
+             const uint8_t *record,
+             unsigned int record_len)
+{
+  if (*count == max || record_len < 2 || record_len > 256)
+    return (-1);
+
+  records[*count].record_id = _get16 (record);
+  memcpy (records[*count].data, record, record_len);
+  records[*count].len = record_len;
+  (*count)++;
+  return (0);
+}
+
+int
+fakebmc_add_sdr (fakebmc_t bmc, const uint8_t *record, unsigned int record_len)
+{
+  int rv;
+
+  pthread_mutex_lock (&bmc->mutex);
+  if (!(rv = _record_add (bmc->sdr, &bmc->sdr_count, FAKEBMC_SDR_MAX, record, record_len)))
+    bmc->sdr_addition_timestamp++;
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+void
+fakebmc_clear_sdr (fakebmc_t bmc)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->sdr_count = 0;
+  bmc->sdr_erase_timestamp++;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+void
+fakebmc_set_sdr_read_max (fakebmc_t bmc, unsigned int read_max)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->sdr_read_max = read_max;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+int
+fakebmc_add_sel (fakebmc_t bmc, const uint8_t *entry)
+{
+  int rv;
+
+  pthread_mutex_lock (&bmc->mutex);
+  if (!(rv = _record_add (bmc->sel, &bmc->sel_count, FAKEBMC_SEL_MAX, entry, FAKEBMC_SEL_ENTRY_LEN)))
+    bmc->sel_addition_timestamp++;
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+int
+fakebmc_overwrite_sel (fakebmc_t bmc, const uint8_t *entry)
+{
+  int rv = -1;
+
+  pthread_mutex_lock (&bmc->mutex);
+  if (bmc->sel_count)
+    {
+      bmc->sel_count--;
+      memmove (&bmc->sel[0], &bmc->sel[1], bmc->sel_count * sizeof (struct fakebmc_record));
+      if (!(rv = _record_add (bmc->sel, &bmc->sel_count, FAKEBMC_SEL_MAX, entry, FAKEBMC_SEL_ENTRY_LEN)))
+        bmc->sel_addition_timestamp++;
+    }
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+void
+fakebmc_clear_sel (fakebmc_t bmc)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->sel_count = 0;
+  bmc->sel_erase_timestamp++;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+void
+fakebmc_close_sessions (fakebmc_t bmc)
+{
+  unsigned int i;
+
+  pthread_mutex_lock (&bmc->mutex);
+  for (i = 0; i < bmc->peers_count; i++)
+    bmc->peers[i].session_open = 0;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+void
+fakebmc_set_delay (fakebmc_t bmc, unsigned int min_ms, unsigned int max_ms)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->delay_min_ms = min_ms;
+  bmc->delay_max_ms = max_ms < min_ms ? min_ms : max_ms;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+void
+fakebmc_set_drop (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd, unsigned int every)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->drop.net_fn = net_fn;
+  bmc->drop.cmd = cmd;
+  bmc->drop.every = every;
+  bmc->drop.count = 0;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+void
+fakebmc_set_late (fakebmc_t bmc,
+                  uint8_t net_fn,
+                  uint8_t cmd,
+                  unsigned int every,
+                  unsigned int delay_ms)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->late.net_fn = net_fn;
+  bmc->late.cmd = cmd;
+  bmc->late.every = every;
+  bmc->late.delay_ms = delay_ms;
+  bmc->late.count = 0;
+  pthread_mutex_unlock (&bmc->mutex);
+}
+
+unsigned int
+fakebmc_count (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd)
+{
+  unsigned int rv;
+
+  pthread_mutex_lock (&bmc->mutex);
+  rv = bmc->counts[(net_fn >> 1) & 0x3f][cmd];
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+unsigned int
+fakebmc_outstanding_max (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd)
+{
+  unsigned int rv;
+
+  pthread_mutex_lock (&bmc->mutex);
+  rv = bmc->outstanding_max[(net_fn >> 1) & 0x3f][cmd];
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+unsigned int
+fakebmc_sdr_read_rejected (fakebmc_t bmc)
+{
+  unsigned int rv;
+
+  pthread_mutex_lock (&bmc->mutex);
+  rv = bmc->sdr_read_rejected;
+  pthread_mutex_unlock (&bmc->mutex);
+  return (rv);
+}
+
+void
+fakebmc_reset_counts (fakebmc_t bmc)
+{
+  pthread_mutex_lock (&bmc->mutex);
+  bmc->sdr_read_rejected = 0;
+  memset (bmc->counts, '\0', sizeof (bmc->counts));
+  memset (bmc->outstanding_max, '\0', sizeof (bmc->outstanding_max));
+  pthread_mutex_unlock (&bmc->mutex);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FAKEBMC_H
+#define FAKEBMC_H
+
+#include <stdint.h>
+
+#include <freeipmi/freeipmi.h>
+
+/* A minimal BMC answering IPMI 2.0 LAN sessions on 127.0.0.1, for
+ * tests only.  Sessions use cipher suite 0, so there is no
+ * authentication, integrity or encryption.  The BMC runs in its own
+ * thread, all functions below may be called while it runs.
+ *
+ * Supported commands are Get Device ID, Get Channel Authentication
+ * Capabilities, Set Session Privilege Level, Close Session, Get
+ * Chassis Status, Get Sensor Reading, and the SDR and SEL repository
+ * commands.  Anything else is answered with "invalid command".
+ * Outside a session only Get Channel Authentication Capabilities is
+ * answered.
+ */
+
+#define FAKEBMC_SDR_MAX     512
+#define FAKEBMC_SEL_MAX     16384
+
+/* Get Sensor Reading of this sensor number fails with "requested
+ * sensor, data, or record not present".
+ */
+#define FAKEBMC_SENSOR_NOT_PRESENT 0x99
+
+typedef struct fakebmc *fakebmc_t;
+
+/* Returns NULL on error */
+fakebmc_t fakebmc_start (void);
+
+void fakebmc_stop (fakebmc_t bmc);
+
+/* Hostname to pass to ipmi_ctx_open_outofband_2_0(), "127.0.0.1:port" */
+const char *fakebmc_hostname (fakebmc_t bmc);
+
+/* Open an IPMI 2.0 session to the BMC.  Returns NULL on error. */
+ipmi_ctx_t fakebmc_ctx_open (fakebmc_t bmc,
+                             unsigned int session_timeout,
+                             unsigned int retransmission_timeout);
+
+/* SDR repository.  The record id is taken from the record itself.
+ * Adding or clearing records updates the addition or erase timestamp.
+ */
+int fakebmc_add_sdr (fakebmc_t bmc, const uint8_t *record, unsigned int record_len);
+
+void fakebmc_clear_sdr (fakebmc_t bmc);
+
+/* Largest Get SDR partial read accepted, larger reads fail with
+ * "cannot return number of requested data bytes".  0 for no limit.
+ */
+void fakebmc_set_sdr_read_max (fakebmc_t bmc, unsigned int read_max);
+
+/* SEL, entries are 16 bytes, the record id is taken from the entry */
+int fakebmc_add_sel (fakebmc_t bmc, const uint8_t *entry);
+
+/* As a full SEL does, replace the oldest entry with a new one without
+ * changing the erase timestamp.
+ */
+int fakebmc_overwrite_sel (fakebmc_t bmc, const uint8_t *entry);
+
+void fakebmc_clear_sel (fakebmc_t bmc);
+
+/* Forget every open session, as a BMC that was reset or timed them
+ * out does.  Requests in those sessions are no longer answered.
+ */
+void fakebmc_close_sessions (fakebmc_t bmc);
+
+/* Delay every response by a random time between min_ms and max_ms,
+ * so responses to outstanding requests are returned out of order.
+ */
+void fakebmc_set_delay (fakebmc_t bmc, unsigned int min_ms, unsigned int max_ms);
+
+/* Drop every 'every'th request for net_fn/cmd, 0 to disable */
+void fakebmc_set_drop (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd, unsigned int every);
+
+/* Delay the response to every 'every'th request for net_fn/cmd by
+ * delay_ms, so it arrives after the request was retransmitted.  0 to
+ * disable.
+ */
+void fakebmc_set_late (fakebmc_t bmc,
+                       uint8_t net_fn,
+                       uint8_t cmd,
+                       unsigned int every,
+                       unsigned int delay_ms);
+
+/* Number of requests received for net_fn/cmd */
+unsigned int fakebmc_count (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd);
+
+/* Largest number of requests for net_fn/cmd that were received but
+ * not yet answered at the same time.
+ */
+unsigned int fakebmc_outstanding_max (fakebmc_t bmc, uint8_t net_fn, uint8_t cmd);
+
+/* Number of partial Get SDR reads failed for exceeding the read
+ * limit.  Reads of an entire record are not counted.
+ */
+unsigned int fakebmc_sdr_read_rejected (fakebmc_t bmc);
+
+void fakebmc_reset_counts (fakebmc_t bmc);
+
+#endif /* FAKEBMC_H */
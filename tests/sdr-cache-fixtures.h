@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SDR_CACHE_FIXTURES_H
+#define SDR_CACHE_FIXTURES_H
+
+#include <stdint.h>
+
+/* SDR caches written by earlier libfreeipmi releases.  Each was
+ * created with ipmi_sdr_cache_create() and default flags against a
+ * fakebmc freshly started and loaded with sdr_records_build
+ * (SDR_RECORDS_COUNT, 0, ...), linking fakebmc.c and sdr-records.c
+ * against the release's libfreeipmi.
+ */
+
+/* cache file version 1.2, records only */
+static const uint8_t sdr_cache_fixture_1_2[] =
+  {
+    0x72, 0x8C, 0x9D, 0x1F, 0x00, 0x01, 0x00, 0x02, 0x15, 0x28, 0x00, 0x28,
+    0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0xBE, 0x00, 0x01, 0x51, 0x01,
+    0x34, 0x20, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x30, 0x30, 0x25, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00,
+    0x05, 0x04, 0x01, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x31, 0x0A, 0x01,
+    0x51, 0x03, 0x15, 0x20, 0x00, 0x09, 0x05, 0x02, 0x07, 0x6F, 0x01, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x32,
+    0x2F, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x03, 0x14, 0x01, 0x51,
+    0x01, 0x34, 0x20, 0x00, 0x11, 0x04, 0x04, 0x00, 0x00, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x30, 0x34, 0x39, 0x01, 0x51, 0x02, 0x24, 0x20,
+    0x00, 0x15, 0x05, 0x05, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x35, 0x1E,
+    0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x19, 0x03, 0x06, 0x07, 0x6F, 0x01,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30,
+    0x36, 0x03, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x07, 0x28, 0x01,
+    0x51, 0x01, 0x34, 0x20, 0x00, 0x21, 0x05, 0x01, 0x00, 0x00, 0x01, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x38, 0x0D, 0x01, 0x51, 0x02, 0x24,
+    0x20, 0x00, 0x25, 0x03, 0x02, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x39,
+    0x32, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x29, 0x04, 0x03, 0x07, 0x6F,
+    0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x31, 0x30, 0x17, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x0B, 0x3C,
+    0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x31, 0x03, 0x05, 0x00, 0x00, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53,
+    0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31, 0x32, 0x21, 0x01, 0x51, 0x02,
+    0x24, 0x20, 0x00, 0x35, 0x04, 0x06, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31,
+    0x33, 0x06, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x39, 0x05, 0x00, 0x07,
+    0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72,
+    0x20, 0x31, 0x34, 0x2B, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x0F,
+    0x10, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x41, 0x04, 0x02, 0x00, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9,
+    0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31, 0x36, 0x35, 0x01, 0x51,
+    0x02, 0x24, 0x20, 0x00, 0x45, 0x05, 0x03, 0x00, 0x00, 0x02, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x31, 0x37, 0x1A, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x49, 0x03, 0x04,
+    0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F,
+    0x72, 0x20, 0x31, 0x38, 0x3F, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00,
+    0x13, 0x24, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x51, 0x05, 0x06, 0x00,
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x30, 0x09, 0x01,
+    0x51, 0x02, 0x24, 0x20, 0x00, 0x55, 0x03, 0x00, 0x00, 0x00, 0x02, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72,
+    0x20, 0x32, 0x31, 0x2E, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x59, 0x04,
+    0x01, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x32, 0x32, 0x13, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01,
+    0x00, 0x17, 0x38, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x61, 0x03, 0x03,
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x34, 0x1D,
+    0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x65, 0x04, 0x04, 0x00, 0x00, 0x02,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F,
+    0x72, 0x20, 0x32, 0x35, 0x02, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x69,
+    0x05, 0x05, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x32, 0x36, 0x27, 0x01, 0x51, 0xC0, 0x04, 0x57,
+    0x01, 0x00, 0x1B, 0x0C, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x71, 0x04,
+    0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x38,
+    0x31, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x75, 0x05, 0x01, 0x00, 0x00,
+    0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x32, 0x39, 0x16, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00,
+    0x79, 0x03, 0x02, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x30, 0x3B, 0x01, 0x51, 0xC0, 0x04,
+    0x57, 0x01, 0x00, 0x1F, 0x20, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x81,
+    0x05, 0x04, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33,
+    0x32, 0x05, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x85, 0x03, 0x05, 0x00,
+    0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x33, 0x33, 0x2A, 0x01, 0x51, 0x03, 0x15, 0x20,
+    0x00, 0x89, 0x04, 0x06, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53,
+    0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x34, 0x0F, 0x01, 0x51, 0xC0,
+    0x04, 0x57, 0x01, 0x00, 0x23, 0x34, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00,
+    0x91, 0x03, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x33, 0x36, 0x19, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x95, 0x04, 0x02,
+    0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x37, 0x3E, 0x01, 0x51, 0x03, 0x15,
+    0x20, 0x00, 0x19, 0x05, 0x03, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9,
+    0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x38, 0x23, 0x01, 0x51,
+    0xC0, 0x04, 0x57, 0x01, 0x00, 0x27, 0x4B, 0x05, 0x00, 0x00, 0xD5
+  };
+
+/* cache file version 1.3, records followed by the record id and
+ * sensor indexes
+ */
+static const uint8_t sdr_cache_fixture_1_3[] =
+  {
+    0x72, 0x8C, 0x9D, 0x1F, 0x00, 0x01, 0x00, 0x03, 0x15, 0x28, 0x00, 0x28,
+    0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0xBD, 0x00, 0x01, 0x51, 0x01,
+    0x34, 0x20, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x30, 0x30, 0x25, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00,
+    0x05, 0x04, 0x01, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x31, 0x0A, 0x01,
+    0x51, 0x03, 0x15, 0x20, 0x00, 0x09, 0x05, 0x02, 0x07, 0x6F, 0x01, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x32,
+    0x2F, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x03, 0x14, 0x01, 0x51,
+    0x01, 0x34, 0x20, 0x00, 0x11, 0x04, 0x04, 0x00, 0x00, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x30, 0x34, 0x39, 0x01, 0x51, 0x02, 0x24, 0x20,
+    0x00, 0x15, 0x05, 0x05, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x35, 0x1E,
+    0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x19, 0x03, 0x06, 0x07, 0x6F, 0x01,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30,
+    0x36, 0x03, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x07, 0x28, 0x01,
+    0x51, 0x01, 0x34, 0x20, 0x00, 0x21, 0x05, 0x01, 0x00, 0x00, 0x01, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x38, 0x0D, 0x01, 0x51, 0x02, 0x24,
+    0x20, 0x00, 0x25, 0x03, 0x02, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x30, 0x39,
+    0x32, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x29, 0x04, 0x03, 0x07, 0x6F,
+    0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x31, 0x30, 0x17, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x0B, 0x3C,
+    0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x31, 0x03, 0x05, 0x00, 0x00, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53,
+    0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31, 0x32, 0x21, 0x01, 0x51, 0x02,
+    0x24, 0x20, 0x00, 0x35, 0x04, 0x06, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31,
+    0x33, 0x06, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x39, 0x05, 0x00, 0x07,
+    0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72,
+    0x20, 0x31, 0x34, 0x2B, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00, 0x0F,
+    0x10, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x41, 0x04, 0x02, 0x00, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9,
+    0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x31, 0x36, 0x35, 0x01, 0x51,
+    0x02, 0x24, 0x20, 0x00, 0x45, 0x05, 0x03, 0x00, 0x00, 0x02, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x31, 0x37, 0x1A, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x49, 0x03, 0x04,
+    0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F,
+    0x72, 0x20, 0x31, 0x38, 0x3F, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01, 0x00,
+    0x13, 0x24, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x51, 0x05, 0x06, 0x00,
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x30, 0x09, 0x01,
+    0x51, 0x02, 0x24, 0x20, 0x00, 0x55, 0x03, 0x00, 0x00, 0x00, 0x02, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72,
+    0x20, 0x32, 0x31, 0x2E, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x59, 0x04,
+    0x01, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x32, 0x32, 0x13, 0x01, 0x51, 0xC0, 0x04, 0x57, 0x01,
+    0x00, 0x17, 0x38, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x61, 0x03, 0x03,
+    0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x34, 0x1D,
+    0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x65, 0x04, 0x04, 0x00, 0x00, 0x02,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F,
+    0x72, 0x20, 0x32, 0x35, 0x02, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00, 0x69,
+    0x05, 0x05, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x32, 0x36, 0x27, 0x01, 0x51, 0xC0, 0x04, 0x57,
+    0x01, 0x00, 0x1B, 0x0C, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x71, 0x04,
+    0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x32, 0x38,
+    0x31, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x75, 0x05, 0x01, 0x00, 0x00,
+    0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73,
+    0x6F, 0x72, 0x20, 0x32, 0x39, 0x16, 0x01, 0x51, 0x03, 0x15, 0x20, 0x00,
+    0x79, 0x03, 0x02, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x30, 0x3B, 0x01, 0x51, 0xC0, 0x04,
+    0x57, 0x01, 0x00, 0x1F, 0x20, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00, 0x81,
+    0x05, 0x04, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33,
+    0x32, 0x05, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x85, 0x03, 0x05, 0x00,
+    0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E,
+    0x73, 0x6F, 0x72, 0x20, 0x33, 0x33, 0x2A, 0x01, 0x51, 0x03, 0x15, 0x20,
+    0x00, 0x89, 0x04, 0x06, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9, 0x53,
+    0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x34, 0x0F, 0x01, 0x51, 0xC0,
+    0x04, 0x57, 0x01, 0x00, 0x23, 0x34, 0x01, 0x51, 0x01, 0x34, 0x20, 0x00,
+    0x91, 0x03, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20,
+    0x33, 0x36, 0x19, 0x01, 0x51, 0x02, 0x24, 0x20, 0x00, 0x95, 0x04, 0x02,
+    0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC9, 0x53, 0x65,
+    0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x37, 0x3E, 0x01, 0x51, 0x03, 0x15,
+    0x20, 0x00, 0x19, 0x05, 0x03, 0x07, 0x6F, 0x01, 0x00, 0x00, 0x00, 0xC9,
+    0x53, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x20, 0x33, 0x38, 0x23, 0x01, 0x51,
+    0xC0, 0x04, 0x57, 0x01, 0x00, 0x27, 0x28, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x14, 0x00, 0x00, 0x00, 0x02, 0x01, 0x94, 0x03, 0x00, 0x00, 0x03, 0x01,
+    0x15, 0x01, 0x00, 0x00, 0x05, 0x01, 0x75, 0x04, 0x00, 0x00, 0x06, 0x01,
+    0x05, 0x02, 0x00, 0x00, 0x09, 0x01, 0xE6, 0x02, 0x00, 0x00, 0x0A, 0x01,
+    0x76, 0x00, 0x00, 0x00, 0x0C, 0x01, 0xB7, 0x03, 0x00, 0x00, 0x0D, 0x01,
+    0x57, 0x01, 0x00, 0x00, 0x0F, 0x01, 0xB8, 0x04, 0x00, 0x00, 0x10, 0x01,
+    0x28, 0x02, 0x00, 0x00, 0x13, 0x01, 0x29, 0x03, 0x00, 0x00, 0x14, 0x01,
+    0x99, 0x00, 0x00, 0x00, 0x16, 0x01, 0x19, 0x04, 0x00, 0x00, 0x17, 0x01,
+    0x9A, 0x01, 0x00, 0x00, 0x19, 0x01, 0xFA, 0x04, 0x00, 0x00, 0x1A, 0x01,
+    0x8A, 0x02, 0x00, 0x00, 0x1D, 0x01, 0x6B, 0x03, 0x00, 0x00, 0x1E, 0x01,
+    0xFB, 0x00, 0x00, 0x00, 0x20, 0x01, 0x3C, 0x04, 0x00, 0x00, 0x21, 0x01,
+    0xDC, 0x01, 0x00, 0x00, 0x23, 0x01, 0x3D, 0x05, 0x00, 0x00, 0x24, 0x01,
+    0xAD, 0x02, 0x00, 0x00, 0x25, 0x01, 0x4D, 0x00, 0x00, 0x00, 0x27, 0x01,
+    0xAE, 0x03, 0x00, 0x00, 0x28, 0x01, 0x1E, 0x01, 0x00, 0x00, 0x2A, 0x01,
+    0x9E, 0x04, 0x00, 0x00, 0x2B, 0x01, 0x1F, 0x02, 0x00, 0x00, 0x2E, 0x01,
+    0x0F, 0x03, 0x00, 0x00, 0x2F, 0x01, 0x90, 0x00, 0x00, 0x00, 0x31, 0x01,
+    0xF0, 0x03, 0x00, 0x00, 0x32, 0x01, 0x80, 0x01, 0x00, 0x00, 0x34, 0x01,
+    0xC1, 0x04, 0x00, 0x00, 0x35, 0x01, 0x61, 0x02, 0x00, 0x00, 0x38, 0x01,
+    0x32, 0x03, 0x00, 0x00, 0x39, 0x01, 0xD2, 0x00, 0x00, 0x00, 0x3B, 0x01,
+    0x33, 0x04, 0x00, 0x00, 0x3C, 0x01, 0xA3, 0x01, 0x00, 0x00, 0x3E, 0x01,
+    0x23, 0x05, 0x00, 0x00, 0x3F, 0x01, 0xA4, 0x02, 0x00, 0x00, 0x28, 0x00,
+    0x00, 0x00, 0x20, 0x01, 0x14, 0x00, 0x00, 0x00, 0x20, 0x05, 0x4D, 0x00,
+    0x00, 0x00, 0x20, 0x06, 0x4D, 0x00, 0x00, 0x00, 0x20, 0x09, 0x76, 0x00,
+    0x00, 0x00, 0x20, 0x11, 0x99, 0x00, 0x00, 0x00, 0x20, 0x15, 0xD2, 0x00,
+    0x00, 0x00, 0x20, 0x16, 0xD2, 0x00, 0x00, 0x00, 0x20, 0x17, 0xD2, 0x00,
+    0x00, 0x00, 0x20, 0x19, 0xFB, 0x00, 0x00, 0x00, 0x20, 0x19, 0x23, 0x05,
+    0x00, 0x00, 0x20, 0x21, 0x1E, 0x01, 0x00, 0x00, 0x20, 0x25, 0x57, 0x01,
+    0x00, 0x00, 0x20, 0x29, 0x80, 0x01, 0x00, 0x00, 0x20, 0x31, 0xA3, 0x01,
+    0x00, 0x00, 0x20, 0x35, 0xDC, 0x01, 0x00, 0x00, 0x20, 0x36, 0xDC, 0x01,
+    0x00, 0x00, 0x20, 0x39, 0x05, 0x02, 0x00, 0x00, 0x20, 0x41, 0x28, 0x02,
+    0x00, 0x00, 0x20, 0x45, 0x61, 0x02, 0x00, 0x00, 0x20, 0x46, 0x61, 0x02,
+    0x00, 0x00, 0x20, 0x47, 0x61, 0x02, 0x00, 0x00, 0x20, 0x49, 0x8A, 0x02,
+    0x00, 0x00, 0x20, 0x51, 0xAD, 0x02, 0x00, 0x00, 0x20, 0x55, 0xE6, 0x02,
+    0x00, 0x00, 0x20, 0x59, 0x0F, 0x03, 0x00, 0x00, 0x20, 0x61, 0x32, 0x03,
+    0x00, 0x00, 0x20, 0x65, 0x6B, 0x03, 0x00, 0x00, 0x20, 0x66, 0x6B, 0x03,
+    0x00, 0x00, 0x20, 0x69, 0x94, 0x03, 0x00, 0x00, 0x20, 0x71, 0xB7, 0x03,
+    0x00, 0x00, 0x20, 0x75, 0xF0, 0x03, 0x00, 0x00, 0x20, 0x76, 0xF0, 0x03,
+    0x00, 0x00, 0x20, 0x77, 0xF0, 0x03, 0x00, 0x00, 0x20, 0x79, 0x19, 0x04,
+    0x00, 0x00, 0x20, 0x81, 0x3C, 0x04, 0x00, 0x00, 0x20, 0x85, 0x75, 0x04,
+    0x00, 0x00, 0x20, 0x89, 0x9E, 0x04, 0x00, 0x00, 0x20, 0x91, 0xC1, 0x04,
+    0x00, 0x00, 0x20, 0x95, 0xFA, 0x04, 0x00, 0x00, 0x20, 0x96, 0xFA, 0x04,
+    0x00, 0x00, 0x46, 0x05, 0x00, 0x00, 0x37, 0x07, 0x00, 0x00, 0x31
+  };
+
+#endif /* SDR_CACHE_FIXTURES_H */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sdr-records.h"
+
+#define SDR_RECORDS_VERSION             0x51
+
+#define SDR_RECORDS_TYPE_FULL           0x01
+#define SDR_RECORDS_TYPE_COMPACT        0x02
+#define SDR_RECORDS_TYPE_EVENT_ONLY     0x03
+#define SDR_RECORDS_TYPE_OEM            0xC0
+
+#define SDR_RECORDS_DUPLICATE           38
+#define SDR_RECORDS_DUPLICATE_OF        6
+
+/* offset of the id string type/length byte */
+#define SDR_RECORDS_FULL_ID_STRING      47
+#define SDR_RECORDS_COMPACT_ID_STRING   31
+#define SDR_RECORDS_EVENT_ID_STRING     16
+
+static uint8_t
+_sensor_number (unsigned int i)
+{
+  if (i == SDR_RECORDS_DUPLICATE)
+    i = SDR_RECORDS_DUPLICATE_OF;
+  return (i * 4 + 1);
+}
+
+static unsigned int
+_id_string (unsigned int i,
+            unsigned int generation,
+            uint8_t *buf)
+{
+  char str[32];
+  int len;
+
+  if (generation && !(i % 5))
+    len = snprintf (str, sizeof (str), "Sensor %02u gen %u", i, generation);
+  else
+    len = snprintf (str, sizeof (str), "Sensor %02u", i);
+
+  /* 8 bit ASCII + Latin 1 */
+  buf[0] = 0xC0 | len;
+  memcpy (&buf[1], str, len);
+  return (len + 1);
+}
+
+void
+sdr_records_build_one (unsigned int i,
+                       unsigned int generation,
+                       struct sdr_record *record)
+{
+  uint8_t *data;
+  unsigned int len;
+
+  assert (i < SDR_RECORDS_MAX);
+  assert (record);
+
+  memset (record, '\0', sizeof (struct sdr_record));
+  data = record->data;
+
+  /* scrambled, 37 and 64 are coprime so ids are unique */
+  record->record_id = 0x100 + (i * 37) % SDR_RECORDS_MAX;
+
+  switch (i % 4)
+    {
+    case 0:
+      record->record_type = SDR_RECORDS_TYPE_FULL;
+      record->share_count = 1;
+      break;
+    case 1:
+      record->record_type = SDR_RECORDS_TYPE_COMPACT;
+      record->share_count = (i % 3) + 1;
+      break;
+    case 2:
+      record->record_type = SDR_RECORDS_TYPE_EVENT_ONLY;
+      record->share_count = (i % 2) + 1;
+      break;
+    default:
+      record->record_type = SDR_RECORDS_TYPE_OEM;
+      break;
+    }
+
+  data[0] = record->record_id & 0xFF;
+  data[1] = record->record_id >> 8;
+  data[2] = SDR_RECORDS_VERSION;
+  data[3] = record->record_type;
+
+  if (record->record_type == SDR_RECORDS_TYPE_OEM)
+    {
+      /* manufacturer id, then OEM data */
+      data[5] = 0x57;
+      data[6] = 0x01;
+      data[7] = 0x00;
+      data[8] = i;
+      len = 9;
+      goto out;
+    }
+
+  record->sensor_number = _sensor_number (i);
+
+  data[5] = SDR_RECORDS_OWNER_ID;
+  data[6] = 0x00;
+  data[7] = record->sensor_number;
+  /* entity id, entity instance */
+  data[8] = 0x03 + (i % 3);
+  data[9] = i % 7;
+
+  if (record->record_type == SDR_RECORDS_TYPE_FULL)
+    {
+      /* sensor type temperature, threshold based */
+      data[12] = 0x01;
+      data[13] = 0x01;
+      /* unsigned, degrees C, linear, M = 1 */
+      data[21] = 0x01;
+      data[24] = 0x01;
+      data[34] = 0xFF;
+      len = SDR_RECORDS_FULL_ID_STRING;
+    }
+  else if (record->record_type == SDR_RECORDS_TYPE_COMPACT)
+    {
+      /* sensor type voltage, generic discrete */
+      data[12] = 0x02;
+      data[13] = 0x03;
+      data[23] = record->share_count;
+      len = SDR_RECORDS_COMPACT_ID_STRING;
+    }
+  else
+    {
+      /* sensor type processor, sensor specific */
+      data[10] = 0x07;
+      data[11] = 0x6F;
+      data[12] = record->share_count;
+      len = SDR_RECORDS_EVENT_ID_STRING;
+    }
+
+  len += _id_string (i, generation, &data[len]);
+
+ out:
+  assert (len <= SDR_RECORDS_LEN_MAX);
+  data[4] = len - 5;
+  record->len = len;
+}
+
+void
+sdr_records_build (unsigned int count,
+                   unsigned int generation,
+                   struct sdr_record *records)
+{
+  unsigned int i;
+
+  assert (count <= SDR_RECORDS_MAX);
+  assert (records);
+
+  for (i = 0; i < count; i++)
+    sdr_records_build_one (i, generation, &records[i]);
+}
+
+int
+sdr_records_search_sensor (const struct sdr_record *records,
+                           unsigned int count,
+                           uint8_t sensor_number)
+{
+  unsigned int i;
+
+  assert (records);
+
+  for (i = 0; i < count; i++)
+    {
+      if (records[i].record_type == SDR_RECORDS_TYPE_OEM)
+        continue;
+
+      if (sensor_number >= records[i].sensor_number
+          && sensor_number < records[i].sensor_number + records[i].share_count)
+        return (i);
+    }
+
+  return (-1);
+}
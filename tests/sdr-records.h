@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SDR_RECORDS_H
+#define SDR_RECORDS_H
+
+#include <stdint.h>
+
+/* Deterministic SDR repository for tests.  Record types rotate
+ * through Full, Compact, Event Only and OEM records, compact records
+ * are shared by up to three sensors, and record ids are not in
+ * ascending order.  Record 38 repeats the sensor number of record 6,
+ * so searches must return the first match.
+ *
+ * The sdr cache fixtures were generated from sdr_records_build
+ * (SDR_RECORDS_COUNT, ...), never change the records it builds.
+ */
+
+#define SDR_RECORDS_COUNT       40
+#define SDR_RECORDS_MAX         64
+#define SDR_RECORDS_LEN_MAX     64
+
+#define SDR_RECORDS_OWNER_ID    0x20
+
+struct sdr_record
+{
+  uint16_t record_id;
+  uint8_t record_type;
+  uint8_t sensor_number;
+  unsigned int share_count;
+  uint8_t data[SDR_RECORDS_LEN_MAX];
+  unsigned int len;
+};
+
+/* Build record number i of the repository.  generation alters the id
+ * string, and so the record length, of every record with i %
+ * 5 == 0 when non-zero.
+ */
+void sdr_records_build_one (unsigned int i,
+                            unsigned int generation,
+                            struct sdr_record *record);
+
+void sdr_records_build (unsigned int count,
+                        unsigned int generation,
+                        struct sdr_record *records);
+
+/* Index of the first record in records serving sensor_number owned
+ * by SDR_RECORDS_OWNER_ID, -1 if none.
+ */
+int sdr_records_search_sensor (const struct sdr_record *records,
+                               unsigned int count,
+                               uint8_t sensor_number);
+
+#endif /* SDR_RECORDS_H */
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   100
+
+/* well past the 64 requester sequence numbers */
+#define TEST_COUNT                    300
+
+/* A batch of Get Sensor Reading commands.  The fake BMC returns the
+ * sensor number as the reading, so each response can be matched to
+ * its request.  Sensor numbers repeat every FAKEBMC_SENSOR_NOT_PRESENT
+ * commands, so that one always reads.
+ */
+struct batch
+{
+  fiid_obj_t obj_cmd_rq[TEST_COUNT];
+  fiid_obj_t obj_cmd_rs[TEST_COUNT];
+  unsigned int count;
+};
+
+static fakebmc_t bmc;
+
+static uint8_t
+_sensor_number (unsigned int i)
+{
+  return (i % FAKEBMC_SENSOR_NOT_PRESENT);
+}
+
+static void
+_batch_init (struct batch *b, unsigned int count)
+{
+  unsigned int i;
+
+  TEST_REQUIRE (count <= TEST_COUNT);
+
+  memset (b, '\0', sizeof (struct batch));
+  b->count = count;
+  for (i = 0; i < count; i++)
+    {
+      TEST_REQUIRE ((b->obj_cmd_rq[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)));
+      TEST_REQUIRE ((b->obj_cmd_rs[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)));
+      TEST_REQUIRE (fill_cmd_get_sensor_reading (_sensor_number (i), b->obj_cmd_rq[i]) >= 0);
+    }
+}
+
+static void
+_batch_cleanup (struct batch *b)
+{
+  unsigned int i;
+
+  for (i = 0; i < b->count; i++)
+    {
+      fiid_obj_destroy (b->obj_cmd_rq[i]);
+      fiid_obj_destroy (b->obj_cmd_rs[i]);
+    }
+}
+
+static int
+_batch_run (ipmi_ctx_t ctx, struct batch *b, unsigned int window)
+{
+  return (ipmi_cmd_batch (ctx,
+                          IPMI_BMC_IPMB_LUN_BMC,
+                          IPMI_NET_FN_SENSOR_EVENT_RQ,
+                          b->obj_cmd_rq,
+                          b->obj_cmd_rs,
+                          b->count,
+                          window));
+}
+
+/* every response holds the reading of its own request */
+static void
+_batch_check (struct batch *b)
+{
+  unsigned int mismatched = 0;
+  unsigned int i;
+  uint64_t val;
+
+  for (i = 0; i < b->count; i++)
+    {
+      if (FIID_OBJ_GET (b->obj_cmd_rs[i], "comp_code", &val) < 0
+          || val != IPMI_COMP_CODE_COMMAND_SUCCESS
+          || FIID_OBJ_GET (b->obj_cmd_rs[i], "sensor_reading", &val) < 0
+          || val != _sensor_number (i))
+        mismatched++;
+    }
+
+  TEST_CHECK (!mismatched);
+}
+
+static unsigned int
+_count (void)
+{
+  return (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING));
+}
+
+static unsigned int
+_outstanding_max (void)
+{
+  return (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING));
+}
+
+static void
+test_errors (ipmi_ctx_t ctx)
+{
+  struct batch b;
+
+  _batch_init (&b, 1);
+
+  TEST_CHECK (ipmi_cmd_batch (NULL,
+                              IPMI_BMC_IPMB_LUN_BMC,
+                              IPMI_NET_FN_SENSOR_EVENT_RQ,
+                              b.obj_cmd_rq,
+                              b.obj_cmd_rs,
+                              1,
+                              0) < 0);
+  TEST_CHECK (_batch_run (ctx, &b, IPMI_CMD_BATCH_WINDOW_MAX + 1) < 0
+              && ipmi_ctx_errnum (ctx) == IPMI_ERR_PARAMETERS);
+  TEST_CHECK (ipmi_cmd_batch (ctx,
+                              IPMI_BMC_IPMB_LUN_BMC,
+                              IPMI_NET_FN_SENSOR_EVENT_RQ,
+                              b.obj_cmd_rq,
+                              b.obj_cmd_rs,
+                              0,
+                              0) < 0
+              && ipmi_ctx_errnum (ctx) == IPMI_ERR_PARAMETERS);
+
+  _batch_cleanup (&b);
+}
+
+/* A window of 1 performs the commands one at a time */
+static void
+test_serial (ipmi_ctx_t ctx)
+{
+  struct batch b;
+
+  _batch_init (&b, 20);
+  fakebmc_reset_counts (bmc);
+
+  TEST_CHECK (!_batch_run (ctx, &b, 1));
+  _batch_check (&b);
+
+  TEST_CHECK (_count () == 20);
+  TEST_CHECK (_outstanding_max () == 1);
+
+  _batch_cleanup (&b);
+}
+
+/* Requester sequence numbers wrap several times over, with responses
+ * returned out of order
+ */
+static void
+test_wrap (ipmi_ctx_t ctx, unsigned int window)
+{
+  struct batch b;
+
+  _batch_init (&b, TEST_COUNT);
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_delay (bmc, 0, 10);
+
+  TEST_CHECK (!_batch_run (ctx, &b, window));
+  _batch_check (&b);
+
+  TEST_CHECK (_count () == TEST_COUNT);
+  TEST_CHECK (_outstanding_max () > 1
+              && _outstanding_max () <= window);
+
+  fakebmc_set_delay (bmc, 0, 0);
+  _batch_cleanup (&b);
+}
+
+/* Lost requests are retransmitted on their own timeout while the rest
+ * of the window keeps going
+ */
+static void
+test_lost (ipmi_ctx_t ctx)
+{
+  struct batch b;
+
+  _batch_init (&b, 100);
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 7);
+
+  TEST_CHECK (!_batch_run (ctx, &b, 8));
+  _batch_check (&b);
+
+  /* only the lost requests were retransmitted */
+  TEST_CHECK (_count () > 100
+              && _count () < 100 + 100 / 6 + 2);
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+  _batch_cleanup (&b);
+}
+
+/* Responses to the original request arrive after the retransmission
+ * was answered and after far more than 64 later sends.  They must not
+ * be taken for the response to a later request.
+ */
+static void
+test_late (ipmi_ctx_t ctx)
+{
+  struct batch b;
+
+  _batch_init (&b, TEST_COUNT);
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_late (bmc,
+                    IPMI_NET_FN_SENSOR_EVENT_RQ,
+                    IPMI_CMD_GET_SENSOR_READING,
+                    5,
+                    TEST_RETRANSMISSION_TIMEOUT * 3 / 2);
+
+  TEST_CHECK (!_batch_run (ctx, &b, IPMI_CMD_BATCH_WINDOW_MAX));
+  _batch_check (&b);
+
+  TEST_CHECK (_count () > TEST_COUNT);
+
+  fakebmc_set_late (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0, 0);
+  _batch_cleanup (&b);
+}
+
+/* A BMC that stops answering fails the batch with a session timeout */
+static void
+test_timeout (void)
+{
+  struct batch b;
+  ipmi_ctx_t ctx;
+
+  TEST_REQUIRE ((ctx = fakebmc_ctx_open (bmc, 1000, TEST_RETRANSMISSION_TIMEOUT)));
+  _batch_init (&b, 20);
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 1);
+  TEST_CHECK (_batch_run (ctx, &b, 0) < 0
+              && ipmi_ctx_errnum (ctx) == IPMI_ERR_SESSION_TIMEOUT);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+
+  _batch_cleanup (&b);
+  ipmi_ctx_close (ctx);
+  ipmi_ctx_destroy (ctx);
+}
+
+int
+main (int argc, char **argv)
+{
+  ipmi_ctx_t ctx;
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  TEST_REQUIRE ((ctx = fakebmc_ctx_open (bmc,
+                                         TEST_SESSION_TIMEOUT,
+                                         TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_errors (ctx);
+  test_serial (ctx);
+  test_wrap (ctx, IPMI_CMD_BATCH_WINDOW_DEFAULT);
+  test_wrap (ctx, IPMI_CMD_BATCH_WINDOW_MAX);
+  test_lost (ctx);
+  test_late (ctx);
+  test_timeout ();
+
+  ipmi_ctx_close (ctx);
+  ipmi_ctx_destroy (ctx);
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}
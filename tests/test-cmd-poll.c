@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   100
+
+#define TEST_CTXS                     8
+
+#define TEST_BUF_LEN                  256
+
+/* give up on a test rather than hang */
+#define TEST_RUN_SECONDS              30
+
+/* A chain of Get Sensor Reading commands on one context, each
+ * submitted from the callback of the previous one.  The fake BMC
+ * returns the sensor number as the reading, so each response can be
+ * matched to its request.
+ */
+struct chain
+{
+  ipmi_ctx_t ctx;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+  uint8_t first;
+  unsigned int count;
+  unsigned int submitted;
+  unsigned int completed;
+  unsigned int mismatched;
+  int errnum;
+};
+
+static fakebmc_t bmc;
+
+static int
+_submit (struct chain *c);
+
+static void
+_callback (ipmi_ctx_t ctx, int errnum, fiid_obj_t obj_cmd_rs, void *data)
+{
+  struct chain *c = data;
+  uint8_t expected;
+  uint64_t val;
+
+  TEST_CHECK (ctx == c->ctx);
+  TEST_CHECK (obj_cmd_rs == c->obj_cmd_rs);
+
+  c->completed++;
+  c->errnum = errnum;
+  if (errnum != IPMI_ERR_SUCCESS)
+    return;
+
+  expected = c->first + c->completed - 1;
+  if (FIID_OBJ_GET (obj_cmd_rs, "sensor_reading", &val) < 0
+      || val != expected)
+    c->mismatched++;
+
+  if (c->submitted < c->count)
+    TEST_CHECK (!_submit (c));
+}
+
+static int
+_submit (struct chain *c)
+{
+  if (fill_cmd_get_sensor_reading (c->first + c->submitted, c->obj_cmd_rq) < 0)
+    return (-1);
+
+  if (ipmi_cmd_poll_submit (c->ctx,
+                            IPMI_BMC_IPMB_LUN_BMC,
+                            IPMI_NET_FN_SENSOR_EVENT_RQ,
+                            c->obj_cmd_rq,
+                            c->obj_cmd_rs,
+                            _callback,
+                            c) < 0)
+    return (-1);
+
+  c->submitted++;
+  return (0);
+}
+
+static void
+_chain_init (struct chain *c, ipmi_ctx_t ctx, uint8_t first, unsigned int count)
+{
+  memset (c, '\0', sizeof (struct chain));
+  c->ctx = ctx;
+  c->first = first;
+  c->count = count;
+  TEST_REQUIRE ((c->obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)));
+  TEST_REQUIRE ((c->obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)));
+}
+
+static void
+_chain_cleanup (struct chain *c)
+{
+  fiid_obj_destroy (c->obj_cmd_rq);
+  fiid_obj_destroy (c->obj_cmd_rs);
+}
+
+/* Drive the outstanding commands of every chain from this thread
+ * until none are outstanding.
+ */
+static void
+_run (struct chain *chains, unsigned int n)
+{
+  struct pollfd pfds[TEST_CTXS];
+  time_t start = time (NULL);
+  unsigned int i;
+
+  while (time (NULL) - start < TEST_RUN_SECONDS)
+    {
+      unsigned int outstanding = 0;
+      int timeout = -1;
+
+      for (i = 0; i < n; i++)
+        {
+          unsigned int ms;
+          int rv;
+
+          pfds[i].fd = ipmi_ctx_get_fd (chains[i].ctx);
+          pfds[i].events = POLLIN;
+          pfds[i].revents = 0;
+          TEST_REQUIRE (pfds[i].fd >= 0);
+
+          TEST_REQUIRE ((rv = ipmi_cmd_poll_timeout (chains[i].ctx, &ms)) >= 0);
+          if (!rv)
+            continue;
+
+          outstanding++;
+          if (timeout < 0 || ms < (unsigned int)timeout)
+            timeout = ms;
+        }
+
+      if (!outstanding)
+        return;
+
+      TEST_REQUIRE (poll (pfds, n, timeout) >= 0);
+
+      for (i = 0; i < n; i++)
+        TEST_REQUIRE (ipmi_cmd_poll_process (chains[i].ctx) >= 0);
+    }
+
+  TEST_REQUIRE (0);
+}
+
+static void
+_check_chain (struct chain *c)
+{
+  TEST_CHECK (c->submitted == c->count);
+  TEST_CHECK (c->completed == c->count);
+  TEST_CHECK (c->errnum == IPMI_ERR_SUCCESS);
+  TEST_CHECK (!c->mismatched);
+}
+
+/* One command at a time, and nothing else on the context meanwhile */
+static void
+test_single (ipmi_ctx_t ctx)
+{
+  struct chain c;
+  unsigned int ms;
+  uint8_t rq[1] = { IPMI_CMD_GET_DEVICE_ID };
+  uint8_t rs[TEST_BUF_LEN];
+
+  _chain_init (&c, ctx, 5, 1);
+
+  TEST_CHECK (!ipmi_cmd_poll_timeout (ctx, &ms));
+  TEST_CHECK (!ipmi_cmd_poll_process (ctx));
+
+  TEST_REQUIRE (!_submit (&c));
+  TEST_CHECK (ipmi_cmd_poll_timeout (ctx, &ms) == 1
+              && ms <= TEST_RETRANSMISSION_TIMEOUT);
+
+  /* the one command is still outstanding */
+  TEST_CHECK (ipmi_cmd_poll_submit (ctx,
+                                    IPMI_BMC_IPMB_LUN_BMC,
+                                    IPMI_NET_FN_SENSOR_EVENT_RQ,
+                                    c.obj_cmd_rq,
+                                    c.obj_cmd_rs,
+                                    _callback,
+                                    &c) < 0
+              && ipmi_ctx_errnum (ctx) == IPMI_ERR_DRIVER_BUSY);
+  TEST_CHECK (ipmi_cmd (ctx,
+                        IPMI_BMC_IPMB_LUN_BMC,
+                        IPMI_NET_FN_SENSOR_EVENT_RQ,
+                        c.obj_cmd_rq,
+                        c.obj_cmd_rs) < 0
+              && ipmi_ctx_errnum (ctx) == IPMI_ERR_DRIVER_BUSY);
+
+  _run (&c, 1);
+  _check_chain (&c);
+
+  TEST_CHECK (!ipmi_cmd_poll_timeout (ctx, &ms));
+
+  /* a cancelled command's callback is never called, and the context
+   * is usable again at once
+   */
+  c.count = 2;
+  TEST_REQUIRE (!_submit (&c));
+  TEST_CHECK (!ipmi_cmd_poll_cancel (ctx));
+  TEST_CHECK (!ipmi_cmd_poll_timeout (ctx, &ms));
+  _run (&c, 1);
+  TEST_CHECK (c.completed == 1);
+
+  TEST_CHECK (ipmi_cmd_raw (ctx,
+                            IPMI_BMC_IPMB_LUN_BMC,
+                            IPMI_NET_FN_APP_RQ,
+                            rq,
+                            sizeof (rq),
+                            rs,
+                            TEST_BUF_LEN) > 0
+              && rs[1] == IPMI_COMP_CODE_COMMAND_SUCCESS);
+
+  _chain_cleanup (&c);
+}
+
+/* Commands submitted from callbacks are never outstanding together */
+static void
+test_chain (ipmi_ctx_t ctx)
+{
+  struct chain c;
+
+  _chain_init (&c, ctx, 1, 40);
+  fakebmc_reset_counts (bmc);
+
+  TEST_REQUIRE (!_submit (&c));
+  _run (&c, 1);
+  _check_chain (&c);
+
+  TEST_CHECK (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) == 40);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) == 1);
+
+  _chain_cleanup (&c);
+}
+
+/* Many contexts from one thread, with responses delayed, lost and
+ * arriving after the retransmission
+ */
+static void
+test_many (ipmi_ctx_t *ctxs)
+{
+  struct chain chains[TEST_CTXS];
+  unsigned int i;
+
+  for (i = 0; i < TEST_CTXS; i++)
+    _chain_init (&chains[i], ctxs[i], i * 16, 16);
+
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_delay (bmc, 0, 20);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 7);
+  fakebmc_set_late (bmc,
+                    IPMI_NET_FN_SENSOR_EVENT_RQ,
+                    IPMI_CMD_GET_SENSOR_READING,
+                    5,
+                    TEST_RETRANSMISSION_TIMEOUT * 3 / 2);
+
+  for (i = 0; i < TEST_CTXS; i++)
+    TEST_REQUIRE (!_submit (&chains[i]));
+  _run (chains, TEST_CTXS);
+
+  for (i = 0; i < TEST_CTXS; i++)
+    _check_chain (&chains[i]);
+
+  /* the lost and late requests were retransmitted */
+  TEST_CHECK (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) > TEST_CTXS * 16);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) > 1);
+
+  fakebmc_set_delay (bmc, 0, 0);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+  fakebmc_set_late (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0, 0);
+
+  for (i = 0; i < TEST_CTXS; i++)
+    _chain_cleanup (&chains[i]);
+}
+
+/* A BMC that stops answering fails the command with a session timeout */
+static void
+test_timeout (void)
+{
+  struct chain c;
+  ipmi_ctx_t ctx;
+
+  TEST_REQUIRE ((ctx = fakebmc_ctx_open (bmc, 1000, TEST_RETRANSMISSION_TIMEOUT)));
+  _chain_init (&c, ctx, 1, 2);
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 1);
+  TEST_REQUIRE (!_submit (&c));
+  _run (&c, 1);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+
+  TEST_CHECK (c.submitted == 1);
+  TEST_CHECK (c.completed == 1);
+  TEST_CHECK (c.errnum == IPMI_ERR_SESSION_TIMEOUT);
+
+  _chain_cleanup (&c);
+  ipmi_ctx_close (ctx);
+  ipmi_ctx_destroy (ctx);
+}
+
+int
+main (int argc, char **argv)
+{
+  ipmi_ctx_t ctxs[TEST_CTXS];
+  unsigned int i;
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  for (i = 0; i < TEST_CTXS; i++)
+    TEST_REQUIRE ((ctxs[i] = fakebmc_ctx_open (bmc,
+                                               TEST_SESSION_TIMEOUT,
+                                               TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_single (ctxs[0]);
+  test_chain (ctxs[0]);
+  test_many (ctxs);
+  test_timeout ();
+
+  for (i = 0; i < TEST_CTXS; i++)
+    {
+      ipmi_ctx_close (ctxs[i]);
+      ipmi_ctx_destroy (ctxs[i]);
+    }
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}
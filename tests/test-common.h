@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Exit status understood by the automake test driver */
+#define TEST_EXIT_PASS 0
+#define TEST_EXIT_FAIL 1
+#define TEST_EXIT_SKIP 77
+
+extern unsigned int test_failures;
+
+/* Record a failure but continue on, so one run reports every
+ * failing check.
+ */
+#define TEST_CHECK(__expr)                                              \
+  do {                                                                  \
+    if (!(__expr))                                                      \
+      {                                                                 \
+        fprintf (stderr, "%s:%d: check failed: %s\n",                   \
+                 __FILE__, __LINE__, #__expr);                          \
+        test_failures++;                                                \
+      }                                                                 \
+  } while (0)
+
+/* For setup that later checks depend on */
+#define TEST_REQUIRE(__expr)                                            \
+  do {                                                                  \
+    if (!(__expr))                                                      \
+      {                                                                 \
+        fprintf (stderr, "%s:%d: requirement failed: %s\n",             \
+                 __FILE__, __LINE__, #__expr);                          \
+        exit (TEST_EXIT_FAIL);                                          \
+      }                                                                 \
+  } while (0)
+
+#define TEST_DEFINE_FAILURES unsigned int test_failures = 0
+
+#define TEST_EXIT()                                                     \
+  (test_failures ? TEST_EXIT_FAIL : TEST_EXIT_PASS)
+
+#endif /* TEST_COMMON_H */
@@ -0,0 +1,687 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_PKT_LEN                   1024
+#define TEST_INTEGRITY_KEY_LEN         20
+#define TEST_CONFIDENTIALITY_KEY_LEN   16
+#define TEST_AES_CBC_128_IV_LEN        16
+
+/* Two templates with the same number of fields, so dynamic copies
+ * of them are likely to land on the same heap address.
+ */
+static fiid_template_t tmpl_test_a =
+  {
+    { 8, "alpha", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 8, "bravo", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 16, "charlie", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 0, "", 0}
+  };
+
+static fiid_template_t tmpl_test_b =
+  {
+    { 16, "xray", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 8, "yankee", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 8, "zulu", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 0, "", 0}
+  };
+
+/* Duplicate keys were always accepted, lookups resolve to the first */
+static fiid_template_t tmpl_test_dup =
+  {
+    { 8, "dup", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 8, "middle", FIID_FIELD_REQUIRED | FIID_FIELD_LENGTH_FIXED},
+    { 8, "dup", FIID_FIELD_OPTIONAL | FIID_FIELD_LENGTH_FIXED},
+    { 8, "aaa", FIID_FIELD_OPTIONAL | FIID_FIELD_LENGTH_FIXED},
+    { 8, "dup", FIID_FIELD_OPTIONAL | FIID_FIELD_LENGTH_FIXED},
+    { 0, "", 0}
+  };
+
+static void
+test_layout_lookup (void)
+{
+  fiid_obj_t obj;
+  uint64_t val;
+
+  TEST_REQUIRE ((obj = fiid_obj_create (tmpl_cmd_get_device_id_rs)));
+
+  TEST_CHECK (!fiid_obj_set (obj, "cmd", IPMI_CMD_GET_DEVICE_ID));
+  TEST_CHECK (!fiid_obj_set (obj, "comp_code", IPMI_COMP_CODE_COMMAND_SUCCESS));
+  TEST_CHECK (!fiid_obj_set (obj, "device_id", 0x20));
+  TEST_CHECK (!fiid_obj_set (obj, "manufacturer_id.id", 0x1234));
+
+  TEST_CHECK (fiid_obj_get (obj, "cmd", &val) == 1 && val == IPMI_CMD_GET_DEVICE_ID);
+  TEST_CHECK (fiid_obj_get (obj, "device_id", &val) == 1 && val == 0x20);
+  TEST_CHECK (fiid_obj_get (obj, "manufacturer_id.id", &val) == 1 && val == 0x1234);
+
+  TEST_CHECK (fiid_obj_get (obj, "no_such_field", &val) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_FIELD_NOT_FOUND);
+  /* keys before the first and after the last sorted key */
+  TEST_CHECK (fiid_obj_get (obj, "", &val) < 0);
+  TEST_CHECK (fiid_obj_get (obj, "zzzz", &val) < 0);
+
+  fiid_obj_destroy (obj);
+}
+
+static void
+test_layout_dynamic (void)
+{
+  fiid_field_index_t index;
+  fiid_field_t *tmpl;
+  fiid_obj_t obj, obj_dyn;
+  uint64_t val;
+  int i;
+
+  /* A freed dynamic template must not leave its layout behind for
+   * whatever template is allocated at the same address next.
+   */
+  for (i = 0; i < 8; i++)
+    {
+      TEST_REQUIRE ((obj = fiid_obj_create (i % 2 ? tmpl_test_b : tmpl_test_a)));
+      TEST_REQUIRE ((tmpl = fiid_obj_template (obj)));
+      TEST_REQUIRE ((obj_dyn = fiid_obj_create (tmpl)));
+
+      if (i % 2)
+        {
+          TEST_CHECK (!fiid_obj_set (obj_dyn, "xray", 0xabcd));
+          TEST_CHECK (fiid_obj_get (obj_dyn, "xray", &val) == 1 && val == 0xabcd);
+          TEST_CHECK (fiid_obj_get (obj_dyn, "charlie", &val) < 0);
+          TEST_CHECK (!fiid_template_field_index (tmpl, "zulu", &index) && index.index == 2);
+        }
+      else
+        {
+          TEST_CHECK (!fiid_obj_set (obj_dyn, "charlie", 0x1234));
+          TEST_CHECK (fiid_obj_get (obj_dyn, "charlie", &val) == 1 && val == 0x1234);
+          TEST_CHECK (fiid_obj_get (obj_dyn, "xray", &val) < 0);
+          TEST_CHECK (!fiid_template_field_index (tmpl, "alpha", &index) && index.index == 0);
+        }
+
+      /* objects keep their layout after the template is freed */
+      fiid_template_free (tmpl);
+      TEST_CHECK (fiid_obj_get (obj_dyn, i % 2 ? "yankee" : "bravo", &val) == 0);
+
+      fiid_obj_destroy (obj_dyn);
+      fiid_obj_destroy (obj);
+    }
+}
+
+/* A template changed in place, as a template on the stack may be,
+ * must not be given the layout of its old contents.
+ */
+static void
+test_layout_reused_address (void)
+{
+  static fiid_field_t tmpl[8];
+  fiid_obj_t obj;
+  uint8_t buf[16];
+  uint64_t val;
+
+  memcpy (tmpl, tmpl_test_a, sizeof (tmpl_test_a));
+  TEST_REQUIRE ((obj = fiid_obj_create (tmpl)));
+  TEST_CHECK (!fiid_obj_set (obj, "charlie", 0x1234));
+  fiid_obj_destroy (obj);
+
+  memcpy (tmpl, tmpl_test_b, sizeof (tmpl_test_b));
+  TEST_REQUIRE ((obj = fiid_obj_create (tmpl)));
+  TEST_CHECK (fiid_obj_get (obj, "charlie", &val) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_FIELD_NOT_FOUND);
+  TEST_CHECK (!fiid_obj_set (obj, "xray", 0xabcd));
+  TEST_CHECK (fiid_obj_get (obj, "xray", &val) == 1 && val == 0xabcd);
+  TEST_CHECK (fiid_obj_get_data (obj, "xray", buf, sizeof (buf)) == 2);
+  fiid_obj_destroy (obj);
+}
+
+static void
+test_layout_duplicate_keys (void)
+{
+  fiid_field_index_t index;
+  fiid_obj_t obj;
+  uint8_t buf[16];
+  uint64_t val;
+
+  TEST_REQUIRE ((obj = fiid_obj_create (tmpl_test_dup)));
+
+  TEST_CHECK (!fiid_template_field_index (tmpl_test_dup, "dup", &index) && index.index == 0);
+  TEST_CHECK (!fiid_template_field_index (tmpl_test_dup, "aaa", &index) && index.index == 3);
+
+  TEST_CHECK (!fiid_obj_set (obj, "dup", 0x11));
+  TEST_CHECK (!fiid_obj_set (obj, "middle", 0x22));
+  TEST_CHECK (fiid_obj_get (obj, "dup", &val) == 1 && val == 0x11);
+
+  /* only the first "dup" was set */
+  memset (buf, '\0', sizeof (buf));
+  TEST_CHECK (fiid_obj_get_all (obj, buf, sizeof (buf)) == 2);
+  TEST_CHECK (buf[0] == 0x11 && buf[1] == 0x22);
+
+  fiid_obj_destroy (obj);
+}
+
+static void
+test_field_index (void)
+{
+  fiid_field_index_t index_device_id;
+  fiid_field_index_t index_manufacturer_id;
+  fiid_field_index_t index_session_id;
+  fiid_field_index_t index;
+  fiid_field_t *tmpl;
+  fiid_obj_t obj, obj_other, obj_dyn;
+  uint8_t buf[16];
+  uint64_t val;
+
+  TEST_CHECK (!fiid_template_field_index (tmpl_cmd_get_device_id_rs, "device_id", &index_device_id));
+  TEST_CHECK (!fiid_template_field_index (tmpl_cmd_get_device_id_rs, "manufacturer_id.id", &index_manufacturer_id));
+  TEST_CHECK (!fiid_template_field_index (tmpl_lan_session_hdr, "session_id", &index_session_id));
+  TEST_CHECK (fiid_template_field_index (tmpl_cmd_get_device_id_rs, "no_such_field", &index) < 0);
+  TEST_CHECK (fiid_template_field_index (tmpl_cmd_get_device_id_rs, "device_id", NULL) < 0);
+
+  TEST_REQUIRE ((obj = fiid_obj_create (tmpl_cmd_get_device_id_rs)));
+  TEST_REQUIRE ((obj_other = fiid_obj_create (tmpl_rmcpplus_session_hdr)));
+
+  TEST_CHECK (!fiid_obj_get_by_index (obj, index_device_id, &val));
+  TEST_CHECK (FIID_OBJ_GET_BY_INDEX (obj, index_device_id, &val) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_DATA_NOT_AVAILABLE);
+
+  TEST_CHECK (!fiid_obj_set_by_index (obj, index_device_id, 0x42));
+  TEST_CHECK (fiid_obj_get (obj, "device_id", &val) == 1 && val == 0x42);
+  TEST_CHECK (FIID_OBJ_GET_BY_INDEX (obj, index_device_id, &val) == 1 && val == 0x42);
+
+  TEST_CHECK (!fiid_obj_set (obj, "manufacturer_id.id", 0x0157));
+  TEST_CHECK (fiid_obj_get_by_index (obj, index_manufacturer_id, &val) == 1 && val == 0x0157);
+
+  /* an index resolved against another template is rejected, even
+   * though its position is in range for this object.
+   */
+  TEST_CHECK (fiid_obj_set_by_index (obj, index_session_id, 1) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_PARAMETERS);
+  TEST_CHECK (fiid_obj_get_by_index (obj, index_session_id, &val) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_PARAMETERS);
+  TEST_CHECK (fiid_obj_get_data_by_index (obj, index_session_id, buf, sizeof (buf)) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_PARAMETERS);
+  TEST_CHECK (fiid_obj_set_data_by_index (obj, index_session_id, buf, 4) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_PARAMETERS);
+  TEST_CHECK (fiid_obj_set_by_index (obj_other, index_device_id, 1) < 0
+              && fiid_obj_errnum (obj_other) == FIID_ERR_PARAMETERS);
+
+  /* an object created from a copy of the template is accepted */
+  TEST_REQUIRE ((tmpl = fiid_obj_template (obj)));
+  TEST_REQUIRE ((obj_dyn = fiid_obj_create (tmpl)));
+  TEST_CHECK (!fiid_obj_set_by_index (obj_dyn, index_device_id, 0x24));
+  TEST_CHECK (fiid_obj_get (obj_dyn, "device_id", &val) == 1 && val == 0x24);
+  TEST_CHECK (fiid_obj_get_by_index (obj_dyn, index_manufacturer_id, &val) == 0);
+  fiid_obj_destroy (obj_dyn);
+  fiid_template_free (tmpl);
+
+  /* an out of range position is rejected */
+  index = index_device_id;
+  index.index = 0xffff;
+  TEST_CHECK (fiid_obj_set_by_index (obj, index, 1) < 0
+              && fiid_obj_errnum (obj) == FIID_ERR_PARAMETERS);
+
+  /* data accessors */
+  TEST_CHECK (!fiid_template_field_index (tmpl_rmcpplus_session_hdr, "session_id", &index));
+  memcpy (buf, "\x11\x22\x33\x44", 4);
+  TEST_CHECK (fiid_obj_set_data_by_index (obj_other, index, buf, 4) == 4);
+  TEST_CHECK (fiid_obj_get (obj_other, "session_id", &val) == 1 && val == 0x44332211);
+  memset (buf, '\0', sizeof (buf));
+  TEST_CHECK (fiid_obj_get_data_by_index (obj_other, index, buf, sizeof (buf)) == 4);
+  TEST_CHECK (!memcmp (buf, "\x11\x22\x33\x44", 4));
+
+  fiid_obj_destroy (obj_other);
+  fiid_obj_destroy (obj);
+}
+
+/* The LAN and RMCP+ fill, assemble and unassemble functions access
+ * their headers and trailers by index.  Round trip a packet through
+ * them and check every field came back.
+ */
+static void
+test_lan_packet (void)
+{
+  fiid_obj_t obj_rmcp_hdr, obj_session_hdr, obj_msg_hdr_rq, obj_msg_hdr_rs;
+  fiid_obj_t obj_cmd_rq, obj_cmd_rs, obj_msg_trlr;
+  uint8_t pkt[TEST_PKT_LEN];
+  uint8_t authcode[IPMI_1_5_MAX_PASSWORD_LENGTH];
+  uint64_t val;
+  int len;
+
+  TEST_REQUIRE ((obj_rmcp_hdr = fiid_obj_create (tmpl_rmcp_hdr)));
+  TEST_REQUIRE ((obj_session_hdr = fiid_obj_create (tmpl_lan_session_hdr)));
+  TEST_REQUIRE ((obj_msg_hdr_rq = fiid_obj_create (tmpl_lan_msg_hdr_rq)));
+  TEST_REQUIRE ((obj_msg_hdr_rs = fiid_obj_create (tmpl_lan_msg_hdr_rs)));
+  TEST_REQUIRE ((obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_msg_trlr = fiid_obj_create (tmpl_lan_msg_trlr)));
+
+  TEST_REQUIRE (!fill_rmcp_hdr_ipmi (obj_rmcp_hdr));
+  TEST_REQUIRE (!fill_lan_session_hdr (IPMI_AUTHENTICATION_TYPE_MD5,
+                                       0x11223344,
+                                       0x55667788,
+                                       obj_session_hdr));
+  TEST_REQUIRE (!fill_lan_msg_hdr (IPMI_SLAVE_ADDRESS_BMC,
+                                   IPMI_NET_FN_APP_RQ,
+                                   IPMI_BMC_IPMB_LUN_BMC,
+                                   5,
+                                   obj_msg_hdr_rq));
+  TEST_REQUIRE (!fill_cmd_get_device_id (obj_cmd_rq));
+
+  TEST_CHECK (fiid_obj_get (obj_msg_hdr_rq, "rq_seq", &val) == 1 && val == 5);
+  TEST_CHECK (fiid_obj_get (obj_msg_hdr_rq, "checksum1", &val) == 1
+              && val == (uint8_t)(0 - IPMI_SLAVE_ADDRESS_BMC - (IPMI_NET_FN_APP_RQ << 2)));
+
+  len = assemble_ipmi_lan_pkt (obj_rmcp_hdr,
+                               obj_session_hdr,
+                               obj_msg_hdr_rq,
+                               obj_cmd_rq,
+                               "password",
+                               8,
+                               pkt,
+                               TEST_PKT_LEN,
+                               IPMI_INTERFACE_FLAGS_DEFAULT);
+  /* rmcp 4, session header 26, message header 5, cmd 1, trailer 1 */
+  TEST_REQUIRE (len == 37);
+  TEST_CHECK (pkt[4] == IPMI_AUTHENTICATION_TYPE_MD5);
+  TEST_CHECK (!memcmp (&pkt[5], "\x44\x33\x22\x11\x88\x77\x66\x55", 8));
+  TEST_CHECK (pkt[29] == 7);
+  TEST_CHECK (pkt[35] == IPMI_CMD_GET_DEVICE_ID);
+
+  TEST_CHECK (ipmi_lan_check_packet_session_authentication_code (pkt,
+                                                                 len,
+                                                                 IPMI_AUTHENTICATION_TYPE_MD5,
+                                                                 "password",
+                                                                 8) == 1);
+  TEST_CHECK (!ipmi_lan_check_packet_session_authentication_code (pkt,
+                                                                  len,
+                                                                  IPMI_AUTHENTICATION_TYPE_MD5,
+                                                                  "wrong",
+                                                                  5));
+
+  fiid_obj_clear (obj_session_hdr);
+  TEST_CHECK (unassemble_ipmi_lan_pkt (pkt,
+                                       len,
+                                       obj_rmcp_hdr,
+                                       obj_session_hdr,
+                                       obj_msg_hdr_rs,
+                                       obj_cmd_rs,
+                                       obj_msg_trlr,
+                                       IPMI_INTERFACE_FLAGS_DEFAULT) == 1);
+
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "authentication_type", &val) == 1
+              && val == IPMI_AUTHENTICATION_TYPE_MD5);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "session_sequence_number", &val) == 1
+              && val == 0x11223344);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "session_id", &val) == 1
+              && val == 0x55667788);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "ipmi_msg_len", &val) == 1 && val == 7);
+  TEST_CHECK (fiid_obj_get_data (obj_session_hdr,
+                                 "authentication_code",
+                                 authcode,
+                                 sizeof (authcode)) == IPMI_1_5_MAX_PASSWORD_LENGTH);
+  TEST_CHECK (!memcmp (authcode, &pkt[13], IPMI_1_5_MAX_PASSWORD_LENGTH));
+  TEST_CHECK (fiid_obj_get (obj_cmd_rs, "cmd", &val) == 1 && val == IPMI_CMD_GET_DEVICE_ID);
+
+  /* no authentication, the session header has no authentication code */
+  TEST_REQUIRE (!fill_lan_session_hdr (IPMI_AUTHENTICATION_TYPE_NONE,
+                                       0,
+                                       0,
+                                       obj_session_hdr));
+  len = assemble_ipmi_lan_pkt (obj_rmcp_hdr,
+                               obj_session_hdr,
+                               obj_msg_hdr_rq,
+                               obj_cmd_rq,
+                               NULL,
+                               0,
+                               pkt,
+                               TEST_PKT_LEN,
+                               IPMI_INTERFACE_FLAGS_DEFAULT);
+  TEST_CHECK (len == 21);
+
+  fiid_obj_destroy (obj_rmcp_hdr);
+  fiid_obj_destroy (obj_session_hdr);
+  fiid_obj_destroy (obj_msg_hdr_rq);
+  fiid_obj_destroy (obj_msg_hdr_rs);
+  fiid_obj_destroy (obj_cmd_rq);
+  fiid_obj_destroy (obj_cmd_rs);
+  fiid_obj_destroy (obj_msg_trlr);
+}
+
+/* The LAN functions took objects built from any template with the
+ * same contents before they accessed fields by index, and still do.
+ */
+static void
+test_lan_packet_template_copy (void)
+{
+  static fiid_field_t tmpl_msg_hdr_rq[32];
+  fiid_field_t *tmpl_session_hdr;
+  fiid_obj_t obj_rmcp_hdr, obj_session_hdr, obj_msg_hdr_rq, obj_msg_hdr_rs;
+  fiid_obj_t obj_cmd_rq, obj_cmd_rs, obj_msg_trlr, obj_tmp;
+  uint8_t pkt[TEST_PKT_LEN];
+  uint64_t val;
+  unsigned int i;
+  int len;
+
+  /* a caller's own copy, and one from fiid_obj_template() */
+  for (i = 0; tmpl_lan_msg_hdr_rq[i].max_field_len; i++)
+    {
+      TEST_REQUIRE (i < 31);
+      tmpl_msg_hdr_rq[i] = tmpl_lan_msg_hdr_rq[i];
+    }
+  memset (&tmpl_msg_hdr_rq[i], '\0', sizeof (fiid_field_t));
+
+  TEST_REQUIRE ((obj_tmp = fiid_obj_create (tmpl_lan_session_hdr)));
+  TEST_REQUIRE ((tmpl_session_hdr = fiid_obj_template (obj_tmp)));
+  fiid_obj_destroy (obj_tmp);
+
+  TEST_REQUIRE ((obj_rmcp_hdr = fiid_obj_create (tmpl_rmcp_hdr)));
+  TEST_REQUIRE ((obj_session_hdr = fiid_obj_create (tmpl_session_hdr)));
+  TEST_REQUIRE ((obj_msg_hdr_rq = fiid_obj_create (tmpl_msg_hdr_rq)));
+  TEST_REQUIRE ((obj_msg_hdr_rs = fiid_obj_create (tmpl_lan_msg_hdr_rs)));
+  TEST_REQUIRE ((obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_msg_trlr = fiid_obj_create (tmpl_lan_msg_trlr)));
+
+  TEST_REQUIRE (!fill_rmcp_hdr_ipmi (obj_rmcp_hdr));
+  TEST_CHECK (!fill_lan_session_hdr (IPMI_AUTHENTICATION_TYPE_NONE,
+                                     0x11223344,
+                                     0x55667788,
+                                     obj_session_hdr));
+  TEST_CHECK (!fill_lan_msg_hdr (IPMI_SLAVE_ADDRESS_BMC,
+                                 IPMI_NET_FN_APP_RQ,
+                                 IPMI_BMC_IPMB_LUN_BMC,
+                                 9,
+                                 obj_msg_hdr_rq));
+  TEST_REQUIRE (!fill_cmd_get_device_id (obj_cmd_rq));
+
+  len = assemble_ipmi_lan_pkt (obj_rmcp_hdr,
+                               obj_session_hdr,
+                               obj_msg_hdr_rq,
+                               obj_cmd_rq,
+                               NULL,
+                               0,
+                               pkt,
+                               TEST_PKT_LEN,
+                               IPMI_INTERFACE_FLAGS_DEFAULT);
+  TEST_CHECK (len == 21);
+
+  fiid_obj_clear (obj_session_hdr);
+  TEST_CHECK (unassemble_ipmi_lan_pkt (pkt,
+                                       len,
+                                       obj_rmcp_hdr,
+                                       obj_session_hdr,
+                                       obj_msg_hdr_rs,
+                                       obj_cmd_rs,
+                                       obj_msg_trlr,
+                                       IPMI_INTERFACE_FLAGS_DEFAULT) == 1);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "session_id", &val) == 1
+              && val == 0x55667788);
+  TEST_CHECK (fiid_obj_get (obj_msg_hdr_rs, "rq_seq", &val) == 1 && val == 9);
+
+  fiid_obj_destroy (obj_rmcp_hdr);
+  fiid_obj_destroy (obj_session_hdr);
+  fiid_obj_destroy (obj_msg_hdr_rq);
+  fiid_obj_destroy (obj_msg_hdr_rs);
+  fiid_obj_destroy (obj_cmd_rq);
+  fiid_obj_destroy (obj_cmd_rs);
+  fiid_obj_destroy (obj_msg_trlr);
+  fiid_template_free (tmpl_session_hdr);
+}
+
+static void
+test_rmcpplus_packet_one (uint8_t confidentiality_algorithm)
+{
+  fiid_obj_t obj_rmcp_hdr, obj_session_hdr, obj_session_trlr, obj_payload;
+  fiid_obj_t obj_msg_hdr_rq, obj_msg_hdr_rs, obj_msg_trlr;
+  fiid_obj_t obj_cmd_rq, obj_cmd_rs;
+  uint8_t pkt[TEST_PKT_LEN];
+  uint8_t integrity_key[TEST_INTEGRITY_KEY_LEN];
+  uint8_t confidentiality_key[TEST_CONFIDENTIALITY_KEY_LEN];
+  uint8_t payload_encrypted;
+  uint64_t val;
+  int len;
+
+  payload_encrypted = (confidentiality_algorithm != IPMI_CONFIDENTIALITY_ALGORITHM_NONE);
+  memset (integrity_key, 0x07, sizeof (integrity_key));
+  memset (confidentiality_key, 0x0b, sizeof (confidentiality_key));
+
+  TEST_REQUIRE ((obj_rmcp_hdr = fiid_obj_create (tmpl_rmcp_hdr)));
+  TEST_REQUIRE ((obj_session_hdr = fiid_obj_create (tmpl_rmcpplus_session_hdr)));
+  TEST_REQUIRE ((obj_session_trlr = fiid_obj_create (tmpl_rmcpplus_session_trlr)));
+  TEST_REQUIRE ((obj_payload = fiid_obj_create (tmpl_rmcpplus_payload)));
+  TEST_REQUIRE ((obj_msg_hdr_rq = fiid_obj_create (tmpl_lan_msg_hdr_rq)));
+  TEST_REQUIRE ((obj_msg_hdr_rs = fiid_obj_create (tmpl_lan_msg_hdr_rs)));
+  TEST_REQUIRE ((obj_msg_trlr = fiid_obj_create (tmpl_lan_msg_trlr)));
+  TEST_REQUIRE ((obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+
+  TEST_REQUIRE (!fill_rmcp_hdr_ipmi (obj_rmcp_hdr));
+  TEST_REQUIRE (!fill_rmcpplus_session_hdr (IPMI_PAYLOAD_TYPE_IPMI,
+                                            IPMI_PAYLOAD_FLAG_AUTHENTICATED,
+                                            payload_encrypted,
+                                            0,
+                                            0,
+                                            0xaabbccdd,
+                                            3,
+                                            obj_session_hdr));
+  TEST_REQUIRE (!fill_rmcpplus_session_trlr (obj_session_trlr));
+  TEST_REQUIRE (!fill_lan_msg_hdr (IPMI_SLAVE_ADDRESS_BMC,
+                                   IPMI_NET_FN_APP_RQ,
+                                   IPMI_BMC_IPMB_LUN_BMC,
+                                   9,
+                                   obj_msg_hdr_rq));
+  TEST_REQUIRE (!fill_cmd_get_device_id (obj_cmd_rq));
+
+  len = assemble_ipmi_rmcpplus_pkt (IPMI_AUTHENTICATION_ALGORITHM_RAKP_HMAC_SHA1,
+                                    IPMI_INTEGRITY_ALGORITHM_HMAC_SHA1_96,
+                                    confidentiality_algorithm,
+                                    integrity_key,
+                                    TEST_INTEGRITY_KEY_LEN,
+                                    confidentiality_key,
+                                    TEST_CONFIDENTIALITY_KEY_LEN,
+                                    NULL,
+                                    0,
+                                    obj_rmcp_hdr,
+                                    obj_session_hdr,
+                                    obj_msg_hdr_rq,
+                                    obj_cmd_rq,
+                                    obj_session_trlr,
+                                    pkt,
+                                    TEST_PKT_LEN,
+                                    IPMI_INTERFACE_FLAGS_DEFAULT);
+  TEST_REQUIRE (len > 0);
+  TEST_CHECK (pkt[4] == IPMI_AUTHENTICATION_TYPE_RMCPPLUS);
+  TEST_CHECK ((pkt[5] & 0x3f) == IPMI_PAYLOAD_TYPE_IPMI);
+  TEST_CHECK (((pkt[5] >> 6) & 0x1) == IPMI_PAYLOAD_FLAG_AUTHENTICATED);
+  TEST_CHECK (((pkt[5] >> 7) & 0x1) == payload_encrypted);
+  TEST_CHECK (!memcmp (&pkt[6], "\xdd\xcc\xbb\xaa\x03\x00\x00\x00", 8));
+  /* the session trailer is padded to a multiple of 4 bytes */
+  TEST_CHECK (!((len - 4) % 4));
+
+  TEST_CHECK (unassemble_ipmi_rmcpplus_pkt (IPMI_AUTHENTICATION_ALGORITHM_RAKP_HMAC_SHA1,
+                                            IPMI_INTEGRITY_ALGORITHM_HMAC_SHA1_96,
+                                            confidentiality_algorithm,
+                                            integrity_key,
+                                            TEST_INTEGRITY_KEY_LEN,
+                                            confidentiality_key,
+                                            TEST_CONFIDENTIALITY_KEY_LEN,
+                                            pkt,
+                                            len,
+                                            obj_rmcp_hdr,
+                                            obj_session_hdr,
+                                            obj_payload,
+                                            obj_msg_hdr_rs,
+                                            obj_cmd_rs,
+                                            obj_msg_trlr,
+                                            obj_session_trlr,
+                                            IPMI_INTERFACE_FLAGS_DEFAULT) == 1);
+
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "payload_type", &val) == 1
+              && val == IPMI_PAYLOAD_TYPE_IPMI);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "payload_type.authenticated", &val) == 1
+              && val == IPMI_PAYLOAD_FLAG_AUTHENTICATED);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "payload_type.encrypted", &val) == 1
+              && val == payload_encrypted);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "session_id", &val) == 1
+              && val == 0xaabbccdd);
+  TEST_CHECK (fiid_obj_get (obj_session_hdr, "session_sequence_number", &val) == 1
+              && val == 3);
+  TEST_CHECK (fiid_obj_get (obj_session_trlr, "next_header", &val) == 1
+              && val == IPMI_NEXT_HEADER);
+  TEST_CHECK (fiid_obj_get (obj_session_trlr, "pad_length", &val) == 1);
+  TEST_CHECK (ipmi_rmcpplus_check_packet_session_authentication_code (IPMI_INTEGRITY_ALGORITHM_HMAC_SHA1_96,
+                                                                      pkt,
+                                                                      len,
+                                                                      integrity_key,
+                                                                      TEST_INTEGRITY_KEY_LEN,
+                                                                      NULL,
+                                                                      0,
+                                                                      obj_session_trlr) == 1);
+  TEST_CHECK (fiid_obj_field_len_bytes (obj_session_trlr, "authentication_code") == IPMI_HMAC_SHA1_96_AUTHENTICATION_CODE_LENGTH);
+  if (payload_encrypted)
+    TEST_CHECK (fiid_obj_field_len_bytes (obj_payload, "confidentiality_header") == TEST_AES_CBC_128_IV_LEN);
+  TEST_CHECK (fiid_obj_get (obj_msg_hdr_rs, "rq_seq", &val) == 1 && val == 9);
+  TEST_CHECK (fiid_obj_get (obj_cmd_rs, "cmd", &val) == 1 && val == IPMI_CMD_GET_DEVICE_ID);
+
+  fiid_obj_destroy (obj_rmcp_hdr);
+  fiid_obj_destroy (obj_session_hdr);
+  fiid_obj_destroy (obj_session_trlr);
+  fiid_obj_destroy (obj_payload);
+  fiid_obj_destroy (obj_msg_hdr_rq);
+  fiid_obj_destroy (obj_msg_hdr_rs);
+  fiid_obj_destroy (obj_msg_trlr);
+  fiid_obj_destroy (obj_cmd_rq);
+  fiid_obj_destroy (obj_cmd_rs);
+}
+
+static void
+test_rmcpplus_packet (void)
+{
+  TEST_REQUIRE (!ipmi_rmcpplus_init ());
+
+  test_rmcpplus_packet_one (IPMI_CONFIDENTIALITY_ALGORITHM_NONE);
+  test_rmcpplus_packet_one (IPMI_CONFIDENTIALITY_ALGORITHM_AES_CBC_128);
+}
+
+#define TEST_ARENA_OBJS 50
+
+static void
+test_arena (void)
+{
+  fiid_arena_t arena;
+  fiid_obj_t objs[TEST_ARENA_OBJS];
+  fiid_obj_t obj, obj_dup;
+  uint64_t val;
+  unsigned int round, i;
+
+  TEST_REQUIRE ((arena = fiid_arena_create (0)));
+  fiid_arena_destroy (arena);
+
+  TEST_CHECK (!fiid_obj_create_in_arena (NULL, tmpl_cmd_get_sdr_rs));
+  TEST_CHECK (fiid_arena_reset (NULL) < 0);
+
+  /* start small, so the arena has to grow */
+  TEST_REQUIRE ((arena = fiid_arena_create (64)));
+  TEST_CHECK (!fiid_obj_create_in_arena (arena, NULL));
+
+  for (round = 0; round < 4; round++)
+    {
+      for (i = 0; i < TEST_ARENA_OBJS; i++)
+        {
+          TEST_REQUIRE ((objs[i] = fiid_obj_create_in_arena (arena, tmpl_cmd_get_sdr_rs)));
+
+          /* memory re-used from an earlier round starts out clear */
+          TEST_CHECK (!fiid_obj_get (objs[i], "cmd", &val));
+          TEST_CHECK (!fiid_obj_set (objs[i], "cmd", i));
+          TEST_CHECK (fiid_obj_set_data (objs[i], "record_data", "\x01\x02\x03\x04", 4) == 4);
+        }
+
+      for (i = 0; i < TEST_ARENA_OBJS; i++)
+        TEST_CHECK (fiid_obj_get (objs[i], "cmd", &val) == 1 && val == i);
+
+      /* a duplicate is a heap object that outlives the arena */
+      TEST_REQUIRE ((obj_dup = fiid_obj_dup (objs[3])));
+
+      switch (round)
+        {
+        case 0:
+          /* out of order, memory is made available once empty */
+          for (i = 0; i < TEST_ARENA_OBJS; i += 2)
+            fiid_obj_destroy (objs[i]);
+          for (i = 1; i < TEST_ARENA_OBJS; i += 2)
+            fiid_obj_destroy (objs[i]);
+          break;
+        case 1:
+          /* reverse order, memory is reclaimed as objects go */
+          for (i = TEST_ARENA_OBJS; i > 1; i--)
+            fiid_obj_destroy (objs[i - 1]);
+          TEST_REQUIRE ((obj = fiid_obj_create_in_arena (arena, tmpl_cmd_get_sdr_rs)));
+          TEST_CHECK (obj == objs[1]);
+          fiid_obj_destroy (obj);
+          fiid_obj_destroy (objs[0]);
+          break;
+        default:
+          /* some destroyed, the rest reset */
+          for (i = 0; i < TEST_ARENA_OBJS; i += 3)
+            fiid_obj_destroy (objs[i]);
+          TEST_CHECK (!fiid_arena_reset (arena));
+          break;
+        }
+
+      TEST_CHECK (fiid_obj_get (obj_dup, "cmd", &val) == 1 && val == 3);
+      fiid_obj_destroy (obj_dup);
+    }
+
+  /* objects of different templates mix in one arena */
+  TEST_REQUIRE ((objs[0] = fiid_obj_create_in_arena (arena, tmpl_sdr_full_sensor_record)));
+  TEST_REQUIRE ((objs[1] = fiid_obj_create_in_arena (arena, tmpl_sdr_record_header)));
+  TEST_CHECK (!fiid_obj_set (objs[0], "sensor_number", 0x33));
+  TEST_CHECK (!fiid_obj_set (objs[1], "record_id", 0x1234));
+  TEST_CHECK (fiid_obj_get (objs[0], "sensor_number", &val) == 1 && val == 0x33);
+  TEST_CHECK (fiid_obj_get (objs[1], "record_id", &val) == 1 && val == 0x1234);
+
+  /* destroying the arena destroys objects still in it */
+  fiid_arena_destroy (arena);
+}
+
+int
+main (int argc, char **argv)
+{
+  test_layout_lookup ();
+  test_layout_dynamic ();
+  test_layout_reused_address ();
+  test_layout_duplicate_keys ();
+  test_field_index ();
+  test_lan_packet ();
+  test_lan_packet_template_copy ();
+  test_rmcpplus_packet ();
+  test_arena ();
+
+  return (TEST_EXIT ());
+}
@@ -0,0 +1,523 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_HOSTS                    32
+
+#define TEST_OUTPUT_LEN               16384
+
+/* generous, a run normally takes well under a second */
+#define TEST_OUTPUT_TIMEOUT           20000
+
+#define TEST_NET_FN_APP               0x06
+#define TEST_NET_FN_CHASSIS           0x00
+
+#define TEST_CMD_GET_CHANNEL_AUTHENTICATION_CAPABILITIES 0x38
+#define TEST_CMD_CLOSE_SESSION        0x3c
+#define TEST_CMD_GET_CHASSIS_STATUS   0x01
+
+/* ipmipower run against fake BMCs, on stdin and stdout pipes so
+ * interactive mode can be driven one command at a time.
+ */
+struct ipmipower
+{
+  pid_t pid;
+  int in;
+  int out;
+  char output[TEST_OUTPUT_LEN];
+  unsigned int output_len;
+};
+
+static fakebmc_t bmcs[TEST_HOSTS];
+
+static char hosts[TEST_HOSTS * 32];
+
+static void
+_hosts_init (unsigned int count)
+{
+  unsigned int i;
+
+  TEST_REQUIRE (count <= TEST_HOSTS);
+
+  hosts[0] = '\0';
+  for (i = 0; i < count; i++)
+    {
+      if (i)
+        strcat (hosts, ",");
+      strcat (hosts, fakebmc_hostname (bmcs[i]));
+    }
+}
+
+static void
+_ipmipower_start (struct ipmipower *p, const char *args[])
+{
+  const char *argv[32];
+  unsigned int argc = 0;
+  int in[2], out[2];
+
+  memset (p, '\0', sizeof (struct ipmipower));
+
+  argv[argc++] = TEST_IPMIPOWER;
+  argv[argc++] = "--config-file=/dev/null";
+  argv[argc++] = "--driver-type=LAN_2_0";
+  argv[argc++] = "--cipher-suite-id=0";
+  argv[argc++] = "--ping-interval=0";
+  argv[argc++] = "--session-timeout=5000";
+  argv[argc++] = "--retransmission-timeout=100";
+  argv[argc++] = "-h";
+  argv[argc++] = hosts;
+  while (*args)
+    {
+      TEST_REQUIRE (argc < 31);
+      argv[argc++] = *args++;
+    }
+  argv[argc] = NULL;
+
+  TEST_REQUIRE (!pipe (in));
+  TEST_REQUIRE (!pipe (out));
+  TEST_REQUIRE ((p->pid = fork ()) >= 0);
+
+  if (!p->pid)
+    {
+      dup2 (in[0], STDIN_FILENO);
+      dup2 (out[1], STDOUT_FILENO);
+      dup2 (out[1], STDERR_FILENO);
+      close (in[0]);
+      close (in[1]);
+      close (out[0]);
+      close (out[1]);
+      execv (argv[0], (char * const *)argv);
+      _exit (127);
+    }
+
+  close (in[0]);
+  close (out[1]);
+  p->in = in[1];
+  p->out = out[0];
+}
+
+static unsigned int
+_output_count (struct ipmipower *p, const char *str)
+{
+  const char *ptr = p->output;
+  unsigned int count = 0;
+
+  while ((ptr = strstr (ptr, str)))
+    {
+      count++;
+      ptr += strlen (str);
+    }
+
+  return (count);
+}
+
+/* Read output until 'str' appears 'count' times in all of it, or
+ * until end of file.  Returns 0 on success, -1 if not.
+ */
+static int
+_ipmipower_read (struct ipmipower *p, const char *str, unsigned int count)
+{
+  while (!str || _output_count (p, str) < count)
+    {
+      struct pollfd pfd;
+      ssize_t len;
+
+      pfd.fd = p->out;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll (&pfd, 1, TEST_OUTPUT_TIMEOUT) <= 0)
+        return (-1);
+
+      TEST_REQUIRE (p->output_len < TEST_OUTPUT_LEN - 1);
+      if ((len = read (p->out,
+                       p->output + p->output_len,
+                       TEST_OUTPUT_LEN - 1 - p->output_len)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return (-1);
+        }
+      if (!len)
+        break;
+
+      p->output_len += len;
+      p->output[p->output_len] = '\0';
+    }
+
+  return (str ? 0 : -1);
+}
+
+/* Run an interactive mode command, returns as _ipmipower_read().
+ * The command line is written at once, ipmipower may run a partial
+ * line it reads as a command.
+ */
+static int
+_ipmipower_command (struct ipmipower *p, const char *cmd, const char *str, unsigned int count)
+{
+  char buf[64];
+
+  snprintf (buf, sizeof (buf), "%s\n", cmd);
+  TEST_REQUIRE (write (p->in, buf, strlen (buf)) == strlen (buf));
+  return (_ipmipower_read (p, str, count + _output_count (p, str)));
+}
+
+/* Returns the exit status */
+static int
+_ipmipower_finish (struct ipmipower *p)
+{
+  int status;
+
+  /* ignored outside interactive mode */
+  write (p->in, "quit\n", 5);
+  close (p->in);
+  _ipmipower_read (p, NULL, 0);
+  close (p->out);
+
+  if (waitpid (p->pid, &status, 0) < 0)
+    return (-1);
+
+  if (!WIFEXITED (status))
+    return (-1);
+
+  return (WEXITSTATUS (status));
+}
+
+static void
+_reset_counts (unsigned int count)
+{
+  unsigned int i;
+
+  for (i = 0; i < count; i++)
+    fakebmc_reset_counts (bmcs[i]);
+}
+
+/* Sessions set up on each host */
+static unsigned int
+_sessions (unsigned int host)
+{
+  return (fakebmc_count (bmcs[host],
+                         TEST_NET_FN_APP,
+                         TEST_CMD_GET_CHANNEL_AUTHENTICATION_CAPABILITIES));
+}
+
+static unsigned int
+_closes (unsigned int host)
+{
+  return (fakebmc_count (bmcs[host], TEST_NET_FN_APP, TEST_CMD_CLOSE_SESSION));
+}
+
+static unsigned int
+_status (unsigned int host)
+{
+  return (fakebmc_count (bmcs[host], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS));
+}
+
+/* Power status of every host, one session each */
+static void
+_run_status (unsigned int count, const char *args[])
+{
+  struct ipmipower p;
+  unsigned int failures = test_failures;
+  unsigned int i, bad = 0;
+
+  _hosts_init (count);
+  _reset_counts (count);
+
+  _ipmipower_start (&p, args);
+  TEST_CHECK (!_ipmipower_read (&p, ": on\n", count));
+  TEST_CHECK (!_ipmipower_finish (&p));
+  TEST_CHECK (_output_count (&p, ": on\n") == count);
+
+  for (i = 0; i < count; i++)
+    {
+      if (_sessions (i) != 1 || _status (i) < 1 || _closes (i) < 1)
+        bad++;
+    }
+  TEST_CHECK (!bad);
+
+  if (test_failures != failures)
+    fprintf (stderr, "%s", p.output);
+}
+
+static void
+test_status (void)
+{
+  const char *args[] = { "--stat", NULL };
+
+  _run_status (TEST_HOSTS, args);
+}
+
+/* Lost responses are retransmitted */
+static void
+test_status_lost (void)
+{
+  const char *args[] = { "--stat", NULL };
+  unsigned int i;
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 2);
+
+  _run_status (TEST_HOSTS, args);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 0);
+}
+
+/* All hosts on a few sockets */
+static void
+test_shared_sockets (void)
+{
+  const char *args[] = { "--stat", "--shared-sockets", NULL };
+
+  _run_status (TEST_HOSTS, args);
+}
+
+/* Retransmissions go out in the same send batch as first sends */
+static void
+test_shared_sockets_lost (void)
+{
+  const char *args[] = { "--stat", "--shared-sockets", NULL };
+  unsigned int i;
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 2);
+
+  _run_status (TEST_HOSTS, args);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 0);
+}
+
+static void
+test_threads (void)
+{
+  const char *args[] = { "--stat", "--threads=4", NULL };
+  const char *args_many[] = { "--stat", "--threads=64", NULL };
+
+  _run_status (TEST_HOSTS, args);
+  /* more threads than hosts */
+  _run_status (TEST_HOSTS / 4, args_many);
+}
+
+/* The window shrinks on loss but every host completes */
+static void
+test_session_window (void)
+{
+  const char *args[] = { "--stat", "--session-window=4", NULL };
+  const char *args_threads[] = { "--stat", "--session-window=4", "--threads=2", NULL };
+  unsigned int i;
+
+  _run_status (TEST_HOSTS, args);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 2);
+
+  _run_status (TEST_HOSTS, args);
+  _run_status (TEST_HOSTS, args_threads);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_set_drop (bmcs[i], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 0);
+}
+
+/* 50 session starts per second with a burst of 5, the rest of the
+ * hosts wait their turn
+ */
+static void
+test_session_rate (void)
+{
+  const char *args[] = { "--stat", "--session-rate=50", NULL };
+  struct timeval begin, end, result;
+  unsigned int ms;
+
+  TEST_REQUIRE (!gettimeofday (&begin, NULL));
+  _run_status (TEST_HOSTS, args);
+  TEST_REQUIRE (!gettimeofday (&end, NULL));
+
+  timersub (&end, &begin, &result);
+  ms = result.tv_sec * 1000 + result.tv_usec / 1000;
+  TEST_CHECK (ms >= ((TEST_HOSTS - 5 - 1) * 1000 / 50) * 3 / 4);
+}
+
+/* Without --reuse-sessions every command sets up its own session */
+static void
+test_interactive (void)
+{
+  const char *args[] = { NULL };
+  struct ipmipower p;
+
+  _hosts_init (1);
+  _reset_counts (1);
+
+  _ipmipower_start (&p, args);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (!_ipmipower_finish (&p));
+
+  TEST_CHECK (_sessions (0) == 3);
+  TEST_CHECK (_closes (0) == 3);
+}
+
+/* One session serves every command, it is closed on exit */
+static void
+test_reuse (void)
+{
+  const char *args[] = { "--reuse-sessions", NULL };
+  struct ipmipower p;
+  unsigned int i, bad = 0;
+
+  _hosts_init (4);
+  _reset_counts (4);
+
+  _ipmipower_start (&p, args);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 4));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 4));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 4));
+
+  for (i = 0; i < 4; i++)
+    {
+      if (_sessions (i) != 1 || _status (i) != 3 || _closes (i))
+        bad++;
+    }
+  TEST_CHECK (!bad);
+
+  TEST_CHECK (!_ipmipower_finish (&p));
+
+  for (i = 0; i < 4; i++)
+    {
+      if (_closes (i) != 1)
+        bad++;
+    }
+  TEST_CHECK (!bad);
+}
+
+/* A reused session does not wait for a session start under
+ * --session-rate
+ */
+static void
+test_reuse_session_rate (void)
+{
+  const char *args[] = { "--reuse-sessions", "--session-rate=1", NULL };
+  struct timeval begin, end, result;
+  struct ipmipower p;
+
+  _hosts_init (1);
+  _reset_counts (1);
+
+  _ipmipower_start (&p, args);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+
+  TEST_REQUIRE (!gettimeofday (&begin, NULL));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_REQUIRE (!gettimeofday (&end, NULL));
+
+  TEST_CHECK (!_ipmipower_finish (&p));
+  TEST_CHECK (_sessions (0) == 1);
+
+  timersub (&end, &begin, &result);
+  TEST_CHECK (!result.tv_sec && result.tv_usec < 500000);
+}
+
+/* A reused session the BMC has dropped is replaced by a new session
+ * without an error.  A session that does not answer at all still
+ * times out.
+ */
+static void
+test_reuse_restart (void)
+{
+  const char *args[] = { "--reuse-sessions", NULL };
+  struct ipmipower p;
+
+  _hosts_init (1);
+  _reset_counts (1);
+
+  _ipmipower_start (&p, args);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (_sessions (0) == 1);
+
+  fakebmc_close_sessions (bmcs[0]);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (_sessions (0) == 2);
+
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": on\n", 1));
+  TEST_CHECK (_sessions (0) == 2);
+
+  /* restarted once only */
+  fakebmc_set_drop (bmcs[0], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 1);
+  TEST_CHECK (!_ipmipower_command (&p, "stat", ": session timeout\n", 1));
+  TEST_CHECK (_sessions (0) == 3);
+  fakebmc_set_drop (bmcs[0], TEST_NET_FN_CHASSIS, TEST_CMD_GET_CHASSIS_STATUS, 0);
+
+  /* the timeout is an error */
+  TEST_CHECK (_ipmipower_finish (&p) == EXIT_FAILURE);
+  TEST_CHECK (_output_count (&p, ": on\n") == 3);
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int i;
+
+  if (access (TEST_IPMIPOWER, X_OK) < 0)
+    return (TEST_EXIT_SKIP);
+
+  signal (SIGPIPE, SIG_IGN);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    TEST_REQUIRE ((bmcs[i] = fakebmc_start ()));
+
+  test_status ();
+  test_status_lost ();
+  test_shared_sockets ();
+  test_shared_sockets_lost ();
+  test_threads ();
+  test_session_window ();
+  test_session_rate ();
+  test_interactive ();
+  test_reuse ();
+  test_reuse_session_rate ();
+  test_reuse_restart ();
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    fakebmc_stop (bmcs[i]);
+
+  return (TEST_EXIT ());
+}
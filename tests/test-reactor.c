@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   100
+
+#define TEST_HOSTS                    8
+
+#define TEST_CMDS                     16
+
+/* Get Sensor Reading commands queued on one context.  The fake BMC
+ * returns the sensor number as the reading, so each response can be
+ * matched to its request.
+ */
+struct host;
+
+struct cmd
+{
+  struct host *host;
+  unsigned int index;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+};
+
+struct host
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  ipmi_ctx_t ctx;
+  struct cmd cmds[TEST_CMDS];
+  uint8_t first;
+  unsigned int count;
+  /* queue the next command from each callback after this many */
+  unsigned int chain_after;
+  unsigned int queued;
+  unsigned int completed;
+  unsigned int out_of_order;
+  unsigned int mismatched;
+  int errnum;
+};
+
+static fakebmc_t bmc;
+
+static int
+_queue (struct host *h);
+
+static void
+_callback (ipmi_ctx_t ctx, int errnum, fiid_obj_t obj_cmd_rs, void *data)
+{
+  struct cmd *c = data;
+  struct host *h = c->host;
+  uint64_t val;
+
+  TEST_CHECK (ctx == h->ctx);
+  TEST_CHECK (obj_cmd_rs == c->obj_cmd_rs);
+
+  if (c->index != h->completed)
+    h->out_of_order++;
+  h->completed++;
+  h->errnum = errnum;
+  if (errnum != IPMI_ERR_SUCCESS)
+    return;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "sensor_reading", &val) < 0
+      || val != h->first + c->index)
+    h->mismatched++;
+
+  if (h->queued >= h->chain_after && h->queued < h->count)
+    TEST_CHECK (!_queue (h));
+}
+
+static int
+_queue (struct host *h)
+{
+  struct cmd *c = &h->cmds[h->queued];
+
+  if (fill_cmd_get_sensor_reading (h->first + h->queued, c->obj_cmd_rq) < 0)
+    return (-1);
+
+  h->queued++;
+
+  if (ipmi_reactor_cmd (h->reactor_ctx,
+                        h->ctx,
+                        IPMI_BMC_IPMB_LUN_BMC,
+                        IPMI_NET_FN_SENSOR_EVENT_RQ,
+                        c->obj_cmd_rq,
+                        c->obj_cmd_rs,
+                        _callback,
+                        c) < 0)
+    return (-1);
+
+  return (0);
+}
+
+static void
+_host_init (struct host *h,
+            ipmi_reactor_ctx_t reactor_ctx,
+            ipmi_ctx_t ctx,
+            uint8_t first,
+            unsigned int count,
+            unsigned int chain_after)
+{
+  unsigned int i;
+
+  memset (h, '\0', sizeof (struct host));
+  h->reactor_ctx = reactor_ctx;
+  h->ctx = ctx;
+  h->first = first;
+  h->count = count;
+  h->chain_after = chain_after;
+  for (i = 0; i < count; i++)
+    {
+      h->cmds[i].host = h;
+      h->cmds[i].index = i;
+      TEST_REQUIRE ((h->cmds[i].obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)));
+      TEST_REQUIRE ((h->cmds[i].obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)));
+    }
+
+  while (h->queued < chain_after && h->queued < count)
+    TEST_REQUIRE (!_queue (h));
+  if (!chain_after)
+    TEST_REQUIRE (!_queue (h));
+}
+
+static void
+_host_cleanup (struct host *h)
+{
+  unsigned int i;
+
+  for (i = 0; i < h->count; i++)
+    {
+      fiid_obj_destroy (h->cmds[i].obj_cmd_rq);
+      fiid_obj_destroy (h->cmds[i].obj_cmd_rs);
+    }
+}
+
+static void
+_check_host (struct host *h)
+{
+  TEST_CHECK (h->queued == h->count);
+  TEST_CHECK (h->completed == h->count);
+  TEST_CHECK (h->errnum == IPMI_ERR_SUCCESS);
+  TEST_CHECK (!h->out_of_order);
+  TEST_CHECK (!h->mismatched);
+}
+
+static void
+test_errors (ipmi_ctx_t ctx)
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  ipmi_ctx_t closed;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+
+  TEST_REQUIRE ((reactor_ctx = ipmi_reactor_ctx_create ()));
+  TEST_REQUIRE ((closed = ipmi_ctx_create ()));
+  TEST_REQUIRE ((obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)));
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)));
+  TEST_REQUIRE (fill_cmd_get_sensor_reading (1, obj_cmd_rq) >= 0);
+
+  /* nothing queued, nothing to wait for */
+  TEST_CHECK (!ipmi_reactor_run (reactor_ctx));
+
+  TEST_CHECK (ipmi_reactor_add (reactor_ctx, closed) < 0
+              && ipmi_reactor_ctx_errnum (reactor_ctx) == IPMI_REACTOR_ERR_IPMI_ERROR);
+
+  TEST_CHECK (ipmi_reactor_cmd (reactor_ctx,
+                                ctx,
+                                IPMI_BMC_IPMB_LUN_BMC,
+                                IPMI_NET_FN_SENSOR_EVENT_RQ,
+                                obj_cmd_rq,
+                                obj_cmd_rs,
+                                _callback,
+                                NULL) < 0
+              && ipmi_reactor_ctx_errnum (reactor_ctx) == IPMI_REACTOR_ERR_NOT_FOUND);
+
+  TEST_CHECK (!ipmi_reactor_add (reactor_ctx, ctx));
+  TEST_CHECK (ipmi_reactor_add (reactor_ctx, ctx) < 0
+              && ipmi_reactor_ctx_errnum (reactor_ctx) == IPMI_REACTOR_ERR_ALREADY_ADDED);
+
+  TEST_CHECK (ipmi_reactor_cmd (reactor_ctx,
+                                ctx,
+                                IPMI_BMC_IPMB_LUN_BMC,
+                                IPMI_NET_FN_SENSOR_EVENT_RQ,
+                                obj_cmd_rq,
+                                obj_cmd_rs,
+                                NULL,
+                                NULL) < 0
+              && ipmi_reactor_ctx_errnum (reactor_ctx) == IPMI_REACTOR_ERR_PARAMETERS);
+
+  TEST_CHECK (ipmi_reactor_run (NULL) < 0);
+
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  ipmi_ctx_destroy (closed);
+  fiid_obj_destroy (obj_cmd_rq);
+  fiid_obj_destroy (obj_cmd_rs);
+}
+
+/* Commands queued together on one context are sent one at a time
+ * and complete in order
+ */
+static void
+test_queue (ipmi_ctx_t ctx)
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  struct host h;
+
+  TEST_REQUIRE ((reactor_ctx = ipmi_reactor_ctx_create ()));
+  TEST_REQUIRE (!ipmi_reactor_add (reactor_ctx, ctx));
+  fakebmc_reset_counts (bmc);
+
+  _host_init (&h, reactor_ctx, ctx, 1, TEST_CMDS, TEST_CMDS);
+  TEST_CHECK (!h.completed);
+  TEST_CHECK (!ipmi_reactor_run (reactor_ctx));
+  _check_host (&h);
+
+  TEST_CHECK (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) == TEST_CMDS);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) == 1);
+
+  /* the context is usable on its own again */
+  TEST_CHECK (!ipmi_cmd (ctx,
+                         IPMI_BMC_IPMB_LUN_BMC,
+                         IPMI_NET_FN_SENSOR_EVENT_RQ,
+                         h.cmds[0].obj_cmd_rq,
+                         h.cmds[0].obj_cmd_rs));
+
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  _host_cleanup (&h);
+}
+
+/* Many contexts at once, commands queued up front and from
+ * callbacks, with responses delayed, lost and arriving after the
+ * retransmission
+ */
+static void
+test_many (ipmi_ctx_t *ctxs)
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  struct host hosts[TEST_HOSTS];
+  unsigned int i;
+
+  TEST_REQUIRE ((reactor_ctx = ipmi_reactor_ctx_create ()));
+  for (i = 0; i < TEST_HOSTS; i++)
+    TEST_REQUIRE (!ipmi_reactor_add (reactor_ctx, ctxs[i]));
+
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_delay (bmc, 0, 20);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 7);
+  fakebmc_set_late (bmc,
+                    IPMI_NET_FN_SENSOR_EVENT_RQ,
+                    IPMI_CMD_GET_SENSOR_READING,
+                    5,
+                    TEST_RETRANSMISSION_TIMEOUT * 3 / 2);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    _host_init (&hosts[i], reactor_ctx, ctxs[i], i * TEST_CMDS, TEST_CMDS, i);
+
+  TEST_CHECK (!ipmi_reactor_run (reactor_ctx));
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    _check_host (&hosts[i]);
+
+  /* the lost and late requests were retransmitted */
+  TEST_CHECK (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) > TEST_HOSTS * TEST_CMDS);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) > 1);
+
+  fakebmc_set_delay (bmc, 0, 0);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+  fakebmc_set_late (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0, 0);
+
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  for (i = 0; i < TEST_HOSTS; i++)
+    _host_cleanup (&hosts[i]);
+}
+
+/* A BMC that stops answering fails every queued command through its
+ * callback, and the reactor still returns
+ */
+static void
+test_timeout (void)
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  struct host h;
+  ipmi_ctx_t ctx;
+
+  TEST_REQUIRE ((ctx = fakebmc_ctx_open (bmc, 1000, TEST_RETRANSMISSION_TIMEOUT)));
+  TEST_REQUIRE ((reactor_ctx = ipmi_reactor_ctx_create ()));
+  TEST_REQUIRE (!ipmi_reactor_add (reactor_ctx, ctx));
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 1);
+  _host_init (&h, reactor_ctx, ctx, 1, 2, 2);
+  TEST_CHECK (!ipmi_reactor_run (reactor_ctx));
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+
+  TEST_CHECK (h.completed == 2);
+  TEST_CHECK (!h.out_of_order);
+  TEST_CHECK (h.errnum != IPMI_ERR_SUCCESS);
+
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  _host_cleanup (&h);
+  ipmi_ctx_close (ctx);
+  ipmi_ctx_destroy (ctx);
+}
+
+/* Session-less IPMI 1.5 contexts, as ipmi-raw --no-session uses */
+static void
+test_nosession (void)
+{
+  ipmi_reactor_ctx_t reactor_ctx;
+  ipmi_ctx_t ctxs[TEST_HOSTS];
+  fiid_obj_t obj_cmd_rq[TEST_HOSTS];
+  fiid_obj_t obj_cmd_rs[TEST_HOSTS];
+  struct host hosts[TEST_HOSTS];
+  unsigned int i;
+
+  TEST_REQUIRE ((reactor_ctx = ipmi_reactor_ctx_create ()));
+
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_delay (bmc, 0, 20);
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    {
+      /* only ctx is looked at by the callback */
+      memset (&hosts[i], '\0', sizeof (struct host));
+      hosts[i].ctx = ctxs[i] = ipmi_ctx_create ();
+      hosts[i].count = 1;
+      hosts[i].queued = 1;
+      hosts[i].cmds[0].host = &hosts[i];
+      TEST_REQUIRE (ctxs[i]);
+      TEST_REQUIRE (!ipmi_ctx_open_outofband (ctxs[i],
+                                              fakebmc_hostname (bmc),
+                                              NULL,
+                                              NULL,
+                                              IPMI_AUTHENTICATION_TYPE_NONE,
+                                              IPMI_PRIVILEGE_LEVEL_USER,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT,
+                                              0,
+                                              IPMI_FLAGS_NOSESSION));
+      TEST_REQUIRE (!ipmi_reactor_add (reactor_ctx, ctxs[i]));
+
+      TEST_REQUIRE ((obj_cmd_rq[i] = fiid_obj_create (tmpl_cmd_get_channel_authentication_capabilities_rq)));
+      TEST_REQUIRE ((obj_cmd_rs[i] = fiid_obj_create (tmpl_cmd_get_channel_authentication_capabilities_rs)));
+      TEST_REQUIRE (fill_cmd_get_channel_authentication_capabilities (IPMI_CHANNEL_NUMBER_CURRENT_CHANNEL,
+                                                                      IPMI_PRIVILEGE_LEVEL_USER,
+                                                                      IPMI_GET_IPMI_V20_EXTENDED_DATA,
+                                                                      obj_cmd_rq[i]) >= 0);
+      hosts[i].cmds[0].obj_cmd_rs = obj_cmd_rs[i];
+      TEST_REQUIRE (!ipmi_reactor_cmd (reactor_ctx,
+                                       ctxs[i],
+                                       IPMI_BMC_IPMB_LUN_BMC,
+                                       IPMI_NET_FN_APP_RQ,
+                                       obj_cmd_rq[i],
+                                       obj_cmd_rs[i],
+                                       _callback,
+                                       &hosts[i].cmds[0]));
+    }
+
+  TEST_CHECK (!ipmi_reactor_run (reactor_ctx));
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    {
+      TEST_CHECK (hosts[i].completed == 1);
+      TEST_CHECK (hosts[i].errnum == IPMI_ERR_SUCCESS);
+      TEST_CHECK (ipmi_check_completion_code_success (obj_cmd_rs[i]) == 1);
+    }
+
+  TEST_CHECK (fakebmc_count (bmc, IPMI_NET_FN_APP_RQ, IPMI_CMD_GET_CHANNEL_AUTHENTICATION_CAPABILITIES) == TEST_HOSTS);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_APP_RQ, IPMI_CMD_GET_CHANNEL_AUTHENTICATION_CAPABILITIES) > 1);
+
+  fakebmc_set_delay (bmc, 0, 0);
+
+  ipmi_reactor_ctx_destroy (reactor_ctx);
+  for (i = 0; i < TEST_HOSTS; i++)
+    {
+      fiid_obj_destroy (obj_cmd_rq[i]);
+      fiid_obj_destroy (obj_cmd_rs[i]);
+      ipmi_ctx_close (ctxs[i]);
+      ipmi_ctx_destroy (ctxs[i]);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  ipmi_ctx_t ctxs[TEST_HOSTS];
+  unsigned int i;
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  for (i = 0; i < TEST_HOSTS; i++)
+    TEST_REQUIRE ((ctxs[i] = fakebmc_ctx_open (bmc,
+                                               TEST_SESSION_TIMEOUT,
+                                               TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_errors (ctxs[0]);
+  test_queue (ctxs[0]);
+  test_many (ctxs);
+  test_timeout ();
+  test_nosession ();
+
+  for (i = 0; i < TEST_HOSTS; i++)
+    {
+      ipmi_ctx_close (ctxs[i]);
+      ipmi_ctx_destroy (ctxs[i]);
+    }
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          20000
+
+/* far above the round trip to the fake BMC */
+#define TEST_RETRANSMISSION_TIMEOUT   2000
+#define TEST_DELAY                    50
+
+static fakebmc_t bmc;
+
+static unsigned int
+_count (void)
+{
+  return (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING));
+}
+
+/* Get Sensor Reading commands one at a time, returns the elapsed
+ * milliseconds.  The fake BMC returns the sensor number as the
+ * reading.
+ */
+static unsigned int
+_readings (ipmi_ctx_t ctx, unsigned int count)
+{
+  struct timeval begin, end, result;
+  fiid_obj_t obj_cmd_rs;
+  unsigned int mismatched = 0;
+  unsigned int i;
+  uint64_t val;
+
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)));
+
+  TEST_REQUIRE (!gettimeofday (&begin, NULL));
+  for (i = 0; i < count; i++)
+    {
+      if (ipmi_cmd_get_sensor_reading (ctx, i, obj_cmd_rs) < 0
+          || FIID_OBJ_GET (obj_cmd_rs, "sensor_reading", &val) < 0
+          || val != i)
+        mismatched++;
+    }
+  TEST_REQUIRE (!gettimeofday (&end, NULL));
+
+  TEST_CHECK (!mismatched);
+  fiid_obj_destroy (obj_cmd_rs);
+
+  timersub (&end, &begin, &result);
+  return (result.tv_sec * 1000 + result.tv_usec / 1000);
+}
+
+/* The retransmission timeout follows the measured round trip time,
+ * so lost requests are retransmitted long before the configured
+ * retransmission timeout.
+ */
+static void
+test_adaptive (ipmi_ctx_t ctx)
+{
+  unsigned int ms;
+
+  fakebmc_set_delay (bmc, TEST_DELAY, TEST_DELAY);
+
+  /* measure the round trip time */
+  _readings (ctx, 20);
+
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 5);
+  ms = _readings (ctx, 10);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+
+  /* the 2 lost requests were retransmitted once, and sooner than the
+   * configured retransmission timeout
+   */
+  TEST_CHECK (_count () == 12);
+  TEST_CHECK (ms < TEST_RETRANSMISSION_TIMEOUT);
+
+  fakebmc_set_delay (bmc, 0, 0);
+}
+
+int
+main (int argc, char **argv)
+{
+  ipmi_ctx_t ctx;
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  TEST_REQUIRE ((ctx = fakebmc_ctx_open (bmc,
+                                         TEST_SESSION_TIMEOUT,
+                                         TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_adaptive (ctx);
+
+  ipmi_ctx_close (ctx);
+  ipmi_ctx_destroy (ctx);
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}
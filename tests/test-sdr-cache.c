@@ -0,0 +1,734 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+#include "sdr-records.h"
+#include "sdr-cache-fixtures.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   250
+
+#define TEST_FILENAME_LEN             256
+#define TEST_FILE_LEN                 8192
+
+/* not a record id in sdr-records */
+#define TEST_RECORD_ID_ABSENT         0x0FF
+
+static fakebmc_t bmc;
+static ipmi_ctx_t ipmi_ctx;
+static char dir[TEST_FILENAME_LEN];
+
+static void
+_filename (char *buf, const char *name)
+{
+  snprintf (buf, TEST_FILENAME_LEN, "%s/%s", dir, name);
+}
+
+static int
+_file_read (const char *filename, uint8_t *buf, unsigned int buflen)
+{
+  int fd, len;
+
+  if ((fd = open (filename, O_RDONLY)) < 0)
+    return (-1);
+  len = read (fd, buf, buflen);
+  close (fd);
+  return (len);
+}
+
+static int
+_file_write (const char *filename, const uint8_t *buf, unsigned int buflen)
+{
+  int fd, len;
+
+  if ((fd = open (filename, O_CREAT | O_TRUNC | O_WRONLY, 0644)) < 0)
+    return (-1);
+  len = write (fd, buf, buflen);
+  close (fd);
+  return (len == (int)buflen ? 0 : -1);
+}
+
+static void
+_bmc_load (unsigned int count, unsigned int generation)
+{
+  struct sdr_record records[SDR_RECORDS_MAX];
+  unsigned int i;
+
+  sdr_records_build (count, generation, records);
+
+  fakebmc_clear_sdr (bmc);
+  for (i = 0; i < count; i++)
+    TEST_REQUIRE (!fakebmc_add_sdr (bmc, records[i].data, records[i].len));
+}
+
+static int
+_create (const char *filename, int cache_create_flags)
+{
+  ipmi_sdr_ctx_t ctx;
+  int rv;
+
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+  if ((rv = ipmi_sdr_cache_create (ctx, ipmi_ctx, filename, cache_create_flags, NULL, NULL)) < 0)
+    fprintf (stderr, "ipmi_sdr_cache_create: %s\n", ipmi_sdr_ctx_errormsg (ctx));
+  ipmi_sdr_ctx_destroy (ctx);
+  return (rv);
+}
+
+static int
+_record_matches (ipmi_sdr_ctx_t ctx, const struct sdr_record *record)
+{
+  uint8_t buf[IPMI_SDR_MAX_RECORD_LENGTH];
+  int len;
+
+  if ((len = ipmi_sdr_cache_record_read (ctx, buf, IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+    return (0);
+
+  return (len == (int)record->len && !memcmp (buf, record->data, len));
+}
+
+/* Every way of reaching a record must agree with the records the
+ * cache was created from.
+ */
+static void
+_check_cache (const char *filename,
+              unsigned int flags,
+              unsigned int count,
+              unsigned int generation)
+{
+  struct sdr_record records[SDR_RECORDS_MAX];
+  ipmi_sdr_ctx_t ctx;
+  uint16_t record_count;
+  unsigned int i;
+
+  sdr_records_build (count, generation, records);
+
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+  TEST_REQUIRE (!ipmi_sdr_ctx_set_flags (ctx, flags));
+
+  if (ipmi_sdr_cache_open (ctx, NULL, filename) < 0)
+    {
+      fprintf (stderr, "ipmi_sdr_cache_open: %s: %s\n", filename, ipmi_sdr_ctx_errormsg (ctx));
+      test_failures++;
+      ipmi_sdr_ctx_destroy (ctx);
+      return;
+    }
+
+  TEST_CHECK (!ipmi_sdr_cache_record_count (ctx, &record_count) && record_count == count);
+
+  /* walk */
+  TEST_CHECK (!ipmi_sdr_cache_first (ctx));
+  for (i = 0; i < count; i++)
+    {
+      TEST_CHECK (_record_matches (ctx, &records[i]));
+      TEST_CHECK (ipmi_sdr_cache_next (ctx) == (i + 1 < count ? 1 : 0));
+    }
+
+  /* seek, backwards so the iterator really moves */
+  for (i = count; i > 0; i--)
+    {
+      TEST_CHECK (!ipmi_sdr_cache_seek (ctx, i - 1));
+      TEST_CHECK (_record_matches (ctx, &records[i - 1]));
+    }
+  TEST_CHECK (ipmi_sdr_cache_seek (ctx, count) < 0);
+
+  /* record ids */
+  for (i = 0; i < count; i++)
+    {
+      TEST_CHECK (!ipmi_sdr_cache_search_record_id (ctx, records[i].record_id));
+      TEST_CHECK (_record_matches (ctx, &records[i]));
+    }
+  TEST_CHECK (ipmi_sdr_cache_search_record_id (ctx, TEST_RECORD_ID_ABSENT) < 0
+              && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_NOT_FOUND);
+
+  /* every sensor number, including shared, duplicate and absent ones */
+  for (i = 0; i <= 0xFF; i++)
+    {
+      int expected = sdr_records_search_sensor (records, count, i);
+      int rv = ipmi_sdr_cache_search_sensor (ctx, i, SDR_RECORDS_OWNER_ID);
+
+      if (expected < 0)
+        TEST_CHECK (rv < 0 && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_NOT_FOUND);
+      else
+        TEST_CHECK (!rv && _record_matches (ctx, &records[expected]));
+
+      /* owner id is part of the key */
+      TEST_CHECK (ipmi_sdr_cache_search_sensor (ctx, i, SDR_RECORDS_OWNER_ID + 2) < 0);
+    }
+
+  /* iterator still usable after searches */
+  TEST_CHECK (!ipmi_sdr_cache_first (ctx));
+  TEST_CHECK (_record_matches (ctx, &records[0]));
+
+  TEST_CHECK (!ipmi_sdr_cache_close (ctx));
+  ipmi_sdr_ctx_destroy (ctx);
+}
+
+static void
+test_create (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  uint8_t buf[TEST_FILE_LEN];
+  int len;
+
+  _filename (filename, "create");
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+
+  TEST_REQUIRE (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT));
+
+  /* written as version 1.4 */
+  TEST_REQUIRE ((len = _file_read (filename, buf, TEST_FILE_LEN)) > 8);
+  TEST_CHECK (buf[4] == 0x00 && buf[5] == 0x01 && buf[6] == 0x00 && buf[7] == 0x04);
+
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_INDEX, SDR_RECORDS_COUNT, 0);
+
+  /* existing cache is not overwritten without the flag */
+  {
+    ipmi_sdr_ctx_t ctx;
+
+    TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+    TEST_CHECK (ipmi_sdr_cache_create (ctx, ipmi_ctx, filename, 0, NULL, NULL) < 0
+                && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_CACHE_CREATE_CACHE_EXISTS);
+    ipmi_sdr_ctx_destroy (ctx);
+  }
+
+  /* pipelined creation yields the same records */
+  _filename (filename, "create-pipeline");
+  TEST_REQUIRE (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+}
+
+static unsigned int
+_get_sdr_requests (void)
+{
+  return (fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR));
+}
+
+/* Pipelined creation copes with responses returned out of order,
+ * lost, or so late the request was already retransmitted
+ */
+static void
+test_pipeline_lost (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  unsigned int requests;
+
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+
+  _filename (filename, "pipeline");
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE));
+  requests = _get_sdr_requests ();
+
+  _filename (filename, "pipeline-reordered");
+  fakebmc_set_delay (bmc, 0, 10);
+  TEST_CHECK (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE));
+  fakebmc_set_delay (bmc, 0, 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  _filename (filename, "pipeline-lost");
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR, 7);
+  TEST_CHECK (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE));
+  fakebmc_set_drop (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR, 0);
+  TEST_CHECK (_get_sdr_requests () > requests);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  _filename (filename, "pipeline-late");
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_late (bmc,
+                    IPMI_NET_FN_STORAGE_RQ,
+                    IPMI_CMD_GET_SDR,
+                    5,
+                    TEST_RETRANSMISSION_TIMEOUT * 2);
+  TEST_CHECK (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE));
+  fakebmc_set_late (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR, 0, 0);
+  TEST_CHECK (_get_sdr_requests () > requests);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+}
+
+/* Caches written by earlier releases must still be readable */
+static void
+test_old_formats (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  ipmi_sdr_ctx_t ctx;
+
+  _filename (filename, "fixture-1.2");
+  TEST_REQUIRE (!_file_write (filename, sdr_cache_fixture_1_2, sizeof (sdr_cache_fixture_1_2)));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_INDEX, SDR_RECORDS_COUNT, 0);
+
+  _filename (filename, "fixture-1.3");
+  TEST_REQUIRE (!_file_write (filename, sdr_cache_fixture_1_3, sizeof (sdr_cache_fixture_1_3)));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_INDEX, SDR_RECORDS_COUNT, 0);
+
+  /* a corrupt index is rejected, not followed */
+  {
+    uint8_t buf[sizeof (sdr_cache_fixture_1_3)];
+
+    memcpy (buf, sdr_cache_fixture_1_3, sizeof (buf));
+    /* index start offset is just before the trailer, keep the
+     * trailer checksum valid so only the index is wrong
+     */
+    buf[sizeof (buf) - 9] += 1;
+    buf[sizeof (buf) - 1] -= 1;
+    _filename (filename, "fixture-1.3-corrupt");
+    TEST_REQUIRE (!_file_write (filename, buf, sizeof (buf)));
+
+    TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+    TEST_CHECK (ipmi_sdr_cache_open (ctx, NULL, filename) < 0
+                && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_CACHE_INVALID);
+    ipmi_sdr_ctx_destroy (ctx);
+  }
+}
+
+/* The in memory index is only built at open, and reopening the same
+ * context must rebuild it rather than reuse the previous cache's.
+ */
+static void
+test_memory_index (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  char filename_old[TEST_FILENAME_LEN];
+  ipmi_sdr_ctx_t ctx;
+  uint8_t buf[IPMI_SDR_MAX_RECORD_LENGTH];
+  struct sdr_record record;
+  unsigned int i;
+
+  _filename (filename, "create");
+  _filename (filename_old, "fixture-1.2");
+
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+
+  /* flag set while a cache is open takes effect on the next open */
+  TEST_REQUIRE (!ipmi_sdr_cache_open (ctx, NULL, filename_old));
+  TEST_CHECK (!ipmi_sdr_ctx_set_flags (ctx, IPMI_SDR_FLAGS_CACHE_INDEX));
+  sdr_records_build_one (SDR_RECORDS_COUNT - 1, 0, &record);
+  TEST_CHECK (!ipmi_sdr_cache_search_record_id (ctx, record.record_id));
+  TEST_CHECK (ipmi_sdr_cache_record_read (ctx, buf, sizeof (buf)) == (int)record.len);
+  TEST_CHECK (!ipmi_sdr_cache_close (ctx));
+
+  for (i = 0; i < 4; i++)
+    {
+      TEST_REQUIRE (!ipmi_sdr_cache_open (ctx, NULL, (i % 2) ? filename : filename_old));
+      TEST_CHECK (!ipmi_sdr_cache_seek (ctx, SDR_RECORDS_COUNT - 1));
+      TEST_CHECK (ipmi_sdr_cache_record_read (ctx, buf, sizeof (buf)) == (int)record.len
+                  && !memcmp (buf, record.data, record.len));
+      TEST_CHECK (!ipmi_sdr_cache_close (ctx));
+    }
+
+  ipmi_sdr_ctx_destroy (ctx);
+}
+
+#define TEST_READ_MAX                 20
+#define TEST_RECORD_HEADER_LENGTH     5
+
+/* read size hints sit before the total bytes (4) and checksum (1) */
+static int
+_read_size_hints (const char *filename,
+                  unsigned int *bytes_to_read,
+                  unsigned int *bytes_to_read_max)
+{
+  uint8_t buf[TEST_FILE_LEN];
+  int len;
+
+  if ((len = _file_read (filename, buf, TEST_FILE_LEN)) < 8 + 2 + 5)
+    return (-1);
+
+  *bytes_to_read = buf[len - 7];
+  *bytes_to_read_max = buf[len - 6];
+  return (0);
+}
+
+static void
+_test_read_size (int cache_create_flags)
+{
+  char filename[TEST_FILENAME_LEN];
+  unsigned int bytes_to_read, bytes_to_read_max;
+  unsigned int requests, requests_hinted;
+  uint8_t buf[TEST_FILE_LEN];
+  int len;
+
+  _filename (filename, "read-size");
+  unlink (filename);
+
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  fakebmc_set_sdr_read_max (bmc, TEST_READ_MAX);
+
+  /* without hints the read size has to be learned */
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags));
+  TEST_CHECK (fakebmc_sdr_read_rejected (bmc) > 0);
+  requests = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  TEST_REQUIRE (!_read_size_hints (filename, &bytes_to_read, &bytes_to_read_max));
+  TEST_CHECK (bytes_to_read_max <= TEST_READ_MAX);
+  TEST_CHECK (bytes_to_read_max >= TEST_RECORD_HEADER_LENGTH);
+  TEST_CHECK (bytes_to_read <= bytes_to_read_max);
+
+  /* recreating starts from the hints and is never rejected */
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE));
+  TEST_CHECK (!fakebmc_sdr_read_rejected (bmc));
+  requests_hinted = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+  TEST_CHECK (requests_hinted < requests);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  /* hints out of range are ignored */
+  TEST_REQUIRE ((len = _file_read (filename, buf, TEST_FILE_LEN)) > 0);
+  buf[len - 6] = 0xFF;
+  buf[len - 1] -= 0xFF - bytes_to_read_max;
+  TEST_REQUIRE (!_file_write (filename, buf, len));
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE));
+  TEST_CHECK (fakebmc_sdr_read_rejected (bmc) > 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  /* so are caches from releases without hints */
+  TEST_REQUIRE (!_file_write (filename, sdr_cache_fixture_1_3, sizeof (sdr_cache_fixture_1_3)));
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE));
+  TEST_CHECK (fakebmc_sdr_read_rejected (bmc) > 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  fakebmc_set_sdr_read_max (bmc, 0);
+}
+
+static void
+test_read_size (void)
+{
+  _test_read_size (IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT);
+  _test_read_size (IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE);
+}
+
+/* Generation 1 changes the length of every fifth record, and four
+ * records are added.
+ */
+#define TEST_INCREMENTAL_COUNT (SDR_RECORDS_COUNT + 4)
+
+static void
+_test_incremental (int cache_create_flags)
+{
+  char filename[TEST_FILENAME_LEN];
+  char filename_full[TEST_FILENAME_LEN];
+  unsigned int requests, requests_full;
+  ipmi_sdr_ctx_t ctx;
+
+  _filename (filename, "incremental");
+  _filename (filename_full, "incremental-full");
+  unlink (filename);
+
+  /* no previous cache, everything is downloaded */
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  /* Unchanged records cost one header read instead of a download,
+   * which only saves requests when records need several partial
+   * reads, as on most BMCs.
+   */
+  fakebmc_set_sdr_read_max (bmc, TEST_READ_MAX);
+
+  _bmc_load (TEST_INCREMENTAL_COUNT, 1);
+
+  unlink (filename_full);
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename_full, cache_create_flags));
+  requests_full = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL));
+  requests = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, TEST_INCREMENTAL_COUNT, 1);
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_INDEX, TEST_INCREMENTAL_COUNT, 1);
+  TEST_CHECK (requests < requests_full);
+
+  /* refreshed cache is up to date */
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+  TEST_CHECK (!ipmi_sdr_cache_open (ctx, ipmi_ctx, filename));
+  ipmi_sdr_ctx_destroy (ctx);
+
+  /* records removed from the BMC are dropped */
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  /* previous caches from older releases work too */
+  unlink (filename_full);
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename_full, cache_create_flags));
+  requests_full = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+
+  TEST_REQUIRE (!_file_write (filename, sdr_cache_fixture_1_2, sizeof (sdr_cache_fixture_1_2)));
+  fakebmc_reset_counts (bmc);
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL));
+  requests = fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SDR);
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+  TEST_CHECK (requests < requests_full);
+
+  /* a corrupt previous cache is ignored */
+  TEST_REQUIRE (!_file_write (filename, sdr_cache_fixture_1_2, sizeof (sdr_cache_fixture_1_2) / 2));
+  TEST_REQUIRE (!_create (filename, cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_INCREMENTAL));
+  _check_cache (filename, IPMI_SDR_FLAGS_DEFAULT, SDR_RECORDS_COUNT, 0);
+
+  fakebmc_set_sdr_read_max (bmc, 0);
+}
+
+static void
+test_incremental (void)
+{
+  _test_incremental (IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT);
+  _test_incremental (IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINE);
+}
+
+/* Number of mappings of filename in this process, -1 if unknown */
+static int
+_mappings_count (const char *filename)
+{
+  char line[PATH_MAX + 128];
+  char path[PATH_MAX];
+  unsigned int len;
+  int count = 0;
+  FILE *fp;
+
+  if (!realpath (filename, path))
+    return (-1);
+
+  if (!(fp = fopen ("/proc/self/maps", "r")))
+    return (-1);
+
+  len = strlen (path);
+  while (fgets (line, sizeof (line), fp))
+    {
+      char *ptr;
+
+      /* replaced files are listed as "path (deleted)" */
+      if ((ptr = strstr (line, path))
+          && (ptr[len] == '\n' || ptr[len] == '\0'))
+        count++;
+    }
+
+  fclose (fp);
+  return (count);
+}
+
+#define TEST_SHARED_CTXS 3
+
+static void
+test_shared (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  char filename_new[TEST_FILENAME_LEN];
+  ipmi_sdr_ctx_t ctxs[TEST_SHARED_CTXS];
+  ipmi_sdr_ctx_t ctx;
+  uint16_t record_count;
+  unsigned int i;
+
+  _filename (filename, "shared");
+  _filename (filename_new, "shared-new");
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  TEST_REQUIRE (!_create (filename, IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT));
+
+  if (_mappings_count (filename) < 0)
+    {
+      fprintf (stderr, "cannot count mappings, skipping shared cache tests\n");
+      return;
+    }
+
+  for (i = 0; i < TEST_SHARED_CTXS; i++)
+    {
+      TEST_REQUIRE ((ctxs[i] = ipmi_sdr_ctx_create ()));
+      TEST_REQUIRE (!ipmi_sdr_ctx_set_flags (ctxs[i], IPMI_SDR_FLAGS_CACHE_SHARED));
+      TEST_REQUIRE (!ipmi_sdr_cache_open (ctxs[i], NULL, filename));
+    }
+  TEST_CHECK (_mappings_count (filename) == 1);
+
+  /* contexts without the flag map privately */
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+  TEST_REQUIRE (!ipmi_sdr_cache_open (ctx, NULL, filename));
+  TEST_CHECK (_mappings_count (filename) == 2);
+  TEST_CHECK (!ipmi_sdr_cache_close (ctx));
+  TEST_CHECK (_mappings_count (filename) == 1);
+
+  /* mapping lives until the last sharer closes */
+  TEST_CHECK (!ipmi_sdr_cache_close (ctxs[0]));
+  TEST_CHECK (!ipmi_sdr_cache_close (ctxs[1]));
+  TEST_CHECK (_mappings_count (filename) == 1);
+  TEST_CHECK (!ipmi_sdr_cache_record_count (ctxs[2], &record_count)
+              && record_count == SDR_RECORDS_COUNT);
+
+  /* a cache replaced while open gets its own mapping, the old one
+   * stays valid for contexts still using it
+   */
+  _bmc_load (SDR_RECORDS_COUNT + 1, 0);
+  TEST_REQUIRE (!_create (filename_new, IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT));
+  TEST_REQUIRE (!rename (filename_new, filename));
+
+  TEST_CHECK (!ipmi_sdr_cache_open (ctxs[0], NULL, filename));
+  TEST_CHECK (!ipmi_sdr_cache_open (ctxs[1], NULL, filename));
+  TEST_CHECK (_mappings_count (filename) == 1);
+  TEST_CHECK (!ipmi_sdr_cache_record_count (ctxs[0], &record_count)
+              && record_count == SDR_RECORDS_COUNT + 1);
+  TEST_CHECK (!ipmi_sdr_cache_record_count (ctxs[2], &record_count)
+              && record_count == SDR_RECORDS_COUNT);
+  TEST_CHECK (!ipmi_sdr_cache_first (ctxs[2]));
+
+  for (i = 0; i < TEST_SHARED_CTXS; i++)
+    {
+      TEST_CHECK (!ipmi_sdr_cache_close (ctxs[i]));
+      ipmi_sdr_ctx_destroy (ctxs[i]);
+    }
+  TEST_CHECK (!_mappings_count (filename));
+
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_SHARED, SDR_RECORDS_COUNT + 1, 0);
+  _check_cache (filename, IPMI_SDR_FLAGS_CACHE_SHARED | IPMI_SDR_FLAGS_CACHE_INDEX, SDR_RECORDS_COUNT + 1, 0);
+  TEST_CHECK (!_mappings_count (filename));
+}
+
+static void
+test_cache_key (void)
+{
+  char key[IPMI_SDR_CACHE_KEY_BUFLEN];
+  char key_added[IPMI_SDR_CACHE_KEY_BUFLEN];
+  char key_cleared[IPMI_SDR_CACHE_KEY_BUFLEN];
+  unsigned int manufacturer_id, product_id, sdr_version, record_count;
+  unsigned int addition_timestamp, erase_timestamp;
+  unsigned int addition_timestamp_added, erase_timestamp_added;
+  ipmi_sdr_ctx_t ctx;
+  struct sdr_record record;
+
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  TEST_REQUIRE (!ipmi_sdr_cache_key (ctx, ipmi_ctx, key, IPMI_SDR_CACHE_KEY_BUFLEN));
+
+  /* usable as a filename component */
+  TEST_CHECK (!strchr (key, '/'));
+  TEST_CHECK (sscanf (key,
+                      "%5X.%4X.%2X.%4X.%8X.%8X",
+                      &manufacturer_id,
+                      &product_id,
+                      &sdr_version,
+                      &record_count,
+                      &addition_timestamp,
+                      &erase_timestamp) == 6);
+  TEST_CHECK (strlen (key) == 5 + 1 + 4 + 1 + 2 + 1 + 4 + 1 + 8 + 1 + 8);
+  TEST_CHECK (manufacturer_id == 0x157 && product_id == 0x1234);
+  TEST_CHECK (record_count == SDR_RECORDS_COUNT);
+
+  /* stable */
+  TEST_REQUIRE (!ipmi_sdr_cache_key (ctx, ipmi_ctx, key_added, IPMI_SDR_CACHE_KEY_BUFLEN));
+  TEST_CHECK (!strcmp (key, key_added));
+
+  /* an addition changes the count and addition timestamp */
+  sdr_records_build_one (SDR_RECORDS_COUNT, 0, &record);
+  TEST_REQUIRE (!fakebmc_add_sdr (bmc, record.data, record.len));
+  TEST_REQUIRE (!ipmi_sdr_cache_key (ctx, ipmi_ctx, key_added, IPMI_SDR_CACHE_KEY_BUFLEN));
+  TEST_CHECK (sscanf (key_added,
+                      "%*5X.%*4X.%*2X.%4X.%8X.%8X",
+                      &record_count,
+                      &addition_timestamp_added,
+                      &erase_timestamp_added) == 3);
+  TEST_CHECK (record_count == SDR_RECORDS_COUNT + 1);
+  TEST_CHECK (addition_timestamp_added != addition_timestamp);
+  TEST_CHECK (erase_timestamp_added == erase_timestamp);
+
+  /* the same records after an erase are a different repository */
+  _bmc_load (SDR_RECORDS_COUNT, 0);
+  TEST_REQUIRE (!ipmi_sdr_cache_key (ctx, ipmi_ctx, key_cleared, IPMI_SDR_CACHE_KEY_BUFLEN));
+  TEST_CHECK (strcmp (key, key_cleared) && strcmp (key_added, key_cleared));
+
+  TEST_CHECK (ipmi_sdr_cache_key (ctx, ipmi_ctx, key, 8) < 0
+              && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_OVERFLOW);
+
+  ipmi_sdr_ctx_destroy (ctx);
+}
+
+static void
+_cleanup (void)
+{
+  char filename[TEST_FILENAME_LEN];
+  struct dirent *dirent;
+  DIR *dirp;
+
+  if (!(dirp = opendir (dir)))
+    return;
+
+  while ((dirent = readdir (dirp)))
+    {
+      if (!strcmp (dirent->d_name, ".") || !strcmp (dirent->d_name, ".."))
+        continue;
+      _filename (filename, dirent->d_name);
+      unlink (filename);
+    }
+
+  closedir (dirp);
+  rmdir (dir);
+}
+
+int
+main (int argc, char **argv)
+{
+  snprintf (dir, TEST_FILENAME_LEN, "test-sdr-cache.XXXXXX");
+  TEST_REQUIRE (mkdtemp (dir));
+  /* also on TEST_REQUIRE failures */
+  atexit (_cleanup);
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_create ();
+  test_pipeline_lost ();
+  test_old_formats ();
+  test_memory_index ();
+  test_read_size ();
+  test_incremental ();
+  test_shared ();
+  test_cache_key ();
+
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}
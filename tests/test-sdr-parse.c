@@ -0,0 +1,630 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "sdr-records.h"
+
+TEST_DEFINE_FAILURES;
+
+/* random bodies decoded per record type */
+#define TEST_RANDOM_COUNT             200
+
+#define TEST_RECORD_HEADER_LENGTH     5
+#define TEST_SENSOR_NUMBER_INDEX      7
+#define TEST_FULL_EVENT_READING_TYPE_CODE 13
+
+/* offset of the id string type/length byte, see sdr-records.c */
+#define TEST_FULL_ID_STRING           47
+#define TEST_COMPACT_ID_STRING        31
+#define TEST_EVENT_ID_STRING          16
+
+#define TEST_RECORD_LEN_MAX           (TEST_FULL_ID_STRING + 1 + IPMI_SDR_MAX_ID_STRING_LENGTH + 8)
+
+static ipmi_sdr_ctx_t ctx;
+static unsigned int seed = 1;
+
+/* The sensor record accessors used to get every field from a fiid
+ * object filled with the record, the decoder must return the same
+ * values and fail on the same fields of a short record.
+ */
+static fiid_obj_t
+_fiid_record (const uint8_t *buf, unsigned int len)
+{
+  fiid_obj_t obj;
+
+  TEST_REQUIRE (len >= 4);
+
+  switch (buf[3])
+    {
+    case IPMI_SDR_FORMAT_FULL_SENSOR_RECORD:
+      TEST_REQUIRE ((obj = fiid_obj_create (tmpl_sdr_full_sensor_record)));
+      break;
+    case IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD:
+      TEST_REQUIRE ((obj = fiid_obj_create (tmpl_sdr_compact_sensor_record)));
+      break;
+    default:
+      TEST_REQUIRE (buf[3] == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD);
+      TEST_REQUIRE ((obj = fiid_obj_create (tmpl_sdr_event_only_record)));
+      break;
+    }
+
+  TEST_REQUIRE (fiid_obj_set_all (obj, buf, len) >= 0);
+  return (obj);
+}
+
+static void
+_check_field (fiid_obj_t obj,
+              const char *field,
+              int rv,
+              uint64_t value,
+              unsigned int len,
+              int line)
+{
+  uint64_t val = 0;
+  int ret;
+
+  ret = FIID_OBJ_GET (obj, field, &val);
+  if ((rv < 0) != (ret < 0)
+      || (rv >= 0 && value != val))
+    {
+      fprintf (stderr,
+               "%s:%d: check failed: %s in a %u byte record: accessor %d/%llu, fiid %d/%llu\n",
+               __FILE__,
+               line,
+               field,
+               len,
+               rv,
+               (unsigned long long)value,
+               ret,
+               (unsigned long long)val);
+      test_failures++;
+    }
+}
+
+#define TEST_CHECK_FIELD(__field, __rv, __value)                        \
+  _check_field (obj, (__field), (__rv), (__value), len, __LINE__)
+
+static uint8_t
+_unit (uint64_t val)
+{
+  if (!IPMI_SENSOR_UNIT_VALID (val))
+    return (IPMI_SENSOR_UNIT_UNSPECIFIED);
+  return (val);
+}
+
+static int16_t
+_m_b (uint64_t ls, uint64_t ms)
+{
+  int16_t val = ls | (ms << 8);
+
+  if (val & 0x200)
+    val |= 0xFE00;
+  return (val);
+}
+
+static int8_t
+_exponent (uint64_t val)
+{
+  int8_t exponent = val;
+
+  if (exponent & 0x08)
+    exponent |= 0xF0;
+  return (exponent);
+}
+
+/* fields of every sensor record type */
+static void
+_check_common (fiid_obj_t obj, const uint8_t *buf, unsigned int len)
+{
+  uint8_t a, b;
+  int rv;
+
+  a = b = 0;
+  rv = ipmi_sdr_parse_sensor_owner_id (ctx, buf, len, &a, NULL);
+  TEST_CHECK_FIELD ("sensor_owner_id.type", rv, a);
+  rv = ipmi_sdr_parse_sensor_owner_id (ctx, buf, len, NULL, &b);
+  TEST_CHECK_FIELD ("sensor_owner_id", rv, b);
+
+  rv = ipmi_sdr_parse_sensor_owner_lun (ctx, buf, len, &a, NULL);
+  TEST_CHECK_FIELD ("sensor_owner_lun", rv, a);
+  rv = ipmi_sdr_parse_sensor_owner_lun (ctx, buf, len, NULL, &b);
+  TEST_CHECK_FIELD ("channel_number", rv, b);
+
+  rv = ipmi_sdr_parse_sensor_number (ctx, buf, len, &a);
+  TEST_CHECK_FIELD ("sensor_number", rv, a);
+
+  rv = ipmi_sdr_parse_entity_id_instance_type (ctx, buf, len, &a, NULL, NULL);
+  TEST_CHECK_FIELD ("entity_id", rv, a);
+  rv = ipmi_sdr_parse_entity_id_instance_type (ctx, buf, len, NULL, &a, &b);
+  TEST_CHECK_FIELD ("entity_instance", rv, a);
+  TEST_CHECK_FIELD ("entity_instance.type", rv, b);
+
+  rv = ipmi_sdr_parse_sensor_type (ctx, buf, len, &a);
+  TEST_CHECK_FIELD ("sensor_type", rv, a);
+
+  rv = ipmi_sdr_parse_event_reading_type_code (ctx, buf, len, &a);
+  TEST_CHECK_FIELD ("event_reading_type_code", rv, a);
+}
+
+/* fields of full and compact records */
+static void
+_check_full_compact (fiid_obj_t obj, const uint8_t *buf, unsigned int len)
+{
+  uint8_t a, b, c;
+  int rv;
+
+  a = b = c = 0;
+  rv = ipmi_sdr_parse_sensor_units (ctx, buf, len, &a, &b, &c, NULL, NULL);
+  TEST_CHECK_FIELD ("sensor_unit1.percentage", rv, a);
+  TEST_CHECK_FIELD ("sensor_unit1.modifier_unit", rv, b);
+  TEST_CHECK_FIELD ("sensor_unit1.rate_unit", rv, c);
+
+  rv = ipmi_sdr_parse_sensor_units (ctx, buf, len, NULL, NULL, NULL, &a, NULL);
+  if (rv >= 0)
+    {
+      uint64_t val;
+
+      TEST_CHECK (FIID_OBJ_GET (obj, "sensor_unit2.base_unit", &val) >= 0
+                  && a == _unit (val));
+    }
+  else
+    TEST_CHECK_FIELD ("sensor_unit2.base_unit", rv, 0);
+
+  rv = ipmi_sdr_parse_sensor_units (ctx, buf, len, NULL, NULL, NULL, NULL, &a);
+  if (rv >= 0)
+    {
+      uint64_t val;
+
+      TEST_CHECK (FIID_OBJ_GET (obj, "sensor_unit3.modifier_unit", &val) >= 0
+                  && a == _unit (val));
+    }
+  else
+    TEST_CHECK_FIELD ("sensor_unit3.modifier_unit", rv, 0);
+
+  rv = ipmi_sdr_parse_sensor_capabilities (ctx, buf, len, &a, &b, &c, NULL, NULL);
+  TEST_CHECK_FIELD ("sensor_capabilities.event_message_control_support", rv, a);
+  TEST_CHECK_FIELD ("sensor_capabilities.threshold_access_support", rv, b);
+  TEST_CHECK_FIELD ("sensor_capabilities.hysteresis_support", rv, c);
+  rv = ipmi_sdr_parse_sensor_capabilities (ctx, buf, len, NULL, NULL, NULL, &a, &b);
+  TEST_CHECK_FIELD ("sensor_capabilities.auto_re_arm_support", rv, a);
+  TEST_CHECK_FIELD ("sensor_capabilities.entity_ignore_support", rv, b);
+
+  rv = ipmi_sdr_parse_sensor_direction (ctx, buf, len, &a);
+  TEST_CHECK_FIELD ("sensor_direction", rv, a);
+
+  rv = ipmi_sdr_parse_hysteresis (ctx, buf, len, &a, NULL);
+  TEST_CHECK_FIELD ("positive_going_threshold_hysteresis", rv, a);
+  rv = ipmi_sdr_parse_hysteresis (ctx, buf, len, NULL, &b);
+  TEST_CHECK_FIELD ("negative_going_threshold_hysteresis", rv, b);
+}
+
+/* fields only in full records */
+static void
+_check_full (fiid_obj_t obj, const uint8_t *buf, unsigned int len)
+{
+  uint8_t t[6];
+  uint8_t a, b, c;
+  int8_t r_exponent, b_exponent;
+  int16_t m, bb;
+  uint64_t ls, ms, val;
+  int rv;
+
+  memset (t, '\0', sizeof (t));
+  a = b = c = 0;
+
+  if (FIID_OBJ_GET (obj, "event_reading_type_code", &val) >= 0
+      && !IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (val))
+    {
+      TEST_CHECK (ipmi_sdr_parse_thresholds_raw (ctx, buf, len, &t[0], NULL, NULL, NULL, NULL, NULL) < 0
+                  && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+      goto decoding_data;
+    }
+
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, &t[0], NULL, NULL, NULL, NULL, NULL);
+  TEST_CHECK_FIELD ("lower_non_critical_threshold", rv, t[0]);
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, NULL, &t[1], NULL, NULL, NULL, NULL);
+  TEST_CHECK_FIELD ("lower_critical_threshold", rv, t[1]);
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, NULL, NULL, &t[2], NULL, NULL, NULL);
+  TEST_CHECK_FIELD ("lower_non_recoverable_threshold", rv, t[2]);
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, NULL, NULL, NULL, &t[3], NULL, NULL);
+  TEST_CHECK_FIELD ("upper_non_critical_threshold", rv, t[3]);
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, NULL, NULL, NULL, NULL, &t[4], NULL);
+  TEST_CHECK_FIELD ("upper_critical_threshold", rv, t[4]);
+  rv = ipmi_sdr_parse_thresholds_raw (ctx, buf, len, NULL, NULL, NULL, NULL, NULL, &t[5]);
+  TEST_CHECK_FIELD ("upper_non_recoverable_threshold", rv, t[5]);
+
+ decoding_data:
+
+  rv = ipmi_sdr_parse_sensor_reading_ranges_specified (ctx, buf, len, &a, &b, &c);
+  TEST_CHECK_FIELD ("analog_characteristics_flag.nominal_reading", rv, a);
+  TEST_CHECK_FIELD ("analog_characteristics_flag.normal_max", rv, b);
+  TEST_CHECK_FIELD ("analog_characteristics_flag.normal_min", rv, c);
+
+  rv = ipmi_sdr_parse_sensor_decoding_data (ctx, buf, len, NULL, NULL, NULL, NULL, &a, NULL);
+  TEST_CHECK_FIELD ("linearization", rv, a);
+  rv = ipmi_sdr_parse_sensor_decoding_data (ctx, buf, len, NULL, NULL, NULL, NULL, NULL, &b);
+  TEST_CHECK_FIELD ("sensor_unit1.analog_data_format", rv, b);
+
+  rv = ipmi_sdr_parse_sensor_decoding_data (ctx, buf, len, &r_exponent, &b_exponent, NULL, NULL, NULL, NULL);
+  TEST_CHECK ((rv < 0) == (FIID_OBJ_GET (obj, "r_exponent", &val) < 0));
+  if (rv >= 0)
+    {
+      TEST_CHECK (r_exponent == _exponent (val));
+      TEST_CHECK (FIID_OBJ_GET (obj, "b_exponent", &val) >= 0
+                  && b_exponent == _exponent (val));
+    }
+
+  rv = ipmi_sdr_parse_sensor_decoding_data (ctx, buf, len, NULL, NULL, &m, NULL, NULL, NULL);
+  TEST_CHECK ((rv < 0) == (FIID_OBJ_GET (obj, "m_ls", &ls) < 0
+                           || FIID_OBJ_GET (obj, "m_ms", &ms) < 0));
+  if (rv >= 0)
+    TEST_CHECK (m == _m_b (ls, ms));
+
+  rv = ipmi_sdr_parse_sensor_decoding_data (ctx, buf, len, NULL, NULL, NULL, &bb, NULL, NULL);
+  TEST_CHECK ((rv < 0) == (FIID_OBJ_GET (obj, "b_ls", &ls) < 0
+                           || FIID_OBJ_GET (obj, "b_ms", &ms) < 0));
+  if (rv >= 0)
+    TEST_CHECK (bb == _m_b (ls, ms));
+}
+
+/* fields only in compact and event only records */
+static void
+_check_sharing (fiid_obj_t obj, const uint8_t *buf, unsigned int len)
+{
+  uint8_t a, b, c, d;
+  int rv;
+
+  a = b = c = d = 0;
+  rv = ipmi_sdr_parse_sensor_record_sharing (ctx, buf, len, &a, &b, NULL, NULL);
+  TEST_CHECK_FIELD ("share_count", rv, a);
+  TEST_CHECK_FIELD ("id_string_instance_modifier_type", rv, b);
+  rv = ipmi_sdr_parse_sensor_record_sharing (ctx, buf, len, NULL, NULL, &c, &d);
+  TEST_CHECK_FIELD ("id_string_instance_modifier_offset", rv, c);
+  TEST_CHECK_FIELD ("entity_instance_sharing", rv, d);
+}
+
+static void
+_check_id_string (fiid_obj_t obj, const uint8_t *buf, unsigned int len)
+{
+  char id_string[IPMI_SDR_MAX_ID_STRING_LENGTH + 1];
+  char fiid_id_string[IPMI_SDR_MAX_ID_STRING_LENGTH + 1];
+  int rv, ret;
+
+  memset (id_string, '\0', sizeof (id_string));
+  memset (fiid_id_string, '\0', sizeof (fiid_id_string));
+
+  rv = ipmi_sdr_parse_id_string (ctx, buf, len, id_string, IPMI_SDR_MAX_ID_STRING_LENGTH);
+  ret = fiid_obj_get_data (obj, "id_string", fiid_id_string, IPMI_SDR_MAX_ID_STRING_LENGTH);
+  TEST_CHECK (rv == ret);
+  if (rv > 0)
+    TEST_CHECK (!memcmp (id_string, fiid_id_string, rv));
+}
+
+/* ipmi_sdr_parse_record_decoded() returns what the accessors do */
+static void
+_check_decoded (const uint8_t *buf, unsigned int len)
+{
+  struct ipmi_sdr_record_decoded d;
+  char id_string[IPMI_SDR_MAX_ID_STRING_LENGTH + 1];
+  uint8_t a, b, c;
+  uint8_t t[6];
+  int8_t r_exponent, b_exponent;
+  int16_t m, bb;
+  int rv;
+
+  if (ipmi_sdr_parse_record_decoded (ctx, buf, len, &d) < 0)
+    {
+      /* only records cut short before the id string are refused */
+      TEST_CHECK (ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
+      TEST_CHECK (ipmi_sdr_parse_id_string (ctx, buf, len, id_string, IPMI_SDR_MAX_ID_STRING_LENGTH) <= 0);
+      return;
+    }
+
+  TEST_CHECK (!ipmi_sdr_parse_record_id_and_type (ctx, buf, len, NULL, &a)
+              && d.record_type == a);
+  TEST_CHECK (!ipmi_sdr_parse_sensor_owner_id (ctx, buf, len, &a, &b)
+              && d.sensor_owner_id_type == a
+              && d.sensor_owner_id == b);
+  TEST_CHECK (!ipmi_sdr_parse_sensor_number (ctx, buf, len, &a)
+              && d.sensor_number == a);
+  TEST_CHECK (!ipmi_sdr_parse_entity_id_instance_type (ctx, buf, len, &a, &b, &c)
+              && d.entity_id == a
+              && d.entity_instance == b
+              && d.entity_instance_type == c);
+  TEST_CHECK (!ipmi_sdr_parse_sensor_type (ctx, buf, len, &a)
+              && d.sensor_type == a);
+  TEST_CHECK (!ipmi_sdr_parse_event_reading_type_code (ctx, buf, len, &a)
+              && d.event_reading_type_code == a);
+
+  memset (id_string, '\0', sizeof (id_string));
+  rv = ipmi_sdr_parse_id_string (ctx, buf, len, id_string, IPMI_SDR_MAX_ID_STRING_LENGTH);
+  TEST_CHECK (rv >= 0
+              && d.id_string_len == rv
+              && !memcmp (d.id_string, id_string, rv));
+
+  if (d.record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
+      || d.record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+    {
+      TEST_CHECK (!ipmi_sdr_parse_sensor_units (ctx, buf, len, NULL, NULL, NULL, &a, &b)
+                  && d.sensor_base_unit_type == a
+                  && d.sensor_modifier_unit_type == b);
+      TEST_CHECK (!ipmi_sdr_parse_sensor_direction (ctx, buf, len, &a)
+                  && d.sensor_direction == a);
+    }
+
+  if (d.record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+    {
+      TEST_CHECK (!ipmi_sdr_parse_sensor_decoding_data (ctx,
+                                                        buf,
+                                                        len,
+                                                        &r_exponent,
+                                                        &b_exponent,
+                                                        &m,
+                                                        &bb,
+                                                        &a,
+                                                        &b)
+                  && d.r_exponent == r_exponent
+                  && d.b_exponent == b_exponent
+                  && d.m == m
+                  && d.b == bb
+                  && d.linearization == a
+                  && d.analog_data_format == b);
+      if (IPMI_EVENT_READING_TYPE_CODE_IS_THRESHOLD (d.event_reading_type_code))
+        TEST_CHECK (!ipmi_sdr_parse_thresholds_raw (ctx, buf, len, &t[0], &t[1], &t[2], &t[3], &t[4], &t[5])
+                    && d.lower_non_critical_threshold == t[0]
+                    && d.lower_critical_threshold == t[1]
+                    && d.lower_non_recoverable_threshold == t[2]
+                    && d.upper_non_critical_threshold == t[3]
+                    && d.upper_critical_threshold == t[4]
+                    && d.upper_non_recoverable_threshold == t[5]);
+    }
+  else
+    TEST_CHECK (!ipmi_sdr_parse_sensor_record_sharing (ctx, buf, len, &a, &b, &c, NULL)
+                && d.share_count == a
+                && d.id_string_instance_modifier_type == b
+                && d.id_string_instance_modifier_offset == c);
+}
+
+static void
+_check_record (const uint8_t *buf, unsigned int len)
+{
+  fiid_obj_t obj;
+
+  obj = _fiid_record (buf, len);
+
+  _check_common (obj, buf, len);
+  if (buf[3] != IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
+    _check_full_compact (obj, buf, len);
+  if (buf[3] == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+    _check_full (obj, buf, len);
+  else
+    _check_sharing (obj, buf, len);
+  _check_id_string (obj, buf, len);
+  _check_decoded (buf, len);
+
+  fiid_obj_destroy (obj);
+}
+
+/* The fixture records, then every shorter cut of each */
+static void
+test_records (void)
+{
+  struct sdr_record records[SDR_RECORDS_COUNT];
+  unsigned int i, len;
+
+  sdr_records_build (SDR_RECORDS_COUNT, 0, records);
+
+  for (i = 0; i < SDR_RECORDS_COUNT; i++)
+    {
+      if (records[i].record_type == IPMI_SDR_FORMAT_OEM_RECORD)
+        continue;
+
+      for (len = TEST_RECORD_HEADER_LENGTH; len <= records[i].len; len++)
+        _check_record (records[i].data, len);
+    }
+}
+
+/* Compact and event only records shared by several sensors */
+static void
+test_shared (void)
+{
+  struct sdr_record records[SDR_RECORDS_COUNT];
+  unsigned int shared = 0;
+  unsigned int i;
+
+  sdr_records_build (SDR_RECORDS_COUNT, 0, records);
+
+  for (i = 0; i < SDR_RECORDS_COUNT; i++)
+    {
+      struct ipmi_sdr_record_decoded d;
+      uint8_t share_count;
+
+      if (records[i].share_count < 2)
+        continue;
+
+      TEST_CHECK (!ipmi_sdr_parse_record_decoded (ctx, records[i].data, records[i].len, &d)
+                  && d.share_count == records[i].share_count
+                  && d.sensor_number == records[i].sensor_number);
+      TEST_CHECK (!ipmi_sdr_parse_sensor_record_sharing (ctx,
+                                                         records[i].data,
+                                                         records[i].len,
+                                                         &share_count,
+                                                         NULL,
+                                                         NULL,
+                                                         NULL)
+                  && share_count == records[i].share_count);
+      shared++;
+    }
+
+  TEST_CHECK (shared);
+}
+
+static void
+_random_body (uint8_t *buf, unsigned int len, unsigned int id_string)
+{
+  unsigned int i;
+
+  for (i = TEST_RECORD_HEADER_LENGTH; i < id_string && i < len; i++)
+    buf[i] = rand_r (&seed);
+}
+
+/* Every bit of the record bodies, the fixtures leave most bytes 0 */
+static void
+test_random (void)
+{
+  struct sdr_record record;
+  unsigned int i, j;
+
+  for (i = 0; i < 3; i++)
+    {
+      unsigned int id_string;
+
+      sdr_records_build_one (i, 0, &record);
+      if (record.record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
+        id_string = TEST_FULL_ID_STRING;
+      else if (record.record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+        id_string = TEST_COMPACT_ID_STRING;
+      else
+        id_string = TEST_EVENT_ID_STRING;
+
+      for (j = 0; j < TEST_RANDOM_COUNT; j++)
+        {
+          _random_body (record.data, record.len, id_string);
+          /* half the full records are threshold based */
+          if (record.record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD && (j % 2))
+            record.data[TEST_FULL_EVENT_READING_TYPE_CODE] = IPMI_EVENT_READING_TYPE_CODE_THRESHOLD;
+          _check_record (record.data, record.len);
+        }
+    }
+}
+
+/* No id string, a maximum length id string, and one longer than any
+ * BMC should report, for each sensor record type
+ */
+static void
+test_id_string (void)
+{
+  unsigned int id_strings[] = { TEST_FULL_ID_STRING, TEST_COMPACT_ID_STRING, TEST_EVENT_ID_STRING };
+  unsigned int id_string_lens[] = { 0, 1, IPMI_SDR_MAX_ID_STRING_LENGTH - 1, IPMI_SDR_MAX_ID_STRING_LENGTH, IPMI_SDR_MAX_ID_STRING_LENGTH + 4 };
+  unsigned int i, j;
+
+  for (i = 0; i < 3; i++)
+    {
+      for (j = 0; j < sizeof (id_string_lens) / sizeof (id_string_lens[0]); j++)
+        {
+          struct sdr_record record;
+          uint8_t buf[TEST_RECORD_LEN_MAX];
+          unsigned int len;
+          char id_string[IPMI_SDR_MAX_ID_STRING_LENGTH + 1];
+          int rv;
+
+          sdr_records_build_one (i, 0, &record);
+          memset (buf, '\0', sizeof (buf));
+          memcpy (buf, record.data, id_strings[i]);
+          len = id_strings[i] + 1 + id_string_lens[j];
+          buf[id_strings[i]] = 0xC0 | id_string_lens[j];
+          memset (buf + id_strings[i] + 1, 'a' + j, id_string_lens[j]);
+          buf[4] = len - TEST_RECORD_HEADER_LENGTH;
+
+          _check_record (buf, len);
+
+          rv = ipmi_sdr_parse_id_string (ctx, buf, len, id_string, IPMI_SDR_MAX_ID_STRING_LENGTH);
+          if (id_string_lens[j] > IPMI_SDR_MAX_ID_STRING_LENGTH)
+            TEST_CHECK (rv == IPMI_SDR_MAX_ID_STRING_LENGTH);
+          else
+            TEST_CHECK (rv == id_string_lens[j]);
+        }
+    }
+}
+
+/* Non sensor records are refused */
+static void
+test_oem (void)
+{
+  struct sdr_record record;
+  struct ipmi_sdr_record_decoded d;
+  uint8_t sensor_number;
+
+  sdr_records_build_one (3, 0, &record);
+  TEST_REQUIRE (record.record_type == IPMI_SDR_FORMAT_OEM_RECORD);
+
+  TEST_CHECK (ipmi_sdr_parse_record_decoded (ctx, record.data, record.len, &d) < 0
+              && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+  TEST_CHECK (ipmi_sdr_parse_sensor_number (ctx, record.data, record.len, &sensor_number) < 0
+              && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_PARSE_INVALID_SDR_RECORD);
+
+  /* shorter than a record header */
+  TEST_CHECK (ipmi_sdr_parse_sensor_number (ctx, record.data, TEST_RECORD_HEADER_LENGTH - 1, &sensor_number) < 0
+              && ipmi_sdr_ctx_errnum (ctx) == IPMI_SDR_ERR_PARSE_INCOMPLETE_SDR_RECORD);
+}
+
+/* The last decode is reused only while the record bytes are the
+ * same, not while the buffer is
+ */
+static void
+test_reuse (void)
+{
+  struct sdr_record record;
+  uint8_t sensor_number;
+  unsigned int i;
+
+  sdr_records_build_one (0, 0, &record);
+
+  for (i = 0; i < 4; i++)
+    {
+      record.data[TEST_SENSOR_NUMBER_INDEX] = 0x10 + i;
+      TEST_CHECK (!ipmi_sdr_parse_sensor_number (ctx, record.data, record.len, &sensor_number)
+                  && sensor_number == 0x10 + i);
+      TEST_CHECK (!ipmi_sdr_parse_sensor_number (ctx, record.data, record.len, &sensor_number)
+                  && sensor_number == 0x10 + i);
+    }
+
+  /* same bytes, shorter record */
+  TEST_CHECK (ipmi_sdr_parse_sensor_number (ctx,
+                                            record.data,
+                                            TEST_SENSOR_NUMBER_INDEX,
+                                            &sensor_number) < 0);
+}
+
+int
+main (int argc, char **argv)
+{
+  TEST_REQUIRE ((ctx = ipmi_sdr_ctx_create ()));
+
+  test_records ();
+  test_shared ();
+  test_random ();
+  test_id_string ();
+  test_oem ();
+  test_reuse ();
+
+  ipmi_sdr_ctx_destroy (ctx);
+
+  return (TEST_EXIT ());
+}
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   250
+
+#define TEST_FILENAME_LEN             256
+#define TEST_SEL_ENTRY_LEN            16
+
+/* first record id, ids then count up */
+#define TEST_SEL_RECORD_ID_BASE       0x0040
+
+/* enough entries for the parsed entry array to outgrow the heap and
+ * be remapped at least once
+ */
+#define TEST_SEL_LARGE_COUNT          10000
+
+static fakebmc_t bmc;
+static ipmi_ctx_t ipmi_ctx;
+static char mirror[TEST_FILENAME_LEN];
+
+/* System event record number n */
+static void
+_sel_entry (unsigned int n, uint8_t *entry)
+{
+  uint16_t record_id = TEST_SEL_RECORD_ID_BASE + n;
+  uint32_t timestamp = 0x50000000 + n * 60;
+
+  memset (entry, '\0', TEST_SEL_ENTRY_LEN);
+  entry[0] = record_id & 0xFF;
+  entry[1] = record_id >> 8;
+  /* system event record */
+  entry[2] = 0x02;
+  entry[3] = timestamp & 0xFF;
+  entry[4] = (timestamp >> 8) & 0xFF;
+  entry[5] = (timestamp >> 16) & 0xFF;
+  entry[6] = timestamp >> 24;
+  /* generator id BMC, event message revision 2.0 */
+  entry[7] = 0x20;
+  entry[9] = 0x04;
+  /* temperature, threshold, upper critical going high */
+  entry[10] = 0x01;
+  entry[11] = n & 0xFF;
+  entry[12] = 0x01;
+  entry[13] = 0x09;
+  entry[14] = n & 0xFF;
+  entry[15] = n >> 8;
+}
+
+static void
+_sel_add (unsigned int first, unsigned int count)
+{
+  uint8_t entry[TEST_SEL_ENTRY_LEN];
+  unsigned int i;
+
+  for (i = first; i < first + count; i++)
+    {
+      _sel_entry (i, entry);
+      TEST_REQUIRE (!fakebmc_add_sel (bmc, entry));
+    }
+}
+
+static unsigned int
+_sel_entry_requests (void)
+{
+  return (fakebmc_count (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SEL_ENTRY));
+}
+
+static ipmi_sel_ctx_t
+_sel_ctx_create (void)
+{
+  ipmi_sel_ctx_t ctx;
+
+  TEST_REQUIRE ((ctx = ipmi_sel_ctx_create (ipmi_ctx, NULL)));
+  return (ctx);
+}
+
+/* Parse and check that exactly entries first to first + count - 1
+ * are found, in order.
+ */
+static void
+_check_parse (ipmi_sel_ctx_t ctx, unsigned int first, unsigned int count)
+{
+  uint8_t entry[TEST_SEL_ENTRY_LEN];
+  uint8_t buf[TEST_SEL_ENTRY_LEN];
+  unsigned int i;
+  int n;
+
+  n = ipmi_sel_parse (ctx,
+                      IPMI_SEL_RECORD_ID_FIRST,
+                      IPMI_SEL_RECORD_ID_LAST,
+                      NULL,
+                      NULL);
+  TEST_CHECK (n == (int)count);
+  if (n != (int)count)
+    {
+      fprintf (stderr, "ipmi_sel_parse: %d: %s\n", n, ipmi_sel_ctx_errormsg (ctx));
+      return;
+    }
+
+  if (!count)
+    {
+      TEST_CHECK (ipmi_sel_parse_sel_entry_count (ctx) < 0
+                  && ipmi_sel_ctx_errnum (ctx) == IPMI_SEL_ERR_NO_SEL_ENTRIES);
+      return;
+    }
+
+  TEST_CHECK (ipmi_sel_parse_sel_entry_count (ctx) == (int)count);
+
+  TEST_CHECK (!ipmi_sel_parse_first (ctx));
+  for (i = first; i < first + count; i++)
+    {
+      _sel_entry (i, entry);
+      TEST_CHECK (ipmi_sel_parse_read_record (ctx, buf, TEST_SEL_ENTRY_LEN) == TEST_SEL_ENTRY_LEN
+                  && !memcmp (buf, entry, TEST_SEL_ENTRY_LEN));
+      TEST_CHECK (ipmi_sel_parse_next (ctx) == (i + 1 < first + count ? 1 : 0));
+    }
+
+  /* random access */
+  for (i = first; i < first + count; i += 7)
+    {
+      uint16_t record_id;
+
+      TEST_CHECK (!ipmi_sel_parse_search_record_id (ctx, TEST_SEL_RECORD_ID_BASE + i));
+      TEST_CHECK (!ipmi_sel_parse_read_record_id (ctx, NULL, 0, &record_id)
+                  && record_id == TEST_SEL_RECORD_ID_BASE + i);
+    }
+}
+
+/* Start over in a new session.  Responses answered late may still
+ * arrive in the old one, and cannot be told apart from responses to
+ * later requests given the same requester sequence number.
+ */
+static void
+_session_restart (void)
+{
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT)));
+}
+
+/* ipmi_sel_parse without a mirror reads the whole SEL */
+static void
+_test_parse (unsigned int flags)
+{
+  ipmi_sel_ctx_t ctx;
+
+  fakebmc_clear_sel (bmc);
+  ctx = _sel_ctx_create ();
+  TEST_REQUIRE (!ipmi_sel_ctx_set_flags (ctx, flags));
+  _check_parse (ctx, 0, 0);
+
+  _sel_add (0, 50);
+  _check_parse (ctx, 0, 50);
+
+  /* responses out of order */
+  fakebmc_set_delay (bmc, 0, 5);
+  _check_parse (ctx, 0, 50);
+  fakebmc_set_delay (bmc, 0, 0);
+
+  /* lost responses */
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SEL_ENTRY, 7);
+  _check_parse (ctx, 0, 50);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SEL_ENTRY, 0);
+  TEST_CHECK (_sel_entry_requests () > 50);
+
+  /* responses arriving after the retransmission was answered */
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_late (bmc,
+                    IPMI_NET_FN_STORAGE_RQ,
+                    IPMI_CMD_GET_SEL_ENTRY,
+                    5,
+                    TEST_RETRANSMISSION_TIMEOUT * 2);
+  _check_parse (ctx, 0, 50);
+  fakebmc_set_late (bmc, IPMI_NET_FN_STORAGE_RQ, IPMI_CMD_GET_SEL_ENTRY, 0, 0);
+  TEST_CHECK (_sel_entry_requests () > 50);
+
+  ipmi_sel_ctx_destroy (ctx);
+  _session_restart ();
+}
+
+static void
+test_parse (void)
+{
+  _test_parse (0);
+  _test_parse (IPMI_SEL_FLAGS_PIPELINE);
+}
+
+static void
+test_sync (void)
+{
+  ipmi_sel_ctx_t ctx;
+  uint8_t entry[TEST_SEL_ENTRY_LEN];
+  unsigned int i;
+
+  unlink (mirror);
+  fakebmc_clear_sel (bmc);
+  _sel_add (0, 40);
+
+  ctx = _sel_ctx_create ();
+
+  /* first sync reads everything */
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 40);
+  TEST_CHECK (_sel_entry_requests () == 40);
+
+  /* nothing changed, nothing read */
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (!ipmi_sel_sync (ctx, mirror));
+  TEST_CHECK (!_sel_entry_requests ());
+
+  /* parse goes through the mirror */
+  fakebmc_reset_counts (bmc);
+  _check_parse (ctx, 0, 40);
+  TEST_CHECK (!_sel_entry_requests ());
+
+  /* additions read only the new entries, plus checking the first
+   * and last mirrored entries are unchanged
+   */
+  _sel_add (40, 10);
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 10);
+  TEST_CHECK (_sel_entry_requests () == 10 + 2);
+  _check_parse (ctx, 0, 50);
+
+  /* a full SEL overwriting its oldest entries forces a rebuild */
+  for (i = 50; i < 53; i++)
+    {
+      _sel_entry (i, entry);
+      TEST_REQUIRE (!fakebmc_overwrite_sel (bmc, entry));
+    }
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 50);
+  _check_parse (ctx, 3, 50);
+
+  /* clearing forces a rebuild */
+  fakebmc_clear_sel (bmc);
+  _sel_add (100, 5);
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 5);
+  _check_parse (ctx, 100, 5);
+
+  /* an empty SEL mirrors as empty */
+  fakebmc_clear_sel (bmc);
+  TEST_CHECK (!ipmi_sel_sync (ctx, mirror));
+  _check_parse (ctx, 0, 0);
+
+  _sel_add (200, 20);
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 20);
+
+  /* unbinding goes back to reading the BMC */
+  TEST_CHECK (!ipmi_sel_sync (ctx, NULL));
+  fakebmc_reset_counts (bmc);
+  _check_parse (ctx, 200, 20);
+  TEST_CHECK (_sel_entry_requests () >= 20);
+
+  ipmi_sel_ctx_destroy (ctx);
+}
+
+/* A mirror is reusable by later contexts and processes, and damage
+ * to it is repaired rather than trusted.
+ */
+static void
+test_mirror_file (void)
+{
+  ipmi_sel_ctx_t ctx;
+  struct stat statbuf;
+  uint8_t junk[TEST_SEL_ENTRY_LEN / 2];
+  int fd;
+
+  unlink (mirror);
+  fakebmc_clear_sel (bmc);
+  _sel_add (0, 30);
+
+  ctx = _sel_ctx_create ();
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 30);
+  ipmi_sel_ctx_destroy (ctx);
+
+  /* read back by a new context */
+  ctx = _sel_ctx_create ();
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (!ipmi_sel_sync (ctx, mirror));
+  TEST_CHECK (!_sel_entry_requests ());
+  _check_parse (ctx, 0, 30);
+  ipmi_sel_ctx_destroy (ctx);
+
+  /* a partial record from an interrupted sync is dropped */
+  TEST_REQUIRE (!stat (mirror, &statbuf));
+  memset (junk, 0xA5, sizeof (junk));
+  TEST_REQUIRE ((fd = open (mirror, O_WRONLY | O_APPEND)) >= 0);
+  TEST_REQUIRE (write (fd, junk, sizeof (junk)) == sizeof (junk));
+  close (fd);
+
+  _sel_add (30, 2);
+  ctx = _sel_ctx_create ();
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 2);
+  _check_parse (ctx, 0, 32);
+  ipmi_sel_ctx_destroy (ctx);
+
+  /* so is anything that is not a mirror */
+  TEST_REQUIRE ((fd = open (mirror, O_WRONLY | O_TRUNC)) >= 0);
+  TEST_REQUIRE (write (fd, junk, sizeof (junk)) == sizeof (junk));
+  close (fd);
+
+  ctx = _sel_ctx_create ();
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == 32);
+  _check_parse (ctx, 0, 32);
+  ipmi_sel_ctx_destroy (ctx);
+
+  unlink (mirror);
+}
+
+/* A SEL far larger than the initial parsed entry array */
+static void
+test_large (void)
+{
+  ipmi_sel_ctx_t ctx;
+
+  unlink (mirror);
+  fakebmc_clear_sel (bmc);
+  _sel_add (0, TEST_SEL_LARGE_COUNT);
+
+  /* from the BMC */
+  ctx = _sel_ctx_create ();
+  _check_parse (ctx, 0, TEST_SEL_LARGE_COUNT);
+
+  /* parsing again reuses the grown array */
+  _check_parse (ctx, 0, TEST_SEL_LARGE_COUNT);
+
+  /* from the mirror */
+  TEST_CHECK (ipmi_sel_sync (ctx, mirror) == TEST_SEL_LARGE_COUNT);
+  fakebmc_reset_counts (bmc);
+  _check_parse (ctx, 0, TEST_SEL_LARGE_COUNT);
+  TEST_CHECK (!_sel_entry_requests ());
+  ipmi_sel_ctx_destroy (ctx);
+
+  unlink (mirror);
+}
+
+int
+main (int argc, char **argv)
+{
+  char dir[TEST_FILENAME_LEN];
+
+  snprintf (dir, TEST_FILENAME_LEN, "test-sel.XXXXXX");
+  TEST_REQUIRE (mkdtemp (dir));
+  snprintf (mirror, TEST_FILENAME_LEN, "%s/mirror", dir);
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT)));
+
+  test_parse ();
+  test_sync ();
+  test_mirror_file ();
+  test_large ();
+
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+  fakebmc_stop (bmc);
+
+  unlink (mirror);
+  rmdir (dir);
+  return (TEST_EXIT ());
+}
@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "test-common.h"
+#include "fakebmc.h"
+#include "sdr-records.h"
+
+TEST_DEFINE_FAILURES;
+
+#define TEST_SESSION_TIMEOUT          5000
+#define TEST_RETRANSMISSION_TIMEOUT   100
+
+/* shared sensors included */
+#define TEST_SENSORS_MAX              (SDR_RECORDS_COUNT * 3)
+
+/* The result of ipmi_sensor_read() for one sensor */
+struct reading
+{
+  int ret;
+  uint8_t sensor_reading_raw;
+  int have_reading;
+  double sensor_reading;
+  uint16_t sensor_event_bitmask;
+};
+
+static fakebmc_t bmc;
+
+static struct sdr_record records[SDR_RECORDS_COUNT];
+
+/* Get Sensor Reading requests issued reading every sensor one at a
+ * time, event only records are not read
+ */
+static unsigned int requests;
+
+static unsigned int
+_count (void)
+{
+  return (fakebmc_count (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING));
+}
+
+static unsigned int
+_sweep_add_all (ipmi_sensor_read_ctx_t ctx)
+{
+  unsigned int sensors = 0;
+  unsigned int i, j;
+
+  for (i = 0; i < SDR_RECORDS_COUNT; i++)
+    {
+      /* OEM records are skipped, as ipmi-sensors skips them */
+      if (!records[i].share_count)
+        continue;
+
+      for (j = 0; j < records[i].share_count; j++)
+        {
+          TEST_CHECK (!ipmi_sensor_read_sweep_add (ctx,
+                                                   records[i].data,
+                                                   records[i].len,
+                                                   j));
+          sensors++;
+        }
+    }
+
+  return (sensors);
+}
+
+/* Read every sensor of every record, in record order */
+static unsigned int
+_read_all (ipmi_sensor_read_ctx_t ctx, struct reading *readings)
+{
+  unsigned int n = 0;
+  unsigned int i, j;
+
+  for (i = 0; i < SDR_RECORDS_COUNT; i++)
+    {
+      if (!records[i].share_count)
+        continue;
+
+      for (j = 0; j < records[i].share_count; j++)
+        {
+          double *sensor_reading = NULL;
+
+          TEST_REQUIRE (n < TEST_SENSORS_MAX);
+          memset (&readings[n], '\0', sizeof (struct reading));
+          readings[n].ret = ipmi_sensor_read (ctx,
+                                              records[i].data,
+                                              records[i].len,
+                                              j,
+                                              &readings[n].sensor_reading_raw,
+                                              &sensor_reading,
+                                              &readings[n].sensor_event_bitmask);
+          if (sensor_reading)
+            {
+              readings[n].have_reading = 1;
+              readings[n].sensor_reading = *sensor_reading;
+              free (sensor_reading);
+            }
+          n++;
+        }
+    }
+
+  return (n);
+}
+
+static void
+_check_readings (struct reading *expected,
+                 struct reading *readings,
+                 unsigned int n)
+{
+  unsigned int mismatched = 0;
+  unsigned int i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (readings[i].ret != expected[i].ret
+          || readings[i].sensor_reading_raw != expected[i].sensor_reading_raw
+          || readings[i].have_reading != expected[i].have_reading
+          || readings[i].sensor_reading != expected[i].sensor_reading
+          || readings[i].sensor_event_bitmask != expected[i].sensor_event_bitmask)
+        mismatched++;
+    }
+
+  TEST_CHECK (!mismatched);
+}
+
+/* Sensors are read one at a time without a sweep */
+static unsigned int
+_read_serial (ipmi_sensor_read_ctx_t ctx, struct reading *readings)
+{
+  unsigned int n;
+
+  fakebmc_reset_counts (bmc);
+  n = _read_all (ctx, readings);
+  requests = _count ();
+  TEST_CHECK (requests > SDR_RECORDS_COUNT / 2 && requests < n);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) == 1);
+
+  /* the swept readings will be checked against these */
+  TEST_CHECK (readings[0].ret == 1 && readings[0].have_reading);
+
+  return (n);
+}
+
+/* A sweep reads every sensor once, and ipmi_sensor_read() returns the
+ * same results without further requests
+ */
+static void
+test_sweep (ipmi_sensor_read_ctx_t ctx, struct reading *expected, unsigned int n)
+{
+  struct reading readings[TEST_SENSORS_MAX];
+
+  fakebmc_reset_counts (bmc);
+  fakebmc_set_delay (bmc, 0, 10);
+
+  TEST_CHECK (_sweep_add_all (ctx) == n);
+  TEST_CHECK (!ipmi_sensor_read_sweep (ctx));
+  TEST_CHECK (_count () == requests);
+  TEST_CHECK (fakebmc_outstanding_max (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING) > 1);
+
+  TEST_CHECK (_read_all (ctx, readings) == n);
+  TEST_CHECK (_count () == requests);
+  _check_readings (expected, readings, n);
+
+  /* each response is used only once */
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (_read_all (ctx, readings) == n);
+  TEST_CHECK (_count () == requests);
+  _check_readings (expected, readings, n);
+
+  TEST_CHECK (!ipmi_sensor_read_sweep_clear (ctx));
+  fakebmc_set_delay (bmc, 0, 0);
+}
+
+/* Lost responses are retransmitted within the sweep */
+static void
+test_sweep_lost (ipmi_sensor_read_ctx_t ctx, struct reading *expected, unsigned int n)
+{
+  struct reading readings[TEST_SENSORS_MAX];
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 5);
+
+  _sweep_add_all (ctx);
+  TEST_CHECK (!ipmi_sensor_read_sweep (ctx));
+  TEST_CHECK (_read_all (ctx, readings) == n);
+  _check_readings (expected, readings, n);
+
+  TEST_CHECK (!ipmi_sensor_read_sweep_clear (ctx));
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+}
+
+/* Unused responses are dropped by ipmi_sensor_read_sweep_clear(),
+ * later reads request the sensor again
+ */
+static void
+test_sweep_clear (ipmi_sensor_read_ctx_t ctx, struct reading *expected, unsigned int n)
+{
+  struct reading readings[TEST_SENSORS_MAX];
+
+  _sweep_add_all (ctx);
+  TEST_CHECK (!ipmi_sensor_read_sweep (ctx));
+  TEST_CHECK (!ipmi_sensor_read_sweep_clear (ctx));
+
+  fakebmc_reset_counts (bmc);
+  TEST_CHECK (_read_all (ctx, readings) == n);
+  TEST_CHECK (_count () == requests);
+  _check_readings (expected, readings, n);
+}
+
+static void
+_callback (ipmi_ctx_t ctx, int errnum, fiid_obj_t obj_cmd_rs, void *data)
+{
+  /* cancelled, never called */
+  TEST_CHECK (0);
+}
+
+/* A failed sweep keeps no responses, so callers can fall back to
+ * reading sensors one at a time.  A context with a command
+ * outstanding fails the sweep without touching the session.
+ */
+static void
+test_sweep_busy (struct reading *expected, unsigned int n)
+{
+  struct reading readings[TEST_SENSORS_MAX];
+  ipmi_sensor_read_ctx_t ctx;
+  ipmi_ctx_t ipmi_ctx;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT)));
+  TEST_REQUIRE ((ctx = ipmi_sensor_read_ctx_create (ipmi_ctx)));
+  TEST_REQUIRE ((obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_device_id_rq)));
+  TEST_REQUIRE ((obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_device_id_rs)));
+  TEST_REQUIRE (!fill_cmd_get_device_id (obj_cmd_rq));
+
+  TEST_REQUIRE (!ipmi_cmd_poll_submit (ipmi_ctx,
+                                       IPMI_BMC_IPMB_LUN_BMC,
+                                       IPMI_NET_FN_APP_RQ,
+                                       obj_cmd_rq,
+                                       obj_cmd_rs,
+                                       _callback,
+                                       NULL));
+
+  fakebmc_reset_counts (bmc);
+  _sweep_add_all (ctx);
+  TEST_CHECK (ipmi_sensor_read_sweep (ctx) < 0
+              && ipmi_sensor_read_ctx_errnum (ctx) == IPMI_SENSOR_READ_ERR_IPMI_ERROR
+              && ipmi_ctx_errnum (ipmi_ctx) == IPMI_ERR_DRIVER_BUSY);
+  TEST_CHECK (!_count ());
+
+  TEST_CHECK (!ipmi_cmd_poll_cancel (ipmi_ctx));
+
+  TEST_CHECK (!ipmi_sensor_read_sweep_clear (ctx));
+  TEST_CHECK (_read_all (ctx, readings) == n);
+  TEST_CHECK (_count () == requests);
+  _check_readings (expected, readings, n);
+
+  fiid_obj_destroy (obj_cmd_rq);
+  fiid_obj_destroy (obj_cmd_rs);
+  ipmi_sensor_read_ctx_destroy (ctx);
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+}
+
+/* A BMC that drops every request fails the sweep with the session.
+ * Later reads report the error, nothing swept is used.
+ */
+static void
+test_sweep_timeout (void)
+{
+  ipmi_sensor_read_ctx_t ctx;
+  ipmi_ctx_t ipmi_ctx;
+  uint8_t sensor_reading_raw;
+  double *sensor_reading = NULL;
+  uint16_t sensor_event_bitmask;
+
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc, 1000, TEST_RETRANSMISSION_TIMEOUT)));
+  TEST_REQUIRE ((ctx = ipmi_sensor_read_ctx_create (ipmi_ctx)));
+
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 1);
+  _sweep_add_all (ctx);
+  TEST_CHECK (ipmi_sensor_read_sweep (ctx) < 0
+              && ipmi_ctx_errnum (ipmi_ctx) == IPMI_ERR_SESSION_TIMEOUT);
+  fakebmc_set_drop (bmc, IPMI_NET_FN_SENSOR_EVENT_RQ, IPMI_CMD_GET_SENSOR_READING, 0);
+
+  TEST_CHECK (!ipmi_sensor_read_sweep_clear (ctx));
+  TEST_CHECK (ipmi_sensor_read (ctx,
+                                records[0].data,
+                                records[0].len,
+                                0,
+                                &sensor_reading_raw,
+                                &sensor_reading,
+                                &sensor_event_bitmask) < 0
+              && !sensor_reading);
+
+  ipmi_sensor_read_ctx_destroy (ctx);
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct reading expected[TEST_SENSORS_MAX];
+  ipmi_sensor_read_ctx_t ctx;
+  ipmi_ctx_t ipmi_ctx;
+  unsigned int n;
+
+  sdr_records_build (SDR_RECORDS_COUNT, 0, records);
+
+  TEST_REQUIRE ((bmc = fakebmc_start ()));
+  TEST_REQUIRE ((ipmi_ctx = fakebmc_ctx_open (bmc,
+                                              TEST_SESSION_TIMEOUT,
+                                              TEST_RETRANSMISSION_TIMEOUT)));
+  TEST_REQUIRE ((ctx = ipmi_sensor_read_ctx_create (ipmi_ctx)));
+
+  n = _read_serial (ctx, expected);
+  test_sweep (ctx, expected, n);
+  test_sweep_lost (ctx, expected, n);
+  test_sweep_clear (ctx, expected, n);
+  test_sweep_busy (expected, n);
+  test_sweep_timeout ();
+
+  ipmi_sensor_read_ctx_destroy (ctx);
+  ipmi_ctx_close (ipmi_ctx);
+  ipmi_ctx_destroy (ipmi_ctx);
+  fakebmc_stop (bmc);
+
+  return (TEST_EXIT ());
+}